@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/c/c_api_experimental.h"
 
+#include <cstring>
+
 #include "absl/strings/substitute.h"
 #include "tensorflow/c/c_api.h"
 #include "tensorflow/c/c_api_internal.h"
@@ -26,8 +28,10 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/init_main.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/net.h"
 #include "tensorflow/core/platform/platform.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -915,3 +919,180 @@ TFE_TensorHandle* TFE_ConsumeInputConcreteTensorFromTraceContext(
           << handle->DebugString();
   return ret;
 }
+
+struct TF_TensorPool {
+  TF_DataType dtype;
+  std::vector<int64_t> dims;
+  size_t byte_size;
+
+  tensorflow::mutex mu;
+  std::vector<TF_Tensor*> available GUARDED_BY(mu);
+};
+
+TF_TensorPool* TF_NewTensorPool(TF_DataType dtype, const int64_t* dims,
+                                int num_dims) {
+  const size_t elem_size = TF_DataTypeSize(dtype);
+  if (elem_size == 0) {
+    // Variable-length dtypes (TF_STRING, TF_RESOURCE) cannot share fixed-size
+    // buffers.
+    return nullptr;
+  }
+  TF_TensorPool* pool = new TF_TensorPool;
+  pool->dtype = dtype;
+  pool->dims.assign(dims, dims + num_dims);
+  int64_t num_elements = 1;
+  for (int i = 0; i < num_dims; ++i) {
+    num_elements *= dims[i];
+  }
+  pool->byte_size = elem_size * num_elements;
+  return pool;
+}
+
+TF_Tensor* TF_TensorPoolLease(TF_TensorPool* pool) {
+  {
+    tensorflow::mutex_lock lock(pool->mu);
+    if (!pool->available.empty()) {
+      TF_Tensor* tensor = pool->available.back();
+      pool->available.pop_back();
+      return tensor;
+    }
+  }
+  return TF_AllocateTensor(pool->dtype, pool->dims.data(),
+                           static_cast<int>(pool->dims.size()),
+                           pool->byte_size);
+}
+
+void TF_ReturnTensorToPool(TF_TensorPool* pool, TF_Tensor* tensor) {
+  // Recycle the buffer only if nothing else holds a reference to it (the
+  // runtime may have retained the feed); otherwise a later lease could alias
+  // memory a session is still reading.
+  tensorflow::TensorBuffer* buf = tensor->buffer;
+  if (TF_TensorType(tensor) == pool->dtype &&
+      TF_TensorByteSize(tensor) == pool->byte_size && buf->RefCountIsOne() &&
+      buf->root_buffer()->RefCountIsOne() && buf->OwnsMemory()) {
+    tensorflow::mutex_lock lock(pool->mu);
+    pool->available.push_back(tensor);
+    return;
+  }
+  TF_DeleteTensor(tensor);
+}
+
+void TF_DeleteTensorPool(TF_TensorPool* pool) {
+  if (pool == nullptr) return;
+  for (TF_Tensor* tensor : pool->available) {
+    TF_DeleteTensor(tensor);
+  }
+  delete pool;
+}
+
+void TF_SessionRunWithPreallocatedOutputs(
+    TF_Session* session, const TF_Buffer* run_options, const TF_Output* inputs,
+    TF_Tensor* const* input_values, int ninputs, const TF_Output* outputs,
+    TF_Tensor* const* output_values, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets,
+    TF_Buffer* run_metadata, TF_Status* status) {
+  std::vector<TF_Tensor*> fetched(noutputs, nullptr);
+  TF_SessionRun(session, run_options, inputs, input_values, ninputs, outputs,
+                fetched.data(), noutputs, target_opers, ntargets, run_metadata,
+                status);
+  if (TF_GetCode(status) == TF_OK) {
+    for (int i = 0; i < noutputs; ++i) {
+      if (TF_TensorType(fetched[i]) != TF_TensorType(output_values[i]) ||
+          TF_TensorByteSize(fetched[i]) !=
+              TF_TensorByteSize(output_values[i])) {
+        status->status = tensorflow::errors::InvalidArgument(
+            "Provided tensor for fetch ", i, " has dtype ",
+            TF_TensorType(output_values[i]), " and ",
+            TF_TensorByteSize(output_values[i]),
+            " bytes, but the fetched tensor has dtype ",
+            TF_TensorType(fetched[i]), " and ", TF_TensorByteSize(fetched[i]),
+            " bytes");
+        break;
+      }
+      std::memcpy(TF_TensorData(output_values[i]), TF_TensorData(fetched[i]),
+                  TF_TensorByteSize(fetched[i]));
+    }
+  }
+  for (TF_Tensor* tensor : fetched) {
+    if (tensor != nullptr) TF_DeleteTensor(tensor);
+  }
+}
+
+namespace {
+
+tensorflow::string CallableTensorName(const TF_Output& output) {
+  return tensorflow::strings::StrCat(output.oper->node.name(), ":",
+                                     output.index);
+}
+
+}  // namespace
+
+int64_t TF_SessionMakeCallable(TF_Session* session, const TF_Output* inputs,
+                               int ninputs, const TF_Output* outputs,
+                               int noutputs,
+                               const TF_Operation* const* target_opers,
+                               int ntargets, const TF_Buffer* run_options,
+                               TF_Status* status) {
+  if (session->extend_before_run &&
+      !tensorflow::ExtendSessionGraphHelper(session, status)) {
+    return -1;
+  }
+  tensorflow::CallableOptions callable_options;
+  for (int i = 0; i < ninputs; ++i) {
+    callable_options.add_feed(CallableTensorName(inputs[i]));
+  }
+  for (int i = 0; i < noutputs; ++i) {
+    callable_options.add_fetch(CallableTensorName(outputs[i]));
+  }
+  for (int i = 0; i < ntargets; ++i) {
+    callable_options.add_target(target_opers[i]->node.name());
+  }
+  if (run_options != nullptr && run_options->data != nullptr &&
+      !callable_options.mutable_run_options()->ParseFromArray(
+          run_options->data, run_options->length)) {
+    status->status =
+        tensorflow::errors::InvalidArgument("Unparseable RunOptions proto");
+    return -1;
+  }
+  tensorflow::Session::CallableHandle handle = -1;
+  status->status = session->session->MakeCallable(callable_options, &handle);
+  if (!status->status.ok()) return -1;
+  return handle;
+}
+
+void TF_SessionRunCallable(TF_Session* session, int64_t handle,
+                           TF_Tensor* const* feed_values, int nfeeds,
+                           TF_Tensor** fetch_values, int nfetches,
+                           TF_Buffer* run_metadata, TF_Status* status) {
+  std::vector<tensorflow::Tensor> feeds(nfeeds);
+  for (int i = 0; i < nfeeds; ++i) {
+    status->status = tensorflow::TF_TensorToTensor(feed_values[i], &feeds[i]);
+    if (!status->status.ok()) return;
+  }
+  std::vector<tensorflow::Tensor> fetches;
+  tensorflow::RunMetadata run_metadata_proto;
+  status->status = session->session->RunCallable(
+      handle, feeds, &fetches,
+      run_metadata != nullptr ? &run_metadata_proto : nullptr);
+  if (!status->status.ok()) return;
+  if (run_metadata != nullptr) {
+    status->status =
+        tensorflow::MessageToBuffer(run_metadata_proto, run_metadata);
+    if (!status->status.ok()) return;
+  }
+  if (static_cast<int>(fetches.size()) != nfetches) {
+    status->status = tensorflow::errors::InvalidArgument(
+        "Expected ", fetches.size(), " fetch tensors but the caller provided ",
+        "space for ", nfetches);
+    return;
+  }
+  for (int i = 0; i < nfetches; ++i) {
+    fetch_values[i] = tensorflow::TF_TensorFromTensor(fetches[i], status);
+    if (!status->status.ok()) return;
+  }
+}
+
+void TF_SessionReleaseCallable(TF_Session* session, int64_t handle,
+                               TF_Status* status) {
+  status->status = session->session->ReleaseCallable(handle);
+}
@@ -308,6 +308,85 @@ TF_CAPI_EXPORT extern TFE_TensorHandle*
 TFE_ConsumeInputConcreteTensorFromTraceContext(TFE_TraceContext* trace_ctx,
                                                unsigned int idx);
 
+// TF_TensorPool -------------------------------------------------------------
+//
+// A pool of interchangeable tensors of one fixed dtype and shape, for callers
+// that feed identically shaped tensors over and over (e.g. a serving layer).
+// Leasing a tensor from the pool reuses a previously returned buffer when one
+// is available, so the steady state performs no allocation.
+
+typedef struct TF_TensorPool TF_TensorPool;
+
+// Creates a pool of tensors of the given dtype and shape. Only dtypes with a
+// fixed element size are supported; returns NULL for TF_STRING and
+// TF_RESOURCE. The pool is thread-safe.
+TF_CAPI_EXPORT extern TF_TensorPool* TF_NewTensorPool(TF_DataType dtype,
+                                                      const int64_t* dims,
+                                                      int num_dims);
+
+// Takes a tensor from `pool`, allocating a fresh one only if the pool is
+// empty. The caller may fill the buffer via TF_TensorData() and must hand the
+// tensor back with TF_ReturnTensorToPool() (or TF_DeleteTensor()) when done.
+TF_CAPI_EXPORT extern TF_Tensor* TF_TensorPoolLease(TF_TensorPool* pool);
+
+// Returns a leased tensor to `pool` for reuse. If the runtime still holds a
+// reference to the tensor's buffer (e.g. a session kept the feed alive), the
+// buffer is released instead of recycled, so a subsequent lease can never
+// alias memory the runtime is still reading.
+TF_CAPI_EXPORT extern void TF_ReturnTensorToPool(TF_TensorPool* pool,
+                                                 TF_Tensor* tensor);
+
+// Deletes `pool` and the tensors it holds. Tensors currently leased from the
+// pool are unaffected, but must subsequently be released with
+// TF_DeleteTensor() rather than returned.
+TF_CAPI_EXPORT extern void TF_DeleteTensorPool(TF_TensorPool* pool);
+
+// Like TF_SessionRun(), but writes each fetch result into the corresponding
+// caller-provided tensor in `output_values` (e.g. tensors leased from a
+// TF_TensorPool) instead of returning newly allocated outputs. Each provided
+// tensor must match the fetched dtype and byte size exactly, otherwise an
+// InvalidArgument error is raised. The caller keeps ownership of
+// `output_values`, so output buffer addresses stay stable across calls.
+TF_CAPI_EXPORT extern void TF_SessionRunWithPreallocatedOutputs(
+    TF_Session* session, const TF_Buffer* run_options,
+    const TF_Output* inputs, TF_Tensor* const* input_values, int ninputs,
+    const TF_Output* outputs, TF_Tensor* const* output_values, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets,
+    TF_Buffer* run_metadata, TF_Status* status);
+
+// Pre-resolved callables ----------------------------------------------------
+//
+// TF_SessionRun() resolves feed/fetch names and re-keys into the session's
+// executor cache on every call. These functions expose Session::MakeCallable:
+// feeds, fetches and targets are bound once into an integer handle, and the
+// per-call cost of TF_SessionRunCallable() is only tensor conversion.
+
+// Binds the given feeds, fetches and targets into a callable and returns its
+// handle. `run_options` may be NULL, or a serialized RunOptions proto that is
+// applied to every invocation of the callable. Returns -1 on error. The
+// callable captures the session's graph as of this call; later graph
+// additions are not visible through it.
+TF_CAPI_EXPORT extern int64_t TF_SessionMakeCallable(
+    TF_Session* session, const TF_Output* inputs, int ninputs,
+    const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets,
+    const TF_Buffer* run_options, TF_Status* status);
+
+// Runs the callable created by TF_SessionMakeCallable(). `feed_values` must
+// match the inputs bound at creation, in order; the caller retains ownership
+// of them. On success, `fetch_values[i]` is set to a newly allocated tensor
+// for each bound fetch, owned by the caller. `run_metadata` may be NULL.
+TF_CAPI_EXPORT extern void TF_SessionRunCallable(
+    TF_Session* session, int64_t handle, TF_Tensor* const* feed_values,
+    int nfeeds, TF_Tensor** fetch_values, int nfetches,
+    TF_Buffer* run_metadata, TF_Status* status);
+
+// Releases the resources (partitioned graphs, executors) associated with the
+// callable handle.
+TF_CAPI_EXPORT extern void TF_SessionReleaseCallable(TF_Session* session,
+                                                     int64_t handle,
+                                                     TF_Status* status);
+
 #ifdef __cplusplus
 } /* end extern "C" */
 #endif
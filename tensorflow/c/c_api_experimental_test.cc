@@ -431,5 +431,126 @@ TEST_F(AddEagerOpToGraphTest,
   TFE_DeleteTensorHandle(matrix);
 }
 
+TEST(CAPI_EXPERIMENTAL, SessionCallable) {
+  TF_Status* s = TF_NewStatus();
+  TF_Graph* graph = TF_NewGraph();
+  TF_Operation* feed = Placeholder(graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* neg = Neg(feed, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_SessionOptions* opts = TF_NewSessionOptions();
+  TF_Session* session = TF_NewSession(graph, opts, s);
+  TF_DeleteSessionOptions(opts);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_Output feeds[] = {{feed, 0}};
+  TF_Output fetches[] = {{neg, 0}};
+  const int64_t handle = TF_SessionMakeCallable(
+      session, feeds, 1, fetches, 1, nullptr, 0, nullptr, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  // The resolved handle can be run repeatedly without re-binding.
+  for (int32_t value : {3, 5}) {
+    TF_Tensor* input = Int32Tensor(value);
+    TF_Tensor* output = nullptr;
+    TF_SessionRunCallable(session, handle, &input, 1, &output, 1, nullptr, s);
+    ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+    EXPECT_EQ(*static_cast<int32_t*>(TF_TensorData(output)), -value);
+    TF_DeleteTensor(input);
+    TF_DeleteTensor(output);
+  }
+
+  TF_SessionReleaseCallable(session, handle, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  // Running a released handle fails.
+  TF_Tensor* input = Int32Tensor(1);
+  TF_Tensor* output = nullptr;
+  TF_SessionRunCallable(session, handle, &input, 1, &output, 1, nullptr, s);
+  EXPECT_NE(TF_OK, TF_GetCode(s));
+  TF_DeleteTensor(input);
+
+  TF_CloseSession(session, s);
+  TF_DeleteSession(session, s);
+  TF_DeleteGraph(graph);
+  TF_DeleteStatus(s);
+}
+
+TEST(CAPI_EXPERIMENTAL, TensorPoolReusesReturnedTensors) {
+  const int64_t dims[] = {2, 2};
+  TF_TensorPool* pool = TF_NewTensorPool(TF_FLOAT, dims, 2);
+  ASSERT_NE(pool, nullptr);
+
+  TF_Tensor* t1 = TF_TensorPoolLease(pool);
+  TF_Tensor* t2 = TF_TensorPoolLease(pool);
+  ASSERT_NE(t1, nullptr);
+  ASSERT_NE(t2, nullptr);
+  EXPECT_NE(t1, t2);
+  EXPECT_EQ(TF_TensorType(t1), TF_FLOAT);
+  EXPECT_EQ(TF_NumDims(t1), 2);
+  EXPECT_EQ(TF_TensorByteSize(t1), 4 * sizeof(float));
+
+  // A returned tensor is handed out again on the next lease.
+  TF_ReturnTensorToPool(pool, t1);
+  TF_Tensor* t3 = TF_TensorPoolLease(pool);
+  EXPECT_EQ(t3, t1);
+
+  TF_ReturnTensorToPool(pool, t2);
+  TF_ReturnTensorToPool(pool, t3);
+  TF_DeleteTensorPool(pool);
+
+  // Variable-length dtypes cannot be pooled.
+  EXPECT_EQ(TF_NewTensorPool(TF_STRING, dims, 2), nullptr);
+}
+
+TEST(CAPI_EXPERIMENTAL, SessionRunWithPreallocatedOutputs) {
+  TF_Status* s = TF_NewStatus();
+  TF_Graph* graph = TF_NewGraph();
+  TF_Operation* feed = Placeholder(graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* neg = Neg(feed, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_SessionOptions* opts = TF_NewSessionOptions();
+  TF_Session* session = TF_NewSession(graph, opts, s);
+  TF_DeleteSessionOptions(opts);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_TensorPool* pool = TF_NewTensorPool(TF_INT32, nullptr, 0);
+  TF_Tensor* input = TF_TensorPoolLease(pool);
+  TF_Tensor* output = TF_TensorPoolLease(pool);
+  *static_cast<int32_t*>(TF_TensorData(input)) = 7;
+  void* output_buffer = TF_TensorData(output);
+
+  TF_Output feeds[] = {{feed, 0}};
+  TF_Output fetches[] = {{neg, 0}};
+  TF_SessionRunWithPreallocatedOutputs(session, nullptr, feeds, &input, 1,
+                                       fetches, &output, 1, nullptr, 0,
+                                       nullptr, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  // The result lands in the caller's buffer, whose address is unchanged.
+  EXPECT_EQ(TF_TensorData(output), output_buffer);
+  EXPECT_EQ(*static_cast<int32_t*>(TF_TensorData(output)), -7);
+
+  // A dtype mismatch on the provided output tensor is an error.
+  TF_Tensor* bad_output = TF_AllocateTensor(TF_FLOAT, nullptr, 0,
+                                            sizeof(float));
+  TF_SessionRunWithPreallocatedOutputs(session, nullptr, feeds, &input, 1,
+                                       fetches, &bad_output, 1, nullptr, 0,
+                                       nullptr, s);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(s));
+  TF_DeleteTensor(bad_output);
+
+  TF_ReturnTensorToPool(pool, input);
+  TF_ReturnTensorToPool(pool, output);
+  TF_DeleteTensorPool(pool);
+
+  TF_CloseSession(session, s);
+  TF_DeleteSession(session, s);
+  TF_DeleteGraph(graph);
+  TF_DeleteStatus(s);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -15,10 +15,15 @@ limitations under the License.
 
 #include "tensorflow/cc/client/client_session.h"
 
+#include <algorithm>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -27,6 +32,30 @@ limitations under the License.
 
 namespace tensorflow {
 
+// A TensorBuffer that refers to caller-owned memory, allowing a user buffer
+// to be fed to the graph without a copy. The caller is responsible for
+// keeping the memory alive for as long as any tensor refers to it.
+class BorrowedTensorBuffer : public TensorBuffer {
+ public:
+  BorrowedTensorBuffer(void* data, size_t len)
+      : TensorBuffer(data), len_(len) {}
+
+  size_t size() const override { return len_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(len_);
+    proto->set_allocator_name("borrowed");
+  }
+  bool OwnsMemory() const override { return false; }
+
+  Tensor MakeTensor(DataType dtype, const TensorShape& shape) {
+    return Tensor(dtype, shape, this);
+  }
+
+ private:
+  const size_t len_;
+};
+
 class ClientSession::Impl {
  private:
   friend class ClientSession;
@@ -42,6 +71,11 @@ class ClientSession::Impl {
 
   mutable mutex mu_;
   mutable int last_num_graph_nodes_ GUARDED_BY(mu_) = 0;
+
+  // Callables created by `RunCached`, keyed by the feed/fetch signature.
+  mutable mutex callables_mu_;
+  mutable std::unordered_map<string, Session::CallableHandle> callables_
+      GUARDED_BY(callables_mu_);
 };
 
 ClientSession::ClientSession(const Scope& scope, const string& target)
@@ -127,6 +161,102 @@ Status ClientSession::Run(const RunOptions& run_options, const FeedType& inputs,
                                target_node_names, outputs, run_metadata);
 }
 
+Status ClientSession::RunCached(const FeedType& inputs,
+                                const std::vector<Output>& fetch_outputs,
+                                std::vector<Tensor>* outputs) const {
+  return RunCached(inputs, fetch_outputs, outputs, nullptr);
+}
+
+Status ClientSession::RunCached(const FeedType& inputs,
+                                const std::vector<Output>& fetch_outputs,
+                                std::vector<Tensor>* outputs,
+                                RunMetadata* run_metadata) const {
+  // Canonicalize the feed order so that equal feed sets map to the same
+  // callable regardless of the map's iteration order.
+  std::vector<const FeedType::value_type*> feeds;
+  feeds.reserve(inputs.size());
+  for (const auto& feed : inputs) {
+    TF_RETURN_IF_ERROR(feed.second.status);
+    feeds.push_back(&feed);
+  }
+  std::sort(feeds.begin(), feeds.end(),
+            [](const FeedType::value_type* a, const FeedType::value_type* b) {
+              if (a->first.node()->id() != b->first.node()->id()) {
+                return a->first.node()->id() < b->first.node()->id();
+              }
+              return a->first.index() < b->first.index();
+            });
+
+  // The cache key is built from graph node ids rather than names, so a cache
+  // hit does not materialize any tensor names.
+  string key;
+  for (const auto* feed : feeds) {
+    strings::StrAppend(&key, feed->first.node()->id(), ":",
+                       feed->first.index(), ",");
+  }
+  strings::StrAppend(&key, "|");
+  for (const auto& fetch : fetch_outputs) {
+    strings::StrAppend(&key, fetch.node()->id(), ":", fetch.index(), ",");
+  }
+
+  Session::CallableHandle handle;
+  bool found = false;
+  {
+    mutex_lock l(impl()->callables_mu_);
+    auto it = impl()->callables_.find(key);
+    if (it != impl()->callables_.end()) {
+      handle = it->second;
+      found = true;
+    }
+  }
+  if (!found) {
+    CallableOptions callable_options;
+    for (const auto* feed : feeds) {
+      callable_options.add_feed(feed->first.name());
+    }
+    for (const auto& fetch : fetch_outputs) {
+      callable_options.add_fetch(fetch.name());
+    }
+    TF_RETURN_IF_ERROR(impl()->MaybeExtendGraph());
+    TF_RETURN_IF_ERROR(
+        impl()->session_->MakeCallable(callable_options, &handle));
+    mutex_lock l(impl()->callables_mu_);
+    auto insert_result = impl()->callables_.emplace(key, handle);
+    if (!insert_result.second) {
+      // Another thread created the same callable concurrently; use theirs.
+      impl()->session_->ReleaseCallable(handle).IgnoreError();
+      handle = insert_result.first->second;
+    }
+  }
+
+  std::vector<Tensor> feed_tensors;
+  feed_tensors.reserve(feeds.size());
+  for (const auto* feed : feeds) {
+    feed_tensors.push_back(feed->second.tensor);
+  }
+  return impl()->session_->RunCallable(handle, feed_tensors, outputs,
+                                       run_metadata);
+}
+
+Status ClientSession::TensorFromBorrowedBuffer(DataType dtype,
+                                               const TensorShape& shape,
+                                               void* data, Tensor* out) {
+  if (!DataTypeCanUseMemcpy(dtype)) {
+    return errors::InvalidArgument(
+        "Cannot borrow a buffer for tensors of type ", DataTypeString(dtype));
+  }
+  if (reinterpret_cast<intptr_t>(data) % EIGEN_MAX_ALIGN_BYTES != 0) {
+    return errors::InvalidArgument("Borrowed buffers must be aligned to ",
+                                   EIGEN_MAX_ALIGN_BYTES, " bytes");
+  }
+  const size_t len = shape.num_elements() * DataTypeSize(dtype);
+  BorrowedTensorBuffer* buf = new BorrowedTensorBuffer(data, len);
+  // The tensor acquires its own reference on 'buf'.
+  *out = buf->MakeTensor(dtype, shape);
+  buf->Unref();
+  return Status::OK();
+}
+
 Status ClientSession::MakeCallable(const CallableOptions& callable_options,
                                    CallableHandle* out_handle) {
   TF_RETURN_IF_ERROR(impl()->MaybeExtendGraph());
@@ -87,6 +87,34 @@ class ClientSession {
              const std::vector<Operation>& run_outputs,
              std::vector<Tensor>* outputs, RunMetadata* run_metadata) const;
 
+  /// Same as `Run`, but caches the underlying `Session` callable keyed by the
+  /// feed and fetch `Output` sets. Repeated calls with the same signature
+  /// reuse the cached callable and bind feeds by their position in the graph,
+  /// skipping the per-call tensor name materialization and resolution that
+  /// `Run` performs. Best suited for hot loops that run one signature many
+  /// times. Cached callables live until the session is destroyed.
+  Status RunCached(const FeedType& inputs,
+                   const std::vector<Output>& fetch_outputs,
+                   std::vector<Tensor>* outputs) const;
+
+  /// Same as above. `run_metadata`, if not null, is filled in with the
+  /// execution results. Per-call `RunOptions` are not supported; to customize
+  /// them, use `MakeCallable` with `CallableOptions::run_options` directly.
+  Status RunCached(const FeedType& inputs,
+                   const std::vector<Output>& fetch_outputs,
+                   std::vector<Tensor>* outputs,
+                   RunMetadata* run_metadata) const;
+
+  /// Wraps the caller-owned buffer `data` as a tensor of the given type and
+  /// shape, without copying, so it can be fed to a `Run` call. `data` must
+  /// hold `shape.num_elements()` elements of `dtype`, be aligned to
+  /// `EIGEN_MAX_ALIGN_BYTES`, and remain valid and unmodified until every
+  /// `Run` call fed with the tensor has returned. Only simple types are
+  /// supported (in particular not `DT_STRING`).
+  static Status TensorFromBorrowedBuffer(DataType dtype,
+                                         const TensorShape& shape, void* data,
+                                         Tensor* out);
+
   /// \brief A handle to a subgraph, created with
   /// `ClientSession::MakeCallable()`.
   typedef int64 CallableHandle;
@@ -69,6 +69,51 @@ TEST(ClientSessionTest, Extend) {
   test::ExpectTensorEqual<int>(outputs[0], test::AsTensor<int>({31, 42}, {2}));
 }
 
+TEST(ClientSessionTest, RunCached) {
+  Scope root = Scope::NewRootScope();
+  auto a = Placeholder(root, DT_INT32);
+  auto b = Placeholder(root, DT_INT32);
+  auto c = Add(root, a, b);
+  auto d = Mul(root, a, b);
+  ClientSession session(root);
+  std::vector<Tensor> outputs;
+
+  // Repeated calls with the same signature reuse the cached callable.
+  TF_EXPECT_OK(session.RunCached({{a, 1}, {b, 41}}, {c}, &outputs));
+  test::ExpectTensorEqual<int>(outputs[0], test::AsTensor<int>({42}, {}));
+  TF_EXPECT_OK(session.RunCached({{a, 2}, {b, 40}}, {c}, &outputs));
+  test::ExpectTensorEqual<int>(outputs[0], test::AsTensor<int>({42}, {}));
+
+  // A different fetch set is a different signature.
+  TF_EXPECT_OK(session.RunCached({{a, 6}, {b, 7}}, {d}, &outputs));
+  test::ExpectTensorEqual<int>(outputs[0], test::AsTensor<int>({42}, {}));
+}
+
+TEST(ClientSessionTest, TensorFromBorrowedBuffer) {
+  Scope root = Scope::NewRootScope();
+  auto a = Placeholder(root, DT_INT32, Placeholder::Shape({2}));
+  auto c = Add(root, a, {1, 1});
+  ClientSession session(root);
+  std::vector<Tensor> outputs;
+
+  alignas(EIGEN_MAX_ALIGN_BYTES) int data[4] = {1, 41, 0, 0};
+  Tensor feed;
+  TF_ASSERT_OK(
+      ClientSession::TensorFromBorrowedBuffer(DT_INT32, {2}, data, &feed));
+  // The tensor aliases the caller's buffer rather than copying it.
+  EXPECT_EQ(reinterpret_cast<const char*>(data), feed.tensor_data().data());
+  TF_EXPECT_OK(session.Run({{a, feed}}, {c}, &outputs));
+  test::ExpectTensorEqual<int>(outputs[0], test::AsTensor<int>({2, 42}, {2}));
+
+  // Misaligned buffers and string tensors are rejected.
+  Tensor bad;
+  EXPECT_FALSE(
+      ClientSession::TensorFromBorrowedBuffer(DT_INT32, {1}, data + 1, &bad)
+          .ok());
+  EXPECT_FALSE(
+      ClientSession::TensorFromBorrowedBuffer(DT_STRING, {2}, data, &bad).ok());
+}
+
 TEST(ClientSessionTest, MultiThreaded) {
   Scope root = Scope::NewRootScope();
   auto a = Add(root, {1, 2}, {3, 4});
@@ -39,6 +39,13 @@ constexpr char kSavedModelLegacyInitOpKey[] = "legacy_init_op";
 /// SavedModel main op collection key. Used in v1 SavedModels.
 constexpr char kSavedModelMainOpKey[] = "saved_model_main_op";
 
+/// Filename of an optional memmapped package in the export directory, holding
+/// the graph def with its large constants converted to ImmutableConst nodes
+/// (see tensorflow/core/util/convert_graphdef_memmapped_format.h). When
+/// present, the loader serves the weights directly from the memmapped file.
+constexpr char kSavedModelMemmappedPackageFilename[] =
+    "graph.memmapped_package";
+
 /// Directory in which to save the SavedModel variables.
 constexpr char kSavedModelVariablesDirectory[] = "variables";
 
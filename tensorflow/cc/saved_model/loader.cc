@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/loader.h"
 
+#include <memory>
 #include <unordered_set>
 
 #include "tensorflow/cc/saved_model/constants.h"
@@ -29,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/memmapped_file_system.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 
 namespace tensorflow {
@@ -257,17 +259,88 @@ Status GetAssetFileDefs(const MetaGraphDef& meta_graph_def,
   return Status::OK();
 }
 
+// If the export directory contains a memmapped package of the graph's large
+// constants (see tensorflow/core/util/convert_graphdef_memmapped_format.h),
+// replaces the graph def in the bundle with the converted one stored in the
+// package and points session_options->env at an environment that resolves the
+// memory regions of the graph's ImmutableConst nodes. The environment is
+// owned by the bundle, which keeps it alive longer than the session.
+Status MaybeLoadMemmappedPackage(const string& export_dir,
+                                 SessionOptions* session_options,
+                                 SavedModelBundle* bundle) {
+  const string package_path =
+      io::JoinPath(export_dir, kSavedModelMemmappedPackageFilename);
+  if (!session_options->env->FileExists(package_path).ok()) {
+    return Status::OK();
+  }
+  LOG(INFO) << "Serving weights from memmapped package: " << package_path;
+  std::unique_ptr<MemmappedEnv> memmapped_env(
+      new MemmappedEnv(session_options->env));
+  TF_RETURN_IF_ERROR(memmapped_env->InitializeFromFile(package_path));
+  TF_RETURN_IF_ERROR(ReadBinaryProto(
+      memmapped_env.get(),
+      MemmappedFileSystem::kMemmappedPackageDefaultGraphDef,
+      bundle->meta_graph_def.mutable_graph_def()));
+  session_options->env = memmapped_env.get();
+  bundle->memmapped_env = std::move(memmapped_env);
+  return Status::OK();
+}
+
+// Warms the file system cache for the variable checkpoint shards by reading
+// each shard on a background thread. Scheduled before the session is created,
+// this overlaps the bulk of the checkpoint I/O with graph optimization, and
+// the per-shard threads give the parallelism that the single restore op does
+// not. Best-effort: read failures are ignored here and surface through the
+// restore op instead.
+void PrefetchVariableShards(const string& export_dir) {
+  const string variables_directory =
+      io::JoinPath(export_dir, kSavedModelVariablesDirectory);
+  const string shards_pattern =
+      io::JoinPath(variables_directory,
+                   strings::StrCat(kSavedModelVariablesFilename, ".data-*"));
+  std::vector<string> shard_paths;
+  if (!Env::Default()->GetMatchingPaths(shards_pattern, &shard_paths).ok()) {
+    return;
+  }
+  for (const string& shard_path : shard_paths) {
+    Env::Default()->SchedClosure([shard_path]() {
+      std::unique_ptr<RandomAccessFile> file;
+      if (!Env::Default()->NewRandomAccessFile(shard_path, &file).ok()) {
+        return;
+      }
+      constexpr size_t kReadChunkBytes = 8 << 20;
+      std::unique_ptr<char[]> scratch(new char[kReadChunkBytes]);
+      uint64 offset = 0;
+      while (true) {
+        StringPiece chunk;
+        const Status read_status =
+            file->Read(offset, kReadChunkBytes, &chunk, scratch.get());
+        offset += chunk.size();
+        // A short read (OUT_OF_RANGE) marks the end of the shard.
+        if (!read_status.ok()) break;
+      }
+    });
+  }
+}
+
 Status LoadSavedModelInternal(const SessionOptions& session_options,
                               const RunOptions& run_options,
+                              const SavedModelLoaderOptions& loader_options,
                               const string& export_dir,
                               const std::unordered_set<string>& tags,
                               SavedModelBundle* const bundle) {
   const uint64 read_start_microseconds = Env::Default()->NowMicros();
   TF_RETURN_IF_ERROR(ReadMetaGraphDefFromSavedModel(export_dir, tags,
                                                     &bundle->meta_graph_def));
+  if (loader_options.prefetch_variable_shards) {
+    PrefetchVariableShards(export_dir);
+  }
 
+  SessionOptions load_options = session_options;
+  TF_RETURN_IF_ERROR(
+      MaybeLoadMemmappedPackage(export_dir, &load_options, bundle));
   TF_RETURN_IF_ERROR(LoadMetaGraphIntoSession(
-      bundle->meta_graph_def, session_options, &bundle->session));
+      bundle->meta_graph_def, load_options, &bundle->session));
 
   std::vector<AssetFileDef> asset_file_defs;
   TF_RETURN_IF_ERROR(
@@ -294,6 +367,16 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
   // Record wall time spent in init op.
   load_latency_by_stage->GetCell(export_dir, "init_graph")
       ->Add(GetLatencyMicroseconds(graph_init_start_microseconds));
+
+  if (loader_options.warmup_fn) {
+    const uint64 warmup_start_microseconds = Env::Default()->NowMicros();
+    LOG(INFO) << "Running warmup requests on SavedModel bundle at path: "
+              << export_dir;
+    TF_RETURN_IF_ERROR(loader_options.warmup_fn(bundle->session.get(),
+                                                bundle->meta_graph_def));
+    load_latency_by_stage->GetCell(export_dir, "warmup")
+        ->Add(GetLatencyMicroseconds(warmup_start_microseconds));
+  }
   return Status::OK();
 }
 
@@ -303,10 +386,21 @@ Status LoadSavedModel(const SessionOptions& session_options,
                       const RunOptions& run_options, const string& export_dir,
                       const std::unordered_set<string>& tags,
                       SavedModelBundle* const bundle) {
+  return LoadSavedModel(session_options, run_options, SavedModelLoaderOptions(),
+                        export_dir, tags, bundle);
+}
+
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options,
+                      const SavedModelLoaderOptions& loader_options,
+                      const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      SavedModelBundle* const bundle) {
   // TODO(robson): Add tests for the counters.
   const uint64 start_microseconds = Env::Default()->NowMicros();
-  const Status status = LoadSavedModelInternal(session_options, run_options,
-                                               export_dir, tags, bundle);
+  const Status status =
+      LoadSavedModelInternal(session_options, run_options, loader_options,
+                             export_dir, tags, bundle);
   auto log_and_count = [&](const string& status_str) {
     LOG(INFO) << "SavedModel load for tags { " << str_util::Join(tags, " ")
               << " }; Status: " << status_str << ". Took "
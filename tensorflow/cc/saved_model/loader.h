@@ -18,10 +18,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CC_SAVED_MODEL_LOADER_H_
 #define TENSORFLOW_CC_SAVED_MODEL_LOADER_H_
 
+#include <functional>
 #include <string>
 #include <unordered_set>
 
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/public/session.h"
 
@@ -29,6 +31,11 @@ namespace tensorflow {
 
 /// SavedModel representation once the SavedModel is loaded from storage.
 struct SavedModelBundle {
+  /// Set only when the export directory contains a memmapped package of the
+  /// graph's weights: an environment that resolves the memory regions of the
+  /// graph's ImmutableConst nodes. Declared before the session so that it
+  /// outlives it.
+  std::unique_ptr<Env> memmapped_env;
   std::unique_ptr<Session> session;
   MetaGraphDef meta_graph_def;
 
@@ -43,6 +50,23 @@ struct SavedModelBundle {
   SavedModelBundle() = default;
 };
 
+/// Optional tuning knobs and hooks for LoadSavedModel.
+struct SavedModelLoaderOptions {
+  /// If true, the variable checkpoint shards are read into the file system
+  /// cache by parallel background threads that overlap with session creation
+  /// and graph optimization, so the restore op mostly hits warm pages. The
+  /// reads are best-effort; I/O errors surface through the restore op.
+  bool prefetch_variable_shards = false;
+
+  /// If set, invoked with the freshly loaded session and meta graph def after
+  /// the restore and init ops have run, before LoadSavedModel returns.
+  /// Intended for replaying recorded sample requests so that executors,
+  /// allocators and kernel caches are primed before the replica starts
+  /// serving. A non-OK status fails the load.
+  std::function<Status(Session* session, const MetaGraphDef& meta_graph_def)>
+      warmup_fn;
+};
+
 /// Loads a SavedModel from the specified export directory. The meta graph def
 /// to be loaded is identified by the supplied tags, corresponding exactly to
 /// the set of tags used at SavedModel build time. Returns a SavedModel bundle
@@ -52,6 +76,14 @@ Status LoadSavedModel(const SessionOptions& session_options,
                       const std::unordered_set<string>& tags,
                       SavedModelBundle* const bundle);
 
+/// Like the above, but additionally honors the supplied loader options.
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options,
+                      const SavedModelLoaderOptions& loader_options,
+                      const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      SavedModelBundle* const bundle);
+
 /// Checks whether the provided directory could contain a SavedModel. Note that
 /// the method does not load any data by itself. If the method returns `false`,
 /// the export directory definitely does not contain a SavedModel. If the method
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
@@ -229,6 +230,55 @@ TEST_F(LoaderTest, MaybeSavedModelDirectory) {
   EXPECT_FALSE(MaybeSavedModelDirectory(invalid_export_dir));
 }
 
+TEST_F(LoaderTest, LoaderOptionsPrefetchAndWarmup) {
+  SavedModelBundle bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+  SavedModelLoaderOptions loader_options;
+  loader_options.prefetch_variable_shards = true;
+  int num_warmup_calls = 0;
+  loader_options.warmup_fn = [&](Session* session,
+                                 const MetaGraphDef& meta_graph_def) {
+    ++num_warmup_calls;
+    // Replay a recorded sample request against the regression signature.
+    const auto& signature_def =
+        meta_graph_def.signature_def().at("regress_x_to_y");
+    const string input_name = signature_def.inputs().at(kRegressInputs).name();
+    const string output_name =
+        signature_def.outputs().at(kRegressOutputs).name();
+    Tensor input = test::AsTensor<string>({MakeSerializedExample(0)},
+                                          TensorShape({1}));
+    std::vector<Tensor> outputs;
+    return session->Run({{input_name, input}}, {output_name}, {}, &outputs);
+  };
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  TF_ASSERT_OK(LoadSavedModel(session_options, run_options, loader_options,
+                              export_dir, {kSavedModelTagServe}, &bundle));
+  EXPECT_EQ(1, num_warmup_calls);
+  CheckSavedModelBundle(export_dir, bundle);
+}
+
+TEST_F(LoaderTest, WarmupFailureFailsLoad) {
+  SavedModelBundle bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+  SavedModelLoaderOptions loader_options;
+  loader_options.warmup_fn = [](Session* session,
+                                const MetaGraphDef& meta_graph_def) {
+    return errors::Internal("warmup failed");
+  };
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  Status st = LoadSavedModel(session_options, run_options, loader_options,
+                             export_dir, {kSavedModelTagServe}, &bundle);
+  EXPECT_FALSE(st.ok());
+  EXPECT_TRUE(str_util::StrContains(st.error_message(), "warmup failed"))
+      << st.error_message();
+}
+
 TEST_F(LoaderTest, SavedModelInitOpV2Format) {
   SavedModelBundle bundle;
   SessionOptions session_options;
@@ -15,44 +15,192 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/reader.h"
 
+#include <limits>
+#include <memory>
 #include <unordered_set>
 
 #include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/protobuf/saved_model.pb.h"
 
 namespace tensorflow {
 namespace {
 
-Status ReadSavedModel(const string& export_dir, SavedModel* saved_model_proto) {
-  LOG(INFO) << "Reading SavedModel from: " << export_dir;
+// Wire-format field numbers used by the streaming parser below.
+// SavedModel.meta_graphs
+constexpr int kMetaGraphsFieldNumber = 2;
+// MetaGraphDef.meta_info_def
+constexpr int kMetaInfoDefFieldNumber = 1;
 
-  const string saved_model_pb_path =
-      io::JoinPath(export_dir, kSavedModelFilenamePb);
-  if (Env::Default()->FileExists(saved_model_pb_path).ok()) {
-    return ReadBinaryProto(Env::Default(), saved_model_pb_path,
-                           saved_model_proto);
+Status MetaGraphDefNotFound(const std::unordered_set<string>& tags) {
+  return Status(
+      error::Code::NOT_FOUND,
+      strings::StrCat(
+          "Could not find meta graph def matching supplied tags: { ",
+          str_util::Join(tags, " "),
+          " }. To inspect available tag-sets in the SavedModel, please "
+          "use the SavedModel CLI: `saved_model_cli`"));
+}
+
+// A ZeroCopyInputStream over a RandomAccessFile, starting at a given offset.
+// (Mirrors the stream that ReadBinaryProto in platform/env.cc uses
+// internally, which is not exported.)
+class FileStream : public protobuf::io::ZeroCopyInputStream {
+ public:
+  FileStream(RandomAccessFile* file, uint64 offset)
+      : file_(file),
+        pos_(offset),
+        start_(offset),
+        scratch_(new char[kBufSize]) {}
+
+  void BackUp(int count) override { pos_ -= count; }
+  bool Skip(int count) override {
+    pos_ += count;
+    return true;
   }
-  const string saved_model_pbtxt_path =
-      io::JoinPath(export_dir, kSavedModelFilenamePbTxt);
-  if (Env::Default()->FileExists(saved_model_pbtxt_path).ok()) {
-    return ReadTextProto(Env::Default(), saved_model_pbtxt_path,
-                         saved_model_proto);
+  protobuf_int64 ByteCount() const override { return pos_ - start_; }
+  Status status() const { return status_; }
+
+  bool Next(const void** data, int* size) override {
+    StringPiece result;
+    Status s = file_->Read(pos_, kBufSize, &result, scratch_.get());
+    if (result.empty()) {
+      status_ = s;
+      return false;
+    }
+    pos_ += result.size();
+    *data = result.data();
+    *size = result.size();
+    return true;
   }
-  return Status(error::Code::NOT_FOUND,
-                "Could not find SavedModel .pb or .pbtxt at supplied export "
-                "directory path: " +
-                    export_dir);
+
+ private:
+  static constexpr int kBufSize = 512 << 10;
+
+  RandomAccessFile* file_;
+  uint64 pos_;
+  const uint64 start_;
+  Status status_;
+  const std::unique_ptr<char[]> scratch_;
+};
+
+// Reads just the tag set of the serialized MetaGraphDef occupying 'size'
+// bytes at 'offset' in 'file', skipping over every other field (in
+// particular the graph def, which is never read from disk).
+Status ReadMetaGraphTags(RandomAccessFile* file, uint64 offset, uint64 size,
+                         std::unordered_set<string>* graph_tags) {
+  FileStream stream(file, offset);
+  protobuf::io::CodedInputStream coded(&stream);
+  coded.SetTotalBytesLimit(std::numeric_limits<int>::max(), -1);
+  const auto limit = coded.PushLimit(size);
+  while (true) {
+    const uint32 tag = coded.ReadTag();
+    if (tag == 0) break;  // Reached the end of the meta graph.
+    if (protobuf::internal::WireFormatLite::GetTagFieldNumber(tag) ==
+            kMetaInfoDefFieldNumber &&
+        protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32 info_size;
+      if (!coded.ReadVarint32(&info_size)) {
+        return errors::DataLoss("Corrupt MetaGraphDef in SavedModel");
+      }
+      const auto info_limit = coded.PushLimit(info_size);
+      MetaGraphDef::MetaInfoDef meta_info_def;
+      if (!meta_info_def.ParseFromCodedStream(&coded) ||
+          !coded.ConsumedEntireMessage()) {
+        return errors::DataLoss("Corrupt MetaGraphDef in SavedModel");
+      }
+      coded.PopLimit(info_limit);
+      for (const string& graph_tag : meta_info_def.tags()) {
+        graph_tags->insert(graph_tag);
+      }
+    } else if (!protobuf::internal::WireFormatLite::SkipField(&coded, tag)) {
+      return errors::DataLoss("Corrupt MetaGraphDef in SavedModel");
+    }
+  }
+  coded.PopLimit(limit);
+  return stream.status().ok() || errors::IsOutOfRange(stream.status())
+             ? Status::OK()
+             : stream.status();
+}
+
+// Streams over the MetaGraphDefs in the binary SavedModel at
+// 'saved_model_pb_path', parsing only the first one whose tag set equals
+// 'tags' directly into 'meta_graph_def'. Non-matching meta graphs are
+// skipped without being materialized and the file is never read into memory
+// as a whole, so peak memory stays near the size of the selected meta graph
+// rather than a multiple of the file size. A fresh coded stream is used per
+// meta graph, so the usual proto size limits apply per meta graph rather
+// than to the SavedModel as a whole.
+Status StreamMetaGraphDefFromFile(const string& saved_model_pb_path,
+                                  const std::unordered_set<string>& tags,
+                                  MetaGraphDef* meta_graph_def) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(
+      Env::Default()->NewRandomAccessFile(saved_model_pb_path, &file));
+
+  uint64 offset = 0;
+  while (true) {
+    FileStream stream(file.get(), offset);
+    protobuf::io::CodedInputStream coded(&stream);
+    coded.SetTotalBytesLimit(std::numeric_limits<int>::max(), -1);
+    const uint32 tag = coded.ReadTag();
+    if (tag == 0) {
+      if (!stream.status().ok() && !errors::IsOutOfRange(stream.status())) {
+        return stream.status();
+      }
+      break;  // Reached the end of the file.
+    }
+    if (protobuf::internal::WireFormatLite::GetTagFieldNumber(tag) ==
+            kMetaGraphsFieldNumber &&
+        protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32 size;
+      if (!coded.ReadVarint32(&size)) {
+        return errors::DataLoss("Can't parse ", saved_model_pb_path,
+                                " as binary proto");
+      }
+      const uint64 payload_offset = offset + coded.CurrentPosition();
+      std::unordered_set<string> graph_tags;
+      TF_RETURN_IF_ERROR(
+          ReadMetaGraphTags(file.get(), payload_offset, size, &graph_tags));
+      if (graph_tags == tags) {
+        // Parse the selected meta graph directly into the caller's proto, so
+        // no intermediate SavedModel or MetaGraphDef copy is made.
+        FileStream payload_stream(file.get(), payload_offset);
+        protobuf::io::CodedInputStream payload_coded(&payload_stream);
+        payload_coded.SetTotalBytesLimit(std::numeric_limits<int>::max(), -1);
+        const auto limit = payload_coded.PushLimit(size);
+        if (!meta_graph_def->ParseFromCodedStream(&payload_coded) ||
+            !payload_coded.ConsumedEntireMessage()) {
+          TF_RETURN_IF_ERROR(payload_stream.status());
+          return errors::DataLoss("Can't parse ", saved_model_pb_path,
+                                  " as binary proto");
+        }
+        payload_coded.PopLimit(limit);
+        return Status::OK();
+      }
+      offset = payload_offset + size;
+    } else {
+      // Some other SavedModel field (e.g. the schema version); skip it.
+      if (!protobuf::internal::WireFormatLite::SkipField(&coded, tag)) {
+        return errors::DataLoss("Can't parse ", saved_model_pb_path,
+                                " as binary proto");
+      }
+      offset += coded.CurrentPosition();
+    }
+  }
+  return MetaGraphDefNotFound(tags);
 }
 
 Status FindMetaGraphDef(const SavedModel& saved_model_proto,
                         const std::unordered_set<string>& tags,
                         MetaGraphDef* meta_graph_def) {
-  LOG(INFO) << "Reading meta graph with tags { " << str_util::Join(tags, " ")
-            << " }";
   for (const MetaGraphDef& graph_def : saved_model_proto.meta_graphs()) {
     // Get tags from the graph_def.
     std::unordered_set<string> graph_tags;
@@ -65,13 +213,7 @@ Status FindMetaGraphDef(const SavedModel& saved_model_proto,
       return Status::OK();
     }
   }
-  return Status(
-      error::Code::NOT_FOUND,
-      strings::StrCat(
-          "Could not find meta graph def matching supplied tags: { ",
-          str_util::Join(tags, " "),
-          " }. To inspect available tag-sets in the SavedModel, please "
-          "use the SavedModel CLI: `saved_model_cli`"));
+  return MetaGraphDefNotFound(tags);
 }
 
 }  // namespace
@@ -79,10 +221,28 @@ Status FindMetaGraphDef(const SavedModel& saved_model_proto,
 Status ReadMetaGraphDefFromSavedModel(const string& export_dir,
                                       const std::unordered_set<string>& tags,
                                       MetaGraphDef* const meta_graph_def) {
-  SavedModel saved_model_proto;
-  TF_RETURN_IF_ERROR(ReadSavedModel(export_dir, &saved_model_proto));
-  TF_RETURN_IF_ERROR(FindMetaGraphDef(saved_model_proto, tags, meta_graph_def));
-  return Status::OK();
+  LOG(INFO) << "Reading SavedModel from: " << export_dir;
+  LOG(INFO) << "Reading meta graph with tags { " << str_util::Join(tags, " ")
+            << " }";
+
+  const string saved_model_pb_path =
+      io::JoinPath(export_dir, kSavedModelFilenamePb);
+  if (Env::Default()->FileExists(saved_model_pb_path).ok()) {
+    return StreamMetaGraphDefFromFile(saved_model_pb_path, tags,
+                                      meta_graph_def);
+  }
+  const string saved_model_pbtxt_path =
+      io::JoinPath(export_dir, kSavedModelFilenamePbTxt);
+  if (Env::Default()->FileExists(saved_model_pbtxt_path).ok()) {
+    SavedModel saved_model_proto;
+    TF_RETURN_IF_ERROR(ReadTextProto(Env::Default(), saved_model_pbtxt_path,
+                                     &saved_model_proto));
+    return FindMetaGraphDef(saved_model_proto, tags, meta_graph_def);
+  }
+  return Status(error::Code::NOT_FOUND,
+                "Could not find SavedModel .pb or .pbtxt at supplied export "
+                "directory path: " +
+                    export_dir);
 }
 
 }  // namespace tensorflow
@@ -226,4 +226,35 @@ Status FreezeSavedModel(const SavedModelBundle& saved_model_bundle,
   return Status::OK();
 }
 
+Status FreezeSavedModelInPlace(const SessionOptions& session_options,
+                               SavedModelBundle* saved_model_bundle) {
+  GraphDef frozen_graph_def;
+  std::unordered_set<string> inputs;
+  std::unordered_set<string> outputs;
+  TF_RETURN_IF_ERROR(FreezeSavedModel(*saved_model_bundle, &frozen_graph_def,
+                                      &inputs, &outputs));
+  Session* session_p = nullptr;
+  TF_RETURN_IF_ERROR(NewSession(session_options, &session_p));
+  std::unique_ptr<Session> frozen_session(session_p);
+  TF_RETURN_IF_ERROR(frozen_session->Create(frozen_graph_def));
+  // Swap in the frozen session only once it is fully created, so that a
+  // failure above leaves the bundle usable. Closing the original session
+  // releases the variable resources.
+  saved_model_bundle->session->Close().IgnoreError();
+  saved_model_bundle->session = std::move(frozen_session);
+  *saved_model_bundle->meta_graph_def.mutable_graph_def() =
+      std::move(frozen_graph_def);
+  return Status::OK();
+}
+
+Status LoadAndFreezeSavedModel(const SessionOptions& session_options,
+                               const RunOptions& run_options,
+                               const string& export_dir,
+                               const std::unordered_set<string>& tags,
+                               SavedModelBundle* saved_model_bundle) {
+  TF_RETURN_IF_ERROR(LoadSavedModel(session_options, run_options, export_dir,
+                                    tags, saved_model_bundle));
+  return FreezeSavedModelInPlace(session_options, saved_model_bundle);
+}
+
 }  // namespace tensorflow
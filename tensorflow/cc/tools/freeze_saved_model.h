@@ -38,6 +38,27 @@ Status FreezeSavedModel(const SavedModelBundle& saved_model_bundle,
                         std::unordered_set<string>* inputs,
                         std::unordered_set<string>* outputs);
 
+// Freezes `saved_model_bundle` in place: all variables reachable from the
+// SignatureDef outputs are converted to Const nodes holding their restored
+// values (see FreezeSavedModel above), the bundle's graph def is replaced
+// with the frozen graph, and the bundle's session is replaced by a new
+// session created from it. Graph optimizations therefore run again over the
+// now-constant weights, and the variable resources are released together
+// with the original session, so serving stops paying per-step variable reads.
+// WARNING: The frozen bundle can only run the SignatureDef entry points; the
+// saver and init ops are pruned away, so models whose serving path depends on
+// the init op (e.g. table initializers) are not supported.
+Status FreezeSavedModelInPlace(const SessionOptions& session_options,
+                               SavedModelBundle* saved_model_bundle);
+
+// Loads a SavedModel from `export_dir` (see LoadSavedModel) and then freezes
+// the resulting bundle in place with FreezeSavedModelInPlace.
+Status LoadAndFreezeSavedModel(const SessionOptions& session_options,
+                               const RunOptions& run_options,
+                               const string& export_dir,
+                               const std::unordered_set<string>& tags,
+                               SavedModelBundle* saved_model_bundle);
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CC_TOOLS_FREEZE_SAVED_MODEL_H_
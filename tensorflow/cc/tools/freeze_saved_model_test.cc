@@ -425,5 +425,36 @@ TEST_F(FreezeTest, GraphDefWithAndWithoutDependentResourceVariables) {
   TestFreezeGraphWithAndWithoutDependentVariables(true);
 }
 
+TEST_F(FreezeTest, FreezeSavedModelInPlace) {
+  // Freezing a bundle in place should convert its variables to constants and
+  // leave a bundle whose session serves the same outputs.
+  SavedModelBundle saved_model_bundle;
+  GraphDef graph_def;
+  Scope scope = Scope::NewRootScope();
+  Output a = ops::Const(scope.WithOpName("a"), 10.0f, {});
+  Output var = ops::Variable(scope.WithOpName("var"), {}, DataType::DT_FLOAT);
+  Output assign = ops::Assign(scope.WithOpName("assign"), var, a);
+  Output c = ops::Mul(scope.WithOpName("c"), a, var);
+  TF_ASSERT_OK(scope.ToGraphDef(&graph_def));
+  TF_ASSERT_OK(AddGraphDefWithOutputsToSavedModelBundle(
+      graph_def, {"c:0"}, "assign", &saved_model_bundle));
+
+  SessionOptions session_options;
+  TF_ASSERT_OK(FreezeSavedModelInPlace(session_options, &saved_model_bundle));
+
+  // The bundle's graph def must no longer contain any variables.
+  for (const NodeDef& node :
+       saved_model_bundle.meta_graph_def.graph_def().node()) {
+    EXPECT_NE(node.op(), "Variable") << node.name();
+    EXPECT_NE(node.op(), "VariableV2") << node.name();
+  }
+  // The replacement session serves the frozen value.
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(saved_model_bundle.session->Run(/* inputs */ {}, {"c:0"},
+                                               /* targets */ {}, &outputs));
+  test::ExpectTensorEqual<float>(outputs[0],
+                                 test::AsTensor<float>({100.0f}, {}));
+}
+
 }  // namespace
 }  // namespace tensorflow
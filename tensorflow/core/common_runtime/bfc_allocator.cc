@@ -30,9 +30,11 @@ limitations under the License.
 namespace tensorflow {
 
 BFCAllocator::BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
-                           bool allow_growth, const string& name)
+                           bool allow_growth, const string& name,
+                           bool garbage_collection)
     : sub_allocator_(sub_allocator),
       name_(name),
+      garbage_collection_(garbage_collection),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1) {
   if (allow_growth) {
@@ -168,6 +170,80 @@ bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
   return true;
 }
 
+size_t BFCAllocator::LargestFreeChunk() {
+  for (int i = kNumBins - 1; i >= 0; i--) {
+    Bin* b = BinFromIndex(i);
+    if (!b->free_chunks.empty()) {
+      // Free chunks within a bin are ordered by increasing size.
+      return ChunkFromHandle(*b->free_chunks.rbegin())->size;
+    }
+  }
+  return 0;
+}
+
+bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes) {
+  // Find regions in which every chunk is free.  Chunks still waiting on a
+  // timestamp (freed_at_count > 0) may be referenced from
+  // timestamped_chunks_, so regions containing them are never released.
+  std::unordered_set<void*> free_region_ptrs;
+  size_t total_free_bytes = 0;
+  for (const AllocationRegion& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    bool any_use = false;
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->in_use() || c->freed_at_count > 0) {
+        any_use = true;
+        break;
+      }
+      h = c->next;
+    }
+    if (!any_use) {
+      VLOG(2) << "Found free region with ptr = " << region.ptr();
+      free_region_ptrs.insert(region.ptr());
+      total_free_bytes += region.memory_size();
+    }
+  }
+  if (free_region_ptrs.empty()) {
+    return false;
+  }
+
+  LOG(WARNING) << "Allocator (" << Name() << ") is releasing "
+               << strings::HumanReadableNumBytes(total_free_bytes)
+               << " of fully-free regions to satisfy an allocation of "
+               << strings::HumanReadableNumBytes(rounded_bytes)
+               << " that would otherwise fail due to fragmentation.";
+  DeallocateRegions(free_region_ptrs);
+  return true;
+}
+
+void BFCAllocator::DeallocateRegions(
+    const std::unordered_set<void*>& region_ptrs) {
+  auto it = region_manager_.mutable_regions_begin();
+  while (it != region_manager_.mutable_regions_end()) {
+    if (region_ptrs.find(it->ptr()) == region_ptrs.end()) {
+      ++it;
+      continue;
+    }
+    VLOG(2) << "Deallocating region with ptr = " << it->ptr();
+    // Remove the chunks of the region from their bins and delete their
+    // metadata before the backing memory is returned.
+    ChunkHandle h = region_manager_.get_handle(it->ptr());
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->bin_num != kInvalidBinNum) {
+        RemoveFreeChunkFromBin(h);
+      }
+      ChunkHandle h_to_delete = h;
+      h = c->next;
+      DeleteChunk(h_to_delete);
+    }
+    total_region_allocated_bytes_ -= it->memory_size();
+    sub_allocator_->Free(it->ptr(), it->memory_size());
+    it = region_manager_.RemoveAllocationRegion(it);
+  }
+}
+
 BFCAllocator::ChunkHandle BFCAllocator::AllocateChunk() {
   if (free_chunks_list_ != kInvalidChunkHandle) {
     ChunkHandle h = free_chunks_list_;
@@ -219,6 +295,13 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
 void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                 const AllocationAttributes& allocation_attr) {
   VLOG(1) << "AllocateRaw " << Name() << "  " << num_bytes;
+  if (ThreadCacheEnabled() && timing_counter_ == nullptr &&
+      allocation_attr.freed_by_func == nullptr) {
+    void* result = AllocateFromThreadCache(num_bytes);
+    if (result != nullptr) {
+      return result;
+    }
+  }
   if (allocation_attr.no_retry_on_failure) {
     // Return immediately upon the first failure if this is for allocating an
     // optional scratch space.
@@ -260,6 +343,113 @@ size_t BFCAllocator::RoundedBytes(size_t bytes) {
   return rounded_bytes;
 }
 
+// static
+bool BFCAllocator::ThreadCacheEnabled() {
+  static const bool enabled = [] {
+    const char* env = getenv("TF_BFC_THREAD_CACHE");
+    return env != nullptr && env[0] == '1';
+  }();
+  return enabled;
+}
+
+BFCAllocator::ThreadCache* BFCAllocator::GetThreadCache() {
+  // One cache per (thread, allocator) pair.  The caches are intentionally
+  // never torn down at thread exit: BFC allocators are process-lifetime
+  // objects and a flush from a thread-exit destructor could run after the
+  // allocator in a test has been destroyed.
+  static thread_local std::unordered_map<const BFCAllocator*, ThreadCache>*
+      caches = nullptr;
+  if (caches == nullptr) {
+    caches = new std::unordered_map<const BFCAllocator*, ThreadCache>;
+  }
+  return &(*caches)[this];
+}
+
+// static
+int BFCAllocator::CacheClassForBytes(size_t rounded_bytes) {
+  if (rounded_bytes == 0 || rounded_bytes > kMaxCachedBytes) {
+    return -1;
+  }
+  return static_cast<int>((rounded_bytes >> kMinAllocationBits) - 1);
+}
+
+void* BFCAllocator::AllocateFromThreadCache(size_t num_bytes) {
+  if (num_bytes == 0) {
+    return nullptr;
+  }
+  const int cls = CacheClassForBytes(RoundedBytes(num_bytes));
+  if (cls < 0) {
+    return nullptr;
+  }
+  ThreadCache* cache = GetThreadCache();
+  std::vector<void*>& magazine = cache->magazines[cls];
+  if (magazine.empty()) {
+    return nullptr;
+  }
+  void* ptr = magazine.back();
+  magazine.pop_back();
+  cache->cached_bytes -= (cls + 1) << kMinAllocationBits;
+  cache->outstanding[ptr] = cls;
+  return ptr;
+}
+
+bool BFCAllocator::DeallocateToThreadCache(void* ptr) {
+  ThreadCache* cache = GetThreadCache();
+  auto it = cache->outstanding.find(ptr);
+  if (it == cache->outstanding.end()) {
+    return false;
+  }
+  const int cls = it->second;
+  cache->outstanding.erase(it);
+  std::vector<void*>& magazine = cache->magazines[cls];
+  magazine.push_back(ptr);
+  cache->cached_bytes += (cls + 1) << kMinAllocationBits;
+  if (magazine.size() > kCacheMagazineSize) {
+    FlushThreadCacheClass(cache, cls);
+  }
+  return true;
+}
+
+void BFCAllocator::StashInThreadCache(void* ptr) {
+  ThreadCache* cache = GetThreadCache();
+  mutex_lock l(lock_);
+  BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
+  CHECK(h != kInvalidChunkHandle);
+  Chunk* chunk = ChunkFromHandle(h);
+  const size_t rounded_bytes = RoundedBytes(chunk->requested_size);
+  const int cls = CacheClassForBytes(rounded_bytes);
+  if (cls >= 0 && chunk->size <= 2 * rounded_bytes &&
+      cache->magazines[cls].size() < kCacheMagazineSize &&
+      cache->cached_bytes + ((cls + 1) << kMinAllocationBits) <=
+          kMaxCachedBytesPerThread) {
+    // Park the pointer; the chunk stays marked in-use so the bins and
+    // coalescing machinery never see it.
+    cache->magazines[cls].push_back(ptr);
+    cache->cached_bytes += (cls + 1) << kMinAllocationBits;
+    return;
+  }
+  // Not cacheable (too large, a chunk much bigger than the request that
+  // parking would hoard, or the magazine is full): free it normally, under
+  // the lock we already hold.
+  MarkFree(h);
+  InsertFreeChunkIntoBin(TryToCoalesce(h, false));
+}
+
+void BFCAllocator::FlushThreadCacheClass(ThreadCache* cache, int cls) {
+  std::vector<void*>& magazine = cache->magazines[cls];
+  const size_t keep = kCacheMagazineSize / 2;
+  mutex_lock l(lock_);
+  while (magazine.size() > keep) {
+    void* ptr = magazine.back();
+    magazine.pop_back();
+    cache->cached_bytes -= (cls + 1) << kMinAllocationBits;
+    BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
+    CHECK(h != kInvalidChunkHandle);
+    MarkFree(h);
+    InsertFreeChunkIntoBin(TryToCoalesce(h, false));
+  }
+}
+
 void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
                                         size_t num_bytes,
                                         bool dump_log_on_failure,
@@ -307,6 +497,18 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     }
   }
 
+  // Fragmentation rescue: release regions that are entirely free back to
+  // the sub-allocator and re-extend, so a sufficiently large contiguous
+  // region can be re-created even though the existing free space is
+  // scattered across regions.
+  if (garbage_collection_ && DeallocateFreeRegions(rounded_bytes) &&
+      Extend(unused_alignment, rounded_bytes)) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
   // We searched all bins for an existing free chunk to use and
   // couldn't find one.  This means we must have run out of memory,
   // Dump the memory log for analysis.
@@ -420,6 +622,15 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
 void BFCAllocator::DeallocateRaw(void* ptr) {
   VLOG(1) << "DeallocateRaw " << Name() << " "
           << (ptr ? RequestedSize(ptr) : 0);
+  if (ThreadCacheEnabled() && timing_counter_ == nullptr && ptr != nullptr) {
+    // Lock-free when this thread handed the pointer out from its own cache;
+    // otherwise park or free it under the lock.
+    if (!DeallocateToThreadCache(ptr)) {
+      StashInThreadCache(ptr);
+    }
+    retry_helper_.NotifyDealloc();
+    return;
+  }
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
@@ -826,7 +1037,9 @@ void BFCAllocator::DumpMemoryLog(size_t num_bytes) {
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
   mutex_lock l(lock_);
-  return stats_;
+  AllocatorStats stats = stats_;
+  stats.largest_free_block_bytes = LargestFreeChunk();
+  return stats;
 }
 
 void BFCAllocator::ClearStats() {
@@ -21,6 +21,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/allocator_retry.h"
@@ -45,9 +46,13 @@ namespace tensorflow {
 // all requests to allocate memory go through this interface.
 class BFCAllocator : public Allocator {
  public:
-  // Takes ownership of sub_allocator.
+  // Takes ownership of sub_allocator.  If 'garbage_collection' is true,
+  // regions in which every chunk is free may be released back to the
+  // sub-allocator when an allocation would otherwise fail, so that a larger
+  // contiguous region can be allocated despite fragmentation.
   BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
-               bool allow_growth, const string& name);
+               bool allow_growth, const string& name,
+               bool garbage_collection = false);
   ~BFCAllocator() override;
 
   string Name() override { return name_; }
@@ -90,6 +95,50 @@ class BFCAllocator : public Allocator {
 
   void DeallocateRawInternal(void* ptr);
 
+  // Optional thread-local front-end ("magazine") cache of small chunks,
+  // enabled by setting TF_BFC_THREAD_CACHE=1 in the environment.  A chunk
+  // freed by the thread that most recently allocated it, or stashed by a
+  // freeing thread under the global lock, can be handed back out by that
+  // thread without taking lock_ at all.  Cached chunks stay marked in-use by
+  // the rest of the allocator, so the bin and coalescing machinery is
+  // untouched; magazines are small and overflow is flushed back to the bins
+  // in batches under the lock.
+  //
+  // Note that a recycled chunk keeps the requested_size and allocation_id of
+  // the allocation that first produced it, so per-allocation tracking is
+  // approximate while the cache is enabled.  The cache is bypassed when a
+  // timing counter is in use, since cached chunks would not observe
+  // freed_at_count ordering.
+  static const size_t kMaxCachedBytes = 32768;
+  // One class per rounded size: kMaxCachedBytes / kMinAllocationSize.
+  static const int kNumCacheClasses = 128;
+  static const size_t kCacheMagazineSize = 16;
+  static const size_t kMaxCachedBytesPerThread = 1 << 21;
+  struct ThreadCache {
+    // Recycled pointers ready for reuse, segregated by size class.
+    std::vector<void*> magazines[kNumCacheClasses];
+    // Size class of each pointer handed out from this cache, so a free from
+    // the same thread can recycle it without the global lock.
+    std::unordered_map<const void*, int> outstanding;
+    // Upper bound on the bytes held in magazines, accounted per class.
+    size_t cached_bytes = 0;
+  };
+  static bool ThreadCacheEnabled();
+  ThreadCache* GetThreadCache();
+  // Returns the cache class for an allocation of 'rounded_bytes', or -1 if
+  // the size is not cacheable.
+  static int CacheClassForBytes(size_t rounded_bytes);
+  // Lock-free fast paths; return nullptr/false on a miss, in which case the
+  // caller falls through to the regular locked path.
+  void* AllocateFromThreadCache(size_t num_bytes);
+  bool DeallocateToThreadCache(void* ptr);
+  // Completes a deallocation under lock_: either parks the pointer in the
+  // calling thread's cache with its chunk still marked in-use, or, when the
+  // chunk is not cacheable, frees it into the bins as usual.
+  void StashInThreadCache(void* ptr);
+  // Returns all but half a magazine of class 'cls' to the free bins.
+  void FlushThreadCacheClass(ThreadCache* cache, int cls);
+
   // Chunks whose freed_at_count is later than the safe frontier value are kept
   // on a special list and not subject to merging immediately upon being freed.
   //
@@ -320,6 +369,17 @@ class BFCAllocator : public Allocator {
 
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
+    std::vector<AllocationRegion>::iterator mutable_regions_begin() {
+      return regions_.begin();
+    }
+    std::vector<AllocationRegion>::iterator mutable_regions_end() {
+      return regions_.end();
+    }
+    std::vector<AllocationRegion>::iterator RemoveAllocationRegion(
+        std::vector<AllocationRegion>::iterator it) {
+      return regions_.erase(it);
+    }
+
    private:
     static bool Comparator(const void* ptr, const AllocationRegion& other) {
       return ptr < other.end_ptr();
@@ -354,6 +414,24 @@ class BFCAllocator : public Allocator {
   bool Extend(size_t alignment, size_t rounded_bytes)
       EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Returns the size of the largest free chunk across all bins, or 0 if no
+  // chunk is free.
+  size_t LargestFreeChunk() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Releases regions in which every chunk is free (and not waiting on a
+  // timestamp) back to the sub-allocator, so that Extend() can carve a
+  // sufficiently large new region.  Called only when an allocation of
+  // 'rounded_bytes' would otherwise fail and garbage collection was
+  // requested at construction time.  Returns true if any region was
+  // released.
+  bool DeallocateFreeRegions(size_t rounded_bytes)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Helper for DeallocateFreeRegions: deallocates the regions whose base
+  // pointers appear in 'region_ptrs', including their chunk metadata.
+  void DeallocateRegions(const std::unordered_set<void*>& region_ptrs)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Returns a pointer to an underlying allocated chunk of size
   // 'rounded_bytes'.
   void* FindChunkPtr(BinNum bin_num, size_t rounded_bytes, size_t num_bytes,
@@ -471,6 +549,9 @@ class BFCAllocator : public Allocator {
 
   std::unique_ptr<SubAllocator> sub_allocator_;
   string name_;
+  // Whether fully-free regions may be released back to the sub-allocator
+  // when an allocation would otherwise fail.
+  const bool garbage_collection_;
   SharedCounter* timing_counter_ = nullptr;
   std::deque<ChunkHandle> timestamped_chunks_;
 
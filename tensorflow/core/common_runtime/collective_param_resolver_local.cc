@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -56,6 +57,22 @@ void CollectiveParamResolverLocal::CompleteGroupAsync(
 }
 
 namespace {
+// When TF_COLLECTIVE_HIERARCHICAL_REDUCE is true, multi-task reductions with
+// more than one device per task use HierarchicalReduce instead of a flat
+// ring, aggregating locally on each task before going over the network.
+bool HierarchicalReduceEnabled() {
+  static const bool enabled = []() {
+    bool value = false;
+    Status status =
+        ReadBoolFromEnvVar("TF_COLLECTIVE_HIERARCHICAL_REDUCE", false, &value);
+    if (!status.ok()) {
+      LOG(ERROR) << "Invalid TF_COLLECTIVE_HIERARCHICAL_REDUCE: " << status;
+    }
+    return value;
+  }();
+  return enabled;
+}
+
 string GetCollectiveName(const CollectiveParams* cp, bool nccl) {
   switch (cp->instance.type) {
     case BROADCAST_COLLECTIVE:
@@ -64,9 +81,15 @@ string GetCollectiveName(const CollectiveParams* cp, bool nccl) {
     case REDUCTION_COLLECTIVE: {
       if (nccl) {
         return "NcclReduce";
-      } else {
-        return "RingReduce";
       }
+      // A hierarchical reduce only pays off when some task hosts more than
+      // one device, i.e. when there is local interconnect to aggregate over
+      // before touching the network.
+      if (HierarchicalReduceEnabled() && cp->group.num_tasks > 1 &&
+          cp->group.group_size > cp->group.num_tasks) {
+        return "HierarchicalReduce";
+      }
+      return "RingReduce";
     }
 
     case GATHER_COLLECTIVE:
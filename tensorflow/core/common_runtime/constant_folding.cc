@@ -15,6 +15,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <functional>
 #include <set>
 #include <unordered_map>
 #include <vector>
@@ -27,16 +28,18 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/graph_runner.h"
 #include "tensorflow/core/common_runtime/memory_types.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
+#include "tensorflow/core/common_runtime/single_threaded_cpu_device.h"
 #include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/graph/subgraph.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/threadpool.h"
-#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/denormal.h"
 #include "tensorflow/core/platform/setround.h"
 #include "tensorflow/core/public/session_options.h"
@@ -350,6 +353,50 @@ int64 UniqueConstantId() {
   return unique_constant_id.fetch_add(1);
 }
 
+// A persistent CPU device shared by every constant-folding evaluation in the
+// process, so repeated folding calls during session creation do not each pay
+// for device setup.  The first Env wins; in practice this is Env::Default().
+Device* SharedFoldingDevice(Env* env) {
+  static Device* device = NewSingleThreadedCpuDevice(env);
+  return device;
+}
+
+// Thread pool used to evaluate independent constant subgraphs concurrently.
+thread::ThreadPool* FoldingThreadPool(Env* env) {
+  static thread::ThreadPool* pool = new thread::ThreadPool(
+      env, "constant_folding", std::min(8, port::NumSchedulableCPUs()));
+  return pool;
+}
+
+// Partitions the fetched nodes of "constant_graph" into weakly connected
+// components so that independent constant subgraphs can be evaluated in
+// parallel.  Returns, for each component, the indices into "fetch_nodes".
+std::vector<std::vector<size_t>> PartitionFetchesByComponent(
+    const Graph* constant_graph, const std::vector<Node*>& fetch_nodes) {
+  // Union-find over node ids.
+  std::vector<int> parent(constant_graph->num_node_ids());
+  for (int i = 0; i < static_cast<int>(parent.size()); ++i) parent[i] = i;
+  std::function<int(int)> find = [&](int x) {
+    while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+    return x;
+  };
+  for (const Edge* e : constant_graph->edges()) {
+    parent[find(e->src()->id())] = find(e->dst()->id());
+  }
+  std::unordered_map<int, size_t> root_to_component;
+  std::vector<std::vector<size_t>> components;
+  for (size_t i = 0; i < fetch_nodes.size(); ++i) {
+    const int root = find(fetch_nodes[i]->id());
+    auto insert = root_to_component.emplace(root, components.size());
+    if (insert.second) components.emplace_back();
+    components[insert.first->second].push_back(i);
+  }
+  return components;
+}
+
 // Adds n to constant_graph which is being built up for subsequent evaluation of
 // constant propagation. node_map is the mapping of nodes in the original graph
 // to nodes in the constant graph. The value of an entry in node_map is a vector
@@ -622,18 +669,55 @@ Status ConstantFold(const ConstantFoldingOptions& opts,
     tensors_to_replace.push_back({n.second, n.first.second});
   }
 
-  auto graph_runner = std::unique_ptr<GraphRunner>(new GraphRunner(env));
-  // Evaluate the constant foldable nodes.
-  std::vector<Tensor> outputs;
-  auto delete_tensors = gtl::MakeCleanup([&graph_runner, &outputs] {
-    // Output tensors need to be cleared before the GraphRunner is deleted.
-    outputs.clear();
-    graph_runner.reset(nullptr);
-  });
+  // Evaluate the constant foldable nodes on a persistent shared device;
+  // independent constant subgraphs are evaluated concurrently.
+  std::vector<Node*> fetch_nodes;
+  fetch_nodes.reserve(tensors_to_fetch_sorted.size());
+  for (auto n : tensors_to_fetch_sorted) {
+    fetch_nodes.push_back(n.first.first);
+  }
+  const std::vector<std::vector<size_t>> components =
+      PartitionFetchesByComponent(constant_graph.get(), fetch_nodes);
 
-  Status s =
-      graph_runner->Run(constant_graph.get(), function_library, {} /* inputs*/,
-                        tensors_to_fetch_names, &outputs);
+  std::vector<Tensor> outputs(tensors_to_fetch_names.size());
+  Status s;
+  if (components.size() <= 1) {
+    GraphRunner graph_runner(SharedFoldingDevice(env));
+    s = graph_runner.Run(constant_graph.get(), function_library,
+                         {} /* inputs*/, tensors_to_fetch_names, &outputs);
+  } else {
+    mutex status_mu;
+    BlockingCounter counter(components.size());
+    for (const std::vector<size_t>& component : components) {
+      FoldingThreadPool(env)->Schedule([&, component]() {
+        // Match the numeric environment of the calling thread.
+        port::ScopedFlushDenormal flush;
+        port::ScopedSetRound round(FE_TONEAREST);
+        std::vector<string> names;
+        names.reserve(component.size());
+        for (size_t i : component) {
+          names.push_back(tensors_to_fetch_names[i]);
+        }
+        GraphRunner graph_runner(SharedFoldingDevice(env));
+        std::vector<Tensor> component_outputs;
+        Status run_status =
+            graph_runner.Run(constant_graph.get(), function_library,
+                             {} /* inputs*/, names, &component_outputs);
+        {
+          mutex_lock l(status_mu);
+          if (!run_status.ok()) {
+            s.Update(run_status);
+          } else {
+            for (size_t j = 0; j < component.size(); ++j) {
+              outputs[component[j]] = component_outputs[j];
+            }
+          }
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
   if (!s.ok()) {
     VLOG(1) << "Could not fetch constants: " << s;
     *was_mutated = false;
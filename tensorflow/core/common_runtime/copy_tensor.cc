@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/util/reffed_status_callback.h"
@@ -47,6 +48,62 @@ std::vector<RegistrationInfo>* MutableRegistry() {
   return registry;
 }
 
+// Returns the size in bytes above which host<->device copies are split into
+// multiple sub-copies, or 0 if chunking is disabled (the default).
+// Controlled by the TF_COPY_CHUNK_BYTES environment variable.  Chunking lets
+// the driver pipeline its internal staging for multi-GB transfers instead of
+// issuing one monolithic DMA.
+int64 CopyChunkBytes() {
+  static const int64 chunk_bytes = []() -> int64 {
+    int64 value;
+    const char* env = getenv("TF_COPY_CHUNK_BYTES");
+    if (env != nullptr && strings::safe_strto64(env, &value) && value > 0) {
+      return value;
+    }
+    return 0;
+  }();
+  return chunk_bytes;
+}
+
+// If chunking is enabled and "input"/"output" are large pre-allocated
+// DMA-compatible tensors, splits the copy into contiguous dim-0 slices of at
+// most CopyChunkBytes() each, issues "copy_one" per slice, and invokes
+// "*done" once all slices complete.  Returns false (leaving *done untouched)
+// when the copy should take the regular single-DMA path.
+bool ChunkedCopy(const Tensor* input, Tensor* output, StatusCallback* done,
+                 const std::function<void(const Tensor*, Tensor*,
+                                          StatusCallback)>& copy_one) {
+  const int64 chunk_bytes = CopyChunkBytes();
+  if (chunk_bytes <= 0 || input->dims() == 0 || input->dim_size(0) <= 1 ||
+      !DataTypeCanUseMemcpy(input->dtype()) ||
+      input->TotalBytes() <= static_cast<uint64>(chunk_bytes) ||
+      !output->IsInitialized() || output->shape() != input->shape()) {
+    return false;
+  }
+  const int64 dim0 = input->dim_size(0);
+  const int64 row_bytes = input->TotalBytes() / dim0;
+  if (row_bytes == 0 || row_bytes > chunk_bytes) return false;
+  const int64 rows_per_chunk = chunk_bytes / row_bytes;
+
+  auto* status_cb = new ReffedStatusCallback(std::move(*done));
+  core::ScopedUnref status_cb_unref(status_cb);
+  for (int64 start = 0; start < dim0; start += rows_per_chunk) {
+    const int64 limit = std::min(dim0, start + rows_per_chunk);
+    // The slices alias the original buffers and must stay alive until the
+    // asynchronous sub-copy signals completion.
+    auto* from = new Tensor(input->Slice(start, limit));
+    auto* to = new Tensor(output->Slice(start, limit));
+    status_cb->Ref();
+    copy_one(from, to, [status_cb, from, to](const Status& s) {
+      status_cb->UpdateStatus(s);
+      delete from;
+      delete to;
+      status_cb->Unref();
+    });
+  }
+  return true;
+}
+
 void CopyHostToDevice(const Tensor* input, Allocator* cpu_allocator,
                       Allocator* out_allocator, StringPiece edge_name,
                       Device* dst, Tensor* output,
@@ -109,6 +166,16 @@ void CopyHostToDevice(const Tensor* input, Allocator* cpu_allocator,
       *output = std::move(copy);
     }
   } else {
+    if (ChunkedCopy(input, output, &done,
+                    [dst, recv_dev_context, sync_dst_compute](
+                        const Tensor* from, Tensor* to,
+                        StatusCallback chunk_done) {
+                      recv_dev_context->CopyCPUTensorToDevice(
+                          from, dst, to, std::move(chunk_done),
+                          sync_dst_compute);
+                    })) {
+      return;
+    }
     recv_dev_context->CopyCPUTensorToDevice(input, dst, output, std::move(done),
                                             sync_dst_compute);
   }
@@ -174,6 +241,15 @@ void CopyDeviceToHost(const Tensor* input, Allocator* cpu_allocator,
       *output = std::move(copy);
     }
   } else {
+    if (ChunkedCopy(input, output, &done,
+                    [src, send_dev_context, edge_name](
+                        const Tensor* from, Tensor* to,
+                        StatusCallback chunk_done) {
+                      send_dev_context->CopyDeviceTensorToCPU(
+                          from, edge_name, src, to, std::move(chunk_done));
+                    })) {
+      return;
+    }
     send_dev_context->CopyDeviceTensorToCPU(input, edge_name, src, output,
                                             std::move(done));
   }
@@ -14,7 +14,19 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
+
+#include <unordered_map>
+#include <vector>
+
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/host_info.h"
+#include "tensorflow/core/util/device_name_utils.h"
 
 namespace tensorflow {
 
@@ -22,10 +34,103 @@ namespace {
 
 static const string kCostModelLogTag = "COST_MODEL";
 
+// Costs are aggregated by this many tab-separated fields per line:
+// op, device type, execution count, total time in microseconds.
+struct CostSummary {
+  int64 count = 0;
+  int64 time_us = 0;
+};
+
+const string& CostModelCacheDir() {
+  static const string* dir = [] {
+    const char* value = getenv("TF_COST_MODEL_CACHE_DIR");
+    return new string(value == nullptr ? "" : value);
+  }();
+  return *dir;
+}
+
+bool CostModelCacheEnabled() { return !CostModelCacheDir().empty(); }
+
+string CostCacheFileHeader() {
+  return strings::StrCat("tf_cost_model_cache_v1 ", port::Hostname());
+}
+
+// This host's summary file. Each host writes only its own file, so
+// concurrent processes on different hosts sharing the directory never
+// clobber each other; processes on the same host race benignly
+// (last-writer-wins, and both wrote merged summaries).
+string CostCacheFileName() {
+  return io::JoinPath(
+      CostModelCacheDir(),
+      strings::StrCat(strings::FpToString(Fingerprint64(port::Hostname())),
+                      ".costs"));
+}
+
+// The signature costs are aggregated by. The device type rather than the
+// full device name is used so summaries transfer across processes (and
+// hosts) with different job/task layouts.
+string NodeCostSignature(const Node* n) {
+  DeviceNameUtils::ParsedName parsed;
+  StringPiece device_type = "UNKNOWN";
+  if (DeviceNameUtils::ParseFullName(n->assigned_device_name(), &parsed) &&
+      parsed.has_type) {
+    device_type = parsed.type;
+  }
+  return strings::StrCat(n->type_string(), "\t", device_type);
+}
+
+// Parses one summary file into *summaries, summing duplicate signatures.
+// Missing files and malformed lines are silently skipped.
+void LoadCostSummaryFile(Env* env, const string& filename,
+                         std::unordered_map<string, CostSummary>* summaries) {
+  string contents;
+  if (!ReadFileToString(env, filename, &contents).ok()) {
+    return;
+  }
+  std::vector<string> lines = str_util::Split(contents, '\n');
+  if (lines.empty() ||
+      !str_util::StartsWith(lines[0], "tf_cost_model_cache_v1 ")) {
+    LOG(WARNING) << "Ignoring cost model cache file " << filename
+                 << ": unrecognized header.";
+    return;
+  }
+  for (size_t i = 1; i < lines.size(); ++i) {
+    std::vector<string> fields = str_util::Split(lines[i], '\t');
+    if (fields.size() != 4) continue;
+    int64 count, time_us;
+    if (!strings::safe_strto64(fields[2], &count) ||
+        !strings::safe_strto64(fields[3], &time_us) || count <= 0 ||
+        time_us < 0) {
+      continue;
+    }
+    CostSummary& summary =
+        (*summaries)[strings::StrCat(fields[0], "\t", fields[1])];
+    summary.count += count;
+    summary.time_us += time_us;
+  }
+}
+
+// Loads and merges every summary file under the cache directory.
+void LoadAllCostSummaries(
+    Env* env, std::unordered_map<string, CostSummary>* summaries) {
+  std::vector<string> children;
+  if (!env->GetChildren(CostModelCacheDir(), &children).ok()) {
+    return;
+  }
+  for (const string& child : children) {
+    if (!str_util::EndsWith(child, ".costs")) continue;
+    LoadCostSummaryFile(env, io::JoinPath(CostModelCacheDir(), child),
+                        summaries);
+  }
+}
+
 }  // namespace
 
 CostModelManager::~CostModelManager() {
   for (auto it : cost_models_) {
+    // Graphs a cost model is still registered for outlive the manager in
+    // both DirectSession and GraphMgr, so walking them here is safe.
+    PersistCostModel(it.first, it.second);
     delete it.second;
   }
 }
@@ -38,6 +143,7 @@ CostModel* CostModelManager::FindOrCreateCostModel(const Graph* graph) {
   }
   CostModel* cost_model = new CostModel(false);
   cost_model->InitFromGraph(*graph);
+  WarmStartCostModel(graph, cost_model);
   cost_models_.emplace(graph, cost_model);
   return cost_model;
 }
@@ -48,6 +154,7 @@ bool CostModelManager::RemoveCostModelForGraph(const Graph* graph) {
   if (itr == cost_models_.end()) {
     return false;
   }
+  PersistCostModel(graph, itr->second);
   delete itr->second;
   cost_models_.erase(graph);
   return true;
@@ -66,4 +173,76 @@ Status CostModelManager::AddToCostGraphDef(const Graph* graph,
   return Status::OK();
 }
 
+void CostModelManager::WarmStartCostModel(const Graph* graph,
+                                          CostModel* cost_model) {
+  if (!CostModelCacheEnabled()) return;
+  std::unordered_map<string, CostSummary> summaries;
+  LoadAllCostSummaries(Env::Default(), &summaries);
+  if (summaries.empty()) return;
+  int seeded = 0;
+  for (const Node* n : graph->op_nodes()) {
+    const CostSummary* summary =
+        gtl::FindOrNull(summaries, NodeCostSignature(n));
+    if (summary == nullptr || cost_model->TotalCount(n) > 0) continue;
+    // Seed with a count of one so that the estimate starts at the
+    // persisted mean but real measurements quickly dominate it. The
+    // parser guarantees count > 0.
+    cost_model->RecordCount(n, 1);
+    cost_model->RecordTime(n, Microseconds(summary->time_us / summary->count));
+    ++seeded;
+  }
+  VLOG(1) << "Warm-started cost model with " << seeded << " of "
+          << graph->num_op_nodes() << " nodes from " << CostModelCacheDir();
+}
+
+void CostModelManager::PersistCostModel(const Graph* graph,
+                                        CostModel* cost_model) {
+  if (!CostModelCacheEnabled()) return;
+  Env* env = Env::Default();
+  const string filename = CostCacheFileName();
+
+  // Merge this cost model's measurements into this host's existing
+  // summaries so retiring one graph doesn't discard what others learned.
+  std::unordered_map<string, CostSummary> summaries;
+  LoadCostSummaryFile(env, filename, &summaries);
+  int64 recorded = 0;
+  for (const Node* n : graph->op_nodes()) {
+    const int32 count = cost_model->TotalCount(n);
+    // Skip warm-start seeds (count == 1 with no further executions would
+    // still round-trip their mean, which is harmless, but nodes that
+    // never ran contribute nothing).
+    if (count <= 0) continue;
+    CostSummary& summary = summaries[NodeCostSignature(n)];
+    summary.count += count;
+    summary.time_us += cost_model->TotalTime(n).value();
+    ++recorded;
+  }
+  if (recorded == 0) return;
+
+  string contents = strings::StrCat(CostCacheFileHeader(), "\n");
+  for (const auto& entry : summaries) {
+    strings::StrAppend(&contents, entry.first, "\t", entry.second.count, "\t",
+                       entry.second.time_us, "\n");
+  }
+  Status s = env->RecursivelyCreateDir(CostModelCacheDir());
+  string tmp_path = filename;
+  if (s.ok() && !env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    s = errors::Internal("could not create temporary file name");
+  }
+  if (s.ok()) {
+    s = WriteStringToFile(env, tmp_path, contents);
+    if (s.ok()) {
+      s = env->RenameFile(tmp_path, filename);
+      if (!s.ok()) env->DeleteFile(tmp_path).IgnoreError();
+    }
+  }
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to persist cost model summaries to " << filename
+                 << ": " << s;
+  } else {
+    VLOG(1) << "Persisted cost summaries for " << recorded << " nodes to "
+            << filename;
+  }
+}
+
 }  // namespace tensorflow
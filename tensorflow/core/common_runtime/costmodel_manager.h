@@ -27,6 +27,18 @@ limitations under the License.
 namespace tensorflow {
 
 // Used to manage all the cost models for a session.
+//
+// When TF_COST_MODEL_CACHE_DIR is set, measured costs are aggregated by
+// (op, device type) signature and written to a per-host file under that
+// directory when a cost model is retired, and newly created cost models
+// are seeded from every file found there. Seeded estimates carry an
+// execution count of one, so the first real measurements quickly dominate
+// them; their only job is to let the executor's expensive-node
+// classification and the scheduling heuristics start from the costs a
+// previous process learned instead of from zero. Sharing the directory
+// across hosts (e.g. on a network filesystem) merges summaries fleet-wide;
+// each file records the host it was produced on, and mixing files from
+// heterogeneous hardware simply averages their estimates.
 class CostModelManager {
  public:
   ~CostModelManager();
@@ -46,6 +58,15 @@ class CostModelManager {
   Status AddToCostGraphDef(const Graph* graph, CostGraphDef* cost_graph);
 
  private:
+  // Seeds "cost_model" with per-signature summaries previously persisted
+  // under TF_COST_MODEL_CACHE_DIR. No-op if the cache is disabled.
+  void WarmStartCostModel(const Graph* graph, CostModel* cost_model);
+
+  // Merges the costs accumulated in "cost_model" into this host's summary
+  // file under TF_COST_MODEL_CACHE_DIR. No-op if the cache is disabled.
+  // "graph" must still be alive.
+  void PersistCostModel(const Graph* graph, CostModel* cost_model);
+
   mutex mu_;
   CostModelMap cost_models_ GUARDED_BY(mu_);
 };
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_resolver_local.h"
 #include "tensorflow/core/common_runtime/executor.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/fixed_slot_rendezvous.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/graph_optimizer.h"
 #include "tensorflow/core/common_runtime/memory_types.h"
@@ -36,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/common_runtime/step_stats_sampler.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb_text.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -58,6 +60,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -147,6 +150,24 @@ string GetRendezvousKey(const string& tensor_name,
                          frame_iter.frame_id, ":", frame_iter.iter_id);
 }
 
+// Order-sensitive hash over a name list, used by the signature fast path in
+// GetOrCreateExecutors.  The list length is folded in so that adjacent lists
+// hash differently depending on where one ends and the next begins.
+uint64 HashNameList(gtl::ArraySlice<string> names, uint64 h) {
+  for (const string& name : names) {
+    h = Hash64Combine(h, Hash64(name));
+  }
+  return Hash64Combine(h, names.size());
+}
+
+bool NameListsEqual(const std::vector<string>& a, gtl::ArraySlice<string> b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i] != b[i]) return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 class DirectSessionFactory : public SessionFactory {
@@ -461,6 +482,15 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   // Create a run state and start execution.
   RunState run_state(step_id, &devices_);
   run_state.rendez = new IntraProcessRendezvous(device_mgr_.get());
+  // If requested, route statically-known Send/Recv pairs through
+  // pre-assigned lock-free slots; all other keys (feeds, fetches, loop
+  // iterations) fall back to the IntraProcessRendezvous.
+  core::RefCountPtr<FixedSlotRendezvous> fixed_slot_rendez;
+  if (executors_and_keys->fixed_slot_table != nullptr) {
+    fixed_slot_rendez.reset(
+        new FixedSlotRendezvous(executors_and_keys->fixed_slot_table.get(),
+                                run_state.rendez, device_mgr_.get()));
+  }
 #ifndef __ANDROID__
   // Set up for collectives if ExecutorsAndKeys declares a key.
   if (executors_and_keys->collective_graph_key !=
@@ -507,12 +537,26 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   Executor::Args args;
   args.step_id = step_id;
   args.call_frame = call_frame;
-  args.rendezvous = run_state.rendez;
+  args.rendezvous = fixed_slot_rendez != nullptr
+                        ? static_cast<Rendezvous*>(fixed_slot_rendez.get())
+                        : run_state.rendez;
   args.collective_executor =
       (run_state.collective_executor ? run_state.collective_executor->get()
                                      : nullptr);
   CancellationManager step_cancellation_manager;
   args.cancellation_manager = &step_cancellation_manager;
+  // Cancellation aborts run_state.rendez via the RunState machinery; make
+  // sure pending fixed-slot waiters are aborted as well so the executors can
+  // drain.  The callback is deregistered on the normal completion path.
+  CancellationToken fixed_slot_abort_token =
+      CancellationManager::kInvalidToken;
+  if (fixed_slot_rendez != nullptr) {
+    fixed_slot_abort_token = step_cancellation_manager.get_cancellation_token();
+    step_cancellation_manager.RegisterCallback(
+        fixed_slot_abort_token, [rendez = fixed_slot_rendez.get()]() {
+          rendez->StartAbort(errors::Cancelled("Run call was cancelled"));
+        });
+  }
   args.session_state = &session_state_;
   args.session_handle = session_handle_;
   args.tensor_store = &run_state.tensor_store;
@@ -533,11 +577,18 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
           ((measure_step_count + 1) % build_cost_model_every == 0);
     }
   }
+  std::unique_ptr<SamplingStepStatsCollector> sampling_collector;
   if (do_trace || update_cost_model ||
       run_options.report_tensor_allocations_upon_oom()) {
     run_state.collector.reset(
         new StepStatsCollector(run_metadata->mutable_step_stats()));
     args.stats_collector = run_state.collector.get();
+  } else if (StepStatsSampler::Global()->enabled() &&
+             StepStatsSampler::Global()->ShouldSampleStep()) {
+    // Low-overhead production sampling: POD timing records in preallocated
+    // ring buffers, converted to StepStats only when fetched.
+    sampling_collector.reset(new SamplingStepStatsCollector(step_id));
+    args.stats_collector = sampling_collector.get();
   }
 
   std::unique_ptr<ProfilerSession> profiler_session;
@@ -597,6 +648,13 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   }
   auto* handler_ptr = handler.get();
 
+  // The common case (default inter-op pool, no RunHandler) uses the runners
+  // pre-bound at executor creation time instead of rebuilding them per step.
+  const bool use_prebound_runners =
+      handler_ptr == nullptr && pool != nullptr &&
+      pool == executors_and_keys->prebound_pool &&
+      executors_and_keys->prebound_default_runner != nullptr;
+
   Executor::Args::Runner default_runner = nullptr;
 
   if (pool == nullptr) {
@@ -605,7 +663,7 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
     default_runner = [handler_ptr](Executor::Args::Closure c) {
       handler_ptr->ScheduleInterOpClosure(std::move(c));
     };
-  } else {
+  } else if (!use_prebound_runners) {
     default_runner = [this, pool](Executor::Args::Closure c) {
       pool->Schedule(std::move(c));
     };
@@ -619,7 +677,11 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
         item.device->tensorflow_device_thread_pool();
     // TODO(crk): Investigate usage of RunHandlerPool when using device specific
     // thread pool(s).
-    if (!device_thread_pool) {
+    if (use_prebound_runners) {
+      args.runner = device_thread_pool
+                        ? item.prebound_runner
+                        : executors_and_keys->prebound_default_runner;
+    } else if (!device_thread_pool) {
       args.runner = default_runner;
     } else {
       args.runner = [this, device_thread_pool](Executor::Args::Closure c) {
@@ -634,6 +696,10 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
                           ? run_options.timeout_in_ms()
                           : operation_timeout_in_ms_);
 
+  if (fixed_slot_abort_token != CancellationManager::kInvalidToken) {
+    step_cancellation_manager.DeregisterCallback(fixed_slot_abort_token);
+  }
+
   if (!cancellation_manager_->DeregisterCallback(cancellation_token)) {
     // The step has been cancelled: make sure we don't attempt to receive the
     // outputs as this would make it block forever.
@@ -1239,6 +1305,9 @@ Status DirectSession::CreateExecutors(
     LocalExecutorParams params;
     params.device = device;
     params.function_library = lib;
+    params.use_per_step_arena =
+        options_.config.experimental().use_per_step_arena_allocator() &&
+        device->device_type() == DEVICE_CPU;
     auto opseg = device->op_segment();
     params.create_kernel = [this, lib, opseg](const NodeDef& ndef,
                                               OpKernel** kernel) {
@@ -1291,6 +1360,40 @@ Status DirectSession::CreateExecutors(
         executor_type, params, std::move(partition_graph), &item->executor));
   }
 
+  // Resolve slot assignments for statically-known Send/Recv pairs once, at
+  // partition time, so per-step rendezvous lookups become array indexing.
+  if (options_.config.experimental().use_fixed_slot_rendezvous()) {
+    std::vector<const Graph*> partitions;
+    partitions.reserve(ek->items.size());
+    for (const auto& item : ek->items) {
+      partitions.push_back(item.graph);
+    }
+    FixedSlotKeyTable* table = nullptr;
+    TF_RETURN_IF_ERROR(FixedSlotKeyTable::Create(partitions, &table));
+    ek->fixed_slot_table.reset(table);
+  }
+
+  // Pre-bind the inter-op runners that RunInternal would otherwise rebuild
+  // on every step.  These cover default RunOptions; RunInternal falls back
+  // to per-step construction when a different pool or a RunHandler is
+  // requested.
+  if (!thread_pools_.empty()) {
+    thread::ThreadPool* pool = thread_pools_[0].first;
+    ek->prebound_pool = pool;
+    ek->prebound_default_runner = [pool](Executor::Args::Closure c) {
+      pool->Schedule(std::move(c));
+    };
+  }
+  for (auto& item : ek->items) {
+    thread::ThreadPool* device_thread_pool =
+        item.device->tensorflow_device_thread_pool();
+    if (device_thread_pool != nullptr) {
+      item.prebound_runner = [device_thread_pool](Executor::Args::Closure c) {
+        device_thread_pool->Schedule(std::move(c));
+      };
+    }
+  }
+
   // Cache the mapping from input/output names to graph elements to
   // avoid recomputing it every time.
   if (!run_state_args->is_partial_run) {
@@ -1344,6 +1447,39 @@ Status DirectSession::GetOrCreateExecutors(
         run_state_args->debug_options.debug_tensor_watch_opts());
   }
 
+  // Signature fast path: a hash of the feed/fetch/target names, avoiding the
+  // string-key concatenation below on steady-state calls.  Only available
+  // when no handle needs to be derived from the key.  The stored names are
+  // compared on lookup, so a collision falls through rather than returning
+  // the wrong executors.
+  const bool can_use_signature =
+      handle_name_counter_value < 0 && debug_tensor_watches_summary.empty();
+  uint64 signature = 0;
+  if (can_use_signature) {
+    signature = HashNameList(
+        target_nodes,
+        HashNameList(outputs,
+                     HashNameList(inputs, run_state_args->is_partial_run)));
+    mutex_lock l(executor_lock_);
+    auto it = executors_by_signature_.find(signature);
+    if (it != executors_by_signature_.end() &&
+        NameListsEqual(it->second.inputs, inputs) &&
+        NameListsEqual(it->second.outputs, outputs) &&
+        NameListsEqual(it->second.target_nodes, target_nodes)) {
+      *executors_and_keys = it->second.executors_and_keys;
+      return Status::OK();
+    }
+  }
+  auto record_signature = [&](ExecutorsAndKeys* ek)
+                              EXCLUSIVE_LOCKS_REQUIRED(executor_lock_) {
+    if (!can_use_signature) return;
+    ExecutorSignature& sig = executors_by_signature_[signature];
+    sig.inputs.assign(inputs.begin(), inputs.end());
+    sig.outputs.assign(outputs.begin(), outputs.end());
+    sig.target_nodes.assign(target_nodes.begin(), target_nodes.end());
+    sig.executors_and_keys = ek;
+  };
+
   // Fast lookup path, no sorting.
   const string key = strings::StrCat(
       str_util::Join(inputs, ","), "->", str_util::Join(outputs, ","), "/",
@@ -1361,6 +1497,7 @@ Status DirectSession::GetOrCreateExecutors(
     auto it = executors_.find(key);
     if (it != executors_.end()) {
       *executors_and_keys = it->second.get();
+      record_signature(it->second.get());
       return Status::OK();
     }
   }
@@ -1396,6 +1533,7 @@ Status DirectSession::GetOrCreateExecutors(
       *executors_and_keys = it->second.get();
       // Insert this under the original key.
       executors_.emplace(key, it->second);
+      record_signature(it->second.get());
       return Status::OK();
     }
   }
@@ -1435,6 +1573,7 @@ Status DirectSession::GetOrCreateExecutors(
   // if the user uses the same order of inputs, outputs, and targets again.
   executors_.emplace(key, insert_result.first->second);
   *executors_and_keys = insert_result.first->second.get();
+  record_signature(insert_result.first->second.get());
 
   return Status::OK();
 }
@@ -1791,9 +1930,8 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
   }
 
   // NOTE(mrry): Debug options are not currently supported in the
-  // callable interface.
-  DebugOptions debug_options;
-  RunStateArgs run_state_args(debug_options);
+  // callable interface, so there is no per-call RunStateArgs to build:
+  // everything the step needs was bound at MakeCallable() time.
 
   // Configure a call frame for the step, which we use to feed and
   // fetch values to and from the executors.
@@ -1823,7 +1961,7 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
                                   fetch_tensors);
 
   if (LogMemory::IsEnabled()) {
-    LogMemory::RecordStep(step_id, run_state_args.handle);
+    LogMemory::RecordStep(step_id, /*handle=*/"");
   }
 
   TF_RETURN_IF_ERROR(
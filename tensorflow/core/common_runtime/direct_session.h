@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/device_set.h"
 #include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/fixed_slot_rendezvous.h"
 #include "tensorflow/core/common_runtime/graph_execution_state.h"
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
@@ -127,6 +128,9 @@ class DirectSession : public Session {
     Device* device = nullptr;                // not owned.
     FunctionLibraryRuntime* flib = nullptr;  // not owned.
     std::unique_ptr<Executor> executor;
+    // Runner bound to the device's own thread pool, pre-built at executor
+    // creation time; null when the device has no dedicated pool.
+    Executor::Args::Runner prebound_runner;
   };
 
   // An ExecutorsAndKeys is created for a given set of feeds/fetches.
@@ -155,6 +159,18 @@ class DirectSession : public Session {
     CallableOptions callable_options;
 
     int64 collective_graph_key = BuildGraphOptions::kNoCollectiveGraphKey;
+
+    // Slot assignment for statically-known Send/Recv pairs; non-null only
+    // when ConfigProto.experimental.use_fixed_slot_rendezvous is set.
+    core::RefCountPtr<FixedSlotKeyTable> fixed_slot_table;
+
+    // Runner bound to the inter-op pool this set of executors would use with
+    // default RunOptions, pre-built at executor creation time so RunInternal
+    // does not rebuild it on every step.  RunInternal falls back to per-step
+    // construction when the resolved pool differs (e.g. a non-default
+    // inter_op_thread_pool or a RunHandler is requested).
+    thread::ThreadPool* prebound_pool = nullptr;  // not owned.
+    Executor::Args::Runner prebound_default_runner;
   };
 
   // A FunctionInfo object is created for every unique set of feeds/fetches.
@@ -343,6 +359,19 @@ class DirectSession : public Session {
   std::unordered_map<string, std::shared_ptr<ExecutorsAndKeys>> executors_
       GUARDED_BY(executor_lock_);
 
+  // Signature-based fast path for GetOrCreateExecutors.  The key is an
+  // order-sensitive hash of the feed/fetch/target names; the stored names are
+  // compared on lookup so a hash collision can never return the wrong
+  // executors, it merely falls through to the string-keyed lookup above.
+  struct ExecutorSignature {
+    std::vector<string> inputs;
+    std::vector<string> outputs;
+    std::vector<string> target_nodes;
+    ExecutorsAndKeys* executors_and_keys = nullptr;  // owned by executors_.
+  };
+  std::unordered_map<uint64, ExecutorSignature> executors_by_signature_
+      GUARDED_BY(executor_lock_);
+
   class RunCallableCallFrame;
   struct Callable {
     std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
@@ -241,13 +241,39 @@ void CombineUnordered(const tensorflow::Fprint128& a,
   b->high64 += a.high64;
 }
 
-inline tensorflow::Fprint128 CacheKeyHelper(StringPiece s,
+// Op names, device names and attribute names recur across virtually every
+// eager op dispatch, so their fingerprints are interned in a process-wide
+// table: steady-state cache key construction looks them up instead of
+// rehashing the string bytes each time.  The table only ever holds strings
+// from these sets (bounded by the distinct ops, devices and attrs the
+// process uses), so it stays small and entries are never evicted.
+mutex g_fingerprint_intern_lock(LINKER_INITIALIZED);
+
+std::unordered_map<string, tensorflow::Fprint128>* FingerprintInternTable() {
+  static auto* const m =
+      new std::unordered_map<string, tensorflow::Fprint128>;
+  return m;
+}
+
+tensorflow::Fprint128 InternedFingerprint(const string& s) {
+  {
+    tf_shared_lock l(g_fingerprint_intern_lock);
+    const auto* table = FingerprintInternTable();
+    auto it = table->find(s);
+    if (it != table->end()) return it->second;
+  }
+  tensorflow::Fprint128 f = tensorflow::Fingerprint128(s);
+  mutex_lock l(g_fingerprint_intern_lock);
+  FingerprintInternTable()->emplace(s, f);
+  return f;
+}
+
+inline tensorflow::Fprint128 CacheKeyHelper(const string& s,
                                             const tensorflow::Fprint128& b) {
-  tensorflow::Fprint128 a = tensorflow::Fingerprint128(s);
-  return FingerprintCat128(a, b);
+  return FingerprintCat128(InternedFingerprint(s), b);
 }
 
-inline tensorflow::Fprint128 CacheKeyHelper(StringPiece s, uint64 b) {
+inline tensorflow::Fprint128 CacheKeyHelper(const string& s, uint64 b) {
   return CacheKeyHelper(s, {b, b});
 }
 
@@ -264,8 +290,8 @@ tensorflow::Fprint128 AttrBuilder::CacheKey(const string& device) {
 
 tensorflow::Fprint128 AttrBuilder::BuildCacheKeyForDevice(
     const string& device) const {
-  tensorflow::Fprint128 f = tensorflow::Fingerprint128(op_name_);
-  f = tensorflow::FingerprintCat128(f, tensorflow::Fingerprint128(device));
+  tensorflow::Fprint128 f = InternedFingerprint(op_name_);
+  f = tensorflow::FingerprintCat128(f, InternedFingerprint(device));
   if (node_def_ != nullptr) {
     // Some attributes are directly written to node_def_ instead of being
     // stored explicitly.
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/eager/context.h"
 
+#include <iterator>
 #include <vector>
 
 // clang-format off
@@ -27,12 +28,14 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/collective_param_resolver_local.h"
 #include "tensorflow/core/common_runtime/device_resolver_local.h"
 #include "tensorflow/core/common_runtime/device_set.h"
+#include "tensorflow/core/common_runtime/eager/tensor_handle.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/lib/core/errors.h"
 #if !defined(IS_MOBILE_PLATFORM)
 #include "tensorflow/core/distributed_runtime/collective_param_resolver_distributed.h"
 #include "tensorflow/core/distributed_runtime/device_resolver_distributed.h"
+#include "tensorflow/core/distributed_runtime/eager/remote_op_batcher.h"
 #include "tensorflow/core/distributed_runtime/rpc_collective_executor_mgr.h"
 #endif  // !IS_MOBILE_PLATFORM
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -51,6 +54,20 @@ bool ReadBoolFromEnvVar(StringPiece env_var_name, bool default_val) {
   return default_val;
 }
 
+// Bounds the per-context constant cache; in practice programs use far fewer
+// distinct small constants than this.
+const size_t kMaxCachedConstants = 1024;
+
+// The maximum number of shape-specialized function kernels kept per context
+// before the least recently used one is evicted.
+int64 FunctionKernelCacheLimit() {
+  int64 limit;
+  Status s = ReadInt64FromEnvVar("TF_EAGER_FUNCTION_KERNEL_CACHE_SIZE",
+                                 /*default_val=*/512, &limit);
+  if (!s.ok() || limit <= 0) return 512;
+  return limit;
+}
+
 }  // namespace
 
 EagerContext::EagerContext(const SessionOptions& opts,
@@ -76,6 +93,7 @@ EagerContext::EagerContext(
           device_mgr, opts.env, TF_GRAPH_DEF_VERSION, &func_lib_def_,
           opts.config.graph_options().optimizer_options(), thread_pool_.get(),
           cluster_flr, custom_kernel_creator)),
+      function_kernel_cache_limit_(FunctionKernelCacheLimit()),
       log_device_placement_(opts.config.log_device_placement()),
       num_active_steps_(0),
       async_default_(async),
@@ -106,6 +124,10 @@ EagerContext::EagerContext(
       "/job:localhost/replica:0/task:0"));
   collective_executor_mgr_.reset(new CollectiveExecutorMgr(
       opts.config, local_device_mgr(), std::move(drl), std::move(cprl)));
+
+#if !defined(IS_MOBILE_PLATFORM)
+  remote_op_batcher_.reset(new eager::RemoteOpBatcher);
+#endif  // !IS_MOBILE_PLATFORM
 }
 
 void EagerContext::InitDeviceMapAndAsync() {
@@ -162,8 +184,17 @@ void EagerContext::ClearCaches() {
   // well.
   mutex_lock ml(cache_mu_);
   executor_.WaitForAllPendingNodes().IgnoreError();
-  gtl::STLDeleteValues(&kernel_cache_);
+  for (auto& entry : kernel_cache_) {
+    entry.second->Unref();
+  }
+  kernel_cache_.clear();
+  function_kernel_lru_.clear();
+  function_kernel_lru_index_.clear();
   gtl::STLDeleteValues(&active_functions_);
+  for (auto& entry : constant_cache_) {
+    entry.second.handle->Unref();
+  }
+  constant_cache_.clear();
 }
 
 void EagerContext::SetThreadLocalDevicePlacementPolicy(
@@ -390,7 +421,14 @@ Status EagerContext::RemoveFunction(const string& func) {
                                      func, "'.");
     }
     for (auto& key : *cache_keys) {
-      delete gtl::EraseKeyReturnValuePtr(&kernel_cache_, key);
+      // The key may already have been dropped by LRU eviction.
+      KernelAndDevice* kernel = gtl::EraseKeyReturnValuePtr(&kernel_cache_, key);
+      if (kernel != nullptr) kernel->Unref();
+      auto lru_iter = function_kernel_lru_index_.find(key);
+      if (lru_iter != function_kernel_lru_index_.end()) {
+        function_kernel_lru_.erase(lru_iter->second);
+        function_kernel_lru_index_.erase(lru_iter);
+      }
     }
   }
   {
@@ -401,18 +439,92 @@ Status EagerContext::RemoveFunction(const string& func) {
 }
 
 KernelAndDevice* EagerContext::GetCachedKernel(Fprint128 cache_key) {
-  tf_shared_lock l(cache_mu_);
-  return gtl::FindPtrOrNull(kernel_cache_, cache_key);
+  {
+    tf_shared_lock l(cache_mu_);
+    KernelAndDevice* kernel = gtl::FindPtrOrNull(kernel_cache_, cache_key);
+    if (kernel == nullptr) return nullptr;
+    if (function_kernel_lru_index_.count(cache_key) == 0) {
+      kernel->Ref();
+      return kernel;
+    }
+  }
+  // Hits on LRU-tracked function kernels refresh their position, which
+  // needs the exclusive lock.
+  mutex_lock ml(cache_mu_);
+  KernelAndDevice* kernel = gtl::FindPtrOrNull(kernel_cache_, cache_key);
+  if (kernel == nullptr) {
+    // Evicted between the two lookups.
+    return nullptr;
+  }
+  auto lru_iter = function_kernel_lru_index_.find(cache_key);
+  if (lru_iter != function_kernel_lru_index_.end()) {
+    function_kernel_lru_.splice(function_kernel_lru_.end(),
+                                function_kernel_lru_, lru_iter->second);
+  }
+  kernel->Ref();
+  return kernel;
 }
 
 void EagerContext::AddKernelToCache(Fprint128 cache_key,
                                     KernelAndDevice* kernel) {
   mutex_lock ml(cache_mu_);
+  kernel->Ref();
+  KernelAndDevice* old = gtl::FindPtrOrNull(kernel_cache_, cache_key);
+  if (old != nullptr) old->Unref();
   gtl::InsertOrUpdate(&kernel_cache_, cache_key, kernel);
   auto* keys = gtl::FindPtrOrNull(active_functions_, kernel->name());
-  // The kernel name can be either a primitive op or a function.
+  // The kernel name can be either a primitive op or a function. Function
+  // kernels are specialized per input shape signature, so their population
+  // is unbounded in principle; track them in LRU order and evict the
+  // coldest specialization once over the limit.
   if (keys != nullptr) {
     keys->emplace_back(cache_key);
+    auto lru_iter = function_kernel_lru_index_.find(cache_key);
+    if (lru_iter != function_kernel_lru_index_.end()) {
+      function_kernel_lru_.erase(lru_iter->second);
+      function_kernel_lru_index_.erase(lru_iter);
+    }
+    function_kernel_lru_.push_back(cache_key);
+    function_kernel_lru_index_[cache_key] =
+        std::prev(function_kernel_lru_.end());
+    while (function_kernel_lru_.size() >
+           static_cast<size_t>(function_kernel_cache_limit_)) {
+      const Fprint128 victim = function_kernel_lru_.front();
+      function_kernel_lru_.pop_front();
+      function_kernel_lru_index_.erase(victim);
+      KernelAndDevice* evicted =
+          gtl::EraseKeyReturnValuePtr(&kernel_cache_, victim);
+      if (evicted != nullptr) evicted->Unref();
+    }
+  }
+}
+
+TensorHandle* EagerContext::GetCachedConstant(Fprint128 cache_key) {
+  tf_shared_lock l(cache_mu_);
+  auto iter = constant_cache_.find(cache_key);
+  if (iter == constant_cache_.end()) {
+    return nullptr;
+  }
+  iter->second.handle->Ref();
+  return iter->second.handle;
+}
+
+void EagerContext::AddConstantToCache(Fprint128 cache_key,
+                                      TensorHandle* handle) {
+  mutex_lock ml(cache_mu_);
+  if (constant_cache_.size() >= kMaxCachedConstants) {
+    return;
+  }
+  auto result = constant_cache_.emplace(cache_key, CachedConstant());
+  if (!result.second) {
+    // Lost a race with a concurrent insert; the existing entry wins.
+    return;
+  }
+  handle->Ref();
+  result.first->second.handle = handle;
+  const Tensor* t = nullptr;
+  if (handle->Tensor(&t).ok()) {
+    result.first->second.pin = *t;
   }
 }
 
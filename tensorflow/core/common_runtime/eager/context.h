@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <list>
 #include <map>
 #include <memory>
 #include <queue>
@@ -75,6 +76,14 @@ enum ContextDevicePlacementPolicy {
   DEVICE_PLACEMENT_SILENT_FOR_INT32 = 3,
 };
 
+class TensorHandle;
+
+#if !defined(IS_MOBILE_PLATFORM)
+namespace eager {
+class RemoteOpBatcher;
+}  // namespace eager
+#endif  // IS_MOBILE_PLATFORM
+
 class RunMetadataListener {
  public:
   virtual ~RunMetadataListener() {}
@@ -162,10 +171,26 @@ class EagerContext : public core::RefCounted {
 
   Status RemoveFunction(const string& func);
 
+  // Returns the cached kernel for `cache_key` with a reference added for
+  // the caller, or nullptr. Hits on shape-specialized function kernels also
+  // refresh their LRU position.
   KernelAndDevice* GetCachedKernel(Fprint128 cache_key);
 
+  // Adds `kernel` to the cache, which takes its own reference. Function
+  // kernels (whose cache key includes the input shape signature) are
+  // LRU-tracked, and the least recently used one is evicted once the cache
+  // holds more of them than the limit.
   void AddKernelToCache(Fprint128 cache_key, KernelAndDevice* kernel);
 
+  // Small immutable constants (scalars, axis indices and the like) are
+  // deduped per destination device so loops do not re-materialize and
+  // re-copy them every iteration. A hit returns the handle with an extra
+  // reference for the caller; the cache keeps its own reference until
+  // ClearCaches.
+  TensorHandle* GetCachedConstant(Fprint128 cache_key);
+
+  void AddConstantToCache(Fprint128 cache_key, TensorHandle* handle);
+
   bool LogDevicePlacement() const { return log_device_placement_; }
   bool LogMemory() const { return log_memory_; }
 
@@ -235,6 +260,12 @@ class EagerContext : public core::RefCounted {
   Status GetClientAndContextID(Device* device, eager::EagerClient** client,
                                uint64* context_id);
 
+  // Batches consecutive async remote ops bound for the same worker into
+  // single Enqueue RPCs. See RemoteOpBatcher.
+  eager::RemoteOpBatcher* remote_op_batcher() {
+    return remote_op_batcher_.get();
+  }
+
   // TODO(nareshmodi): Encapsulate remote state into a separate
   // class/struct.
   //
@@ -320,6 +351,25 @@ class EagerContext : public core::RefCounted {
       GUARDED_BY(cache_mu_);
   std::unordered_map<string, std::vector<Fprint128>*> active_functions_
       GUARDED_BY(cache_mu_);
+  // Shape-specialized function kernels in least-recently-used order (oldest
+  // at the front), with an index from cache key to list position. Distinct
+  // input shape signatures instantiate distinct kernels, so this bounds how
+  // many specializations of defuns the context keeps alive; primitive-op
+  // kernels are not tracked.
+  std::list<Fprint128> function_kernel_lru_ GUARDED_BY(cache_mu_);
+  std::unordered_map<Fprint128, std::list<Fprint128>::iterator,
+                     Fprint128Hasher>
+      function_kernel_lru_index_ GUARDED_BY(cache_mu_);
+  const int64 function_kernel_cache_limit_;
+  // Each cached constant keeps a second Tensor aliasing the handle's buffer
+  // so that no kernel can ever claim exclusive ownership of the buffer and
+  // modify the constant in place.
+  struct CachedConstant {
+    TensorHandle* handle = nullptr;
+    Tensor pin;
+  };
+  std::unordered_map<Fprint128, CachedConstant, Fprint128Hasher>
+      constant_cache_ GUARDED_BY(cache_mu_);
 
   // Whether we should compute RunMetadata.
   std::atomic<bool> should_store_step_stats_{false};
@@ -360,6 +410,7 @@ class EagerContext : public core::RefCounted {
   WorkerEnv* worker_env_ = nullptr;
   std::shared_ptr<WorkerSession> worker_session_;
   std::unique_ptr<eager::EagerClientCache> remote_eager_workers_;
+  std::unique_ptr<eager::RemoteOpBatcher> remote_op_batcher_;
 
   mutex remote_state_mu_;
 
@@ -53,6 +53,30 @@ class CopyToDeviceNode : public EagerNode {
     return Status::OK();
   }
 
+  // When the source is already ready, the copy completes on the transfer
+  // stream; overriding RunAsync lets the executor issue the next copy while
+  // this one is in flight instead of blocking on a notification per
+  // transfer.
+  void RunAsync(StatusCallback done) override {
+    if (!src_->IsReady()) {
+      // Fall back to the blocking path, which waits for the producer.
+      done(Run());
+      return;
+    }
+    TensorHandle* dst = dst_;
+    dst->Ref();
+    src_->CopyToDeviceAsync(
+        ctx_, dstd_, [dst, done](const Status& s, const Tensor& tensor) {
+          // The destination must be ready before the executor marks this
+          // node done and releases its waiters.
+          if (s.ok()) dst->SetTensor(tensor);
+          dst->Unref();
+          done(s);
+        });
+  }
+
+  Device* device() const override { return dstd_; }
+
   TensorHandle* dst() { return dst_; }
 
  private:
@@ -17,12 +17,30 @@ limitations under the License.
 
 namespace tensorflow {
 
+namespace {
+
+// Bounds how many asynchronously-completing nodes a single device queue may
+// have in flight before dispatch pauses; this plays the role of a small
+// staging ring for pipelined device copies.
+const int kMaxInFlightNodes = 4;
+
+}  // namespace
+
 EagerNode::EagerNode(tensorflow::uint64 id) : id(id) {}
 
 EagerExecutor::~EagerExecutor() {
   tensorflow::mutex_lock l(node_queue_mutex_);
   thread_done_ = true;
   nodes_pending_.notify_all();
+  // In-flight asynchronous nodes hold a pointer to this executor; wait for
+  // their completions before the queues (and their threads) are destroyed.
+  for (auto& entry : device_queues_) {
+    while (entry.second->num_inflight > 0) {
+      all_done_.wait(l);
+    }
+  }
+  // The queue threads are joined when device_queues_ is destroyed, after
+  // this lock is released.
 }
 
 tensorflow::uint64 EagerExecutor::NextId() {
@@ -32,34 +50,39 @@ tensorflow::uint64 EagerExecutor::NextId() {
 
 void EagerExecutor::EnableAsync() {
   tensorflow::mutex_lock l(node_queue_mutex_);
-  if (thread_ == nullptr) {
-    thread_.reset(tensorflow::Env::Default()->StartThread(
+  async_enabled_ = true;
+}
+
+EagerExecutor::DeviceQueue* EagerExecutor::GetDeviceQueue(Device* device) {
+  std::unique_ptr<DeviceQueue>& device_queue = device_queues_[device];
+  if (device_queue == nullptr) {
+    device_queue.reset(new DeviceQueue);
+    device_queue->thread.reset(tensorflow::Env::Default()->StartThread(
         tensorflow::ThreadOptions(), "eager_async_executor",
-        std::bind(&EagerExecutor::Run, this)));
+        std::bind(&EagerExecutor::Run, this, device_queue.get())));
   }
+  return device_queue.get();
 }
 
 void EagerExecutor::Add(EagerNode* node) {
   tensorflow::mutex_lock l(node_queue_mutex_);
-  DCHECK(thread_) << "EnableAsync should have been called before Add";
+  DCHECK(async_enabled_) << "EnableAsync should have been called before Add";
   if (!status_.ok()) {
     delete node;
     return;
   }
-  int64 qlen = node_queue_.size();
-  if (qlen > 0) {
-    if (node_queue_.back()->id >= node->id) {
-      status_ = tensorflow::errors::InvalidArgument(
-          "Inserting EagerNode with non-increasing ids:",
-          node_queue_.back()->id, " vs ", node->id);
-      delete node;
-      return;
-    }
-    node_queue_.push(node);
-  } else {
-    node_queue_.push(node);
-    nodes_pending_.notify_all();
+  if (node->id <= max_id_added_) {
+    status_ = tensorflow::errors::InvalidArgument(
+        "Inserting EagerNode with non-increasing ids:", max_id_added_, " vs ",
+        node->id);
+    delete node;
+    return;
   }
+  max_id_added_ = node->id;
+  pending_ids_.insert(node->id);
+  DeviceQueue* device_queue = GetDeviceQueue(node->device());
+  device_queue->queue.push(node);
+  nodes_pending_.notify_all();
 }
 
 tensorflow::Status EagerExecutor::WaitFor(tensorflow::uint64 node_id) {
@@ -76,12 +99,16 @@ tensorflow::Status EagerExecutor::WaitImpl(bool wait_all,
   tensorflow::mutex_lock l(node_queue_mutex_);
   // Don't wait if an error is already set.
   if (!status_.ok()) return status_;
-  if (node_queue_.empty()) return tensorflow::Status::OK();
+  if (pending_ids_.empty()) return tensorflow::Status::OK();
   if (wait_all) {
-    node_id = node_queue_.back()->id;
-  } else if (node_id < node_queue_.front()->id) {
-    // Note that we are relying on the ops being dispatched sequentially from
-    // the queue.
+    // Barrier across all device queues.
+    while (!pending_ids_.empty() && status_.ok()) {
+      all_done_.wait(l);
+    }
+    return status_;
+  }
+  if (pending_ids_.count(node_id) == 0 && node_id <= max_id_added_) {
+    // The node has already finished executing.
     return tensorflow::Status::OK();
   }
   node_done_notifications_.insert(std::make_pair(node_id, &cond));
@@ -94,10 +121,11 @@ tensorflow::Status EagerExecutor::WaitImpl(bool wait_all,
 void EagerExecutor::ClearError() {
   tensorflow::mutex_lock l(node_queue_mutex_);
   if (status_.ok()) return;
-  // If an error was set, node_done_notifications_ and node_queue_ should have
-  // been cleared, and no new entries should have been added since.
+  // If an error was set, node_done_notifications_ and the queues should have
+  // been cleared, and no new entries should have been added since.  Nodes
+  // that were already running in other device queues when the error hit may
+  // still be draining, so pending_ids_ is not necessarily empty here.
   DCHECK(node_done_notifications_.empty());
-  DCHECK(node_queue_.empty());
   status_ = tensorflow::Status::OK();
   nodes_pending_.notify_all();
 }
@@ -107,45 +135,77 @@ tensorflow::Status EagerExecutor::status() {
   return status_;
 }
 
-void EagerExecutor::Run() {
+void EagerExecutor::Run(DeviceQueue* device_queue) {
   while (true) {
-    std::unique_ptr<EagerNode> curr_node;
+    EagerNode* curr_node;
     {
       tensorflow::mutex_lock l(node_queue_mutex_);
-      while (node_queue_.empty() || !status_.ok()) {
+      while (device_queue->queue.empty() || !status_.ok() ||
+             device_queue->num_inflight >= kMaxInFlightNodes) {
         if (thread_done_) return;
         nodes_pending_.wait(l);
       }
-      curr_node.reset(node_queue_.front());
+      // Transfer ownership out of the queue: if another queue hits an error
+      // while this node is running, the error sweep in NodeDone must not
+      // delete it out from under us.
+      curr_node = device_queue->queue.front();
+      device_queue->queue.pop();
+      ++device_queue->num_inflight;
     }
-    tensorflow::Status status = curr_node->Run();
-    const bool ok = status.ok();
-    tensorflow::mutex_lock l(node_queue_mutex_);
-    node_queue_.pop();
-    if (!ok) {
-      status_ = status;
-      // TODO(agarwal): mark all affected handles as corrupted before clearing
-      // this queue.
-      // We remove any pending ops so that we don't try to execute them if
-      // ClearError is called.
-      for (int i = 0; i < node_queue_.size(); ++i) {
-        delete node_queue_.front();
-        node_queue_.pop();
+    // Data dependence on nodes draining in other device queues is enforced
+    // inside the node: consuming an unready TensorHandle blocks on the
+    // producing node's id.  Synchronous nodes invoke the completion inline;
+    // asynchronous ones (e.g. pipelined device copies) invoke it later from
+    // a device event thread while the next node is dispatched.
+    curr_node->RunAsync(
+        [this, device_queue, curr_node](const tensorflow::Status& status) {
+          NodeDone(device_queue, curr_node, status);
+        });
+  }
+}
+
+void EagerExecutor::NodeDone(DeviceQueue* device_queue, EagerNode* node,
+                             const tensorflow::Status& status) {
+  std::unique_ptr<EagerNode> curr_node(node);
+  const bool ok = status.ok();
+  tensorflow::mutex_lock l(node_queue_mutex_);
+  --device_queue->num_inflight;
+  pending_ids_.erase(curr_node->id);
+  if (!ok) {
+    // Keep the first error if several queues fail concurrently.
+    if (status_.ok()) status_ = status;
+    // TODO(agarwal): mark all affected handles as corrupted before clearing
+    // this queue.
+    // We remove any pending ops, from every queue, so that we don't try to
+    // execute them if ClearError is called.
+    for (auto& queue_entry : device_queues_) {
+      std::queue<EagerNode*>* queue = &queue_entry.second->queue;
+      while (!queue->empty()) {
+        pending_ids_.erase(queue->front()->id);
+        delete queue->front();
+        queue->pop();
       }
     }
-    if (!node_done_notifications_.empty()) {
-      tensorflow::uint64 node_id = curr_node->id;
-      // Note that we notify all waiting threads in case an error has occurred.
-      // These calling threads are responsible for checking status_ before
-      // proceeding.
-      const auto range = ok ? node_done_notifications_.equal_range(node_id)
-                            : make_pair(node_done_notifications_.begin(),
-                                        node_done_notifications_.end());
-      for (auto it = range.first; it != range.second; ++it) {
-        it->second->notify_all();
-      }
-      node_done_notifications_.erase(range.first, range.second);
+  }
+  if (pending_ids_.empty() || device_queue->num_inflight == 0) {
+    // The destructor also waits on all_done_ for in-flight completions to
+    // drain.
+    all_done_.notify_all();
+  }
+  // Wake dispatch threads that may be throttled on the in-flight bound.
+  nodes_pending_.notify_all();
+  if (!node_done_notifications_.empty()) {
+    tensorflow::uint64 node_id = curr_node->id;
+    // Note that we notify all waiting threads in case an error has occurred.
+    // These calling threads are responsible for checking status_ before
+    // proceeding.
+    const auto range = ok ? node_done_notifications_.equal_range(node_id)
+                          : make_pair(node_done_notifications_.begin(),
+                                      node_done_notifications_.end());
+    for (auto it = range.first; it != range.second; ++it) {
+      it->second->notify_all();
     }
+    node_done_notifications_.erase(range.first, range.second);
   }
 }
 
@@ -17,17 +17,21 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
 #include <queue>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
@@ -50,6 +54,18 @@ class EagerNode {
   // execution is done.
   virtual Status Run() = 0;
 
+  // Runs the computation and invokes `done` exactly once when the node's
+  // outputs are ready, possibly from another thread. The default
+  // implementation adapts the synchronous Run; nodes whose work completes
+  // asynchronously (e.g. a copy enqueued on a transfer stream) override
+  // this so the executor can keep several of them in flight.
+  virtual void RunAsync(StatusCallback done) { done(Run()); }
+
+  // The device on which this node's work runs, if known.  The executor
+  // dispatches nodes bound to different devices concurrently; nodes that
+  // return nullptr share a single in-order queue.
+  virtual Device* device() const { return nullptr; }
+
   // An id unique to the TFE_Context under which this node is created. Allocated
   // monotonically.
   const uint64 id;
@@ -57,12 +73,23 @@ class EagerNode {
 
 // A class for handling async execution (see TFE_ContextSetAsync).
 // Note that this class is thread-safe.
+//
+// Pending nodes are partitioned into one FIFO queue per target device, each
+// drained in order by its own thread, so ops bound to different devices run
+// concurrently.  Data dependence across queues is enforced through
+// TensorHandle: consuming an unready handle blocks on the producing node's
+// id (see TensorHandle::WaitReady), so a cross-device edge inserts a wait
+// while independent streams of work proceed.
+//
+// Nodes that complete asynchronously (see EagerNode::RunAsync) do not hold
+// up their queue: the dispatch thread issues the next node while up to a
+// small bounded number of completions are still in flight, so back-to-back
+// device copies pipeline instead of serializing on each transfer.
+//
 // TODO(agarwal): TFE_OpAddInput may currently block if it tries to access the
 // device of the input handle. Fix that.
 // TODO(agarwal): On error, mark all affected handles as corrupted.
 // TODO(agarwal): Implement support for control dependencies.
-// TODO(agarwal): Support out-of-order execution and dispatching multiple
-// EagerNode in parallel.
 // TODO(agarwal): Implement optimizations over EagerNode traces.
 class EagerExecutor {
  public:
@@ -85,7 +112,8 @@ class EagerExecutor {
   // execution.
   Status WaitFor(uint64 node_id);
 
-  // Blocks till all currently pending ops are done.
+  // Blocks till all currently pending ops are done, across all device
+  // queues.
   Status WaitForAllPendingNodes();
 
   // Clears all currently set errors which re-enables async execution.
@@ -95,21 +123,52 @@ class EagerExecutor {
   Status status();
 
  private:
-  // Starts execution of pending EagerNodes. This function loops till
-  // thread_done_ is set to true. If any errors are encontered, these are set
-  // inside `status_`. The loop blocks anytime there are no pending nodes, or if
-  // `status_` is not ok.
-  void Run();
+  // One FIFO queue of pending EagerNodes per target device, drained in
+  // order by its own thread.
+  struct DeviceQueue {
+    std::queue<EagerNode*> queue;
+    std::unique_ptr<Thread> thread;
+    // Number of dispatched nodes whose RunAsync completion has not fired
+    // yet. Dispatch pauses when this reaches the in-flight bound.
+    int num_inflight = 0;
+  };
+
+  // Starts execution of pending EagerNodes in `device_queue`. This function
+  // loops till thread_done_ is set to true. If any errors are encountered,
+  // these are set inside `status_`. The loop blocks anytime there are no
+  // pending nodes in the queue, or if `status_` is not ok.
+  void Run(DeviceQueue* device_queue);
+
+  // Called exactly once per dispatched node, after its outputs are ready
+  // (possibly from a device event thread). Records errors, releases the
+  // node's in-flight slot and wakes any waiters.
+  void NodeDone(DeviceQueue* device_queue, EagerNode* node,
+                const Status& status);
 
   Status WaitImpl(bool wait_all, uint64 node_id);
 
+  // Returns the queue for `device`, starting its thread on first use.
+  DeviceQueue* GetDeviceQueue(Device* device)
+      EXCLUSIVE_LOCKS_REQUIRED(node_queue_mutex_);
+
   mutex node_queue_mutex_;
 
   // Used to signal that some EagerNodes are pending execution.
   condition_variable nodes_pending_ GUARDED_BY(node_queue_mutex_);
 
-  // Queue of pending EagerNodes.
-  std::queue<EagerNode*> node_queue_ GUARDED_BY(node_queue_mutex_);
+  // Notified whenever the set of pending nodes drains to empty.
+  condition_variable all_done_ GUARDED_BY(node_queue_mutex_);
+
+  // Pending EagerNodes, keyed by the device their work runs on.  Nodes with
+  // no known device (nullptr) share one queue.
+  std::unordered_map<Device*, std::unique_ptr<DeviceQueue>> device_queues_
+      GUARDED_BY(node_queue_mutex_);
+
+  // Ids of all nodes that have been added but have not finished executing.
+  gtl::FlatSet<uint64> pending_ids_ GUARDED_BY(node_queue_mutex_);
+
+  // The largest node id passed to Add so far.
+  uint64 max_id_added_ GUARDED_BY(node_queue_mutex_) = 0;
 
   // `status_` is set based on any errors raised during execution of a
   // EagerNode.  It remains set until ClearError is called.
@@ -121,12 +180,11 @@ class EagerExecutor {
   std::multimap<uint64, condition_variable*> node_done_notifications_
       GUARDED_BY(node_queue_mutex_);
 
-  // Thread object that calls the `Run` method. Currently we use only one thread
-  // for executing the EagerNodes one-by-one.
-  std::unique_ptr<Thread> thread_ GUARDED_BY(node_queue_mutex_);
+  // Set by EnableAsync; queue threads are started lazily per device.
+  bool async_enabled_ GUARDED_BY(node_queue_mutex_) = false;
 
-  // Indicates that `thread_` should stop as soon as it is done executing the
-  // current EagerNode.
+  // Indicates that the queue threads should stop as soon as they are done
+  // executing their current EagerNode.
   bool thread_done_ GUARDED_BY(node_queue_mutex_) = false;
 
   mutex next_id_mutex_;
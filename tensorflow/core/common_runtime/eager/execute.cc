@@ -38,17 +38,19 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #if !defined(IS_MOBILE_PLATFORM)
 #include "tensorflow/core/distributed_runtime/eager/eager_client.h"
-#include "tensorflow/core/distributed_runtime/eager/remote_execute_node.h"
+#include "tensorflow/core/distributed_runtime/eager/remote_op_batcher.h"
 #endif  // IS_MOBILE_PLATFORM
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/ptr_util.h"
 
@@ -88,6 +90,33 @@ int StepStatsDeviceIndex(StepStats* step_stats, EagerContext* ctx,
   return 0;
 }
 
+// Returns true if "op" may bypass the EagerExecutor queue in async mode and
+// run synchronously on the calling thread.  This is only safe when nothing
+// observable can depend on the op's position in the queue: the kernel must be
+// known-cheap (otherwise inline execution stalls the client thread), every
+// input must already be ready (so the op has no data dependence on pending
+// nodes), and the op must be stateless with no resource inputs (so it cannot
+// be reordered against pending side effects).
+bool ShouldExecuteInline(EagerContext* ctx, EagerOperation* op,
+                         KernelAndDevice* kernel) {
+  OpKernel* op_kernel = const_cast<OpKernel*>(kernel->kernel());
+  if (op_kernel == nullptr || op_kernel->IsExpensive()) {
+    return false;
+  }
+  const OpDef* op_def = nullptr;
+  if (!OpDefForOp(op->Name().c_str(), &op_def).ok() || op_def->is_stateful()) {
+    return false;
+  }
+  for (TensorHandle* input : op->Inputs()) {
+    if (input->dtype == DT_RESOURCE || !input->IsReady()) {
+      return false;
+    }
+  }
+  // Preserve the async contract that ops enqueued after a failure observe
+  // the executor's error.
+  return ctx->GetStatus().ok();
+}
+
 // This function expects *handle to point to an existing tensor handle. The
 // function will (maybe) update the *handle to be pointed to the newly copied
 // tensor handle.
@@ -640,12 +669,17 @@ Status EagerLocalExecute(EagerOperation* op,
 
     status = kernel->Init(ndef, graph_collector);
     if (!status.ok()) {
-      delete kernel;
+      kernel->Unref();
       return status;
     }
 
     ctx->AddKernelToCache(cache_key, kernel);
   }
+  // The cache-hit path returned the kernel with a reference for us; on the
+  // creation path we still hold the initial one. Either way it is released
+  // when this frame exits, while the cache (and any pending async node)
+  // keeps its own.
+  core::ScopedUnref kernel_unref(kernel);
   const DataTypeVector& output_dtypes = kernel->output_dtypes();
   const int output_dtypes_size = static_cast<int>(output_dtypes.size());
   if (output_dtypes_size > *num_retvals) {
@@ -681,11 +715,9 @@ Status EagerLocalExecute(EagerOperation* op,
     // TODO(apassos) track referenced tensors
   }
   retvals->resize(*num_retvals);
-  if (ctx->Async()) {
+  if (ctx->Async() && !ShouldExecuteInline(ctx, op, kernel)) {
     // Note that for async mode, execution order will make sure that all
     // input handles are ready before executing them.
-    // TODO(agarwal): Consider executing "cheap" kernels inline for
-    // performance.
     tensorflow::uint64 id = ctx->NextId();
     for (int i = 0; i < *num_retvals; ++i) {
       (*retvals)[i] = new TensorHandle(
@@ -699,6 +731,11 @@ Status EagerLocalExecute(EagerOperation* op,
                                       graph_collector, output_dtypes, *retvals);
     ctx->ExecutorAdd(node);
   } else {
+    // Sync mode, or an async-mode op that ShouldExecuteInline judged cheap
+    // and ready: run on the calling thread, skipping the queue round trip
+    // through the EagerExecutor thread, which costs more than a cheap
+    // kernel itself.
+    //
     // Execute checks if retvals[i] is nullptr or not to figure if it needs to
     // allocate it.
     status = EagerKernelExecute(ctx, op->Inputs(), kernel, maybe_stats.get(),
@@ -724,20 +761,28 @@ std::function<void()> GetRemoteTensorDestructor(
       return tensorflow::Status::OK();
     }
 
-    std::unique_ptr<eager::EnqueueRequest> request(new eager::EnqueueRequest);
-    request->set_context_id(context_id);
-
-    auto* handle_to_decref = request->add_queue()->mutable_handle_to_decref();
-    handle_to_decref->set_op_id(op_id);
-    handle_to_decref->set_output_num(output_num);
-
     if (ctx->Async()) {
+      // Join the open Enqueue batch for this worker so the decref rides
+      // along with the next batch of ops instead of costing an RPC of its
+      // own.
+      eager::QueueItem item;
+      auto* handle_to_decref = item.mutable_handle_to_decref();
+      handle_to_decref->set_op_id(op_id);
+      handle_to_decref->set_output_num(output_num);
+      int index = 0;
+      std::shared_ptr<eager::RemoteOpBatch> batch =
+          ctx->remote_op_batcher()->Append(eager_client, context_id,
+                                           std::move(item), nullptr, &index);
       tensorflow::uint64 id = ctx->NextId();
-      auto* node =
-          new eager::RemoteExecuteNode(id, std::move(request), eager_client);
-      ctx->ExecutorAdd(node);
+      ctx->ExecutorAdd(
+          new eager::RemoteOpBatchNode(id, std::move(batch), index));
     } else {
-      eager::EnqueueRequest* actual_request = request.release();
+      eager::EnqueueRequest* actual_request = new eager::EnqueueRequest;
+      actual_request->set_context_id(context_id);
+      auto* handle_to_decref =
+          actual_request->add_queue()->mutable_handle_to_decref();
+      handle_to_decref->set_op_id(op_id);
+      handle_to_decref->set_output_num(output_num);
       eager::EnqueueResponse* response = new eager::EnqueueResponse;
       eager_client->EnqueueAsync(
           actual_request, response,
@@ -838,12 +883,8 @@ Status EagerRemoteExecute(EagerOperation* op, TensorHandle** retvals,
   TF_RETURN_IF_ERROR(
       ctx->GetClientAndContextID(op->Device(), &eager_client, &context_id));
 
-  std::unique_ptr<eager::EnqueueRequest> request(new eager::EnqueueRequest);
-  eager::EnqueueResponse response;
-
-  request->set_context_id(context_id);
-
-  auto* remote_op = request->add_queue()->mutable_operation();
+  eager::QueueItem item;
+  auto* remote_op = item.mutable_operation();
 
   for (int i = 0; i < op->Inputs().size(); i++) {
     tensorflow::Device* input_device = op->Inputs()[i]->device();
@@ -901,9 +942,6 @@ Status EagerRemoteExecute(EagerOperation* op, TensorHandle** retvals,
 
   const tensorflow::uint64 id = remote_op->id();
   for (int i = 0; i < *num_retvals; i++) {
-    // TODO(nareshmodi): Change the callback to instead add the decref to a
-    // list of pending decrefs that we can send as a batch with the next
-    // execute.
     std::function<void()> destructor =
         GetRemoteTensorDestructor(ctx, eager_client, context_id, id, i);
 
@@ -930,26 +968,50 @@ Status EagerRemoteExecute(EagerOperation* op, TensorHandle** retvals,
       retvals_copy.push_back(retvals[i]);
       retvals_copy[i]->Ref();
     }
+    // Hold the inputs until the batched RPC has completed, so their remote
+    // counterparts cannot be decref'd away before this op runs.
+    gtl::InlinedVector<TensorHandle*, 4> inputs_copy = op->Inputs();
+    for (auto* input : inputs_copy) {
+      input->Ref();
+    }
     // Unable to capture via std::move, so bind instead.
-    auto* node = new eager::RemoteExecuteNode(
-        remote_node_id, std::move(request), eager_client, op->Inputs(),
-        std::bind(
-            [](const gtl::InlinedVector<TensorHandle*, 2>& retvals,
-               const Status& status, const eager::EnqueueResponse& response) {
-              if (!status.ok()) return;
-              for (int i = 0; i < retvals.size(); i++) {
-                retvals[i]->SetRemoteShape(MakeUnique<TensorShape>(
-                    response.queue_response(0).shape(i)));
-                retvals[i]->Unref();
-              }
-            },
-            std::move(retvals_copy), std::placeholders::_1,
-            std::placeholders::_2));
-    op->EagerContext()->ExecutorAdd(node);
+    eager::RemoteOpBatch::ItemDoneCallback done = std::bind(
+        [](const gtl::InlinedVector<TensorHandle*, 2>& retvals,
+           const gtl::InlinedVector<TensorHandle*, 4>& inputs,
+           const Status& status,
+           const eager::QueueResponse& queue_response) {
+          for (int i = 0; i < retvals.size(); i++) {
+            if (status.ok()) {
+              retvals[i]->SetRemoteShape(
+                  MakeUnique<TensorShape>(queue_response.shape(i)));
+            }
+            retvals[i]->Unref();
+          }
+          for (auto* input : inputs) {
+            input->Unref();
+          }
+        },
+        std::move(retvals_copy), std::move(inputs_copy),
+        std::placeholders::_1, std::placeholders::_2);
+    // Join the open Enqueue batch for this worker: the op is sent together
+    // with the other ops queued behind the executor, and this node completes
+    // from the shared response.
+    int index = 0;
+    std::shared_ptr<eager::RemoteOpBatch> batch =
+        ctx->remote_op_batcher()->Append(eager_client, context_id,
+                                         std::move(item), std::move(done),
+                                         &index);
+    op->EagerContext()->ExecutorAdd(
+        new eager::RemoteOpBatchNode(remote_node_id, std::move(batch), index));
   } else {
+    eager::EnqueueRequest request;
+    request.set_context_id(context_id);
+    *request.add_queue() = std::move(item);
+    eager::EnqueueResponse response;
+
     Notification n;
     Status status;
-    eager_client->EnqueueAsync(request.get(), &response,
+    eager_client->EnqueueAsync(&request, &response,
                                [&n, &status](const Status& s) {
                                  status = s;
                                  n.Notify();
@@ -1228,9 +1290,52 @@ Status EagerKernelExecute(EagerContext* ctx,
 
 namespace {
 
+// Upper bound on the size of tensors served from the EagerContext constant
+// cache. Covers scalars and small shape/axis tuples.
+const int64 kSmallConstantBytes = 64;
+
+// Returns true and fills *key if `h` qualifies for the EagerContext constant
+// cache when copied to `dstd`: it must be resident on the host CPU (so its
+// contents can be fingerprinted), ready, at most kSmallConstantBytes, and of
+// a dtype whose buffer is a plain byte string.
+bool SmallConstantCacheKey(TensorHandle* h, EagerContext* ctx, Device* dstd,
+                           Fprint128* key) {
+  if (h->device() != nullptr && h->device() != ctx->HostCPU()) return false;
+  if (!h->IsReady()) return false;
+  const Tensor* tensor = nullptr;
+  if (!h->Tensor(&tensor).ok()) return false;
+  if (!DataTypeCanUseMemcpy(tensor->dtype())) return false;
+  if (tensor->TotalBytes() > kSmallConstantBytes) return false;
+  string buf = strings::StrCat(dstd->name(), ",", tensor->dtype());
+  for (int i = 0; i < tensor->dims(); ++i) {
+    strings::StrAppend(&buf, ",", tensor->dim_size(i));
+  }
+  buf.push_back(';');
+  const StringPiece data = tensor->tensor_data();
+  buf.append(data.data(), data.size());
+  *key = Fingerprint128(buf);
+  return true;
+}
+
 Status LocalEagerCopyToDevice(TensorHandle* h, EagerContext* ctx, Device* dstd,
                               TensorHandle** result) {
   TF_RETURN_IF_ERROR(ctx->GetStatus());
+  // Small constants like 1.0 or axis indices tend to recur every loop
+  // iteration; serve them from the per-context cache of permanently-alive
+  // residents instead of allocating and copying a fresh tensor each time.
+  Fprint128 cache_key;
+  if (SmallConstantCacheKey(h, ctx, dstd, &cache_key)) {
+    TensorHandle* cached = ctx->GetCachedConstant(cache_key);
+    if (cached != nullptr) {
+      *result = cached;
+      return Status::OK();
+    }
+    // `h` is ready, so even in async mode the copy can be done inline; the
+    // resident is then immediately available to every later hit.
+    TF_RETURN_IF_ERROR(h->CopyToDevice(ctx, dstd, result));
+    ctx->AddConstantToCache(cache_key, *result);
+    return Status::OK();
+  }
   if (ctx->Async()) {
     // Note that `h` may not be currently ready. However execution order will
     // make sure that `h` is ready before the copy is actually done.
@@ -45,6 +45,9 @@ class ExecuteNode : public EagerNode {
         maybe_step_stats_(maybe_step_stats),
         graph_collector_(graph_collector),
         retvals_(retvals) {
+    // Hold the kernel alive in case it is evicted from the context's kernel
+    // cache while this node is still pending.
+    kernel_->Ref();
     for (auto handle : inputs_) {
       handle->Ref();
     }
@@ -54,6 +57,7 @@ class ExecuteNode : public EagerNode {
   }
 
   ~ExecuteNode() override {
+    kernel_->Unref();
     for (auto handle : inputs_) {
       handle->Unref();
     }
@@ -76,6 +80,8 @@ class ExecuteNode : public EagerNode {
     }
   }
 
+  Device* device() const override { return kernel_->device(); }
+
  private:
   tensorflow::EagerContext* ctx_;
   tensorflow::gtl::InlinedVector<TensorHandle*, 4> inputs_;
@@ -76,6 +76,24 @@ Status KernelAndDeviceOp::Init(const NodeDef& ndef,
   }
   TF_RETURN_IF_ERROR(flr_->CreateKernel(ndef, &k));
   kernel_.reset(k);
+
+  // Precompute the per-call scaffolding that depends only on the kernel, so
+  // Run does not rebuild it on every invocation.
+  input_alloc_attrs_.resize(kernel_->num_inputs());
+  for (size_t i = 0; i < input_alloc_attrs_.size(); ++i) {
+    input_alloc_attrs_[i].set_on_host(kernel_->input_memory_types()[i] ==
+                                      tensorflow::HOST_MEMORY);
+  }
+  output_alloc_attrs_.resize(kernel_->num_outputs());
+  for (size_t i = 0; i < output_alloc_attrs_.size(); ++i) {
+    output_alloc_attrs_[i].set_on_host(kernel_->output_memory_types()[i] ==
+                                       tensorflow::HOST_MEMORY);
+  }
+  DeviceContext* device_context = nullptr;
+  if (device_->tensorflow_gpu_device_info() != nullptr) {
+    device_context = device_->tensorflow_gpu_device_info()->default_context;
+  }
+  input_device_contexts_.resize(kernel_->num_inputs(), device_context);
   return Status::OK();
 }
 
@@ -220,34 +238,16 @@ Status KernelAndDeviceOp::Run(ScopedStepContainer* step_container,
                               std::vector<Tensor>* outputs,
                               NodeExecStats* stats, StepStats* step_stats,
                               GraphCollector* graph_collector) {
-  gtl::InlinedVector<AllocatorAttributes, 4> in_attrs(kernel_->num_inputs());
-  for (size_t i = 0; i < in_attrs.size(); ++i) {
-    in_attrs[i].set_on_host(kernel_->input_memory_types()[i] ==
-                            tensorflow::HOST_MEMORY);
-  }
-  std::vector<AllocatorAttributes> out_attrs(kernel_->num_outputs());
-  for (size_t i = 0; i < out_attrs.size(); ++i) {
-    out_attrs[i].set_on_host(kernel_->output_memory_types()[i] ==
-                             tensorflow::HOST_MEMORY);
-  }
-
-  gtl::InlinedVector<DeviceContext*, 4> input_device_contexts;
-  for (int i = 0; i < inputs.size(); i++) {
-    DeviceContext* device_context = nullptr;
-    if (device_->tensorflow_gpu_device_info() != nullptr) {
-      device_context = device_->tensorflow_gpu_device_info()->default_context;
-    }
-    input_device_contexts.push_back(device_context);
-  }
-
+  // The allocator attributes and device contexts depend only on the kernel;
+  // they were precomputed in Init and are shared read-only across calls.
   OpKernelContext::Params params;
   params.device = device_;
   params.frame_iter = FrameAndIter(0, 0);
   params.inputs = &inputs;
   params.op_kernel = kernel_.get();
   params.resource_manager = device_->resource_manager();
-  params.input_alloc_attrs = &in_attrs;
-  params.output_attr_array = gtl::vector_as_array(&out_attrs);
+  params.input_alloc_attrs = &input_alloc_attrs_;
+  params.output_attr_array = output_alloc_attrs_.data();
   params.function_library = flr_;
   params.slice_reader_cache = &slice_reader_cache_;
   params.rendezvous = rendez_;
@@ -277,7 +277,7 @@ Status KernelAndDeviceOp::Run(ScopedStepContainer* step_container,
   params.step_container = step_container;
   params.collective_executor =
       collective_executor_ ? collective_executor_->get() : nullptr;
-  params.input_device_contexts = &input_device_contexts;
+  params.input_device_contexts = &input_device_contexts_;
 
   OpKernelContext context(&params);
 
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/platform/fingerprint.h"
@@ -46,11 +47,16 @@ class FunctionLibraryRuntime;
 // KernelAndDeviceOp below) or a multi-device function (implemented by
 // KernelAndDeviceFunc below).
 //
+// Instances are reference counted: the EagerContext kernel cache holds one
+// reference, and every user of a kernel (an executing op, a pending async
+// node) holds its own, so evicting a kernel from the cache cannot delete it
+// out from under a concurrent execution.
+//
 // Also see:
 // https://www.tensorflow.org/code/tensorflow/core/common_runtime/kernel_benchmark_testlib.h
 // and
 // https://www.tensorflow.org/code/tensorflow/core/kernels/ops_testutil.h
-class KernelAndDevice {
+class KernelAndDevice : public core::RefCounted {
  public:
   // Populates this with a kernel appropriate for 'ndef'.
   //
@@ -75,7 +81,7 @@ class KernelAndDevice {
         collective_executor_(std::move(collective_executor)) {}
 
   // Not thread safe.
-  virtual ~KernelAndDevice() {}
+  ~KernelAndDevice() override {}
 
   // TODO(ashankar): Handle list-valued inputs.
   virtual Status Run(const gtl::InlinedVector<TensorValue, 4>& inputs,
@@ -174,6 +180,13 @@ class KernelAndDeviceOp final : public KernelAndDevice {
   checkpoint::TensorSliceReaderCacheWrapper slice_reader_cache_;
   const bool log_memory_;
 
+  // Per-call scaffolding that depends only on the kernel, precomputed in
+  // Init and shared read-only by every Run: rebuilding these vectors per
+  // invocation costs more than many of the kernels they wrap.
+  gtl::InlinedVector<AllocatorAttributes, 4> input_alloc_attrs_;
+  std::vector<AllocatorAttributes> output_alloc_attrs_;
+  gtl::InlinedVector<DeviceContext*, 4> input_device_contexts_;
+
   // For deferred ops, AsyncOpKernel::DoneCallback is called once the op is
   // enqueued to device. The execution of the op may not finish when
   // device_->Compute returns. We rely on no_deferred_ops_cv_ to know when the
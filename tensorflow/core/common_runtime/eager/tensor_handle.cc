@@ -366,6 +366,73 @@ Status TensorHandle::CopyToDevice(EagerContext* ctx, tensorflow::Device* dstd,
   return status;
 }
 
+void TensorHandle::CopyToDeviceAsync(
+    EagerContext* ctx, tensorflow::Device* dstd,
+    std::function<void(const Status&, const tensorflow::Tensor&)> done) {
+  const tensorflow::Tensor* src = nullptr;
+  tensorflow::Device* srcd = nullptr;
+  tensorflow::Device* src_opd = nullptr;
+  tensorflow::Status s = TensorAndDevice(&src, &srcd, &src_opd);
+  if (!s.ok()) {
+    done(s, tensorflow::Tensor());
+    return;
+  }
+  if (srcd == nullptr) srcd = ctx->HostCPU();
+  bool is_same_device = (srcd == dstd) || (srcd->name() == dstd->name());
+  const bool dst_cpu = dstd->tensorflow_gpu_device_info() == nullptr;
+  const bool src_cpu = srcd->tensorflow_gpu_device_info() == nullptr;
+  if (is_same_device) {
+    done(tensorflow::Status::OK(), *src);
+    return;
+  }
+  if (!dst_cpu && (src->dtype() != tensorflow::DT_VARIANT &&
+                   !tensorflow::DataTypeCanUseMemcpy(src->dtype()))) {
+    done(tensorflow::errors::InvalidArgument(
+             "Can't copy Tensor with type ",
+             tensorflow::DataTypeString(src->dtype()), " to device ",
+             dstd->name(), "."),
+         tensorflow::Tensor());
+    return;
+  }
+  tensorflow::AllocatorAttributes attr;
+  if (src->dtype() == tensorflow::DT_VARIANT) {
+    attr.set_on_host(true);
+  }
+  tensorflow::Tensor* dst = new tensorflow::Tensor(dstd->GetAllocator(attr),
+                                                   src->dtype(), src->shape());
+  if (src->shape().num_elements() == 0) {
+    done(tensorflow::Status::OK(), *dst);
+    delete dst;
+    return;
+  }
+  tensorflow::DeviceContext* src_device_context = nullptr;
+  if (!src_cpu) {
+    src_device_context = srcd->tensorflow_gpu_device_info()->default_context;
+    // A device source may still be producing the tensor on another stream;
+    // stay with the synchronous path's conservative Sync before reading it.
+    s = srcd->Sync();
+    if (!s.ok()) {
+      done(s, tensorflow::Tensor());
+      delete dst;
+      return;
+    }
+  }
+  tensorflow::DeviceContext* dst_device_context = nullptr;
+  if (!dst_cpu) {
+    dst_device_context = dstd->tensorflow_gpu_device_info()->default_context;
+  }
+  // The destination tensor stays alive in the closure until the transfer
+  // stream reports completion.
+  tensorflow::CopyTensor::ViaDMA("copy", src_device_context, dst_device_context,
+                                 srcd, dstd, tensorflow::AllocatorAttributes(),
+                                 tensorflow::AllocatorAttributes(), src, dst,
+                                 0 /*dev_to_dev_stream_index*/,
+                                 [done, dst](const tensorflow::Status& status) {
+                                   done(status, *dst);
+                                   delete dst;
+                                 });
+}
+
 Device* GetResourceDevice(const Tensor& t, EagerContext* ctx) {
   if (t.dtype() != DT_RESOURCE) {
     return nullptr;
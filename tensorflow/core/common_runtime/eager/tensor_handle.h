@@ -81,6 +81,11 @@ class TensorHandle : public core::RefCounted {
 
   Status TensorValue(tensorflow::TensorValue* t);
 
+  // Returns true if the tensor pointed to by this handle has been computed,
+  // without blocking. Ready handles can be read with the accessors above
+  // without waiting.
+  bool IsReady();
+
   tensorflow::Device* device() const { return device_; }
   tensorflow::Device* op_device() const { return op_device_; }
   tensorflow::Device* resource_device() const { return resource_device_; }
@@ -105,6 +110,16 @@ class TensorHandle : public core::RefCounted {
   Status CopyToDevice(EagerContext* ctx, tensorflow::Device* dstd,
                       TensorHandle** output);
 
+  // Asynchronous variant of CopyToDevice for ready handles: validation and
+  // destination allocation happen inline, but the transfer itself is
+  // enqueued on the device's copy stream and `done` is invoked with the
+  // copied tensor once it completes, so back-to-back copies pipeline
+  // instead of each blocking on a notification. The handle must be ready
+  // and must stay alive until `done` has run.
+  void CopyToDeviceAsync(
+      EagerContext* ctx, tensorflow::Device* dstd,
+      std::function<void(const Status&, const tensorflow::Tensor&)> done);
+
   // Warning: can return nullptr for CPU tensors.
   EagerContext* Context() {
     mutex_lock ml(ctx_mutex_);
@@ -143,8 +158,6 @@ class TensorHandle : public core::RefCounted {
   Status WaitReady();
   Status WaitForNode(uint64 node_id, bool return_if_is_ready);
 
-  bool IsReady();
-
   // Id for the EagerNode that will compute the value pointed to by this handle.
   // If the value is 0, the handle is already ready, but not vice-versa.
   const uint64 node_id_;
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/executor.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <memory>
@@ -26,7 +27,9 @@ limitations under the License.
 #include "absl/strings/string_view.h"
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/executor_plan.h"
 #include "tensorflow/core/common_runtime/pending_counts.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -65,6 +68,7 @@ limitations under the License.
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/profile_utils/cpu_utils.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/trace_ring.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/internal/traceme_recorder.h"
@@ -128,6 +132,10 @@ void SetReferencedTensors(NodeExecStatsInterface* stats,
 
 }  // namespace nodestats
 
+// Maximum number of nodes executed synchronously by one Process() invocation
+// before the remaining ready nodes are yielded back to the threadpool.
+const int64 kInlineExecutionBudget = 32;
+
 class ExecutorImpl;
 class GraphView;
 
@@ -377,8 +385,16 @@ class ExecutorImpl : public Executor {
   // A cached value of params_
   bool device_record_tensor_accesses_ = false;
 
-  // Root nodes (with no in edges) that should form the initial ready queue
-  std::vector<const Node*> root_nodes_;
+  // Widest fan-in/fan-out of any node in the graph, computed in
+  // Initialize(). ExecutorState reserves its per-step input/output scratch
+  // to these sizes once, so the per-node resizes during Process() never
+  // reallocate.
+  int max_num_inputs_ = 0;
+  int max_num_outputs_ = 0;
+
+  // Immutable, flat-array summary of the graph topology (root node ids,
+  // per-node pending/fanout counts), built once in Initialize().
+  std::unique_ptr<const ExecutorPlan> plan_;
 
   // Mapping from frame name to static information about the frame.
   // TODO(yuanbyu): We could cache it along with the graph so to avoid
@@ -623,17 +639,15 @@ Status ExecutorImpl::Initialize() {
     const string& frame_name = cf_info.frame_names[id];
     FrameInfo* frame_info = EnsureFrameInfo(frame_name);
 
-    // See if this node is a root node, and if so, add to root_nodes_.
-    if (n->in_edges().empty()) {
-      root_nodes_.push_back(n);
-    }
-
     NodeItem* item = gview_.node(id);
     item->node = n;
 
     item->input_start = frame_info->total_inputs;
     frame_info->total_inputs += n->num_inputs();
 
+    max_num_inputs_ = std::max(max_num_inputs_, n->num_inputs());
+    max_num_outputs_ = std::max(max_num_outputs_, n->num_outputs());
+
     Status s = params_.create_kernel(n->def(), &item->kernel);
     if (!s.ok()) {
       item->kernel = nullptr;
@@ -681,6 +695,10 @@ Status ExecutorImpl::Initialize() {
   // all nodes.
   InitializePending(graph_.get(), cf_info);
 
+  // Freeze the topology into flat arrays so per-step setup does not walk the
+  // Graph again.
+  plan_ = ExecutorPlan::Create(graph_.get());
+
   return gview_.SetAllocAttrs(graph_.get(), params_.device);
 }
 
@@ -999,6 +1017,19 @@ class ExecutorState {
                                     dead_result);
     }
 
+    // Re-initializes this instance so a later iteration can reuse it:
+    // clears any leftover input entries and restores the pending counts
+    // to their initial values. Cheaper than a delete/new pair when a
+    // loop cycles through many iterations.
+    void Reset(const PendingCounts* pending_counts, int total_input_tensors) {
+      for (int i = 0; i < total_input_tensors; ++i) {
+        input_tensors[i] = Entry();
+      }
+      outstanding_ops = 0;
+      outstanding_frame_count = 0;
+      counts_.ResetFrom(*pending_counts);
+    }
+
     ~IterationState() { delete[] input_tensors; }
 
    private:
@@ -1074,6 +1105,17 @@ class ExecutorState {
     // The active iteration states of this frame.
     gtl::InlinedVector<IterationState*, 12> iterations;
 
+    // Iteration states retired by CleanupIterations, kept around for
+    // reuse by IncrementIteration. A long-running loop settles into a
+    // fixed ring of at most max_parallel_iterations states instead of
+    // allocating and freeing one per iteration.
+    gtl::InlinedVector<IterationState*, 12> free_iterations GUARDED_BY(mu);
+
+    // High watermark of num_outstanding_iterations, logged when the frame
+    // is destroyed so the iteration overlap actually achieved can be
+    // compared against the parallel_iterations setting.
+    int max_observed_outstanding_iterations GUARDED_BY(mu) = 1;
+
     // The NextIteration nodes to enter a new iteration. If the number of
     // outstanding iterations reaches the limit, we will defer the start of
     // the next iteration until the number of outstanding iterations falls
@@ -1123,6 +1165,32 @@ class ExecutorState {
       iterations[index] = state;
     }
 
+    // Returns a ready-to-use iteration state, reusing a retired one when
+    // available.
+    IterationState* AllocateIterationState() EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      if (!free_iterations.empty()) {
+        IterationState* state = free_iterations.back();
+        free_iterations.pop_back();
+        return state;
+      }
+      return new IterationState(pending_counts, total_input_tensors);
+    }
+
+    // Retires an iteration state, keeping up to max_parallel_iterations
+    // of them for reuse. Retired states are reset eagerly so any tensors
+    // left in their input entries are released now rather than when the
+    // state is reused.
+    void ReleaseIterationState(IterationState* state)
+        EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      if (free_iterations.size() <
+          static_cast<size_t>(max_parallel_iterations)) {
+        state->Reset(pending_counts, total_input_tensors);
+        free_iterations.push_back(state);
+      } else {
+        delete state;
+      }
+    }
+
     // Decrement the outstanding op count and clean up the iterations in the
     // frame. Return true iff the execution of the frame is done.
     inline bool DecrementOutstandingOps(const GraphView* gview, int64 iter,
@@ -1181,10 +1249,20 @@ class ExecutorState {
                            TaggedNodeSeq* ready) EXCLUSIVE_LOCKS_REQUIRED(mu);
 
     ~FrameState() {
+      if (iteration_count > 0) {
+        VLOG(1) << "Loop frame \"" << frame_name << "\" ran "
+                << (iteration_count + 1) << " iterations with peak overlap "
+                << max_observed_outstanding_iterations
+                << " (parallel_iterations=" << max_parallel_iterations << ")";
+      }
       for (size_t i = 0; i < iterations.size(); ++i) {
         delete iterations[i];
         iterations[i] = nullptr;
       }
+      for (IterationState* state : free_iterations) {
+        delete state;
+      }
+      free_iterations.clear();
     }
   };
 
@@ -1256,6 +1334,9 @@ class ExecutorState {
   TensorStore* tensor_store_;
   // Step-local container.
   ScopedStepContainer* step_container_;
+  // Per-step arena for temp allocations; acquired from the process-wide
+  // pool when the executor enables arena mode, retired in the destructor.
+  StepArenaAllocator* step_arena_ = nullptr;
   StepStatsCollectorInterface* const stats_collector_;
   const tracing::EventCollector* const event_collector_;
   Context context_;
@@ -1266,10 +1347,22 @@ class ExecutorState {
   CallFrameInterface* call_frame_;
   const ExecutorImpl* impl_;
   CancellationManager* cancellation_manager_;
+  // Non-null iff the caller supplied a cancellation manager: a per-executor
+  // child chained under cancellation_manager_, handed to kernels so that
+  // per-op callback registrations do not contend on the step-level
+  // manager's tables.
+  std::unique_ptr<CancellationManager> local_cancellation_manager_;
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
   const bool trace_using_annotations_;
 
+  // Kernel-context parameters that are constant across all nodes of the
+  // step, assembled once at construction time. Process() starts each node's
+  // Params from a copy of this prototype and writes only the per-node
+  // fields. The prototype never constructs an OpKernelContext, so its
+  // eigen_gpu_device stays null and the shallow copy is safe.
+  OpKernelContext::Params params_prototype_;
+
   // Owned.
 
   // A flag that is set on error after the frame state has been
@@ -1284,6 +1377,10 @@ class ExecutorState {
 
   std::atomic_int_fast32_t num_outstanding_ops_;
 
+  // Per-step record of node activations; one bit per node id, reset (not
+  // reallocated) at the start of each step.
+  ExecutorStepActivation activation_;
+
   // Available via OpKernelContext to every OpKernel invocation.
   mutex num_deferred_ops_mu_;
   int64 num_deferred_ops_ GUARDED_BY(num_deferred_ops_mu_) = 0;
@@ -1401,7 +1498,8 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
       trace_using_annotations_(impl->params_.device->TraceUsingAnnotations()),
-      num_outstanding_ops_(0) {
+      num_outstanding_ops_(0),
+      activation_(impl->graph_->num_node_ids()) {
   // We start the entire execution in iteration 0 of the root frame
   // so let us create the root frame and the state for iteration 0.
   // We assume root_frame_->frame_name.empty().
@@ -1415,6 +1513,65 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
       root_frame_->pending_counts, root_frame_->total_input_tensors);
 
   outstanding_frames_.insert({root_frame_->frame_name, root_frame_});
+
+  if (impl->params_.use_per_step_arena) {
+    step_arena_ = StepArenaPool::Global()->Acquire(
+        impl->params_.device->GetAllocator(AllocatorAttributes()));
+  }
+
+  if (cancellation_manager_ != nullptr) {
+    // Chain a per-executor manager under the caller's manager, so kernels
+    // register their cancellation callbacks here instead of contending on
+    // the (possibly step-wide) parent. Cancelling the parent cancels the
+    // child; error-abort paths still cancel through cancellation_manager_
+    // so that the whole step is torn down, not just this executor.
+    local_cancellation_manager_.reset(
+        new CancellationManager(cancellation_manager_));
+  }
+
+  // Assemble the step-constant kernel-context parameters once, rather than
+  // per Process() invocation.
+  Device* device = impl_->params_.device;
+  params_prototype_.step_id = step_id_;
+  params_prototype_.device = device;
+  params_prototype_.log_memory = log_memory_;
+  params_prototype_.record_tensor_accesses =
+      impl_->device_record_tensor_accesses_;
+  params_prototype_.rendezvous = rendezvous_;
+  params_prototype_.create_rendezvous = create_rendezvous_;
+  params_prototype_.collective_executor = collective_executor_;
+  params_prototype_.session_state = session_state_;
+  params_prototype_.session_handle = session_handle_;
+  params_prototype_.tensor_store = tensor_store_;
+  params_prototype_.cancellation_manager =
+      local_cancellation_manager_ != nullptr ? local_cancellation_manager_.get()
+                                             : cancellation_manager_;
+  params_prototype_.call_frame = call_frame_;
+  params_prototype_.function_library = impl_->params_.function_library;
+  params_prototype_.resource_manager = device->resource_manager();
+  params_prototype_.step_container = step_container_;
+  params_prototype_.step_arena_allocator = step_arena_;
+  params_prototype_.slice_reader_cache = slice_reader_cache_;
+  params_prototype_.runner = &runner_;
+  params_prototype_.stats_collector = stats_collector_;
+  params_prototype_.inc_num_deferred_ops_function = [this]() {
+    mutex_lock lock(num_deferred_ops_mu_);
+    num_deferred_ops_++;
+  };
+  params_prototype_.dec_num_deferred_ops_function = [this]() {
+    bool finish_when_deferred_ops_done = false;
+    {
+      mutex_lock lock(num_deferred_ops_mu_);
+      num_deferred_ops_--;
+      if (num_deferred_ops_ == 0) {
+        finish_when_deferred_ops_done = finish_when_deferred_ops_done_;
+      }
+    }
+    // Invoke Finish if the graph processing has completed. Finish is always
+    // called exactly once per ExecutorState, either here if there are any
+    // deferred ops, or in ScheduleFinish if there aren't any deferred ops.
+    if (finish_when_deferred_ops_done) Finish();
+  };
 }
 
 ExecutorState::~ExecutorState() {
@@ -1425,6 +1582,11 @@ ExecutorState::~ExecutorState() {
     it->Unref();
   }
   delete slice_reader_cache_;
+  if (step_arena_ != nullptr) {
+    // Retire after all frames (and so all pending input tensors) have been
+    // released; the arena recycles itself once fully drained.
+    step_arena_->Retire();
+  }
 }
 
 Status ExecutorImpl::BuildControlFlowInfo(const Graph* g,
@@ -1523,8 +1685,10 @@ void ExecutorState::RunAsync(Executor::DoneCallback done) {
     return;
   }
 
-  // Initialize the ready queue.
-  for (const Node* n : impl_->root_nodes_) {
+  // Initialize the ready queue from the precompiled plan.
+  activation_.Reset();
+  for (const int id : impl_->plan_->root_ids()) {
+    const Node* n = graph->FindNodeId(id);
     DCHECK_EQ(n->in_edges().size(), 0);
     ready.push_back(TaggedNode{n, root_frame_, 0, false});
   }
@@ -1617,60 +1781,52 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
   TaggedNodeSeq ready;
   TaggedNodeReadyQueue inline_ready;
 
-  // Parameters passed to OpKernel::Compute.
+  // Parameters passed to OpKernel::Compute. Reserved up front for the widest
+  // node in the graph, so the per-node resizes in PrepareInputs() never
+  // reallocate.
   TensorValueVec inputs;
   DeviceContextVec input_device_contexts;
   AllocatorAttributeVec input_alloc_attrs;
+  inputs.reserve(impl_->max_num_inputs_);
+  input_device_contexts.reserve(impl_->max_num_inputs_);
+  input_alloc_attrs.reserve(impl_->max_num_inputs_);
 
-  OpKernelContext::Params params;
-  params.step_id = step_id_;
+  // All step-constant fields were assembled into 'params_prototype_' when
+  // this state was created; only the fields that point at this invocation's
+  // scratch space need to be written here.
   Device* device = impl_->params_.device;
-  params.device = device;
-  params.log_memory = log_memory_;
-  params.record_tensor_accesses = impl_->device_record_tensor_accesses_;
-  params.rendezvous = rendezvous_;
-  params.create_rendezvous = create_rendezvous_;
-  params.collective_executor = collective_executor_;
-  params.session_state = session_state_;
-  params.session_handle = session_handle_;
-  params.tensor_store = tensor_store_;
-  params.cancellation_manager = cancellation_manager_;
-  params.call_frame = call_frame_;
-  params.function_library = impl_->params_.function_library;
-  params.resource_manager = device->resource_manager();
-  params.step_container = step_container_;
-  params.slice_reader_cache = slice_reader_cache_;
+  OpKernelContext::Params params = params_prototype_;
   params.inputs = &inputs;
   params.input_device_contexts = &input_device_contexts;
   params.input_alloc_attrs = &input_alloc_attrs;
-  params.runner = &runner_;
-  params.stats_collector = stats_collector_;
-  params.inc_num_deferred_ops_function = [this]() {
-    mutex_lock lock(num_deferred_ops_mu_);
-    num_deferred_ops_++;
-  };
-  params.dec_num_deferred_ops_function = [this]() {
-    bool finish_when_deferred_ops_done = false;
-    {
-      mutex_lock lock(num_deferred_ops_mu_);
-      num_deferred_ops_--;
-      if (num_deferred_ops_ == 0) {
-        finish_when_deferred_ops_done = finish_when_deferred_ops_done_;
-      }
-    }
-    // Invoke Finish if the graph processing has completed. Finish is always
-    // called exactly once per ExecutorState, either here if there are any
-    // deferred ops, or in ScheduleFinish if there aren't any deferred ops.
-    if (finish_when_deferred_ops_done) Finish();
-  };
 
   Status s;
   NodeExecStatsInterface* stats = nullptr;
 
   EntryVector outputs;
+  outputs.reserve(impl_->max_num_outputs_);
   bool completed = false;
   inline_ready.push_back(tagged_node);
+  // Budget of synchronous kernel executions for this Process() invocation.
+  // Long chains of inexpensive nodes (as classified by IsExpensive(), which
+  // folds in the measured cost estimate) run inline on the dispatching thread
+  // to avoid threadpool round trips, but once the budget is exhausted the
+  // remaining ready nodes are handed back to the pool so a single thread
+  // cannot monopolize a step.
+  int64 inline_budget = kInlineExecutionBudget;
   while (!inline_ready.empty()) {
+    if (inline_budget-- == 0) {
+      int64 yield_nsec = 0;
+      if (stats_collector_) {
+        yield_nsec = nodestats::NowInNsec();
+      }
+      while (!inline_ready.empty()) {
+        TaggedNode yielded_node = inline_ready.front();
+        inline_ready.pop_front();
+        runner_([=]() { Process(yielded_node, yield_nsec); });
+      }
+      break;
+    }
     tagged_node = inline_ready.front();
     inline_ready.pop_front();
     const Node* node = tagged_node.node;
@@ -1679,6 +1835,11 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
     const int id = node->id();
     const NodeItem& item = *gview.node(id);
 
+    // Record the activation in the step bitmap.  Only merge nodes and the
+    // control-flow ops that restart iterations may legally run more than
+    // once per (frame, iteration).
+    activation_.Activate(id);
+
     // TODO(misard) Replace with a finer-grain enabling flag once we
     // add better optional debugging support.
     if (vlog_ && VLOG_IS_ON(1)) {
@@ -1805,6 +1966,13 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
         OpKernelContext ctx(&params, item.num_outputs);
         nodestats::SetOpStart(stats);
 
+        // Tag the kernel's span in the always-on trace ring with the step id
+        // so it can be correlated across threads after the fact. Costs one
+        // relaxed atomic load when the ring is disabled.
+        tracing::ScopedRingActivity ring_activity(
+            tracing::EventCategory::kCompute, static_cast<uint64>(id),
+            static_cast<uint64>(step_id_));
+
         if (TF_PREDICT_FALSE(
                 MightTrace(item, event_collector_, trace_using_annotations_))) {
           const string& op_name = op_kernel->name();
@@ -2821,10 +2989,12 @@ void ExecutorState::FrameState::IncrementIteration(const GraphView* gview,
   const int64 next_iter = iteration_count;
 
   // Initialize the next iteration.
-  IterationState* iter_state =
-      new IterationState(pending_counts, total_input_tensors);
+  IterationState* iter_state = AllocateIterationState();
   SetIteration(next_iter, iter_state);
   num_outstanding_iterations++;
+  if (num_outstanding_iterations > max_observed_outstanding_iterations) {
+    max_observed_outstanding_iterations = num_outstanding_iterations;
+  }
   dead_exits.clear();
 
   // Activate the successors of the deferred roots in the new iteration.
@@ -2839,8 +3009,8 @@ bool ExecutorState::FrameState::CleanupIterations(const GraphView* gview,
                                                   TaggedNodeSeq* ready) {
   int64 curr_iter = iter;
   while (curr_iter <= iteration_count && IsIterationDone(curr_iter)) {
-    // Delete the iteration curr_iter.
-    delete GetIteration(curr_iter);
+    // Retire the iteration curr_iter for reuse by a later iteration.
+    ReleaseIterationState(GetIteration(curr_iter));
     SetIteration(curr_iter, nullptr);
     --num_outstanding_iterations;
     ++curr_iter;
@@ -2878,11 +3048,28 @@ Status CreateNonCachedKernel(Device* device, FunctionLibraryRuntime* flib,
                              OpKernel** kernel) {
   const auto device_type = DeviceType(device->attributes().device_type());
   auto allocator = device->GetAllocator(AllocatorAttributes());
+  const KernelDef* kernel_def = nullptr;
+  if (FindKernelDef(device_type, ndef, &kernel_def, nullptr).ok() &&
+      kernel_def->process_shared()) {
+    // Kernels that opt in to process-level sharing are cached by (device,
+    // node fingerprint), so sessions running the same model reuse a single
+    // instance. DeleteNonCachedKernel drops the registry reference.
+    return SharedKernelRegistry::Global()->FindOrCreate(
+        SharedKernelRegistry::KernelKey(ndef, device->name()), kernel,
+        [&](OpKernel** ret) {
+          return CreateOpKernel(device_type, device, allocator, flib, ndef,
+                                graph_def_version, ret);
+        });
+  }
   return CreateOpKernel(device_type, device, allocator, flib, ndef,
                         graph_def_version, kernel);
 }
 
-void DeleteNonCachedKernel(OpKernel* kernel) { delete kernel; }
+void DeleteNonCachedKernel(OpKernel* kernel) {
+  if (!SharedKernelRegistry::Global()->Release(kernel)) {
+    delete kernel;
+  }
+}
 
 namespace {
 
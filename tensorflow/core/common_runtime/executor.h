@@ -141,6 +141,11 @@ struct LocalExecutorParams {
   std::function<void(OpKernel*)> delete_kernel;
 
   Executor::RendezvousFactory rendezvous_factory;
+
+  // If true, each step acquires a recycled arena from which temp tensors
+  // are allocated, reset wholesale when the step's state is destroyed.
+  // Only meaningful for CPU devices.
+  bool use_per_step_arena = false;
 };
 ::tensorflow::Status NewLocalExecutor(const LocalExecutorParams& params,
                                       std::unique_ptr<const Graph> graph,
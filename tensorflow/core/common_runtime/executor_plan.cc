@@ -0,0 +1,70 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/executor_plan.h"
+
+#include <cstring>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+/* static */ std::unique_ptr<const ExecutorPlan> ExecutorPlan::Create(
+    const Graph* graph) {
+  std::unique_ptr<ExecutorPlan> plan(new ExecutorPlan);
+  const int num_nodes = graph->num_node_ids();
+  plan->num_nodes_ = num_nodes;
+  plan->initial_pending_.resize(num_nodes, 0);
+  plan->fanout_.resize(num_nodes, 0);
+  for (const Node* n : graph->nodes()) {
+    const int id = n->id();
+    plan->initial_pending_[id] = n->in_edges().size();
+    plan->fanout_[id] = n->out_edges().size();
+    if (n->in_edges().empty()) {
+      plan->root_ids_.push_back(id);
+    }
+  }
+  return std::move(plan);
+}
+
+ExecutorStepActivation::ExecutorStepActivation(int num_nodes)
+    : num_nodes_(num_nodes),
+      words_((num_nodes + kBitsPerWord - 1) / kBitsPerWord) {
+  Reset();
+}
+
+void ExecutorStepActivation::Reset() {
+  for (auto& word : words_) {
+    word.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool ExecutorStepActivation::Activate(int id) {
+  DCHECK_GE(id, 0);
+  DCHECK_LT(id, num_nodes_);
+  const uint64 bit = uint64{1} << (id % kBitsPerWord);
+  const uint64 prev =
+      words_[id / kBitsPerWord].fetch_or(bit, std::memory_order_relaxed);
+  return (prev & bit) == 0;
+}
+
+bool ExecutorStepActivation::IsActive(int id) const {
+  DCHECK_GE(id, 0);
+  DCHECK_LT(id, num_nodes_);
+  const uint64 bit = uint64{1} << (id % kBitsPerWord);
+  return (words_[id / kBitsPerWord].load(std::memory_order_relaxed) & bit) !=
+         0;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,92 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EXECUTOR_PLAN_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_EXECUTOR_PLAN_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/gtl/array_slice.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// ExecutorPlan is an immutable, cache-friendly summary of the executor's
+// graph topology, built exactly once when the executor is initialized.  All
+// per-node metadata is laid out in contiguous arrays indexed by node id so
+// that repeated Run calls touch a few flat arrays instead of re-deriving
+// activation state from the Graph on every step.
+class ExecutorPlan {
+ public:
+  // Builds a plan for "graph".  "graph" must outlive the returned plan.
+  static std::unique_ptr<const ExecutorPlan> Create(const Graph* graph);
+
+  int num_nodes() const { return num_nodes_; }
+
+  // Ids of nodes with no in-edges; these seed the initial ready queue of
+  // every step.
+  gtl::ArraySlice<int> root_ids() const { return root_ids_; }
+
+  // Number of in-edges (data + control) of node "id".  This is the initial
+  // pending count of every non-merge node.
+  int32 initial_pending(int id) const { return initial_pending_[id]; }
+
+  // Number of out-edges of node "id".
+  int32 fanout(int id) const { return fanout_[id]; }
+
+ private:
+  ExecutorPlan() = default;
+
+  int num_nodes_ = 0;
+  std::vector<int> root_ids_;
+  std::vector<int32> initial_pending_;
+  std::vector<int32> fanout_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ExecutorPlan);
+};
+
+// A compact per-step record of which nodes have been activated.  One bit per
+// node id; the backing storage is allocated once and reset with a memset at
+// the start of a step, so steps over small graphs do not allocate.  Marking
+// is thread-safe; distinct executor threads may activate different nodes
+// concurrently.
+class ExecutorStepActivation {
+ public:
+  explicit ExecutorStepActivation(int num_nodes);
+
+  // Clears all activation bits; cheap enough to call per step.
+  void Reset();
+
+  // Marks node "id" active.  Returns true if the node was not already
+  // active, i.e. the caller performed the first activation.
+  bool Activate(int id);
+
+  bool IsActive(int id) const;
+
+ private:
+  static constexpr int kBitsPerWord = 64;
+
+  const int num_nodes_;
+  std::vector<std::atomic<uint64>> words_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ExecutorStepActivation);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_EXECUTOR_PLAN_H_
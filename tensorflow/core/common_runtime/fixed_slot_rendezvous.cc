@@ -0,0 +1,236 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/fixed_slot_rendezvous.h"
+
+#include <unordered_set>
+#include <utility>
+
+#include "tensorflow/core/common_runtime/copy_tensor.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+/* static */ Status FixedSlotKeyTable::Create(
+    const std::vector<const Graph*>& partitions,
+    FixedSlotKeyTable** out_table) {
+  *out_table = nullptr;
+  // A slot is assigned only when both endpoints of a key are present, which
+  // excludes feed and fetch transfers terminated by the client.
+  std::unordered_set<string> send_keys;
+  std::unordered_set<string> recv_keys;
+  for (const Graph* graph : partitions) {
+    for (const Node* n : graph->nodes()) {
+      if (!n->IsSend() && !n->IsRecv()) continue;
+      string tensor_name, send_device, recv_device;
+      int64 send_device_incarnation;
+      TF_RETURN_IF_ERROR(
+          GetNodeAttr(n->attrs(), "tensor_name", &tensor_name));
+      TF_RETURN_IF_ERROR(
+          GetNodeAttr(n->attrs(), "send_device", &send_device));
+      TF_RETURN_IF_ERROR(
+          GetNodeAttr(n->attrs(), "recv_device", &recv_device));
+      TF_RETURN_IF_ERROR(GetNodeAttr(n->attrs(), "send_device_incarnation",
+                                     &send_device_incarnation));
+      const string key = Rendezvous::CreateKey(
+          send_device, static_cast<uint64>(send_device_incarnation),
+          recv_device, tensor_name, FrameAndIter(0, 0));
+      if (n->IsSend()) {
+        send_keys.insert(key);
+      } else {
+        recv_keys.insert(key);
+      }
+    }
+  }
+
+  FixedSlotKeyTable* table = new FixedSlotKeyTable;
+  for (const string& key : send_keys) {
+    if (recv_keys.count(key) > 0) {
+      table->keys_.push_back(key);
+    }
+  }
+  table->slots_.reserve(table->keys_.size());
+  for (int i = 0; i < static_cast<int>(table->keys_.size()); ++i) {
+    table->slots_[StringPiece(table->keys_[i])] = i;
+  }
+  *out_table = table;
+  return Status::OK();
+}
+
+FixedSlotRendezvous::FixedSlotRendezvous(const FixedSlotKeyTable* table,
+                                         Rendezvous* fallback,
+                                         const DeviceMgr* device_mgr)
+    : table_(table), fallback_(fallback), device_mgr_(device_mgr) {
+  table_->Ref();
+  fallback_->Ref();
+  const int n = table_->num_slots();
+  slots_.reset(new std::atomic<Item*>[n]);
+  for (int i = 0; i < n; ++i) {
+    slots_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+FixedSlotRendezvous::~FixedSlotRendezvous() {
+  // Any leftover items are unmatched sends (or waiters already aborted via
+  // StartAbort); mirror LocalRendezvous and simply drop them.
+  for (int i = 0; i < table_->num_slots(); ++i) {
+    delete slots_[i].load(std::memory_order_relaxed);
+  }
+  table_->Unref();
+  fallback_->Unref();
+}
+
+void FixedSlotRendezvous::DeliverLocally(const ParsedKey& parsed,
+                                         const Args& send_args,
+                                         const Args& recv_args,
+                                         const Tensor& val, bool is_dead,
+                                         DoneCallback done) {
+  // Dead tensors and host-to-host transfers are delivered by sharing the
+  // buffer; everything else goes through a device copy, as in
+  // IntraProcessRendezvous::SameWorkerRecvDone.
+  const bool src_host =
+      (send_args.alloc_attrs.on_host() || parsed.src.type == "CPU");
+  const bool dst_host =
+      (recv_args.alloc_attrs.on_host() || parsed.dst.type == "CPU");
+  if (is_dead || (src_host && dst_host)) {
+    done(Status::OK(), send_args, recv_args, val, is_dead);
+    return;
+  }
+
+  if (!DataTypeCanUseMemcpy(val.dtype()) && val.dtype() != DT_VARIANT) {
+    done(errors::InvalidArgument("Non-DMA-safe ", DataTypeString(val.dtype()),
+                                 " tensor may not be copied from/to a GPU."),
+         send_args, recv_args, val, is_dead);
+    return;
+  }
+
+  Device* src_device;
+  Status s = device_mgr_->LookupDevice(parsed.src_device, &src_device);
+  if (!s.ok()) {
+    done(s, send_args, recv_args, val, is_dead);
+    return;
+  }
+  Device* dst_device;
+  s = device_mgr_->LookupDevice(parsed.dst_device, &dst_device);
+  if (!s.ok()) {
+    done(s, send_args, recv_args, val, is_dead);
+    return;
+  }
+
+  AllocatorAttributes attr = recv_args.alloc_attrs;
+  attr.set_gpu_compatible(send_args.alloc_attrs.gpu_compatible() ||
+                          recv_args.alloc_attrs.gpu_compatible());
+  Allocator* out_allocator = dst_device->GetAllocator(attr);
+  Tensor* out = new Tensor;
+  if (val.dtype() != DT_VARIANT) {
+    // Variants are allocated by CopyTensor::ViaDMA.
+    *out = Tensor(out_allocator, val.dtype(), val.shape());
+  }
+  StatusCallback copy_done = [done = std::move(done), send_args, recv_args,
+                              out, is_dead](const Status& s) {
+    done(s, send_args, recv_args, *out, is_dead);
+    delete out;
+  };
+  CopyTensor::ViaDMA(parsed.edge_name, send_args.device_context,
+                     recv_args.device_context, src_device, dst_device,
+                     send_args.alloc_attrs, recv_args.alloc_attrs, &val, out,
+                     0 /*dev_to_dev_stream_index*/, std::move(copy_done));
+}
+
+Status FixedSlotRendezvous::Send(const ParsedKey& parsed,
+                                 const Args& send_args, const Tensor& val,
+                                 const bool is_dead) {
+  const int slot = table_->Lookup(parsed.FullKey());
+  if (slot < 0) {
+    return fallback_->Send(parsed, send_args, val, is_dead);
+  }
+  if (aborted_.load(std::memory_order_acquire)) {
+    return aborted_status();
+  }
+  Item* item = new Item;
+  item->value = val;
+  item->is_dead = is_dead;
+  item->args = send_args;
+  item->has_value = true;
+  Item* prev = slots_[slot].exchange(item, std::memory_order_acq_rel);
+  if (prev == nullptr) {
+    // The consumer has not arrived yet; it will find the buffered value.
+    return Status::OK();
+  }
+  // The consumer is already waiting.  We arrived second, so we own the
+  // handoff: clear the slot and complete the pending recv.
+  DCHECK(!prev->has_value) << "Duplicate send for fixed-slot key "
+                           << parsed.FullKey();
+  slots_[slot].store(nullptr, std::memory_order_relaxed);
+  DeliverLocally(parsed, send_args, prev->args, val, is_dead,
+                 std::move(prev->waiter));
+  delete prev;
+  delete item;
+  return Status::OK();
+}
+
+void FixedSlotRendezvous::RecvAsync(const ParsedKey& parsed,
+                                    const Args& recv_args, DoneCallback done) {
+  const int slot = table_->Lookup(parsed.FullKey());
+  if (slot < 0) {
+    fallback_->RecvAsync(parsed, recv_args, std::move(done));
+    return;
+  }
+  if (aborted_.load(std::memory_order_acquire)) {
+    done(aborted_status(), Args(), recv_args, Tensor(), false);
+    return;
+  }
+  Item* item = new Item;
+  item->args = recv_args;
+  item->waiter = std::move(done);
+  Item* prev = slots_[slot].exchange(item, std::memory_order_acq_rel);
+  if (prev == nullptr) {
+    // The producer has not arrived yet; Send() will complete the handoff.
+    return;
+  }
+  DCHECK(prev->has_value) << "Duplicate recv for fixed-slot key "
+                          << parsed.FullKey();
+  slots_[slot].store(nullptr, std::memory_order_relaxed);
+  DeliverLocally(parsed, prev->args, recv_args, prev->value, prev->is_dead,
+                 std::move(item->waiter));
+  delete prev;
+  delete item;
+}
+
+void FixedSlotRendezvous::StartAbort(const Status& status) {
+  CHECK(!status.ok());
+  {
+    mutex_lock l(mu_);
+    if (status_.ok()) status_ = status;
+  }
+  aborted_.store(true, std::memory_order_release);
+  for (int i = 0; i < table_->num_slots(); ++i) {
+    Item* item = slots_[i].exchange(nullptr, std::memory_order_acq_rel);
+    if (item != nullptr) {
+      if (!item->has_value) {
+        item->waiter(status, Args(), item->args, Tensor(), false);
+      }
+      delete item;
+    }
+  }
+  fallback_->StartAbort(status);
+}
+
+}  // namespace tensorflow
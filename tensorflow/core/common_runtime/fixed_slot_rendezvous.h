@@ -0,0 +1,129 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_FIXED_SLOT_RENDEZVOUS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_FIXED_SLOT_RENDEZVOUS_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class DeviceMgr;
+class Graph;
+
+// Immutable mapping from statically-known rendezvous keys to dense slot
+// indices.  Built once at graph-partition time from the Send/Recv pairs that
+// are fully contained in the partitioned graphs (i.e. both the _Send and the
+// matching _Recv node exist), and shared read-only by every step's
+// FixedSlotRendezvous.  Feed and fetch keys, whose producer or consumer lives
+// outside the graph, are deliberately excluded.
+class FixedSlotKeyTable : public core::RefCounted {
+ public:
+  // Builds a table from the device-partitioned graphs of a session.  Only
+  // keys in the root frame (FrameAndIter(0, 0)) are assigned slots; Send/Recv
+  // inside loop frames use dynamic iteration ids and fall back to the
+  // standard rendezvous.
+  static Status Create(const std::vector<const Graph*>& partitions,
+                       FixedSlotKeyTable** out_table);
+
+  int num_slots() const { return static_cast<int>(keys_.size()); }
+
+  // Returns the slot index for "full_key", or -1 if the key has no
+  // pre-assigned slot.  Lock-free; the table is immutable after Create().
+  int Lookup(StringPiece full_key) const {
+    auto iter = slots_.find(full_key);
+    return iter == slots_.end() ? -1 : iter->second;
+  }
+
+ private:
+  FixedSlotKeyTable() = default;
+
+  std::vector<string> keys_;             // Slot index -> full key.
+  gtl::FlatMap<StringPiece, int> slots_;  // Views into keys_.
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FixedSlotKeyTable);
+};
+
+// A per-step rendezvous that hands off tensors for statically-known Send/Recv
+// pairs through pre-assigned slots: one atomic exchange per side, no string
+// hashing and no lock on the hot path.  Keys without a slot are forwarded to
+// a fallback rendezvous (typically IntraProcessRendezvous).
+//
+// Enabled via
+// ConfigProto.experimental.use_fixed_slot_rendezvous.
+class FixedSlotRendezvous : public Rendezvous {
+ public:
+  // Takes a reference on "table" and "fallback"; "device_mgr" must outlive
+  // this object and is used for cross-device copies on the receive path.
+  FixedSlotRendezvous(const FixedSlotKeyTable* table, Rendezvous* fallback,
+                      const DeviceMgr* device_mgr);
+
+  Status Send(const ParsedKey& parsed, const Args& send_args,
+              const Tensor& val, const bool is_dead) override;
+
+  void RecvAsync(const ParsedKey& parsed, const Args& recv_args,
+                 DoneCallback done) override;
+
+  void StartAbort(const Status& status) override;
+
+ private:
+  // One side of a pending slot handoff: either a buffered value (from Send)
+  // or a waiting consumer (from Recv).
+  struct Item {
+    Tensor value;
+    bool is_dead = false;
+    Args args;
+    DoneCallback waiter;
+    bool has_value = false;
+  };
+
+  ~FixedSlotRendezvous() override;
+
+  // Completes a matched slot: copies between devices if needed, then invokes
+  // the consumer callback.
+  void DeliverLocally(const ParsedKey& parsed, const Args& send_args,
+                      const Args& recv_args, const Tensor& val, bool is_dead,
+                      DoneCallback done);
+
+  Status aborted_status() const {
+    mutex_lock l(mu_);
+    return status_;
+  }
+
+  const FixedSlotKeyTable* table_;
+  Rendezvous* fallback_;
+  const DeviceMgr* device_mgr_;
+  std::unique_ptr<std::atomic<Item*>[]> slots_;
+
+  std::atomic<bool> aborted_{false};
+  mutable mutex mu_;
+  Status status_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FixedSlotRendezvous);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_FIXED_SLOT_RENDEZVOUS_H_
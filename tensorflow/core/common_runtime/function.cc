@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op.h"
@@ -41,6 +42,7 @@ limitations under the License.
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/graph/optimizer_cse.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
@@ -318,6 +320,169 @@ Status FunctionLibraryRuntimeOverlay::Clone(
   return base_flr_->Clone(out_lib_def, out_pflr, out_flr, skip_flib_def);
 }
 
+// Executes a small function body as a flat sequence of synchronous kernel
+// invocations on the caller thread, with intermediates carried in a dense
+// per-call slot vector. This avoids the executor, rendezvous, and frame
+// machinery whose per-call setup cost dominates for the tiny stateless
+// bodies (dataset map functions, small defuns) that make up most calls.
+class InlineCallPlan {
+ public:
+  // Function bodies with more op nodes than this run on the executor.
+  static constexpr int kMaxNodes = 16;
+
+  // Builds a plan for 'g', or returns nullptr if the graph does not
+  // qualify: too many nodes, control flow, sends/recvs, ref-typed edges,
+  // stateful ops (other than _Arg/_Retval, which only touch the call
+  // frame), or kernels that are asynchronous.
+  static std::unique_ptr<InlineCallPlan> Create(
+      const Graph& g, Device* device, FunctionLibraryRuntime* flr,
+      const std::function<Status(const NodeDef&, OpKernel**)>& create_kernel,
+      const std::function<void(OpKernel*)>& delete_kernel);
+
+  ~InlineCallPlan() {
+    for (const Step& step : steps_) {
+      delete_kernel_(step.kernel);
+    }
+  }
+
+  // Runs the call sequence synchronously on the caller thread. Arguments
+  // are read from and return values written to 'frame'.
+  Status Run(const FunctionLibraryRuntime::Options& opts,
+             CallFrameInterface* frame) const;
+
+ private:
+  struct Step {
+    OpKernel* kernel = nullptr;
+    // Slot index holding each of the kernel's inputs.
+    gtl::InlinedVector<int, 4> input_slots;
+    // Slot index of the kernel's first output; outputs are contiguous.
+    int first_output_slot = 0;
+  };
+
+  InlineCallPlan(Device* device, FunctionLibraryRuntime* flr,
+                 std::function<void(OpKernel*)> delete_kernel)
+      : device_(device), flr_(flr), delete_kernel_(std::move(delete_kernel)) {}
+
+  Device* const device_;
+  FunctionLibraryRuntime* const flr_;
+  const std::function<void(OpKernel*)> delete_kernel_;
+  std::vector<Step> steps_;  // In topological order.
+  int num_slots_ = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(InlineCallPlan);
+};
+
+std::unique_ptr<InlineCallPlan> InlineCallPlan::Create(
+    const Graph& g, Device* device, FunctionLibraryRuntime* flr,
+    const std::function<Status(const NodeDef&, OpKernel**)>& create_kernel,
+    const std::function<void(OpKernel*)>& delete_kernel) {
+  int num_nodes = 0;
+  for (const Node* n : g.op_nodes()) {
+    if (++num_nodes > kMaxNodes) return nullptr;
+    if (n->IsControlFlow() || n->IsSend() || n->IsRecv()) return nullptr;
+    const bool arg_or_ret =
+        n->type_string() == kArgOp || n->type_string() == kRetOp;
+    if (n->op_def().is_stateful() && !arg_or_ret) return nullptr;
+    for (DataType dt : n->output_types()) {
+      if (IsRefType(dt)) return nullptr;
+    }
+  }
+
+  std::vector<Node*> order;
+  GetReversePostOrder(g, &order, NodeComparatorID());
+
+  std::unique_ptr<InlineCallPlan> plan(
+      new InlineCallPlan(device, flr, delete_kernel));
+  std::unordered_map<const Node*, int> first_slot;
+  for (Node* n : order) {
+    if (!n->IsOp()) continue;
+    Step step;
+    Status s = create_kernel(n->def(), &step.kernel);
+    if (!s.ok()) {
+      VLOG(2) << "Not inlining " << n->name() << ": " << s;
+      return nullptr;
+    }
+    if (step.kernel->AsAsync() != nullptr) {
+      delete_kernel(step.kernel);
+      return nullptr;
+    }
+    step.first_output_slot = plan->num_slots_;
+    first_slot[n] = plan->num_slots_;
+    plan->num_slots_ += n->num_outputs();
+    step.input_slots.resize(n->num_inputs());
+    for (const Edge* e : n->in_edges()) {
+      if (e->IsControlEdge()) continue;
+      step.input_slots[e->dst_input()] =
+          first_slot[e->src()] + e->src_output();
+    }
+    // The plan now owns step.kernel; it is deleted by ~InlineCallPlan even
+    // if a later node disqualifies the graph.
+    plan->steps_.push_back(std::move(step));
+  }
+  return plan;
+}
+
+Status InlineCallPlan::Run(const FunctionLibraryRuntime::Options& opts,
+                           CallFrameInterface* frame) const {
+  std::vector<Tensor> slots(num_slots_);
+
+  OpKernelContext::Params params;
+  params.step_id = opts.step_id;
+  params.device = device_;
+  params.call_frame = frame;
+  params.function_library = flr_;
+  params.rendezvous = opts.rendezvous;
+  params.cancellation_manager = opts.cancellation_manager;
+  params.collective_executor = opts.collective_executor;
+  params.step_container = opts.step_container;
+  params.resource_manager = device_->resource_manager();
+  params.runner = opts.runner;
+  params.log_memory = LogMemory::IsEnabled();
+
+  gtl::InlinedVector<TensorValue, 4> inputs;
+  gtl::InlinedVector<DeviceContext*, 4> input_device_contexts;
+  gtl::InlinedVector<AllocatorAttributes, 4> input_alloc_attrs;
+  params.inputs = &inputs;
+  params.input_device_contexts = &input_device_contexts;
+  params.input_alloc_attrs = &input_alloc_attrs;
+
+  for (const Step& step : steps_) {
+    if (opts.cancellation_manager &&
+        opts.cancellation_manager->IsCancelled()) {
+      return errors::Cancelled("");
+    }
+    const int num_inputs = step.input_slots.size();
+    const int num_outputs = step.kernel->num_outputs();
+    inputs.clear();
+    inputs.resize(num_inputs);
+    input_device_contexts.clear();
+    input_device_contexts.resize(num_inputs, nullptr);
+    input_alloc_attrs.clear();
+    input_alloc_attrs.resize(num_inputs);
+    for (int i = 0; i < num_inputs; ++i) {
+      inputs[i] = TensorValue(&slots[step.input_slots[i]]);
+    }
+    gtl::InlinedVector<AllocatorAttributes, 4> output_attrs(num_outputs);
+    params.op_kernel = step.kernel;
+    params.output_attr_array = output_attrs.data();
+
+    OpKernelContext ctx(&params, num_outputs);
+    device_->Compute(step.kernel, &ctx);
+    TF_RETURN_IF_ERROR(ctx.status());
+
+    for (int i = 0; i < num_outputs; ++i) {
+      TensorValue val = ctx.release_output(i);
+      if (val.tensor == nullptr) {
+        return errors::Internal("Missing output ", i, " from node ",
+                                step.kernel->name());
+      }
+      slots[step.first_output_slot + i] = std::move(*val.tensor);
+      delete val.tensor;
+    }
+  }
+  return Status::OK();
+}
+
 class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
  public:
   FunctionLibraryRuntimeImpl(const DeviceMgr* dmgr, Env* env, Device* device,
@@ -403,6 +568,9 @@ class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
     FunctionLibraryRuntimeOverlay* overlay_flr = nullptr;
     string executor_type;
     Executor::RendezvousFactory rendezvous_factory = nullptr;
+    // Non-null iff the function body qualifies for executor-free
+    // invocation on the caller thread (see InlineCallPlan).
+    std::unique_ptr<InlineCallPlan> inline_plan;
 
     ~Item() {
       delete this->func_graph;
@@ -940,11 +1108,24 @@ Status FunctionLibraryRuntimeImpl::CreateItem(Item** item) {
   Graph* graph = g.get();
   std::unique_ptr<Executor> exec;
   TF_RETURN_IF_ERROR(NewExecutor(executor_type, params, std::move(g), &exec));
+
+  // Small stateless CPU function bodies additionally get a flat call plan
+  // so that Run() can execute them directly on the caller thread; the
+  // executor remains the fallback (and serves remote execution).
+  std::unique_ptr<InlineCallPlan> inline_plan;
+  if (device_ != nullptr && executor_type.empty() &&
+      device_->attributes().device_type() == DEVICE_CPU) {
+    inline_plan = InlineCallPlan::Create(*graph, device_, flr,
+                                         params.create_kernel,
+                                         params.delete_kernel);
+  }
+
   {
     // Guard item since it is already inserted in items_.
     mutex_lock l(mu_);
     if ((*item)->exec == nullptr) {
       (*item)->graph = graph;
+      (*item)->inline_plan = std::move(inline_plan);
       (*item)->exec = exec.release();
     }
   }
@@ -1050,6 +1231,11 @@ void FunctionLibraryRuntimeImpl::RunRemote(const Options& opts, Handle handle,
         Status s = status;
         if (s.ok()) {
           s = frame->SetArgs(*remote_args);
+          // The frame now holds the only references needed: dropping the
+          // rendezvous copies and letting _Arg kernels consume the frame's
+          // references gives function-body ops forwardable buffers.
+          remote_args->clear();
+          frame->MarkArgsConsumable(true);
         }
         if (!s.ok()) {
           delete frame;
@@ -1131,6 +1317,23 @@ void FunctionLibraryRuntimeImpl::Run(const Options& opts, Handle handle,
   }
 
   const FunctionBody* fbody = GetFunctionBody(handle);
+
+  if (item->inline_plan != nullptr && run_opts.stats_collector == nullptr) {
+    FunctionCallFrame inline_frame(fbody->arg_types, fbody->ret_types);
+    s = inline_frame.SetArgs(args);
+    // Each argument feeds exactly one _Arg kernel and the frame dies with
+    // this call, so its references may be handed to the function body.
+    inline_frame.MarkArgsConsumable(true);
+    if (s.ok()) {
+      s = item->inline_plan->Run(run_opts, &inline_frame);
+    }
+    if (s.ok()) {
+      s = inline_frame.ConsumeRetvals(rets, run_opts.allow_dead_tensors);
+    }
+    done(s);
+    return;
+  }
+
   FunctionCallFrame* frame =
       new FunctionCallFrame(fbody->arg_types, fbody->ret_types);
   s = frame->SetArgs(args);
@@ -1139,6 +1342,9 @@ void FunctionLibraryRuntimeImpl::Run(const Options& opts, Handle handle,
     done(s);
     return;
   }
+  // As above: the frame is used for a single call, so _Arg kernels may
+  // take over its argument references instead of copying them.
+  frame->MarkArgsConsumable(true);
 
   Executor::Args exec_args;
   ExecutorArgsFromOptions(run_opts, frame, &exec_args);
@@ -1207,6 +1413,11 @@ void FunctionLibraryRuntimeImpl::Run(const Options& opts, Handle handle,
   }
   DCHECK(run_opts.runner != nullptr);
 
+  if (item->inline_plan != nullptr && run_opts.stats_collector == nullptr) {
+    done(item->inline_plan->Run(run_opts, frame));
+    return;
+  }
+
   Executor::Args exec_args;
   ExecutorArgsFromOptions(run_opts, frame, &exec_args);
   item->exec->RunAsync(exec_args, std::move(done));
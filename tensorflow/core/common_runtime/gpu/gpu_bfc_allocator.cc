@@ -17,6 +17,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 
@@ -53,6 +54,68 @@ bool GPUBFCAllocator::GetAllowGrowthValue(const GPUOptions& gpu_options) {
   return gpu_options.allow_growth();
 }
 
+bool GPUBFCAllocator::GetGarbageCollectionValue() {
+  const char* enable_gpu_garbage_collection =
+      std::getenv("TF_ENABLE_GPU_GARBAGE_COLLECTION");
+  if (enable_gpu_garbage_collection == nullptr) {
+    // By default garbage collection is disabled.
+    return false;
+  }
+  if (strcmp("false", enable_gpu_garbage_collection) == 0) {
+    return false;
+  } else if (strcmp("true", enable_gpu_garbage_collection) == 0) {
+    return true;
+  }
+
+  LOG(ERROR)
+      << "The TF_ENABLE_GPU_GARBAGE_COLLECTION environment variable is set but"
+      << " could not be parsed: \"" << enable_gpu_garbage_collection << "\"."
+      << " Valid values are \"true\" or \"false\"."
+      << " Garbage collection is disabled.";
+  return false;
+}
+
+bool GPUBFCAllocator::GetAsyncReservationValue() {
+  const char* async_reservation_string =
+      std::getenv("TF_GPU_ASYNC_REGION_RESERVATION");
+  if (async_reservation_string == nullptr) {
+    // By default the region is reserved on the thread that first
+    // allocates.
+    return false;
+  }
+  if (strcmp("false", async_reservation_string) == 0) {
+    return false;
+  } else if (strcmp("true", async_reservation_string) == 0) {
+    return true;
+  }
+
+  LOG(ERROR)
+      << "The TF_GPU_ASYNC_REGION_RESERVATION environment variable is set but"
+      << " could not be parsed: \"" << async_reservation_string << "\"."
+      << " Valid values are \"true\" or \"false\"."
+      << " Asynchronous region reservation is disabled.";
+  return false;
+}
+
+bool GPUBFCAllocator::GetUnifiedMemorySpilloverValue() {
+  const char* uvm_spillover_string = std::getenv("TF_GPU_BFC_UVM_SPILLOVER");
+  if (uvm_spillover_string == nullptr) {
+    // By default allocations that exhaust the arena fail.
+    return false;
+  }
+  if (strcmp("false", uvm_spillover_string) == 0) {
+    return false;
+  } else if (strcmp("true", uvm_spillover_string) == 0) {
+    return true;
+  }
+
+  LOG(ERROR)
+      << "The TF_GPU_BFC_UVM_SPILLOVER environment variable is set but could"
+      << " not be parsed: \"" << uvm_spillover_string << "\". Valid values are"
+      << " \"true\" or \"false\". Unified-memory spillover is disabled.";
+  return false;
+}
+
 GPUBFCAllocator::GPUBFCAllocator(GPUMemAllocator* sub_allocator,
                                  size_t total_memory, const string& name)
     : GPUBFCAllocator(sub_allocator, total_memory, GPUOptions(), name) {}
@@ -62,6 +125,112 @@ GPUBFCAllocator::GPUBFCAllocator(GPUMemAllocator* sub_allocator,
                                  const GPUOptions& gpu_options,
                                  const string& name)
     : BFCAllocator(sub_allocator, total_memory,
-                   GPUBFCAllocator::GetAllowGrowthValue(gpu_options), name) {}
+                   GPUBFCAllocator::GetAllowGrowthValue(gpu_options), name,
+                   GPUBFCAllocator::GetGarbageCollectionValue()),
+      stream_exec_(sub_allocator->stream_executor()),
+      uvm_spillover_enabled_(
+          GPUBFCAllocator::GetUnifiedMemorySpilloverValue()) {
+  if (!GPUBFCAllocator::GetAllowGrowthValue(gpu_options) &&
+      GPUBFCAllocator::GetAsyncReservationValue()) {
+    // Without allow_growth the first allocation reserves the whole
+    // region, which can take seconds per device.  Touch the allocator
+    // once from a background thread so those reservations overlap when
+    // several devices are created; the arena's own lock serializes the
+    // warm-up with any real allocation that arrives first.
+    reservation_thread_.reset(Env::Default()->StartThread(
+        ThreadOptions(), strings::StrCat(name, "_reserve"), [this]() {
+          void* ptr = this->BFCAllocator::AllocateRaw(kAllocatorAlignment, 1);
+          if (ptr != nullptr) {
+            this->BFCAllocator::DeallocateRaw(ptr);
+          }
+        }));
+  }
+}
+
+void* GPUBFCAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  void* ptr = BFCAllocator::AllocateRaw(alignment, num_bytes);
+  if (ptr != nullptr || !uvm_spillover_enabled_) {
+    return ptr;
+  }
+  return SpilloverAllocate(num_bytes);
+}
+
+void* GPUBFCAllocator::AllocateRaw(
+    size_t alignment, size_t num_bytes,
+    const AllocationAttributes& allocation_attr) {
+  void* ptr = BFCAllocator::AllocateRaw(alignment, num_bytes, allocation_attr);
+  if (ptr != nullptr || !uvm_spillover_enabled_) {
+    return ptr;
+  }
+  return SpilloverAllocate(num_bytes);
+}
+
+void* GPUBFCAllocator::SpilloverAllocate(size_t num_bytes) {
+  void* ptr = stream_exec_->UnifiedMemoryAllocate(num_bytes);
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+  mutex_lock l(spill_mu_);
+  spilled_[ptr] = SpilledAlloc{num_bytes, next_spill_id_--};
+  spilled_bytes_ += num_bytes;
+  if (spilled_.size() == 1) {
+    LOG(WARNING) << Name() << " ran out of device memory; serving " << num_bytes
+                 << " bytes from CUDA unified memory. Kernels touching spilled"
+                 << " tensors may run at reduced speed while the driver"
+                 << " migrates pages on demand.";
+  } else {
+    VLOG(1) << Name() << " spilled " << num_bytes
+            << " bytes to unified memory (total spilled: " << spilled_bytes_
+            << " bytes in " << spilled_.size() << " allocations)";
+  }
+  return ptr;
+}
+
+void GPUBFCAllocator::DeallocateRaw(void* ptr) {
+  if (uvm_spillover_enabled_ && ptr != nullptr) {
+    mutex_lock l(spill_mu_);
+    auto it = spilled_.find(ptr);
+    if (it != spilled_.end()) {
+      spilled_bytes_ -= it->second.num_bytes;
+      spilled_.erase(it);
+      stream_exec_->UnifiedMemoryDeallocate(ptr);
+      return;
+    }
+  }
+  BFCAllocator::DeallocateRaw(ptr);
+}
+
+size_t GPUBFCAllocator::RequestedSize(const void* ptr) const {
+  if (uvm_spillover_enabled_) {
+    mutex_lock l(spill_mu_);
+    auto it = spilled_.find(ptr);
+    if (it != spilled_.end()) {
+      return it->second.num_bytes;
+    }
+  }
+  return BFCAllocator::RequestedSize(ptr);
+}
+
+size_t GPUBFCAllocator::AllocatedSize(const void* ptr) const {
+  if (uvm_spillover_enabled_) {
+    mutex_lock l(spill_mu_);
+    auto it = spilled_.find(ptr);
+    if (it != spilled_.end()) {
+      return it->second.num_bytes;
+    }
+  }
+  return BFCAllocator::AllocatedSize(ptr);
+}
+
+int64 GPUBFCAllocator::AllocationId(const void* ptr) const {
+  if (uvm_spillover_enabled_) {
+    mutex_lock l(spill_mu_);
+    auto it = spilled_.find(ptr);
+    if (it != spilled_.end()) {
+      return it->second.allocation_id;
+    }
+  }
+  return BFCAllocator::AllocationId(ptr);
+}
 
 }  // namespace tensorflow
@@ -23,6 +23,8 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_mem_allocator.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -39,10 +41,62 @@ class GPUBFCAllocator : public BFCAllocator {
                   const GPUOptions& gpu_options, const string& name);
   ~GPUBFCAllocator() override {}
 
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override;
+  void DeallocateRaw(void* ptr) override;
+
+  size_t RequestedSize(const void* ptr) const override;
+  size_t AllocatedSize(const void* ptr) const override;
+  int64 AllocationId(const void* ptr) const override;
+
   TF_DISALLOW_COPY_AND_ASSIGN(GPUBFCAllocator);
 
  private:
+  // Satisfies an allocation the BFC arena could not, from CUDA unified
+  // memory.  Returns nullptr if that also fails.
+  void* SpilloverAllocate(size_t num_bytes);
+
   static bool GetAllowGrowthValue(const GPUOptions& gpu_options);
+  // Whether fully-free regions may be released back to the GPU driver when
+  // an allocation would otherwise fail; controlled by the
+  // TF_ENABLE_GPU_GARBAGE_COLLECTION environment variable and disabled by
+  // default.  Only regions in which every chunk is free and past any
+  // timestamp requirement are released, so no stream can still be reading
+  // from or writing to the region.
+  static bool GetGarbageCollectionValue();
+  // Whether the eager whole-region reservation performed when
+  // allow_growth is disabled should run on a background thread, so
+  // that creating many GPU devices does not serialize on one large
+  // driver allocation per device; controlled by the
+  // TF_GPU_ASYNC_REGION_RESERVATION environment variable and disabled
+  // by default.
+  static bool GetAsyncReservationValue();
+  // Whether allocations the arena cannot satisfy should be served from
+  // CUDA unified memory instead of failing; controlled by the
+  // TF_GPU_BFC_UVM_SPILLOVER environment variable and disabled by
+  // default.  Spilled pages migrate on demand under the driver's
+  // paging policy, so oversized steps run slowly rather than OOM.
+  static bool GetUnifiedMemorySpilloverValue();
+
+  se::StreamExecutor* stream_exec_;  // not owned, non-null
+  const bool uvm_spillover_enabled_;
+
+  mutable mutex spill_mu_;
+  struct SpilledAlloc {
+    size_t num_bytes;
+    int64 allocation_id;
+  };
+  // Unified-memory allocations currently live, keyed by base pointer.
+  std::unordered_map<const void*, SpilledAlloc> spilled_
+      GUARDED_BY(spill_mu_);
+  int64 spilled_bytes_ GUARDED_BY(spill_mu_) = 0;
+  // Spilled allocations get negative ids so they never collide with
+  // the arena's.
+  int64 next_spill_id_ GUARDED_BY(spill_mu_) = -1;
+
+  // Joined on destruction.
+  std::unique_ptr<Thread> reservation_thread_;
 };
 
 }  // namespace tensorflow
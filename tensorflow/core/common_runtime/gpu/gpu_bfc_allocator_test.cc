@@ -232,6 +232,35 @@ TEST(GPUBFCAllocatorTest, TestCustomMemoryLimit) {
   a.DeallocateRaw(first_ptr);
 }
 
+TEST(GPUBFCAllocatorTest, UnifiedMemorySpillover) {
+  setenv("TF_GPU_BFC_UVM_SPILLOVER", "true", 1);
+  PlatformGpuId platform_gpu_id(0);
+  GPUMemAllocator* sub_allocator = new GPUMemAllocator(
+      GpuIdUtil::ExecutorForPlatformGpuId(platform_gpu_id).ValueOrDie(),
+      platform_gpu_id, false /*use_unified_memory*/, {}, {});
+  // Configure a 1MiB byte limit
+  GPUBFCAllocator a(sub_allocator, 1 << 20, "GPU_0_bfc");
+  unsetenv("TF_GPU_BFC_UVM_SPILLOVER");
+
+  // Larger than the arena: served from unified memory instead of
+  // failing.  Skip the retry wait so the test stays fast.
+  AllocationAttributes attr;
+  attr.no_retry_on_failure = true;
+  void* spilled = a.AllocateRaw(1, 1 << 22, attr);
+  ASSERT_NE(nullptr, spilled);
+  EXPECT_EQ(1 << 22, a.RequestedSize(spilled));
+  EXPECT_EQ(1 << 22, a.AllocatedSize(spilled));
+  EXPECT_GT(0, a.AllocationId(spilled));
+
+  // In-arena allocations are unaffected.
+  void* in_arena = a.AllocateRaw(1, 256);
+  EXPECT_NE(nullptr, in_arena);
+  EXPECT_GT(a.AllocationId(in_arena), 0);
+
+  a.DeallocateRaw(spilled);
+  a.DeallocateRaw(in_arena);
+}
+
 TEST(GPUBFCAllocatorTest, AllocationsAndDeallocationsWithGrowth) {
   GPUOptions options;
   options.set_allow_growth(true);
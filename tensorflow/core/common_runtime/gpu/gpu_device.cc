@@ -375,6 +375,11 @@ Status BaseGPUDevice::Init(const SessionOptions& options) {
         i, streams_.back()->compute, streams_.back()->host_to_device,
         streams_.back()->device_to_host, streams_.back()->device_to_device));
   }
+  if (max_streams_ > 1) {
+    LOG(INFO) << "Using " << max_streams_ << " streams for device " << name()
+              << "; independent subgraphs will be assigned to separate "
+                 "compute streams.";
+  }
 
   em_ = EventMgrFactory::Singleton()->GetEventMgr(executor_,
                                                   options.config.gpu_options());
@@ -556,7 +561,10 @@ void BaseGPUDevice::ComputeHelper(OpKernel* op_kernel,
   const auto num_streams = streams_.size();
   if (num_streams > 1) {
     // If this op's device context is different from the other contexts,
-    // we must wait on the stream.
+    // we must wait on the stream.  Wait once per distinct producing stream
+    // rather than once per input; each wait enqueues a device-side event
+    // wait on the compute stream.
+    gtl::InlinedVector<se::Stream*, 4> waited_streams;
     for (int i = 0; i < context->num_inputs(); ++i) {
       const GPUDeviceContext* idc =
           static_cast<GPUDeviceContext*>(context->input_device_context(i));
@@ -582,7 +590,13 @@ void BaseGPUDevice::ComputeHelper(OpKernel* op_kernel,
                     << ((idc->stream() == stream) ? " not needed" : "");
         }
       }
-      if (idc->stream() != stream) stream->ThenWaitFor(idc->stream());
+      se::Stream* input_stream = idc->stream();
+      if (input_stream != stream &&
+          std::find(waited_streams.begin(), waited_streams.end(),
+                    input_stream) == waited_streams.end()) {
+        stream->ThenWaitFor(input_stream);
+        waited_streams.push_back(input_stream);
+      }
     }
   }
   if (kernel_tracker_.get()) {
@@ -1600,6 +1614,10 @@ Status BaseGPUDeviceFactory::EnablePeerAccess(
               << ", status: " << status;
         } else {
           ++enabled_peer_count;
+          // Record the pair so device-to-device copies can tell direct
+          // DMA routes from ones the driver must stage through host.
+          GPUUtil::RecordPeerAccessEnabled(platform_gpu_i.value(),
+                                           platform_gpu_j.value());
         }
       }
     }
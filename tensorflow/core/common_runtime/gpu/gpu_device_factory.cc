@@ -23,9 +23,27 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 #include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+// Number of stream groups per GPU device.  With more than one group,
+// BaseGPUDevice::FillContextMap colors independent subgraphs onto separate
+// compute streams, so parallel branches of a graph can overlap on device.
+// Inter-stream data dependencies are handled by BaseGPUDevice::ComputeHelper
+// and tensor lifetimes across streams by the EventMgr.  Experimental; not
+// supported in combination with kernel tracking or timestamped_allocator.
+static int32 GetMaxStreams() {
+  int64 max_streams;
+  Status status = ReadInt64FromEnvVar("TF_GPU_MAX_STREAMS", 1, &max_streams);
+  if (!status.ok() || max_streams < 1) {
+    LOG(ERROR) << "Invalid TF_GPU_MAX_STREAMS value: " << max_streams
+               << "; using 1";
+    return 1;
+  }
+  return static_cast<int32>(max_streams);
+}
+
 class GPUDevice : public BaseGPUDevice {
  public:
   GPUDevice(const SessionOptions& options, const string& name,
@@ -34,7 +52,8 @@ class GPUDevice : public BaseGPUDevice {
             Allocator* gpu_allocator, Allocator* cpu_allocator)
       : BaseGPUDevice(options, name, memory_limit, locality, tf_gpu_id,
                       physical_device_desc, gpu_allocator, cpu_allocator,
-                      false /* sync every op */, 1 /* max_streams */) {
+                      false /* sync every op */, GetMaxStreams()),
+        numa_node_(locality.numa_node()) {
     if (options.config.has_gpu_options()) {
       force_gpu_compatible_ =
           options.config.gpu_options().force_gpu_compatible();
@@ -46,7 +65,9 @@ class GPUDevice : public BaseGPUDevice {
     if (attr.on_host()) {
       if (attr.gpu_compatible() || force_gpu_compatible_) {
         GPUProcessState* ps = GPUProcessState::singleton();
-        return ps->GetGpuHostAllocator(0);
+        // Use the pinned pool on this GPU's NUMA node so staging buffers
+        // are local to its PCIe root complex.
+        return ps->GetGpuHostAllocator(numa_node_);
       } else {
         return cpu_allocator_;
       }
@@ -56,6 +77,7 @@ class GPUDevice : public BaseGPUDevice {
   }
 
  private:
+  int numa_node_ = port::kNUMANoAffinity;
   bool force_gpu_compatible_ = false;
 };
 
@@ -108,10 +108,6 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
 EventMgr::~EventMgr() {
   StopPollingLoop();
 
-  // Events are owned by this object.
-  for (auto& e : free_events_) {
-    delete e;
-  }
   for (auto& t : *(accumulated_tensors_)) {
     t.Unref();
   }
@@ -219,18 +215,15 @@ void EventMgr::PollLoop() {
 }
 
 void EventMgr::QueueInUse(se::Stream* stream, InUse iu) {
-  VLOG(2) << "QueueInUse  free_events_ " << free_events_.size()
+  VLOG(2) << "QueueInUse  event_pool " << exec_->EventPoolSize()
           << " used_events_ " << used_events_.size();
-  // Events are created on demand, and repeatedly reused.  There is no
-  // limit placed here on the number of allocated Events.
-  if (free_events_.empty()) {
-    free_events_.push_back(new se::Event(exec_));
-    free_events_.back()->Init();
-  }
-  se::Event* e = free_events_.back();
-  free_events_.pop_back();
-  stream->ThenRecordEvent(e);
-  iu.event = e;
+  // Events are leased from the executor's pool, which creates them on
+  // demand and repeatedly reuses them; completed events go back to the pool
+  // in PollEvents() below.
+  std::unique_ptr<se::Event> e = exec_->GetOrCreateEvent();
+  CHECK(e != nullptr) << "Failed to create an event to track GPU activity";
+  stream->ThenRecordEvent(e.get());
+  iu.event = e.release();
   bool was_empty = used_events_.empty();
   used_events_.push_back(iu);
   // Maybe wake up the polling thread
@@ -257,7 +250,7 @@ void EventMgr::QueueInUse(se::Stream* stream, InUse iu) {
 // polling thread always sweep the full queue.
 void EventMgr::PollEvents(bool is_dedicated_poller,
                           gtl::InlinedVector<InUse, 4>* to_free) {
-  VLOG(2) << "PollEvents  free_events_ " << free_events_.size()
+  VLOG(2) << "PollEvents  event_pool " << exec_->EventPoolSize()
           << " used_events_ " << used_events_.size();
   // Sweep the remaining events in order.  If this is the dedicated
   // polling thread, check the entire set.  Otherwise, just sweep up to
@@ -279,7 +272,8 @@ void EventMgr::PollEvents(bool is_dedicated_poller,
         // Make a copy of the InUse record so we can free it after releasing
         // the lock
         to_free->push_back(iu);
-        free_events_.push_back(iu.event);
+        // The event has completed, so it is safe to recycle.
+        exec_->ReturnEvent(std::unique_ptr<se::Event>(iu.event));
         // Mark this InUse record as completed.
         iu.event = nullptr;
     }
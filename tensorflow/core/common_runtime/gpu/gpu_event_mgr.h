@@ -185,9 +185,6 @@ class EventMgr {
   void StartPollingLoop();
   void StopPollingLoop();
 
-  // A stack of unused events
-  std::vector<se::Event*> free_events_ GUARDED_BY(mu_);
-
   // Buffered list of tensors waiting to have an event queued for deletion
   se::Stream* accumulated_stream_ GUARDED_BY(mu_);
   TensorReferenceVector* accumulated_tensors_ GUARDED_BY(mu_);
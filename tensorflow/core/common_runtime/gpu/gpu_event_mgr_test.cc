@@ -52,6 +52,12 @@ class TEST_EventMgrHelper {
     // The tested behavior is slightly different from what may occur in
     // ordinary execution.
     StopPollingLoop();
+    // Free events now live in the executor's pool, which is shared across
+    // test cases in this process; drain it so the counts below start at
+    // zero.
+    while (em_->exec_->EventPoolSize() > 0) {
+      em_->exec_->GetOrCreateEvent();
+    }
   }
 
   size_t queue_size() {
@@ -59,10 +65,7 @@ class TEST_EventMgrHelper {
     return em_->used_events_.size();
   }
 
-  size_t free_size() {
-    mutex_lock l(em_->mu_);
-    return em_->free_events_.size();
-  }
+  size_t free_size() { return em_->exec_->EventPoolSize(); }
 
   void QueueTensors(se::Stream* stream, TensorReferenceVector* tensors) {
     mutex_lock l(em_->mu_);
@@ -16,13 +16,23 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_HOST_ALLOCATOR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_HOST_ALLOCATOR_H_
 
+#include <unordered_set>
+
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/stream_executor.h"
 
 namespace tensorflow {
 // Allocator for pinned CPU RAM that is made known to GPU for the
 // purpose of efficient DMA with a GPU.
+//
+// When constructed with a real NUMA node on a NUMA-aware system the
+// backing pages are allocated on that node and then registered with the
+// GPU, so that H2D/D2H staging for a GPU reads and writes memory on the
+// socket its PCIe root complex is attached to.  Otherwise pinned memory
+// is obtained directly from the driver with no node affinity.
 class GpuHostAllocator : public SubAllocator {
  public:
   // Note: stream_exec cannot be null.
@@ -31,7 +41,8 @@ class GpuHostAllocator : public SubAllocator {
                             const std::vector<Visitor>& free_visitors)
       : SubAllocator(alloc_visitors, free_visitors),
         stream_exec_(stream_exec),
-        numa_node_(numa_node) {
+        numa_node_(numa_node),
+        use_numa_(numa_node != port::kNUMANoAffinity && port::NUMAEnabled()) {
     CHECK(stream_exec_ != nullptr);
   }
   ~GpuHostAllocator() override {}
@@ -39,7 +50,25 @@ class GpuHostAllocator : public SubAllocator {
   void* Alloc(size_t alignment, size_t num_bytes) override {
     void* ptr = nullptr;
     if (num_bytes > 0) {
-      ptr = stream_exec_->HostMemoryAllocate(num_bytes);
+      if (use_numa_) {
+        ptr = port::NUMAMalloc(numa_node_, num_bytes, alignment);
+        if (ptr != nullptr) {
+          if (stream_exec_->HostMemoryRegister(ptr, num_bytes)) {
+            mutex_lock l(mu_);
+            numa_regions_.insert(ptr);
+          } else {
+            LOG(WARNING) << "could not register NUMA node " << numa_node_
+                         << " host memory of size " << num_bytes
+                         << " with the GPU, falling back to unpinned "
+                         << "node allocation";
+            port::NUMAFree(ptr, num_bytes);
+            ptr = nullptr;
+          }
+        }
+      }
+      if (ptr == nullptr) {
+        ptr = stream_exec_->HostMemoryAllocate(num_bytes);
+      }
       if (ptr == nullptr) {
         LOG(WARNING) << "could not allocate pinned host memory of size: "
                      << num_bytes;
@@ -53,13 +82,31 @@ class GpuHostAllocator : public SubAllocator {
   void Free(void* ptr, size_t num_bytes) override {
     if (ptr != nullptr) {
       VisitFree(ptr, numa_node_, num_bytes);
-      stream_exec_->HostMemoryDeallocate(ptr);
+      bool numa_region = false;
+      {
+        mutex_lock l(mu_);
+        numa_region = numa_regions_.erase(ptr) > 0;
+      }
+      if (numa_region) {
+        if (!stream_exec_->HostMemoryUnregister(ptr)) {
+          LOG(WARNING) << "could not unregister host memory at " << ptr;
+        }
+        port::NUMAFree(ptr, num_bytes);
+      } else {
+        stream_exec_->HostMemoryDeallocate(ptr);
+      }
     }
   }
 
  private:
   se::StreamExecutor* stream_exec_;  // not owned, non-null
   const int numa_node_;
+  const bool use_numa_;
+
+  mutex mu_;
+  // Regions obtained from NUMAMalloc + HostMemoryRegister, which must be
+  // released differently from driver-allocated pinned memory.
+  std::unordered_set<void*> numa_regions_ GUARDED_BY(mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(GpuHostAllocator);
 };
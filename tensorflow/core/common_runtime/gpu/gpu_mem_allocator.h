@@ -40,6 +40,8 @@ class GPUMemAllocator : public SubAllocator {
   }
   ~GPUMemAllocator() override {}
 
+  se::StreamExecutor* stream_executor() const { return stream_exec_; }
+
   void* Alloc(size_t alignment, size_t num_bytes) override {
     void* ptr = nullptr;
     if (num_bytes > 0) {
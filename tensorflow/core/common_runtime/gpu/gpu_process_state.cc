@@ -208,7 +208,7 @@ Allocator* GPUProcessState::GetGpuHostAllocator(int numa_node) {
       return gpu_host_allocators_[0].recording_allocator.get();
     }
     if (static_cast<int>(gpu_host_allocators_.size()) > numa_node) {
-      return gpu_host_allocators_[0].allocator.get();
+      return gpu_host_allocators_[numa_node].allocator.get();
     }
   }
 
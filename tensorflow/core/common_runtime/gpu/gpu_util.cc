@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_util.h"
 
+#include <set>
+#include <utility>
+
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -60,6 +63,21 @@ namespace tensorflow {
 using se::DeviceMemoryBase;
 using se::Stream;
 
+namespace {
+
+// Minimum number of bytes per stripe when a device-to-device transfer is
+// split across several copy streams.  Below this size the fixed cost of an
+// extra copy-engine launch outweighs the added bandwidth.
+const int64 kMinCopyStripeBytes = 4 << 20;
+
+// Directed (src, dst) platform GPU id pairs with peer-to-peer DMA enabled,
+// populated by BaseGPUDeviceFactory::EnablePeerAccess at startup.
+mutex peer_access_mu(LINKER_INITIALIZED);
+std::set<std::pair<int, int>>* peer_access_pairs
+    GUARDED_BY(peer_access_mu) = new std::set<std::pair<int, int>>;
+
+}  // namespace
+
 Status PrepareCopy(Device* device, const DeviceContext* ctx, const Tensor& src,
                    const Tensor* dst,
                    const DeviceBase::GpuDeviceInfo** dev_info,
@@ -150,7 +168,9 @@ void GPUUtil::SetProtoFromGPU(const Tensor& tensor, Device* dev,
   const int64 total_bytes = is_dead ? 0 : tensor.TotalBytes();
   if (total_bytes > 0) {
     tracing::ScopedAnnotation annotation("SetProtoFromGPU");
-    alloc = GPUProcessState::singleton()->GetGpuHostAllocator(0);
+    // Stage through pinned memory on the GPU's own NUMA node.
+    alloc = GPUProcessState::singleton()->GetGpuHostAllocator(
+        dev->attributes().locality().numa_node());
     buf = static_cast<char*>(
         alloc->AllocateRaw(Allocator::kAllocatorAlignment, total_bytes));
     if (LogMemory::IsEnabled()) {
@@ -213,9 +233,7 @@ void GPUUtil::DeviceToDeviceCopy(
   const int64 total_bytes = input->TotalBytes();
   if (total_bytes > 0) {
     void* src_ptr = GetBase(input);
-    DeviceMemoryBase gpu_src_ptr(src_ptr, total_bytes);
     void* dst_ptr = GetBase(output);
-    DeviceMemoryBase gpu_dst_ptr(dst_ptr, total_bytes);
     auto recv_stream =
         static_cast<const GPUDeviceContext*>(recv_dev_context)->stream();
     if (recv_stream == nullptr) {
@@ -230,8 +248,55 @@ void GPUUtil::DeviceToDeviceCopy(
     send_device_to_device_stream->ThenWaitFor(recv_stream);
 
     VLOG(2) << "src_ptr " << src_ptr << " dst_ptr " << dst_ptr;
+
+    // When the devices are peered, the copy runs directly over the
+    // interconnect and a large transfer can be striped over the device's
+    // other copy streams to engage more than one copy engine.  Unpeered
+    // transfers are bounced through host memory by the driver, a single
+    // serialized route that extra streams cannot widen.
+    const GPUDeviceContext* send_gpu_context =
+        static_cast<const GPUDeviceContext*>(send_dev_context);
+    const DeviceBase::GpuDeviceInfo* dst_info =
+        dst->tensorflow_gpu_device_info();
+    int64 num_stripes = 1;
+    if (dst_info != nullptr &&
+        IsPeerAccessEnabled(dev_info->gpu_id, dst_info->gpu_id)) {
+      num_stripes = std::max<int64>(
+          1, std::min<int64>(send_gpu_context->num_device_to_device_streams(),
+                             total_bytes / kMinCopyStripeBytes));
+    } else if (dst_info != nullptr && dev_info->gpu_id != dst_info->gpu_id) {
+      VLOG(1) << "No peer access from GPU " << dev_info->gpu_id << " to GPU "
+              << dst_info->gpu_id
+              << "; transfer will be staged through host memory.";
+    }
+    // Stripes are whole multiples of 256 bytes so that each copy stays
+    // well aligned.  The first stripe runs on send_device_to_device_stream
+    // itself; the rest are enqueued on the other copy streams and rejoined
+    // afterwards so that the completion callback below covers all of them.
+    const int64 stripe_bytes = std::min(
+        total_bytes,
+        ((total_bytes + num_stripes - 1) / num_stripes + 255) & ~int64{255});
+    DeviceMemoryBase gpu_src_ptr(src_ptr, stripe_bytes);
+    DeviceMemoryBase gpu_dst_ptr(dst_ptr, stripe_bytes);
     send_device_to_device_stream->ThenMemcpy(&gpu_dst_ptr, gpu_src_ptr,
-                                             total_bytes);
+                                             stripe_bytes);
+    int64 offset = stripe_bytes;
+    gtl::InlinedVector<Stream*, 4> stripe_streams;
+    for (int64 i = 1; i < num_stripes && offset < total_bytes; ++i) {
+      Stream* stripe_stream = send_gpu_context->device_to_device_stream(
+          dev_to_dev_stream_index + i);
+      const int64 bytes = std::min(stripe_bytes, total_bytes - offset);
+      DeviceMemoryBase stripe_src(static_cast<char*>(src_ptr) + offset, bytes);
+      DeviceMemoryBase stripe_dst(static_cast<char*>(dst_ptr) + offset, bytes);
+      stripe_stream->ThenWaitFor(send_stream);
+      stripe_stream->ThenWaitFor(recv_stream);
+      stripe_stream->ThenMemcpy(&stripe_dst, stripe_src, bytes);
+      stripe_streams.push_back(stripe_stream);
+      offset += bytes;
+    }
+    for (Stream* stripe_stream : stripe_streams) {
+      send_device_to_device_stream->ThenWaitFor(stripe_stream);
+    }
   }
 
   // Use of input may outlive stack scope, so keep a ref.
@@ -252,6 +317,19 @@ void GPUUtil::DeviceToDeviceCopy(
 static CopyTensor::Registration register_gpu_gpu_copy(
     DEVICE_GPU, DEVICE_GPU, GPUUtil::DeviceToDeviceCopy);
 
+// static
+void GPUUtil::RecordPeerAccessEnabled(int src_gpu_id, int dst_gpu_id) {
+  mutex_lock l(peer_access_mu);
+  peer_access_pairs->insert({src_gpu_id, dst_gpu_id});
+}
+
+// static
+bool GPUUtil::IsPeerAccessEnabled(int src_gpu_id, int dst_gpu_id) {
+  if (src_gpu_id == dst_gpu_id) return true;
+  mutex_lock l(peer_access_mu);
+  return peer_access_pairs->count({src_gpu_id, dst_gpu_id}) != 0;
+}
+
 // static
 void GPUUtil::CopyGPUTensorToCPU(Device* gpu_device,
                                  const DeviceContext* device_context,
@@ -96,6 +96,17 @@ class GPUUtil {
       AllocatorAttributes dst_alloc_attr, const Tensor* input, Tensor* output,
       int dev_to_dev_stream_index, StatusCallback done);
 
+  // Records that peer-to-peer DMA was enabled from platform GPU
+  // "src_gpu_id" to "dst_gpu_id".  Called by BaseGPUDeviceFactory while
+  // enabling peer access at startup.
+  static void RecordPeerAccessEnabled(int src_gpu_id, int dst_gpu_id);
+
+  // Returns true if peer-to-peer DMA is enabled from platform GPU
+  // "src_gpu_id" to "dst_gpu_id" (trivially true when they are equal).
+  // Transfers between peered devices go directly over the interconnect;
+  // others are bounced through host memory by the driver.
+  static bool IsPeerAccessEnabled(int src_gpu_id, int dst_gpu_id);
+
   // Deep-copying of GPU tensor on the same device.
   // 'src_gpu_tensor''s and 'dst_gpu_tensor''s backing memory must be on
   // 'gpu_device' and 'dst_cpu_tensor' must be allocated to be of the same
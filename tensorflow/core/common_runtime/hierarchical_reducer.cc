@@ -0,0 +1,539 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_reducer.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tensorflow/core/common_runtime/collective_rma_local.h"
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/device_base.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/tracing.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+
+namespace {
+// Key to be used for BufRendezvous by HierarchicalReducer.  `step`
+// disambiguates the successive exchanges between the same pair of ranks in
+// the inter-task ring.
+string ReduceBufKey(const string& exec_key, int subdiv, int step, int src_rank,
+                    int dst_rank) {
+  // TODO(b/78352018): Try a denser format, e.g. a 64 or 128 bit hash.
+  return strings::StrCat(exec_key, ":", subdiv, ":", step, ":", src_rank, ":",
+                         dst_rank);
+}
+}  // namespace
+
+HierarchicalReducer::HierarchicalReducer()
+    : col_ctx_(nullptr), col_params_(nullptr), done_(nullptr) {}
+
+HierarchicalReducer::~HierarchicalReducer() {
+  group_size_tensor_ready_.WaitForNotification();
+}
+
+Status HierarchicalReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  // TODO(b/113171733): change CHECKs to return errors.
+  CHECK_EQ(col_params->instance.type, REDUCTION_COLLECTIVE);
+  CHECK_EQ(col_params->instance.impl_details.collective_name,
+           "HierarchicalReduce");
+  const string& device_name =
+      col_params->instance.device_names[col_params->default_rank];
+  // Start by counting the devices in each task.
+  // Precondition: device_names must be sorted so that all devices in
+  // the same task are adjacent.
+  VLOG(2) << "Sorted task names: "
+          << str_util::Join(col_params->instance.task_names, ", ");
+  std::vector<int> dev_per_task;
+  const string* prior_task_name = &col_params->instance.task_names[0];
+  int dev_count = 1;
+  for (int di = 1; di < col_params->group.group_size; ++di) {
+    if (col_params->instance.task_names[di] != *prior_task_name) {
+      dev_per_task.push_back(dev_count);
+      dev_count = 1;
+      prior_task_name = &col_params->instance.task_names[di];
+    } else {
+      ++dev_count;
+    }
+  }
+  dev_per_task.push_back(dev_count);
+  CHECK_EQ(col_params->group.num_tasks, dev_per_task.size());
+
+  // Subdiv 0 is the inter-task ring comprising the leader (first) device of
+  // each task.  Subdiv i+1 comprises all devices of task i, with the leader
+  // at rank 0; it carries the local reduce towards the leader and the final
+  // local broadcast of the result.
+  int num_tasks = col_params->group.num_tasks;
+  int num_subdivs = num_tasks + 1;
+
+  col_params->instance.impl_details.subdiv_permutations.resize(num_subdivs);
+  col_params->subdiv_rank.reserve(num_subdivs);
+  col_params->instance.impl_details.subdiv_source_rank.reserve(num_subdivs);
+
+  // Inter-task subdiv.  Pick the first device from each task.  If a device
+  // does not participate in the subdiv, set subdiv_rank to -1.
+  {
+    std::vector<int>& perm =
+        col_params->instance.impl_details.subdiv_permutations[0];
+    CHECK_EQ(perm.size(), 0);
+    int device_count = 0;
+    for (int ti = 0; ti < num_tasks; ti++) {
+      perm.push_back(device_count);
+      if (col_params->instance.device_names[device_count] == device_name) {
+        col_params->subdiv_rank.push_back(ti);
+      }
+      device_count += dev_per_task[ti];
+    }
+    if (col_params->subdiv_rank.empty()) col_params->subdiv_rank.push_back(-1);
+    col_params->instance.impl_details.subdiv_source_rank.push_back(0);
+  }
+
+  // Intra-task subdivs.  Pick all devices in task ti for subdiv ti+1.  If a
+  // device does not participate in the subdiv, set subdiv_rank to -1.
+  int abs_di = 0;
+  for (int ti = 0; ti < num_tasks; ti++) {
+    std::vector<int>& perm =
+        col_params->instance.impl_details.subdiv_permutations[ti + 1];
+    CHECK_EQ(perm.size(), 0);
+    bool participate = false;
+    for (int di = 0; di < dev_per_task[ti]; di++) {
+      perm.push_back(abs_di);
+      if (col_params->instance.device_names[abs_di] == device_name) {
+        participate = true;
+        col_params->subdiv_rank.push_back(di);
+      }
+      abs_di++;
+    }
+    if (!participate) col_params->subdiv_rank.push_back(-1);
+    col_params->instance.impl_details.subdiv_source_rank.push_back(0);
+  }
+
+  VLOG(2) << collective_util::SubdivPermDebugString(*col_params);
+  return Status::OK();
+}
+
+Status HierarchicalReducer::InitializeCollectiveContext(
+    CollectiveContext* col_ctx) {
+  CHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = &col_ctx->col_params;
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void HierarchicalReducer::Run(StatusCallback done) {
+  CHECK(col_ctx_);
+  CHECK(col_params_);
+  done_ = std::move(done);
+  RunReduce();
+}
+
+// Executes a hierarchical reduce.
+// Phase 1: each task's devices send their inputs to the task leader which
+// merges them into a per-task partial sum.
+// Phase 2: the leaders all-reduce the partial sums by circulating them
+// around the inter-task ring; only one device per task touches the network.
+// Phase 3: each leader applies the final op, if any, and sends the result
+// to the other devices on its task.
+void HierarchicalReducer::RunReduce() {
+  // Locate this device's intra-task subdiv and rank within it.
+  int local_subdiv = -1;
+  int local_rank = -1;
+  for (int si = 1; si < static_cast<int>(col_params_->subdiv_rank.size());
+       ++si) {
+    if (col_params_->subdiv_rank[si] >= 0) {
+      local_subdiv = si;
+      local_rank = col_params_->subdiv_rank[si];
+      break;
+    }
+  }
+  CHECK_GE(local_subdiv, 1);
+  CHECK_GE(local_rank, 0);
+  const int local_size = static_cast<int>(
+      col_params_->instance.impl_details.subdiv_permutations[local_subdiv]
+          .size());
+  const bool is_leader = (local_rank == 0);
+  VLOG(1) << "HierarchicalReducer::Run for device " << col_ctx_->device_name
+          << " default_rank " << col_params_->default_rank << " local_subdiv "
+          << local_subdiv << " local_rank " << local_rank << " leader "
+          << is_leader;
+
+  if (!is_leader) {
+    // Contribute this device's input to the task leader, then wait for the
+    // leader to send back the final value.
+    group_size_tensor_ready_.Notify();  // Value is only used by leaders.
+    {
+      profiler::TraceMe activity("SendToLeader", profiler::TraceMeLevel::kInfo);
+      Notification note;
+      DispatchSend(local_subdiv, 0 /*step*/, 0 /*dst_rank*/, local_rank,
+                   col_ctx_->input, [this, &note](const Status& s) {
+                     mutex_lock l(status_mu_);
+                     status_.Update(s);
+                     note.Notify();
+                   });
+      note.WaitForNotification();
+    }
+    bool ok;
+    {
+      mutex_lock l(status_mu_);
+      ok = status_.ok();
+    }
+    if (ok) {
+      profiler::TraceMe activity("RecvFromLeader",
+                                 profiler::TraceMeLevel::kInfo);
+      Notification note;
+      DispatchRecv(local_subdiv, 0 /*step*/, 0 /*src_rank*/, local_rank,
+                   col_ctx_->output, [this, &note](const Status& s) {
+                     mutex_lock l(status_mu_);
+                     status_.Update(s);
+                     note.Notify();
+                   });
+      note.WaitForNotification();
+    }
+    Status s;
+    {
+      mutex_lock l(status_mu_);
+      s = status_;
+    }
+    done_(s);
+    return;
+  }
+
+  // Leader path.  Start by copying input to output if they're not already the
+  // same, i.e. if we're not computing in-place on the input tensor.
+  if ((col_ctx_->input != col_ctx_->output) &&
+      (DMAHelper::base(col_ctx_->input) != DMAHelper::base(col_ctx_->output))) {
+    // We are running in a blockable thread and the callback can't block so
+    // just wait here on the copy.
+    Notification note;
+    Status status;
+    profiler::TraceMe activity("MemCpyAsync", profiler::TraceMeLevel::kInfo);
+    CollectiveRemoteAccessLocal::MemCpyAsync(
+        col_ctx_->op_ctx->input_device_context(0),
+        col_ctx_->op_ctx->op_device_context(), col_ctx_->device,
+        col_ctx_->device, col_ctx_->op_ctx->input_alloc_attr(0),
+        col_ctx_->op_ctx->output_alloc_attr(0), col_ctx_->input,
+        col_ctx_->output, 0 /*dev_to_dev_stream_index*/,
+        [&note, &status](const Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+    if (!status.ok()) {
+      group_size_tensor_ready_.Notify();
+      done_(status);
+      return;
+    }
+  }
+
+  AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+  ca_.reset(MakeCollectiveAdapter(col_ctx_->output, 1 /*num_chunks*/,
+                                  col_ctx_->device->GetAllocator(attr)));
+
+  if (col_params_->final_op) {
+    // Create an on-device scalar value from the group size that may be
+    // needed later.
+    Tensor group_size_val = ca_->Scalar(col_params_->group.group_size);
+    if (col_params_->group.device_type != "CPU") {
+      uint64 safe_alloc_frontier = col_ctx_->device->SafeAllocFrontier(0);
+      AllocationAttributes aa;
+      std::function<uint64()> freed_by_func = [this, &safe_alloc_frontier]() {
+        safe_alloc_frontier =
+            col_ctx_->device->SafeAllocFrontier(safe_alloc_frontier);
+        return safe_alloc_frontier;
+      };
+      if (safe_alloc_frontier > 0) {
+        aa.freed_by_func = &freed_by_func;
+      }
+      group_size_tensor_ = ca_->Scalar(
+          col_ctx_->device->GetAllocator(col_ctx_->op_ctx->input_alloc_attr(0)),
+          aa);
+      DeviceContext* op_dev_ctx = col_ctx_->op_ctx->op_device_context();
+      op_dev_ctx->CopyCPUTensorToDevice(
+          &group_size_val, col_ctx_->device, &group_size_tensor_,
+          [this](const Status& s) {
+            if (!s.ok()) {
+              mutex_lock l(status_mu_);
+              status_.Update(s);
+            }
+            group_size_tensor_ready_.Notify();
+          },
+          (safe_alloc_frontier == 0));
+    } else {
+      group_size_tensor_ = group_size_val;
+      group_size_tensor_ready_.Notify();
+    }
+  } else {
+    // Value won't be used, so no need to initialize.
+    group_size_tensor_ready_.Notify();
+  }
+
+  Tensor accumulator = ca_->ChunkAlias(0);
+
+  const DeviceBase::GpuDeviceInfo* gpu_info =
+      col_ctx_->device->tensorflow_gpu_device_info();
+  if (gpu_info) {
+    // Wait for all currently queued events on the CPU compute stream to
+    // complete before proceeding.  The temp buffers allocated during the
+    // phases below are not guaranteed to be valid (e.g. for RDMA write)
+    // unless we do.
+    profiler::TraceMe activity("WaitForQueuedEvents",
+                               profiler::TraceMeLevel::kInfo);
+    Notification note;
+    Status s = gpu_info->default_context->ThenExecute(
+        col_ctx_->device, gpu_info->stream, [&note]() { note.Notify(); });
+    if (s.ok()) {
+      note.WaitForNotification();
+    } else {
+      mutex_lock l(status_mu_);
+      status_.Update(
+          errors::Internal("Failed to dispatch ThenExecute in "
+                           "HierarchicalReducer"));
+    }
+  }
+
+  bool ok;
+  {
+    mutex_lock l(status_mu_);
+    ok = status_.ok();
+  }
+  if (ok) {
+    profiler::TraceMe activity("ReduceLocal", profiler::TraceMeLevel::kInfo);
+    ReduceLocal(local_subdiv, local_size, &accumulator);
+    mutex_lock l(status_mu_);
+    ok = status_.ok();
+  }
+  if (ok) {
+    profiler::TraceMe activity("ReduceAcrossTasks",
+                               profiler::TraceMeLevel::kInfo);
+    ReduceAcrossTasks(&accumulator);
+    mutex_lock l(status_mu_);
+    ok = status_.ok();
+  }
+  if (ok && col_params_->final_op) {
+    profiler::TraceMe activity("Finalize", profiler::TraceMeLevel::kInfo);
+    group_size_tensor_ready_.WaitForNotification();
+    Status s = collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->final_op.get(), &accumulator, &group_size_tensor_);
+    mutex_lock l(status_mu_);
+    status_.Update(s);
+    ok = status_.ok();
+  }
+  if (ok) {
+    profiler::TraceMe activity("BroadcastLocal",
+                               profiler::TraceMeLevel::kInfo);
+    BroadcastLocal(local_subdiv, local_size);
+    mutex_lock l(status_mu_);
+    ok = status_.ok();
+  }
+
+  if (ok) {
+    // Recover the output from the adaptor.
+    ca_->ConsumeFinalValue(col_ctx_->output);
+  }
+  Status s;
+  {
+    mutex_lock l(status_mu_);
+    s = status_;
+  }
+  VLOG(2) << "device=" << col_ctx_->device_name << " return status " << s;
+  done_(s);
+}
+
+void HierarchicalReducer::ReduceLocal(int subdiv, int local_size,
+                                      Tensor* accumulator) {
+  // Receive and merge one contribution at a time so that only a single temp
+  // buffer is needed regardless of how many devices the task hosts.  The
+  // local interconnect is fast relative to the network so the serialization
+  // is not the bottleneck of the collective.
+  Tensor tmp = ca_->TempChunk(0);
+  for (int r = 1; r < local_size; ++r) {
+    Notification note;
+    DispatchRecv(subdiv, 0 /*step*/, r, 0 /*dst_rank*/, &tmp,
+                 [this, &note](const Status& s) {
+                   mutex_lock l(status_mu_);
+                   status_.Update(s);
+                   note.Notify();
+                 });
+    note.WaitForNotification();
+    {
+      mutex_lock l(status_mu_);
+      if (!status_.ok()) return;
+    }
+    Status s = collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->merge_op.get(), accumulator, &tmp);
+    if (!s.ok()) {
+      mutex_lock l(status_mu_);
+      status_.Update(s);
+      return;
+    }
+  }
+}
+
+void HierarchicalReducer::ReduceAcrossTasks(Tensor* accumulator) {
+  const int num_tasks = col_params_->group.num_tasks;
+  if (num_tasks <= 1) return;
+  const int my_rank = col_params_->subdiv_rank[0];
+  CHECK_GE(my_rank, 0);
+  const int send_to_rank = (my_rank + 1) % num_tasks;
+  const int recv_from_rank = (my_rank + num_tasks - 1) % num_tasks;
+
+  // At step s each leader forwards the partial sum it received at step s-1
+  // (initially its own) to the next leader and merges the one received from
+  // the previous leader, so that after num_tasks-1 steps every leader has
+  // merged every task's partial sum exactly once.
+  Tensor fwd = ca_->TempChunk(0);
+  Tensor recv_buf = ca_->TempChunk(0);
+  {
+    Notification note;
+    DeviceContext* op_dev_ctx = col_ctx_->op_ctx->op_device_context();
+    CollectiveRemoteAccessLocal::MemCpyAsync(
+        op_dev_ctx, op_dev_ctx, col_ctx_->device, col_ctx_->device,
+        col_ctx_->op_ctx->output_alloc_attr(0),
+        col_ctx_->op_ctx->output_alloc_attr(0), accumulator, &fwd,
+        0 /*dev_to_dev_stream_index*/, [this, &note](const Status& s) {
+          mutex_lock l(status_mu_);
+          status_.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+  }
+  for (int step = 0; step < num_tasks - 1; ++step) {
+    {
+      mutex_lock l(status_mu_);
+      if (!status_.ok()) return;
+    }
+    Notification send_note;
+    Notification recv_note;
+    DispatchSend(0 /*subdiv*/, step, send_to_rank, my_rank, &fwd,
+                 [this, &send_note](const Status& s) {
+                   mutex_lock l(status_mu_);
+                   status_.Update(s);
+                   send_note.Notify();
+                 });
+    DispatchRecv(0 /*subdiv*/, step, recv_from_rank, my_rank, &recv_buf,
+                 [this, &recv_note](const Status& s) {
+                   mutex_lock l(status_mu_);
+                   status_.Update(s);
+                   recv_note.Notify();
+                 });
+    send_note.WaitForNotification();
+    recv_note.WaitForNotification();
+    {
+      mutex_lock l(status_mu_);
+      if (!status_.ok()) return;
+    }
+    Status s = collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->merge_op.get(), accumulator, &recv_buf);
+    if (!s.ok()) {
+      mutex_lock l(status_mu_);
+      status_.Update(s);
+      return;
+    }
+    // What was just received is what gets forwarded at the next step.
+    std::swap(fwd, recv_buf);
+  }
+}
+
+void HierarchicalReducer::BroadcastLocal(int subdiv, int local_size) {
+  mutex mu;
+  int pending_count = local_size - 1;  // GUARDED_BY(mu)
+  if (pending_count == 0) return;
+  condition_variable all_done;
+  // The final value still lives in the adapter's backing buffer; send the
+  // chunk alias rather than col_ctx_->output.
+  Tensor final_value = ca_->ChunkAlias(0);
+  for (int r = 1; r < local_size; ++r) {
+    DispatchSend(subdiv, 0 /*step*/, r, 0 /*src_rank*/, &final_value,
+                 [this, &mu, &pending_count, &all_done](const Status& s) {
+                   mutex_lock l(mu);
+                   {
+                     mutex_lock sl(status_mu_);
+                     status_.Update(s);
+                   }
+                   --pending_count;
+                   if (pending_count == 0) {
+                     all_done.notify_all();
+                   }
+                 });
+  }
+  mutex_lock l(mu);
+  while (pending_count > 0) {
+    all_done.wait(l);
+  }
+}
+
+void HierarchicalReducer::DispatchSend(int subdiv, int step, int dst_rank,
+                                       int src_rank, const Tensor* src_tensor,
+                                       const StatusCallback& done) {
+  string send_buf_key =
+      ReduceBufKey(col_ctx_->exec_key, subdiv, step, src_rank, dst_rank);
+  int dst_idx =
+      col_params_->instance.impl_details.subdiv_permutations[subdiv][dst_rank];
+  VLOG(3) << "DispatchSend " << send_buf_key << " from_device "
+          << col_ctx_->device_name << " to_device "
+          << col_params_->instance.device_names[dst_idx] << " subdiv=" << subdiv
+          << " step=" << step << " dst_rank=" << dst_rank
+          << " dst_idx=" << dst_idx;
+  col_ctx_->col_exec->PostToPeer(col_params_->instance.device_names[dst_idx],
+                                 col_params_->instance.task_names[dst_idx],
+                                 send_buf_key, col_ctx_->device,
+                                 col_ctx_->op_ctx->op_device_context(),
+                                 col_ctx_->op_ctx->output_alloc_attr(0),
+                                 src_tensor, col_ctx_->device_locality, done);
+}
+
+void HierarchicalReducer::DispatchRecv(int subdiv, int step, int src_rank,
+                                       int dst_rank, Tensor* dst_tensor,
+                                       const StatusCallback& done) {
+  string recv_buf_key =
+      ReduceBufKey(col_ctx_->exec_key, subdiv, step, src_rank, dst_rank);
+  int src_idx =
+      col_params_->instance.impl_details.subdiv_permutations[subdiv][src_rank];
+  VLOG(3) << "DispatchRecv " << recv_buf_key << " from_device "
+          << col_params_->instance.device_names[src_idx] << " to_device "
+          << col_ctx_->device_name << " subdiv=" << subdiv << " step=" << step
+          << " src_rank=" << src_rank << " src_idx=" << src_idx;
+  col_ctx_->col_exec->RecvFromPeer(
+      col_params_->instance.device_names[src_idx],
+      col_params_->instance.task_names[src_idx],
+      col_params_->task.is_local[src_idx], recv_buf_key, col_ctx_->device,
+      col_ctx_->op_ctx->op_device_context(),
+      col_ctx_->op_ctx->output_alloc_attr(0), dst_tensor,
+      col_ctx_->device_locality, 0 /*stream_index*/, done);
+}
+
+REGISTER_COLLECTIVE(HierarchicalReduce, HierarchicalReducer);
+
+}  // namespace tensorflow
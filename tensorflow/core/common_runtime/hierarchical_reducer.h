@@ -0,0 +1,101 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/framework/collective.h"
+
+namespace tensorflow {
+
+// Hierarchical implementation of collective all-reduce.
+//
+// Reduction proceeds in three phases: each task first reduces the
+// contributions of its local devices onto one leader device, the leaders
+// then all-reduce among themselves over the network, and finally each
+// leader broadcasts the result back to the other devices on its task.
+// Compared to a flat ring over all devices this moves each byte across
+// the network only between one device per task, which is a large win
+// when tasks host many fast locally-interconnected devices.
+class HierarchicalReducer : public CollectiveImplementationInterface {
+ public:
+  HierarchicalReducer();
+  ~HierarchicalReducer() override;
+
+  // Establishes the subdiv permutations needed for a hierarchical reduce.
+  // Subdiv 0 comprises the leader (first) device of each task; subdiv i+1
+  // comprises all devices of task i.
+  Status InitializeCollectiveParams(CollectiveParams* col_params) override;
+
+  // Initializes members of CollectiveContext not yet initialized, i.e. device
+  // and device_locality.  Also saves the CollectiveContext in this object.
+  Status InitializeCollectiveContext(CollectiveContext* col_ctx) override;
+
+  // No-op for hierarchical reducer.
+  Status InitializeCollectiveGroupRuntimeDetails(
+      CollGroupRuntimeDetails*) override {
+    return Status::OK();
+  }
+
+  // Begins async execution of the hierarchical reduce algorithm.
+  // Must be called in a blockable thread.
+  // TODO(b/80529858): remove the previous warning when we have a dedicated
+  // collective threadpool.
+  void Run(StatusCallback done) override;
+
+ private:
+  // Sends `src_tensor` asynchronously from this device to device at `dst_rank`
+  // in `subdiv`.  Calls `done` upon completion.
+  void DispatchSend(int subdiv, int step, int dst_rank, int src_rank,
+                    const Tensor* src_tensor, const StatusCallback& done);
+
+  // Receives a tensor into the memory buffer owned by `dst_tensor` at this
+  // device from device at `src_rank` in `subdiv`.  Calls `done` upon
+  // completion.
+  void DispatchRecv(int subdiv, int step, int src_rank, int dst_rank,
+                    Tensor* dst_tensor, const StatusCallback& done);
+
+  // Executes the three reduction phases on behalf of this device.  Blocking.
+  void RunReduce();
+
+  // Phase 1, leader side: receive and merge the contribution of every other
+  // device on this task.  `accumulator` aliases the output buffer.
+  void ReduceLocal(int subdiv, int local_size, Tensor* accumulator);
+
+  // Phase 2: all-reduce the per-task sums among the task leaders by
+  // forwarding contributions around a ring of one device per task.
+  void ReduceAcrossTasks(Tensor* accumulator);
+
+  // Phase 3, leader side: send the final value to every other device on
+  // this task.
+  void BroadcastLocal(int subdiv, int local_size);
+
+  CollectiveContext* col_ctx_;          // Not owned
+  const CollectiveParams* col_params_;  // Not owned
+  StatusCallback done_;
+  std::unique_ptr<CollectiveAdapter> ca_;
+  mutex status_mu_;
+  Status status_ GUARDED_BY(status_mu_);
+  Tensor group_size_tensor_;
+  Notification group_size_tensor_ready_;
+
+  friend class HierarchicalReducerTest;
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
@@ -0,0 +1,109 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_reducer.h"
+
+#include <vector>
+
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Tests of the subdiv permutations established by
+// HierarchicalReducer::InitializeCollectiveParams.  Subdiv 0 is the
+// inter-task ring of task leaders, subdiv i+1 covers the devices of task i.
+class HierarchicalReducerTest : public ::testing::Test {
+ protected:
+  void PrepColParams(CollectiveParams* cp,
+                     const std::vector<int>& dev_per_task) {
+    cp->group.device_type = DeviceType("GPU");
+    cp->group.num_tasks = dev_per_task.size();
+    cp->group.group_size = 0;
+    cp->instance.type = REDUCTION_COLLECTIVE;
+    cp->instance.impl_details.collective_name = "HierarchicalReduce";
+    for (int ti = 0; ti < cp->group.num_tasks; ti++) {
+      string task_name = strings::StrCat("/job:worker/replica:0/task:", ti);
+      for (int di = 0; di < dev_per_task[ti]; di++) {
+        string dev_name = strings::StrCat(task_name, "/device:GPU:", di);
+        cp->instance.task_names.push_back(task_name);
+        cp->instance.device_names.push_back(dev_name);
+        cp->group.group_size++;
+      }
+    }
+  }
+
+  void RunSubdivPermsTest(
+      CollectiveParams* cp,
+      const std::vector<std::vector<int>>& expected_subdiv_perms,
+      const std::vector<int>& expected_subdiv_rank) {
+    cp->instance.impl_details.subdiv_permutations.clear();
+    cp->subdiv_rank.clear();
+    cp->instance.impl_details.subdiv_source_rank.clear();
+    // Create a stub reducer only for testing param initialization.
+    HierarchicalReducer reducer;
+    reducer.group_size_tensor_ready_.Notify();  // Never blocks in destructor.
+    TF_CHECK_OK(reducer.InitializeCollectiveParams(cp));
+    EXPECT_EQ(expected_subdiv_perms,
+              cp->instance.impl_details.subdiv_permutations);
+    EXPECT_EQ(expected_subdiv_rank, cp->subdiv_rank);
+  }
+};
+
+TEST_F(HierarchicalReducerTest, InitializeParams2Tasks4GPU) {
+  CollectiveParams cp;
+  PrepColParams(&cp, {4, 4});
+
+  // task 0 leader
+  cp.default_rank = 0;
+  RunSubdivPermsTest(&cp, {{0, 4}, {0, 1, 2, 3}, {4, 5, 6, 7}}, {0, 0, -1});
+
+  // task 0 non-leader
+  cp.default_rank = 2;
+  RunSubdivPermsTest(&cp, {{0, 4}, {0, 1, 2, 3}, {4, 5, 6, 7}}, {-1, 2, -1});
+
+  // task 1 leader
+  cp.default_rank = 4;
+  RunSubdivPermsTest(&cp, {{0, 4}, {0, 1, 2, 3}, {4, 5, 6, 7}}, {1, -1, 0});
+}
+
+TEST_F(HierarchicalReducerTest, InitializeParams3TasksVariableGPU) {
+  CollectiveParams cp;
+  PrepColParams(&cp, {2, 4, 3});
+
+  // task 1 leader
+  cp.default_rank = 2;
+  RunSubdivPermsTest(
+      &cp, {{0, 2, 6}, {0, 1}, {2, 3, 4, 5}, {6, 7, 8}}, {1, -1, 0, -1});
+
+  // task 2 non-leader
+  cp.default_rank = 8;
+  RunSubdivPermsTest(
+      &cp, {{0, 2, 6}, {0, 1}, {2, 3, 4, 5}, {6, 7, 8}}, {-1, -1, -1, 2});
+}
+
+TEST_F(HierarchicalReducerTest, InitializeParams1Task8GPU) {
+  CollectiveParams cp;
+  PrepColParams(&cp, {8});
+
+  cp.default_rank = 3;
+  RunSubdivPermsTest(&cp, {{0}, {0, 1, 2, 3, 4, 5, 6, 7}}, {-1, 3});
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/lib/monitoring/sampler.h"
 
 namespace tensorflow {
@@ -61,6 +62,25 @@ auto* tf_data_elements_counter = monitoring::Counter<1>::New(
 auto* tf_data_optimization_counter = monitoring::Counter<1>::New(
     "/tensorflow/data/optimization", "tf.data optimization", "name");
 
+auto* tf_data_iterator_num_elements_gauge = monitoring::Gauge<int64, 1>::New(
+    "/tensorflow/data/iterator/num_elements",
+    "The number of elements a tf.data iterator has produced, as recorded by "
+    "the performance model.",
+    "name");
+
+auto* tf_data_iterator_processing_time_gauge =
+    monitoring::Gauge<int64, 1>::New(
+        "/tensorflow/data/iterator/processing_time_nsecs",
+        "The cumulative self processing time of a tf.data iterator in "
+        "nanoseconds, as recorded by the performance model.",
+        "name");
+
+auto* tf_data_iterator_buffered_bytes_gauge = monitoring::Gauge<int64, 1>::New(
+    "/tensorflow/data/iterator/buffered_bytes",
+    "The number of bytes currently buffered by a tf.data iterator, as "
+    "recorded by the performance model.",
+    "name");
+
 auto* build_graph_calls = monitoring::Counter<0>::New(
     "/tensorflow/core/graph_build_calls",
     "The number of times TensorFlow has created a new client graph. "
@@ -92,6 +112,13 @@ void RecordTFDataElements(const string& name, int64 num_elements) {
   tf_data_elements_counter->GetCell(name)->IncrementBy(num_elements);
 }
 
+void RecordTFDataIteratorMetrics(const string& name, int64 num_elements,
+                                 int64 processing_time, int64 buffered_bytes) {
+  tf_data_iterator_num_elements_gauge->GetCell(name)->Set(num_elements);
+  tf_data_iterator_processing_time_gauge->GetCell(name)->Set(processing_time);
+  tf_data_iterator_buffered_bytes_gauge->GetCell(name)->Set(buffered_bytes);
+}
+
 void RecordTFDataOptimization(const string& name, int64 num_changes) {
   tf_data_optimization_counter->GetCell(name)->IncrementBy(num_changes);
 }
@@ -37,6 +37,14 @@ void RecordTFDataBytesRead(const string& name, int64 num_bytes);
 // The `name` argument identifies the Dataset type (e.g. "Batch" or "Map").
 void RecordTFDataElements(const string& name, int64 num_elements);
 
+// Sets a point-in-time snapshot of the runtime counters of one tf.data
+// iterator, as recorded by the performance model of a ModelDataset.
+//
+// The `name` argument identifies the iterator within its pipeline (e.g.
+// "Iterator::Model::ParallelMap"). `processing_time` is in nanoseconds.
+void RecordTFDataIteratorMetrics(const string& name, int64 num_elements,
+                                 int64 processing_time, int64 buffered_bytes);
+
 // Records the number of independent graph changes resulting from the
 // application of a tf.data optimization.
 //
@@ -89,6 +89,14 @@ class PendingCounts {
     memcpy(bytes_, other.bytes_, other.num_bytes_);
   }
 
+  // Restores all counts to those of "other", which must have the same
+  // layout as the object this instance was copy-constructed from. Lets
+  // callers recycle a PendingCounts without reallocating its storage.
+  void ResetFrom(const PendingCounts& other) {
+    DCHECK_EQ(num_bytes_, other.num_bytes_);
+    memcpy(bytes_, other.bytes_, other.num_bytes_);
+  }
+
   ~PendingCounts() { delete[] bytes_; }
 
   void set_initial_count(Handle h, size_t pending_count) {
@@ -0,0 +1,163 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/placement_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+PlacementCache::PlacementCache() {
+  const char* enabled = getenv("TF_PLACEMENT_CACHE");
+  const char* dir = getenv("TF_PLACEMENT_CACHE_DIR");
+  if (dir != nullptr && dir[0] != '\0') {
+    cache_dir_ = dir;
+    enabled_ = true;
+  } else if (enabled != nullptr && enabled[0] == '1') {
+    enabled_ = true;
+  }
+}
+
+/* static */ PlacementCache* PlacementCache::Global() {
+  static PlacementCache* cache = new PlacementCache;
+  return cache;
+}
+
+/* static */ uint64 PlacementCache::ComputeFingerprint(
+    const Graph& graph, const DeviceSet& devices) {
+  GraphDef graph_def;
+  graph.ToGraphDef(&graph_def);
+  string serialized;
+  graph_def.SerializeToString(&serialized);
+  uint64 fp = Fingerprint64(serialized);
+  // The device set participates in the key: the same graph placed on a
+  // different machine configuration must not hit.
+  std::vector<string> device_names;
+  device_names.reserve(devices.devices().size());
+  for (const Device* d : devices.devices()) {
+    device_names.push_back(d->name());
+  }
+  std::sort(device_names.begin(), device_names.end());
+  for (const string& name : device_names) {
+    fp = FingerprintCat64(fp, Fingerprint64(name));
+  }
+  return fp;
+}
+
+bool PlacementCache::ApplyIfCached(uint64 fingerprint, Graph* graph,
+                                   const DeviceSet& devices) {
+  Assignment assignment;
+  {
+    mutex_lock l(mu_);
+    auto iter = cache_.find(fingerprint);
+    if (iter != cache_.end()) {
+      assignment = iter->second;
+    }
+  }
+  if (assignment.empty() && !cache_dir_.empty()) {
+    if (LoadFromFile(fingerprint, &assignment)) {
+      mutex_lock l(mu_);
+      cache_.emplace(fingerprint, assignment);
+    }
+  }
+  if (assignment.empty()) return false;
+
+  // Validate before mutating the graph: every op node must be covered and
+  // every cached device must exist in this process.
+  for (const Node* node : graph->op_nodes()) {
+    auto iter = assignment.find(node->name());
+    if (iter == assignment.end() ||
+        devices.FindDeviceByName(iter->second) == nullptr) {
+      return false;
+    }
+  }
+  for (Node* node : graph->op_nodes()) {
+    if (!node->has_assigned_device_name()) {
+      node->set_assigned_device_name(assignment[node->name()]);
+    }
+  }
+  VLOG(1) << "Applied cached placement for fingerprint " << fingerprint;
+  return true;
+}
+
+void PlacementCache::Insert(uint64 fingerprint, const Graph& graph) {
+  Assignment assignment;
+  for (const Node* node : graph.op_nodes()) {
+    if (!node->has_assigned_device_name()) return;  // Incomplete placement.
+    assignment[node->name()] = node->assigned_device_name();
+  }
+  {
+    mutex_lock l(mu_);
+    if (!cache_.emplace(fingerprint, assignment).second) {
+      return;  // Already cached; nothing new to persist.
+    }
+  }
+  if (!cache_dir_.empty()) {
+    SaveToFile(fingerprint, assignment);
+  }
+}
+
+string PlacementCache::FileName(uint64 fingerprint) const {
+  return strings::StrCat(cache_dir_, "/placement_", fingerprint, ".txt");
+}
+
+bool PlacementCache::LoadFromFile(uint64 fingerprint,
+                                  Assignment* assignment) {
+  string contents;
+  Status s = ReadFileToString(Env::Default(), FileName(fingerprint),
+                              &contents);
+  if (!s.ok()) return false;
+  for (StringPiece line : str_util::Split(contents, '\n')) {
+    if (line.empty()) continue;
+    std::vector<string> parts = str_util::Split(line, '\t');
+    if (parts.size() != 2) {
+      LOG(WARNING) << "Ignoring malformed placement cache file "
+                   << FileName(fingerprint);
+      assignment->clear();
+      return false;
+    }
+    (*assignment)[parts[0]] = parts[1];
+  }
+  return !assignment->empty();
+}
+
+void PlacementCache::SaveToFile(uint64 fingerprint,
+                                const Assignment& assignment) {
+  string contents;
+  for (const auto& entry : assignment) {
+    strings::StrAppend(&contents, entry.first, "\t", entry.second, "\n");
+  }
+  // Write to a temporary file first so concurrent readers never observe a
+  // partially written assignment.
+  const string file_name = FileName(fingerprint);
+  const string tmp_name = strings::StrCat(file_name, ".tmp.", getpid());
+  Status s = WriteStringToFile(Env::Default(), tmp_name, contents);
+  if (s.ok()) {
+    s = Env::Default()->RenameFile(tmp_name, file_name);
+  }
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to persist placement cache entry: " << s;
+  }
+}
+
+}  // namespace tensorflow
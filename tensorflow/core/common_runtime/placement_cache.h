@@ -0,0 +1,85 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_PLACEMENT_CACHE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_PLACEMENT_CACHE_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "tensorflow/core/common_runtime/device_set.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Caches node->device assignments computed by the Placer, keyed by a
+// fingerprint of the graph plus the device set.  When several sessions (or,
+// with the file-backed mode, several processes) place an identical graph on
+// an identical device set, all but the first skip colocation-graph
+// construction and constraint solving entirely.
+//
+// The in-memory cache is enabled by setting the environment variable
+// TF_PLACEMENT_CACHE=1.  Setting TF_PLACEMENT_CACHE_DIR to a writable
+// directory additionally persists each assignment to a file so that other
+// processes can reuse it.
+class PlacementCache {
+ public:
+  // Returns the process-wide cache.
+  static PlacementCache* Global();
+
+  // True if caching was requested via the environment.
+  bool enabled() const { return enabled_; }
+
+  // Fingerprints "graph" (including any pre-assigned devices) together with
+  // the names of the devices in "devices".
+  static uint64 ComputeFingerprint(const Graph& graph,
+                                   const DeviceSet& devices);
+
+  // If an assignment for "fingerprint" is cached (in memory or on disk) and
+  // every mapped device exists in "devices", assigns the cached device to
+  // every unplaced op node of "graph" and returns true.  Returns false on a
+  // cache miss, leaving "graph" untouched.
+  bool ApplyIfCached(uint64 fingerprint, Graph* graph,
+                     const DeviceSet& devices);
+
+  // Records the assigned devices of "graph" under "fingerprint" and, if a
+  // cache directory is configured, persists them.  Best-effort: failures to
+  // write the file are logged and otherwise ignored.
+  void Insert(uint64 fingerprint, const Graph& graph);
+
+ private:
+  PlacementCache();
+
+  typedef std::unordered_map<string, string> Assignment;
+
+  // Loads a persisted assignment for "fingerprint", if any.
+  bool LoadFromFile(uint64 fingerprint, Assignment* assignment);
+  void SaveToFile(uint64 fingerprint, const Assignment& assignment);
+  string FileName(uint64 fingerprint) const;
+
+  bool enabled_ = false;
+  string cache_dir_;
+
+  mutex mu_;
+  std::unordered_map<uint64, Assignment> cache_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PlacementCache);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_PLACEMENT_CACHE_H_
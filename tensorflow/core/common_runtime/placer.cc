@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/colocation_graph.h"
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/placement_cache.h"
 #include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/function.h"
@@ -111,6 +112,24 @@ Status Placer::Run() {
     }
   }
 
+  // If an identical graph has already been placed on an identical device
+  // set, reuse that assignment and skip constraint solving entirely.
+  PlacementCache* placement_cache = PlacementCache::Global();
+  uint64 placement_fingerprint = 0;
+  if (placement_cache->enabled()) {
+    placement_fingerprint =
+        PlacementCache::ComputeFingerprint(*graph_, *devices_);
+    if (placement_cache->ApplyIfCached(placement_fingerprint, graph_,
+                                       *devices_)) {
+      if (log_device_placement_) {
+        for (Node* node : graph_->op_nodes()) {
+          LogDeviceAssignment(node, log_device_placement_);
+        }
+      }
+      return Status::OK();
+    }
+  }
+
   FunctionStack stack(function_name_);
   ColocationGraph colocation_graph(graph_, stack, flib_def_, devices_,
                                    default_device_, allow_soft_placement_,
@@ -230,6 +249,10 @@ Status Placer::Run() {
   if (VLOG_IS_ON(3)) {
     DumpGraphToFile("placer_output", *graph_, nullptr);
   }
+
+  if (placement_cache->enabled()) {
+    placement_cache->Insert(placement_fingerprint, *graph_);
+  }
   return Status::OK();
 }
 
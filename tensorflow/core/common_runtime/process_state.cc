@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 #include "tensorflow/core/common_runtime/pool_allocator.h"
+#include "tensorflow/core/common_runtime/size_class_allocator.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/tracking_allocator.h"
@@ -74,14 +75,28 @@ Allocator* ProcessState::GetCPUAllocator(int numa_node) {
     if (!status.ok()) {
       LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
     }
+    bool use_size_class_allocator = false;
+    status = ReadBoolFromEnvVar("TF_CPU_ALLOCATOR_USE_SIZE_CLASS", false,
+                                &use_size_class_allocator);
+    if (!status.ok()) {
+      LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
+    }
     Allocator* allocator = nullptr;
     SubAllocator* sub_allocator =
-        (numa_enabled_ || alloc_visitors_defined || use_bfc_allocator)
+        (numa_enabled_ || alloc_visitors_defined || use_bfc_allocator ||
+         use_size_class_allocator)
             ? new BasicCPUAllocator(
                   numa_enabled_ ? numa_node : port::kNUMANoAffinity,
                   cpu_alloc_visitors_, cpu_free_visitors_)
             : nullptr;
-    if (use_bfc_allocator) {
+    if (use_size_class_allocator) {
+      DCHECK(sub_allocator);
+      allocator = new SizeClassAllocator(
+          sub_allocator, 100 /*max_chunks_per_class*/,
+          strings::StrCat("size_class_cpu_", numa_node));
+      VLOG(2) << "Using SizeClassAllocator for ProcessState CPU allocator "
+              << "numa_node=" << numa_node;
+    } else if (use_bfc_allocator) {
       // TODO(reedwm): evaluate whether 64GB by default is the best choice.
       int64 cpu_mem_limit_in_mb = -1;
       Status status = ReadInt64FromEnvVar("TF_CPU_BFC_MEM_LIMIT_IN_MB",
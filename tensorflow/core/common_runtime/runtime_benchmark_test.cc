@@ -0,0 +1,201 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Curated microbenchmarks for the runtime subsystems that dominate session
+// overhead: Run() call overhead, per-node executor dispatch, rendezvous
+// throughput, and BFC allocator contention. Unlike the ad-hoc per-op
+// benchmarks under kernels/, this file is meant to be run as one suite so
+// that builds can be compared against each other.
+//
+// When TEST_REPORT_FILE_PREFIX is set, each benchmark writes a
+// machine-readable BenchmarkEntries protobuf (see util/reporter.h); two
+// such runs can be diffed with util/benchmark_baseline.h to catch
+// regressions before deploying a new build.
+
+#include <vector>
+
+#include "tensorflow/core/common_runtime/bfc_allocator.h"
+#include "tensorflow/core/common_runtime/pool_allocator.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/session.h"
+
+namespace tensorflow {
+namespace {
+
+// Builds a graph with one scalar float placeholder feeding a chain of
+// `chain_length` Identity nodes, and returns the feed/fetch names. All
+// nodes are pinned to CPU so device copies are not part of the
+// measurement.
+void MakeIdentityChainGraph(int chain_length, GraphDef* gdef, string* feed,
+                            string* fetch) {
+  Graph g(OpRegistry::Global());
+  Node* placeholder;
+  TF_CHECK_OK(NodeBuilder(g.NewName("Placeholder"), "Placeholder")
+                  .Attr("shape", TensorShape())
+                  .Attr("dtype", DT_FLOAT)
+                  .Device("/cpu:0")
+                  .Finalize(&g, &placeholder));
+  Node* last = placeholder;
+  for (int i = 0; i < chain_length; ++i) {
+    Node* identity;
+    TF_CHECK_OK(NodeBuilder(g.NewName("Identity"), "Identity")
+                    .Input(last)
+                    .Attr("T", DT_FLOAT)
+                    .Device("/cpu:0")
+                    .Finalize(&g, &identity));
+    last = identity;
+  }
+  g.ToGraphDef(gdef);
+  *feed = placeholder->name() + ":0";
+  *fetch = last->name() + ":0";
+}
+
+void RunSessionChainBenchmark(int iters, int chain_length) {
+  testing::StopTiming();
+
+  GraphDef gdef;
+  string feed;
+  string fetch;
+  MakeIdentityChainGraph(chain_length, &gdef, &feed, &fetch);
+
+  Tensor value(DT_FLOAT, TensorShape());
+  value.flat<float>()(0) = 37.0;
+  const std::vector<std::pair<string, Tensor>> inputs = {{feed, value}};
+  const std::vector<string> outputs = {fetch};
+
+  SessionOptions opts;
+  std::unique_ptr<Session> session(NewSession(opts));
+  TF_CHECK_OK(session->Create(gdef));
+  {
+    // The first run pays for pruning/partitioning; not the object of study.
+    std::vector<Tensor> output_values;
+    TF_CHECK_OK(session->Run(inputs, outputs, {}, &output_values));
+  }
+
+  testing::StartTiming();
+  for (int i = 0; i < iters; ++i) {
+    std::vector<Tensor> output_values;
+    TF_CHECK_OK(session->Run(inputs, outputs, {}, &output_values));
+  }
+  testing::StopTiming();
+  testing::ItemsProcessed(static_cast<int64>(iters) * chain_length);
+}
+
+// Fixed per-Run() overhead: the smallest useful graph.
+void BM_SessionRunOverhead(int iters) { RunSessionChainBenchmark(iters, 1); }
+BENCHMARK(BM_SessionRunOverhead);
+
+// Per-node dispatch cost: long chains make the executor's node scheduling
+// the dominant term.
+void BM_ExecutorDispatchChain(int iters, int chain_length) {
+  RunSessionChainBenchmark(iters, chain_length);
+}
+BENCHMARK(BM_ExecutorDispatchChain)->Arg(16)->Arg(64)->Arg(256);
+
+Rendezvous::ParsedKey MakeRendezvousKey(const string& edge_name) {
+  const string key = Rendezvous::CreateKey(
+      "/job:localhost/replica:0/task:0/cpu:0", 1,
+      "/job:localhost/replica:0/task:0/cpu:1", edge_name, FrameAndIter(0, 0));
+  Rendezvous::ParsedKey parsed;
+  TF_CHECK_OK(Rendezvous::ParseKey(key, &parsed));
+  return parsed;
+}
+
+// Streams `iters` scalar tensors through each of `num_pairs` concurrent
+// producer/consumer pairs sharing one local rendezvous.
+void BM_RendezvousThroughput(int iters, int num_pairs) {
+  testing::StopTiming();
+
+  Rendezvous* rendez = NewLocalRendezvous();
+  std::vector<Rendezvous::ParsedKey> keys;
+  for (int p = 0; p < num_pairs; ++p) {
+    keys.push_back(MakeRendezvousKey(strings::StrCat("edge_", p)));
+  }
+  Tensor value(DT_FLOAT, TensorShape());
+  value.flat<float>()(0) = 37.0;
+
+  thread::ThreadPool pool(Env::Default(), "rendezvous_bench", 2 * num_pairs);
+  BlockingCounter counter(2 * num_pairs);
+
+  testing::StartTiming();
+  for (int p = 0; p < num_pairs; ++p) {
+    pool.Schedule([rendez, &keys, &value, &counter, iters, p]() {
+      Rendezvous::Args args;
+      for (int i = 0; i < iters; ++i) {
+        TF_CHECK_OK(rendez->Send(keys[p], args, value, false));
+      }
+      counter.DecrementCount();
+    });
+    pool.Schedule([rendez, &keys, &counter, iters, p]() {
+      Rendezvous::Args args;
+      Tensor received;
+      bool is_dead = false;
+      for (int i = 0; i < iters; ++i) {
+        TF_CHECK_OK(rendez->Recv(keys[p], args, &received, &is_dead));
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  testing::StopTiming();
+  testing::ItemsProcessed(static_cast<int64>(iters) * num_pairs);
+  rendez->Unref();
+}
+BENCHMARK(BM_RendezvousThroughput)->Arg(1)->Arg(4)->Arg(8);
+
+// Allocate/deallocate churn on a shared BFC allocator from `num_threads`
+// threads. The size mix covers both binned and coalescing paths.
+void BM_BFCAllocatorContention(int iters, int num_threads) {
+  testing::StopTiming();
+
+  BFCAllocator allocator(
+      new BasicCPUAllocator(port::kNUMANoAffinity, {}, {}), 1 << 30,
+      false /* allow_growth */, "bfc_benchmark");
+  thread::ThreadPool pool(Env::Default(), "allocator_bench", num_threads);
+  BlockingCounter counter(num_threads);
+
+  testing::StartTiming();
+  for (int t = 0; t < num_threads; ++t) {
+    pool.Schedule([&allocator, &counter, iters, t]() {
+      static const size_t kSizes[] = {64, 256, 4096, 1 << 16};
+      for (int i = 0; i < iters; ++i) {
+        const size_t size = kSizes[(i + t) % 4];
+        void* ptr = allocator.AllocateRaw(64, size);
+        allocator.DeallocateRaw(ptr);
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  testing::StopTiming();
+  testing::ItemsProcessed(static_cast<int64>(iters) * num_threads);
+}
+BENCHMARK(BM_BFCAllocatorContention)->Arg(1)->Arg(4)->Arg(8);
+
+}  // namespace
+}  // namespace tensorflow
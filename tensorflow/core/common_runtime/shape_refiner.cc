@@ -16,6 +16,8 @@ limitations under the License.
 
 #include <deque>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -327,6 +329,46 @@ Status ShapeRefiner::SetShape(const Node* node, int output_port,
   return Status::OK();
 }
 
+Status ShapeRefiner::UpdateNodeAndFanout(const Node* node, bool relax,
+                                         int* num_refined) {
+  if (num_refined != nullptr) *num_refined = 0;
+
+  // Process the worklist in node-id order, which approximates topological
+  // order for graphs built by the graph constructor, so each node is
+  // typically visited once per wave of changes reaching it.
+  auto by_id = [](const Node* a, const Node* b) { return a->id() < b->id(); };
+  std::set<const Node*, decltype(by_id)> worklist(by_id);
+  worklist.insert(node);
+
+  // Merge/NextIteration cycles can keep re-enqueueing their members; bound
+  // the number of visits per node so refinement always terminates.
+  static constexpr int kMaxVisitsPerNode = 8;
+  std::unordered_map<const Node*, int> visits;
+
+  while (!worklist.empty()) {
+    const Node* n = *worklist.begin();
+    worklist.erase(worklist.begin());
+    if (node_to_context_.find(n) == node_to_context_.end()) {
+      // Never added to this refiner; its fanout cannot depend on our shapes.
+      continue;
+    }
+    if (++visits[n] > kMaxVisitsPerNode) {
+      VLOG(1) << "UpdateNodeAndFanout: visit limit reached for "
+              << n->name();
+      continue;
+    }
+    bool refined = false;
+    TF_RETURN_IF_ERROR(UpdateNode(n, relax, &refined));
+    if (!refined) continue;
+    if (num_refined != nullptr) ++(*num_refined);
+    for (const Edge* e : n->out_edges()) {
+      if (e->IsControlEdge()) continue;
+      worklist.insert(e->dst());
+    }
+  }
+  return Status::OK();
+}
+
 Status ShapeRefiner::UpdateNode(const Node* node, bool relax, bool* refined) {
   auto it = node_to_context_.find(node);
   if (it == node_to_context_.end()) {
@@ -125,6 +125,15 @@ class ShapeRefiner {
   // if <*refined> is set to false.
   Status UpdateNode(const Node* node, bool relax, bool* refined);
 
+  // Re-runs shape inference for 'node' and then, for every node whose shapes
+  // actually changed, for its data fanout (restricted to nodes already added
+  // to this refiner), repeating until the affected subgraph reaches a fixed
+  // point.  This makes an edit to a large graph cost O(affected fanout)
+  // rather than requiring the refiner to be rebuilt from scratch.  If
+  // 'num_refined' is non-null it is set to the number of nodes whose shapes
+  // changed.  'relax' has the same meaning as in UpdateNode().
+  Status UpdateNodeAndFanout(const Node* node, bool relax, int* num_refined);
+
   // Returns the InferenceContext for 'node', if present.
   shape_inference::InferenceContext* GetContext(const Node* node) const {
     auto it = node_to_context_.find(node);
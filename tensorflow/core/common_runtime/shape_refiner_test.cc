@@ -198,6 +198,35 @@ TEST_F(ShapeRefinerTest, SetShape) {
   ASSERT_FALSE(m.SetShape(a.node(), 0, h).ok());
 }
 
+TEST_F(ShapeRefinerTest, UpdateNodeAndFanout) {
+  ShapeRefiner m(TF_GRAPH_DEF_VERSION, OpRegistry::Global());
+
+  Scope root = Scope::NewRootScope();
+  auto a = ops::Placeholder(root, DT_FLOAT);
+  auto b = ops::Identity(root, a);
+  auto c = ops::Identity(root, b);
+  TF_ASSERT_OK(m.AddNode(a.node()));
+  TF_ASSERT_OK(m.AddNode(b.node()));
+  TF_ASSERT_OK(m.AddNode(c.node()));
+  EXPECT_SHAPE("?", m, c, 0);
+
+  // Tighten the placeholder's shape, then re-refine only the affected
+  // fanout: both identities should pick up the new shape.
+  auto ic = m.GetContext(a.node());
+  ASSERT_NE(nullptr, ic);
+  TF_ASSERT_OK(m.SetShape(a.node(), 0, ic->MakeShape({2, 3})));
+
+  int num_refined = 0;
+  TF_ASSERT_OK(m.UpdateNodeAndFanout(b.node(), false, &num_refined));
+  EXPECT_EQ(2, num_refined);
+  EXPECT_SHAPE("[2,3]", m, b, 0);
+  EXPECT_SHAPE("[2,3]", m, c, 0);
+
+  // A second pass is a no-op: the subgraph has reached a fixed point.
+  TF_ASSERT_OK(m.UpdateNodeAndFanout(b.node(), false, &num_refined));
+  EXPECT_EQ(0, num_refined);
+}
+
 namespace {
 
 // An op with no shape function.
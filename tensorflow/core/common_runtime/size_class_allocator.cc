@@ -0,0 +1,161 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/size_class_allocator.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "tensorflow/core/lib/core/bits.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Header stored at the start of every chunk, in front of the pointer
+// handed out to the client.  It occupies a full kAllocatorAlignment so
+// client pointers keep the usual alignment guarantee.
+struct ChunkHeader {
+  size_t requested_bytes;
+  int32 size_class;  // -1 for oversize chunks
+};
+
+static_assert(sizeof(ChunkHeader) <= Allocator::kAllocatorAlignment,
+              "ChunkHeader must fit in kAllocatorAlignment bytes");
+
+const ChunkHeader* HeaderForClientPtr(const void* ptr) {
+  return reinterpret_cast<const ChunkHeader*>(static_cast<const char*>(ptr) -
+                                              Allocator::kAllocatorAlignment);
+}
+
+}  // namespace
+
+SizeClassAllocator::SizeClassAllocator(SubAllocator* sub_allocator,
+                                       size_t max_chunks_per_class,
+                                       const string& name)
+    : sub_allocator_(sub_allocator),
+      max_chunks_per_class_(max_chunks_per_class),
+      name_(name),
+      free_lists_(kNumClasses) {
+  CHECK(sub_allocator_ != nullptr);
+  memset(hits_, 0, sizeof(hits_));
+  memset(misses_, 0, sizeof(misses_));
+}
+
+SizeClassAllocator::~SizeClassAllocator() {
+  mutex_lock l(mu_);
+  for (int cls = 0; cls < kNumClasses; ++cls) {
+    for (void* chunk : free_lists_[cls]) {
+      sub_allocator_->Free(chunk, ClassBytes(cls) + kAllocatorAlignment);
+    }
+  }
+}
+
+int SizeClassAllocator::SizeClassForBytes(size_t num_bytes) {
+  const int log2 = Log2Ceiling64(num_bytes);
+  if (log2 > kMaxClassLog2) return -1;
+  return log2 <= kMinClassLog2 ? 0 : log2 - kMinClassLog2;
+}
+
+void* SizeClassAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  if (num_bytes == 0) return nullptr;
+  CHECK_LE(alignment, static_cast<size_t>(kAllocatorAlignment))
+      << "Alignment larger than kAllocatorAlignment is not supported by "
+      << Name();
+  const int cls = SizeClassForBytes(num_bytes);
+  const size_t chunk_bytes =
+      (cls >= 0 ? ClassBytes(cls) : num_bytes) + kAllocatorAlignment;
+  void* chunk = nullptr;
+  mutex_lock l(mu_);
+  if (cls >= 0) {
+    std::vector<void*>& free_list = free_lists_[cls];
+    if (!free_list.empty()) {
+      chunk = free_list.back();
+      free_list.pop_back();
+      ++hits_[cls];
+    } else {
+      ++misses_[cls];
+    }
+  }
+  if (chunk == nullptr) {
+    chunk = sub_allocator_->Alloc(kAllocatorAlignment, chunk_bytes);
+    if (chunk == nullptr) return nullptr;
+  }
+  ChunkHeader* header = reinterpret_cast<ChunkHeader*>(chunk);
+  header->requested_bytes = num_bytes;
+  header->size_class = cls;
+  const int64 used_bytes = static_cast<int64>(chunk_bytes);
+  ++stats_.num_allocs;
+  stats_.bytes_in_use += used_bytes;
+  stats_.peak_bytes_in_use =
+      std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  stats_.largest_alloc_size =
+      std::max(stats_.largest_alloc_size, static_cast<int64>(num_bytes));
+  return static_cast<char*>(chunk) + kAllocatorAlignment;
+}
+
+void SizeClassAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) return;
+  void* chunk = static_cast<char*>(ptr) - kAllocatorAlignment;
+  const ChunkHeader* header = reinterpret_cast<const ChunkHeader*>(chunk);
+  const int cls = header->size_class;
+  const size_t chunk_bytes =
+      (cls >= 0 ? ClassBytes(cls) : header->requested_bytes) +
+      kAllocatorAlignment;
+  mutex_lock l(mu_);
+  stats_.bytes_in_use -= static_cast<int64>(chunk_bytes);
+  if (cls >= 0 && free_lists_[cls].size() < max_chunks_per_class_) {
+    free_lists_[cls].push_back(chunk);
+  } else {
+    sub_allocator_->Free(chunk, chunk_bytes);
+  }
+}
+
+size_t SizeClassAllocator::RequestedSize(const void* ptr) const {
+  CHECK(ptr != nullptr);
+  return HeaderForClientPtr(ptr)->requested_bytes;
+}
+
+size_t SizeClassAllocator::AllocatedSize(const void* ptr) const {
+  CHECK(ptr != nullptr);
+  const ChunkHeader* header = HeaderForClientPtr(ptr);
+  return header->size_class >= 0 ? ClassBytes(header->size_class)
+                                 : header->requested_bytes;
+}
+
+absl::optional<AllocatorStats> SizeClassAllocator::GetStats() {
+  mutex_lock l(mu_);
+  AllocatorStats stats = stats_;
+  stats.size_class_stats.resize(kNumClasses);
+  for (int cls = 0; cls < kNumClasses; ++cls) {
+    AllocatorStats::SizeClassStats& sc = stats.size_class_stats[cls];
+    sc.class_bytes = static_cast<int64>(ClassBytes(cls));
+    sc.hits = hits_[cls];
+    sc.misses = misses_[cls];
+  }
+  return stats;
+}
+
+void SizeClassAllocator::ClearStats() {
+  mutex_lock l(mu_);
+  stats_.num_allocs = 0;
+  stats_.peak_bytes_in_use = stats_.bytes_in_use;
+  stats_.largest_alloc_size = 0;
+  memset(hits_, 0, sizeof(hits_));
+  memset(misses_, 0, sizeof(misses_));
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,93 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SIZE_CLASS_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SIZE_CLASS_ALLOCATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Pooled allocator that recycles freed chunks in power-of-two size
+// classes, from 64 bytes up to 256KiB; larger requests pass straight
+// through to the backing SubAllocator.
+//
+// Each instance owns a private arena, so subsystems that should not
+// contend on the same free lists (e.g. an input pipeline and a model
+// executor) can be given separate instances.  Per-size-class hit/miss
+// counters are reported through AllocatorStats::size_class_stats.
+class SizeClassAllocator : public Allocator {
+ public:
+  // "sub_allocator" provides the backing memory; this object takes
+  // ownership.  Freed chunks are retained per size class up to
+  // "max_chunks_per_class" entries; further frees are returned to the
+  // sub_allocator.
+  SizeClassAllocator(SubAllocator* sub_allocator, size_t max_chunks_per_class,
+                     const string& name);
+  ~SizeClassAllocator() override;
+
+  string Name() override { return name_; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+
+  void DeallocateRaw(void* ptr) override;
+
+  bool TracksAllocationSizes() const override { return true; }
+
+  size_t RequestedSize(const void* ptr) const override;
+
+  size_t AllocatedSize(const void* ptr) const override;
+
+  absl::optional<AllocatorStats> GetStats() override;
+
+  void ClearStats() override;
+
+  static const int kMinClassLog2 = 6;   // 64 bytes
+  static const int kMaxClassLog2 = 18;  // 256KiB
+  static const int kNumClasses = kMaxClassLog2 - kMinClassLog2 + 1;
+
+ private:
+  // Returns the size class whose chunks hold num_bytes, or -1 if
+  // num_bytes exceeds the largest class.
+  static int SizeClassForBytes(size_t num_bytes);
+
+  // Number of usable bytes in a chunk of the given class.
+  static size_t ClassBytes(int size_class) {
+    return static_cast<size_t>(1) << (size_class + kMinClassLog2);
+  }
+
+  std::unique_ptr<SubAllocator> sub_allocator_;
+  const size_t max_chunks_per_class_;
+  const string name_;
+
+  mutable mutex mu_;
+  std::vector<std::vector<void*>> free_lists_ GUARDED_BY(mu_);
+  int64 hits_[kNumClasses] GUARDED_BY(mu_);
+  int64 misses_[kNumClasses] GUARDED_BY(mu_);
+  AllocatorStats stats_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SizeClassAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SIZE_CLASS_ALLOCATOR_H_
@@ -0,0 +1,94 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/size_class_allocator.h"
+
+#include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// A SubAllocator over AlignedMalloc that counts its calls.
+class CountingSubAllocator : public SubAllocator {
+ public:
+  CountingSubAllocator() : SubAllocator({}, {}) {}
+
+  void* Alloc(size_t alignment, size_t num_bytes) override {
+    ++alloc_count_;
+    return port::AlignedMalloc(num_bytes, alignment);
+  }
+
+  void Free(void* ptr, size_t num_bytes) override {
+    ++free_count_;
+    port::AlignedFree(ptr);
+  }
+
+  int alloc_count_ = 0;
+  int free_count_ = 0;
+};
+
+TEST(SizeClassAllocatorTest, RecyclesBySizeClass) {
+  CountingSubAllocator* sub = new CountingSubAllocator;
+  SizeClassAllocator allocator(sub, 4 /*max_chunks_per_class*/, "test");
+
+  void* p1 = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  ASSERT_NE(p1, nullptr);
+  EXPECT_EQ(100, allocator.RequestedSize(p1));
+  EXPECT_EQ(128, allocator.AllocatedSize(p1));
+  EXPECT_EQ(1, sub->alloc_count_);
+  allocator.DeallocateRaw(p1);
+  EXPECT_EQ(0, sub->free_count_);
+
+  // A same-class allocation must be served from the free list.
+  void* p2 = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 90);
+  EXPECT_EQ(p1, p2);
+  EXPECT_EQ(1, sub->alloc_count_);
+  allocator.DeallocateRaw(p2);
+}
+
+TEST(SizeClassAllocatorTest, OversizePassesThrough) {
+  CountingSubAllocator* sub = new CountingSubAllocator;
+  SizeClassAllocator allocator(sub, 4 /*max_chunks_per_class*/, "test");
+
+  void* p = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 1 << 20);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(1 << 20, allocator.AllocatedSize(p));
+  allocator.DeallocateRaw(p);
+  // Oversize chunks are not pooled.
+  EXPECT_EQ(1, sub->free_count_);
+}
+
+TEST(SizeClassAllocatorTest, ReportsHitsAndMisses) {
+  CountingSubAllocator* sub = new CountingSubAllocator;
+  SizeClassAllocator allocator(sub, 4 /*max_chunks_per_class*/, "test");
+
+  void* p = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 64);
+  allocator.DeallocateRaw(p);
+  p = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 64);
+  allocator.DeallocateRaw(p);
+
+  absl::optional<AllocatorStats> stats = allocator.GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(2, stats->num_allocs);
+  ASSERT_EQ(SizeClassAllocator::kNumClasses, stats->size_class_stats.size());
+  const AllocatorStats::SizeClassStats& sc = stats->size_class_stats[0];
+  EXPECT_EQ(64, sc.class_bytes);
+  EXPECT_EQ(1, sc.hits);
+  EXPECT_EQ(1, sc.misses);
+}
+
+}  // namespace
+}  // namespace tensorflow
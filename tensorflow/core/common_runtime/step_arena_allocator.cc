@@ -0,0 +1,104 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+
+StepArenaAllocator::StepArenaAllocator(Allocator* base, StepArenaPool* pool)
+    : base_(base), pool_(pool), arena_(kArenaBlockSize) {}
+
+StepArenaAllocator::~StepArenaAllocator() {}
+
+string StepArenaAllocator::Name() {
+  return strings::StrCat("step_arena_", base_->Name());
+}
+
+void* StepArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  if (num_bytes == 0 || num_bytes > kMaxArenaAllocation) {
+    return base_->AllocateRaw(alignment, num_bytes);
+  }
+  mutex_lock l(mu_);
+  void* ptr = arena_.AllocAligned(num_bytes, alignment);
+  arena_ptrs_.insert(ptr);
+  return ptr;
+}
+
+void StepArenaAllocator::DeallocateRaw(void* ptr) {
+  bool recycle = false;
+  {
+    mutex_lock l(mu_);
+    auto it = arena_ptrs_.find(ptr);
+    if (it != arena_ptrs_.end()) {
+      arena_ptrs_.erase(it);
+      if (retired_ && arena_ptrs_.empty()) {
+        arena_.Reset();
+        retired_ = false;
+        recycle = true;
+      }
+      ptr = nullptr;
+    }
+  }
+  if (recycle) {
+    pool_->Release(this);
+  } else if (ptr != nullptr) {
+    base_->DeallocateRaw(ptr);
+  }
+}
+
+void StepArenaAllocator::Retire() {
+  bool recycle = false;
+  {
+    mutex_lock l(mu_);
+    if (arena_ptrs_.empty()) {
+      arena_.Reset();
+      recycle = true;
+    } else {
+      // Escaped allocations are still alive; the last DeallocateRaw will
+      // reset the arena and return this allocator to the pool.
+      retired_ = true;
+    }
+  }
+  if (recycle) {
+    pool_->Release(this);
+  }
+}
+
+/* static */ StepArenaPool* StepArenaPool::Global() {
+  static StepArenaPool* pool = new StepArenaPool;
+  return pool;
+}
+
+StepArenaAllocator* StepArenaPool::Acquire(Allocator* base) {
+  {
+    mutex_lock l(mu_);
+    std::vector<StepArenaAllocator*>& idle = idle_[base];
+    if (!idle.empty()) {
+      StepArenaAllocator* allocator = idle.back();
+      idle.pop_back();
+      return allocator;
+    }
+  }
+  return new StepArenaAllocator(base, this);
+}
+
+void StepArenaPool::Release(StepArenaAllocator* allocator) {
+  mutex_lock l(mu_);
+  idle_[allocator->base()].push_back(allocator);
+}
+
+}  // namespace tensorflow
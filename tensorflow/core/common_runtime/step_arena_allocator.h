@@ -0,0 +1,105 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/core/arena.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class StepArenaPool;
+
+// An Allocator that serves small allocations from a chunked Arena
+// (lib/core/arena.h) and defers all reclamation to a wholesale Reset once
+// the owning step has retired and every allocation has been returned, so
+// the per-allocation cost in the common case is a pointer bump under a
+// short critical section.  Allocations above kMaxArenaAllocation pass
+// through to the wrapped device allocator.
+//
+// Deallocations of arena memory return no memory individually.  A tensor
+// that escapes the step (e.g. a temp forwarded to an output and fetched by
+// the client) simply delays recycling of this arena until it is released;
+// correctness never depends on allocations staying inside the step.
+class StepArenaAllocator : public Allocator {
+ public:
+  StepArenaAllocator(Allocator* base, StepArenaPool* pool);
+  ~StepArenaAllocator() override;
+
+  string Name() override;
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+
+  Allocator* base() const { return base_; }
+
+  // Called by the executor when its step finishes.  Once every outstanding
+  // arena allocation has been returned (possibly immediately), the arena is
+  // reset and this allocator hands itself back to its pool for reuse.
+  void Retire();
+
+ private:
+  // Allocations above this size go to the wrapped allocator.
+  static const size_t kMaxArenaAllocation = 32 * 1024;
+  // Block size of the underlying arena.
+  static const size_t kArenaBlockSize = 256 * 1024;
+
+  Allocator* const base_;  // Not owned.
+  StepArenaPool* const pool_;  // Not owned.
+
+  mutex mu_;
+  core::Arena arena_ GUARDED_BY(mu_);
+  // Outstanding arena-served pointers; membership distinguishes arena
+  // memory from pass-through memory in DeallocateRaw.
+  std::unordered_set<void*> arena_ptrs_ GUARDED_BY(mu_);
+  bool retired_ GUARDED_BY(mu_) = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StepArenaAllocator);
+};
+
+// Process-wide pool of StepArenaAllocators, keyed by the wrapped allocator.
+// Pooled allocators are never destroyed: TensorBuffers keep a raw pointer
+// to their allocator, and an arena-served tensor can outlive the session
+// that created it.
+class StepArenaPool {
+ public:
+  static StepArenaPool* Global();
+
+  // Returns an idle allocator wrapping 'base', creating one if none is
+  // available.
+  StepArenaAllocator* Acquire(Allocator* base);
+
+ private:
+  friend class StepArenaAllocator;
+
+  // Called by an allocator once it has been retired and fully drained.
+  void Release(StepArenaAllocator* allocator);
+
+  mutex mu_;
+  std::unordered_map<Allocator*, std::vector<StepArenaAllocator*>> idle_
+      GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
@@ -0,0 +1,171 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_stats_sampler.h"
+
+#include <vector>
+
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/env_time.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+// Pooled, allocation-free NodeExecStatsInterface implementation.  Instances
+// are recycled through a per-thread freelist; Done() emits one POD record.
+class SamplingNodeExecStats : public NodeExecStatsInterface {
+ public:
+  void Reset(const Node* node, int64 step_id) {
+    record_ = StepStatsSampler::Record();
+    record_.node = node;
+    record_.step_id = step_id;
+  }
+
+  void Done(const string& device) override;
+
+  void RecordExecutorStarted() override {
+    record_.start_nanos = Env::Default()->NowNanos();
+  }
+  void RecordComputeStarted() override {}
+  void RecordComputeEnded() override {}
+  void RecordExecutorEnded() override {
+    record_.end_nanos = Env::Default()->NowNanos();
+  }
+  bool TrackAllocations() const override { return false; }
+  void SetMemory(OpKernelContext* ctx) override {}
+  void SetOutput(int slot, const Tensor* tensor) override {}
+  void SetReferencedTensors(const TensorReferenceVector& tensors) override {}
+  void SetScheduled(int64 nanos) override {}
+
+ private:
+  StepStatsSampler::Record record_;
+};
+
+// Per-thread freelist of recycled SamplingNodeExecStats.  Entries may be
+// created on one thread and returned on another; each thread only ever
+// touches its own list.
+thread_local std::vector<SamplingNodeExecStats*>* sampling_stats_pool =
+    nullptr;
+
+SamplingNodeExecStats* AcquireSamplingStats() {
+  if (sampling_stats_pool == nullptr) {
+    sampling_stats_pool = new std::vector<SamplingNodeExecStats*>;
+  }
+  if (sampling_stats_pool->empty()) {
+    return new SamplingNodeExecStats;
+  }
+  SamplingNodeExecStats* stats = sampling_stats_pool->back();
+  sampling_stats_pool->pop_back();
+  return stats;
+}
+
+void SamplingNodeExecStats::Done(const string& device) {
+  StepStatsSampler::Global()->AddRecord(record_);
+  if (sampling_stats_pool == nullptr) {
+    sampling_stats_pool = new std::vector<SamplingNodeExecStats*>;
+  }
+  sampling_stats_pool->push_back(this);
+}
+
+}  // namespace
+
+StepStatsSampler::StepStatsSampler() {
+  const char* env = getenv("TF_STEP_STATS_SAMPLING");
+  int64 rate;
+  if (env != nullptr && strings::safe_strto64(env, &rate) && rate > 0) {
+    sample_rate_ = rate;
+  }
+}
+
+/* static */ StepStatsSampler* StepStatsSampler::Global() {
+  static StepStatsSampler* sampler = new StepStatsSampler;
+  return sampler;
+}
+
+bool StepStatsSampler::ShouldSampleStep() {
+  if (sample_rate_ <= 0) return false;
+  return step_counter_.fetch_add(1, std::memory_order_relaxed) %
+             sample_rate_ ==
+         0;
+}
+
+StepStatsSampler::Ring* StepStatsSampler::ThreadRing() {
+  thread_local Ring* ring = [this]() {
+    Ring* r = new Ring;
+    r->records.resize(kRingSize);
+    mutex_lock l(mu_);
+    registered_rings_.push_back(r);
+    return r;
+  }();
+  return ring;
+}
+
+void StepStatsSampler::AddRecord(const Record& record) {
+  Ring* ring = ThreadRing();
+  ring->records[ring->next % kRingSize] = record;
+  // The write index is advanced after the record so a concurrent
+  // ToStepStats never reads a half-written slot as committed.
+  ++ring->next;
+}
+
+void StepStatsSampler::ToStepStats(int64 step_id, StepStats* step_stats) {
+  std::vector<Ring*> rings;
+  {
+    mutex_lock l(mu_);
+    rings = registered_rings_;
+  }
+  // Group records by device; the sampler does not track devices, so all
+  // records land in a single "sampled" device stats entry.
+  DeviceStepStats* dss = step_stats->add_dev_stats();
+  dss->set_device("/sampled");
+  for (Ring* ring : rings) {
+    const int64 end = ring->next;
+    const int64 begin = std::max<int64>(0, end - kRingSize);
+    for (int64 i = begin; i < end; ++i) {
+      const Record& record = ring->records[i % kRingSize];
+      if (record.node == nullptr) continue;
+      if (step_id >= 0 && record.step_id != step_id) continue;
+      NodeExecStats* ns = dss->add_node_stats();
+      ns->set_node_name(record.node->name());
+      ns->set_all_start_micros(record.start_nanos /
+                               EnvTime::kMicrosToNanos);
+      ns->set_op_end_rel_micros((record.end_nanos - record.start_nanos) /
+                                EnvTime::kMicrosToNanos);
+      ns->set_all_end_rel_micros((record.end_nanos - record.start_nanos) /
+                                 EnvTime::kMicrosToNanos);
+    }
+  }
+}
+
+SamplingStepStatsCollector::SamplingStepStatsCollector(int64 step_id)
+    : step_id_(step_id) {}
+
+SamplingStepStatsCollector::~SamplingStepStatsCollector() {}
+
+NodeExecStatsInterface* SamplingStepStatsCollector::CreateNodeExecStats(
+    const Node* node) {
+  SamplingNodeExecStats* stats = AcquireSamplingStats();
+  stats->Reset(node, step_id_);
+  return stats;
+}
+
+string SamplingStepStatsCollector::ReportAllocsOnResourceExhausted(
+    const string& err) {
+  return "";
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,113 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_SAMPLER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_SAMPLER_H_
+
+#include <atomic>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class Node;
+
+// A low-overhead alternative to the full StepStatsCollector for production
+// use.  Instead of allocating a NodeExecStats proto per node per step, nodes
+// record POD timing entries into preallocated per-thread ring buffers, and
+// only 1-in-N steps are sampled at all.  The records are converted to
+// StepStats lazily, when a client actually fetches them.
+//
+// Enabled by setting TF_STEP_STATS_SAMPLING=N (sample one step out of every
+// N).  DirectSession installs a SamplingStepStatsCollector on sampled steps
+// that have not explicitly requested full tracing.
+class StepStatsSampler {
+ public:
+  // A single timing record.  Fixed-size POD so ring writes never allocate.
+  struct Record {
+    // Owned by the Graph, which outlives the sampler's consumers within a
+    // session; only the pointer is stored.
+    const Node* node = nullptr;
+    int64 step_id = 0;
+    int64 start_nanos = 0;
+    int64 end_nanos = 0;
+  };
+
+  // Returns the process-wide sampler.
+  static StepStatsSampler* Global();
+
+  // True if sampling was requested via the environment.
+  bool enabled() const { return sample_rate_ > 0; }
+
+  // Returns true if the step that calls this should be sampled.  Counts
+  // calls, so exactly one out of every sample_rate steps samples.
+  bool ShouldSampleStep();
+
+  // Appends a record to the calling thread's ring buffer, overwriting the
+  // oldest entry when full.  Thread-safe and allocation-free after the first
+  // call on a given thread.
+  void AddRecord(const Record& record);
+
+  // Converts the currently buffered records for "step_id" (or all records if
+  // "step_id" is -1) into "step_stats".  This is the only expensive call and
+  // is intended to be made off the hot path, when stats are fetched.
+  void ToStepStats(int64 step_id, StepStats* step_stats);
+
+ private:
+  StepStatsSampler();
+
+  static constexpr int kRingSize = 4096;
+
+  struct Ring {
+    std::vector<Record> records;  // Preallocated to kRingSize.
+    int64 next = 0;               // Monotonic write index.
+  };
+
+  // Returns the ring for the calling thread, registering it on first use.
+  Ring* ThreadRing();
+
+  int64 sample_rate_ = 0;
+  std::atomic<int64> step_counter_{0};
+
+  mutex mu_;  // Guards registered_rings_; ring writes themselves are
+              // single-writer (per thread) and unsynchronized by design.
+  std::vector<Ring*> registered_rings_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StepStatsSampler);
+};
+
+// StepStatsCollectorInterface implementation backed by StepStatsSampler.
+// CreateNodeExecStats hands out entries from a preallocated pool instead of
+// heap-allocating per node, and Done() pushes one POD record into the
+// calling thread's ring.
+class SamplingStepStatsCollector : public StepStatsCollectorInterface {
+ public:
+  explicit SamplingStepStatsCollector(int64 step_id);
+  ~SamplingStepStatsCollector() override;
+
+  NodeExecStatsInterface* CreateNodeExecStats(const Node* node) override;
+  string ReportAllocsOnResourceExhausted(const string& err) override;
+
+ private:
+  const int64 step_id_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_SAMPLER_H_
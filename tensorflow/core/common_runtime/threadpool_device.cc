@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/common_runtime/local_device.h"
+#include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/scoped_allocator.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -27,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/types.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
@@ -50,6 +54,27 @@ ThreadPoolDevice::ThreadPoolDevice(const SessionOptions& options,
                                name, DEVICE_CPU, memory_limit, locality)),
       allocator_(allocator),
       scoped_allocator_mgr_(new ScopedAllocatorMgr(name)) {
+  // When NUMA affinity is requested and this device was assigned a node,
+  // give it a node-pinned inter-op pool.  The executor prefers the device
+  // thread pool over the process-wide compute pool, so ops placed on this
+  // device run on threads whose allocations and cache traffic stay on the
+  // device's socket.
+  if (options.config.experimental().use_numa_affinity() &&
+      locality.numa_node() != port::kNUMANoAffinity &&
+      port::NUMANumNodes() > 1) {
+    const int numa_node = locality.numa_node();
+    int num_threads = NumInterOpThreadsFromSessionOptions(options);
+    // Give each node its share of the configured inter-op parallelism.
+    num_threads = std::max(1, num_threads / port::NUMANumNodes());
+    ThreadOptions thread_opts;
+    thread_opts.numa_node = numa_node;
+    numa_inter_op_pool_.reset(new thread::ThreadPool(
+        options.env, thread_opts,
+        strings::StrCat("numa_", numa_node, "_InterOp"), num_threads,
+        !options.config.experimental().disable_thread_spinning(),
+        /*allocator=*/nullptr));
+    set_tensorflow_device_thread_pool(numa_inter_op_pool_.get());
+  }
 #ifdef INTEL_MKL
   // Early return when MKL is disabled
   if (DisableMKL()) return;
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/common_runtime/local_device.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 
 namespace tensorflow {
 
@@ -47,6 +48,9 @@ class ThreadPoolDevice : public LocalDevice {
  private:
   Allocator* allocator_;  // Not owned
   std::unique_ptr<ScopedAllocatorMgr> scoped_allocator_mgr_;
+  // When NUMA affinity is enabled, a node-pinned inter-op pool used by
+  // executors for this device instead of the process-wide compute pool.
+  std::unique_ptr<thread::ThreadPool> numa_inter_op_pool_;
 };
 
 }  // namespace tensorflow
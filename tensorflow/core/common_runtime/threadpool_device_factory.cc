@@ -38,6 +38,11 @@ class ThreadPoolDeviceFactory : public DeviceFactory {
   Status CreateDevices(const SessionOptions& options, const string& name_prefix,
                        std::vector<std::unique_ptr<Device>>* devices) override {
     int num_numa_nodes = port::NUMANumNodes();
+    if (options.config.experimental().use_numa_affinity()) {
+      // Must happen before the first GetCPUAllocator call so that per-node
+      // allocators are created instead of one node-0 allocator.
+      ProcessState::singleton()->EnableNUMA();
+    }
     int n = 1;
     auto iter = options.config.device_count().find("CPU");
     if (iter != options.config.device_count().end()) {
@@ -0,0 +1,136 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/eager/remote_op_batcher.h"
+
+#include <utility>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+
+namespace tensorflow {
+namespace eager {
+
+namespace {
+
+// Upper bound on the number of QueueItems a single batch may carry, to keep
+// individual EnqueueRequests from growing without limit under very long
+// bursts.
+const int kMaxRemoteOpsPerBatch = 64;
+
+}  // namespace
+
+RemoteOpBatch::RemoteOpBatch(RemoteOpBatcher* batcher, EagerClient* client,
+                             uint64 context_id)
+    : batcher_(batcher), client_(client), context_id_(context_id) {
+  request_.set_context_id(context_id);
+}
+
+RemoteOpBatch::~RemoteOpBatch() {
+  mutex_lock l(mu_);
+  Status status =
+      sent_ ? rpc_status_
+            : errors::Cancelled(
+                  "Remote op batch was destroyed before it was sent.");
+  if (status.ok()) {
+    status = errors::Internal("Remote op batch item was never run.");
+  }
+  QueueResponse empty;
+  for (auto& done : item_done_) {
+    if (done) {
+      done(status, empty);
+      done = nullptr;
+    }
+  }
+}
+
+Status RemoteOpBatch::RunItem(int index) {
+  // Make sure no further items join once we start sending. Later RunItem
+  // calls for items of this batch make this a no-op.
+  batcher_->Retire(this);
+  mutex_lock l(mu_);
+  if (!sent_) {
+    sent_ = true;
+    Status rpc_status;
+    Notification n;
+    client_->EnqueueAsync(&request_, &response_,
+                          [&rpc_status, &n](const Status& status) {
+                            rpc_status = status;
+                            n.Notify();
+                          });
+    n.WaitForNotification();
+    rpc_status_ = rpc_status;
+  }
+  if (index < 0 || index >= static_cast<int>(item_done_.size())) {
+    return errors::Internal("Remote op batch item index ", index,
+                            " out of range.");
+  }
+  if (item_done_[index]) {
+    QueueResponse empty;
+    const QueueResponse& item_response =
+        (rpc_status_.ok() && index < response_.queue_response_size())
+            ? response_.queue_response(index)
+            : empty;
+    item_done_[index](rpc_status_, item_response);
+    item_done_[index] = nullptr;
+  }
+  return rpc_status_;
+}
+
+std::shared_ptr<RemoteOpBatch> RemoteOpBatcher::Append(
+    EagerClient* client, uint64 context_id, QueueItem item,
+    RemoteOpBatch::ItemDoneCallback done, int* index) {
+  while (true) {
+    std::shared_ptr<RemoteOpBatch> batch;
+    {
+      mutex_lock l(mu_);
+      std::shared_ptr<RemoteOpBatch>& open_batch =
+          open_batches_[std::make_pair(client, context_id)];
+      if (open_batch == nullptr) {
+        open_batch.reset(new RemoteOpBatch(this, client, context_id));
+      }
+      batch = open_batch;
+    }
+    bool full = false;
+    {
+      mutex_lock l(batch->mu_);
+      if (batch->sent_) {
+        // The batch was sealed between the lookup above and here; try again
+        // with a fresh one.
+        continue;
+      }
+      *index = batch->request_.queue_size();
+      *batch->request_.add_queue() = std::move(item);
+      batch->item_done_.push_back(std::move(done));
+      full = batch->request_.queue_size() >= kMaxRemoteOpsPerBatch;
+    }
+    if (full) {
+      Retire(batch.get());
+    }
+    return batch;
+  }
+}
+
+void RemoteOpBatcher::Retire(const RemoteOpBatch* batch) {
+  mutex_lock l(mu_);
+  auto it = open_batches_.find(
+      std::make_pair(batch->client_, batch->context_id_));
+  if (it != open_batches_.end() && it->second.get() == batch) {
+    open_batches_.erase(it);
+  }
+}
+
+}  // namespace eager
+}  // namespace tensorflow
@@ -0,0 +1,134 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EAGER_REMOTE_OP_BATCHER_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EAGER_REMOTE_OP_BATCHER_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/eager/eager_executor.h"
+#include "tensorflow/core/distributed_runtime/eager/eager_client.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/eager_service.pb.h"
+
+namespace tensorflow {
+namespace eager {
+
+class RemoteOpBatcher;
+
+// One batch of QueueItems bound for a single worker, shared by the executor
+// nodes of its items (see RemoteOpBatcher below).
+class RemoteOpBatch {
+ public:
+  // Invoked with an item's QueueResponse once the batch RPC has completed.
+  // If the RPC failed (or the batch is abandoned without running), the
+  // response is empty and the status carries the error.
+  typedef std::function<void(const Status&, const QueueResponse&)>
+      ItemDoneCallback;
+
+  // Items whose nodes never ran (e.g. the executor swept them away after an
+  // error) still get their callbacks, so the resources they hold are
+  // released.
+  ~RemoteOpBatch();
+
+  // Called by each item's executor node, in queue order. The first call
+  // seals the batch and performs the Enqueue RPC inline; later calls
+  // complete from the stored response without a round trip. Runs the item's
+  // callback before returning.
+  Status RunItem(int index);
+
+ private:
+  friend class RemoteOpBatcher;
+
+  RemoteOpBatch(RemoteOpBatcher* batcher, EagerClient* client,
+                uint64 context_id);
+
+  RemoteOpBatcher* const batcher_;
+  EagerClient* const client_;  // Not owned; must outlive this batch.
+  const uint64 context_id_;
+
+  mutex mu_;
+  EnqueueRequest request_ GUARDED_BY(mu_);
+  // Entries are reset after their callback has run.
+  std::vector<ItemDoneCallback> item_done_ GUARDED_BY(mu_);
+  // True once the batch RPC has been issued; no more items may join.
+  bool sent_ GUARDED_BY(mu_) = false;
+  Status rpc_status_ GUARDED_BY(mu_);
+  EnqueueResponse response_ GUARDED_BY(mu_);
+};
+
+// Coalesces async remote eager op dispatch into batched Enqueue RPCs.
+//
+// Every remote op (and handle decref) still gets its own EagerNode, so ids,
+// waiting and error propagation work exactly as with one RPC per op, but
+// instead of owning a private EnqueueRequest the node joins the open batch
+// for its target worker. The first node of a batch to reach the front of
+// the executor queue seals it and sends every item accumulated so far in
+// one request; the nodes queued behind it find their item already answered
+// and complete immediately. While that RPC is in flight the next batch
+// accumulates behind it, so a burst of N consecutive remote ops costs a
+// couple of round trips instead of N. Batches also seal once they hold
+// kMaxRemoteOpsPerBatch items. Because batches are only ever sent from the
+// executor queue, cross-batch ordering at the worker matches execution
+// order, which dependent ops rely on.
+class RemoteOpBatcher {
+ public:
+  // Appends `item` to the open batch for (client, context_id), opening a
+  // new one if needed, and returns that batch; *index is the item's
+  // position in it. The caller creates a RemoteOpBatchNode with the
+  // returned batch and index and adds it to the executor. `done` may be
+  // nullptr.
+  std::shared_ptr<RemoteOpBatch> Append(EagerClient* client, uint64 context_id,
+                                        QueueItem item,
+                                        RemoteOpBatch::ItemDoneCallback done,
+                                        int* index);
+
+ private:
+  friend class RemoteOpBatch;
+
+  // Stops handing out `batch`: later Appends for its worker open a new one.
+  // No-op if the batch has already been retired.
+  void Retire(const RemoteOpBatch* batch);
+
+  mutex mu_;
+  std::map<std::pair<EagerClient*, uint64>, std::shared_ptr<RemoteOpBatch>>
+      open_batches_ GUARDED_BY(mu_);
+};
+
+// EagerNode representing one item of a RemoteOpBatch.
+class RemoteOpBatchNode : public tensorflow::EagerNode {
+ public:
+  RemoteOpBatchNode(tensorflow::uint64 id, std::shared_ptr<RemoteOpBatch> batch,
+                    int index)
+      : tensorflow::EagerNode(id), batch_(std::move(batch)), index_(index) {}
+
+  tensorflow::Status Run() override { return batch_->RunItem(index_); }
+
+ private:
+  std::shared_ptr<RemoteOpBatch> batch_;
+  const int index_;
+};
+
+}  // namespace eager
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EAGER_REMOTE_OP_BATCHER_H_
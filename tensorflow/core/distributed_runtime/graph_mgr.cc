@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/graph_mgr.h"
 
 #include <chrono>  // NOLINT(build/c++11)
+#include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/build_graph_options.h"
@@ -66,8 +68,74 @@ GraphMgr::GraphMgr(const WorkerEnv* worker_env, DeviceMgr* device_mgr)
   }
 }
 
+namespace {
+// Upper bound on the number of idle StepState objects retained for reuse.
+const int kStepStatePoolLimit = 128;
+
+// When true (the default), registering a graph that contains collective ops
+// also kicks off resolution of their params, so the round trips to the group
+// leader overlap registration instead of serializing into the first step.
+bool PreResolveCollectivesEnabled() {
+  static const bool enabled = []() {
+    bool value = true;
+    Status status =
+        ReadBoolFromEnvVar("TF_COLLECTIVE_PRERESOLVE_PARAMS", true, &value);
+    if (!status.ok()) {
+      LOG(ERROR) << "Invalid TF_COLLECTIVE_PRERESOLVE_PARAMS: " << status;
+    }
+    return value;
+  }();
+  return enabled;
+}
+}  // namespace
+
+// Scaffolding allocated for every executed step.  The step container is
+// scoped to the pooled object rather than to the step id, and is cleared
+// every time the state is released, so reuse never leaks resources from one
+// step into the next.
+struct GraphMgr::StepState {
+  StepState(int64 id, DeviceMgr* device_mgr)
+      : step_container(
+            id,
+            [device_mgr](const string& name) {
+              device_mgr->ClearContainers({name});
+            },
+            "graph_mgr") {}
+
+  ScopedStepContainer step_container;
+
+  // Staging buffers for the tensors sent into the step's rendezvous.
+  std::vector<string> keys;
+  std::vector<Tensor> tensors_to_send;
+};
+
 GraphMgr::~GraphMgr() {
   for (auto p : table_) p.second->Unref();
+  for (StepState* state : step_state_pool_) delete state;
+}
+
+GraphMgr::StepState* GraphMgr::GetStepState() {
+  mutex_lock l(mu_);
+  if (!step_state_pool_.empty()) {
+    StepState* state = step_state_pool_.back();
+    step_state_pool_.pop_back();
+    return state;
+  }
+  return new StepState(next_step_state_id_++, device_mgr_);
+}
+
+void GraphMgr::ReleaseStepState(StepState* state) {
+  // Clear anything the step left in its container before the scaffolding
+  // can be handed to another step.
+  device_mgr_->ClearContainers({state->step_container.name()});
+  state->keys.clear();
+  state->tensors_to_send.clear();
+  mutex_lock l(mu_);
+  if (step_state_pool_.size() < kStepStatePoolLimit) {
+    step_state_pool_.push_back(state);
+  } else {
+    delete state;
+  }
 }
 
 GraphMgr::Item::~Item() {
@@ -290,6 +358,100 @@ Status GraphMgr::InitItem(const string& handle, const GraphDef& gdef,
   return Status::OK();
 }
 
+void GraphMgr::PreResolveCollectiveParams(Item* item) {
+  ParamResolverInterface* resolver =
+      worker_env_->collective_executor_mgr->GetParamResolver();
+  if (resolver == nullptr) return;
+  // The resolver caches groups and instances persistently, so everything
+  // warmed here is still resolved when the ops execute, across all steps
+  // of the graph.  The warmup calls are fire-and-forget: a failure here
+  // will be rediscovered and reported by the op itself.
+  auto cancel_mgr = std::make_shared<CancellationManager>();
+  // Group keys warmed for ops whose instance cannot be pre-resolved.
+  std::unordered_set<int32> warmed_groups;
+  for (const ExecutionUnit& unit : item->units) {
+    const string& device_name = unit.device->name();
+    for (const Node* node : unit.graph->nodes()) {
+      const string& op = node->type_string();
+      const bool is_bcast_send = op == "CollectiveBcastSend";
+      const bool is_bcast = is_bcast_send || op == "CollectiveBcastRecv";
+      if (!is_bcast && op != "CollectiveReduce" && op != "CollectiveGather") {
+        continue;
+      }
+      int32 group_size;
+      int32 group_key;
+      int32 instance_key;
+      Status s = GetNodeAttr(node->attrs(), "group_size", &group_size);
+      s.Update(GetNodeAttr(node->attrs(), "group_key", &group_key));
+      s.Update(GetNodeAttr(node->attrs(), "instance_key", &instance_key));
+      if (!s.ok()) {
+        VLOG(1) << "Skipping collective param pre-resolution for "
+                << node->name() << ": " << s;
+        continue;
+      }
+      if (is_bcast) {
+        // Broadcast ops declare their shape as an attr, so the full
+        // instance params can be resolved ahead of execution.  The calls
+        // are idempotent with the resolution the op performs later.
+        CollectiveParams* cp = new CollectiveParams;
+        cp->name = node->name();
+        cp->group.group_size = group_size;
+        cp->group.group_key = group_key;
+        cp->group.device_type = DeviceType(unit.device->device_type());
+        cp->instance.type = BROADCAST_COLLECTIVE;
+        cp->instance.instance_key = instance_key;
+        cp->instance.impl_details.subdiv_offsets = {0};
+        cp->is_source = is_bcast_send;
+        s = GetNodeAttr(node->attrs(), "T", &cp->instance.data_type);
+        s.Update(GetNodeAttr(node->attrs(), "shape", &cp->instance.shape));
+        if (!s.ok()) {
+          VLOG(1) << "Skipping collective param pre-resolution for "
+                  << node->name() << ": " << s;
+          delete cp;
+          continue;
+        }
+        VLOG(1) << "Pre-resolving collective params for " << node->name()
+                << " group " << group_key << " instance " << instance_key;
+        resolver->CompleteParamsAsync(
+            device_name, cp, cancel_mgr.get(),
+            [cp, cancel_mgr](const Status& s) {
+              if (!s.ok()) {
+                VLOG(1) << "Collective param pre-resolution for " << cp->name
+                        << " failed: " << s;
+              }
+              delete cp;
+            });
+      } else {
+        // Reduce and gather shapes are only known from the runtime input,
+        // and the first resolution of an instance fixes the shape every
+        // other rank sees, so only the group is warmed for them here.
+        if (!warmed_groups.insert(group_key).second) continue;
+        CompleteGroupRequest* req = new CompleteGroupRequest;
+        CompleteGroupResponse* resp = new CompleteGroupResponse;
+        req->set_group_key(group_key);
+        req->set_group_size(group_size);
+        req->set_device_type(unit.device->device_type());
+        req->add_device_name(device_name);
+        req->set_collective_type(op == "CollectiveReduce"
+                                     ? REDUCTION_COLLECTIVE
+                                     : GATHER_COLLECTIVE);
+        VLOG(1) << "Pre-resolving collective group " << group_key << " for "
+                << node->name();
+        resolver->CompleteGroupAsync(
+            req, resp, cancel_mgr.get(),
+            [req, resp, cancel_mgr](const Status& s) {
+              if (!s.ok()) {
+                VLOG(1) << "Collective group pre-resolution for group "
+                        << req->group_key() << " failed: " << s;
+              }
+              delete req;
+              delete resp;
+            });
+      }
+    }
+  }
+}
+
 Status GraphMgr::Register(const string& handle, const GraphDef& gdef,
                           WorkerSession* session,
                           const GraphOptions& graph_options,
@@ -312,6 +474,10 @@ Status GraphMgr::Register(const string& handle, const GraphDef& gdef,
     item->handle = *graph_handle;
     CHECK(table_.insert({*graph_handle, item}).second);
   }
+  if (item->collective_graph_key != BuildGraphOptions::kNoCollectiveGraphKey &&
+      PreResolveCollectivesEnabled()) {
+    PreResolveCollectiveParams(item);
+  }
   return Status::OK();
 }
 
@@ -458,11 +624,13 @@ void GraphMgr::ExecuteAsync(const string& handle, const int64 step_id,
                 worker_env_->collective_executor_mgr->FindOrCreate(step_id),
                 true)
           : nullptr;
+  StepState* step_state = GetStepState();
+
   // Sends values specified by the caller.
   size_t input_size = 0;
   if (s.ok()) {
-    std::vector<string> keys;
-    std::vector<Tensor> tensors_to_send;
+    std::vector<string>& keys = step_state->keys;
+    std::vector<Tensor>& tensors_to_send = step_state->tensors_to_send;
     keys.reserve(in.size());
     tensors_to_send.reserve(in.size());
     for (auto& p : in) {
@@ -479,11 +647,13 @@ void GraphMgr::ExecuteAsync(const string& handle, const int64 step_id,
     delete ce_handle;
     item->Unref();
     rendezvous->Unref();
+    ReleaseStepState(step_state);
     return;
   }
 
-  StartParallelExecutors(handle, step_id, item, rendezvous, ce_handle,
-                         collector, cost_graph, cancellation_manager, session,
+  StartParallelExecutors(handle, step_id, item, step_state, rendezvous,
+                         ce_handle, collector, cost_graph, cancellation_manager,
+                         session,
                          [item, rendezvous, ce_handle, done, start_time_usecs,
                           input_size, activity](const Status& s) {
                            done(s);
@@ -498,23 +668,22 @@ void GraphMgr::ExecuteAsync(const string& handle, const int64 step_id,
 }
 
 void GraphMgr::StartParallelExecutors(
-    const string& handle, int64 step_id, Item* item, Rendezvous* rendezvous,
-    CollectiveExecutor::Handle* ce_handle, StepStatsCollector* collector,
-    CostGraphDef* cost_graph, CancellationManager* cancellation_manager,
-    WorkerSession* session, StatusCallback done) {
+    const string& handle, int64 step_id, Item* item, StepState* step_state,
+    Rendezvous* rendezvous, CollectiveExecutor::Handle* ce_handle,
+    StepStatsCollector* collector, CostGraphDef* cost_graph,
+    CancellationManager* cancellation_manager, WorkerSession* session,
+    StatusCallback done) {
   const int num_units = item->units.size();
   CHECK_GE(num_units, 1);
-  ScopedStepContainer* step_container = new ScopedStepContainer(
-      step_id,
-      [this](const string& name) { device_mgr_->ClearContainers({name}); });
+  ScopedStepContainer* step_container = &step_state->step_container;
   // NOTE: Transfer one ref of rendezvous and item.
   ExecutorBarrier* barrier =
       new ExecutorBarrier(num_units, rendezvous,
-                          [this, item, collector, cost_graph, step_container,
+                          [this, item, collector, cost_graph, step_state,
                            done](const Status& s) {
                             BuildCostModel(item, collector, cost_graph);
                             done(s);
-                            delete step_container;
+                            ReleaseStepState(step_state);
                           });
   Executor::Args args;
   args.step_id = step_id;
@@ -143,6 +143,11 @@ class GraphMgr {
     int64 collective_graph_key;
   };
 
+  // Per-step execution scaffolding.  ExecuteAsync would otherwise allocate
+  // this fresh for every step, which shows up as allocator pressure at high
+  // step rates, so released instances are recycled through a free list.
+  struct StepState;
+
   const WorkerEnv* worker_env_;  // Not owned.
   DeviceMgr* device_mgr_;
 
@@ -151,6 +156,8 @@ class GraphMgr {
   // Owned.
   mutex mu_;
   int64 next_id_ GUARDED_BY(mu_) = 0;
+  int64 next_step_state_id_ GUARDED_BY(mu_) = 0;
+  std::vector<StepState*> step_state_pool_ GUARDED_BY(mu_);
 
   // If true, blocks until device has finished all queued operations in a step.
   bool sync_on_finish_ = true;
@@ -163,13 +170,25 @@ class GraphMgr {
   std::unordered_map<string, Item*> table_;
 
   void StartParallelExecutors(const string& handle, int64 step_id, Item* item,
-                              Rendezvous* rendezvous,
+                              StepState* step_state, Rendezvous* rendezvous,
                               CollectiveExecutor::Handle* ce_handle,
                               StepStatsCollector* collector,
                               CostGraphDef* cost_graph,
                               CancellationManager* cancellation_manager,
                               WorkerSession* session, StatusCallback done);
 
+  // Returns a StepState, reusing a pooled one when available.
+  StepState* GetStepState();
+  // Clears the per-step contents of *state and returns it to the pool.
+  void ReleaseStepState(StepState* state);
+
+  // Kicks off asynchronous resolution of the collective params of every
+  // collective op in item's partitions, so that the group and instance
+  // resolution round trips to the group leader overlap graph registration
+  // instead of stalling the first step.  Fire-and-forget; results land in
+  // the param resolver's persistent caches.
+  void PreResolveCollectiveParams(Item* item);
+
   // Don't attempt to process cost models unless explicitly requested for at
   // least one of the items.
   bool skip_cost_models_ = true;
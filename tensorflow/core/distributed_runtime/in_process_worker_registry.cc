@@ -0,0 +1,46 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/distributed_runtime/in_process_worker_registry.h"
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+InProcessWorkerRegistry* InProcessWorkerRegistry::Global() {
+  static InProcessWorkerRegistry* registry = new InProcessWorkerRegistry;
+  return registry;
+}
+
+void InProcessWorkerRegistry::Register(const string& target,
+                                       WorkerInterface* worker) {
+  mutex_lock l(mu_);
+  if (!workers_.insert({target, worker}).second) {
+    LOG(WARNING) << "Worker " << target << " is already registered; two "
+                 << "servers in this process are serving the same task.";
+  }
+}
+
+void InProcessWorkerRegistry::Deregister(const string& target) {
+  mutex_lock l(mu_);
+  workers_.erase(target);
+}
+
+WorkerInterface* InProcessWorkerRegistry::Lookup(const string& target) {
+  mutex_lock l(mu_);
+  auto it = workers_.find(target);
+  return it == workers_.end() ? nullptr : it->second;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,59 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_IN_PROCESS_WORKER_REGISTRY_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_IN_PROCESS_WORKER_REGISTRY_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class WorkerInterface;
+
+// A process-wide registry of the workers hosted by servers running in this
+// process, keyed by their "/job:X/replica:Y/task:Z" name. When several tasks
+// of a cluster are co-located in one process, the worker cache can use the
+// registry to exchange tensors between them through direct WorkerInterface
+// calls, skipping serialization and the loopback network entirely.
+//
+// Servers register their worker when they start serving and must deregister
+// it before the worker is destroyed. Registered workers are not owned by the
+// registry.
+class InProcessWorkerRegistry {
+ public:
+  static InProcessWorkerRegistry* Global();
+
+  void Register(const string& target, WorkerInterface* worker);
+  void Deregister(const string& target);
+
+  // Returns the worker registered for "target", or nullptr.
+  WorkerInterface* Lookup(const string& target);
+
+ private:
+  InProcessWorkerRegistry() {}
+
+  mutex mu_;
+  std::unordered_map<string, WorkerInterface*> workers_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(InProcessWorkerRegistry);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_IN_PROCESS_WORKER_REGISTRY_H_
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/master_session.h"
 
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -46,6 +47,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
@@ -55,9 +57,144 @@ limitations under the License.
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+// Tracks which graph partitions are already registered on which workers,
+// keyed by a fingerprint of the partition GraphDef.  When a new feed/fetch
+// signature produces a partition whose content is identical to one already
+// registered, the existing graph handle is reused and no RegisterGraph RPC
+// is issued for it.  Handles no longer referenced by any ReffedClientGraph
+// are retained in an LRU list of bounded size so that a client rotating
+// through a working set of signatures does not re-pay registration; they
+// are deregistered only upon eviction.
+class MasterSession::GraphRegistrationCache {
+ public:
+  GraphRegistrationCache(WorkerCacheInterface* worker_cache,
+                         const string& session_handle,
+                         bool create_worker_session_called, int64 capacity)
+      : worker_cache_(worker_cache),
+        session_handle_(session_handle),
+        create_worker_session_called_(create_worker_session_called),
+        capacity_(capacity) {}
+
+  ~GraphRegistrationCache() {
+    mutex_lock l(mu_);
+    // Any remaining unreferenced handles are deregistered here.  Entries
+    // still holding references are deregistered by their owners' workers
+    // going away with the worker session.
+    for (auto& it : entries_) {
+      if (it.second.refs == 0 && it.second.deregister_on_evict) {
+        DeregisterLocked(it.second);
+      }
+    }
+  }
+
+  // If a graph with `fingerprint` is already registered on `worker_name`,
+  // acquires a reference to it, sets *graph_handle and returns true.
+  bool Lookup(const string& worker_name, uint64 fingerprint,
+              string* graph_handle) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(Key(worker_name, fingerprint));
+    if (it == entries_.end()) return false;
+    if (it->second.refs == 0) {
+      lru_.erase(it->second.lru_pos);
+    }
+    ++it->second.refs;
+    *graph_handle = it->second.graph_handle;
+    VLOG(1) << "Reusing graph handle " << it->second.graph_handle << " on "
+            << worker_name << " for fingerprint " << fingerprint;
+    return true;
+  }
+
+  // Records a newly registered graph handle with one reference.  Returns
+  // false without taking ownership of the handle if the fingerprint is
+  // already present, e.g. because a concurrent registration beat us to it.
+  bool Insert(const string& worker_name, uint64 fingerprint,
+              const string& graph_handle, bool deregister_on_evict) {
+    mutex_lock l(mu_);
+    auto result = entries_.emplace(Key(worker_name, fingerprint), Entry());
+    if (!result.second) return false;
+    Entry& entry = result.first->second;
+    entry.worker_name = worker_name;
+    entry.fingerprint = fingerprint;
+    entry.graph_handle = graph_handle;
+    entry.deregister_on_evict = deregister_on_evict;
+    entry.refs = 1;
+    return true;
+  }
+
+  // Releases one reference.  An unreferenced handle stays registered until
+  // evicted by more recently released handles.
+  void Release(const string& worker_name, uint64 fingerprint) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(Key(worker_name, fingerprint));
+    if (it == entries_.end()) return;
+    DCHECK_GT(it->second.refs, 0);
+    if (--it->second.refs > 0) return;
+    lru_.push_front(&it->second);
+    it->second.lru_pos = lru_.begin();
+    while (static_cast<int64>(lru_.size()) > capacity_) {
+      Entry* oldest = lru_.back();
+      lru_.pop_back();
+      if (oldest->deregister_on_evict) {
+        DeregisterLocked(*oldest);
+      }
+      entries_.erase(Key(oldest->worker_name, oldest->fingerprint));
+    }
+  }
+
+ private:
+  struct Entry {
+    string worker_name;
+    uint64 fingerprint = 0;
+    string graph_handle;
+    bool deregister_on_evict = true;
+    int refs = 0;
+    std::list<Entry*>::iterator lru_pos;
+  };
+
+  static string Key(const string& worker_name, uint64 fingerprint) {
+    return strings::StrCat(worker_name, ":", fingerprint);
+  }
+
+  // Issues a fire-and-forget DeregisterGraph for entry's handle.
+  void DeregisterLocked(const Entry& entry) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    WorkerInterface* w = worker_cache_->CreateWorker(entry.worker_name);
+    if (w == nullptr) return;
+    struct Call {
+      DeregisterGraphRequest req;
+      DeregisterGraphResponse resp;
+    };
+    Call* c = new Call;
+    c->req.set_session_handle(session_handle_);
+    c->req.set_create_worker_session_called(create_worker_session_called_);
+    c->req.set_graph_handle(entry.graph_handle);
+    WorkerCacheInterface* worker_cache = worker_cache_;
+    const string name = entry.worker_name;
+    auto cb = [worker_cache, c, name, w](const Status& s) {
+      if (!s.ok()) {
+        // This error is potentially benign, so we don't log at the
+        // error level.
+        LOG(INFO) << "DeregisterGraph error: " << s;
+      }
+      delete c;
+      worker_cache->ReleaseWorker(name, w);
+    };
+    w->DeregisterGraphAsync(&c->req, &c->resp, cb);
+  }
+
+  WorkerCacheInterface* const worker_cache_;  // Not owned.
+  const string session_handle_;
+  const bool create_worker_session_called_;
+  const int64 capacity_;
+  mutex mu_;
+  std::unordered_map<string, Entry> entries_ GUARDED_BY(mu_);
+  // Unreferenced entries, most recently released first.
+  std::list<Entry*> lru_ GUARDED_BY(mu_);
+};
+
 // MasterSession wraps ClientGraph in a reference counted object.
 // This way, MasterSession can clear up the cache mapping Run requests to
 // compiled graphs while the compiled graph is still being used.
@@ -70,7 +207,8 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
                     const SessionOptions& session_opts,
                     const StatsPublisherFactory& stats_publisher_factory,
                     bool is_partial, WorkerCacheInterface* worker_cache,
-                    bool should_deregister)
+                    bool should_deregister,
+                    std::shared_ptr<GraphRegistrationCache> registration_cache)
       : session_handle_(handle),
         bg_opts_(bopts),
         client_graph_before_register_(std::move(client_graph)),
@@ -79,6 +217,7 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
         callable_opts_(bopts.callable_options),
         worker_cache_(worker_cache),
         should_deregister_(should_deregister),
+        registration_cache_(std::move(registration_cache)),
         collective_graph_key_(
             client_graph_before_register_->collective_graph_key) {
     VLOG(1) << "Created ReffedClientGraph for node with "
@@ -96,15 +235,7 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
     }
   }
 
-  ~ReffedClientGraph() override {
-    if (should_deregister_) {
-      DeregisterPartitions();
-    } else {
-      for (Part& part : partitions_) {
-        worker_cache_->ReleaseWorker(part.name, part.worker);
-      }
-    }
-  }
+  ~ReffedClientGraph() override { DeregisterPartitions(); }
 
   const CallableOptions& callable_options() { return callable_opts_; }
 
@@ -243,6 +374,7 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
   std::unordered_map<string, NodeDetails> name_to_node_details_;
 
   const bool should_deregister_;
+  const std::shared_ptr<GraphRegistrationCache> registration_cache_;
   const int64 collective_graph_key_;
   std::atomic<int64> execution_count_ = {0};
 
@@ -264,6 +396,12 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
     // this partition on the worker.
     string graph_handle;
 
+    // Fingerprint of the partition GraphDef.  If handle_in_cache is true,
+    // graph_handle is tracked under it in the session's
+    // GraphRegistrationCache, which owns its deregistration.
+    uint64 fingerprint = 0;
+    bool handle_in_cache = false;
+
     Part() : feed_key(3), key_fetch(3) {}
   };
 
@@ -322,8 +460,9 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
       const ClientRequestType& req, ClientResponseType* resp,
       CancellationManager* cm, bool is_last_partial_run);
 
-  // Deregisters the partitions on the workers.  Called in the
-  // destructor and does not wait for the rpc completion.
+  // Releases the partitions' graph handles, either back to the
+  // registration cache or by deregistering them on the workers directly.
+  // Called in the destructor and does not wait for rpc completion.
   void DeregisterPartitions();
 
   TF_DISALLOW_COPY_AND_ASSIGN(ReffedClientGraph);
@@ -443,6 +582,7 @@ Status MasterSession::ReffedClientGraph::DoRegisterPartitions(
     partitions_.emplace_back();
     Part* part = &partitions_.back();
     part->name = name_def.first;
+    part->fingerprint = DeterministicProtoHash64(name_def.second);
     TrackFeedsAndFetches(part, name_def.second, popts);
     part->worker = worker_cache_->CreateWorker(part->name);
     if (part->worker == nullptr) {
@@ -464,8 +604,23 @@ Status MasterSession::ReffedClientGraph::DoRegisterPartitions(
   };
   const int num = partitions_.size();
   gtl::InlinedVector<Call, 4> calls(num);
-  BlockingCounter done(num);
+  // Partitions whose fingerprint matches a graph already registered on the
+  // worker reuse that handle; only the changed partitions pay a
+  // RegisterGraph round trip.
+  std::vector<bool> reused(num, false);
+  int num_to_register = 0;
+  for (int i = 0; i < num; ++i) {
+    Part* part = &partitions_[i];
+    reused[i] = registration_cache_->Lookup(part->name, part->fingerprint,
+                                            &part->graph_handle);
+    part->handle_in_cache = reused[i];
+    if (!reused[i]) ++num_to_register;
+  }
+  VLOG(1) << "Registering " << num_to_register << " of " << num
+          << " partitions";
+  BlockingCounter done(num_to_register);
   for (int i = 0; i < num; ++i) {
+    if (reused[i]) continue;
     const Part& part = partitions_[i];
     Call* c = &calls[i];
     c->req.set_session_handle(session_handle_);
@@ -484,9 +639,15 @@ Status MasterSession::ReffedClientGraph::DoRegisterPartitions(
   }
   done.Wait();
   for (int i = 0; i < num; ++i) {
+    if (reused[i]) continue;
     Call* c = &calls[i];
     s.Update(c->status);
     partitions_[i].graph_handle = c->resp.graph_handle();
+    if (c->status.ok() && !partitions_[i].graph_handle.empty()) {
+      partitions_[i].handle_in_cache = registration_cache_->Insert(
+          partitions_[i].name, partitions_[i].fingerprint,
+          partitions_[i].graph_handle, should_deregister_);
+    }
   }
   return s;
 }
@@ -1058,8 +1219,14 @@ void MasterSession::ReffedClientGraph::DeregisterPartitions() {
     DeregisterGraphResponse resp;
   };
   for (Part& part : partitions_) {
-    // The graph handle may be empty if we failed during partition registration.
-    if (!part.graph_handle.empty()) {
+    if (part.handle_in_cache) {
+      // The handle is owned by the registration cache, which deregisters
+      // it when it falls out of the cache's LRU set.
+      registration_cache_->Release(part.name, part.fingerprint);
+    } else if (should_deregister_ && !part.graph_handle.empty()) {
+      // The handle never made it into the cache (e.g. a concurrent
+      // registration claimed its fingerprint first), so deregister it
+      // directly.
       Call* c = new Call;
       c->req.set_session_handle(session_handle_);
       c->req.set_create_worker_session_called(!should_deregister_);
@@ -1080,6 +1247,10 @@ void MasterSession::ReffedClientGraph::DeregisterPartitions() {
         worker_cache->ReleaseWorker(name, w);
       };
       w->DeregisterGraphAsync(&c->req, &c->resp, cb);
+      continue;  // The worker is released by the callback.
+    }
+    if (part.worker != nullptr) {
+      worker_cache_->ReleaseWorker(part.name, part.worker);
     }
   }
 }
@@ -1460,6 +1631,22 @@ WorkerCacheInterface* MasterSession::get_worker_cache() const {
   return env_->worker_cache;
 }
 
+std::shared_ptr<MasterSession::GraphRegistrationCache>
+MasterSession::get_registration_cache() {
+  if (!graph_registration_cache_) {
+    int64 capacity = 64;
+    Status status = ReadInt64FromEnvVar(
+        "TF_MASTER_GRAPH_REGISTRATION_CACHE_SIZE", 64, &capacity);
+    if (!status.ok()) {
+      LOG(ERROR) << "Invalid TF_MASTER_GRAPH_REGISTRATION_CACHE_SIZE: "
+                 << status;
+    }
+    graph_registration_cache_ = std::make_shared<GraphRegistrationCache>(
+        get_worker_cache(), handle_, should_delete_worker_sessions_, capacity);
+  }
+  return graph_registration_cache_;
+}
+
 Status MasterSession::StartStep(const BuildGraphOptions& opts, bool is_partial,
                                 ReffedClientGraph** out_rcg, int64* out_count) {
   const uint64 hash = HashBuildGraphOptions(opts);
@@ -1482,7 +1669,7 @@ Status MasterSession::StartStep(const BuildGraphOptions& opts, bool is_partial,
       auto entry = new ReffedClientGraph(
           handle_, opts, std::move(client_graph), session_opts_,
           stats_publisher_factory_, is_partial, worker_cache,
-          !should_delete_worker_sessions_);
+          !should_delete_worker_sessions_, get_registration_cache());
       iter = m->insert({hash, entry}).first;
       VLOG(1) << "Preparing to execute new graph";
     }
@@ -1613,9 +1800,16 @@ Status MasterSession::BuildAndRegisterPartitions(ReffedClientGraph* rcg) {
   // The closures popts.{new_name,get_incarnation} are called synchronously in
   // RegisterPartitions() below, so do not need a Ref()/Unref() pair to keep
   // "this" alive during the closure.
-  popts.new_name = [this](const string& prefix) {
-    mutex_lock l(mu_);
-    return strings::StrCat(prefix, "_S", next_node_id_++);
+  //
+  // Generated send/recv names are numbered per partitioning invocation
+  // rather than per session so that identical pruned graphs partition into
+  // byte-identical GraphDefs, letting their unchanged partitions hit the
+  // graph registration cache.  Different client graphs may therefore reuse
+  // the same generated names, which is safe because rendezvous traffic is
+  // scoped by step_id.
+  auto next_node_id = std::make_shared<int64>(0);
+  popts.new_name = [next_node_id](const string& prefix) {
+    return strings::StrCat(prefix, "_S", (*next_node_id)++);
   };
   popts.get_incarnation = [this](const string& name) -> int64 {
     Device* d = devices_->FindDeviceByName(name);
@@ -1941,10 +2135,10 @@ Status MasterSession::MakeCallable(const MakeCallableRequest& req,
     }
     std::unique_ptr<ClientGraph> client_graph;
     TF_RETURN_IF_ERROR(execution_state_->BuildGraph(opts, &client_graph));
-    callable = new ReffedClientGraph(handle_, opts, std::move(client_graph),
-                                     session_opts_, stats_publisher_factory_,
-                                     false /* is_partial */, get_worker_cache(),
-                                     !should_delete_worker_sessions_);
+    callable = new ReffedClientGraph(
+        handle_, opts, std::move(client_graph), session_opts_,
+        stats_publisher_factory_, false /* is_partial */, get_worker_cache(),
+        !should_delete_worker_sessions_, get_registration_cache());
   }
 
   Status s = BuildAndRegisterPartitions(callable);
@@ -155,6 +155,16 @@ class MasterSession : public core::RefCounted {
   class ReffedClientGraph;
   typedef std::unordered_map<uint64, ReffedClientGraph*> RCGMap;
   RCGMap run_graphs_ GUARDED_BY(mu_);
+  // Maps (worker, partition fingerprint) to the graph handle already
+  // registered on that worker so that building a new ReffedClientGraph
+  // re-registers only partitions whose content actually changed.  Shared
+  // by all ReffedClientGraphs of this session.
+  class GraphRegistrationCache;
+  std::shared_ptr<GraphRegistrationCache> graph_registration_cache_
+      GUARDED_BY(mu_);
+  // Returns graph_registration_cache_, creating it on first use.
+  std::shared_ptr<GraphRegistrationCache> get_registration_cache()
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
   RCGMap partial_run_graphs_ GUARDED_BY(mu_);
   int64 next_callable_handle_ GUARDED_BY(mu_) = 0;
   RCGMap callables_ GUARDED_BY(mu_);
@@ -203,10 +213,6 @@ class MasterSession : public core::RefCounted {
 
   std::unordered_map<uint64, int64> subgraph_execution_counts_ GUARDED_BY(mu_);
 
-  // We need to ensure that certain nodes added (e.g., send and recv
-  // nodes) are unique across all sub-graphs within this session.
-  int64 next_node_id_ GUARDED_BY(mu_) = 0;
-
   // Used to cancel running steps on Close().
   CancellationManager cancellation_manager_;
 
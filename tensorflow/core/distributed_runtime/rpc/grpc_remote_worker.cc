@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_client_cq_tag.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_state.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
@@ -110,8 +111,26 @@ class GrpcRemoteWorker : public WorkerInterface {
   void RunGraphAsync(CallOptions* call_opts, RunGraphRequestWrapper* request,
                      MutableRunGraphResponseWrapper* response,
                      StatusCallback done) override {
-    IssueRequest(&request->ToProto(), get_proto_from_wrapper(response),
-                 rungraph_, std::move(done), call_opts);
+    // Encode the request directly from the wrapper so that feed tensors
+    // held as in-memory Tensors go to the wire without first being copied
+    // into TensorProto fields.  For a proto-backed wrapper the encoder is
+    // equivalent to serializing ToProto().
+    ::grpc::ByteBuffer request_buf;
+    Status s = grpc::EncodeRunGraphRequestToByteBuffer(*request, &request_buf);
+    if (!s.ok()) {
+      // Fall back to the proto round trip rather than failing the step.
+      IssueRequest(&request->ToProto(), get_proto_from_wrapper(response),
+                   rungraph_, std::move(done), call_opts);
+      return;
+    }
+    IssueRequest(request_buf, get_proto_from_wrapper(response), rungraph_,
+                 std::move(done), call_opts);
+  }
+
+  MutableRunGraphRequestWrapper* CreateRunGraphRequest() override {
+    // Keeps feeds as Tensors until RunGraphAsync encodes them, avoiding the
+    // TensorProto copy made by the default proto-backed request.
+    return new InMemoryRunGraphRequest;
   }
 
   void CleanupGraphAsync(const CleanupGraphRequest* request,
@@ -274,6 +293,15 @@ class GrpcRemoteWorker : public WorkerInterface {
                                     std::move(done), call_opts,
                                     callback_threadpool_, max_retries);
   }
+  void IssueRequest(const ::grpc::ByteBuffer& request,
+                    protobuf::Message* response, const ::grpc::string& method,
+                    StatusCallback done, CallOptions* call_opts = nullptr,
+                    int max_retries = kMaxWorkerRpcRetries) {
+    new RPCState<protobuf::Message>(&stub_, cq_, method, request, response,
+                                    std::move(done), call_opts,
+                                    callback_threadpool_, /*fail_fast=*/false,
+                                    /*timeout_in_ms=*/0, max_retries);
+  }
   void IssueRequest(const protobuf::Message* request, TensorResponse* response,
                     const ::grpc::string& method, StatusCallback done,
                     CallOptions* call_opts = nullptr,
@@ -15,45 +15,86 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_response_cache.h"
 #include "absl/types/optional.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Qualifies a tensor key with its step so entries from different steps can
+// never alias each other.
+string StepTensorKey(int64 step_id, const string& tensor_key) {
+  return strings::StrCat(step_id, ";", tensor_key);
+}
+
+}  // namespace
+
 bool GrpcResponseCache::QueueRequest(int64 request_id, int64 step_id,
+                                     const string& tensor_key,
                                      const FinishResponseCB& cb) {
   VLOG(1) << "GrpcResponseCache Lookup " << request_id;
 
   mu_.lock();
 
-  ResponseCacheEntry& entry = response_cache_[request_id];
+  // Resolve deduplicated request ids to the entry serving them.
+  int64 entry_id = request_id;
+  auto alias_it = alias_index_.find(request_id);
+  if (alias_it != alias_index_.end()) {
+    entry_id = alias_it->second;
+  }
+
+  auto it = response_cache_.find(entry_id);
+  if (it == response_cache_.end() && !tensor_key.empty()) {
+    // No entry under this request id.  If another request already produces
+    // the same tensor in this step, attach to its entry instead of starting
+    // a duplicate computation.
+    auto key_it = tensor_key_index_.find(StepTensorKey(step_id, tensor_key));
+    if (key_it != tensor_key_index_.end()) {
+      it = response_cache_.find(key_it->second);
+      if (it != response_cache_.end()) {
+        VLOG(1) << "Dedup request " << request_id << " onto " << key_it->second
+                << " for tensor " << tensor_key;
+        entry_id = key_it->second;
+        alias_index_[request_id] = entry_id;
+        it->second.num_consumers++;
+      }
+    }
+  }
 
-  if (entry.state == ResponseCacheEntry::State::FINISHED) {
+  if (it != response_cache_.end() &&
+      it->second.state == ResponseCacheEntry::State::FINISHED) {
     VLOG(1) << "Reuse cached response for " << request_id;
     // Make a copy of the ResponseCacheEntry so that we can run FinishResponse
     // outside the critical section. FinishResponse can be potentially
     // expensive.
-    auto entry_copy = entry;
+    auto entry_copy = it->second;
 
     mu_.unlock();
     entry_copy.FinishResponse(cb);
     return true;
   }
 
-  entry.callbacks.emplace_back(cb);
-
-  if (entry.state == ResponseCacheEntry::State::ACTIVE) {
+  if (it != response_cache_.end()) {
     VLOG(1) << "Found active request for " << request_id
             << ".  Adding entry to response queue.";
+    it->second.callbacks.emplace_back(cb);
     mu_.unlock();
     return true;
-  } else {
-    VLOG(2) << "No cache entry for " << request_id
-            << ", running user computation.";
-    entry.step_id = step_id;
-    entry.state = ResponseCacheEntry::State::ACTIVE;
-    mu_.unlock();
-    return false;
   }
+
+  VLOG(2) << "No cache entry for " << request_id
+          << ", running user computation.";
+  ResponseCacheEntry& entry = response_cache_[request_id];
+  entry.callbacks.emplace_back(cb);
+  entry.step_id = step_id;
+  entry.state = ResponseCacheEntry::State::ACTIVE;
+  if (!tensor_key.empty()) {
+    entry.tensor_key = StepTensorKey(step_id, tensor_key);
+    tensor_key_index_[entry.tensor_key] = request_id;
+  }
+  mu_.unlock();
+  return false;
 }
 
 void GrpcResponseCache::OnRequestFinished(int64 request_id,
@@ -80,12 +121,18 @@ void GrpcResponseCache::OnRequestFinished(int64 request_id,
     entry.is_dead = is_dead;
     entry.response_status = status;
     entry.state = ResponseCacheEntry::State::FINISHED;
+    finished_bytes_ += tensor.TotalBytes();
+    finished_order_.push_back(request_id);
 
     // We copy the extra work out of the critical section in order to avoid
     // serializing the work for sending response.
     entry_copy = entry;
 
     entry.callbacks.clear();
+
+    if (max_finished_bytes_ > 0) {
+      EvictForBudgetLocked();
+    }
   }
 
   for (auto& cb : entry_copy->callbacks) {
@@ -95,20 +142,68 @@ void GrpcResponseCache::OnRequestFinished(int64 request_id,
 
 void GrpcResponseCache::EraseRequestId(int64 request_id) {
   mutex_lock m(mu_);
-  response_cache_.erase(request_id);
+  int64 entry_id = request_id;
+  auto alias_it = alias_index_.find(request_id);
+  if (alias_it != alias_index_.end()) {
+    entry_id = alias_it->second;
+    alias_index_.erase(alias_it);
+  }
+  auto it = response_cache_.find(entry_id);
+  if (it == response_cache_.end()) return;
+  // The entry may still have to serve retries from other deduplicated
+  // consumers; drop it only once the last of them has acked.
+  if (--it->second.num_consumers > 0) return;
+  EraseEntryLocked(entry_id, &it->second);
 }
 
 void GrpcResponseCache::CleanEntriesForStep(int64 step_id) {
   mutex_lock m(mu_);
-  // Remove all cache entries whose step id is the given step_id
-  for (auto it = response_cache_.begin(), last = response_cache_.end();
-       it != last;) {
-    if (it->second.step_id == step_id) {
-      VLOG(1) << "Erase stale GrpcResponseCache entry " << it->first;
-      it = response_cache_.erase(it);
-    } else {
-      ++it;
+  // Remove all cache entries whose step id is the given step_id.  Erasure
+  // may shuffle the map, so collect the ids first.
+  std::vector<int64> victims;
+  for (const auto& p : response_cache_) {
+    if (p.second.step_id == step_id) victims.push_back(p.first);
+  }
+  for (int64 entry_id : victims) {
+    VLOG(1) << "Erase stale GrpcResponseCache entry " << entry_id;
+    auto it = response_cache_.find(entry_id);
+    if (it != response_cache_.end()) {
+      EraseEntryLocked(entry_id, &it->second);
+    }
+  }
+}
+
+void GrpcResponseCache::EraseEntryLocked(int64 request_id,
+                                         ResponseCacheEntry* entry) {
+  if (entry->state == ResponseCacheEntry::State::FINISHED) {
+    finished_bytes_ -= entry->tensor.TotalBytes();
+  }
+  if (!entry->tensor_key.empty()) {
+    tensor_key_index_.erase(entry->tensor_key);
+  }
+  if (!alias_index_.empty()) {
+    std::vector<int64> stale_aliases;
+    for (const auto& p : alias_index_) {
+      if (p.second == request_id) stale_aliases.push_back(p.first);
+    }
+    for (int64 alias_id : stale_aliases) alias_index_.erase(alias_id);
+  }
+  response_cache_.erase(request_id);
+}
+
+void GrpcResponseCache::EvictForBudgetLocked() {
+  while (finished_bytes_ > max_finished_bytes_ && !finished_order_.empty()) {
+    int64 victim_id = finished_order_.front();
+    finished_order_.pop_front();
+    auto it = response_cache_.find(victim_id);
+    // Skip ids of entries already erased by ack or step cleanup.
+    if (it == response_cache_.end() ||
+        it->second.state != ResponseCacheEntry::State::FINISHED) {
+      continue;
     }
+    VLOG(1) << "Evict GrpcResponseCache entry " << victim_id << " ("
+            << it->second.tensor.TotalBytes() << " bytes) for byte budget.";
+    EraseEntryLocked(victim_id, &it->second);
   }
 }
 
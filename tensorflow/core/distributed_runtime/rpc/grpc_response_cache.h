@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_RESPONSE_CACHE_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_RESPONSE_CACHE_H_
 
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -37,9 +38,28 @@ namespace tensorflow {
 // * PENDING: this is the first call of the RPC, and it will transition to
 // * ACTIVE: another thread is active processing this RPC
 // * FINISHED: the worker has finished processing the method
-
+//
+// Entries hold a reference to the produced Tensor rather than serialized
+// bytes; each response is encoded lazily from the shared buffer, so serving
+// N requests from one entry costs one tensor production plus N encodes.
+//
+// In addition to exact retries (same request_id), requests that carry the
+// same tensor key within the same step are deduplicated: the first request
+// produces the tensor and later ones are served from its entry.  This makes
+// a recv that the receiver re-issues under a fresh request id share the
+// single cached buffer instead of racing for an already-consumed rendezvous
+// value.
 class GrpcResponseCache {
  public:
+  // If max_finished_bytes > 0, finished entries are evicted oldest-first
+  // once their combined tensor payload exceeds the budget.  An evicted
+  // entry can no longer serve retries, so the budget should comfortably
+  // exceed the bytes in flight during one step; the oldest entries have
+  // almost always been delivered and are merely awaiting the receiver's
+  // ack.  0 disables eviction.
+  explicit GrpcResponseCache(int64 max_finished_bytes = 0)
+      : max_finished_bytes_(max_finished_bytes) {}
+
   using FinishResponseCB = std::function<void(
       const Tensor& tensor, bool is_dead, const Status& status)>;
 
@@ -49,8 +69,11 @@ class GrpcResponseCache {
   //    If active, cb will be invoked when the current call completes.
   //    In either case, return true.
   // Otherwise, store the request and cb in the cache, and return false.
+  // If `tensor_key` is non-empty it is also matched against active and
+  // finished entries for the same step, deduplicating requests for the
+  // same tensor that arrive under distinct request ids.
   // Note FinishResponseCB is assumed to be thread-safe.
-  bool QueueRequest(int64 request_id, int64 step_id,
+  bool QueueRequest(int64 request_id, int64 step_id, const string& tensor_key,
                     const FinishResponseCB& cb);
 
   // Fill the response cache for the given request_id and respond to all
@@ -58,7 +81,8 @@ class GrpcResponseCache {
   void OnRequestFinished(int64 request_id, const Tensor& tensor, bool is_dead,
                          const Status& status);
 
-  // Erase the cache entry with the given request_id
+  // Erase the cache entry with the given request_id.  An entry shared by
+  // several deduplicated requests is kept until all of them have acked.
   void EraseRequestId(int64 request_id);
 
   // Erase cache entries with the given step_id
@@ -74,6 +98,12 @@ class GrpcResponseCache {
 
     State state = State::PENDING;
     int64 step_id = -1;
+    // Step-qualified tensor key; empty if deduplication is disabled for
+    // this entry.
+    string tensor_key;
+    // Number of distinct request ids (the original plus any deduplicated
+    // aliases) that have not yet acked this entry.
+    int num_consumers = 1;
     Tensor tensor;
     bool is_dead = false;
     Status response_status;
@@ -84,10 +114,30 @@ class GrpcResponseCache {
     std::vector<FinishResponseCB> callbacks;
   };
 
+  // Removes the entry for request_id from all indices and updates the byte
+  // accounting.
+  void EraseEntryLocked(int64 request_id, ResponseCacheEntry* entry)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Evicts the oldest finished entries until the byte budget is respected.
+  void EvictForBudgetLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64 max_finished_bytes_;
+
   mutex mu_;
+  // Total tensor bytes held by FINISHED entries.
+  int64 finished_bytes_ GUARDED_BY(mu_) = 0;
+  // Request ids of finished entries in finish order, used for oldest-first
+  // eviction.  May contain stale ids for entries erased through other paths;
+  // those are skipped at eviction time.
+  std::list<int64> finished_order_ GUARDED_BY(mu_);
   // response_cache_ is expected to be small, as entries are cleared immediately
   // on ack from the receiver.
   gtl::FlatMap<int64, ResponseCacheEntry> response_cache_ GUARDED_BY(mu_);
+  // Step-qualified tensor key -> request id of the entry serving that tensor.
+  gtl::FlatMap<string, int64> tensor_key_index_ GUARDED_BY(mu_);
+  // Deduplicated request id -> request id of the entry serving it.
+  gtl::FlatMap<int64, int64> alias_index_ GUARDED_BY(mu_);
 };
 
 }  // namespace tensorflow
@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/collective_param_resolver_distributed.h"
 #include "tensorflow/core/distributed_runtime/device_resolver_distributed.h"
 #include "tensorflow/core/distributed_runtime/graph_mgr.h"
+#include "tensorflow/core/distributed_runtime/in_process_worker_registry.h"
 #include "tensorflow/core/distributed_runtime/local_master.h"
 #include "tensorflow/core/distributed_runtime/master.h"
 #include "tensorflow/core/distributed_runtime/master_env.h"
@@ -82,6 +83,10 @@ GrpcServer::~GrpcServer() {
   TF_CHECK_OK(Stop());
   TF_CHECK_OK(Join());
 
+  InProcessWorkerRegistry::Global()->Deregister(
+      strings::StrCat("/job:", server_def_.job_name(), "/replica:0",
+                      "/task:", server_def_.task_index()));
+
   delete master_service_;
   delete worker_service_;
   delete eager_service_;
@@ -206,6 +211,9 @@ Status GrpcServer::Init(const GrpcServerOptions& opts) {
   worker_service_ = NewGrpcWorkerService(worker_impl_.get(), &builder,
                                          opts.worker_service_options)
                         .release();
+  // Make this task's worker reachable by other servers in the same process
+  // through direct WorkerInterface calls (see in_process_worker_registry.h).
+  InProcessWorkerRegistry::Global()->Register(name_prefix, worker_impl_.get());
   eager_service_ = new eager::GrpcEagerServiceImpl(&worker_env_, &builder);
 
   // extra service:
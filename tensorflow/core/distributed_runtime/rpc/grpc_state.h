@@ -16,8 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_STATE_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_STATE_H_
 
+#include <algorithm>
+#include <memory>
 #include <utility>
 
+#include "grpcpp/alarm.h"
 #include "grpcpp/generic/generic_stub.h"
 #include "grpcpp/grpcpp.h"
 #include "tensorflow/core/distributed_runtime/call_options.h"
@@ -27,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/notification.h"
 
 namespace tensorflow {
@@ -63,6 +67,12 @@ class RPCState : public GrpcClientCQTag {
         method_(method),
         fail_fast_(fail_fast) {
     response_ = response;
+    if (timeout_in_ms_ > 0) {
+      // The timeout bounds the whole call including retries, not each
+      // attempt, so retries of a slow target cannot multiply the deadline.
+      deadline_micros_ =
+          Env::Default()->NowMicros() + timeout_in_ms_ * 1000;
+    }
     ::grpc::Status s = GrpcMaybeUnparseProto(request, &request_buf_);
     if (!s.ok()) {
       LOG(ERROR) << "GrpcMaybeUnparseProto returned with non-ok status: "
@@ -79,9 +89,13 @@ class RPCState : public GrpcClientCQTag {
     context_.reset(new ::grpc::ClientContext());
     context_->set_fail_fast(fail_fast_);
 
-    if (timeout_in_ms_ > 0) {
+    if (deadline_micros_ > 0) {
+      // Give each attempt whatever remains of the overall budget.
+      int64 remaining_micros = static_cast<int64>(deadline_micros_) -
+                               static_cast<int64>(Env::Default()->NowMicros());
       context_->set_deadline(
-          gpr_time_from_millis(timeout_in_ms_, GPR_TIMESPAN));
+          gpr_time_from_micros(std::max(remaining_micros, int64{0}),
+                               GPR_TIMESPAN));
     }
     if (call_opts_) {
       call_opts_->SetCancelCallback([this]() { context_->TryCancel(); });
@@ -96,6 +110,20 @@ class RPCState : public GrpcClientCQTag {
   }
 
   void OnCompleted(bool ok) override {
+    if (in_backoff_) {
+      // This completion is the backoff alarm firing (or being cancelled at
+      // completion queue shutdown), not a response.
+      in_backoff_ = false;
+      if (ok) {
+        StartCall();
+      } else {
+        done_(errors::Cancelled("rpc cancelled while waiting to retry ",
+                                method_));
+        delete this;
+      }
+      return;
+    }
+
     if (call_opts_) {
       call_opts_->ClearCancelCallback();
     }
@@ -125,11 +153,19 @@ class RPCState : public GrpcClientCQTag {
             << context_->debug_error_string();
     // Retry if we have any attempts left
     if (++num_retries_ <= max_retries_ &&
-        (errors::IsUnavailable(s) || errors::IsUnknown(s))) {
+        (errors::IsUnavailable(s) || errors::IsUnknown(s)) &&
+        !PastDeadline()) {
       response_buf_.Clear();
       VLOG(1) << "Retrying call for " << method_ << "Retry: " << num_retries_
               << " of " << max_retries_;
-      StartCall();
+      if (num_retries_ == 1) {
+        // Retry the first transient failure immediately: the common cause
+        // during rescheduling is a single dropped connection, and waiting a
+        // full backoff period turns an RTT-scale recovery into seconds.
+        StartCall();
+      } else {
+        ScheduleRetry();
+      }
     } else {
       // Attach additional GRPC error information if any to the final status
       s = Status(s.code(),
@@ -158,6 +194,31 @@ class RPCState : public GrpcClientCQTag {
   }
 
  private:
+  bool PastDeadline() const {
+    return deadline_micros_ > 0 &&
+           Env::Default()->NowMicros() >= deadline_micros_;
+  }
+
+  // Schedules the next attempt after a jittered exponential backoff, without
+  // tying up a completion-queue thread while waiting.  The backoff never
+  // extends past the overall call deadline.
+  void ScheduleRetry() {
+    int64 backoff_micros = ComputeBackoffMicroseconds(
+        static_cast<int>(num_retries_) - 2, /*min_delay=*/1000,
+        /*max_delay=*/1000000);
+    if (deadline_micros_ > 0) {
+      int64 remaining_micros = static_cast<int64>(deadline_micros_) -
+                               static_cast<int64>(Env::Default()->NowMicros());
+      backoff_micros = std::min(backoff_micros, std::max(remaining_micros,
+                                                         int64{0}));
+    }
+    in_backoff_ = true;
+    backoff_alarm_.reset(new ::grpc::Alarm(
+        cq_, gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                          gpr_time_from_micros(backoff_micros, GPR_TIMESPAN)),
+        this));
+  }
+
   CallOptions* call_opts_;
   std::unique_ptr<::grpc::ClientContext> context_;
   thread::ThreadPool* threadpool_;
@@ -168,6 +229,10 @@ class RPCState : public GrpcClientCQTag {
   ::grpc::Status status_;
   StatusCallback done_;
   int64 timeout_in_ms_;
+  uint64 deadline_micros_ = 0;  // 0 iff no deadline was given.
+
+  std::unique_ptr<::grpc::Alarm> backoff_alarm_;
+  bool in_backoff_ = false;
 
   size_t num_retries_ = 0;
   size_t max_retries_;
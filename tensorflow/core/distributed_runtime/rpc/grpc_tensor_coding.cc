@@ -14,16 +14,23 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
+
+#include <vector>
+
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/distributed_runtime/message_wrappers.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/io/proto_encode_helper.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/protobuf/named_tensor.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 // (Omitted internal-only flag)
@@ -243,5 +250,117 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
   }
 }
 
+// We generate a RunGraphRequest protocol buffer encoding into "*result"
+// directly from the wrapper's in-memory feed Tensors, using the same
+// hand-encoding scheme as EncodeTensorToByteBuffer: every field except the
+// feeds is serialized by protobuf itself, and each feed is emitted as a
+// hand-framed "send" entry whose tensor_content either lives inline (small
+// tensors) or shares the Tensor's backing store (large tensors).  This
+// avoids materializing a TensorProto copy of every feed on the dispatch
+// path.
+Status EncodeRunGraphRequestToByteBuffer(const RunGraphRequestWrapper& request,
+                                         ::grpc::ByteBuffer* result) {
+  const int kLargeTensorBytes = 1024;
+
+  // All of RunGraphRequest except the send() field.  Relies on protobuf
+  // parsers accepting fields in any order, as the wire format requires.
+  RunGraphRequest header;
+  header.set_session_handle(request.session_handle());
+  header.set_create_worker_session_called(
+      request.create_worker_session_called());
+  header.set_graph_handle(request.graph_handle());
+  header.set_step_id(request.step_id());
+  *header.mutable_exec_opts() = request.exec_opts();
+  for (size_t i = 0; i < request.num_recvs(); ++i) {
+    header.add_recv_key(request.recv_key(i));
+  }
+  header.set_is_partial(request.is_partial());
+  header.set_is_last_partial_run(request.is_last_partial_run());
+  header.set_store_errors_in_response_body(
+      request.store_errors_in_response_body());
+  header.set_request_id(request.request_id());
+
+  std::vector<::grpc::Slice> slices;
+  string buf;
+  header.AppendToString(&buf);
+
+  // Moves the bytes accumulated in "buf" into their own slice; called
+  // before appending a shared slice so slice order matches byte order.
+  auto flush_buf = [&slices, &buf]() {
+    if (buf.empty()) return;
+    ::grpc::Slice slice(buf.size());
+    memcpy(const_cast<uint8_t*>(slice.begin()), buf.data(), buf.size());
+    slices.push_back(slice);
+    buf.clear();
+  };
+
+  for (size_t i = 0; i < request.num_sends(); ++i) {
+    const string& name = request.send_key(i);
+    Tensor val;
+    TF_RETURN_IF_ERROR(request.SendValue(i, &val));
+
+    if (!DataTypeCanUseMemcpy(val.dtype())) {
+      // Straightforward but slow path for complicated kinds of tensor data,
+      // as in EncodeTensorToByteBuffer.
+      NamedTensorProto send;
+      send.set_name(name);
+      val.AsProtoTensorContent(send.mutable_tensor());
+      core::PutVarint32(&buf, (RunGraphRequest::kSendFieldNumber << 3) | 2);
+      core::PutVarint64(&buf, send.ByteSizeLong());
+      send.AppendToString(&buf);
+      continue;
+    }
+
+    // skeleton is the encoded TensorProto contents (dtype and shape), but
+    // not the actual data.
+    gtl::InlinedVector<char, 128> skeleton(SkeletonEncodingSizeUpperBound(val));
+    io::ProtoEncodeHelper e_skeleton(skeleton.data(), skeleton.size());
+    EncodeSkeleton(val, &e_skeleton);
+
+    StringPiece tdata = val.tensor_data();
+    const uint32 tensor_proto_bytes =
+        e_skeleton.size() +
+        VarLengthEncodingSize(TensorProto::kTensorContentFieldNumber,
+                              tdata.size());
+    const uint32 send_bytes =
+        VarLengthEncodingSize(NamedTensorProto::kNameFieldNumber,
+                              name.size()) +
+        VarLengthEncodingSize(NamedTensorProto::kTensorFieldNumber,
+                              tensor_proto_bytes);
+
+    core::PutVarint32(&buf, (RunGraphRequest::kSendFieldNumber << 3) | 2);
+    core::PutVarint32(&buf, send_bytes);
+    core::PutVarint32(&buf, (NamedTensorProto::kNameFieldNumber << 3) | 2);
+    core::PutVarint32(&buf, name.size());
+    buf.append(name);
+    core::PutVarint32(&buf, (NamedTensorProto::kTensorFieldNumber << 3) | 2);
+    core::PutVarint32(&buf, tensor_proto_bytes);
+    buf.append(e_skeleton.data(), e_skeleton.size());
+    core::PutVarint32(&buf, (TensorProto::kTensorContentFieldNumber << 3) | 2);
+    core::PutVarint32(&buf, tdata.size());
+
+    if (tdata.size() > kLargeTensorBytes) {
+      // Share the backing store of the tensor data by creating a slice that
+      // points to it, with appropriate reference counts to keep the backing
+      // store alive as long as the "*result" ByteBuffer needs it.
+      flush_buf();
+      const TensorBuffer* tbuf = DMAHelper::buffer(&val);
+      tbuf->Ref();
+      slices.push_back(::grpc::Slice(
+          const_cast<void*>(static_cast<const void*>(tdata.data())),
+          tdata.size(),
+          [](void* backing) { static_cast<TensorBuffer*>(backing)->Unref(); },
+          const_cast<TensorBuffer*>(tbuf)));
+    } else {
+      buf.append(tdata.data(), tdata.size());
+    }
+  }
+  flush_buf();
+
+  ::grpc::ByteBuffer tmp(slices.data(), slices.size());
+  result->Swap(&tmp);
+  return Status::OK();
+}
+
 }  // namespace grpc
 }  // namespace tensorflow
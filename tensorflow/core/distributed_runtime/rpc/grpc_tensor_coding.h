@@ -17,10 +17,12 @@ limitations under the License.
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_TENSOR_CODING_H_
 
 #include "grpcpp/impl/codegen/byte_buffer.h"
+#include "tensorflow/core/lib/core/status.h"
 
 namespace tensorflow {
 class Tensor;
 class RecvTensorResponse;
+class RunGraphRequestWrapper;
 
 // TODO(jeff,sanjay): this should not be grpc specific.  Instead of
 // grpc::ByteBuffer*, it should accept an object of an interface type
@@ -49,6 +51,18 @@ void EncodeRecvTensorResponseToByteBuffer(const RecvTensorResponse& proto,
 void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
                               ::grpc::ByteBuffer* result);
 
+// Encode "request" into a byte buffer in a format that is parseable as a
+// RunGraphRequest protocol buffer.
+//
+// The feed tensors are encoded directly from the wrapper's in-memory
+// Tensors; as in EncodeTensorToByteBuffer, the backing store of a large
+// feed is shared with the byte buffer instead of being copied into a
+// TensorProto field first.
+//
+// Discards original contents of *result.
+Status EncodeRunGraphRequestToByteBuffer(const RunGraphRequestWrapper& request,
+                                         ::grpc::ByteBuffer* result);
+
 }  // namespace grpc
 }  // namespace tensorflow
 
@@ -17,8 +17,10 @@ limitations under the License.
 
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
+#include "tensorflow/core/distributed_runtime/message_wrappers.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/test.h"
@@ -100,4 +102,76 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(GrpcTensorCodingTest, RunGraphRequest) {
+  // Feeds exercising all three encoder paths: inline copy (small), shared
+  // backing store (large), and the AsProtoTensorContent fallback (string).
+  Tensor small(DT_FLOAT, TensorShape({3}));
+  test::FillValues<float>(&small, {1.0, 2.0, 3.0});
+  Tensor large(DT_FLOAT, TensorShape({1000}));
+  for (int i = 0; i < 1000; i++) {
+    large.flat<float>()(i) = static_cast<float>(i);
+  }
+  Tensor strs(DT_STRING, TensorShape({2}));
+  test::FillValues<string>(&strs, {"foo", "bar"});
+
+  InMemoryRunStepRequest step_request;
+  step_request.add_feed("small", small);
+  step_request.add_feed("large", large);
+  step_request.add_feed("strs", strs);
+
+  InMemoryRunGraphRequest request;
+  request.set_session_handle("session");
+  request.set_create_worker_session_called(true);
+  request.set_graph_handle("graph");
+  request.set_step_id(13);
+  request.mutable_exec_opts()->set_record_timeline(true);
+  TF_ASSERT_OK(request.AddSendFromRunStepRequest(step_request, 0, "small"));
+  TF_ASSERT_OK(request.AddSendFromRunStepRequest(step_request, 1, "large"));
+  TF_ASSERT_OK(request.AddSendFromRunStepRequest(step_request, 2, "strs"));
+  request.add_recv_key("recv1");
+  request.add_recv_key("recv2");
+  request.set_is_partial(true);
+  request.set_store_errors_in_response_body(true);
+  request.set_request_id(42);
+
+  ::grpc::ByteBuffer buf;
+  TF_ASSERT_OK(grpc::EncodeRunGraphRequestToByteBuffer(request, &buf));
+
+  // Make a string
+  std::vector<::grpc::Slice> slices;
+  (void)buf.Dump(&slices);
+  string tmp;
+  for (const auto& s : slices) {
+    tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
+  }
+
+  RunGraphRequest parsed;
+  EXPECT_TRUE(parsed.ParseFromString(tmp));
+  EXPECT_EQ(parsed.session_handle(), "session");
+  EXPECT_TRUE(parsed.create_worker_session_called());
+  EXPECT_EQ(parsed.graph_handle(), "graph");
+  EXPECT_EQ(parsed.step_id(), 13);
+  EXPECT_TRUE(parsed.exec_opts().record_timeline());
+  ASSERT_EQ(parsed.recv_key_size(), 2);
+  EXPECT_EQ(parsed.recv_key(0), "recv1");
+  EXPECT_EQ(parsed.recv_key(1), "recv2");
+  EXPECT_TRUE(parsed.is_partial());
+  EXPECT_FALSE(parsed.is_last_partial_run());
+  EXPECT_TRUE(parsed.store_errors_in_response_body());
+  EXPECT_EQ(parsed.request_id(), 42);
+
+  ASSERT_EQ(parsed.send_size(), 3);
+  for (int i = 0; i < parsed.send_size(); i++) {
+    EXPECT_EQ(parsed.send(i).name(), request.send_key(i));
+    Tensor expected;
+    TF_ASSERT_OK(request.SendValue(i, &expected));
+    Tensor result_tensor;
+    EXPECT_TRUE(result_tensor.FromProto(parsed.send(i).tensor()));
+    EXPECT_EQ(expected.dtype(), result_tensor.dtype());
+    EXPECT_EQ(expected.shape().DebugString(),
+              result_tensor.shape().DebugString());
+    EXPECT_EQ(expected.DebugString(), result_tensor.DebugString());
+  }
+}
+
 }  // namespace tensorflow
@@ -128,6 +128,15 @@ bool GrpcMaybeParseProto(::grpc::ByteBuffer* src, TensorResponse* dst);
 ::grpc::Status GrpcMaybeUnparseProto(const string& src,
                                      ::grpc::ByteBuffer* dst);
 
+// Overload for already-encoded requests (e.g. produced by
+// grpc::EncodeRunGraphRequestToByteBuffer).  Copying a ByteBuffer shares
+// the underlying refcounted slices, so this does not copy the payload.
+inline ::grpc::Status GrpcMaybeUnparseProto(const ::grpc::ByteBuffer& src,
+                                            ::grpc::ByteBuffer* dst) {
+  *dst = src;
+  return ::grpc::Status::OK;
+}
+
 // Copy grpc buffer src to string *dst.
 bool GrpcMaybeParseProto(::grpc::ByteBuffer* src, string* dst);
 
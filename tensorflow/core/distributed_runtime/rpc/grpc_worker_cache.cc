@@ -18,6 +18,7 @@ limitations under the License.
 #include <unordered_map>
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_channel.h"
+#include "tensorflow/core/distributed_runtime/in_process_worker_registry.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_client_cq_tag.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_remote_worker.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
@@ -26,11 +27,28 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 namespace {
 
+// When TF_GRPC_IN_PROCESS_TRANSPORT is true, workers hosted by other servers
+// in this process are contacted through direct WorkerInterface calls instead
+// of serialized loopback RPCs (see in_process_worker_registry.h).
+bool InProcessTransportEnabled() {
+  static const bool enabled = []() {
+    bool value = false;
+    Status status =
+        ReadBoolFromEnvVar("TF_GRPC_IN_PROCESS_TRANSPORT", false, &value);
+    if (!status.ok()) {
+      LOG(ERROR) << "Invalid TF_GRPC_IN_PROCESS_TRANSPORT: " << status;
+    }
+    return value;
+  }();
+  return enabled;
+}
+
 class GrpcWorkerCache : public WorkerCachePartial {
  public:
   // TODO(ncteisen): consider adding a config var or flag for this
@@ -72,19 +90,28 @@ class GrpcWorkerCache : public WorkerCachePartial {
   WorkerInterface* CreateWorker(const string& target) override {
     if (target == local_target_) {
       return local_worker_;
-    } else {
-      SharedGrpcChannelPtr channel = channel_cache_->FindWorkerChannel(target);
-      if (!channel) return nullptr;
-      return NewGrpcRemoteWorker(
-          channel, threads_[AssignWorkerToThread(target)].completion_queue(),
-          callback_threadpool_.get(), &logger_);
     }
+    if (InProcessTransportEnabled()) {
+      WorkerInterface* in_process_worker =
+          InProcessWorkerRegistry::Global()->Lookup(target);
+      if (in_process_worker != nullptr) {
+        return in_process_worker;
+      }
+    }
+    SharedGrpcChannelPtr channel = channel_cache_->FindWorkerChannel(target);
+    if (!channel) return nullptr;
+    return NewGrpcRemoteWorker(
+        channel, threads_[AssignWorkerToThread(target)].completion_queue(),
+        callback_threadpool_.get(), &logger_);
   }
 
   void ReleaseWorker(const string& target, WorkerInterface* worker) override {
     if (target == local_target_) {
       CHECK_EQ(worker, local_worker_)
           << "Releasing a worker that was not returned by this WorkerCache";
+    } else if (InProcessTransportEnabled() &&
+               worker == InProcessWorkerRegistry::Global()->Lookup(target)) {
+      // In-process workers are owned by the server that registered them.
     } else {
       WorkerCacheInterface::ReleaseWorker(target, worker);
     }
@@ -48,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
@@ -55,11 +56,18 @@ limitations under the License.
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 namespace {
 
+auto* grpc_worker_cq_events = monitoring::Counter<1>::New(
+    "/tensorflow/core/grpc_worker_cq_events",
+    "The number of completion queue events processed by the gRPC worker "
+    "service, per queue.",
+    "queue");
+
 // This macro creates a new request for the given RPC method name
 // (e.g., `ENQUEUE_REQUEST(GetStatus, false);`), and enqueues it on
 // `this->cq_`.
@@ -97,21 +105,37 @@ namespace {
 // requests.  Each thread operates on an independent completion queue.
 class GrpcWorkerServiceThread {
  public:
+  // Which RPC methods a thread's completion queue services.  When a
+  // dedicated RecvTensor data plane is configured, control threads stop
+  // servicing RecvTensor so large tensor responses cannot head-of-line
+  // block control RPCs.
+  enum class QueuePlane {
+    kShared,      // All worker methods.
+    kControl,     // All worker methods except RecvTensor.
+    kRecvTensor,  // RecvTensor only.
+  };
+
   explicit GrpcWorkerServiceThread(
       GrpcWorker* worker, ::grpc::ServerBuilder* builder,
       std::unordered_map<int, int> queue_depth, GrpcResponseCache* cache,
-      grpc::WorkerService::AsyncService* worker_service)
+      grpc::WorkerService::AsyncService* worker_service, QueuePlane plane,
+      int numa_node, const string& queue_name)
       : worker_(worker),
         queue_depth_(queue_depth),
         cache_(cache),
         worker_service_(worker_service),
+        plane_(plane),
+        numa_node_(numa_node),
+        cq_events_cell_(grpc_worker_cq_events->GetCell(queue_name)),
         is_shutdown_(false) {
     cq_ = builder->AddCompletionQueue();
   }
 
   void Start() {
+    ThreadOptions thread_options;
+    thread_options.numa_node = numa_node_;
     thread_.reset(
-        worker_->env()->env->StartThread(ThreadOptions(), "grpc_worker_service",
+        worker_->env()->env->StartThread(thread_options, "grpc_worker_service",
                                          [this]() { HandleRPCsLoop(); }));
   }
 
@@ -132,36 +156,41 @@ class GrpcWorkerServiceThread {
     // TODO(ncteisen): This may require performance engineering. We can
     // change the number of threads, the number of handlers per thread,
     // or even decide to specialize certain threads to certain methods.
-    SETUP_FOR_REQUEST(GetStatus, 1, false);
-    SETUP_FOR_REQUEST(CreateWorkerSession, 1, false);
-    SETUP_FOR_REQUEST(DeleteWorkerSession, 1, false);
-    SETUP_FOR_REQUEST(CleanupAll, 1, false);
-    SETUP_FOR_REQUEST(RegisterGraph, 1, false);
-    SETUP_FOR_REQUEST(DeregisterGraph, 1, false);
-    SETUP_FOR_REQUEST(Logging, 1, false);
-    SETUP_FOR_REQUEST(Tracing, 1, false);
-    SETUP_FOR_REQUEST(CompleteGroup, 10, true);
-    SETUP_FOR_REQUEST(CompleteInstance, 10, true);
-    SETUP_FOR_REQUEST(GetStepSequence, 10, true);
-    SETUP_FOR_REQUEST(RecvBuf, 500, true);
-    SETUP_FOR_REQUEST(RunGraph, 100, true);
-    SETUP_FOR_REQUEST(CleanupGraph, 100, false);
-    SETUP_FOR_REQUEST(MarkRecvFinished, 10, false);
+    if (plane_ != QueuePlane::kRecvTensor) {
+      SETUP_FOR_REQUEST(GetStatus, 1, false);
+      SETUP_FOR_REQUEST(CreateWorkerSession, 1, false);
+      SETUP_FOR_REQUEST(DeleteWorkerSession, 1, false);
+      SETUP_FOR_REQUEST(CleanupAll, 1, false);
+      SETUP_FOR_REQUEST(RegisterGraph, 1, false);
+      SETUP_FOR_REQUEST(DeregisterGraph, 1, false);
+      SETUP_FOR_REQUEST(Logging, 1, false);
+      SETUP_FOR_REQUEST(Tracing, 1, false);
+      SETUP_FOR_REQUEST(CompleteGroup, 10, true);
+      SETUP_FOR_REQUEST(CompleteInstance, 10, true);
+      SETUP_FOR_REQUEST(GetStepSequence, 10, true);
+      SETUP_FOR_REQUEST(RecvBuf, 500, true);
+      SETUP_FOR_REQUEST(RunGraph, 100, true);
+      SETUP_FOR_REQUEST(CleanupGraph, 100, false);
+      SETUP_FOR_REQUEST(MarkRecvFinished, 10, false);
+    }
 
     // TODO(ncteisen): Determine a better policy for enqueuing the
     // appropriate number of each request type.
-    for (int i = 0;
-         i < gtl::FindWithDefault(
-                 queue_depth_, static_cast<int>(GrpcWorkerMethod::kRecvTensor),
-                 1000);
-         ++i) {
-      EnqueueRecvTensorRequestRaw();
+    if (plane_ != QueuePlane::kControl) {
+      for (int i = 0;
+           i < gtl::FindWithDefault(
+                   queue_depth_,
+                   static_cast<int>(GrpcWorkerMethod::kRecvTensor), 1000);
+           ++i) {
+        EnqueueRecvTensorRequestRaw();
+      }
     }
 
     void* tag;
     bool ok;
 
     while (cq_->Next(&tag, &ok)) {
+      cq_events_cell_->IncrementBy(1);
       UntypedCall<GrpcWorkerServiceThread>::Tag* callback_tag =
           static_cast<UntypedCall<GrpcWorkerServiceThread>::Tag*>(tag);
       CHECK(callback_tag);
@@ -358,6 +387,9 @@ class GrpcWorkerServiceThread {
   std::unordered_map<int, int> queue_depth_;
   GrpcResponseCache* cache_;
   grpc::WorkerService::AsyncService* const worker_service_;
+  const QueuePlane plane_;
+  const int numa_node_;
+  monitoring::CounterCell* const cq_events_cell_;
 
   mutex shutdown_mu_;
   bool is_shutdown_ GUARDED_BY(shutdown_mu_);
@@ -376,10 +408,25 @@ class GrpcWorkerService : public AsyncServiceInterface {
       worker->EnableResponseCache();
     }
 
+    // When a dedicated RecvTensor data plane is requested, the serving
+    // threads handle only control traffic and RecvTensor gets its own
+    // completion queues, optionally pinned near the NIC's NUMA node.
+    const bool dedicated_data_plane = options.num_recv_tensor_threads > 0;
     for (int i = 0; i < options.num_serving_threads; i++) {
-      threads_.emplace_back(
-          new GrpcWorkerServiceThread(worker, builder, options.queue_depth,
-                                      cache_.get(), &worker_service_));
+      threads_.emplace_back(new GrpcWorkerServiceThread(
+          worker, builder, options.queue_depth, cache_.get(), &worker_service_,
+          dedicated_data_plane ? GrpcWorkerServiceThread::QueuePlane::kControl
+                               : GrpcWorkerServiceThread::QueuePlane::kShared,
+          port::kNUMANoAffinity,
+          strings::StrCat(dedicated_data_plane ? "control" : "shared", "_",
+                          i)));
+    }
+    for (int i = 0; i < options.num_recv_tensor_threads; i++) {
+      threads_.emplace_back(new GrpcWorkerServiceThread(
+          worker, builder, options.queue_depth, cache_.get(), &worker_service_,
+          GrpcWorkerServiceThread::QueuePlane::kRecvTensor,
+          options.recv_tensor_numa_node,
+          strings::StrCat("recv_tensor_", i)));
     }
   }
 
@@ -432,7 +479,15 @@ GrpcWorker::GrpcWorker(WorkerEnv* worker_env, const ConfigProto& config)
 
 void GrpcWorker::EnableResponseCache() {
   VLOG(1) << "Enabling gRPC tensor response cache.";
-  response_cache_ = absl::make_unique<GrpcResponseCache>();
+  // Budget for finished-but-unacked cached tensors; oldest entries are
+  // evicted beyond this.  0 disables eviction.
+  int64 max_bytes;
+  Status status = ReadInt64FromEnvVar("TF_GRPC_RESPONSE_CACHE_BYTES",
+                                      256LL << 20 /*256MiB*/, &max_bytes);
+  if (!status.ok()) {
+    LOG(ERROR) << status.error_message();
+  }
+  response_cache_ = absl::make_unique<GrpcResponseCache>(max_bytes);
 }
 
 // GrpcRecvTensorAsync: unlike the other Worker methods, which use protocol
@@ -460,8 +515,14 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
   // request, we delegate this retry request to the response cache. Otherwise,
   // we add the request to the response cache and start the computation to
   // retrieve the requested data.
+  //
+  // The rendezvous key is passed as the dedup key: a recv re-issued under a
+  // fresh request id (e.g. after the receiver abandoned the original RPC)
+  // then attaches to the entry that already consumed the rendezvous value
+  // instead of starting a second recv that can never complete.
   if (cache_enabled &&
-      response_cache_->QueueRequest(request_id, step_id, do_response)) {
+      response_cache_->QueueRequest(request_id, step_id,
+                                    request->rendezvous_key(), do_response)) {
     return;
   }
 
@@ -603,9 +664,11 @@ void GrpcWorker::RecvBufAsync(CallOptions* opts, const RecvBufRequest* request,
   // If response cache is enabled and the response cache already contains the
   // request, we delegate this retry request to the response cache. Otherwise,
   // we add the request to the response cache and start the computation to
-  // retrieve the requested data.
-  if (cache_enabled &&
-      response_cache_->QueueRequest(request_id, step_id, do_response)) {
+  // retrieve the requested data.  As for RecvTensor, the rendezvous key
+  // dedups re-issued requests so the buffer is only consumed once.
+  if (cache_enabled && response_cache_->QueueRequest(
+                           request_id, step_id, request->buf_rendezvous_key(),
+                           do_response)) {
     return;
   }
 
@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_response_cache.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
 #include "tensorflow/core/distributed_runtime/worker.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace grpc {
@@ -76,6 +77,17 @@ struct GrpcWorkerServiceOptions {
   std::unordered_map<int, int> queue_depth;
   int num_serving_threads = 8;
 
+  // Number of additional threads, each with its own completion queue,
+  // dedicated to RecvTensor -- the hottest RPC in a cluster.  When > 0 the
+  // serving threads above no longer handle RecvTensor, so large tensor
+  // responses cannot head-of-line-block control RPCs such as RegisterGraph
+  // or RunGraph.  0 keeps all RPCs multiplexed on the serving threads.
+  int num_recv_tensor_threads = 0;
+
+  // If not kNUMANoAffinity, the dedicated RecvTensor threads are pinned to
+  // this NUMA node, which should be the one closest to the NIC.
+  int recv_tensor_numa_node = port::kNUMANoAffinity;
+
   // Setting cache_rpc_response to true will enable sender side caching of
   // response for RecvTensorAsync and RecvBufAsync to allow receiver to retry
   // requests . This is only necessary when the network fabric is experiencing a
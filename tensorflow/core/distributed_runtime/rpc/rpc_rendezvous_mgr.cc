@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <unordered_map>
 #include <unordered_set>
 
 #include "tensorflow/core/common_runtime/device.h"
@@ -32,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -53,6 +55,70 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRemoteRendezvous);
 };
 
+// When TF_GRPC_RECV_BUFFER_CACHE_SIZE is set to a positive value, the
+// destination tensors of up to that many RecvTensor calls are retained here,
+// keyed by rendezvous key, and offered to TensorResponse as pre-allocated
+// decode targets on subsequent receives of the same key. Gradient exchange
+// receives the same keys with the same shapes every step, so steady-state
+// receives decode straight into the previously-used buffer instead of a
+// freshly-allocated one. A buffer is handed out only once every reference
+// outside the cache has been dropped, so a consumer that is still reading
+// the tensor of a previous step can never be overwritten.
+class RecvBufferCache {
+ public:
+  static RecvBufferCache* Get() {
+    static RecvBufferCache* cache = new RecvBufferCache;
+    return cache;
+  }
+
+  bool enabled() const { return max_entries_ > 0; }
+
+  // Returns the cached tensor for "key", or an uninitialized tensor if no
+  // buffer is available. The entry is removed from the cache, so concurrent
+  // receives of the same key can never share a destination buffer.
+  Tensor Lookup(const string& key) {
+    mutex_lock l(mu_);
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+      return Tensor();
+    }
+    if (!DMAHelper::buffer(&it->second)->RefCountIsOne()) {
+      return Tensor();
+    }
+    Tensor result = std::move(it->second);
+    cache_.erase(it);
+    return result;
+  }
+
+  void Insert(const string& key, const Tensor& tensor) {
+    if (!DMAHelper::CanUseDMA(&tensor) || tensor.NumElements() == 0) {
+      return;
+    }
+    mutex_lock l(mu_);
+    if (cache_.size() >= max_entries_ && cache_.count(key) == 0) {
+      return;
+    }
+    cache_[key] = tensor;
+  }
+
+ private:
+  RecvBufferCache() {
+    int64 size = 0;
+    Status status =
+        ReadInt64FromEnvVar("TF_GRPC_RECV_BUFFER_CACHE_SIZE", 0, &size);
+    if (!status.ok()) {
+      LOG(ERROR) << "Invalid TF_GRPC_RECV_BUFFER_CACHE_SIZE: " << status;
+    }
+    max_entries_ = size < 0 ? 0 : size;
+  }
+
+  size_t max_entries_;
+  mutex mu_;
+  std::unordered_map<string, Tensor> cache_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(RecvBufferCache);
+};
+
 // Used only to retrieve tensors from remote processes.
 class RpcRecvTensorCall : public BaseRecvTensorCall {
  public:
@@ -136,14 +202,28 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   // Start the main RecvTensor call, checking for an async abort.
   void StartRTCall(std::function<void()> recv_done) {
     resp_.InitAlloc(dst_device_, alloc_attrs_);
+    RecvBufferCache* buffer_cache = RecvBufferCache::Get();
+    const bool cache_buffer =
+        buffer_cache->enabled() &&
+        (alloc_attrs_.on_host() ||
+         dst_device_->attributes().device_type() == "CPU");
+    if (cache_buffer) {
+      Tensor pre_allocated = buffer_cache->Lookup(req_.rendezvous_key());
+      if (pre_allocated.IsInitialized()) {
+        resp_.SetPreAllocated(std::move(pre_allocated));
+      }
+    }
     using namespace std::placeholders;
     StatusCallback cb = std::bind(
-        [this](std::function<void()> recv_done,
-               // Begin unbound arguments.
-               const Status& s) {
+        [this, cache_buffer](std::function<void()> recv_done,
+                             // Begin unbound arguments.
+                             const Status& s) {
           if (!s.ok()) {
             mutex_lock l(mu_);
             status_.Update(s);
+          } else if (cache_buffer) {
+            RecvBufferCache::Get()->Insert(req_.rendezvous_key(),
+                                           resp_.tensor());
           }
           recv_done();
         },
@@ -31,6 +31,7 @@ void TensorResponse::Clear() {
   alloc_attrs_ = AllocatorAttributes();
   allocator_ = nullptr;
   already_used_ = false;
+  pre_allocated_ = Tensor();
   ClearTensor();
 }
 
@@ -50,6 +51,34 @@ void TensorResponse::InitAlloc(DeviceBase* d, const AllocatorAttributes& aa) {
   allocator_ = device_->GetAllocator(alloc_attrs_);
 }
 
+void TensorResponse::SetPreAllocated(Tensor tensor) {
+  pre_allocated_ = std::move(tensor);
+}
+
+bool TensorResponse::CanReusePreAllocated(DataType dtype,
+                                          const TensorShape& shape) const {
+  return pre_allocated_.IsInitialized() && pre_allocated_.dtype() == dtype &&
+         pre_allocated_.shape() == shape;
+}
+
+Status TensorResponse::InitFromTensor(const Tensor& tensor, bool is_dead) {
+  meta_.set_is_dead(is_dead);
+  if (on_host_) {
+    tensor_ = tensor;
+    return Status::OK();
+  }
+  tensor.AsProtoTensorContent(meta_.mutable_tensor());
+  Status s = device_->MakeTensorFromProto(meta_.tensor(), alloc_attrs_,
+                                          &tensor_);
+  // Reduce memory usage for big tensors.
+  {
+    TensorProto empty;
+    meta_.mutable_tensor()->Swap(&empty);
+  }
+  meta_.clear_tensor();
+  return s;
+}
+
 Status TensorResponse::InitFrom(RecvTensorResponse* response) {
   Status s;
   meta_.Swap(response);
@@ -196,7 +225,9 @@ bool TensorResponse::ParseTensorSubmessage(
         if (!ReadVarintSizeAsInt(input, &num_bytes)) return false;
         seen_tensor_content = true;
         TensorShape shape(tensor_meta->tensor_shape());
-        Tensor t(allocator_, tensor_meta->dtype(), shape);
+        Tensor t = CanReusePreAllocated(tensor_meta->dtype(), shape)
+                       ? pre_allocated_
+                       : Tensor(allocator_, tensor_meta->dtype(), shape);
         StringPiece buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
         // TODO(jeff,sanjay): Figure out a way to avoid this copy if
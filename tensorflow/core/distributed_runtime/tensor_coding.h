@@ -46,6 +46,14 @@ class TensorResponse {
   // Initialize memory allocation related members.
   void InitAlloc(DeviceBase* d, const AllocatorAttributes& aa);
 
+  // Provides a pre-allocated destination for the incoming tensor. Must be
+  // called after InitAlloc. If the response carries a tensor of matching
+  // dtype and shape (and the fast memcpy decode path applies), its contents
+  // are decoded directly into the buffer of "tensor" instead of into a
+  // freshly-allocated one. The caller must guarantee that nothing else reads
+  // or writes the buffer while the RPC is in flight.
+  void SetPreAllocated(Tensor tensor);
+
   // Source provides a way for a particular RPC implementation to provide
   // received data to ParseFrom.
   class Source {
@@ -74,6 +82,12 @@ class TensorResponse {
   // Leaves *response with unspecified contents.
   Status InitFrom(RecvTensorResponse* response);
 
+  // Initialize directly from an already-materialized host tensor, without
+  // any serialization. If the destination is not host memory, the tensor is
+  // routed through the device's tensor-proto path instead. Used by
+  // in-process transports.
+  Status InitFromTensor(const Tensor& tensor, bool is_dead);
+
   // Initialize tensor metadata from response and allocate
   // uninitialized backing storage for actual contents.
   void InitPartial(const RecvTensorResponse& response,
@@ -96,6 +110,7 @@ class TensorResponse {
                              TensorProto* tensor_meta);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
+  bool CanReusePreAllocated(DataType dtype, const TensorShape& shape) const;
 
   bool on_host_ = false;
   DeviceBase* device_ = nullptr;
@@ -103,6 +118,7 @@ class TensorResponse {
   Allocator* allocator_ = nullptr;
   bool already_used_ = false;
   Tensor tensor_;
+  Tensor pre_allocated_;
   RecvTensorResponse meta_;
 };
 
@@ -156,6 +156,42 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(TensorResponseTest, PreAllocated) {
+  Tensor src(DT_FLOAT, TensorShape({4, 8}));
+  test::FillFn<float>(&src, [](int i) { return static_cast<float>(i); });
+
+  RecvTensorResponse proto;
+  proto.set_is_dead(false);
+  proto.set_send_start_micros(123456);
+  src.AsProtoTensorContent(proto.mutable_tensor());
+  string encoded;
+  proto.AppendToString(&encoded);
+  StringSource source(&encoded, 1024);
+
+  TensorResponse response;
+  DummyDevice cpu_device(Env::Default());
+
+  // A pre-allocated tensor of matching dtype and shape is used as the decode
+  // destination.
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  Tensor pre_allocated(cpu_allocator(), DT_FLOAT, TensorShape({4, 8}));
+  const char* pre_allocated_base = pre_allocated.tensor_data().data();
+  response.SetPreAllocated(pre_allocated);
+  EXPECT_TRUE(response.ParseFrom(&source).ok());
+  EXPECT_EQ(pre_allocated_base, response.tensor().tensor_data().data());
+  EXPECT_EQ(src.DebugString(), response.tensor().DebugString());
+
+  // A pre-allocated tensor of the wrong shape is ignored and a fresh tensor
+  // is allocated instead.
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  Tensor wrong_shape(cpu_allocator(), DT_FLOAT, TensorShape({2, 8}));
+  response.SetPreAllocated(wrong_shape);
+  EXPECT_TRUE(response.ParseFrom(&source).ok());
+  EXPECT_NE(wrong_shape.tensor_data().data(),
+            response.tensor().tensor_data().data());
+  EXPECT_EQ(src.DebugString(), response.tensor().DebugString());
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
@@ -445,14 +445,68 @@ Status Worker::PrepareRecvTensor(const Rendezvous::ParsedKey& parsed,
   return Status::OK();
 }
 
+// RecvTensorAsync is used for worker-to-worker communication within one
+// process: the requested tensor is handed to the response directly, without
+// any serialization. Cross-process transports use a transport-specific
+// implementation (such as `GrpcWorker::GrpcRecvTensorAsync()`) instead.
 void Worker::RecvTensorAsync(CallOptions* opts,
                              const RecvTensorRequest* request,
                              TensorResponse* response, StatusCallback done) {
-  // The base Worker class does not implement RecvTensorAsync, because
-  // it is not currently used for worker-to-worker communication. Use a
-  // transport-specific implementation (such as `GrpcWorker::RecvTensorAsync()`)
-  // instead.
-  done(errors::Unimplemented("Worker::RecvTensorAsync()"));
+  const int64 step_id = request->step_id();
+  const string& key = request->rendezvous_key();
+  TRACEPRINTF("RecvTensor: %lld %s", step_id, key.c_str());
+  Rendezvous::ParsedKey parsed;
+  Status s = Rendezvous::ParseKey(key, &parsed);
+  Device* src_dev = nullptr;
+  if (s.ok()) {
+    s = PrepareRecvTensor(parsed, &src_dev);
+  }
+  if (!s.ok()) {
+    done(s);
+    return;
+  }
+
+  opts->SetCancelCallback(
+      [step_id]() { LOG(WARNING) << "RecvTensor cancelled for " << step_id; });
+  env_->rendezvous_mgr->RecvLocalAsync(
+      step_id, parsed,
+      [opts, request, response, done, src_dev](
+          const Status& status, const Rendezvous::Args& send_args,
+          const Rendezvous::Args& recv_args, const Tensor& val,
+          const bool is_dead) {
+        opts->ClearCancelCallback();
+        if (!status.ok()) {
+          done(status);
+          return;
+        }
+        const bool on_host = send_args.alloc_attrs.on_host();
+        if (src_dev->tensorflow_gpu_device_info() && !on_host) {
+          // "val" lives on an accelerator: stage it in host memory before
+          // handing it to the response.
+          DeviceContext* send_dev_context = send_args.device_context;
+          AllocatorAttributes alloc_attrs;
+          alloc_attrs.set_gpu_compatible(true);
+          alloc_attrs.set_on_host(true);
+          Allocator* alloc = src_dev->GetAllocator(alloc_attrs);
+          Tensor* copy = new Tensor(alloc, val.dtype(), val.shape());
+          CHECK(send_dev_context)
+              << "send dev name: " << src_dev->name()
+              << " gpu_info: " << src_dev->tensorflow_gpu_device_info();
+          StatusCallback copy_ready = [response, done, copy,
+                                       is_dead](const Status& s) {
+            if (s.ok()) {
+              done(response->InitFromTensor(*copy, is_dead));
+            } else {
+              done(s);
+            }
+            delete copy;
+          };
+          send_dev_context->CopyDeviceTensorToCPU(
+              &val, request->rendezvous_key(), src_dev, copy, copy_ready);
+          return;
+        }
+        done(response->InitFromTensor(val, is_dead));
+      });
 }
 
 }  // namespace tensorflow
@@ -28,14 +28,21 @@ limitations under the License.
 namespace tensorflow {
 
 string AllocatorStats::DebugString() const {
-  return strings::Printf(
+  string s = strings::Printf(
       "Limit:        %20lld\n"
       "InUse:        %20lld\n"
       "MaxInUse:     %20lld\n"
       "NumAllocs:    %20lld\n"
-      "MaxAllocSize: %20lld\n",
+      "MaxAllocSize: %20lld\n"
+      "MaxFreeBlock: %20lld\n",
       this->bytes_limit ? *this->bytes_limit : 0, this->bytes_in_use,
-      this->peak_bytes_in_use, this->num_allocs, this->largest_alloc_size);
+      this->peak_bytes_in_use, this->num_allocs, this->largest_alloc_size,
+      this->largest_free_block_bytes);
+  for (const SizeClassStats& sc : this->size_class_stats) {
+    strings::Appendf(&s, "SizeClass %10lld: Hits: %12lld Misses: %12lld\n",
+                     sc.class_bytes, sc.hits, sc.misses);
+  }
+  return s;
 }
 
 constexpr size_t Allocator::kAllocatorAlignment;
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <functional>
 #include <limits>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -82,13 +83,28 @@ struct AllocatorStats {
   // if such a limit is known.
   absl::optional<int64> bytes_reservable_limit;
 
+  // The largest contiguous free block available, for allocators that track
+  // their free space (e.g. BFCAllocator).  A large gap between this value
+  // and (bytes_limit - bytes_in_use) indicates fragmentation.
+  int64 largest_free_block_bytes;
+
+  // Per-size-class counters for allocators that pool freed chunks by
+  // size class (e.g. SizeClassAllocator).  Empty for other allocators.
+  struct SizeClassStats {
+    int64 class_bytes = 0;  // Upper bound of the size class, in bytes.
+    int64 hits = 0;         // Allocations served from the free list.
+    int64 misses = 0;       // Allocations that went to the backing store.
+  };
+  std::vector<SizeClassStats> size_class_stats;
+
   AllocatorStats()
       : num_allocs(0),
         bytes_in_use(0),
         peak_bytes_in_use(0),
         largest_alloc_size(0),
         bytes_reserved(0),
-        peak_bytes_reserved(0) {}
+        peak_bytes_reserved(0),
+        largest_free_block_bytes(0) {}
 
   string DebugString() const;
 };
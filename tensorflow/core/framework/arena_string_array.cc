@@ -0,0 +1,59 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/arena_string_array.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+Status ArenaStringArray::ToTensor(Tensor* tensor) const {
+  if (tensor->dtype() != DT_STRING) {
+    return errors::InvalidArgument("Expected a string tensor, got ",
+                                   DataTypeString(tensor->dtype()));
+  }
+  if (tensor->NumElements() != size()) {
+    return errors::InvalidArgument("Tensor holds ", tensor->NumElements(),
+                                   " elements but the array holds ", size());
+  }
+  auto flat = tensor->flat<string>();
+  for (int64 i = 0; i < size(); ++i) {
+    StringPiece elem = (*this)[i];
+    flat(i).assign(elem.data(), elem.size());
+  }
+  return Status::OK();
+}
+
+Status ArenaStringArray::FromTensor(const Tensor& tensor) {
+  if (tensor.dtype() != DT_STRING) {
+    return errors::InvalidArgument("Expected a string tensor, got ",
+                                   DataTypeString(tensor.dtype()));
+  }
+  const auto flat = tensor.flat<string>();
+  const int64 n = flat.size();
+  int64 payload_bytes = 0;
+  for (int64 i = 0; i < n; ++i) {
+    payload_bytes += flat(i).size();
+  }
+  Clear();
+  Reserve(n, payload_bytes);
+  for (int64 i = 0; i < n; ++i) {
+    Append(flat(i));
+  }
+  return Status::OK();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,101 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_FRAMEWORK_ARENA_STRING_ARRAY_H_
+#define TENSORFLOW_CORE_FRAMEWORK_ARENA_STRING_ARRAY_H_
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class Tensor;
+
+// A compact batch of strings: one contiguous payload buffer plus an
+// offset array.  Appending n strings costs O(1) amortized heap
+// allocations in total, instead of one per element, and elements are
+// laid out adjacently so scans stay cache-friendly.
+//
+// This is a staging representation for string-heavy kernels, not a
+// tensor format: DT_STRING tensors store std::string elements, which
+// own their payloads and cannot alias an arena.  ToTensor() therefore
+// materializes each element once at the tensor boundary, and
+// FromTensor() flattens an existing string tensor for repeated
+// scanning.  Elements accessed through operator[] are views into the
+// arena and are invalidated by Append.
+class ArenaStringArray {
+ public:
+  ArenaStringArray() { offsets_.push_back(0); }
+
+  // Pre-sizes the arena for num_elements strings totalling
+  // payload_bytes bytes of character data.
+  void Reserve(int64 num_elements, int64 payload_bytes) {
+    offsets_.reserve(num_elements + 1);
+    payload_.reserve(payload_bytes);
+  }
+
+  // Appends a copy of "str" to the arena.
+  void Append(StringPiece str) {
+    payload_.append(str.data(), str.size());
+    offsets_.push_back(payload_.size());
+  }
+
+  int64 size() const { return offsets_.size() - 1; }
+
+  int64 payload_bytes() const { return payload_.size(); }
+
+  // Returns a view of element i, valid until the next Append or the
+  // destruction of this array.
+  StringPiece operator[](int64 i) const {
+    DCHECK_GE(i, 0);
+    DCHECK_LT(i, size());
+    return StringPiece(payload_.data() + offsets_[i],
+                       offsets_[i + 1] - offsets_[i]);
+  }
+
+  // Discards all elements but keeps the underlying buffers, so a
+  // kernel can reuse one array across batches.
+  void Clear() {
+    payload_.clear();
+    offsets_.resize(1);
+  }
+
+  // Materializes the elements into "tensor", which must be a
+  // DT_STRING tensor with exactly size() elements.  Each element is
+  // copied once.
+  Status ToTensor(Tensor* tensor) const;
+
+  // Replaces the contents of this array with the flattened elements
+  // of "tensor", which must be a DT_STRING tensor.  The result is a
+  // single contiguous copy of the tensor's character data.
+  Status FromTensor(const Tensor& tensor);
+
+ private:
+  string payload_;
+  // offsets_[i] .. offsets_[i + 1] delimit element i; always holds at
+  // least the leading 0.
+  std::vector<size_t> offsets_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ArenaStringArray);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_ARENA_STRING_ARRAY_H_
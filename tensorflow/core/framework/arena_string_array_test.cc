@@ -0,0 +1,81 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/arena_string_array.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(ArenaStringArrayTest, AppendAndView) {
+  ArenaStringArray array;
+  EXPECT_EQ(0, array.size());
+
+  array.Append("hello");
+  array.Append("");
+  array.Append("world");
+
+  EXPECT_EQ(3, array.size());
+  EXPECT_EQ(10, array.payload_bytes());
+  EXPECT_EQ("hello", array[0]);
+  EXPECT_EQ("", array[1]);
+  EXPECT_EQ("world", array[2]);
+
+  // Elements are adjacent in one payload buffer.
+  EXPECT_EQ(array[0].data() + array[0].size(), array[2].data());
+
+  array.Clear();
+  EXPECT_EQ(0, array.size());
+  EXPECT_EQ(0, array.payload_bytes());
+}
+
+TEST(ArenaStringArrayTest, ToTensor) {
+  ArenaStringArray array;
+  array.Append("a");
+  array.Append("bc");
+
+  Tensor tensor(DT_STRING, TensorShape({2}));
+  TF_ASSERT_OK(array.ToTensor(&tensor));
+  EXPECT_EQ("a", tensor.vec<string>()(0));
+  EXPECT_EQ("bc", tensor.vec<string>()(1));
+
+  Tensor wrong_size(DT_STRING, TensorShape({3}));
+  EXPECT_FALSE(array.ToTensor(&wrong_size).ok());
+  Tensor wrong_type(DT_INT32, TensorShape({2}));
+  EXPECT_FALSE(array.ToTensor(&wrong_type).ok());
+}
+
+TEST(ArenaStringArrayTest, FromTensor) {
+  Tensor tensor(DT_STRING, TensorShape({3}));
+  tensor.vec<string>()(0) = "x";
+  tensor.vec<string>()(1) = "yz";
+  tensor.vec<string>()(2) = "";
+
+  ArenaStringArray array;
+  TF_ASSERT_OK(array.FromTensor(tensor));
+  EXPECT_EQ(3, array.size());
+  EXPECT_EQ("x", array[0]);
+  EXPECT_EQ("yz", array[1]);
+  EXPECT_EQ("", array[2]);
+
+  Tensor wrong_type(DT_INT32, TensorShape({2}));
+  EXPECT_FALSE(array.FromTensor(wrong_type).ok());
+}
+
+}  // namespace
+}  // namespace tensorflow
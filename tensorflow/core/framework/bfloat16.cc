@@ -15,9 +15,24 @@ limitations under the License.
 
 #include "tensorflow/core/framework/bfloat16.h"
 
+#include "tensorflow/core/platform/cpu_dispatch.h"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace tensorflow {
+namespace {
 
-void FloatToBFloat16(const float* src, bfloat16* dst, int64 size) {
+// A bfloat16 is the high half of a float's bit pattern, so both conversions
+// are pure byte shuffles. The scalar loops below are the portable fallback;
+// the SIMD variants move 8-16 elements per iteration and are selected once
+// at first use based on the host CPU.
+
+void FloatToBFloat16Scalar(const float* src, bfloat16* dst, int64 size) {
   const uint16_t* p = reinterpret_cast<const uint16_t*>(src);
   uint16_t* q = reinterpret_cast<uint16_t*>(dst);
 #if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
@@ -31,7 +46,7 @@ void FloatToBFloat16(const float* src, bfloat16* dst, int64 size) {
 #endif
 }
 
-void BFloat16ToFloat(const bfloat16* src, float* dst, int64 size) {
+void BFloat16ToFloatScalar(const bfloat16* src, float* dst, int64 size) {
   const uint16_t* p = reinterpret_cast<const uint16_t*>(src);
   uint16_t* q = reinterpret_cast<uint16_t*>(dst);
 #if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
@@ -47,4 +62,132 @@ void BFloat16ToFloat(const bfloat16* src, float* dst, int64 size) {
 #endif
 }
 
+#if defined(__AVX512F__)
+void FloatToBFloat16Avx512(const float* src, bfloat16* dst, int64 size) {
+  int64 i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m512i v =
+        _mm512_loadu_si512(reinterpret_cast<const void*>(src + i));
+    const __m256i hi = _mm512_cvtepi32_epi16(_mm512_srli_epi32(v, 16));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), hi);
+  }
+  FloatToBFloat16Scalar(src + i, dst + i, size - i);
+}
+
+void BFloat16ToFloatAvx512(const bfloat16* src, float* dst, int64 size) {
+  int64 i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m512i w = _mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16);
+    _mm512_storeu_si512(reinterpret_cast<void*>(dst + i), w);
+  }
+  BFloat16ToFloatScalar(src + i, dst + i, size - i);
+}
+#endif  // __AVX512F__
+
+#if defined(__AVX2__)
+void FloatToBFloat16Avx2(const float* src, bfloat16* dst, int64 size) {
+  int64 i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i v0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i v1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8));
+    // The shifted words are at most 0xffff, so the unsigned-saturating pack
+    // is exact. Packing interleaves the two 128-bit lanes; the permute
+    // restores element order.
+    const __m256i packed = _mm256_packus_epi32(_mm256_srli_epi32(v0, 16),
+                                               _mm256_srli_epi32(v1, 16));
+    const __m256i ordered = _mm256_permute4x64_epi64(packed, 0xd8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), ordered);
+  }
+  FloatToBFloat16Scalar(src + i, dst + i, size - i);
+}
+
+void BFloat16ToFloatAvx2(const bfloat16* src, float* dst, int64 size) {
+  int64 i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m256i w = _mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 16);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), w);
+  }
+  BFloat16ToFloatScalar(src + i, dst + i, size - i);
+}
+#endif  // __AVX2__
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+void FloatToBFloat16Neon(const float* src, bfloat16* dst, int64 size) {
+  const uint32_t* p = reinterpret_cast<const uint32_t*>(src);
+  uint16_t* q = reinterpret_cast<uint16_t*>(dst);
+  int64 i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const uint16x4_t lo = vshrn_n_u32(vld1q_u32(p + i), 16);
+    const uint16x4_t hi = vshrn_n_u32(vld1q_u32(p + i + 4), 16);
+    vst1q_u16(q + i, vcombine_u16(lo, hi));
+  }
+  FloatToBFloat16Scalar(src + i, dst + i, size - i);
+}
+
+void BFloat16ToFloatNeon(const bfloat16* src, float* dst, int64 size) {
+  const uint16_t* p = reinterpret_cast<const uint16_t*>(src);
+  uint32_t* q = reinterpret_cast<uint32_t*>(dst);
+  int64 i = 0;
+  for (; i + 4 <= size; i += 4) {
+    vst1q_u32(q + i, vshlq_n_u32(vmovl_u16(vld1_u16(p + i)), 16));
+  }
+  BFloat16ToFloatScalar(src + i, dst + i, size - i);
+}
+#endif  // __ARM_NEON__ && little-endian
+
+typedef void (*FloatToBFloat16Fn)(const float*, bfloat16*, int64);
+typedef void (*BFloat16ToFloatFn)(const bfloat16*, float*, int64);
+
+// NEON has no runtime feature bit in CPUFeature; when targeting NEON the
+// vector version is unconditionally usable, so it serves as the fallback.
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+constexpr FloatToBFloat16Fn kFloatToBFloat16Fallback = FloatToBFloat16Neon;
+constexpr BFloat16ToFloatFn kBFloat16ToFloatFallback = BFloat16ToFloatNeon;
+constexpr char kFallbackName[] = "neon";
+#else
+constexpr FloatToBFloat16Fn kFloatToBFloat16Fallback = FloatToBFloat16Scalar;
+constexpr BFloat16ToFloatFn kBFloat16ToFloatFallback = BFloat16ToFloatScalar;
+constexpr char kFallbackName[] = "scalar";
+#endif
+
+}  // namespace
+
+void FloatToBFloat16(const float* src, bfloat16* dst, int64 size) {
+  static const FloatToBFloat16Fn fn =
+      port::CpuDispatcher<FloatToBFloat16Fn>("FloatToBFloat16", kFallbackName,
+                                             kFloatToBFloat16Fallback)
+#if defined(__AVX512F__)
+          .AddVariant(port::CPUFeature::AVX512F, "avx512f",
+                      FloatToBFloat16Avx512)
+#endif
+#if defined(__AVX2__)
+          .AddVariant(port::CPUFeature::AVX2, "avx2", FloatToBFloat16Avx2)
+#endif
+          .Resolve();
+  fn(src, dst, size);
+}
+
+void BFloat16ToFloat(const bfloat16* src, float* dst, int64 size) {
+  static const BFloat16ToFloatFn fn =
+      port::CpuDispatcher<BFloat16ToFloatFn>("BFloat16ToFloat", kFallbackName,
+                                             kBFloat16ToFloatFallback)
+#if defined(__AVX512F__)
+          .AddVariant(port::CPUFeature::AVX512F, "avx512f",
+                      BFloat16ToFloatAvx512)
+#endif
+#if defined(__AVX2__)
+          .AddVariant(port::CPUFeature::AVX2, "avx2", BFloat16ToFloatAvx2)
+#endif
+          .Resolve();
+  fn(src, dst, size);
+}
+
 }  // end namespace tensorflow
@@ -150,6 +150,27 @@ TEST(Bfloat16Test, Negate) {
   EXPECT_EQ(4.5f, static_cast<float>(-bfloat16(-4.5f)));
 }
 
+TEST(Bfloat16Test, ConversionBuffers) {
+  // A length that exercises both the vector body and the scalar tail of the
+  // runtime-dispatched conversion routines.
+  const int N = 100;
+  std::vector<float> inp(N);
+  for (int i = 0; i < N; ++i) {
+    inp[i] = 0.25f * i - 12.5f;
+  }
+  std::vector<bfloat16> converted(N);
+  FloatToBFloat16(inp.data(), converted.data(), N);
+  for (int i = 0; i < N; ++i) {
+    EXPECT_EQ(absl::bit_cast<uint32_t>(inp[i]) >> 16, converted[i].value);
+  }
+  std::vector<float> out(N);
+  BFloat16ToFloat(converted.data(), out.data(), N);
+  for (int i = 0; i < N; ++i) {
+    EXPECT_EQ(static_cast<uint32_t>(converted[i].value) << 16,
+              absl::bit_cast<uint32_t>(out[i]));
+  }
+}
+
 static void BM_FloatToBFloat16(int iters) {
   testing::StopTiming();
   static const int N = 32 << 20;
@@ -25,31 +25,54 @@ const CancellationToken CancellationManager::kInvalidToken = -1;
 CancellationManager::CancellationManager()
     : is_cancelling_(false),
       is_cancelled_(false),
-      next_cancellation_token_(0) {}
+      next_cancellation_token_(0),
+      parent_(nullptr),
+      parent_token_(kInvalidToken) {}
+
+CancellationManager::CancellationManager(CancellationManager* parent)
+    : is_cancelling_(false),
+      is_cancelled_(false),
+      next_cancellation_token_(0),
+      parent_(parent),
+      parent_token_(parent->get_cancellation_token()) {
+  if (!parent->RegisterCallback(parent_token_, [this]() { StartCancel(); })) {
+    StartCancel();
+  }
+}
 
 void CancellationManager::Reset() {
   mutex_lock l(mu_);
   is_cancelling_ = false;
   is_cancelled_.store(false);
+  for (CallbackShard& shard : shards_) {
+    mutex_lock shard_lock(shard.mu);
+    shard.cancel_started = false;
+  }
 }
 
 void CancellationManager::StartCancel() {
-  gtl::FlatMap<CancellationToken, CancelCallback> callbacks_to_run;
   {
     mutex_lock l(mu_);
     if (is_cancelled_.load(std::memory_order_relaxed) || is_cancelling_) {
       return;
     }
     is_cancelling_ = true;
-    std::swap(callbacks_, callbacks_to_run);
   }
-  // We call these callbacks without holding mu_, so that concurrent
+  // We run the callbacks without holding any locks, so that concurrent
   // calls to DeregisterCallback, which can happen asynchronously, do
   // not block. The callbacks remain valid because any concurrent call
-  // to DeregisterCallback will block until the
-  // cancelled_notification_ is notified.
-  for (auto key_and_value : callbacks_to_run) {
-    key_and_value.second();
+  // to DeregisterCallback on an already-drained shard will block until
+  // the cancelled_notification_ is notified.
+  for (CallbackShard& shard : shards_) {
+    gtl::FlatMap<CancellationToken, CancelCallback> callbacks_to_run;
+    {
+      mutex_lock l(shard.mu);
+      shard.cancel_started = true;
+      std::swap(shard.callbacks, callbacks_to_run);
+    }
+    for (auto& key_and_value : callbacks_to_run) {
+      key_and_value.second();
+    }
   }
   {
     mutex_lock l(mu_);
@@ -60,53 +83,68 @@ void CancellationManager::StartCancel() {
 }
 
 CancellationToken CancellationManager::get_cancellation_token() {
-  mutex_lock l(mu_);
-  return next_cancellation_token_++;
+  return next_cancellation_token_.fetch_add(1, std::memory_order_relaxed);
 }
 
 bool CancellationManager::RegisterCallback(CancellationToken token,
                                            CancelCallback callback) {
-  mutex_lock l(mu_);
-  CHECK_LT(token, next_cancellation_token_) << "Invalid cancellation token";
-  bool should_register = !is_cancelled_ && !is_cancelling_;
-  if (should_register) {
-    std::swap(callbacks_[token], callback);
+  CHECK_LT(token, next_cancellation_token_.load(std::memory_order_relaxed))
+      << "Invalid cancellation token";
+  if (is_cancelled_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  CallbackShard& shard = callback_shard(token);
+  mutex_lock l(shard.mu);
+  if (shard.cancel_started) {
+    return false;
   }
-  return should_register;
+  std::swap(shard.callbacks[token], callback);
+  return true;
 }
 
 bool CancellationManager::DeregisterCallback(CancellationToken token) {
-  mu_.lock();
-  if (is_cancelled_) {
-    mu_.unlock();
-    return false;
-  } else if (is_cancelling_) {
-    mu_.unlock();
-    // Wait for all of the cancellation callbacks to be called. This
-    // wait ensures that the caller of DeregisterCallback does not
-    // return immediately and free objects that may be used in the
-    // execution of any currently pending callbacks in StartCancel.
+  CallbackShard& shard = callback_shard(token);
+  {
+    mutex_lock l(shard.mu);
+    if (!shard.cancel_started) {
+      shard.callbacks.erase(token);
+      return true;
+    }
+  }
+  if (!is_cancelled_.load(std::memory_order_acquire)) {
+    // Cancellation is in progress. Wait for all of the cancellation
+    // callbacks to be called. This wait ensures that the caller of
+    // DeregisterCallback does not return immediately and free objects
+    // that may be used in the execution of any currently pending
+    // callbacks in StartCancel.
     cancelled_notification_.WaitForNotification();
-    return false;
-  } else {
-    callbacks_.erase(token);
-    mu_.unlock();
-    return true;
   }
+  return false;
 }
 
 bool CancellationManager::TryDeregisterCallback(CancellationToken token) {
-  mutex_lock lock(mu_);
-  if (is_cancelled_ || is_cancelling_) {
+  CallbackShard& shard = callback_shard(token);
+  mutex_lock lock(shard.mu);
+  if (shard.cancel_started) {
     return false;
-  } else {
-    callbacks_.erase(token);
-    return true;
   }
+  shard.callbacks.erase(token);
+  return true;
 }
 
 CancellationManager::~CancellationManager() {
-  if (!callbacks_.empty()) {
+  if (parent_ != nullptr) {
+    parent_->DeregisterCallback(parent_token_);
+  }
+  bool has_callbacks = false;
+  for (CallbackShard& shard : shards_) {
+    mutex_lock l(shard.mu);
+    if (!shard.callbacks.empty()) {
+      has_callbacks = true;
+      break;
+    }
+  }
+  if (has_callbacks) {
     StartCancel();
   }
 }
@@ -48,6 +48,14 @@ class CancellationManager {
   static const CancellationToken kInvalidToken;
 
   CancellationManager();
+
+  // Constructs a manager chained to "parent": cancelling the parent also
+  // cancels this manager. Must not outlive "parent". This allows e.g.
+  // per-executor managers under a step-level manager, so that per-op
+  // registrations spread over many managers instead of all contending
+  // on the step manager's tables.
+  explicit CancellationManager(CancellationManager* parent);
+
   ~CancellationManager();
 
   // Run all callbacks associated with this manager.
@@ -135,13 +143,31 @@ class CancellationManager {
   bool TryDeregisterCallback(CancellationToken token);
 
  private:
+  // The callback table is sharded; a token's shard is encoded in its low
+  // bits and tokens are handed out round-robin, so concurrent
+  // registrations mostly take different locks.
+  static constexpr int kNumShards = 8;
+  struct CallbackShard {
+    mutex mu;
+    // Set once StartCancel() has drained this shard; cleared by Reset().
+    bool cancel_started GUARDED_BY(mu) = false;
+    gtl::FlatMap<CancellationToken, CancelCallback> callbacks GUARDED_BY(mu);
+  };
+
+  CallbackShard& callback_shard(CancellationToken token) {
+    return shards_[token % kNumShards];
+  }
+
   bool is_cancelling_;
   std::atomic_bool is_cancelled_;
+  std::atomic<CancellationToken> next_cancellation_token_;
+
+  CancellationManager* const parent_;
+  CancellationToken parent_token_;
 
-  mutex mu_;
+  mutex mu_;  // Serializes StartCancel() and Reset().
   Notification cancelled_notification_;
-  CancellationToken next_cancellation_token_ GUARDED_BY(mu_);
-  gtl::FlatMap<CancellationToken, CancelCallback> callbacks_ GUARDED_BY(mu_);
+  CallbackShard shards_[kNumShards];
 };
 
 }  // namespace tensorflow
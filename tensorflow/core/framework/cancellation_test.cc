@@ -142,6 +142,66 @@ TEST(Cancellation, TryDeregisterAfterCancel) {
   delete manager;
 }
 
+TEST(Cancellation, ParentCancelsChild) {
+  bool is_cancelled = false;
+  CancellationManager* parent = new CancellationManager();
+  CancellationManager* child = new CancellationManager(parent);
+  auto token = child->get_cancellation_token();
+  bool registered = child->RegisterCallback(
+      token, [&is_cancelled]() { is_cancelled = true; });
+  EXPECT_TRUE(registered);
+  parent->StartCancel();
+  EXPECT_TRUE(child->IsCancelled());
+  EXPECT_TRUE(is_cancelled);
+  delete child;
+  delete parent;
+}
+
+TEST(Cancellation, ChildCancelLeavesParentUntouched) {
+  bool parent_cancelled = false;
+  CancellationManager* parent = new CancellationManager();
+  auto parent_token = parent->get_cancellation_token();
+  bool registered = parent->RegisterCallback(
+      parent_token, [&parent_cancelled]() { parent_cancelled = true; });
+  EXPECT_TRUE(registered);
+  CancellationManager* child = new CancellationManager(parent);
+  child->StartCancel();
+  EXPECT_TRUE(child->IsCancelled());
+  EXPECT_FALSE(parent->IsCancelled());
+  EXPECT_FALSE(parent_cancelled);
+  delete child;
+  EXPECT_TRUE(parent->DeregisterCallback(parent_token));
+  delete parent;
+}
+
+TEST(Cancellation, ChildOfCancelledParent) {
+  CancellationManager* parent = new CancellationManager();
+  parent->StartCancel();
+  CancellationManager* child = new CancellationManager(parent);
+  EXPECT_TRUE(child->IsCancelled());
+  auto token = child->get_cancellation_token();
+  bool registered = child->RegisterCallback(token, nullptr);
+  EXPECT_FALSE(registered);
+  delete child;
+  delete parent;
+}
+
+TEST(Cancellation, DestroyedChildDoesNotFireOnParentCancel) {
+  bool is_cancelled = false;
+  CancellationManager* parent = new CancellationManager();
+  CancellationManager* child = new CancellationManager(parent);
+  auto token = child->get_cancellation_token();
+  bool registered = child->RegisterCallback(
+      token, [&is_cancelled]() { is_cancelled = true; });
+  EXPECT_TRUE(registered);
+  bool deregistered = child->DeregisterCallback(token);
+  EXPECT_TRUE(deregistered);
+  delete child;
+  parent->StartCancel();
+  EXPECT_FALSE(is_cancelled);
+  delete parent;
+}
+
 TEST(Cancellation, TryDeregisterDuringCancel) {
   Notification cancel_started, finish_callback, cancel_complete;
   CancellationManager* manager = new CancellationManager();
@@ -484,6 +484,27 @@ class IteratorBase {
     return GetNext(&ctx, out_tensors, end_of_sequence);
   }
 
+  // Returns true if this iterator can write its next element directly into
+  // a slice of caller-allocated batch tensors via `GetNextSlice()`.
+  virtual bool SupportsSlicedOutput() const { return false; }
+
+  // Writes the next output of this iterator into row `index` of the
+  // pre-allocated tensors in `*batch_tensors` (one tensor per tuple
+  // component, each with an additional leading batch dimension).
+  //
+  // Batch-aware callers use this to avoid the per-element allocation and
+  // copy that `GetNext()` implies. The semantics of `*end_of_sequence`
+  // match `GetNext()`; when `true` is stored in `*end_of_sequence`, the
+  // contents of row `index` are undefined.
+  //
+  // Only iterators for which `SupportsSlicedOutput()` returns true
+  // implement this method.
+  virtual Status GetNextSlice(IteratorContext* ctx,
+                              std::vector<Tensor>* batch_tensors, int64 index,
+                              bool* end_of_sequence) {
+    return errors::Unimplemented("GetNextSlice");
+  }
+
   // Returns a vector of DataType values, representing the respective
   // element types of each tuple component in the outputs of this
   // iterator.
@@ -789,6 +810,10 @@ class DatasetBaseIterator : public IteratorBase {
     }
   }
 
+  // When modeling is enabled, returns the model node for this iterator;
+  // otherwise returns nullptr.
+  model::Node* model_node() const { return node_; }
+
   // When modeling is enabled, this method records the fact that this iterator
   // has dequeued an element from an internal buffer.
   void RecordBufferDequeue(IteratorContext* ctx,
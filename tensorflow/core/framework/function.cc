@@ -1012,6 +1012,16 @@ Status FunctionCallFrame::GetArg(int index, Tensor* val) const {
   return Status::OK();
 }
 
+bool FunctionCallFrame::CanConsumeArg(int index) const {
+  return args_consumable_ && index >= 0 &&
+         static_cast<size_t>(index) < args_.size();
+}
+
+void FunctionCallFrame::ConsumeArg(int index, Tensor* val) {
+  DCHECK(CanConsumeArg(index));
+  *val = std::move(args_[index]);
+}
+
 Status FunctionCallFrame::SetRetval(int index, const Tensor& val) {
   if (index < 0 || static_cast<size_t>(index) >= rets_.size()) {
     return errors::InvalidArgument("SetRetval ", index, " is not within [0, ",
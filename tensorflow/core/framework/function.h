@@ -266,6 +266,18 @@ class CallFrameInterface {
 
   virtual Status GetArg(int index, Tensor* val) const = 0;
   virtual Status SetRetval(int index, const Tensor& val) = 0;
+
+  // If true, the callee may call ConsumeArg() to take over the frame's
+  // reference to argument "index" instead of copying it with GetArg().
+  // Dropping the frame's reference lets in-place ops in the function body
+  // see unique buffer ownership and forward the argument's buffer.
+  virtual bool CanConsumeArg(int index) const { return false; }
+
+  // Moves argument "index" out of the frame.
+  // REQUIRES: CanConsumeArg(index).
+  virtual void ConsumeArg(int index, Tensor* val) {
+    LOG(FATAL) << "This CallFrameInterface does not support ConsumeArg()";
+  }
 };
 
 // Represents a function call frame. I.e., the data structure used to
@@ -294,10 +306,19 @@ class FunctionCallFrame : public CallFrameInterface {
   Status GetArg(int index, Tensor* val) const override;
   Status SetRetval(int index, const Tensor& val) override;
 
+  bool CanConsumeArg(int index) const override;
+  void ConsumeArg(int index, Tensor* val) override;
+
+  // Allows the callee to consume the frame's arguments.  Only safe when
+  // each argument is read at most once (the usual case: one _Arg kernel
+  // per index) and the frame is discarded after a single call.
+  void MarkArgsConsumable(bool consumable) { args_consumable_ = consumable; }
+
  private:
   DataTypeVector arg_types_;
   DataTypeVector ret_types_;
   gtl::InlinedVector<Tensor, 4> args_;
+  bool args_consumable_ = false;
   struct Retval {
     bool has_val = false;
     Tensor val;
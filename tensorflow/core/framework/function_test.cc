@@ -951,6 +951,29 @@ TEST(FunctionCallFrame, Float_Float_Float) {
   test::ExpectTensorEqual<float>(rets[0], v);
 }
 
+TEST(FunctionCallFrame, ConsumeArgs) {
+  FunctionCallFrame frame({DT_FLOAT, DT_FLOAT}, {});
+  auto a = test::AsTensor<float>({100});
+  auto b = test::AsTensor<float>({200});
+  TF_EXPECT_OK(frame.SetArgs({a, b}));
+
+  // Consumption is disallowed until the caller opts in.
+  EXPECT_FALSE(frame.CanConsumeArg(0));
+  frame.MarkArgsConsumable(true);
+  EXPECT_TRUE(frame.CanConsumeArg(0));
+  EXPECT_FALSE(frame.CanConsumeArg(-1));
+  EXPECT_FALSE(frame.CanConsumeArg(2));
+
+  Tensor v;
+  frame.ConsumeArg(1, &v);
+  test::ExpectTensorEqual<float>(b, v);
+
+  // Arguments that were not consumed remain readable through GetArg.
+  Tensor w;
+  TF_EXPECT_OK(frame.GetArg(0, &w));
+  test::ExpectTensorEqual<float>(a, w);
+}
+
 TEST(Canonicalize, Basic) {
   EXPECT_EQ(Canonicalize("MatMul", Attrs({{"T", DT_FLOAT},
                                           {"transpose_a", false},
@@ -142,6 +142,11 @@ KernelDefBuilder& KernelDefBuilder::Priority(int32 priority) {
   return *this;
 }
 
+KernelDefBuilder& KernelDefBuilder::ProcessShared() {
+  kernel_def_->set_process_shared(true);
+  return *this;
+}
+
 const KernelDef* KernelDefBuilder::Build() {
   KernelDef* r = kernel_def_;
   kernel_def_ = nullptr;
@@ -79,6 +79,11 @@ class KernelDefBuilder {
   // Specify a priority number for this kernel.
   KernelDefBuilder& Priority(int32 priority);
 
+  // Specify that instances of this kernel may be shared across sessions in
+  // the same process. Only opt in stateless kernels whose constructor does
+  // not capture the device or any per-session state.
+  KernelDefBuilder& ProcessShared();
+
   // Returns a pointer to a KernelDef with fields set based on the
   // above calls to this instance.
   // Caller takes ownership of the result.
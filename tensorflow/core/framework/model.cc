@@ -417,6 +417,18 @@ std::shared_ptr<Node> Model::AddNode(Node::Factory factory, const string& name,
   return node;
 }
 
+std::vector<Model::NodeMetrics> Model::CollectMetrics() {
+  std::vector<NodeMetrics> metrics;
+  tf_shared_lock l(mu_);
+  metrics.reserve(lookup_table_.size());
+  for (const auto& pair : lookup_table_) {
+    const std::shared_ptr<Node>& node = pair.second;
+    metrics.push_back({node->name(), node->num_elements(),
+                       node->processing_time(), node->buffered_bytes()});
+  }
+  return metrics;
+}
+
 void Model::AddProcessingTime(const string& name, int64 delta) {
   tf_shared_lock l(mu_);
   auto node = gtl::FindOrNull(lookup_table_, name);
@@ -490,6 +502,42 @@ void Model::Optimize(int64 cpu_budget) {
   }
 }
 
+void Model::OptimizeBuffers(int64 ram_budget) {
+  std::vector<std::shared_ptr<Node>> nodes;
+  {
+    tf_shared_lock l(mu_);
+    for (const auto& pair : lookup_table_) {
+      // Nodes whose buffer autotuners consume `buffer_budget_bytes`.
+      if (pair.second->name() == "Prefetch" ||
+          pair.second->name() == "ParallelMap") {
+        nodes.push_back(pair.second);
+      }
+    }
+  }
+  if (nodes.empty()) {
+    return;
+  }
+  // Weight each buffer by the number of elements it has served; a
+  // buffer that moves more elements benefits more from capacity.
+  double total_weight = 0.0L;
+  std::vector<double> weights(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    weights[i] = static_cast<double>(nodes[i]->num_elements());
+    total_weight += weights[i];
+  }
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    int64 share;
+    if (total_weight > 0) {
+      share = static_cast<int64>(ram_budget * (weights[i] / total_weight));
+    } else {
+      share = ram_budget / static_cast<int64>(nodes.size());
+    }
+    VLOG(2) << "Assigning buffer budget of " << share << " bytes to "
+            << nodes[i]->long_name();
+    nodes[i]->set_buffer_budget_bytes(share);
+  }
+}
+
 void Model::RecordElement(const string& name) {
   tf_shared_lock l(mu_);
   auto node = gtl::FindOrNull(lookup_table_, name);
@@ -150,6 +150,13 @@ class Node {
     return buffered_bytes_;
   }
 
+  // Returns the byte budget assigned to this node's buffer by
+  // `Model::OptimizeBuffers`, or 0 if no budget has been set.
+  int64 buffer_budget_bytes() const LOCKS_EXCLUDED(mu_) {
+    tf_shared_lock l(mu_);
+    return buffer_budget_bytes_;
+  }
+
   // Indicates whether the node has tunable parameters.
   bool has_tunable_parameters() const LOCKS_EXCLUDED(mu_) {
     tf_shared_lock l(mu_);
@@ -227,6 +234,12 @@ class Node {
     autotune_ = autotune;
   }
 
+  // Sets the byte budget for this node's buffer.
+  void set_buffer_budget_bytes(int64 bytes) LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    buffer_budget_bytes_ = bytes;
+  }
+
   // Collects tunable parameters in the subtree rooted in this node.
   void CollectTunableParameters(
       std::map<string, std::shared_ptr<Parameter>>* parameters) const
@@ -377,6 +390,7 @@ class Node {
   // from computation of output time and processing time.
   bool autotune_ GUARDED_BY(mu_) = true;
   int64 buffered_bytes_ GUARDED_BY(mu_) = 0;
+  int64 buffer_budget_bytes_ GUARDED_BY(mu_) = 0;
   int64 processing_time_ GUARDED_BY(mu_) = 0;
   int64 num_elements_ GUARDED_BY(mu_) = 0;
   std::map<std::thread::id, int64> work_start_ GUARDED_BY(mu_);
@@ -438,6 +452,15 @@ class Model {
  public:
   using NodeHook = std::function<void(std::shared_ptr<Node>)>;
 
+  // A point-in-time snapshot of the runtime counters of one node, used for
+  // exporting the model's view of the input pipeline to monitoring.
+  struct NodeMetrics {
+    string name;
+    int64 num_elements;
+    int64 processing_time;
+    int64 buffered_bytes;
+  };
+
   // Creates a new model.
   //
   // The `remove_node_hook` argument can be used to specify functionality that
@@ -457,12 +480,24 @@ class Model {
   std::shared_ptr<Node> AddNode(Node::Factory factory, const string& name,
                                 const string& output_name) LOCKS_EXCLUDED(mu_);
 
+  // Returns a snapshot of the runtime counters of every node in the model.
+  std::vector<NodeMetrics> CollectMetrics() LOCKS_EXCLUDED(mu_);
+
   // Increments the processing time for the given node..
   void AddProcessingTime(const string& name, int64 delta) LOCKS_EXCLUDED(mu_);
 
   // Runs optimization.
   void Optimize(int64 cpu_budget) LOCKS_EXCLUDED(mu_);
 
+  // Distributes `ram_budget` bytes across the buffers of nodes that
+  // maintain internal element buffers (Prefetch, ParallelMap),
+  // proportionally to each node's observed element throughput.  The
+  // per-node shares are published through `Node::buffer_budget_bytes`
+  // and consumed by the buffer autotuners; a node whose share is
+  // smaller than its current buffer shrinks it, so cold buffers yield
+  // memory to hot ones instead of every buffer growing independently.
+  void OptimizeBuffers(int64 ram_budget) LOCKS_EXCLUDED(mu_);
+
   // Records that a node has produced an element.
   void RecordElement(const string& name) LOCKS_EXCLUDED(mu_);
 
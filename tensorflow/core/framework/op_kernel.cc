@@ -38,7 +38,9 @@ limitations under the License.
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/cpu_info.h"
@@ -47,6 +49,7 @@ limitations under the License.
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/platform_strings.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -492,10 +495,52 @@ Status OpKernelContext::forward_input_to_output_with_shape(
   return Status::OK();
 }
 
+namespace {
+
+// Counts buffer-forwarding attempts per op type, split by outcome: "hit"
+// when the input buffer was reused for the output, "miss" otherwise.
+auto* op_forwarding_counter = monitoring::Counter<2>::New(
+    "/tensorflow/core/op_forwarding",
+    "The number of input-buffer forwarding attempts made by op kernels, "
+    "per op type and outcome.",
+    "op", "outcome");
+
+// Collection is opt-in via TF_OP_FORWARDING_STATS because the counter
+// cell lookup adds a small cost to every forwarding attempt.
+bool OpForwardingStatsEnabled() {
+  static const bool enabled = [] {
+    bool value = false;
+    Status s = ReadBoolFromEnvVar("TF_OP_FORWARDING_STATS", false, &value);
+    if (!s.ok()) {
+      LOG(WARNING) << "Could not parse TF_OP_FORWARDING_STATS: " << s;
+    }
+    return value;
+  }();
+  return enabled;
+}
+
+}  // namespace
+
 std::unique_ptr<Tensor> OpKernelContext::forward_input(
     int input_index, int output_index, DataType output_dtype,
     const TensorShape& output_shape, MemoryType output_memory_type,
     const AllocatorAttributes& output_attr) {
+  std::unique_ptr<Tensor> forwarded =
+      forward_input_impl(input_index, output_index, output_dtype, output_shape,
+                         output_memory_type, output_attr);
+  if (OpForwardingStatsEnabled()) {
+    op_forwarding_counter
+        ->GetCell(params_->op_kernel->type_string(),
+                  forwarded != nullptr ? "hit" : "miss")
+        ->IncrementBy(1);
+  }
+  return forwarded;
+}
+
+std::unique_ptr<Tensor> OpKernelContext::forward_input_impl(
+    int input_index, int output_index, DataType output_dtype,
+    const TensorShape& output_shape, MemoryType output_memory_type,
+    const AllocatorAttributes& output_attr) {
   DCHECK_GE(input_index, 0);
   DCHECK_LT(input_index, num_inputs());
   const TensorValue& input = (*params_->inputs)[input_index];
@@ -701,7 +746,13 @@ Status OpKernelContext::allocate_output(StringPiece name,
 Status OpKernelContext::allocate_tensor(
     DataType type, const TensorShape& shape, Tensor* out_tensor,
     AllocatorAttributes attr, const AllocationAttributes& allocation_attr) {
-  Allocator* a = get_allocator(attr);
+  return allocate_tensor(get_allocator(attr), type, shape, out_tensor,
+                         allocation_attr);
+}
+
+Status OpKernelContext::allocate_tensor(
+    Allocator* a, DataType type, const TensorShape& shape, Tensor* out_tensor,
+    const AllocationAttributes& allocation_attr) {
   Tensor new_tensor(a, type, shape,
                     AllocationAttributes(allocation_attr.no_retry_on_failure,
                                          /* allocation_will_be_logged= */ true,
@@ -743,10 +794,14 @@ Status OpKernelContext::allocate_temp(
     DataType type, const TensorShape& shape, Tensor* out_temp,
     AllocatorAttributes allocator_attr,
     const AllocationAttributes& allocation_attr) {
-  Status s =
-      allocate_tensor(type, shape, out_temp, allocator_attr, allocation_attr);
+  // Temps may be served from a per-step arena when the executor provides
+  // one; scoped allocations keep their dedicated allocator.
+  Allocator* a = params_->step_arena_allocator != nullptr &&
+                         allocator_attr.scope_id == 0
+                     ? params_->step_arena_allocator
+                     : get_allocator(allocator_attr);
+  Status s = allocate_tensor(a, type, shape, out_temp, allocation_attr);
   if (track_allocations() && s.ok() && out_temp->TotalBytes() > 0) {
-    Allocator* a = get_allocator(allocator_attr);
     if (a->TracksAllocationSizes()) {
       int64 alloc_size = a->AllocatedSize(out_temp->tensor_data().data());
       record_temp_memory_allocation(alloc_size, *out_temp);
@@ -982,12 +1037,14 @@ struct KernelRegistration {
   std::unique_ptr<kernel_factory::OpKernelFactory> factory;
 };
 
-// This maps from 'op_type' + DeviceType to the set of KernelDefs and
-// factory functions for instantiating the OpKernel that matches the
-// KernelDef.
+// This maps from a hash of 'op_type' + DeviceType + label to the set of
+// KernelDefs and factory functions for instantiating the OpKernel that
+// matches the KernelDef. Keying by hash lets lookups avoid materializing a
+// key string per call; candidates under one hash are verified against the
+// actual op/device/label fields before use.
 struct KernelRegistry {
   mutex mu;
-  std::unordered_multimap<string, KernelRegistration> registry GUARDED_BY(mu);
+  std::unordered_multimap<uint64, KernelRegistration> registry GUARDED_BY(mu);
 };
 
 #if defined(_WIN32)
@@ -1008,7 +1065,18 @@ static Status IsProbablySafeToLoad(const string& path) {
   using port::CPUFeature;
   static const auto* feature_map =
       new std::map<string, std::pair<CPUFeature, string>>{
+          {"__AVX__=1", FEATURE(CPUFeature::AVX)},
+          {"__AVX2__=1", FEATURE(CPUFeature::AVX2)},
+          {"__FMA__=1", FEATURE(CPUFeature::FMA)},
+          {"__AVX512F__=1", FEATURE(CPUFeature::AVX512F)},
+          {"__AVX512CD__=1", FEATURE(CPUFeature::AVX512CD)},
+          {"__AVX512ER__=1", FEATURE(CPUFeature::AVX512ER)},
+          {"__AVX512PF__=1", FEATURE(CPUFeature::AVX512PF)},
           {"__AVX512VL__=1", FEATURE(CPUFeature::AVX512VL)},
+          {"__AVX512BW__=1", FEATURE(CPUFeature::AVX512BW)},
+          {"__AVX512DQ__=1", FEATURE(CPUFeature::AVX512DQ)},
+          {"__AVX512VBMI__=1", FEATURE(CPUFeature::AVX512VBMI)},
+          {"__AVX512IFMA__=1", FEATURE(CPUFeature::AVX512IFMA)},
       };
 
   std::vector<std::string> platform_strings;
@@ -1036,6 +1104,24 @@ static Status IsProbablySafeToLoad(const string& path) {
   return Status::OK();
 }
 
+// Returns the vector-ISA specialization level encoded in a kernel library
+// file name, and strips that token into *stem so that variants of the same
+// library (e.g. libtfkernel_all_kernels.so next to
+// libtfkernel_all_kernels_avx2.so) can be grouped together.
+static int KernelLibraryISALevel(const string& file, string* stem) {
+  static const std::pair<const char*, int> kISASuffixes[] = {
+      {"_avx512", 3}, {"_avx2", 2}, {"_avx", 1}};
+  for (const auto& suffix : kISASuffixes) {
+    if (str_util::StrContains(file, suffix.first)) {
+      *stem = str_util::StringReplace(file, suffix.first, "",
+                                      /*replace_all=*/false);
+      return suffix.second;
+    }
+  }
+  *stem = file;
+  return 0;
+}
+
 void LoadDynamicKernelsInternal() {
   Env* env = Env::Default();
 
@@ -1050,6 +1136,12 @@ void LoadDynamicKernelsInternal() {
   Status s_kernel_dir = env->GetChildren(bazel_kernel_dir, &files);
   if (s_kernel_dir.ok()) {
     string dll_spec = io::JoinPath(bazel_kernel_dir, kKernelLibPattern);
+    // A kernel library may ship in several builds specialized for different
+    // vector ISAs (for example an AVX2 and an AVX-512 build next to the
+    // baseline). Loading more than one would register every kernel twice, so
+    // group the candidates by stem and load only the most specialized variant
+    // this host passes the safety check for.
+    std::map<string, std::pair<int, string>> best_variant;
     for (const auto& file : files) {
       string fullpath = io::JoinPath(bazel_kernel_dir, file);
       if (env->MatchPath(fullpath, dll_spec)) {
@@ -1060,15 +1152,24 @@ void LoadDynamicKernelsInternal() {
                        << s.error_message();
         }
         if (s.ok() || override_abi_check) {
-          // TODO(gunan): Store the handles to the opened files.
-          void* unused_filehandle;
-          TF_CHECK_OK(env->LoadLibrary(fullpath.c_str(), &unused_filehandle));
+          string stem;
+          const int isa_level = KernelLibraryISALevel(file, &stem);
+          auto& best = best_variant[stem];
+          if (best.second.empty() || isa_level > best.first) {
+            best = {isa_level, fullpath};
+          }
         } else {
           LOG(WARNING) << "Not loading plugin library " << fullpath << ": "
                        << s.error_message();
         }
       }
     }
+    for (const auto& entry : best_variant) {
+      // TODO(gunan): Store the handles to the opened files.
+      void* unused_filehandle;
+      TF_CHECK_OK(
+          env->LoadLibrary(entry.second.second.c_str(), &unused_filehandle));
+    }
   }
 }
 
@@ -1092,10 +1193,13 @@ static KernelRegistry* GlobalKernelRegistryTyped() {
   return reinterpret_cast<KernelRegistry*>(GlobalKernelRegistry());
 }
 
-static string Key(StringPiece op_type, const DeviceType& device_type,
+static uint64 Key(StringPiece op_type, const DeviceType& device_type,
                   StringPiece label) {
-  return strings::StrCat(op_type, ":", DeviceTypeString(device_type), ":",
-                         label);
+  const string& device = device_type.type_string();
+  return Hash64Combine(
+      Hash64Combine(Hash64(op_type.data(), op_type.size()),
+                    Hash64(device.data(), device.size())),
+      Hash64(label.data(), label.size()));
 }
 
 namespace kernel_factory {
@@ -1105,7 +1209,7 @@ void OpKernelRegistrar::InitInternal(const KernelDef* kernel_def,
                                      std::unique_ptr<OpKernelFactory> factory) {
   // See comments in register_kernel::Name in header for info on _no_register.
   if (kernel_def->op() != "_no_register") {
-    const string key =
+    const uint64 key =
         Key(kernel_def->op(), DeviceType(kernel_def->device_type()),
             kernel_def->label());
 
@@ -1149,11 +1253,18 @@ Status FindKernelRegistration(
   // Label defaults to empty if not found in NodeDef.
   const string& label = GetNodeAttrString(node_attrs, kKernelAttr);
 
-  const string key = Key(node_op, device_type, label);
+  const uint64 key = Key(node_op, device_type, label);
   auto typed_registry = GlobalKernelRegistryTyped();
   tf_shared_lock lock(typed_registry->mu);
   auto regs = typed_registry->registry.equal_range(key);
   for (auto iter = regs.first; iter != regs.second; ++iter) {
+    // The registry is keyed by hash; skip candidates whose actual key
+    // fields differ (a hash collision between distinct keys).
+    if (iter->second.def.op() != node_op ||
+        iter->second.def.device_type() != device_type.type_string() ||
+        iter->second.def.label() != label) {
+      continue;
+    }
     // If there is a kernel registered for the op and device_type,
     // check that the attrs match.
     bool match;
@@ -646,6 +646,12 @@ class OpKernelContext {
     // stored in this container..
     ScopedStepContainer* step_container = nullptr;
 
+    // If non-null, allocate_temp() serves allocations from this allocator
+    // instead of the device allocator.  Set by executors that enable
+    // per-step arena allocation; the allocator defers reclamation until the
+    // end of the step, so temps must be safe to retain that long.
+    Allocator* step_arena_allocator = nullptr;
+
     // Mechanism used by this op kernel invocation to communicate with
     // computations running on other devices.
     Rendezvous* rendezvous = nullptr;
@@ -1257,6 +1263,13 @@ class OpKernelContext {
   Allocator* get_allocator(AllocatorAttributes attr);
   bool record_memory_consumption_ = false;
 
+  // Implements forward_input(); the public wrapper additionally records
+  // per-op hit/miss statistics when enabled.
+  std::unique_ptr<Tensor> forward_input_impl(
+      int input_index, int output_index, DataType output_dtype,
+      const TensorShape& output_shape, MemoryType output_memory_type,
+      const AllocatorAttributes& output_attr);
+
   // Internal method to add a tensor's buffer to the list of buffers
   // referenced during the execution of the Op, so that GPUs may
   // accurately track the memory that may not be reused until the Op
@@ -1276,6 +1289,11 @@ class OpKernelContext {
                          Tensor* out_tensor, AllocatorAttributes allocator_attr,
                          const AllocationAttributes& allocation_attr);
 
+  // As above, but with the allocator already resolved by the caller.
+  Status allocate_tensor(Allocator* a, DataType type, const TensorShape& shape,
+                         Tensor* out_tensor,
+                         const AllocationAttributes& allocation_attr);
+
   // This is called by PersistentTensor::AccessTensor whenever the
   // wrapped tensor is retrieved, to ensure the runtime knows that the
   // Tensor is being accessed within an Op. This is necessary for
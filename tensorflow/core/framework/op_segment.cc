@@ -16,9 +16,11 @@ limitations under the License.
 #include "tensorflow/core/framework/op_segment.h"
 
 #include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
@@ -108,4 +110,70 @@ bool OpSegment::ShouldOwnKernel(FunctionLibraryRuntime* lib,
          node_op != "PartitionedCall" && node_op != "StatefulPartitionedCall";
 }
 
+SharedKernelRegistry* SharedKernelRegistry::Global() {
+  static SharedKernelRegistry* global = new SharedKernelRegistry;
+  return global;
+}
+
+Status SharedKernelRegistry::FindOrCreate(const string& key, OpKernel** kernel,
+                                          CreateKernelFn create_fn) {
+  {
+    mutex_lock l(mu_);
+    auto iter = entries_.find(key);
+    if (iter != entries_.end()) {
+      ++iter->second.refs;
+      *kernel = iter->second.kernel;
+      return Status::OK();
+    }
+  }
+  Status s = create_fn(kernel);
+  if (!s.ok()) {
+    LOG(ERROR) << "Create kernel failed: " << s;
+    return s;
+  }
+  OpKernel* to_delete = nullptr;
+  {
+    mutex_lock l(mu_);
+    Entry* entry = &entries_[key];
+    if (entry->kernel == nullptr) {
+      entry->kernel = *kernel;  // Inserts 'kernel' in the map.
+      keys_[*kernel] = key;
+    } else {
+      // Another thread created the kernel concurrently; use theirs.
+      to_delete = *kernel;
+      *kernel = entry->kernel;
+    }
+    ++entry->refs;
+  }
+  delete to_delete;
+  return Status::OK();
+}
+
+bool SharedKernelRegistry::Release(OpKernel* kernel) {
+  OpKernel* to_delete = nullptr;
+  {
+    mutex_lock l(mu_);
+    auto kiter = keys_.find(kernel);
+    if (kiter == keys_.end()) {
+      return false;
+    }
+    auto eiter = entries_.find(kiter->second);
+    DCHECK(eiter != entries_.end());
+    if (--eiter->second.refs == 0) {
+      to_delete = eiter->second.kernel;
+      entries_.erase(eiter);
+      keys_.erase(kiter);
+    }
+  }
+  delete to_delete;
+  return true;
+}
+
+string SharedKernelRegistry::KernelKey(const NodeDef& ndef,
+                                       const string& device_name) {
+  // SummarizeNodeDef emits attrs in sorted order, so nodes with identical
+  // definitions produce the same key regardless of attr insertion order.
+  return strings::StrCat(device_name, "##", SummarizeNodeDef(ndef));
+}
+
 }  // end namespace tensorflow
@@ -83,6 +83,56 @@ class OpSegment {
   TF_DISALLOW_COPY_AND_ASSIGN(OpSegment);
 };
 
+// A process-wide registry of OpKernels shared across sessions.
+//
+// Kernels whose KernelDef sets process_shared may be cached here keyed by
+// (device, node fingerprint), so that many sessions running the same model
+// instantiate each such kernel once instead of once per session. Entries
+// are reference-counted: each FindOrCreate() adds a reference and each
+// Release() drops one; the kernel is deleted when the last reference goes
+// away.
+class SharedKernelRegistry {
+ public:
+  // Returns the process-wide registry.
+  static SharedKernelRegistry* Global();
+
+  // If a kernel for "key" is cached, returns it in "*kernel" and adds a
+  // reference. Otherwise, creates the kernel by calling create_fn(),
+  // caches it with one reference, and returns it in "*kernel". If
+  // create_fn() fails, returns the error.
+  //
+  // The registry keeps ownership of "*kernel"; callers must pass it to
+  // Release() instead of deleting it.
+  typedef std::function<Status(OpKernel**)> CreateKernelFn;
+  Status FindOrCreate(const string& key, OpKernel** kernel,
+                      CreateKernelFn create_fn);
+
+  // Drops a reference on "kernel", deleting it if this was the last one.
+  // Returns false if "kernel" is not owned by the registry, in which case
+  // the caller retains ownership.
+  bool Release(OpKernel* kernel);
+
+  // Returns the cache key for instantiating "ndef" on the device named
+  // "device_name". Nodes with identical definitions produce the same key.
+  static string KernelKey(const NodeDef& ndef, const string& device_name);
+
+ private:
+  SharedKernelRegistry() {}
+
+  struct Entry {
+    OpKernel* kernel = nullptr;
+    int refs = 0;
+  };
+
+  mutable mutex mu_;
+  // cache key -> entry.
+  std::unordered_map<string, Entry> entries_ GUARDED_BY(mu_);
+  // kernel -> cache key, for Release().
+  std::unordered_map<const OpKernel*, string> keys_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SharedKernelRegistry);
+};
+
 }  // end namespace tensorflow
 
 #endif  // TENSORFLOW_FRAMEWORK_OP_SEGMENT_H_
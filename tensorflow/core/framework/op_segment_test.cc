@@ -156,4 +156,42 @@ TEST_F(OpSegmentTest, AddRemoveHolds) {
   opseg.RemoveHold("foo");
 }
 
+TEST_F(OpSegmentTest, SharedKernelRegistry) {
+  SharedKernelRegistry* registry = SharedKernelRegistry::Global();
+  const string key0 =
+      SharedKernelRegistry::KernelKey(float_nodedefs_[0], "cpu:0");
+  const string key1 =
+      SharedKernelRegistry::KernelKey(float_nodedefs_[1], "cpu:0");
+  EXPECT_NE(key0, key1);
+
+  OpKernel* op0;
+  TF_EXPECT_OK(registry->FindOrCreate(key0, &op0, GetFn(&float_nodedefs_[0])));
+  ValidateOpAndTypes(op0, float_nodedefs_[0], DT_FLOAT);
+
+  // A second lookup of the same key returns the same instance without
+  // invoking the create function.
+  auto reterr = [](OpKernel** kernel) {
+    return errors::Internal("Should not be called");
+  };
+  OpKernel* op0_again;
+  TF_EXPECT_OK(registry->FindOrCreate(key0, &op0_again, reterr));
+  EXPECT_EQ(op0, op0_again);
+
+  // A different key gets its own instance.
+  OpKernel* op1;
+  TF_EXPECT_OK(registry->FindOrCreate(key1, &op1, GetFn(&float_nodedefs_[1])));
+  EXPECT_NE(op0, op1);
+
+  // op0 holds two references; op1 holds one.
+  EXPECT_TRUE(registry->Release(op0));
+  EXPECT_TRUE(registry->Release(op0));
+  EXPECT_TRUE(registry->Release(op1));
+
+  // A kernel the registry never owned is the caller's to delete.
+  OpKernel* unshared;
+  TF_EXPECT_OK(GetFn(&float_nodedefs_[0])(&unshared));
+  EXPECT_FALSE(registry->Release(unshared));
+  delete unshared;
+}
+
 }  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/rendezvous.h"
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <utility>
@@ -48,6 +49,23 @@ Rendezvous::ParsedKey& Rendezvous::ParsedKey::operator=(const ParsedKey& b) {
   return *this;
 }
 
+void Rendezvous::ParsedKey::SetFrameAndIter(const FrameAndIter& frame_iter) {
+  const size_t prefix_size = buf_.rfind(';');
+  DCHECK_NE(prefix_size, string::npos);
+  // The device and edge pieces all precede the final ';', but appending the
+  // new suffix may reallocate the buffer, so save their offsets and re-point
+  // them below.
+  const char* base = buf_.data();
+  const size_t src_offset = src_device.data() - base;
+  const size_t dst_offset = dst_device.data() - base;
+  const size_t edge_offset = edge_name.data() - base;
+  buf_.resize(prefix_size + 1);
+  strings::StrAppend(&buf_, frame_iter.frame_id, ":", frame_iter.iter_id);
+  src_device = StringPiece(buf_.data() + src_offset, src_device.size());
+  dst_device = StringPiece(buf_.data() + dst_offset, dst_device.size());
+  edge_name = StringPiece(buf_.data() + edge_offset, edge_name.size());
+}
+
 /*  static */
 string Rendezvous::CreateKey(const string& src_device, uint64 src_incarnation,
                              const string& dst_device, const string& name,
@@ -155,15 +173,14 @@ class LocalRendezvousImpl : public Rendezvous {
     uint64 key_hash = KeyHash(key.FullKey());
     VLOG(2) << "Send " << this << " " << key_hash << " " << key.FullKey();
 
-    mu_.lock();
-    if (!status_.ok()) {
-      // Rendezvous has been aborted.
-      Status s = status_;
-      mu_.unlock();
-      return s;
+    Shard* shard = &shards_[key_hash % kNumShards];
+    shard->mu.lock();
+    if (aborted_.load(std::memory_order_acquire)) {
+      shard->mu.unlock();
+      return StatusAfterAbort();
     }
 
-    ItemQueue* queue = &table_[key_hash];
+    ItemQueue* queue = &shard->table[key_hash];
     if (queue->empty() || queue->front()->IsSendValue()) {
       // There is no waiter for this message. Append the message
       // into the queue. The waiter will pick it up when arrives.
@@ -176,20 +193,19 @@ class LocalRendezvousImpl : public Rendezvous {
         item->send_args.device_context->Ref();
       }
       queue->push_back(item);
-      mu_.unlock();
+      shard->mu.unlock();
       return Status::OK();
     }
 
     // There is an earliest waiter to consume this message.
     Item* item = queue->front();
 
-    // Delete the queue when the last element has been consumed.
-    if (queue->size() == 1) {
-      table_.erase(key_hash);
-    } else {
-      queue->pop_front();
-    }
-    mu_.unlock();
+    // The emptied queue entry stays in the table; erasing it here would
+    // pay rehash costs on the hot path for nothing, since most keys see
+    // exactly one send/recv pair per rendezvous and the table dies with
+    // the step.
+    queue->pop_front();
+    shard->mu.unlock();
 
     // Notify the waiter by invoking its done closure, outside the
     // lock.
@@ -204,16 +220,15 @@ class LocalRendezvousImpl : public Rendezvous {
     uint64 key_hash = KeyHash(key.FullKey());
     VLOG(2) << "Recv " << this << " " << key_hash << " " << key.FullKey();
 
-    mu_.lock();
-    if (!status_.ok()) {
-      // Rendezvous has been aborted.
-      Status s = status_;
-      mu_.unlock();
-      done(s, Args(), recv_args, Tensor(), false);
+    Shard* shard = &shards_[key_hash % kNumShards];
+    shard->mu.lock();
+    if (aborted_.load(std::memory_order_acquire)) {
+      shard->mu.unlock();
+      done(StatusAfterAbort(), Args(), recv_args, Tensor(), false);
       return;
     }
 
-    ItemQueue* queue = &table_[key_hash];
+    ItemQueue* queue = &shard->table[key_hash];
     if (queue->empty() || !queue->front()->IsSendValue()) {
       // There is no message to pick up.
       // Only recv-related fields need to be filled.
@@ -224,7 +239,7 @@ class LocalRendezvousImpl : public Rendezvous {
         item->recv_args.device_context->Ref();
       }
       queue->push_back(item);
-      mu_.unlock();
+      shard->mu.unlock();
       return;
     }
 
@@ -232,13 +247,10 @@ class LocalRendezvousImpl : public Rendezvous {
     // this key.  Consumes the message and invokes the done closure.
     Item* item = queue->front();
 
-    // Delete the queue when the last element has been consumed.
-    if (queue->size() == 1) {
-      table_.erase(key_hash);
-    } else {
-      queue->pop_front();
-    }
-    mu_.unlock();
+    // As in Send, the emptied queue entry is left for the table to clean
+    // up wholesale.
+    queue->pop_front();
+    shard->mu.unlock();
 
     // Invokes the done() by invoking its done closure, outside scope
     // of the table lock.
@@ -249,18 +261,27 @@ class LocalRendezvousImpl : public Rendezvous {
 
   void StartAbort(const Status& status) override {
     CHECK(!status.ok());
-    Table table;
     {
-      mutex_lock l(mu_);
+      mutex_lock l(status_mu_);
       status_.Update(status);
-      table_.swap(table);
     }
-    for (auto& p : table) {
-      for (Item* item : p.second) {
-        if (!item->IsSendValue()) {
-          item->waiter(status, Args(), Args(), Tensor(), false);
+    // Publish the abort before sweeping: a Send/Recv that races past the
+    // flag must have entered its shard's critical section before the sweep
+    // below, so the sweep will find whatever it enqueued.
+    aborted_.store(true, std::memory_order_release);
+    for (Shard& shard : shards_) {
+      Table table;
+      {
+        mutex_lock l(shard.mu);
+        shard.table.swap(table);
+      }
+      for (auto& p : table) {
+        for (Item* item : p.second) {
+          if (!item->IsSendValue()) {
+            item->waiter(status, Args(), Args(), Tensor(), false);
+          }
+          delete item;
         }
-        delete item;
       }
     }
   }
@@ -302,13 +323,38 @@ class LocalRendezvousImpl : public Rendezvous {
   typedef std::deque<Item*> ItemQueue;
   typedef gtl::FlatMap<uint64, ItemQueue> Table;
 
-  // TODO(zhifengc): shard table_.
-  mutex mu_;
-  Table table_ GUARDED_BY(mu_);
-  Status status_ GUARDED_BY(mu_);
+  // The matching table is sharded by key hash so that concurrent sends
+  // and recvs for distinct keys mostly take distinct locks.  With
+  // thousands of concurrent recvs per step, a single table mutex is a
+  // measurable fraction of recv latency.
+  static const int kNumShards = 16;
+  struct Shard {
+    mutex mu;
+    Table table GUARDED_BY(mu);
+  };
+  Shard shards_[kNumShards];
+
+  // Set before the shards are swept by StartAbort, and checked by
+  // Send/RecvAsync inside the shard critical section, so no item can be
+  // enqueued after its shard has been swept.
+  std::atomic<bool> aborted_{false};
+  mutex status_mu_;
+  Status status_ GUARDED_BY(status_mu_);
+
+  Status StatusAfterAbort() {
+    mutex_lock l(status_mu_);
+    return status_;
+  }
 
   ~LocalRendezvousImpl() override {
-    if (!table_.empty()) {
+    bool has_entries = false;
+    for (Shard& shard : shards_) {
+      if (!shard.table.empty()) {
+        has_entries = true;
+        break;
+      }
+    }
+    if (has_entries) {
       StartAbort(errors::Cancelled("LocalRendezvousImpl deleted"));
     }
   }
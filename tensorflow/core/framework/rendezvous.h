@@ -73,6 +73,13 @@ class Rendezvous : public core::RefCounted {
     ParsedKey& operator=(const ParsedKey& b);
     StringPiece FullKey() const { return buf_; }
 
+    // Overwrites the trailing "frame_id:iter_id" component of this key
+    // with "frame_iter", leaving all other components (including the
+    // parsed device fields) unchanged. Much cheaper than building and
+    // re-parsing a new key string per loop iteration.
+    // REQUIRES: this key was filled in by a successful ParseKey() call.
+    void SetFrameAndIter(const FrameAndIter& frame_iter);
+
    private:
     friend class Rendezvous;
     friend class SendOp;
@@ -63,6 +63,31 @@ TEST(RendezvousTest, Key) {
       Rendezvous::ParseKey(strings::StrCat(key, ";", key), &parsed).ok());
 }
 
+TEST(RendezvousTest, SetFrameAndIter) {
+  const string key = Rendezvous::CreateKey(
+      "/job:mnist/replica:1/task:2/CPU:0", 7890,
+      "/job:mnist/replica:1/task:2/device:GPU:0", "var0", FrameAndIter(0, 0));
+  Rendezvous::ParsedKey parsed;
+  TF_EXPECT_OK(Rendezvous::ParseKey(key, &parsed));
+
+  parsed.SetFrameAndIter(FrameAndIter(2, 37));
+  const string expected = Rendezvous::CreateKey(
+      "/job:mnist/replica:1/task:2/CPU:0", 7890,
+      "/job:mnist/replica:1/task:2/device:GPU:0", "var0", FrameAndIter(2, 37));
+  EXPECT_EQ(parsed.FullKey(), expected);
+  EXPECT_EQ(parsed.src_device, "/job:mnist/replica:1/task:2/CPU:0");
+  EXPECT_EQ(parsed.src_incarnation, 7890);
+  EXPECT_EQ(parsed.dst_device, "/job:mnist/replica:1/task:2/device:GPU:0");
+  EXPECT_EQ(parsed.edge_name, "var0");
+
+  // The rewritten key parses back to the same components.
+  Rendezvous::ParsedKey reparsed;
+  TF_EXPECT_OK(Rendezvous::ParseKey(parsed.FullKey(), &reparsed));
+  EXPECT_EQ(reparsed.src_device, parsed.src_device);
+  EXPECT_EQ(reparsed.dst_device, parsed.dst_device);
+  EXPECT_EQ(reparsed.edge_name, parsed.edge_name);
+}
+
 class LocalRendezvousTest : public ::testing::Test {
  public:
   LocalRendezvousTest() : threads_(Env::Default(), "test", 16) {
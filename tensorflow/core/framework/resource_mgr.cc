@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 
 #include <atomic>
+#include <memory>
 
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
@@ -80,6 +81,7 @@ Status ValidateDevice(OpKernelContext* ctx, const ResourceHandle& p) {
 
 Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
                                         const string& type_name) {
+  mutex_lock l(debug_mu_);
   auto iter = debug_type_names_.emplace(hash_code, type_name);
   if (iter.first->second != type_name) {
     return errors::AlreadyExists("Duplicate hash code found for type ",
@@ -89,6 +91,7 @@ Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
 }
 
 const char* ResourceMgr::DebugTypeName(uint64 hash_code) const {
+  mutex_lock l(debug_mu_);
   auto type_name_iter = debug_type_names_.find(hash_code);
   if (type_name_iter == debug_type_names_.end()) {
     return "<unknown>";
@@ -104,14 +107,47 @@ ResourceMgr::ResourceMgr(const string& default_container)
 
 ResourceMgr::~ResourceMgr() { Clear(); }
 
+ResourceMgr::Snapshot::~Snapshot() {
+  for (const auto& p : containers) {
+    for (const auto& q : p.second) {
+      q.second->Unref();
+    }
+  }
+}
+
+void ResourceMgr::PublishSnapshot(Shard* shard) {
+  auto snapshot = std::make_shared<Snapshot>();
+  for (const auto& p : shard->containers) {
+    Container& copy = snapshot->containers[p.first];
+    copy = *p.second;
+    for (const auto& q : copy) {
+      q.second->Ref();
+    }
+  }
+  std::atomic_store(&shard->snapshot,
+                    std::shared_ptr<const Snapshot>(std::move(snapshot)));
+}
+
+bool ResourceMgr::ContainerExists(const string& container) const {
+  for (const Shard& s : shards_) {
+    std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&s.snapshot);
+    if (snapshot != nullptr &&
+        snapshot->containers.find(container) != snapshot->containers.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ResourceMgr::GetContainerResources(
     const string& container, std::vector<ResourceEntry>* resources) const {
   resources->clear();
-  mutex_lock l(mu_);
-  Container* b = gtl::FindPtrOrNull(containers_, container);
-  if (b != nullptr) {
-    resources->reserve(b->size());
-    for (auto& key_resource : *b) {
+  for (const Shard& s : shards_) {
+    std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&s.snapshot);
+    if (snapshot == nullptr) continue;
+    auto citer = snapshot->containers.find(container);
+    if (citer == snapshot->containers.end()) continue;
+    for (const auto& key_resource : citer->second) {
       ResourceBase* resource = key_resource.second;
       resource->Ref();
       resources->emplace_back(key_resource.first.second, resource);
@@ -120,18 +156,30 @@ void ResourceMgr::GetContainerResources(
 }
 
 void ResourceMgr::Clear() {
-  mutex_lock l(mu_);
-  for (const auto& p : containers_) {
-    for (const auto& q : *p.second) {
-      q.second->Unref();
+  for (Shard& s : shards_) {
+    std::unordered_map<string, Container*> containers;
+    {
+      mutex_lock l(s.mu);
+      containers.swap(s.containers);
+      PublishSnapshot(&s);
+    }
+    for (const auto& p : containers) {
+      for (const auto& q : *p.second) {
+        q.second->Unref();
+      }
+      delete p.second;
     }
-    delete p.second;
   }
-  containers_.clear();
 }
 
 string ResourceMgr::DebugString() const {
-  mutex_lock l(mu_);
+  // Hold on to the snapshots so the referenced strings stay alive while
+  // the report is built.
+  std::vector<std::shared_ptr<const Snapshot>> snapshots;
+  for (const Shard& s : shards_) {
+    std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&s.snapshot);
+    if (snapshot != nullptr) snapshots.push_back(std::move(snapshot));
+  }
   struct Line {
     const string* container;
     const string type;
@@ -139,15 +187,17 @@ string ResourceMgr::DebugString() const {
     const string detail;
   };
   std::vector<Line> lines;
-  for (const auto& p : containers_) {
-    const string& container = p.first;
-    for (const auto& q : *p.second) {
-      const Key& key = q.first;
-      const char* type = DebugTypeName(key.first);
-      const string& resource = key.second;
-      Line l{&container, port::Demangle(type), &resource,
-             q.second->DebugString()};
-      lines.push_back(l);
+  for (const auto& snapshot : snapshots) {
+    for (const auto& p : snapshot->containers) {
+      const string& container = p.first;
+      for (const auto& q : p.second) {
+        const Key& key = q.first;
+        const char* type = DebugTypeName(key.first);
+        const string& resource = key.second;
+        Line l{&container, port::Demangle(type), &resource,
+               q.second->DebugString()};
+        lines.push_back(l);
+      }
     }
   }
   std::vector<string> text;
@@ -163,11 +213,20 @@ string ResourceMgr::DebugString() const {
 
 Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
                              const string& name, ResourceBase* resource) {
-  Container** b = &containers_[container];
+  Shard& s = shard(name);
+  mutex_lock l(s.mu);
+  return DoCreateLocked(&s, container, type, name, resource);
+}
+
+Status ResourceMgr::DoCreateLocked(Shard* shard, const string& container,
+                                   TypeIndex type, const string& name,
+                                   ResourceBase* resource) {
+  Container** b = &shard->containers[container];
   if (*b == nullptr) {
     *b = new Container;
   }
   if ((*b)->insert({{type.hash_code(), name}, resource}).second) {
+    PublishSnapshot(shard);
     TF_RETURN_IF_ERROR(InsertDebugTypeName(type.hash_code(), type.name()));
     return Status::OK();
   }
@@ -179,18 +238,51 @@ Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
 Status ResourceMgr::DoLookup(const string& container, TypeIndex type,
                              const string& name,
                              ResourceBase** resource) const {
-  const Container* b = gtl::FindPtrOrNull(containers_, container);
-  if (b == nullptr) {
-    return errors::NotFound("Container ", container,
-                            " does not exist. (Could not find resource: ",
-                            container, "/", name, ")");
+  std::shared_ptr<const Snapshot> snapshot =
+      std::atomic_load(&shard(name).snapshot);
+  if (snapshot != nullptr) {
+    auto citer = snapshot->containers.find(container);
+    if (citer != snapshot->containers.end()) {
+      auto riter = citer->second.find({type.hash_code(), name});
+      if (riter != citer->second.end()) {
+        *resource = riter->second;
+        (*resource)->Ref();
+        return Status::OK();
+      }
+      return errors::NotFound("Resource ", container, "/", name, "/",
+                              type.name(), " does not exist.");
+    }
   }
-  auto r = gtl::FindPtrOrNull(*b, {type.hash_code(), name});
-  if (r == nullptr) {
+  // The container has no resources in this shard; whether it exists in
+  // another one decides which error to report.
+  if (ContainerExists(container)) {
     return errors::NotFound("Resource ", container, "/", name, "/", type.name(),
                             " does not exist.");
   }
-  *resource = const_cast<ResourceBase*>(r);
+  return errors::NotFound("Container ", container,
+                          " does not exist. (Could not find resource: ",
+                          container, "/", name, ")");
+}
+
+Status ResourceMgr::DoLookupOrCreate(
+    const string& container, TypeIndex type, const string& name,
+    ResourceBase** resource, std::function<Status(ResourceBase**)> creator) {
+  Shard& s = shard(name);
+  mutex_lock l(s.mu);
+  Container* b = gtl::FindPtrOrNull(s.containers, container);
+  if (b != nullptr) {
+    ResourceBase* found = gtl::FindPtrOrNull(*b, {type.hash_code(), name});
+    if (found != nullptr) {
+      found->Ref();
+      *resource = found;
+      return Status::OK();
+    }
+  }
+  TF_RETURN_IF_ERROR(creator(resource));
+  Status st = DoCreateLocked(&s, container, type, name, *resource);
+  if (!st.ok()) {
+    return errors::Internal("LookupOrCreate failed unexpectedly");
+  }
   (*resource)->Ref();
   return Status::OK();
 }
@@ -200,20 +292,25 @@ Status ResourceMgr::DoDelete(const string& container, uint64 type_hash_code,
                              const string& type_name) {
   ResourceBase* base = nullptr;
   {
-    mutex_lock l(mu_);
-    Container* b = gtl::FindPtrOrNull(containers_, container);
-    if (b == nullptr) {
-      return errors::NotFound("Container ", container, " does not exist.");
+    Shard& s = shard(resource_name);
+    mutex_lock l(s.mu);
+    Container* b = gtl::FindPtrOrNull(s.containers, container);
+    if (b != nullptr) {
+      auto iter = b->find({type_hash_code, resource_name});
+      if (iter != b->end()) {
+        base = iter->second;
+        b->erase(iter);
+        PublishSnapshot(&s);
+      }
     }
-    auto iter = b->find({type_hash_code, resource_name});
-    if (iter == b->end()) {
+  }
+  if (base == nullptr) {
+    if (ContainerExists(container)) {
       return errors::NotFound("Resource ", container, "/", resource_name, "/",
                               type_name, " does not exist.");
     }
-    base = iter->second;
-    b->erase(iter);
+    return errors::NotFound("Container ", container, " does not exist.");
   }
-  CHECK(base != nullptr);
   base->Unref();
   return Status::OK();
 }
@@ -229,29 +326,28 @@ Status ResourceMgr::Delete(const ResourceHandle& handle) {
 }
 
 Status ResourceMgr::Cleanup(const string& container) {
-  {
-    tf_shared_lock l(mu_);
-    if (!gtl::FindOrNull(containers_, container)) {
-      // Nothing to cleanup.
-      return Status::OK();
-    }
+  if (!ContainerExists(container)) {
+    // Nothing to cleanup.
+    return Status::OK();
   }
-  Container* b = nullptr;
-  {
-    mutex_lock l(mu_);
-    auto iter = containers_.find(container);
-    if (iter == containers_.end()) {
-      // Nothing to cleanup, it's OK (concurrent cleanup).
-      return Status::OK();
+  for (Shard& s : shards_) {
+    Container* b = nullptr;
+    {
+      mutex_lock l(s.mu);
+      auto iter = s.containers.find(container);
+      if (iter != s.containers.end()) {
+        b = iter->second;
+        s.containers.erase(iter);
+        PublishSnapshot(&s);
+      }
     }
-    b = iter->second;
-    containers_.erase(iter);
-  }
-  CHECK(b != nullptr);
-  for (const auto& p : *b) {
-    p.second->Unref();
+    if (b == nullptr) continue;  // Nothing in this shard (or concurrent
+                                 // cleanup).
+    for (const auto& p : *b) {
+      p.second->Unref();
+    }
+    delete b;
   }
-  delete b;
   return Status::OK();
 }
 
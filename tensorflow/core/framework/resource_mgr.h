@@ -136,9 +136,9 @@ class ResourceMgr {
   Status Lookup(const string& container, const string& name,
                 T** resource) const TF_MUST_USE_RESULT;
 
-  // Similar to Lookup, but looks up multiple resources at once, with only a
-  // single lock acquisition.  If containers_and_names[i] is uninitialized
-  // then this function does not modify resources[i].
+  // Similar to Lookup, but looks up multiple resources at once.  If
+  // containers_and_names[i] is uninitialized then this function does not
+  // modify resources[i].
   template <typename T, bool use_dynamic_cast = false>
   Status LookupMany(absl::Span<std::pair<const string*, const string*> const>
                         containers_and_names,
@@ -205,22 +205,64 @@ class ResourceMgr {
   };
   typedef std::unordered_map<Key, ResourceBase*, KeyHash, KeyEqual> Container;
 
+  // Resources are partitioned into shards by a hash of the resource name,
+  // so accesses to unrelated resources contend on different locks. Each
+  // shard additionally publishes an immutable snapshot of its contents
+  // after every mutation; lookups resolve against the current snapshot
+  // without taking the shard lock, so the hot path never waits on writers.
+  struct Snapshot {
+    // container name -> copy of that container's map in this shard. The
+    // snapshot owns one ref on every resource it references, so entries
+    // stay valid even if the resource is deleted concurrently.
+    std::unordered_map<string, Container> containers;
+    ~Snapshot();
+  };
+  struct Shard {
+    mutable mutex mu;
+    // container name -> the container's resources in this shard.
+    // Authoritative state; mutated only while holding 'mu'.
+    std::unordered_map<string, Container*> containers GUARDED_BY(mu);
+    // Read via std::atomic_load; replaced via std::atomic_store by
+    // PublishSnapshot() while holding 'mu'.
+    std::shared_ptr<const Snapshot> snapshot;
+  };
+  static constexpr int kNumShards = 16;
+
   const string default_container_;
-  mutable mutex mu_;
-  std::unordered_map<string, Container*> containers_ GUARDED_BY(mu_);
+  Shard shards_[kNumShards];
+
+  const Shard& shard(const string& name) const {
+    return shards_[Hash64(name.data(), name.size()) % kNumShards];
+  }
+  Shard& shard(const string& name) {
+    return shards_[Hash64(name.data(), name.size()) % kNumShards];
+  }
+
+  // Rebuilds and publishes 'shard's snapshot. Must be called after every
+  // mutation of 'shard->containers' before releasing the lock.
+  void PublishSnapshot(Shard* shard) EXCLUSIVE_LOCKS_REQUIRED(shard->mu);
+
+  // Returns true if any shard has resources in "container".
+  bool ContainerExists(const string& container) const;
 
   template <typename T, bool use_dynamic_cast = false>
   Status LookupInternal(const string& container, const string& name,
-                        T** resource) const
-      SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+                        T** resource) const TF_MUST_USE_RESULT;
 
   Status DoCreate(const string& container, TypeIndex type, const string& name,
-                  ResourceBase* resource)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+                  ResourceBase* resource) TF_MUST_USE_RESULT;
+
+  Status DoCreateLocked(Shard* shard, const string& container, TypeIndex type,
+                        const string& name, ResourceBase* resource)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->mu) TF_MUST_USE_RESULT;
 
   Status DoLookup(const string& container, TypeIndex type, const string& name,
-                  ResourceBase** resource) const
-      SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+                  ResourceBase** resource) const TF_MUST_USE_RESULT;
+
+  Status DoLookupOrCreate(const string& container, TypeIndex type,
+                          const string& name, ResourceBase** resource,
+                          std::function<Status(ResourceBase**)> creator)
+      TF_MUST_USE_RESULT;
 
   Status DoDelete(const string& container, uint64 type_hash_code,
                   const string& resource_name,
@@ -230,16 +272,16 @@ class ResourceMgr {
 
   // Inserts the type name for 'hash_code' into the hash_code to type name map.
   Status InsertDebugTypeName(uint64 hash_code, const string& type_name)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      TF_MUST_USE_RESULT;
 
   // Returns the type name for the 'hash_code'.
   // Returns "<unknown>" if a resource with such a type was never inserted into
   // the container.
-  const char* DebugTypeName(uint64 hash_code) const
-      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  const char* DebugTypeName(uint64 hash_code) const;
 
   // Map from type hash_code to type name.
-  std::unordered_map<uint64, string> debug_type_names_ GUARDED_BY(mu_);
+  mutable mutex debug_mu_;
+  std::unordered_map<uint64, string> debug_type_names_ GUARDED_BY(debug_mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(ResourceMgr);
 };
@@ -446,7 +488,6 @@ Status ResourceMgr::Create(const string& container, const string& name,
                            T* resource) {
   CheckDeriveFromResourceBase<T>();
   CHECK(resource != nullptr);
-  mutex_lock l(mu_);
   return DoCreate(container, MakeTypeIndex<T>(), name, resource);
 }
 
@@ -454,7 +495,6 @@ template <typename T, bool use_dynamic_cast>
 Status ResourceMgr::Lookup(const string& container, const string& name,
                            T** resource) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
   return LookupInternal<T, use_dynamic_cast>(container, name, resource);
 }
 
@@ -464,7 +504,6 @@ Status ResourceMgr::LookupMany(
         containers_and_names,
     std::vector<std::unique_ptr<T, core::RefCountDeleter>>* resources) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
   resources->resize(containers_and_names.size());
   for (size_t i = 0; i < containers_and_names.size(); ++i) {
     T* resource;
@@ -508,21 +547,19 @@ Status ResourceMgr::LookupOrCreate(const string& container, const string& name,
                                    std::function<Status(T**)> creator) {
   CheckDeriveFromResourceBase<T>();
   *resource = nullptr;
-  Status s;
-  {
-    tf_shared_lock l(mu_);
-    s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
-    if (s.ok()) return s;
-  }
-  mutex_lock l(mu_);
-  s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  Status s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
   if (s.ok()) return s;
-  TF_RETURN_IF_ERROR(creator(resource));
-  s = DoCreate(container, MakeTypeIndex<T>(), name, *resource);
-  if (!s.ok()) {
-    return errors::Internal("LookupOrCreate failed unexpectedly");
+  ResourceBase* created = nullptr;
+  s = DoLookupOrCreate(container, MakeTypeIndex<T>(), name, &created,
+                       [&creator](ResourceBase** ret) {
+                         T* value = nullptr;
+                         TF_RETURN_IF_ERROR(creator(&value));
+                         *ret = value;
+                         return Status::OK();
+                       });
+  if (s.ok()) {
+    *resource = TypeCastFunctor<T, use_dynamic_cast>::Cast(created);
   }
-  (*resource)->Ref();
   return s;
 }
 
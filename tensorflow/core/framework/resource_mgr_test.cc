@@ -125,6 +125,30 @@ TEST(ResourceMgrTest, Basic) {
   TF_CHECK_OK(rm.Cleanup("bar"));
 }
 
+TEST(ResourceMgrTest, ManyResourcesInOneContainer) {
+  // Resources are sharded internally by name; a container's resources
+  // must still behave as one unit.
+  ResourceMgr rm;
+  const int n = 100;
+  for (int i = 0; i < n; ++i) {
+    TF_CHECK_OK(rm.Create("foo", strings::StrCat("r", i),
+                          new Resource(strings::StrCat("v", i))));
+  }
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(strings::StrCat("R/v", i),
+              Find<Resource>(rm, "foo", strings::StrCat("r", i)));
+  }
+  std::vector<ResourceMgr::ResourceEntry> entries;
+  rm.GetContainerResources("foo", &entries);
+  EXPECT_EQ(n, entries.size());
+
+  TF_CHECK_OK(rm.Cleanup("foo"));
+  for (int i = 0; i < n; ++i) {
+    HasError(FindErr<Resource>(rm, "foo", strings::StrCat("r", i)),
+             "Not found: Container foo");
+  }
+}
+
 TEST(ResourceMgrTest, CreateOrLookup) {
   ResourceMgr rm;
   EXPECT_EQ("R/cat", LookupOrCreate<Resource>(&rm, "foo", "bar", "cat"));
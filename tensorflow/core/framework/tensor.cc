@@ -50,6 +50,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/tensor_coding.h"
 #include "tensorflow/core/platform/types.h"
@@ -120,6 +121,43 @@ class Buffer : public BufferBase {
   TF_DISALLOW_COPY_AND_ASSIGN(Buffer);
 };
 
+// Typed ref-counted buffer whose payload is stored inline in the object
+// itself, so that a tiny tensor costs a single heap allocation instead
+// of a separate buffer object and payload.  Like the host-scalar tensor
+// buffers, the payload does not come from an allocator, which is why its
+// use is restricted to the default CPU allocator with no size tracking
+// (see UseInlineBuffer below).  The object is allocated with
+// EIGEN_MAX_ALIGN_BYTES alignment so kernels see the same payload
+// alignment an allocator would provide.
+template <typename T>
+class InlineBuffer : public BufferBase {
+ public:
+  static const int64 kMaxBytes = EIGEN_MAX_ALIGN_BYTES;
+
+  InlineBuffer(Allocator* a, int64 n) : BufferBase(a, space_), elem_(n) {}
+
+  size_t size() const override { return sizeof(T) * elem_; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size());
+    proto->set_allocator_name(alloc_->Name());
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  static void* operator new(size_t size) {
+    return port::AlignedMalloc(size, EIGEN_MAX_ALIGN_BYTES);
+  }
+  static void operator delete(void* ptr) { port::AlignedFree(ptr); }
+
+ private:
+  alignas(EIGEN_MAX_ALIGN_BYTES) char space_[kMaxBytes];
+  int64 elem_;
+
+  ~InlineBuffer() override {}
+
+  TF_DISALLOW_COPY_AND_ASSIGN(InlineBuffer);
+};
+
 void LogUnexpectedSize(int64 actual, int64 expected) {
   LOG(ERROR) << "Input size was " << actual << " and expected " << expected;
 }
@@ -463,6 +501,33 @@ Buffer<T>::~Buffer() {
   }
 }
 
+// Returns true if a buffer of n elements of type T should store its
+// payload inline.  The payload of an InlineBuffer does not come from an
+// allocator, so inline storage is only safe for the default CPU
+// allocator: any other allocator may be supplying device memory or
+// participating in memory accounting, and tensor payloads must then
+// really be obtained from it.
+template <typename T>
+bool UseInlineBuffer(Allocator* a, int64 n) {
+  // Cached to avoid the lock inside cpu_allocator().
+  static Allocator* const default_cpu_allocator = cpu_allocator();
+  return is_simple_type<T>::value && n > 0 &&
+         static_cast<int64>(sizeof(T)) * n <= InlineBuffer<T>::kMaxBytes &&
+         a == default_cpu_allocator && !a->TracksAllocationSizes() &&
+         !LogMemory::IsEnabled();
+}
+
+// Allocates a buffer of n elements of type T from a, storing the payload
+// inline when possible.
+template <typename T>
+TensorBuffer* MakeBuffer(Allocator* a, int64 n,
+                         const AllocationAttributes& allocation_attr) {
+  if (UseInlineBuffer<T>(a, n)) {
+    return new InlineBuffer<T>(a, n);
+  }
+  return new Buffer<T>(a, n, allocation_attr);
+}
+
 // Allocates a T[n] buffer. Fills in the buffer with repeated values
 // in "in".  If "in" has less values than "n", fills the rest of T[n]
 // with the last value. If "in" has no values, fills T[n] with the
@@ -743,7 +808,8 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape)
   set_dtype(type);
   CHECK_NOTNULL(a);
   if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
-    CASES(type, buf_ = new Buffer<T>(a, shape.num_elements()));
+    CASES(type, buf_ = MakeBuffer<T>(a, shape.num_elements(),
+                                     AllocationAttributes()));
   }
   if (buf_ != nullptr && buf_->data() != nullptr && LogMemory::IsEnabled()) {
     LogMemory::RecordTensorAllocation("Unknown", LogMemory::UNKNOWN_STEP_ID,
@@ -757,7 +823,7 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape,
   set_dtype(type);
   CHECK_NOTNULL(a);
   if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
-    CASES(type, buf_ = new Buffer<T>(a, shape.num_elements(), allocation_attr));
+    CASES(type, buf_ = MakeBuffer<T>(a, shape.num_elements(), allocation_attr));
   }
   if (!allocation_attr.allocation_will_be_logged && buf_ != nullptr &&
       buf_->data() != nullptr && LogMemory::IsEnabled()) {
@@ -639,6 +639,9 @@ class Tensor {
   friend class NumpyTensorBuffer;  // For access to the private constructor
                                    // taking the buffer.
 
+  friend class BorrowedTensorBuffer;  // For access to the private constructor
+                                      // taking the buffer.
+
   // Creates a tensor with the input datatype, shape and buf.
   //
   // Acquires a ref on buf that belongs to this Tensor.
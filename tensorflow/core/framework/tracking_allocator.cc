@@ -15,19 +15,58 @@ limitations under the License.
 
 #include "tensorflow/core/framework/tracking_allocator.h"
 
+#include <cstdlib>
+
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Reads TF_TRACKING_ALLOCATOR_SAMPLE_RATE once; 1 (record every
+// allocation) if unset or unparseable.
+int64 SampleRateFromEnv() {
+  static const int64 sample_rate = [] {
+    int64 rate = 1;
+    const char* val = std::getenv("TF_TRACKING_ALLOCATOR_SAMPLE_RATE");
+    if (val != nullptr && !strings::safe_strto64(val, &rate)) {
+      LOG(ERROR) << "Invalid TF_TRACKING_ALLOCATOR_SAMPLE_RATE: " << val;
+      rate = 1;
+    }
+    return rate < 1 ? 1 : rate;
+  }();
+  return sample_rate;
+}
+
+}  // namespace
+
 TrackingAllocator::TrackingAllocator(Allocator* allocator, bool track_sizes)
+    : TrackingAllocator(allocator, track_sizes, SampleRateFromEnv()) {}
+
+TrackingAllocator::TrackingAllocator(Allocator* allocator, bool track_sizes,
+                                     int64 sample_rate)
     : allocator_(allocator),
       ref_(1),
       allocated_(0),
       high_watermark_(0),
       total_bytes_(0),
       track_sizes_locally_(track_sizes && !allocator_->TracksAllocationSizes()),
-      next_allocation_id_(0) {}
+      next_allocation_id_(0),
+      sample_rate_(sample_rate),
+      sampling_(sample_rate > 1 && allocator_->TracksAllocationSizes()),
+      atomic_ref_(1),
+      atomic_allocated_(0),
+      atomic_high_watermark_(0),
+      atomic_total_bytes_(0) {}
+
+bool TrackingAllocator::TakeSample() {
+  // One stride counter per thread, shared by all wrappers the thread
+  // allocates through.
+  static thread_local int64 allocation_events = 0;
+  return (++allocation_events % sample_rate_) == 0;
+}
 
 void* TrackingAllocator::AllocateRaw(
     size_t alignment, size_t num_bytes,
@@ -38,6 +77,26 @@ void* TrackingAllocator::AllocateRaw(
   if (nullptr == ptr) {
     return ptr;
   }
+  if (sampling_) {
+    size_t allocated_bytes = allocator_->AllocatedSize(ptr);
+    atomic_ref_.fetch_add(1, std::memory_order_relaxed);
+    size_t allocated = atomic_allocated_.fetch_add(allocated_bytes,
+                                                   std::memory_order_relaxed) +
+                       allocated_bytes;
+    size_t watermark = atomic_high_watermark_.load(std::memory_order_relaxed);
+    while (allocated > watermark &&
+           !atomic_high_watermark_.compare_exchange_weak(
+               watermark, allocated, std::memory_order_relaxed)) {
+    }
+    atomic_total_bytes_.fetch_add(allocated_bytes, std::memory_order_relaxed);
+    if (TakeSample()) {
+      mutex_lock lock(mu_);
+      allocations_.emplace_back(
+          static_cast<int64>(allocated_bytes) * sample_rate_,
+          Env::Default()->NowMicros());
+    }
+    return ptr;
+  }
   if (allocator_->TracksAllocationSizes()) {
     size_t allocated_bytes = allocator_->AllocatedSize(ptr);
     {
@@ -77,6 +136,26 @@ void TrackingAllocator::DeallocateRaw(void* ptr) {
   if (nullptr == ptr) {
     return;
   }
+  if (sampling_) {
+    size_t allocated_bytes = allocator_->AllocatedSize(ptr);
+    atomic_allocated_.fetch_sub(allocated_bytes, std::memory_order_relaxed);
+    if (TakeSample()) {
+      mutex_lock lock(mu_);
+      allocations_.emplace_back(
+          -static_cast<int64>(allocated_bytes) * sample_rate_,
+          Env::Default()->NowMicros());
+    }
+    // Copy allocator_ out first: once the reference is dropped another
+    // thread may delete this wrapper.
+    Allocator* allocator = allocator_;
+    bool should_delete =
+        atomic_ref_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    allocator->DeallocateRaw(ptr);
+    if (should_delete) {
+      delete this;
+    }
+    return;
+  }
   bool should_delete;
   // fetch the following outside the lock in case the call to
   // AllocatedSize is slow
@@ -159,6 +238,12 @@ absl::optional<AllocatorStats> TrackingAllocator::GetStats() {
 void TrackingAllocator::ClearStats() { allocator_->ClearStats(); }
 
 std::tuple<size_t, size_t, size_t> TrackingAllocator::GetSizes() {
+  if (sampling_) {
+    return std::make_tuple(
+        atomic_total_bytes_.load(std::memory_order_relaxed),
+        atomic_high_watermark_.load(std::memory_order_relaxed),
+        atomic_allocated_.load(std::memory_order_relaxed));
+  }
   size_t high_watermark;
   size_t total_bytes;
   size_t still_live_bytes;
@@ -172,6 +257,17 @@ std::tuple<size_t, size_t, size_t> TrackingAllocator::GetSizes() {
 }
 
 gtl::InlinedVector<AllocRecord, 4> TrackingAllocator::GetRecordsAndUnRef() {
+  if (sampling_) {
+    gtl::InlinedVector<AllocRecord, 4> allocations;
+    {
+      mutex_lock lock(mu_);
+      allocations.swap(allocations_);
+    }
+    if (atomic_ref_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+    return allocations;
+  }
   bool should_delete;
   gtl::InlinedVector<AllocRecord, 4> allocations;
   {
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_TRACKING_ALLOCATOR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_TRACKING_ALLOCATOR_H_
 
+#include <atomic>
 #include <unordered_map>
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
@@ -42,6 +43,17 @@ namespace tensorflow {
 // TrackingAllocator keeps track of outstanding calls using a
 // reference count, and deletes itself once the last call has been
 // received and the high watermark has been retrieved.
+//
+// When the environment variable TF_TRACKING_ALLOCATOR_SAMPLE_RATE is
+// set to N > 1 and the underlying allocator tracks allocation sizes,
+// the wrapper runs in a low-overhead sampling mode: the byte counters
+// are maintained with atomic operations instead of a mutex, and only
+// every Nth allocation event gets an AllocRecord, with its size
+// scaled by N so the record series remains an unbiased estimate of
+// the true one.  GetSizes() stays exact in this mode; only the
+// per-allocation records are approximate.  This makes the per-op
+// memory attribution that StepStatsCollector folds into RunMetadata
+// cheap enough to leave enabled continuously.
 struct AllocRecord {
   AllocRecord(int64 a_btyes, int64 a_micros)
       : alloc_bytes(a_btyes), alloc_micros(a_micros) {}
@@ -53,7 +65,12 @@ struct AllocRecord {
 
 class TrackingAllocator : public Allocator {
  public:
+  // Takes the sampling rate from TF_TRACKING_ALLOCATOR_SAMPLE_RATE.
   explicit TrackingAllocator(Allocator* allocator, bool track_ids);
+  // As above, but with an explicit rate: if sample_rate > 1 and
+  // "allocator" tracks allocation sizes, only every sample_rate-th
+  // allocation event is recorded, scaled by sample_rate.
+  TrackingAllocator(Allocator* allocator, bool track_ids, int64 sample_rate);
   string Name() override { return allocator_->Name(); }
   void* AllocateRaw(size_t alignment, size_t num_bytes) override {
     return AllocateRaw(alignment, num_bytes, AllocationAttributes());
@@ -93,6 +110,12 @@ class TrackingAllocator : public Allocator {
  private:
   bool UnRef() EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Returns true if the calling thread's allocation-event stride hit
+  // a multiple of sample_rate_.  The stride counter is thread-local
+  // and shared by all wrappers a thread touches, so the decision
+  // never synchronizes across threads.
+  bool TakeSample();
+
   Allocator* allocator_;  // not owned.
   mutable mutex mu_;
   // the number of calls to AllocateRaw that have not yet been matched
@@ -125,6 +148,19 @@ class TrackingAllocator : public Allocator {
   };
   std::unordered_map<const void*, Chunk> in_use_ GUARDED_BY(mu_);
   int64 next_allocation_id_ GUARDED_BY(mu_);
+
+  // Number of allocation events between recorded samples; 1 records
+  // every event.
+  const int64 sample_rate_;
+  // True when sample_rate_ > 1 and the underlying allocator tracks
+  // allocation sizes.  The atomic counters below then supersede their
+  // mutex-guarded counterparts above, and mu_ is only taken for the
+  // sampled records.
+  const bool sampling_;
+  std::atomic<int> atomic_ref_;
+  std::atomic<size_t> atomic_allocated_;
+  std::atomic<size_t> atomic_high_watermark_;
+  std::atomic<size_t> atomic_total_bytes_;
 };
 
 }  // end namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/tracking_allocator.h"
 
+#include <cstdlib>
 #include <unordered_map>
 
 #include "tensorflow/core/framework/allocator.h"
@@ -139,6 +140,38 @@ TEST(TrackingAllocatorTest, SimpleTracking) {
   EXPECT_EQ(-4, records[3].alloc_bytes);
 }
 
+TEST(TrackingAllocatorTest, SampledTracking) {
+  TestableSizeTrackingAllocator a = TestableSizeTrackingAllocator();
+
+  EXPECT_TRUE(a.TracksAllocationSizes());
+
+  TrackingAllocator* ta = new TrackingAllocator(&a, false, 2 /*sample_rate*/);
+
+  void* ptrs[4];
+  for (int i = 0; i < 4; ++i) {
+    ptrs[i] = ta->AllocateRaw(4, 12);
+  }
+
+  // Byte totals stay exact in sampling mode.
+  std::tuple<size_t, size_t, size_t> sizes = ta->GetSizes();
+
+  EXPECT_EQ(48, std::get<0>(sizes));
+  EXPECT_EQ(48, std::get<1>(sizes));
+  EXPECT_EQ(48, std::get<2>(sizes));
+
+  for (int i = 0; i < 4; ++i) {
+    ta->DeallocateRaw(ptrs[i]);
+  }
+
+  // Every second event is recorded, with its size scaled by the
+  // sample rate: eight events produce four records of 24 bytes.
+  auto records = ta->GetRecordsAndUnRef();
+  EXPECT_EQ(4, records.size());
+  for (const auto& record : records) {
+    EXPECT_EQ(24, std::abs(record.alloc_bytes));
+  }
+}
+
 TEST(TrackingAllocatorTest, OutOfMemory) {
   NoMemoryAllocator a;
 
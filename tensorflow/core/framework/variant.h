@@ -73,6 +73,13 @@ void EncodeVariant(const T& value, string* buf);
 //
 // Simple POD types can elide the Encode/Decode functions, they are provided by
 // helper methods.
+//
+// Small objects are stored inline: if the wrapped value fits in the internal
+// 48-byte buffer (and its alignment permits; see CanInlineType<T>()), storing,
+// moving or swapping it performs no heap allocation. Larger objects fall back
+// to a heap-allocated wrapper. Moves of inline values invoke the contained
+// type's move constructor rather than copying.
+//
 // Here are some typical usage patterns:
 //
 //   Variant x = 10;
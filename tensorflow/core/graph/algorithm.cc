@@ -206,6 +206,17 @@ void GetReversePostOrder(const Graph& g, std::vector<Node*>* order,
   std::reverse(order->begin(), order->end());
 }
 
+// Defined here rather than in graph.cc so that the lower-level library
+// containing Graph does not depend on the traversal code above.
+const std::vector<Node*>& Graph::GetCachedReversePostOrder() const {
+  mutex_lock l(cached_order_mu_);
+  if (cached_order_version_ != structure_version_) {
+    GetReversePostOrder(*this, &cached_reverse_post_order_);
+    cached_order_version_ = structure_version_;
+  }
+  return cached_reverse_post_order_;
+}
+
 bool PruneForReverseReachability(Graph* g,
                                  std::unordered_set<const Node*> start) {
   // Compute set of nodes that we need to traverse in order to reach
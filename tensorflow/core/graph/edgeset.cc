@@ -15,13 +15,30 @@ limitations under the License.
 
 #include "tensorflow/core/graph/edgeset.h"
 
+#include <algorithm>
+
+#include "tensorflow/core/graph/graph.h"
+
 namespace tensorflow {
 
+namespace {
+
+// Spilled edges are kept sorted by edge id, so iteration order is the
+// order the graph created the edges in, not wherever the arena placed
+// them.  Ties (edges that were never registered with a graph, as in
+// tests) fall back to address order to keep the comparator strict.
+bool EdgeLess(const Edge* a, const Edge* b) {
+  if (a->id() != b->id()) return a->id() < b->id();
+  return a < b;
+}
+
+}  // namespace
+
 std::pair<EdgeSet::const_iterator, bool> EdgeSet::insert(value_type value) {
   RegisterMutation();
   const_iterator ci;
   ci.Init(this);
-  auto s = get_set();
+  auto s = get_vector();
   if (!s) {
     for (int i = 0; i < kInline; i++) {
       if (ptrs_[i] == value) {
@@ -36,22 +53,30 @@ std::pair<EdgeSet::const_iterator, bool> EdgeSet::insert(value_type value) {
         return std::make_pair(ci, true);
       }
     }
-    // array is full. convert to set.
-    s = new gtl::FlatSet<const Edge*>;
-    s->insert(reinterpret_cast<const Edge**>(std::begin(ptrs_)),
-              reinterpret_cast<const Edge**>(std::end(ptrs_)));
+    // array is full. convert to a sorted vector.
+    s = new std::vector<const Edge*>(
+        reinterpret_cast<const Edge**>(std::begin(ptrs_)),
+        reinterpret_cast<const Edge**>(std::end(ptrs_)));
+    std::sort(s->begin(), s->end(), EdgeLess);
     ptrs_[0] = this;
     ptrs_[1] = s;
     // fall through.
   }
-  auto p = s->insert(value);
-  ci.tree_iter_ = p.first;
-  return std::make_pair(ci, p.second);
+  // Edges are almost always inserted in increasing id order, so this is
+  // usually an O(1) append; out-of-order inserts pay a memmove.
+  auto pos = std::lower_bound(s->begin(), s->end(), value, EdgeLess);
+  const size_t index = pos - s->begin();
+  const bool inserted = (pos == s->end() || *pos != value);
+  if (inserted) {
+    s->insert(pos, value);
+  }
+  ci.array_iter_ = reinterpret_cast<void const* const*>(s->data() + index);
+  return std::make_pair(ci, inserted);
 }
 
 EdgeSet::size_type EdgeSet::erase(key_type key) {
   RegisterMutation();
-  auto s = get_set();
+  auto s = get_vector();
   if (!s) {
     for (int i = 0; i < kInline; i++) {
       if (ptrs_[i] == key) {
@@ -63,7 +88,12 @@ EdgeSet::size_type EdgeSet::erase(key_type key) {
     }
     return 0;
   } else {
-    return s->erase(key);
+    auto pos = std::lower_bound(s->begin(), s->end(), key, EdgeLess);
+    if (pos != s->end() && *pos == key) {
+      s->erase(pos);
+      return 1;
+    }
+    return 0;
   }
 }
 
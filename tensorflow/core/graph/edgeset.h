@@ -18,7 +18,8 @@ limitations under the License.
 
 #include <stddef.h>
 
-#include "tensorflow/core/lib/gtl/flatset.h"
+#include <vector>
+
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
@@ -26,9 +27,11 @@ namespace tensorflow {
 
 class Edge;
 
-// An unordered set of edges.  Uses very little memory for small sets.
-// Unlike gtl::FlatSet, EdgeSet does NOT allow mutations during
-// iteration.
+// A set of edges.  Uses very little memory for small sets.  Storage is
+// always contiguous (an inline array, or a vector sorted by edge id once
+// the array overflows), so iteration is cache-friendly and visits edges
+// in an order that does not depend on where the heap placed them.
+// EdgeSet does NOT allow mutations during iteration.
 class EdgeSet {
  public:
   EdgeSet();
@@ -54,15 +57,15 @@ class EdgeSet {
 
  private:
   // Up to kInline elements are stored directly in ptrs_ (nullptr means none).
-  // If ptrs_[0] == this then ptrs_[1] points to a set<const Edge*>.
-  // kInline must be >= 2, and is chosen such that ptrs_ fills a 64 byte
-  // cacheline.
+  // If ptrs_[0] == this then ptrs_[1] points to a vector<const Edge*>
+  // sorted by edge id.  kInline must be >= 2, and is chosen such that
+  // ptrs_ fills a 64 byte cacheline.
   static constexpr int kInline = 64 / sizeof(const void*);
   const void* ptrs_[kInline];
 
-  gtl::FlatSet<const Edge*>* get_set() const {
+  std::vector<const Edge*>* get_vector() const {
     if (ptrs_[0] == this) {
-      return static_cast<gtl::FlatSet<const Edge*>*>(
+      return static_cast<std::vector<const Edge*>*>(
           const_cast<void*>(ptrs_[1]));
     } else {
       return nullptr;
@@ -103,7 +106,6 @@ class EdgeSet::const_iterator {
   friend class EdgeSet;
 
   void const* const* array_iter_ = nullptr;
-  typename gtl::FlatSet<const Edge*>::const_iterator tree_iter_;
 
 #ifdef NDEBUG
   inline void Init(const EdgeSet* e) {}
@@ -127,12 +129,12 @@ inline EdgeSet::EdgeSet() {
   }
 }
 
-inline EdgeSet::~EdgeSet() { delete get_set(); }
+inline EdgeSet::~EdgeSet() { delete get_vector(); }
 
 inline bool EdgeSet::empty() const { return size() == 0; }
 
 inline EdgeSet::size_type EdgeSet::size() const {
-  auto s = get_set();
+  auto s = get_vector();
   if (s) {
     return s->size();
   } else {
@@ -146,7 +148,7 @@ inline EdgeSet::size_type EdgeSet::size() const {
 
 inline void EdgeSet::clear() {
   RegisterMutation();
-  delete get_set();
+  delete get_vector();
   for (int i = 0; i < kInline; i++) {
     ptrs_[i] = nullptr;
   }
@@ -155,9 +157,9 @@ inline void EdgeSet::clear() {
 inline EdgeSet::const_iterator EdgeSet::begin() const {
   const_iterator ci;
   ci.Init(this);
-  auto s = get_set();
+  auto s = get_vector();
   if (s) {
-    ci.tree_iter_ = s->begin();
+    ci.array_iter_ = reinterpret_cast<void const* const*>(s->data());
   } else {
     ci.array_iter_ = &ptrs_[0];
   }
@@ -167,9 +169,10 @@ inline EdgeSet::const_iterator EdgeSet::begin() const {
 inline EdgeSet::const_iterator EdgeSet::end() const {
   const_iterator ci;
   ci.Init(this);
-  auto s = get_set();
+  auto s = get_vector();
   if (s) {
-    ci.tree_iter_ = s->end();
+    ci.array_iter_ =
+        reinterpret_cast<void const* const*>(s->data() + s->size());
   } else {
     ci.array_iter_ = &ptrs_[size()];
   }
@@ -178,11 +181,7 @@ inline EdgeSet::const_iterator EdgeSet::end() const {
 
 inline EdgeSet::const_iterator& EdgeSet::const_iterator::operator++() {
   CheckNoMutations();
-  if (array_iter_ != nullptr) {
-    ++array_iter_;
-  } else {
-    ++tree_iter_;
-  }
+  ++array_iter_;
   return *this;
 }
 
@@ -199,11 +198,7 @@ inline EdgeSet::const_iterator EdgeSet::const_iterator::operator++(
 inline const EdgeSet::const_iterator::value_type* EdgeSet::const_iterator::
 operator->() const {
   CheckNoMutations();
-  if (array_iter_ != nullptr) {
-    return reinterpret_cast<const value_type*>(array_iter_);
-  } else {
-    return tree_iter_.operator->();
-  }
+  return reinterpret_cast<const value_type*>(array_iter_);
 }
 
 // gcc's set and multiset always use const_iterator since it will otherwise
@@ -211,24 +206,13 @@ operator->() const {
 inline EdgeSet::const_iterator::value_type EdgeSet::const_iterator::operator*()
     const {
   CheckNoMutations();
-  if (array_iter_ != nullptr) {
-    return static_cast<value_type>(*array_iter_);
-  } else {
-    return *tree_iter_;
-  }
+  return static_cast<value_type>(*array_iter_);
 }
 
 inline bool EdgeSet::const_iterator::operator==(
     const const_iterator& other) const {
-  DCHECK((array_iter_ == nullptr) == (other.array_iter_ == nullptr))
-      << "Iterators being compared must be from same set that has not "
-      << "been modified since the iterator was constructed";
   CheckNoMutations();
-  if (array_iter_ != nullptr) {
-    return array_iter_ == other.array_iter_;
-  } else {
-    return other.array_iter_ == nullptr && tree_iter_ == other.tree_iter_;
-  }
+  return array_iter_ == other.array_iter_;
 }
 
 }  // namespace tensorflow
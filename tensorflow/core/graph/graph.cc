@@ -15,10 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/graph/graph.h"
 
+#include <unordered_map>
 #include <vector>
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/while_context.h"
@@ -28,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/public/version.h"
 
 namespace tensorflow {
@@ -47,8 +50,86 @@ struct NodeProperties {
   NodeDef node_def;
   const DataTypeVector input_types;
   const DataTypeVector output_types;
+
+  // True iff this instance lives in the process-wide intern table below and
+  // may therefore be shared by nodes in unrelated graphs. Interned instances
+  // must never be mutated in place, even when a single node holds the last
+  // strong reference; see Node::MaybeCopyOnWrite().
+  bool interned = false;
+};
+
+namespace {
+
+// Process-wide intern table for NodeProperties. Sessions loading the same
+// GraphDef construct byte-identical NodeDefs, so sharing one immutable
+// NodeProperties per distinct definition stores each node's attr map once
+// per process instead of once per session. Entries are weak: the table
+// never extends a property's lifetime, and expired entries are swept once
+// the table has doubled in size since the previous sweep.
+class NodePropertiesInterner {
+ public:
+  static NodePropertiesInterner* Global() {
+    static NodePropertiesInterner* instance = new NodePropertiesInterner;
+    return instance;
+  }
+
+  // Returns an interned NodeProperties equivalent to the one 'create' would
+  // build, invoking 'create' only on a miss. 'op_def' must be owned by the
+  // process-lifetime global op registry; the caller is responsible for
+  // checking this, since the table may hand the same instance to any graph.
+  std::shared_ptr<NodeProperties> FindOrCreate(
+      const NodeDef& node_def, const OpDef* op_def,
+      const std::function<std::shared_ptr<NodeProperties>()>& create) {
+    string key = node_def.SerializeAsString();
+    {
+      mutex_lock l(mu_);
+      auto iter = props_.find(key);
+      if (iter != props_.end()) {
+        std::shared_ptr<NodeProperties> existing = iter->second.lock();
+        // Identical serialized bytes imply an identical NodeDef, but the op
+        // name may resolve to a different OpDef in another graph's function
+        // library; only share when the resolved OpDef is the same.
+        if (existing != nullptr && existing->op_def == op_def) {
+          return existing;
+        }
+      }
+    }
+    std::shared_ptr<NodeProperties> props = create();
+    props->interned = true;
+    mutex_lock l(mu_);
+    std::weak_ptr<NodeProperties>& entry = props_[key];
+    std::shared_ptr<NodeProperties> existing = entry.lock();
+    if (existing != nullptr && existing->op_def == op_def) {
+      return existing;
+    }
+    entry = props;
+    MaybeSweep();
+    return props;
+  }
+
+ private:
+  void MaybeSweep() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (props_.size() < 64 || props_.size() < 2 * last_sweep_size_) {
+      return;
+    }
+    for (auto iter = props_.begin(); iter != props_.end();) {
+      if (iter->second.expired()) {
+        iter = props_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    last_sweep_size_ = props_.size();
+  }
+
+  mutex mu_;
+  std::unordered_map<string, std::weak_ptr<NodeProperties>> props_
+      GUARDED_BY(mu_);
+  size_t last_sweep_size_ GUARDED_BY(mu_) = 0;
 };
 
+}  // namespace
+
 // Node
 
 #define REF_CLASS(key, value) \
@@ -199,9 +280,12 @@ gtl::iterator_range<NeighborIter> Node::in_nodes() const {
 }
 
 void Node::MaybeCopyOnWrite() {
-  // NodeProperties may be shared between Nodes. Make a copy if so.
-  if (!props_.unique()) {
+  // NodeProperties may be shared between Nodes, and interned instances may
+  // additionally be shared with unrelated graphs (and be reachable through
+  // the intern table even when unique). Make a copy if so.
+  if (!props_.unique() || props_->interned) {
     props_ = std::make_shared<NodeProperties>(*props_);
+    props_->interned = false;
   }
 }
 
@@ -422,9 +506,23 @@ Node* Graph::AddNode(const NodeDef& node_def, Status* status) {
     return nullptr;
   }
 
-  Node* node = AllocateNode(
-      std::make_shared<NodeProperties>(op_def, node_def, inputs, outputs),
-      nullptr);
+  // Intern the properties when the op resolves to the global registry, so
+  // identical nodes in other graphs (typically other sessions loading the
+  // same GraphDef) share one copy of the attr map. Function-library OpDefs
+  // are owned by a graph and may not outlive the shared properties.
+  std::shared_ptr<NodeProperties> props;
+  const OpDef* global_op_def = nullptr;
+  if (OpRegistry::Global()->LookUpOpDef(node_def.op(), &global_op_def).ok() &&
+      global_op_def == op_def) {
+    props = NodePropertiesInterner::Global()->FindOrCreate(
+        node_def, op_def, [&]() {
+          return std::make_shared<NodeProperties>(op_def, node_def, inputs,
+                                                  outputs);
+        });
+  } else {
+    props = std::make_shared<NodeProperties>(op_def, node_def, inputs, outputs);
+  }
+  Node* node = AllocateNode(std::move(props), nullptr);
   return node;
 }
 
@@ -498,6 +596,7 @@ const Edge* Graph::AddEdge(Node* source, int x, Node* dest, int y) {
   CHECK(dest->in_edges_.insert(e).second);
   edges_.push_back(e);
   ++num_edges_;
+  ++structure_version_;
   return e;
 }
 
@@ -516,6 +615,7 @@ void Graph::RemoveEdge(const Edge* e) {
 
 void Graph::RecycleEdge(const Edge* e) {
   free_edges_.push_back(const_cast<Edge*>(e));
+  ++structure_version_;
 }
 
 const Edge* Graph::AddControlEdge(Node* source, Node* dest,
@@ -767,6 +867,7 @@ Node* Graph::AllocateNode(std::shared_ptr<NodeProperties> props,
   node->Initialize(id, cost_id, std::move(props));
   nodes_.push_back(node);
   ++num_nodes_;
+  ++structure_version_;
   return node;
 }
 
@@ -775,6 +876,7 @@ void Graph::ReleaseNode(Node* node) {
   nodes_[node->id()] = nullptr;
   free_nodes_.push_back(node);
   --num_nodes_;
+  ++structure_version_;
   node->Clear();
 }
 
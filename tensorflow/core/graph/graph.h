@@ -52,6 +52,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/iterator_range.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -384,7 +385,9 @@ class Edge {
   friend class Graph;
   Node* src_;
   Node* dst_;
-  int id_;
+  // Initialized so EdgeSet's id-ordered storage is well-defined even for
+  // edges that were never registered with a graph.
+  int id_ = -1;
   int src_output_;
   int dst_input_;
 };
@@ -655,6 +658,21 @@ class Graph {
   // Builds a node name to node pointer index for all nodes in the graph.
   std::unordered_map<string, Node*> BuildNodeNameIndex() const;
 
+  // A counter that changes every time a node or edge is added to or removed
+  // from this graph. Results derived purely from the graph's structure can
+  // be memoized against it.
+  int64 structure_version() const { return structure_version_; }
+
+  // Returns the nodes in reverse post-order, equivalent to calling
+  // GetReversePostOrder (see algorithm.h) with default arguments. The
+  // ordering is computed on first use and reused until the structure
+  // changes, so pipelines that repeatedly traverse an unchanged graph pay
+  // for a single walk. The returned reference (but not the Node pointers
+  // already consumed from it) is invalidated by the next structural
+  // mutation. Safe to call from concurrent readers; like the rest of
+  // Graph, not thread-safe with concurrent mutation.
+  const std::vector<Node*>& GetCachedReversePostOrder() const;
+
   // TODO(josh11b): uint64 hash() const;
 
  private:
@@ -695,6 +713,17 @@ class Graph {
   std::vector<Node*> free_nodes_;
   std::vector<Edge*> free_edges_;
 
+  // Bumped by AllocateNode/ReleaseNode/AddEdge/RemoveEdge; see
+  // structure_version().
+  int64 structure_version_ = 0;
+
+  // Lazily filled by GetCachedReversePostOrder(). The mutex only
+  // serializes concurrent readers racing to fill the cache.
+  mutable mutex cached_order_mu_;
+  mutable int64 cached_order_version_ GUARDED_BY(cached_order_mu_) = -1;
+  mutable std::vector<Node*> cached_reverse_post_order_
+      GUARDED_BY(cached_order_mu_);
+
   // For generating unique names.
   int name_counter_ = 0;
 
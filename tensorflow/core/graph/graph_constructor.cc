@@ -36,12 +36,16 @@ limitations under the License.
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/tensor_id.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/public/version.h"
 
@@ -185,6 +189,13 @@ class GraphConstructor {
 
   Status EnsureNoNameCollisions();
   Status ValidateInputMapAndControlDependencies();
+  // Checks properties of `node_def` that depend on no other node: name
+  // syntax, presence of an op (and device, if requested) and input
+  // ordering. Called for every node by ValidateAllNodeDefs.
+  Status ValidateNodeDefSyntax(const NodeDef& node_def);
+  // Runs ValidateNodeDefSyntax on every entry of node_defs_, sharded
+  // across threads for large graphs.
+  Status ValidateAllNodeDefs();
   Status BuildNodeIndex();
   Status InitFromEdges();
   Status Convert();
@@ -459,42 +470,89 @@ Status GraphConstructor::ValidateInputMapAndControlDependencies() {
   return Status::OK();
 }
 
-Status GraphConstructor::BuildNodeIndex() {
-  // Validate the node names and add them to gdef_nodes_ and gdef_prefixes_.
-  for (int n = 0; n < node_defs_.size(); ++n) {
-    const NodeDef& node_def = *node_defs_[n];
-    if (!IsValidNodeName(node_def.name(), opts_.allow_internal_ops)) {
+Status GraphConstructor::ValidateNodeDefSyntax(const NodeDef& node_def) {
+  if (!IsValidNodeName(node_def.name(), opts_.allow_internal_ops)) {
+    return errors::InvalidArgument("Node '", node_def.name(),
+                                   "': Node name contains invalid characters");
+  }
+  // Validate the operation's type.
+  if (node_def.op().empty()) {
+    return errors::InvalidArgument("Node '", node_def.name(),
+                                   "' does not specify an operation");
+  }
+  if (opts_.expect_device_spec && node_def.device().empty()) {
+    return errors::InvalidArgument("Node '", node_def.name(),
+                                   "' is missing a device specification");
+  }
+  // Validate control edges at end
+  bool in_control_dependence = false;
+  for (int i = 0; i < node_def.input_size(); ++i) {
+    StringPiece input_name = node_def.input(i);
+    if (!input_name.empty() && str_util::StartsWith(input_name, "^")) {
+      in_control_dependence = true;
+    } else if (in_control_dependence) {
       return errors::InvalidArgument(
           "Node '", node_def.name(),
-          "': Node name contains invalid characters");
+          "': Control dependencies must come after regular dependencies");
     }
+  }
+  return Status::OK();
+}
+
+Status GraphConstructor::ValidateAllNodeDefs() {
+  // Below this many nodes the thread fan-out costs more than it saves.
+  static const int kMinNodesForParallelValidation = 8192;
+  const int num_nodes = node_defs_.size();
+  if (num_nodes < kMinNodesForParallelValidation) {
+    for (int n = 0; n < num_nodes; ++n) {
+      TF_RETURN_IF_ERROR(ValidateNodeDefSyntax(*node_defs_[n]));
+    }
+    return Status::OK();
+  }
+
+  // Per-node validation touches no shared state, so shard it. Shards cover
+  // contiguous ranges and each records its first failure, so returning the
+  // first failed shard's status reports the same node a serial scan would.
+  const int num_shards =
+      std::min(port::NumSchedulableCPUs(), num_nodes / 1024);
+  thread::ThreadPool pool(Env::Default(), "graph_def_validation", num_shards);
+  std::vector<Status> shard_status(num_shards);
+  BlockingCounter counter(num_shards);
+  for (int shard = 0; shard < num_shards; ++shard) {
+    pool.Schedule([this, shard, num_shards, num_nodes, &shard_status,
+                   &counter]() {
+      const int begin = static_cast<int64>(num_nodes) * shard / num_shards;
+      const int end = static_cast<int64>(num_nodes) * (shard + 1) / num_shards;
+      for (int n = begin; n < end; ++n) {
+        Status s = ValidateNodeDefSyntax(*node_defs_[n]);
+        if (!s.ok()) {
+          shard_status[shard] = s;
+          break;
+        }
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  for (const Status& s : shard_status) {
+    TF_RETURN_IF_ERROR(s);
+  }
+  return Status::OK();
+}
+
+Status GraphConstructor::BuildNodeIndex() {
+  TF_RETURN_IF_ERROR(ValidateAllNodeDefs());
+  // Add the node names to gdef_nodes_ and gdef_prefixes_. The maps are not
+  // thread-safe, and insertion order determines which duplicate is reported,
+  // so this pass stays serial.
+  for (int n = 0; n < node_defs_.size(); ++n) {
+    const NodeDef& node_def = *node_defs_[n];
     if (!gdef_nodes_
              .insert(std::make_pair(StringPiece(node_def.name()), NodeInfo(n)))
              .second) {
       return errors::InvalidArgument("Node '", node_def.name(),
                                      "' is not unique");
     }
-    // Validate the operation's type.
-    if (node_def.op().empty()) {
-      return errors::InvalidArgument("Node '", node_def.name(),
-                                     "' does not specify an operation");
-    }
-    if (opts_.expect_device_spec && node_def.device().empty()) {
-      return errors::InvalidArgument("Node '", node_def.name(),
-                                     "' is missing a device specification");
-    }
-    // Validate control edges at end
-    bool in_control_dependence = false;
-    for (int i = 0; i < node_def.input_size(); ++i) {
-      StringPiece input_name = node_def.input(i);
-      if (!input_name.empty() && str_util::StartsWith(input_name, "^")) {
-        in_control_dependence = true;
-      } else if (in_control_dependence) {
-        return errors::InvalidArgument(
-            "Node '", node_def.name(),
-            "': Control dependencies must come after regular dependencies");
-      }
-    }
     // Update gdef_prefixes_.
     AddPrefixes(node_def.name(), &gdef_prefixes_);
   }
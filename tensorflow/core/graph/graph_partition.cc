@@ -41,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/device_name_utils.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/equal_graph_def.h"
 
 namespace tensorflow {
 
@@ -1249,4 +1250,67 @@ Status Partition(const PartitionOptions& opts, Graph* g,
   return Status::OK();
 }
 
+namespace {
+
+// Fills 'delta' with the differences between 'base' and 'updated', matching
+// nodes by name. A node whose definition changed contributes both a removal
+// and an addition, so applying the delta (drop 'removed', append 'added')
+// turns 'base' into a graph equal to 'updated' up to node ordering.
+void DiffPartition(const GraphDef& base, const GraphDef& updated,
+                   PartitionDelta* delta) {
+  std::unordered_map<StringPiece, const NodeDef*, StringPieceHasher>
+      base_nodes;
+  base_nodes.reserve(base.node_size());
+  for (const NodeDef& node : base.node()) {
+    base_nodes[node.name()] = &node;
+  }
+  for (const NodeDef& node : updated.node()) {
+    auto iter = base_nodes.find(node.name());
+    if (iter == base_nodes.end()) {
+      delta->added.push_back(node);
+    } else if (!EqualNodeDef(node, *iter->second, /*diff=*/nullptr)) {
+      delta->removed.push_back(node.name());
+      delta->added.push_back(node);
+    }
+  }
+  std::unordered_set<StringPiece, StringPieceHasher> updated_names;
+  updated_names.reserve(updated.node_size());
+  for (const NodeDef& node : updated.node()) {
+    updated_names.insert(node.name());
+  }
+  // Iterate over the base proto rather than the leftover map entries so
+  // the removal list comes out in a deterministic order.
+  for (const NodeDef& node : base.node()) {
+    if (updated_names.count(node.name()) == 0) {
+      delta->removed.push_back(node.name());
+    }
+  }
+}
+
+}  // namespace
+
+Status PartitionWithDeltas(
+    const PartitionOptions& opts, Graph* input,
+    const std::unordered_map<string, GraphDef>& base_partitions,
+    std::unordered_map<string, GraphDef>* partitions,
+    std::unordered_map<string, PartitionDelta>* deltas) {
+  TF_RETURN_IF_ERROR(Partition(opts, input, partitions));
+  deltas->clear();
+  static const GraphDef* kEmptyGraphDef = new GraphDef;
+  for (const auto& entry : *partitions) {
+    auto base_iter = base_partitions.find(entry.first);
+    const GraphDef& base = (base_iter == base_partitions.end())
+                               ? *kEmptyGraphDef
+                               : base_iter->second;
+    DiffPartition(base, entry.second, &(*deltas)[entry.first]);
+  }
+  // Locations that are no longer produced have all their nodes removed.
+  for (const auto& entry : base_partitions) {
+    if (partitions->count(entry.first) == 0) {
+      DiffPartition(entry.second, *kEmptyGraphDef, &(*deltas)[entry.first]);
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace tensorflow
@@ -87,6 +87,36 @@ struct PartitionOptions {
 Status Partition(const PartitionOptions& opts, Graph* input,
                  std::unordered_map<string, GraphDef>* partitions);
 
+// Describes how one partition differs from its counterpart in a base
+// partitioning. Nodes are matched by name: 'removed' lists names that are
+// gone or whose definition changed, 'added' holds definitions that are new
+// or changed. Applying a delta means dropping 'removed' and then appending
+// 'added'; a partition with an empty delta is unchanged and its previous
+// registration can be reused as is.
+struct PartitionDelta {
+  std::vector<NodeDef> added;
+  std::vector<string> removed;
+
+  bool unchanged() const { return added.empty() && removed.empty(); }
+};
+
+// Partitions 'input' exactly like Partition() above, and additionally diffs
+// each resulting partition against 'base_partitions' (the result of an
+// earlier partitioning of the graph), filling 'deltas' keyed by location.
+// A location missing from 'base_partitions' yields an all-added delta; a
+// location no longer produced yields an all-removed one. This lets callers
+// that update a few nodes at a time re-register only the partitions whose
+// delta is non-empty instead of rebuilding every partition.
+//
+// Deltas are only minimal if opts.new_name produces the same names for the
+// same send/recv pairs on every run; with a counter-based new_name (e.g.
+// Graph::NewName) the regenerated helper nodes compare as changed.
+Status PartitionWithDeltas(
+    const PartitionOptions& opts, Graph* input,
+    const std::unordered_map<string, GraphDef>& base_partitions,
+    std::unordered_map<string, GraphDef>* partitions,
+    std::unordered_map<string, PartitionDelta>* deltas);
+
 // Add control edges to the partitions to control the ordering
 // and timing of the recv nodes based on the start times calculated
 // using some scheduling algorithm.
@@ -107,6 +107,33 @@ void Partition(const GraphDef& graph_def,
   }
 }
 
+void PartitionWithDeltas(
+    const GraphDef& graph_def,
+    const std::unordered_map<string, GraphDef>& base_partitions,
+    std::unordered_map<string, GraphDef>* partitions,
+    std::unordered_map<string, PartitionDelta>* deltas) {
+  Graph g(OpRegistry::Global());
+  GraphConstructorOptions opts;
+  TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &g));
+
+  for (Node* node : g.nodes()) {
+    string device_name = !node->requested_device().empty()
+                             ? node->requested_device()
+                             : DeviceName(node);
+    node->set_assigned_device_name(device_name);
+  }
+
+  PartitionOptions popts;
+  popts.node_to_loc = SplitByDevice;
+  popts.new_name = [&g](const string& prefix) { return g.NewName(prefix); };
+  popts.get_incarnation = [](const string& name) {
+    return (name[0] - 'A') + 100;
+  };
+  Status s = PartitionWithDeltas(popts, &g, base_partitions, partitions,
+                                 deltas);
+  CHECK(s.ok()) << s;
+}
+
 void CheckLoopConstruction(const GraphDef& graph_def) {
   std::unordered_map<string, GraphDef> partitions;
   Partition(graph_def, &partitions);
@@ -431,6 +458,36 @@ TEST_F(GraphPartitionTest, CrossDeviceLoopFull) {
   CheckLoopConstruction(ToGraphDef());
 }
 
+TEST_F(GraphPartitionTest, PartitionDeltas) {
+  auto a1 = FloatInput(in_.WithOpName("A1"));
+  auto b1 = FloatInput(in_.WithOpName("B1"));
+  Combine(in_.WithOpName("B2"), a1, b1);
+
+  std::unordered_map<string, GraphDef> base;
+  Partition(ToGraphDef(), &base);
+  EXPECT_EQ(2, base.size());
+
+  // Repartitioning the unmodified graph produces empty deltas for both
+  // partitions. (Each helper call partitions a freshly converted graph, so
+  // the counter-based name generator yields the same send/recv names.)
+  std::unordered_map<string, PartitionDelta> deltas;
+  PartitionWithDeltas(in_graph_def_, base, &partitions_, &deltas);
+  EXPECT_EQ(2, deltas.size());
+  for (const auto& it : deltas) {
+    EXPECT_TRUE(it.second.unchanged()) << it.first;
+  }
+
+  // Append one node on partition B; only B's delta reports a change.
+  Combine(in_.WithOpName("B3"), b1, b1);
+  PartitionWithDeltas(ToGraphDef(), base, &partitions_, &deltas);
+  string a = "/job:a/replica:0/task:0/cpu:0";
+  string b = "/job:a/replica:0/task:0/cpu:1";
+  EXPECT_TRUE(deltas[a].unchanged());
+  ASSERT_EQ(1, deltas[b].added.size());
+  EXPECT_EQ("B3", deltas[b].added[0].name());
+  EXPECT_TRUE(deltas[b].removed.empty());
+}
+
 TEST_F(GraphPartitionTest, PartitionIncompleteGraph) {
   NodeDef ndef;
   Graph g(OpRegistry::Global());
@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/benchmark_testlib.h"
 #include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/graph/node_builder.h"
@@ -370,6 +371,28 @@ TEST_F(GraphTest, AddAttr) {
   EXPECT_NE(Status::OK(), GetNodeAttr(n2->attrs(), "_b", &attr));
 }
 
+TEST_F(GraphTest, InternedNodeProperties) {
+  Node* a = FromNodeDef("A", "OneOutput", 0);
+
+  // An identical NodeDef added to another graph shares the same interned
+  // properties, so the NodeDefs are the same object.
+  Graph other(OpRegistry::Global());
+  NodeDef node_def;
+  TF_CHECK_OK(NodeDefBuilder("A", "OneOutput").Finalize(&node_def));
+  Status s;
+  Node* a2 = other.AddNode(node_def, &s);
+  TF_CHECK_OK(s);
+  EXPECT_EQ(&a->def(), &a2->def());
+
+  // Mutating one node copies its properties and leaves the other untouched.
+  a2->AddAttr("_x", "modified");
+  EXPECT_NE(&a->def(), &a2->def());
+  string attr;
+  EXPECT_NE(Status::OK(), GetNodeAttr(a->attrs(), "_x", &attr));
+  EXPECT_EQ(Status::OK(), GetNodeAttr(a2->attrs(), "_x", &attr));
+  EXPECT_EQ("modified", attr);
+}
+
 // Convert edge iteration results into a sorted string.
 static string EdgeIter(const Graph& g) {
   std::vector<std::pair<int, int> > edges;
@@ -660,6 +683,46 @@ TEST_F(GraphTest, BuildNodeNameIndex) {
   }
 }
 
+TEST_F(GraphTest, StructureVersion) {
+  const int64 v0 = graph_.structure_version();
+  Node* a = FromNodeDef("A", "OneOutput", 0);
+  EXPECT_GT(graph_.structure_version(), v0);
+
+  Node* b = FromNodeDef("B", "OneInput", 1);
+  const int64 v1 = graph_.structure_version();
+  const Edge* e = graph_.AddEdge(a, 0, b, 0);
+  EXPECT_GT(graph_.structure_version(), v1);
+
+  const int64 v2 = graph_.structure_version();
+  graph_.RemoveEdge(e);
+  EXPECT_GT(graph_.structure_version(), v2);
+
+  const int64 v3 = graph_.structure_version();
+  graph_.RemoveNode(b);
+  EXPECT_GT(graph_.structure_version(), v3);
+}
+
+TEST_F(GraphTest, GetCachedReversePostOrder) {
+  Node* a = FromNodeDef("A", "OneOutput", 0);
+  Node* b = FromNodeDef("B", "OneInputTwoOutputs", 1);
+  graph_.AddEdge(a, 0, b, 0);
+
+  std::vector<Node*> expected;
+  GetReversePostOrder(graph_, &expected);
+  const std::vector<Node*>& cached = graph_.GetCachedReversePostOrder();
+  EXPECT_EQ(cached, expected);
+
+  // No mutation: repeated calls return the same cached vector.
+  EXPECT_EQ(&graph_.GetCachedReversePostOrder(), &cached);
+  EXPECT_EQ(graph_.GetCachedReversePostOrder(), expected);
+
+  // A structural mutation invalidates the cached ordering.
+  Node* c = FromNodeDef("C", "OneInput", 1);
+  graph_.AddEdge(b, 0, c, 0);
+  GetReversePostOrder(graph_, &expected);
+  EXPECT_EQ(graph_.GetCachedReversePostOrder(), expected);
+}
+
 static void BM_InEdgeIteration(int iters, int num_nodes,
                                int num_edges_per_node) {
   testing::StopTiming();
@@ -18,9 +18,9 @@ limitations under the License.
 // (i.e. inputs before their downstream dependencies).  The rough algorithm is
 // as follows:
 //
-// std::unordered_map<size_t, Node*> available
+// std::unordered_map<uint64, Node*> available
 // for each node n in forward topological order:
-//   h = NodeHash(n)
+//   h = SubgraphFingerprint(n)
 //   if available[h] exists and Equivalent(available(h), h)
 //     redirect downstream uses of outputs of n to available[h]
 //     remove n from graph
@@ -45,24 +45,24 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/subgraph_fingerprint.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
-#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace tensorflow {
 
 class OptimizerCSE {
  public:
-  explicit OptimizerCSE(Graph* g) : g_(g) {}
+  explicit OptimizerCSE(Graph* g) : g_(g), fingerprinter_(g) {}
 
   bool Optimize(const std::function<bool(const Node*)>& consider_fn);
 
  private:
-  static size_t NodeHash(const Node* n);
   static bool Equivalent(const Node* a, const Node* b,
                          AttrSlice::Scratch* scratch);
 
   Graph* g_;
+  SubgraphFingerprinter fingerprinter_;
 };
 
 static void FillInputs(const Node* n,
@@ -86,42 +86,6 @@ static void FillInputs(const Node* n,
   }
 }
 
-static size_t kIllegalNodeHash = 0;
-
-size_t OptimizerCSE::NodeHash(const Node* n) {
-  const DataTypeVector& out = n->output_types();
-  string str_to_hash = strings::StrCat(n->type_string(), out.size());
-  for (DataType dt : out) {
-    strings::StrAppend(&str_to_hash, dt);
-  }
-
-  const int N_in = n->num_inputs();
-  strings::StrAppend(&str_to_hash, N_in);
-  gtl::InlinedVector<const Node*, 4> control_edges;
-  gtl::InlinedVector<std::pair<const Node*, int>, 4> in(N_in);
-  FillInputs(n, &control_edges, &in);
-  for (const auto& edge : in) {
-    strings::StrAppend(&str_to_hash, edge.first->id(), edge.second);
-  }
-
-  size_t h = Hash64(str_to_hash);
-
-#if !defined(__ANDROID__)
-  // Hash the attrs.  For example, this makes sure different constants
-  // end up in different hash buckets.
-  string tmp;
-  for (const auto& attr : n->attrs()) {
-    tmp = attr.first;
-    attr.second.AppendToString(&tmp);
-    // Add hashes of attrs, so the order of attrs doesn't matter.
-    h += Hash32(tmp.data(), tmp.size(), 0x87341245);
-  }
-#endif
-
-  if (h == kIllegalNodeHash) h = kIllegalNodeHash + 1;
-  return h;
-}
-
 static bool HasRefInput(const Node* n) {
   for (auto dt : n->input_types()) {
     if (IsRefType(dt)) return true;
@@ -172,15 +136,25 @@ bool OptimizerCSE::Optimize(
   // with more general control flow will also solve this issue, and for
   // now, our updates are almost always the most downstream nodes in
   // the graph.
-  std::vector<Node*> order;
-  GetReversePostOrder(*g_, &order);
+  // Copied so the rewrites below don't invalidate the iteration order.
+  std::vector<Node*> order(g_->GetCachedReversePostOrder());
+
+  // Snapshot subgraph fingerprints before rewriting anything: two nodes
+  // that should merge root structurally identical subgraphs in the
+  // original graph and therefore already fingerprint equal, and each
+  // rewrite below only redirects consumers to a node with the same
+  // fingerprint as the one removed.
+  std::vector<uint64> hash_of(g_->num_node_ids(), 0);
+  for (Node* n : order) {
+    if (n->IsOp()) hash_of[n->id()] = fingerprinter_.Fingerprint(n);
+  }
 
   // Our value is just a single Node*, meaning we keep just a single
   // candidate for a given node hash value.  This may cause us to
   // (rarely) lose some optimization opportunities if there are
   // hash collisions, but it allows us to avoid having the value
   // be a set<Node*> (or equivalent).
-  std::unordered_map<size_t, Node*> available;
+  std::unordered_map<uint64, Node*> available;
 
   // Scratch space for Equivalent calls.  Allocated here and passed in to
   // Equivalent to avoid allocation inside the loop below.
@@ -199,7 +173,7 @@ bool OptimizerCSE::Optimize(
     // See if we should consider this node at all
     if (consider_fn != nullptr && !consider_fn(n)) continue;
 
-    size_t h = NodeHash(n);
+    const uint64 h = hash_of[n->id()];
     Node** candidate = &available[h];
     if (*candidate == nullptr) {
       // No existing match: insert "n" into the hash table under "h"
@@ -0,0 +1,139 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/graph/subgraph_fingerprint.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Fingerprint value reserved for node ids that have not been computed.
+const uint64 kUnset = 0;
+
+bool HasRefInput(const Node* n) {
+  for (auto dt : n->input_types()) {
+    if (IsRefType(dt)) return true;
+  }
+  return false;
+}
+
+// Returns true if the value "n" produces is fed from outside the graph, so
+// equal structure does not imply equal value.
+bool IsExternallyFed(const Node* n) {
+  return n->IsArg() || n->type_string() == "Placeholder" ||
+         n->type_string() == "PlaceholderV2" ||
+         n->type_string() == "PlaceholderWithDefault";
+}
+
+}  // namespace
+
+uint64 SubgraphFingerprinter::InputFingerprint(const Node* src) const {
+  // Inputs reached through a back edge of a control-flow loop (or from a
+  // node the source-rooted traversal cannot reach) have no fingerprint
+  // yet; identify them by node id, which is deterministic for a given
+  // graph.
+  const uint64 fp = fingerprints_[src->id()];
+  return fp != kUnset ? fp : FingerprintCat64(kUnset, src->id());
+}
+
+void SubgraphFingerprinter::Recompute() {
+  fingerprints_.assign(g_->num_node_ids(), kUnset);
+
+  // Reverse post-order visits inputs before their consumers (except across
+  // back edges), so each node's fingerprint is built from already-computed
+  // input fingerprints. The second loop covers nodes the source-rooted
+  // traversal missed.
+  std::vector<Node*> pending;
+  pending.reserve(g_->num_nodes());
+  for (Node* n : g_->GetCachedReversePostOrder()) pending.push_back(n);
+  for (Node* n : g_->nodes()) {
+    if (fingerprints_[n->id()] == kUnset) pending.push_back(n);
+  }
+
+  string tmp;
+  for (const Node* n : pending) {
+    if (fingerprints_[n->id()] != kUnset) continue;
+
+    uint64 fp = Fingerprint64(n->type_string());
+    for (DataType dt : n->output_types()) {
+      fp = FingerprintCat64(fp, dt);
+    }
+
+    // Sum the per-attr fingerprints so the order of attrs doesn't matter.
+    uint64 attr_fp = 0;
+    for (const auto& attr : n->attrs()) {
+      tmp = attr.first;
+      attr.second.AppendToString(&tmp);
+      attr_fp += Fingerprint64(tmp);
+    }
+    fp = FingerprintCat64(fp, attr_fp);
+
+    const int N_in = n->num_inputs();
+    gtl::InlinedVector<std::pair<uint64, int>, 4> in(
+        N_in, std::make_pair(kUnset, 0));
+    gtl::InlinedVector<uint64, 4> control_in;
+    for (const Edge* e : n->in_edges()) {
+      if (e->IsControlEdge()) {
+        control_in.push_back(InputFingerprint(e->src()));
+      } else {
+        in[e->dst_input()] = {InputFingerprint(e->src()), e->src_output()};
+      }
+    }
+    std::sort(control_in.begin(), control_in.end());
+    if (n->op_def().is_commutative()) {
+      // Canonicalize commutative inputs so that add(a, b) and add(b, a)
+      // fingerprint equal.
+      std::sort(in.begin(), in.end());
+    }
+    fp = FingerprintCat64(fp, N_in);
+    for (const auto& input : in) {
+      fp = FingerprintCat64(fp, input.first);
+      fp = FingerprintCat64(fp, input.second);
+    }
+    for (uint64 control_fp : control_in) {
+      fp = FingerprintCat64(fp, control_fp);
+    }
+
+    // The value of a stateful op, an op reading a ref input, or an
+    // externally fed op depends on more than the structure feeding it;
+    // never let two such nodes compare as equivalent.
+    if (n->op_def().is_stateful() || HasRefInput(n) || IsExternallyFed(n)) {
+      fp = FingerprintCat64(fp, n->id());
+    }
+
+    if (fp == kUnset) fp = kUnset + 1;
+    fingerprints_[n->id()] = fp;
+  }
+}
+
+uint64 SubgraphFingerprinter::Fingerprint(const Node* n) {
+  if (version_ != g_->structure_version()) {
+    Recompute();
+    version_ = g_->structure_version();
+  }
+  DCHECK_LT(n->id(), static_cast<int>(fingerprints_.size()));
+  return fingerprints_[n->id()];
+}
+
+}  // namespace tensorflow
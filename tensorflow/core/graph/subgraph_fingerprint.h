@@ -0,0 +1,75 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPH_SUBGRAPH_FINGERPRINT_H_
+#define TENSORFLOW_CORE_GRAPH_SUBGRAPH_FINGERPRINT_H_
+
+#include <vector>
+
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Computes structural fingerprints for the subgraph feeding each node.
+//
+// A node's fingerprint combines its op, attrs and output types with the
+// fingerprints of its inputs (data inputs in input-slot order, tagged with
+// the producer's output slot; control inputs as a sorted multiset;
+// commutative data inputs in a canonical order), so two nodes fingerprint
+// equal only if the computations feeding them are structurally identical.
+// Stateful ops, ops with ref inputs and externally fed ops (placeholders,
+// function arguments) are uniquified by node id, since their values depend
+// on more than graph structure. Inputs reached through
+// a control-flow back edge are identified by node id as well, so cyclic
+// regions fingerprint deterministically for a given graph but do not
+// compare as equivalent across graphs.
+//
+// Fingerprints are computed bottom-up for the whole graph in one pass and
+// memoized against Graph::structure_version(), so lookups against an
+// unchanged graph are O(1) per node. Equality is probabilistic in the
+// usual fingerprinting sense: distinct subgraphs may collide, so callers
+// that rewrite the graph based on a match must verify it structurally.
+class SubgraphFingerprinter {
+ public:
+  explicit SubgraphFingerprinter(const Graph* g) : g_(g) {}
+
+  // Returns the fingerprint of the subgraph rooted at "n", recomputing the
+  // per-node cache first if the graph has changed since the last call.
+  // "n" must belong to the graph passed to the constructor.
+  uint64 Fingerprint(const Node* n);
+
+ private:
+  // Recomputes fingerprints_ for every node in the graph.
+  void Recompute();
+
+  // Returns the fingerprint to use for an input produced by "src" while
+  // computing fingerprints in reverse post-order.
+  uint64 InputFingerprint(const Node* src) const;
+
+  const Graph* g_;  // Not owned.
+
+  // Graph::structure_version() at the time fingerprints_ was filled, or -1
+  // if it has never been filled.
+  int64 version_ = -1;
+
+  // Fingerprints indexed by node id; kUnset for ids that have not been
+  // computed (removed nodes, or nodes downstream of a traversal front).
+  std::vector<uint64> fingerprints_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPH_SUBGRAPH_FINGERPRINT_H_
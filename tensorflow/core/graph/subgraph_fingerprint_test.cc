@@ -0,0 +1,142 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/graph/subgraph_fingerprint.h"
+
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/graph_constructor.h"
+#include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+REGISTER_OP("FingerprintInput").Output("o: float").SetIsStateful();
+
+class SubgraphFingerprintTest : public ::testing::Test {
+ protected:
+  SubgraphFingerprintTest() : graph_(OpRegistry::Global()) {}
+
+  void InitGraph(const string& s) {
+    GraphDef graph_def;
+    auto parser = protobuf::TextFormat::Parser();
+    CHECK(parser.MergeFromString(s, &graph_def)) << s;
+    GraphConstructorOptions opts;
+    TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &graph_));
+  }
+
+  Node* FindNode(const string& name) {
+    for (Node* n : graph_.nodes()) {
+      if (n->name() == name) return n;
+    }
+    LOG(FATAL) << "Node not found: " << name;
+    return nullptr;
+  }
+
+  Graph graph_;
+};
+
+TEST_F(SubgraphFingerprintTest, EquivalentSubgraphs) {
+  InitGraph(
+      "node { name: 'A' op: 'FingerprintInput'}"
+      "node { name: 'B' op: 'FingerprintInput'}"
+      "node { name: 'C' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['A', 'B'] }"
+      "node { name: 'D' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['A', 'B'] }"
+      "node { name: 'E' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['A', 'A'] }"
+      // F and G consume distinct but equivalent producers; bottom-up
+      // hashing must make them fingerprint equal anyway.
+      "node { name: 'F' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['C', 'C'] }"
+      "node { name: 'G' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['D', 'D'] }");
+  SubgraphFingerprinter fingerprinter(&graph_);
+  EXPECT_EQ(fingerprinter.Fingerprint(FindNode("C")),
+            fingerprinter.Fingerprint(FindNode("D")));
+  EXPECT_NE(fingerprinter.Fingerprint(FindNode("C")),
+            fingerprinter.Fingerprint(FindNode("E")));
+  EXPECT_EQ(fingerprinter.Fingerprint(FindNode("F")),
+            fingerprinter.Fingerprint(FindNode("G")));
+}
+
+TEST_F(SubgraphFingerprintTest, CommutativeInputsCanonicalized) {
+  InitGraph(
+      "node { name: 'A' op: 'FingerprintInput'}"
+      "node { name: 'B' op: 'FingerprintInput'}"
+      "node { name: 'C' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['A', 'B'] }"
+      "node { name: 'D' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['B', 'A'] }"
+      "node { name: 'E' op: 'Sub' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['A', 'B'] }"
+      "node { name: 'F' op: 'Sub' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['B', 'A'] }");
+  SubgraphFingerprinter fingerprinter(&graph_);
+  EXPECT_EQ(fingerprinter.Fingerprint(FindNode("C")),
+            fingerprinter.Fingerprint(FindNode("D")));
+  EXPECT_NE(fingerprinter.Fingerprint(FindNode("E")),
+            fingerprinter.Fingerprint(FindNode("F")));
+}
+
+TEST_F(SubgraphFingerprintTest, StatefulAndExternallyFedUniquified) {
+  InitGraph(
+      "node { name: 'A' op: 'FingerprintInput'}"
+      "node { name: 'B' op: 'FingerprintInput'}"
+      "node { name: 'P1' op: 'Placeholder'"
+      " attr { key: 'dtype' value { type: DT_FLOAT } } }"
+      "node { name: 'P2' op: 'Placeholder'"
+      " attr { key: 'dtype' value { type: DT_FLOAT } } }");
+  SubgraphFingerprinter fingerprinter(&graph_);
+  EXPECT_NE(fingerprinter.Fingerprint(FindNode("A")),
+            fingerprinter.Fingerprint(FindNode("B")));
+  EXPECT_NE(fingerprinter.Fingerprint(FindNode("P1")),
+            fingerprinter.Fingerprint(FindNode("P2")));
+}
+
+TEST_F(SubgraphFingerprintTest, InvalidatedByMutation) {
+  InitGraph(
+      "node { name: 'A' op: 'FingerprintInput'}"
+      "node { name: 'B' op: 'FingerprintInput'}"
+      "node { name: 'C' op: 'Mul' attr { key: 'T' value { type: DT_FLOAT } }"
+      " input: ['A', 'B'] }");
+  SubgraphFingerprinter fingerprinter(&graph_);
+  Node* c = FindNode("C");
+  const uint64 fp_before = fingerprinter.Fingerprint(c);
+  EXPECT_EQ(fingerprinter.Fingerprint(c), fp_before);
+
+  // A mutation that doesn't touch C's subgraph triggers a recompute but
+  // leaves C's fingerprint unchanged.
+  NodeDef ndef;
+  ndef.set_name("X");
+  ndef.set_op("FingerprintInput");
+  Status s;
+  Node* x = graph_.AddNode(ndef, &s);
+  TF_ASSERT_OK(s);
+  EXPECT_EQ(fingerprinter.Fingerprint(c), fp_before);
+
+  // Feeding C a new control input changes its subgraph.
+  graph_.AddControlEdge(x, c);
+  EXPECT_NE(fingerprinter.Fingerprint(c), fp_before);
+}
+
+}  // namespace
+}  // namespace tensorflow
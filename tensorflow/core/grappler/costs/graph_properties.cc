@@ -550,7 +550,7 @@ class SymbolicShapeRefiner {
       const GraphView& graph,
       const std::unordered_map<string, std::unordered_set<int>>& fed_ports,
       const bool aggressive_shape_inference)
-      : graph_(graph),
+      : graph_(&graph),
         function_library_(OpRegistry::Global(), graph.graph()->library()),
         fed_ports_(fed_ports),
         aggressive_shape_inference_(aggressive_shape_inference) {
@@ -558,7 +558,16 @@ class SymbolicShapeRefiner {
     node_to_context_.reserve(graph.graph()->node_size());
   }
 
-  const GraphView& graph() const { return graph_; }
+  const GraphView& graph() const { return *graph_; }
+
+  // Points the refiner at a rebuilt view of the graph after an edit. The
+  // cached node contexts are retained, so only nodes whose inputs actually
+  // changed will be re-inferred.
+  void ResetGraphView(const GraphView& graph) { graph_ = &graph; }
+
+  // Discard everything inferred about the node so that its shape function is
+  // re-run from scratch on the next update.
+  void ForgetNode(const NodeDef* node) { node_to_context_.erase(node); }
 
   struct NodeContext {
     const OpRegistrationData* op_data;
@@ -636,7 +645,7 @@ class SymbolicShapeRefiner {
             "Function inputs should not contain control nodes.");
       }
 
-      const NodeDef* input_node = graph_.GetNode(input_tensor.node());
+      const NodeDef* input_node = graph_->GetNode(input_tensor.node());
       if (input_node == nullptr) {
         return errors::FailedPrecondition(input_tensor.node(),
                                           " was not found in the graph.");
@@ -677,7 +686,7 @@ class SymbolicShapeRefiner {
     for (int i = grappler_function_item.inputs().size() - 1; i >= 0; --i) {
       const string& input = function_node->input(i);
       const string& node_name = NodeName(input);
-      const NodeDef* input_node = graph_.GetNode(node_name);
+      const NodeDef* input_node = graph_->GetNode(node_name);
       if (IsConstant(*input_node)) {
         TF_CHECK_OK(
             ReplaceInputWithConst(*input_node, i, &grappler_function_item));
@@ -779,7 +788,7 @@ class SymbolicShapeRefiner {
 
     for (int dst_input = 0; dst_input < ic->num_inputs(); ++dst_input) {
       const GraphView::InputPort port(node, dst_input);
-      const GraphView::OutputPort fanin = graph_.GetRegularFanin(port);
+      const GraphView::OutputPort fanin = graph_->GetRegularFanin(port);
       int src_output = fanin.port_id;
       const NodeDef* src = fanin.node;
       NodeContext* src_ctx = GetNodeContext(src);
@@ -1714,7 +1723,7 @@ class SymbolicShapeRefiner {
     return false;
   }
 
-  const GraphView& graph_;
+  const GraphView* graph_;
   int graph_def_version_;
   std::unordered_map<const NodeDef*, NodeContext> node_to_context_;
   std::unordered_map<ShapeId, ShapeHandle, HashShapeId> unknown_shapes_;
@@ -2065,31 +2074,24 @@ Status GraphProperties::UpdateEnqueue(
   return Status::OK();
 }
 
-Status GraphProperties::InferStatically(bool assume_valid_feeds,
-                                        bool aggressive_shape_inference) {
-  FunctionLibraryDefinition function_library(OpRegistry::Global(),
-                                             item_.graph.library());
-  std::unordered_map<string, std::unordered_set<int>> fed_ports;
-  if (!assume_valid_feeds) {
-    for (const auto& feed : item_.feed) {
-      SafeTensorId tensor_id = ParseTensorName(feed.first);
-      fed_ports[tensor_id.node()].insert(tensor_id.index());
-    }
-  }
-
-  GraphView graph_view(&item_.graph);
-
-  // List the resources and the nodes using them. Also collect the Merge nodes,
-  // fed nodes, and primary inputs.
+// Out of line because the header only forward declares the types owned by
+// the retained inference state.
+GraphProperties::~GraphProperties() {}
+
+// Lists the resource constructs that constrain the propagation of shapes:
+// which node holds the handle of the queue each Enqueue op feeds, the extra
+// enqueue->dequeue dependencies needed to process queues in their logical
+// order, and the number of loops in the graph.
+static void CollectResourceConstraints(
+    const GraphDef& graph, const GraphView& graph_view,
+    std::unordered_map<const NodeDef*, const NodeDef*>* resource_handles,
+    std::vector<TopologicalDependency>* extra_deps, int* num_loops) {
   std::unordered_map<const NodeDef*,
                      std::pair<std::unordered_set<const NodeDef*>,
                                std::unordered_set<const NodeDef*>>>
       resources;
-  std::unordered_set<const NodeDef*> merge_nodes;
-  std::unordered_set<const NodeDef*> fed_nodes;
-  std::unordered_set<const NodeDef*> primary_inputs;
-  int num_loops = 0;
-  for (const NodeDef& node : item_.graph.node()) {
+  *num_loops = 0;
+  for (const NodeDef& node : graph.node()) {
     if (IsQueue(node)) {
       for (const GraphView::InputPort& fanout :
            graph_view.GetFanouts(node, false)) {
@@ -2111,31 +2113,54 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
           }
         }
       }
-    }
-    if (NumNonControlInputs(node) == 0) {
-      primary_inputs.insert(&node);
-    } else if (IsMerge(node)) {
-      merge_nodes.insert(&node);
     } else if (IsNextIteration(node)) {
-      ++num_loops;
-    }
-    if (fed_ports.find(node.name()) != fed_ports.end()) {
-      fed_nodes.insert(&node);
+      ++*num_loops;
     }
   }
 
-  std::unordered_map<const NodeDef*, const NodeDef*> resource_handles;
-  std::vector<TopologicalDependency> extra_deps;
   for (const auto& resource : resources) {
     for (const NodeDef* src : resource.second.first) {
-      resource_handles[src] = resource.first;
+      (*resource_handles)[src] = resource.first;
       for (const NodeDef* dst : resource.second.second) {
         // Add control edges from enqueue to dequeue nodes to ensure they are
         // processed in their logical order.
-        extra_deps.emplace_back(src, dst);
+        extra_deps->emplace_back(src, dst);
       }
     }
   }
+}
+
+Status GraphProperties::InferStatically(bool assume_valid_feeds,
+                                        bool aggressive_shape_inference) {
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item_.graph.library());
+  fed_ports_.clear();
+  if (!assume_valid_feeds) {
+    for (const auto& feed : item_.feed) {
+      SafeTensorId tensor_id = ParseTensorName(feed.first);
+      fed_ports_[tensor_id.node()].insert(tensor_id.index());
+    }
+  }
+
+  graph_view_ = absl::make_unique<GraphView>(&item_.graph);
+
+  // Collect the fed nodes and primary inputs.
+  std::unordered_set<const NodeDef*> fed_nodes;
+  std::unordered_set<const NodeDef*> primary_inputs;
+  for (const NodeDef& node : item_.graph.node()) {
+    if (NumNonControlInputs(node) == 0) {
+      primary_inputs.insert(&node);
+    }
+    if (fed_ports_.find(node.name()) != fed_ports_.end()) {
+      fed_nodes.insert(&node);
+    }
+  }
+
+  std::unordered_map<const NodeDef*, const NodeDef*> resource_handles;
+  std::vector<TopologicalDependency> extra_deps;
+  int num_loops = 0;
+  CollectResourceConstraints(item_.graph, *graph_view_, &resource_handles,
+                             &extra_deps, &num_loops);
 
   std::vector<const NodeDef*> topo_order;
   Status s = ComputeTopologicalOrder(item_.graph, extra_deps, &topo_order);
@@ -2151,8 +2176,8 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
     }
   }
 
-  SymbolicShapeRefiner refiner(graph_view, fed_ports,
-                               aggressive_shape_inference);
+  shape_refiner_ = absl::make_unique<SymbolicShapeRefiner>(
+      *graph_view_, fed_ports_, aggressive_shape_inference);
 
   TopoQueue new_shapes(topo_order);
   // Also seed the propagation of shapes in the fanout of primary inputs.
@@ -2164,20 +2189,74 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
     new_shapes.push(node);
   }
   // Propagate shapes normally.
-  TF_RETURN_IF_ERROR(
-      PropagateShapes(&refiner, &new_shapes, resource_handles, num_loops));
+  TF_RETURN_IF_ERROR(PropagateShapes(shape_refiner_.get(), &new_shapes,
+                                     resource_handles, num_loops));
+
+  input_properties_.clear();
+  output_properties_.clear();
+  return ExtractProperties(shape_refiner_.get());
+}
+
+Status GraphProperties::UpdateStatically(
+    const std::vector<const NodeDef*>& modified_nodes) {
+  if (shape_refiner_ == nullptr) {
+    return errors::FailedPrecondition(
+        "InferStatically must be run before UpdateStatically");
+  }
+  if (modified_nodes.empty()) {
+    return Status::OK();
+  }
+
+  // The edits may have rewired edges, so refresh the view the refiner
+  // propagates through. The contexts cached for unmodified nodes stay valid
+  // since they are keyed by node pointers.
+  graph_view_ = absl::make_unique<GraphView>(&item_.graph);
+  shape_refiner_->ResetGraphView(*graph_view_);
+
+  std::unordered_map<const NodeDef*, const NodeDef*> resource_handles;
+  std::vector<TopologicalDependency> extra_deps;
+  int num_loops = 0;
+  CollectResourceConstraints(item_.graph, *graph_view_, &resource_handles,
+                             &extra_deps, &num_loops);
+
+  std::vector<const NodeDef*> topo_order;
+  Status s = ComputeTopologicalOrder(item_.graph, extra_deps, &topo_order);
+  if (!s.ok()) {
+    if (extra_deps.empty()) {
+      return s;
+    } else {
+      TF_RETURN_IF_ERROR(ComputeTopologicalOrder(item_.graph, &topo_order));
+    }
+  }
+
+  // Re-seed the propagation with the modified nodes only: shapes will be
+  // re-inferred in their transitive fanout, and PropagateShapes stops
+  // expanding the frontier as soon as the re-inferred shapes stop changing.
+  TopoQueue new_shapes(topo_order);
+  for (const NodeDef* node : modified_nodes) {
+    shape_refiner_->ForgetNode(node);
+    new_shapes.push(node);
+  }
+  TF_RETURN_IF_ERROR(PropagateShapes(shape_refiner_.get(), &new_shapes,
+                                     resource_handles, num_loops));
+
+  input_properties_.clear();
+  output_properties_.clear();
+  return ExtractProperties(shape_refiner_.get());
+}
 
+Status GraphProperties::ExtractProperties(SymbolicShapeRefiner* refiner) {
   // Track shapes globally across the graph.
   std::unique_ptr<SymbolicShapeManager> shape_manager =
       absl::make_unique<SymbolicShapeManager>();
   bool found_error = false;
   for (const NodeDef& node : item_.graph.node()) {
-    auto node_ctx = refiner.GetContext(&node);
+    auto node_ctx = refiner->GetContext(&node);
     if (!node_ctx) {
       continue;
     }
     // Skip any information that comes from fed nodes.
-    if (fed_ports.find(node.name()) != fed_ports.end()) {
+    if (fed_ports_.find(node.name()) != fed_ports_.end()) {
       VLOG(2) << "Skipping feed node shape: " << node.name();
       continue;
     }
@@ -2204,7 +2283,7 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
 
   for (const NodeDef& node : item_.graph.node()) {
     VLOG(3) << "Filling in graph properties for node: " << node.name();
-    auto ctx = refiner.GetNodeContext(&node);
+    auto ctx = refiner->GetNodeContext(&node);
     if (!ctx) {
       continue;
     }
@@ -2224,7 +2303,7 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
         shape_manager->AsTensorProperties(ic->input(i), ctx->input_types[i],
                                           &input_properties[i]);
         input.port_id = i;
-        GraphView::OutputPort fanin = graph_view.GetRegularFanin(input);
+        GraphView::OutputPort fanin = graph_view_->GetRegularFanin(input);
         // Export tensor value to input_properties.value.
         if (IsConstant(*fanin.node)) {
           const TensorProto& raw_val = fanin.node->attr().at("value").tensor();
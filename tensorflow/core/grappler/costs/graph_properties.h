@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_GRAPH_PROPERTIES_H_
 #define TENSORFLOW_CORE_GRAPPLER_COSTS_GRAPH_PROPERTIES_H_
 
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
@@ -66,6 +68,7 @@ ABSL_CONST_INIT const char kOutputTypes[] = "_output_dtype_vector";
 // Outputs TensorShapeProto vector.
 ABSL_CONST_INIT const char kOutputShapes[] = "_output_shape_vector";
 
+class GraphView;
 class SymbolicShapeRefiner;
 class TopoQueue;
 
@@ -79,6 +82,7 @@ class GraphProperties {
  public:
   // The item must outlive the properties
   explicit GraphProperties(const GrapplerItem& item) : item_(item) {}
+  ~GraphProperties();
 
   // Infer the shapes through abstract interpretation. Feed information can be
   // incorrect so it should be discarded to ensure correctness of the analysis.
@@ -95,6 +99,17 @@ class GraphProperties {
     return InferStatically(assume_valid_feeds,
                            /*aggressive_shape_inference=*/false);
   }
+  // Incrementally update the inferred properties after a modification of the
+  // graph. InferStatically must have been run on the item first.
+  // `modified_nodes` must contain every node of `item.graph` whose op,
+  // attributes or inputs have changed since the last inference, including
+  // newly added nodes. Shapes are re-propagated only through the transitive
+  // fanout of the modified nodes, and propagation stops as soon as the
+  // re-inferred shapes match the previously known ones. Removing nodes from
+  // the graph still requires a full InferStatically pass since the refiner
+  // caches state keyed by node pointers.
+  Status UpdateStatically(const std::vector<const NodeDef*>& modified_nodes);
+
   // Infer the shape by running the graph on the specified cluster and recording
   // the shapes of the processed tensors.
   Status InferDynamically(Cluster* cluster);
@@ -169,8 +184,18 @@ class GraphProperties {
           resource_handles,
       int num_loops) const;
 
+  // Rebuild input_properties_ and output_properties_ from the current state
+  // of the shape refiner.
+  Status ExtractProperties(SymbolicShapeRefiner* refiner);
+
   // Data members
   const GrapplerItem& item_;
+  // State retained from the last InferStatically call so that
+  // UpdateStatically can resume propagation instead of starting over. The
+  // refiner keeps references to both the fed ports and the graph view.
+  std::unordered_map<string, std::unordered_set<int>> fed_ports_;
+  std::unique_ptr<GraphView> graph_view_;
+  std::unique_ptr<SymbolicShapeRefiner> shape_refiner_;
   std::unordered_map<string, std::vector<OpInfo::TensorProperties>>
       input_properties_;
   std::unordered_map<string, std::vector<OpInfo::TensorProperties>>
@@ -199,6 +199,48 @@ TEST_F(GraphPropertiesTest, ClearProperties) {
   }
 }
 
+TEST_F(GraphPropertiesTest, UpdateStatically) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                              ops::Placeholder::Shape({10, 8}));
+  Output square = ops::Square(s.WithOpName("square"), a);
+  Output id = ops::Identity(s.WithOpName("id"), square);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  // Incremental updates require a full inference pass first.
+  GraphProperties fresh_properties(item);
+  EXPECT_FALSE(fresh_properties.UpdateStatically({}).ok());
+
+  GraphProperties properties(item);
+  TF_CHECK_OK(properties.InferStatically(/*assume_valid_feeds=*/false));
+  EXPECT_EQ("float: [10,8]",
+            PropToString(properties.GetOutputProperties("id")[0]));
+
+  // Change the placeholder shape in place and re-propagate through its
+  // fanout.
+  NodeDef* placeholder = nullptr;
+  for (NodeDef& node : *item.graph.mutable_node()) {
+    if (node.name() == "a") {
+      placeholder = &node;
+    }
+  }
+  ASSERT_NE(nullptr, placeholder);
+  TensorShapeProto new_shape;
+  new_shape.add_dim()->set_size(7);
+  new_shape.add_dim()->set_size(11);
+  (*placeholder->mutable_attr())["shape"].mutable_shape()->Swap(&new_shape);
+
+  TF_CHECK_OK(properties.UpdateStatically({placeholder}));
+  EXPECT_EQ("float: [7,11]",
+            PropToString(properties.GetOutputProperties("a")[0]));
+  EXPECT_EQ("float: [7,11]",
+            PropToString(properties.GetOutputProperties("square")[0]));
+  EXPECT_EQ("float: [7,11]",
+            PropToString(properties.GetOutputProperties("id")[0]));
+}
+
 TEST_F(GraphPropertiesTest, DynamicProperties) {
   TrivialTestGraphInputYielder fake_input(4, 1, 10, false,
                                           cluster_->GetDeviceNames());
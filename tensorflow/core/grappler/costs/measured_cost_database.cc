@@ -0,0 +1,81 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
+
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+namespace grappler {
+
+void MeasuredCostDatabase::AddMeasurements(const OpPerformanceList& perf_list) {
+  for (const OpPerformance& perf : perf_list.op_performance()) {
+    if (perf.compute_cost() <= 0) continue;
+    measurements_[Signature(perf.op())] = perf;
+  }
+}
+
+bool MeasuredCostDatabase::LookupCosts(const OpInfo& op_info,
+                                       Costs* costs) const {
+  auto it = measurements_.find(Signature(op_info));
+  if (it == measurements_.end()) return false;
+
+  const OpPerformance& perf = it->second;
+  *costs = Costs::ZeroCosts();
+  costs->execution_time = Costs::NanoSeconds(perf.compute_cost());
+  costs->compute_time = Costs::NanoSeconds(perf.compute_time());
+  costs->memory_time = Costs::NanoSeconds(perf.memory_time());
+  costs->temporary_memory = perf.temporary_memory_size();
+  costs->persistent_memory = perf.op_memory().persistent_memory();
+  costs->inaccurate = false;
+  return true;
+}
+
+void MeasuredCostDatabase::ToProto(OpPerformanceList* perf_list) const {
+  perf_list->Clear();
+  for (const auto& entry : measurements_) {
+    *perf_list->add_op_performance() = entry.second;
+  }
+}
+
+string MeasuredCostDatabase::Signature(const OpInfo& op_info) {
+  string signature =
+      strings::StrCat(op_info.device().type(), "/", op_info.op());
+  for (const auto& input : op_info.inputs()) {
+    strings::StrAppend(&signature, "/", static_cast<int>(input.dtype()), ":");
+    if (input.shape().unknown_rank()) {
+      strings::StrAppend(&signature, "?");
+    } else {
+      for (const auto& dim : input.shape().dim()) {
+        strings::StrAppend(&signature, dim.size(), ",");
+      }
+    }
+  }
+  return signature;
+}
+
+Costs MeasuredOpLevelCostEstimator::PredictCosts(
+    const OpContext& op_context) const {
+  Costs measured;
+  if (database_ != nullptr &&
+      database_->LookupCosts(op_context.op_info, &measured)) {
+    return measured;
+  }
+  return OpLevelCostEstimator::PredictCosts(op_context);
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
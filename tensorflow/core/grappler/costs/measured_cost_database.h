@@ -0,0 +1,83 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "tensorflow/core/grappler/costs/cost_estimator.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/op_performance_data.pb.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Database of measured per-op execution costs, keyed by device type and op
+// signature (op, input types and shapes).
+//
+// It is typically populated from measurements collected by
+// MeasuringCostEstimator (whose RunMetadata cost graph can be converted to an
+// OpPerformanceList with CostGraphToOpPerformanceData), serialized for reuse
+// across sessions, and consulted by MeasuredOpLevelCostEstimator before
+// falling back to analytical estimates.
+class MeasuredCostDatabase {
+ public:
+  MeasuredCostDatabase() = default;
+
+  // Merges measurements into the database. A measurement with the same op
+  // signature on the same device type overwrites an older one. Entries without
+  // a measured compute cost are ignored.
+  void AddMeasurements(const OpPerformanceList& perf_list);
+
+  // Looks up measured costs for the given op. On a hit returns true and fills
+  // in *costs from the measurement.
+  bool LookupCosts(const OpInfo& op_info, Costs* costs) const;
+
+  // Serializes all measurements, e.g. to persist the calibration data.
+  void ToProto(OpPerformanceList* perf_list) const;
+
+  // Key identifying measurements that are interchangeable with the given op:
+  // same op type running on the same input types and shapes.
+  static string Signature(const OpInfo& op_info);
+
+  std::size_t num_measurements() const { return measurements_.size(); }
+
+ private:
+  // Op signature (device type included) -> most recent measurement.
+  std::unordered_map<string, OpPerformance> measurements_;
+};
+
+// Cost estimator that returns measured costs when the database has a
+// measurement for the op signature, and analytical estimates otherwise.
+// Does not take ownership of the database.
+class MeasuredOpLevelCostEstimator : public OpLevelCostEstimator {
+ public:
+  explicit MeasuredOpLevelCostEstimator(const MeasuredCostDatabase* database)
+      : database_(database) {}
+  ~MeasuredOpLevelCostEstimator() override = default;
+
+  Costs PredictCosts(const OpContext& op_context) const override;
+
+ private:
+  const MeasuredCostDatabase* database_;  // Not owned.
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
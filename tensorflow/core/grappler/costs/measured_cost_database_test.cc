@@ -0,0 +1,124 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+OpInfo DescribeOp(const string& op, const string& device_type, int rows,
+                  int cols) {
+  OpInfo op_info;
+  op_info.set_op(op);
+  op_info.mutable_device()->set_type(device_type);
+  auto* input = op_info.add_inputs();
+  input->set_dtype(DT_FLOAT);
+  auto* shape = input->mutable_shape();
+  shape->add_dim()->set_size(rows);
+  shape->add_dim()->set_size(cols);
+  return op_info;
+}
+
+TEST(MeasuredCostDatabaseTest, AddAndLookup) {
+  OpPerformanceList perf_list;
+  OpPerformance* perf = perf_list.add_op_performance();
+  *perf->mutable_op() = DescribeOp("Mul", "CPU", 10, 20);
+  perf->set_compute_cost(1500);
+  perf->set_compute_time(1000);
+  perf->set_memory_time(500);
+
+  MeasuredCostDatabase database;
+  database.AddMeasurements(perf_list);
+  EXPECT_EQ(database.num_measurements(), 1);
+
+  Costs costs;
+  ASSERT_TRUE(database.LookupCosts(DescribeOp("Mul", "CPU", 10, 20), &costs));
+  EXPECT_EQ(costs.execution_time, Costs::NanoSeconds(1500));
+  EXPECT_EQ(costs.compute_time, Costs::NanoSeconds(1000));
+  EXPECT_EQ(costs.memory_time, Costs::NanoSeconds(500));
+  EXPECT_FALSE(costs.inaccurate);
+
+  // Different shape, device type or op must not match the measurement.
+  EXPECT_FALSE(database.LookupCosts(DescribeOp("Mul", "CPU", 10, 21), &costs));
+  EXPECT_FALSE(database.LookupCosts(DescribeOp("Mul", "GPU", 10, 20), &costs));
+  EXPECT_FALSE(database.LookupCosts(DescribeOp("Add", "CPU", 10, 20), &costs));
+}
+
+TEST(MeasuredCostDatabaseTest, NewerMeasurementWins) {
+  OpPerformanceList perf_list;
+  OpPerformance* perf = perf_list.add_op_performance();
+  *perf->mutable_op() = DescribeOp("Mul", "CPU", 10, 20);
+  perf->set_compute_cost(1500);
+
+  MeasuredCostDatabase database;
+  database.AddMeasurements(perf_list);
+  perf->set_compute_cost(2000);
+  database.AddMeasurements(perf_list);
+  EXPECT_EQ(database.num_measurements(), 1);
+
+  Costs costs;
+  ASSERT_TRUE(database.LookupCosts(DescribeOp("Mul", "CPU", 10, 20), &costs));
+  EXPECT_EQ(costs.execution_time, Costs::NanoSeconds(2000));
+}
+
+TEST(MeasuredCostDatabaseTest, RoundTripsThroughProto) {
+  OpPerformanceList perf_list;
+  OpPerformance* perf = perf_list.add_op_performance();
+  *perf->mutable_op() = DescribeOp("Mul", "CPU", 10, 20);
+  perf->set_compute_cost(1500);
+
+  MeasuredCostDatabase database;
+  database.AddMeasurements(perf_list);
+
+  OpPerformanceList serialized;
+  database.ToProto(&serialized);
+  MeasuredCostDatabase restored;
+  restored.AddMeasurements(serialized);
+
+  Costs costs;
+  ASSERT_TRUE(restored.LookupCosts(DescribeOp("Mul", "CPU", 10, 20), &costs));
+  EXPECT_EQ(costs.execution_time, Costs::NanoSeconds(1500));
+}
+
+TEST(MeasuredOpLevelCostEstimatorTest, FallsBackToAnalyticalEstimate) {
+  OpPerformanceList perf_list;
+  OpPerformance* perf = perf_list.add_op_performance();
+  *perf->mutable_op() = DescribeOp("Mul", "CPU", 10, 20);
+  perf->set_compute_cost(1500);
+
+  MeasuredCostDatabase database;
+  database.AddMeasurements(perf_list);
+  MeasuredOpLevelCostEstimator estimator(&database);
+
+  // Measured op signature gets the measured costs.
+  OpContext measured_op;
+  measured_op.op_info = DescribeOp("Mul", "CPU", 10, 20);
+  EXPECT_EQ(estimator.PredictCosts(measured_op).execution_time,
+            Costs::NanoSeconds(1500));
+
+  // Unmeasured signature falls back to the analytical estimate, which for
+  // an op with unknown device properties is flagged as inaccurate.
+  OpContext unmeasured_op;
+  unmeasured_op.op_info = DescribeOp("Mul", "CPU", 10, 21);
+  const Costs analytical = estimator.PredictCosts(unmeasured_op);
+  EXPECT_NE(analytical.execution_time, Costs::NanoSeconds(1500));
+}
+
+}  // namespace
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,103 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/what_if_analyzer.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/grappler/clusters/virtual_cluster.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/virtual_placer.h"
+#include "tensorflow/core/grappler/costs/virtual_scheduler.h"
+
+namespace tensorflow {
+namespace grappler {
+
+Status PredictWhatIfRun(
+    const GrapplerItem& item,
+    const std::unordered_map<string, DeviceProperties>& devices,
+    WhatIfPrediction* prediction) {
+  VirtualCluster cluster(devices);
+  TF_RETURN_IF_ERROR(cluster.Provision());
+
+  std::unique_ptr<ReadyNodeManager> node_manager =
+      ReadyNodeManagerFactory("FirstReady");
+  OpLevelCostEstimator node_estimator;
+  VirtualScheduler scheduler(
+      /*use_static_shapes=*/true, /*use_aggressive_shape_inference=*/true,
+      &cluster, node_manager.get(),
+      absl::make_unique<VirtualPlacer>(cluster.GetDevices()));
+  TF_RETURN_IF_ERROR(scheduler.Init(&item));
+
+  Costs node_costs;
+  do {
+    OpContext op_context = scheduler.GetCurrNode();
+    node_costs = node_estimator.PredictCosts(op_context);
+  } while (scheduler.MarkCurrNodeExecuted(node_costs));
+
+  const Costs summary = scheduler.Summary();
+  prediction->step_time = summary.execution_time;
+  prediction->device_stats.clear();
+
+  const auto peak_memory = scheduler.GetPeakMemoryUsage();
+  for (const auto& device : *scheduler.GetDeviceStates()) {
+    WhatIfPrediction::DeviceStats& stats =
+        prediction->device_stats[device.first];
+    stats.busy_time = device.second.GetCurrTime();
+    if (summary.execution_time.count() > 0) {
+      stats.utilization = static_cast<double>(stats.busy_time.count()) /
+                          static_cast<double>(summary.execution_time.count());
+    }
+    auto it = peak_memory.find(device.first);
+    stats.peak_memory = it != peak_memory.end() ? it->second : 0;
+  }
+
+  return Status::OK();
+}
+
+Status RankWhatIfConfigurations(
+    const GrapplerItem& item,
+    const std::vector<std::unordered_map<string, DeviceProperties>>&
+        candidates,
+    std::vector<WhatIfPrediction>* predictions, std::vector<int>* ranking) {
+  predictions->clear();
+  predictions->resize(candidates.size());
+  ranking->clear();
+
+  for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
+    Status status = PredictWhatIfRun(item, candidates[i], &(*predictions)[i]);
+    if (status.ok()) {
+      ranking->push_back(i);
+    } else {
+      VLOG(1) << "Skipping candidate configuration " << i
+              << " from the ranking: " << status.error_message();
+      (*predictions)[i].step_time = Costs::Duration::max();
+    }
+  }
+
+  std::sort(ranking->begin(), ranking->end(), [&](int i1, int i2) {
+    const Costs::Duration& t1 = (*predictions)[i1].step_time;
+    const Costs::Duration& t2 = (*predictions)[i2].step_time;
+    if (t1 != t2) {
+      return t1 < t2;
+    }
+    return i1 < i2;
+  });
+
+  return Status::OK();
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,77 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_WHAT_IF_ANALYZER_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_WHAT_IF_ANALYZER_H_
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "tensorflow/core/grappler/costs/cost_estimator.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/protobuf/device_properties.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Predicted outcome of running a graph on one candidate device
+// configuration, computed by simulating the step with the VirtualScheduler
+// instead of running it on real hardware.
+struct WhatIfPrediction {
+  // Predicted end-to-end step time.
+  Costs::Duration step_time;
+
+  struct DeviceStats {
+    // Time the device spends executing the ops placed on it.
+    Costs::Duration busy_time;
+    // busy_time divided by step_time, in [0, 1].
+    double utilization = 0.0;
+    // Peak temporary memory usage on the device, in bytes.
+    int64 peak_memory = 0;
+  };
+  // Per-device statistics, keyed by device name. Includes the virtual
+  // channel devices the scheduler creates for cross-device transfers.
+  std::map<string, DeviceStats> device_stats;
+};
+
+// Simulates a single step of `item` on the given set of devices (as accepted
+// by VirtualCluster) and fills in the predicted step time, per-device
+// utilization and peak memory usage. The simulation relies on static shape
+// inference, so the item should have feeds with known shapes for the
+// prediction to be meaningful.
+Status PredictWhatIfRun(
+    const GrapplerItem& item,
+    const std::unordered_map<string, DeviceProperties>& devices,
+    WhatIfPrediction* prediction);
+
+// Evaluates every candidate device configuration and ranks them by predicted
+// step time, cheapest first. `predictions` is resized to match `candidates`
+// and holds the per-candidate predictions; `ranking` receives the indices of
+// the candidates that could be simulated, sorted by increasing step time.
+// Candidates that fail to simulate (e.g. a node placed on a device that
+// doesn't exist in the configuration) are left out of the ranking, with
+// their predicted step time set to Costs::Duration::max().
+Status RankWhatIfConfigurations(
+    const GrapplerItem& item,
+    const std::vector<std::unordered_map<string, DeviceProperties>>&
+        candidates,
+    std::vector<WhatIfPrediction>* predictions, std::vector<int>* ranking);
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_WHAT_IF_ANALYZER_H_
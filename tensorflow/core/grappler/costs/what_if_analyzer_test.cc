@@ -0,0 +1,97 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/what_if_analyzer.h"
+
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+// Invent a CPU so that predictions remain the same from machine to machine.
+DeviceProperties GetCpuDevice(int num_cores) {
+  DeviceProperties device;
+  device.set_type("CPU");
+  device.set_frequency(1000);
+  device.set_num_cores(num_cores);
+  device.set_bandwidth(32);
+  device.set_l1_cache_size(32 * 1024);
+  device.set_l2_cache_size(256 * 1024);
+  device.set_l3_cache_size(4 * 1024 * 1024);
+  device.set_memory_size(1024 * 1024);
+  return device;
+}
+
+GrapplerItem CreateMatMulItem() {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto a = ops::Const(s.WithOpName("a"), 1.0f, {256, 256});
+  auto b = ops::Const(s.WithOpName("b"), 2.0f, {256, 256});
+  auto product = ops::MatMul(s.WithOpName("product"), a, b);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"product"};
+  return item;
+}
+
+TEST(WhatIfAnalyzerTest, PredictsStepTimeAndDeviceStats) {
+  GrapplerItem item = CreateMatMulItem();
+  std::unordered_map<string, DeviceProperties> devices;
+  const string device_name = "/job:localhost/replica:0/task:0/cpu:0";
+  devices[device_name] = GetCpuDevice(4);
+
+  WhatIfPrediction prediction;
+  TF_ASSERT_OK(PredictWhatIfRun(item, devices, &prediction));
+
+  EXPECT_GT(prediction.step_time.count(), 0);
+  ASSERT_EQ(1, prediction.device_stats.count(device_name));
+  const auto& stats = prediction.device_stats.at(device_name);
+  EXPECT_GT(stats.busy_time.count(), 0);
+  EXPECT_GT(stats.utilization, 0.0);
+  EXPECT_LE(stats.utilization, 1.0);
+  EXPECT_GT(stats.peak_memory, 0);
+}
+
+TEST(WhatIfAnalyzerTest, RanksConfigurationsByPredictedStepTime) {
+  GrapplerItem item = CreateMatMulItem();
+  const string device_name = "/job:localhost/replica:0/task:0/cpu:0";
+
+  // A 1-core and an 8-core configuration of the same device: the compute
+  // bound matmul should be predicted to run faster on more cores.
+  std::vector<std::unordered_map<string, DeviceProperties>> candidates(2);
+  candidates[0][device_name] = GetCpuDevice(1);
+  candidates[1][device_name] = GetCpuDevice(8);
+
+  std::vector<WhatIfPrediction> predictions;
+  std::vector<int> ranking;
+  TF_ASSERT_OK(
+      RankWhatIfConfigurations(item, candidates, &predictions, &ranking));
+
+  ASSERT_EQ(2, predictions.size());
+  ASSERT_EQ(2, ranking.size());
+  EXPECT_EQ(1, ranking[0]);
+  EXPECT_EQ(0, ranking[1]);
+  EXPECT_LE(predictions[ranking[0]].step_time,
+            predictions[ranking[1]].step_time);
+}
+
+}  // namespace
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -1093,6 +1093,10 @@ class RemoveIdentityTranspose : public ArithmeticOptimizerStage {
     return IsTranspose(*node) || IsConjugateTranspose(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"Transpose", "ConjugateTranspose"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     TF_RETURN_IF_ERROR(EnsureNodeIsSupported(node));
     NodeDef* tail = node;
@@ -1200,6 +1204,10 @@ class RemoveInvolution : public ArithmeticOptimizerStage {
     return IsInvolution(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"Conj", "Reciprocal", "Invert", "Neg", "LogicalNot"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     NodeDef* tail = GetTailOfValuePreservingChain(*node, *ctx().node_map,
                                                   *ctx().nodes_to_preserve);
@@ -1239,6 +1247,8 @@ class RemoveRedundantBitcastStage : public ArithmeticOptimizerStage {
     return IsBitcast(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Bitcast"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     TF_RETURN_IF_ERROR(EnsureNodeIsSupported(node));
 
@@ -1285,6 +1295,8 @@ class RemoveRedundantCastStage : public ArithmeticOptimizerStage {
 
   bool IsSupported(const NodeDef* node) const override { return IsCast(*node); }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Cast"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     TF_RETURN_IF_ERROR(EnsureNodeIsSupported(node));
 
@@ -1312,6 +1324,10 @@ class RemoveNegationStage : public ArithmeticOptimizerStage {
     return IsAdd(*node) || IsSub(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"Add", "AddV2", "Sub"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     NodeDef* x;
     NodeDef* y;
@@ -1352,6 +1368,10 @@ class RemoveLogicalNotStage : public ArithmeticOptimizerStage {
     return IsLogicalNot(*node) && !IsInPreserveSet(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"LogicalNot"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     const string node_name = node->name();
     NodeDef* input;
@@ -1762,6 +1782,10 @@ class SqrtDivToRsqrtMulStage : public ArithmeticOptimizerStage {
     return IsAnyDiv(*node) && !IsDivNoNan(*node) && !IsFloorDiv(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"RealDiv", "Div", "Xdivy", "TruncateDiv"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     NodeDef* y;
     TF_RETURN_IF_ERROR(GetInputNode(node->input(1), &y));
@@ -1798,6 +1822,8 @@ class FuseSquaredDiffStage : public ArithmeticOptimizerStage {
     return IsSquare(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Square"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     NodeDef* b;
     TF_RETURN_IF_ERROR(GetInputNode(node->input(0), &b));
@@ -1825,6 +1851,8 @@ class LogSoftmaxStage : public ArithmeticOptimizerStage {
 
   bool IsSupported(const NodeDef* node) const override { return IsLog(*node); }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Log"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     NodeDef* x;
     TF_RETURN_IF_ERROR(GetInputNode(node->input(0), &x));
@@ -1862,6 +1890,8 @@ class RemoveRedundantReshape : public ArithmeticOptimizerStage {
     return IsReshape(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Reshape"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     NodeDef* input;
     TF_RETURN_IF_ERROR(GetInputNode(node->input(0), &input));
@@ -2079,6 +2109,10 @@ class FoldMultiplyIntoConv : public ArithmeticOptimizerStage {
     return IsConv2D(*node) || IsConv3D(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"Conv2D", "Conv3D"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
 #define TF_RETURN_IF_TRUE(...) \
   if ((__VA_ARGS__)) return Status::OK()
@@ -2188,6 +2222,11 @@ class FoldTransposeIntoMatMul : public ArithmeticOptimizerStage {
     return IsAnyMatMul(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"MatMul", "BatchMatMul", "SparseMatMul", "QuantizedMatMul",
+            "QuantizedMatMulV2"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     const NodeScopeAndName matmul = ParseNodeScopeAndName(node->name());
     const string optimized_node_name = OptimizedNodeName(matmul);
@@ -2295,6 +2334,10 @@ class FoldConjugateIntoTranspose : public ArithmeticOptimizerStage {
     return IsConj(*node) || IsTranspose(*node) || IsConjugateTranspose(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"Conj", "Transpose", "ConjugateTranspose"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     const NodeScopeAndName matmul = ParseNodeScopeAndName(node->name());
     const string optimized_node_name = OptimizedNodeName(matmul);
@@ -2336,6 +2379,10 @@ class ReplaceMulWithSquare : public ArithmeticOptimizerStage {
     return IsAnyMul(*node) && node->input(0) == node->input(1);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"Mul", "MulNoNan"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     const NodeScopeAndName mul = ParseNodeScopeAndName(node->name());
     const string optimized_node_name = OptimizedNodeName(mul);
@@ -2483,6 +2530,8 @@ class ConvertPowStage : public ArithmeticOptimizerStage {
            ctx().graph_properties->GetInputProperties(node->name()).size() == 2;
   }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Pow"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     const auto& pow_props =
         ctx().graph_properties->GetInputProperties(node->name())[1];
@@ -2615,6 +2664,8 @@ class ConvertLog1pStage : public ArithmeticOptimizerStage {
 
   bool IsSupported(const NodeDef* node) const override { return IsLog(*node); }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Log"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     NodeDef* input;
     TF_RETURN_IF_ERROR(GetInputNode(node->input(0), &input));
@@ -2713,6 +2764,8 @@ class ConvertExpm1Stage : public ArithmeticOptimizerStage {
     return IsExp(*input);
   }
 
+  std::vector<string> SupportedOpTypes() const override { return {"Sub"}; }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     if (ctx().graph_properties->GetInputProperties(node->name()).size() < 2) {
       return Status::OK();
@@ -2800,6 +2853,14 @@ class OptimizeMaxOrMinOfMonotonicStage : public ArithmeticOptimizerStage {
            IsArgMax(*node) || IsArgMin(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"Max",       "SegmentMax", "UnsortedSegmentMax",
+            "Min",       "SegmentMin", "UnsortedSegmentMin",
+            "MaxPool",   "MaxPoolV2",  "MaxPool3D",
+            "MaxPoolWithArgmax", "FractionalMaxPool",
+            "ArgMax",    "ArgMin"};
+  }
+
   Status TrySimplify(NodeDef* reduction_node,
                      string* simplified_node_name) override {
     if (IsInPreserveSet(*reduction_node)) {
@@ -3070,6 +3131,10 @@ class RemoveStackStridedSliceSameAxis : public ArithmeticOptimizerStage {
     return IsStridedSlice(*node);
   }
 
+  std::vector<string> SupportedOpTypes() const override {
+    return {"StridedSlice"};
+  }
+
   Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
     // *node is a StridedSlice NodeDef.
     NodeDef* pack;
@@ -61,6 +61,47 @@ NodeDef* AutoParallel::AddNodeDiv(const string& name, const string& input_a,
   return node;
 }
 
+NodeDef* AutoParallel::AddNodeCollectiveReduce(const string& name,
+                                               const string& input,
+                                               int instance_key) {
+  NodeDef* node = graph_.add_node();
+  node->set_name(strings::StrCat(kAutoParallelPrefix, "-Collective-", name));
+  node->set_op("CollectiveReduce");
+  node->add_input(input);
+
+  AttrValue attr_type;
+  attr_type.set_type(DT_FLOAT);
+  node->mutable_attr()->insert({"T", attr_type});
+
+  // All the replicas of this node form a single collective group; since the
+  // node is replicated verbatim, every replica shares the same group and
+  // instance keys and contributes one rank to the reduction.
+  AttrValue attr_group_size;
+  attr_group_size.set_i(num_replicas_);
+  node->mutable_attr()->insert({"group_size", attr_group_size});
+
+  AttrValue attr_group_key;
+  attr_group_key.set_i(0);
+  node->mutable_attr()->insert({"group_key", attr_group_key});
+
+  AttrValue attr_instance_key;
+  attr_instance_key.set_i(instance_key);
+  node->mutable_attr()->insert({"instance_key", attr_instance_key});
+
+  AttrValue attr_merge_op;
+  attr_merge_op.set_s("Add");
+  node->mutable_attr()->insert({"merge_op", attr_merge_op});
+
+  AttrValue attr_final_op;
+  attr_final_op.set_s("Div");
+  node->mutable_attr()->insert({"final_op", attr_final_op});
+
+  AttrValue attr_subdiv_offsets;
+  attr_subdiv_offsets.mutable_list()->add_i(0);
+  node->mutable_attr()->insert({"subdiv_offsets", attr_subdiv_offsets});
+  return node;
+}
+
 NodeDef* AutoParallel::AddNodeControl(const string& name,
                                       const std::set<string>& deps,
                                       GraphDef* graph) {
@@ -133,14 +174,25 @@ Status AutoParallel::Initialize(const GrapplerItem& item) {
                                         {"ApplyAdam", 9},
                                         {"ApplyRMSProp", 7},
                                         {"ApplyCenteredRMSProp", 8}};
+  int collective_instance_key = 0;
   for (const auto& apply_gradient_node_name : apply_gradients_nodes_) {
     auto apply_gradients_op = all_nodes_[apply_gradient_node_name]->op();
     auto apply_gradients_node = all_nodes_[apply_gradient_node_name];
 
-    auto div_node = AddNodeDiv(
-        apply_gradient_node_name,
-        apply_gradients_node->input(gradient_pos[apply_gradients_op]),
-        div_const_node->name());
+    string gradient_input =
+        apply_gradients_node->input(gradient_pos[apply_gradients_op]);
+    if (use_collective_ops_) {
+      // Average the gradient across the replicas first; the div node below
+      // then rescales the per-replica contribution so that the cumulative
+      // update applied to the shared variables stays unchanged.
+      auto collective_node = AddNodeCollectiveReduce(
+          apply_gradient_node_name, gradient_input, collective_instance_key++);
+      all_nodes_.insert(
+          std::make_pair(collective_node->name(), collective_node));
+      gradient_input = collective_node->name();
+    }
+    auto div_node = AddNodeDiv(apply_gradient_node_name, gradient_input,
+                               div_const_node->name());
     all_nodes_.insert(std::make_pair(div_node->name(), div_node));
     *apply_gradients_node->mutable_input(gradient_pos[apply_gradients_op]) =
         div_node->name();
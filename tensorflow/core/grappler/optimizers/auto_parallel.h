@@ -26,7 +26,14 @@ namespace grappler {
 // Automatically parallelize a graph by splitting in the batch dimension.
 class AutoParallel : public GraphOptimizer {
  public:
-  AutoParallel(int num_replicas) : num_replicas_(num_replicas) {
+  // When use_collective_ops is set, the per-replica gradients are averaged
+  // with CollectiveReduce nodes (one collective instance per gradient tensor,
+  // spanning all the replicas) before being applied, so each replica applies
+  // the same globally averaged gradient and the aggregation runs through the
+  // bandwidth-optimal collective implementations instead of materializing
+  // every per-replica gradient on one device.
+  explicit AutoParallel(int num_replicas, bool use_collective_ops = false)
+      : num_replicas_(num_replicas), use_collective_ops_(use_collective_ops) {
     CHECK(num_replicas_ >= 2);
   }
   ~AutoParallel() override {}
@@ -47,11 +54,14 @@ class AutoParallel : public GraphOptimizer {
   std::set<string> shared_nodes_;
   const GrapplerItem* item_;
   int num_replicas_;
+  bool use_collective_ops_;
   int num_gpus_;
   Status Initialize(const GrapplerItem& item);
   NodeDef* AddNodeDivConst();
   NodeDef* AddNodeDiv(const string& name, const string& input_a,
                       const string& input_b);
+  NodeDef* AddNodeCollectiveReduce(const string& name, const string& input,
+                                   int instance_key);
   NodeDef* AddNodeControl(const string& name, const std::set<string>& deps,
                           GraphDef* graph);
   bool NotSharedNode(const string& name);
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -126,6 +127,61 @@ TEST_F(AutoParallelTest, SimpleParallel) {
   EXPECT_EQ("^AutoParallel-Control-Fetch", node_gradient.input(0));
 }
 
+TEST_F(AutoParallelTest, SimpleParallelWithCollectiveReduce) {
+  tensorflow::Scope s = tensorflow::Scope::DisabledShapeInferenceScope();
+  Output constant_a = ops::Const(s.WithOpName("constant_a"), 1.0f, {1});
+  Output constant_b = ops::Const(s.WithOpName("constant_b"), 1, {1});
+  Output var = ops::Variable(s.WithOpName("var"), {1}, DT_FLOAT);
+  Output assign = ops::Assign(s.WithOpName("assign"), {var}, {constant_a});
+  Output fifo_queue = ops::FIFOQueue(s.WithOpName("fifo_queue"), {DT_FLOAT});
+  auto dequeue = ops::QueueDequeueMany(s.WithOpName("dequeue"), {fifo_queue},
+                                       {constant_b}, {DT_FLOAT});
+  Output add = ops::AddN(s.WithOpName("add"), {constant_a, dequeue[0]});
+  Output learning_rate = ops::Const(s.WithOpName("learning_rate"), 0.01f, {1});
+  Output apply_gradient = ops::ApplyGradientDescent(
+      s.WithOpName("apply_gradient"), {var}, {learning_rate}, {add});
+
+  GrapplerItem item;
+  item.init_ops.push_back("assign");
+  item.fetch.push_back("apply_gradient");
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  AutoParallel parallel(2, /*use_collective_ops=*/true);
+  GraphDef output;
+  Status status = parallel.Optimize(nullptr, item, &output);
+  TF_EXPECT_OK(status);
+
+  std::map<string, const NodeDef*> nodes;
+  for (const NodeDef& node : output.node()) {
+    nodes[node.name()] = &node;
+  }
+
+  for (int i = 0; i < 2; i++) {
+    string prefix = strings::StrCat("AutoParallel-Replica-", i);
+    const string collective_name = strings::StrCat(
+        prefix, "/AutoParallel-Collective-apply_gradient");
+    ASSERT_EQ(1, nodes.count(collective_name));
+    const NodeDef& collective = *nodes[collective_name];
+    EXPECT_EQ("CollectiveReduce", collective.op());
+    EXPECT_EQ(strings::StrCat(prefix, "/add"), collective.input(0));
+    EXPECT_EQ(2, collective.attr().at("group_size").i());
+    EXPECT_EQ(0, collective.attr().at("group_key").i());
+    EXPECT_EQ(0, collective.attr().at("instance_key").i());
+    EXPECT_EQ("Add", collective.attr().at("merge_op").s());
+    EXPECT_EQ("Div", collective.attr().at("final_op").s());
+
+    // The collective output still goes through the per-replica rescaling
+    // before being applied.
+    const string div_name =
+        strings::StrCat(prefix, "/AutoParallel-Div-apply_gradient");
+    ASSERT_EQ(1, nodes.count(div_name));
+    EXPECT_EQ(collective_name, nodes[div_name]->input(0));
+    const string apply_name = strings::StrCat(prefix, "/apply_gradient");
+    ASSERT_EQ(1, nodes.count(apply_name));
+    EXPECT_EQ(div_name, nodes[apply_name]->input(2));
+  }
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
@@ -1418,7 +1418,24 @@ Status ConstantFolding::FoldGraph(
       queue.push_back(graph_->mutable_node(i));
     }
   }
+  // Fold high-fanout nodes first. If folding is stopped by the deadline below,
+  // this order makes sure that the rewrites benefiting the most consumers have
+  // already been applied. Sort by name on ties to keep folding deterministic.
+  std::sort(queue.begin(), queue.end(),
+            [this](const NodeDef* n1, const NodeDef* n2) {
+              const size_t f1 = node_map_->GetOutputs(n1->name()).size();
+              const size_t f2 = node_map_->GetOutputs(n2->name()).size();
+              if (f1 != f2) return f1 > f2;
+              return n1->name() < n2->name();
+            });
   while (!queue.empty()) {
+    // Time-boxed folding: stop and keep the folds applied so far instead of
+    // failing the pass once the deadline is reached.
+    if (DeadlineExceeded()) {
+      VLOG(1) << "Stopping constant folding early, deadline exceeded with "
+              << queue.size() << " foldable nodes left in the queue.";
+      break;
+    }
     NodeDef* node = queue.front();
     queue.pop_front();
     if (processed_nodes.count(node->name())) {
@@ -0,0 +1,73 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/vectorization/vectorizer_registry.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class SqueezeVectorizer : public Vectorizer {
+ public:
+  Status Vectorize(const Node& node, Graph* outer_scope,
+                   VectorizerInput&& inputs,
+                   VectorizerOutput* outputs) override {
+    NodeBuilder::NodeOut input;
+    TF_RETURN_IF_ERROR(inputs.stacked(0, &input));
+
+    std::vector<int32> squeeze_dims;
+    if (HasNodeAttr(node.def(), "squeeze_dims")) {
+      TF_RETURN_IF_ERROR(
+          GetNodeAttr(node.attrs(), "squeeze_dims", &squeeze_dims));
+    }
+
+    if (squeeze_dims.empty()) {
+      // An empty `squeeze_dims` squeezes every dimension of size 1. The
+      // leading (batch) dimension of the stacked input may itself be 1, in
+      // which case squeezing it would change the output rank.
+      return errors::Unimplemented(
+          "Cannot vectorize Squeeze with an empty `squeeze_dims`.");
+    }
+
+    for (int32& dim : squeeze_dims) {
+      if (dim >= 0) {
+        // Since the vectorized input has an extra leading dimension,
+        // non-negative values in `squeeze_dims` must be incremented by 1.
+        // Note: negative values wrap around.
+        dim += 1;
+      }
+    }
+
+    Node* new_node;
+    TF_RETURN_IF_ERROR(NodeBuilder(strings::StrCat("vectorized/", node.name()),
+                                   node.type_string())
+                           .Input(input)
+                           .Attr("squeeze_dims", squeeze_dims)
+                           .Finalize(outer_scope, &new_node));
+
+    // Add the output mapping
+    outputs->push_back({new_node, 0, true});
+
+    return Status::OK();
+  }
+};
+
+REGISTER_VECTORIZER("Squeeze", SqueezeVectorizer);
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
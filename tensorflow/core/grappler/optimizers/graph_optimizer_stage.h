@@ -131,6 +131,13 @@ class GraphOptimizerStage {
   // traversals.
   virtual bool IsSupported(const NodeDef* node) const = 0;
 
+  // Op types for which IsSupported() can possibly return true. An empty list
+  // (the default) means the stage must be offered every node. Stages that fire
+  // only on a closed set of ops should override this, so that
+  // GraphOptimizerStagePipeline can dispatch nodes through an op type index
+  // instead of querying IsSupported() on every stage.
+  virtual std::vector<string> SupportedOpTypes() const { return {}; }
+
   // Try to simplify the given node.
   //
   // Return error status only if some precondition is failed, or got an
@@ -243,6 +250,9 @@ class GraphOptimizerStagePipeline {
   T& AddStage(Args&&... args) {
     auto stage = new T(std::forward<Args>(args)...);
     stages_.push_back(std::unique_ptr<T>(stage));
+    const std::vector<string> op_types = stage->SupportedOpTypes();
+    stage_op_types_.emplace_back(op_types.begin(), op_types.end());
+    op_index_.clear();
     return *stage;
   }
 
@@ -255,7 +265,7 @@ class GraphOptimizerStagePipeline {
   //
   // Return false, if node was not optimized by any of registered stages.
   bool PassThroughAllStages(NodeDef* node, Result* result) {
-    for (auto& stage : stages_) {
+    for (auto* stage : StagesForOp(node->op())) {
       if (stage->IsSupported(node)) {
         const Status stage_status = stage->TrySimplify(node, result);
         // Each stage must be "error safe" (just like exception safe). In
@@ -277,7 +287,7 @@ class GraphOptimizerStagePipeline {
   //
   // Returns any stage failure status, or else Status::OK().
   Status PassThroughAllStagesWithStatus(NodeDef* node, Result* result) {
-    for (auto& stage : stages_) {
+    for (auto* stage : StagesForOp(node->op())) {
       if (!stage->IsSupported(node)) {
         continue;
       }
@@ -302,7 +312,31 @@ class GraphOptimizerStagePipeline {
   }
 
  private:
+  // Stages that might fire on the given op type, in registration order. Stages
+  // that did not declare their supported op types are candidates for every op.
+  // The index is memoized per distinct op type, so rewrites that introduce new
+  // op types are picked up on first dispatch.
+  const std::vector<GraphOptimizerStage<Result>*>& StagesForOp(
+      const string& op) {
+    auto it = op_index_.find(op);
+    if (it == op_index_.end()) {
+      std::vector<GraphOptimizerStage<Result>*> candidates;
+      for (std::size_t i = 0; i < stages_.size(); ++i) {
+        const auto& op_types = stage_op_types_[i];
+        if (op_types.empty() || op_types.count(op) > 0) {
+          candidates.push_back(stages_[i].get());
+        }
+      }
+      it = op_index_.emplace(op, std::move(candidates)).first;
+    }
+    return it->second;
+  }
+
   std::vector<std::unique_ptr<GraphOptimizerStage<Result>>> stages_;
+  // Parallel to stages_: declared op types of each stage (empty = any op).
+  std::vector<std::unordered_set<string>> stage_op_types_;
+  std::unordered_map<string, std::vector<GraphOptimizerStage<Result>*>>
+      op_index_;
   std::function<bool(const Result&)> break_predicate_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(GraphOptimizerStagePipeline);
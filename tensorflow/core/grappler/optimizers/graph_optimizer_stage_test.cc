@@ -230,6 +230,59 @@ TEST_F(GraphOptimizerStageTest, AddNodes) {
   EXPECT_EQ(empty_node, empty_node_by_name);
 }
 
+// Optimizer stage that fires only on the declared op types and counts the
+// nodes it was offered.
+class CountingOptimizerStage : public FakeOptimizerStage {
+ public:
+  CountingOptimizerStage(const string& stage_name,
+                         const GraphOptimizerContext& ctx,
+                         const std::vector<string>& op_types)
+      : FakeOptimizerStage("my_opt", stage_name, ctx), op_types_(op_types) {}
+  ~CountingOptimizerStage() override = default;
+
+  bool IsSupported(const NodeDef* node) const override {
+    ++num_offered_nodes;
+    return true;
+  }
+  std::vector<string> SupportedOpTypes() const override { return op_types_; }
+
+  mutable int num_offered_nodes = 0;
+
+ private:
+  std::vector<string> op_types_;
+};
+
+TEST_F(GraphOptimizerStageTest, PipelineDispatchesByOpType) {
+  GrapplerItem item;
+  item.graph = GDef({NDef("a", "Const", {}), NDef("b", "Const", {}),
+                     NDef("add", "Add", {"a", "b"})},
+                    /*funcs=*/{});
+
+  NodeMap node_map(&item.graph);
+  GraphOptimizerContext ctx(/*nodes_to_preserve*/ nullptr,
+                            /*optimized_graph*/ &item.graph,
+                            /*graph_properties*/ nullptr,
+                            /*node_map*/ &node_map,
+                            /*feed_nodes*/ nullptr,
+                            /*opt_level*/ RewriterConfig::ON);
+
+  GraphOptimizerStagePipeline<FakeResult> pipeline(
+      [](const FakeResult&) { return false; });
+  auto& add_stage = pipeline.AddStage<CountingOptimizerStage>(
+      "add_stg", ctx, std::vector<string>{"Add"});
+  auto& generic_stage = pipeline.AddStage<CountingOptimizerStage>(
+      "all_stg", ctx, std::vector<string>{});
+
+  FakeResult result;
+  for (NodeDef& node : *item.graph.mutable_node()) {
+    pipeline.PassThroughAllStages(&node, &result);
+  }
+
+  // The indexed stage is offered only the Add node, the generic one all nodes.
+  EXPECT_EQ(add_stage.num_offered_nodes, 1);
+  EXPECT_EQ(generic_stage.num_offered_nodes, 3);
+}
+
 }  // namespace
 }  // end namespace grappler
 }  // end namespace tensorflow
@@ -420,9 +420,94 @@ void RecomputeSubgraph(
   }
 }
 
+// Profile-guided planning of the recompute set. When the cluster provides a
+// memory profile showing a device over its memory budget, keep only the
+// subgraphs saving the most bytes per recomputed node until the deficit is
+// recovered, since every recomputed subgraph adds compute time. Without a
+// profile, or with all devices under budget, all subgraphs are kept.
+void PruneRecomputedSubgraphsToMemoryBudget(
+    Cluster* cluster, const GrapplerItem& item,
+    std::vector<RecomputedSubGraph>* subgraphs) {
+  if (cluster == nullptr || subgraphs->empty()) {
+    return;
+  }
+  GraphMemory memory(item);
+  const std::unordered_map<string, DeviceProperties>& devices =
+      cluster->GetDevices();
+  Status s = memory.InferStatically(devices);
+  if (!s.ok()) {
+    VLOG(1) << "Failed to infer memory usage: " << s.error_message();
+    return;
+  }
+  int64 required_savings = 0;
+  for (const auto& device : devices) {
+    const DeviceProperties& prop = device.second;
+    if (prop.memory_size() <= 0) {
+      continue;
+    }
+    const GraphMemory::MemoryUsage& mem_usage =
+        memory.GetPeakMemoryUsage(device.first);
+    required_savings = std::max(required_savings,
+                                mem_usage.used_memory - prop.memory_size());
+  }
+  if (required_savings <= 0) {
+    return;
+  }
+
+  GraphProperties properties(item);
+  if (!properties.InferStatically(/*assume_valid_feeds=*/false).ok()) {
+    return;
+  }
+
+  // Estimate for each subgraph the bytes its recomputation frees (activations
+  // of the source nodes feeding target nodes) and its added compute (number of
+  // recomputed nodes, all cheap ops by construction).
+  struct PlannedSubgraph {
+    const RecomputedSubGraph* subgraph;
+    int64 saved_bytes;
+  };
+  std::vector<PlannedSubgraph> planned;
+  planned.reserve(subgraphs->size());
+  for (const RecomputedSubGraph& subgraph : *subgraphs) {
+    int64 saved_bytes = 0;
+    for (const NodeDef* source : subgraph.recomputed_source_nodes) {
+      for (const OpInfo::TensorProperties& prop :
+           properties.GetOutputProperties(source->name())) {
+        saved_bytes += CalculateTensorSize(prop);
+      }
+    }
+    planned.push_back({&subgraph, saved_bytes});
+  }
+  std::sort(planned.begin(), planned.end(),
+            [](const PlannedSubgraph& p1, const PlannedSubgraph& p2) {
+              const double r1 =
+                  static_cast<double>(p1.saved_bytes) /
+                  p1.subgraph->recomputed_source_nodes.size();
+              const double r2 =
+                  static_cast<double>(p2.saved_bytes) /
+                  p2.subgraph->recomputed_source_nodes.size();
+              return r1 > r2;
+            });
+
+  std::vector<RecomputedSubGraph> selection;
+  int64 cumulative_savings = 0;
+  for (const PlannedSubgraph& p : planned) {
+    if (cumulative_savings >= required_savings) {
+      break;
+    }
+    cumulative_savings += p.saved_bytes;
+    selection.push_back(*p.subgraph);
+  }
+  VLOG(1) << "Recomputing " << selection.size() << " of " << subgraphs->size()
+          << " candidate subgraphs to save " << cumulative_savings
+          << " bytes out of " << required_savings << " required";
+  subgraphs->swap(selection);
+}
+
 void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
                                 const string& recomputation_targets_name_scope,
-                                GraphDef* graph, const GrapplerItem& item) {
+                                GraphDef* graph, const GrapplerItem& item,
+                                Cluster* cluster) {
   if (optimization_level != RewriterConfig::RECOMPUTATION_HEURISTICS &&
       optimization_level != RewriterConfig::HEURISTICS &&
       optimization_level != RewriterConfig::MANUAL) {
@@ -481,6 +566,9 @@ void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
         },
         is_target);
   }
+  // Recomputation trades compute for memory: when a memory profile is
+  // available, recompute only as much as the budget requires.
+  PruneRecomputedSubgraphsToMemoryBudget(cluster, item, &recomputed_subgraphs);
   if (!recomputed_subgraphs.empty()) {
     std::unordered_map<const NodeDef*, int> topological_numbering;
     for (int node_number = 0; node_number < graph->node().size();
@@ -1342,7 +1430,7 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
 
   RecomputationRewritingPass(optimization_level_,
                              recomputation_targets_name_scope_,
-                             &optimized_item.graph, item);
+                             &optimized_item.graph, item, cluster);
 
   std::unordered_set<string> skip_list;
   // Bound the number of rewrite passes to avoid long processing times on graphs
@@ -368,6 +368,13 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
     CompressConstants(optimized_graph);
   }
 
+  // Incremental pass scheduling: count graph-modifying passes, and remember
+  // the count observed by each optimizer when it last ran. On iterations after
+  // the first an optimizer whose count is still current would see an identical
+  // graph, so it is skipped instead of re-run.
+  int num_modifying_passes = 0;
+  std::vector<int> passes_seen(optimizers.size(), -1);
+
   for (int iteration = 0; iteration < NumIterations(cfg_); ++iteration) {
     // Don't bother optimizing further if the graph is already tiny.
     if (optimized_graph->node_size() < min_graph_nodes) {
@@ -377,6 +384,7 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
       break;
     }
 
+    const int passes_at_iteration_start = num_modifying_passes;
     VLOG(4) << "Starting optimization iteration " << iteration;
     if (VLOG_IS_ON(4)) {
       DumpGraphDefToFile(
@@ -385,7 +393,8 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
           *optimized_graph);
     }
 
-    for (const auto& optimizer : optimizers) {
+    for (int i = 0; i < static_cast<int>(optimizers.size()); ++i) {
+      const auto& optimizer = optimizers[i];
       GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
       // Some optimizers can run only once.
       if (iteration > 0 && IsRunOnceOptimizer(optimizer->name())) continue;
@@ -398,9 +407,19 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
         if (fusion_optimizer == nullptr) fusion_optimizer = optimizer.get();
         continue;
       }
+      // Skip the optimizer if the graph was not modified since it last ran.
+      if (iteration > 0 && passes_seen[i] == num_modifying_passes) {
+        VLOG(3) << "Skipping " << optimizer->name() << " at iteration "
+                << iteration << ", no changes to the graph since its last run";
+        continue;
+      }
 
+      bool graph_modified = false;
       TF_RETURN_IF_ERROR(RunOptimizer(optimizer.get(), cluster, &optimized_item,
-                                      optimized_graph, &optimization_result));
+                                      optimized_graph, &optimization_result,
+                                      &graph_modified));
+      if (graph_modified) ++num_modifying_passes;
+      passes_seen[i] = num_modifying_passes;
 
       if (iteration == 0 && optimizer->name() == "model_pruner") {
         CompressConstants(optimized_graph);
@@ -428,6 +447,13 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
     for (const auto& verifier : post_optimization_verifiers) {
       TF_RETURN_IF_ERROR(verifier->Verify(*optimized_graph));
     }
+    // If no optimizer modified the graph this iteration, the next iteration
+    // would run every pass on an identical graph; stop early.
+    if (passes_at_iteration_start == num_modifying_passes) {
+      VLOG(3) << "Stopping after iteration " << iteration
+              << ", no optimizer modified the graph";
+      break;
+    }
   }
 
   // Run fusion optimizer if requested after all other optimizers since: 1) it
@@ -471,7 +497,8 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
 
 Status MetaOptimizer::RunOptimizer(
     GraphOptimizer* optimizer, Cluster* cluster, GrapplerItem* optimized_item,
-    GraphDef* optimized_graph, GraphOptimizationResult* optimization_result) {
+    GraphDef* optimized_graph, GraphOptimizationResult* optimization_result,
+    bool* graph_modified) {
   uint64 start_us = Env::Default()->NowMicros();
   // This swaps the current optimized_graph into optimized item and
   // resets optimized_graph to an empty graph.
@@ -483,9 +510,16 @@ Status MetaOptimizer::RunOptimizer(
   uint64 end_us = Env::Default()->NowMicros();
   float duration_ms = (end_us - start_us) / 1000.0f;
 
+  // Unless the optimizer explicitly reported "did nothing" below, assume it
+  // modified the graph.
+  if (graph_modified != nullptr) *graph_modified = true;
+
   string message;
   if (!status.ok()) {
+    // The graph was swapped back to its pre-optimizer state, so it is
+    // unmodified no matter what the error was.
     optimized_graph->Swap(&optimized_item->graph);
+    if (graph_modified != nullptr) *graph_modified = false;
     if (errors::IsAborted(status)) {
       // By convention we (ab-)use the Aborted error code to signal that the
       // optimizer returned without performing any changes to the graph.
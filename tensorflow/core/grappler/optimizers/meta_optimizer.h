@@ -92,9 +92,13 @@ class MetaOptimizer : public GraphOptimizer {
     std::vector<OptimizerResult> results;
   };
 
+  // Runs a single optimizer pass. If `graph_modified` is non-null it is set to
+  // true iff the optimizer reported changes to the graph (optimizers signal "no
+  // changes" by returning the Aborted error code).
   Status RunOptimizer(GraphOptimizer* optimizer, Cluster* cluster,
                       GrapplerItem* optimized_item, GraphDef* optimized_graph,
-                      GraphOptimizationResult* optimization_result);
+                      GraphOptimizationResult* optimization_result,
+                      bool* graph_modified = nullptr);
 
   std::vector<GraphOptimizationResult> optimization_results_;
 };
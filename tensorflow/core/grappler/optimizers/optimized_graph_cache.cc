@@ -0,0 +1,145 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/optimized_graph_cache.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/optimizers/meta_optimizer.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+namespace tensorflow {
+namespace grappler {
+
+uint64 OptimizedGraphCache::ComputeKey(
+    const GraphDef& graph, const std::vector<string>& device_names,
+    const RewriterConfig& rewriter_config) {
+  string serialized_graph;
+  string serialized_config;
+  // Deterministic serialization keeps map fields in a stable order, so the
+  // same inputs hash to the same key in every process.
+  SerializeToStringDeterministic(graph, &serialized_graph);
+  SerializeToStringDeterministic(rewriter_config, &serialized_config);
+
+  uint64 key = FingerprintCat64(Fingerprint64(serialized_graph),
+                                Fingerprint64(serialized_config));
+  std::vector<string> sorted_devices(device_names);
+  std::sort(sorted_devices.begin(), sorted_devices.end());
+  for (const string& device : sorted_devices) {
+    key = FingerprintCat64(key, Fingerprint64(device));
+  }
+  return key;
+}
+
+string OptimizedGraphCache::GraphPath(uint64 key) const {
+  return io::JoinPath(
+      cache_dir_,
+      strings::StrCat(strings::Hex(key, strings::kZeroPad16), ".graph.pb"));
+}
+
+string OptimizedGraphCache::FingerprintPath(uint64 key) const {
+  return io::JoinPath(
+      cache_dir_,
+      strings::StrCat(strings::Hex(key, strings::kZeroPad16), ".fingerprint"));
+}
+
+Status OptimizedGraphCache::Lookup(uint64 key,
+                                   GraphDef* optimized_graph) const {
+  // The fingerprint is written last by Store, so an entry without one is
+  // still being written and counts as a miss.
+  string expected_fingerprint;
+  Status status =
+      ReadFileToString(env_, FingerprintPath(key), &expected_fingerprint);
+  if (!status.ok()) {
+    return errors::NotFound("No cache entry for key ",
+                            strings::StrCat(strings::Hex(key)));
+  }
+
+  string serialized_graph;
+  TF_RETURN_IF_ERROR(ReadFileToString(env_, GraphPath(key),
+                                      &serialized_graph));
+
+  uint64 expected;
+  if (!strings::safe_strtou64(expected_fingerprint, &expected) ||
+      Fingerprint64(serialized_graph) != expected) {
+    return errors::DataLoss("Cache entry for key ",
+                            strings::StrCat(strings::Hex(key)),
+                            " failed verification");
+  }
+  if (!optimized_graph->ParseFromString(serialized_graph)) {
+    return errors::DataLoss("Cache entry for key ",
+                            strings::StrCat(strings::Hex(key)),
+                            " could not be parsed");
+  }
+  return Status::OK();
+}
+
+Status OptimizedGraphCache::Store(uint64 key,
+                                  const GraphDef& optimized_graph) const {
+  TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(cache_dir_));
+
+  string serialized_graph;
+  if (!SerializeToStringDeterministic(optimized_graph, &serialized_graph)) {
+    return errors::Internal("Failed to serialize the optimized graph");
+  }
+  TF_RETURN_IF_ERROR(
+      WriteStringToFile(env_, GraphPath(key), serialized_graph));
+  // Written last: its presence marks the entry as complete.
+  return WriteStringToFile(
+      env_, FingerprintPath(key),
+      strings::StrCat(Fingerprint64(serialized_graph)));
+}
+
+Status RunMetaOptimizerWithCache(const GrapplerItem& item,
+                                 const ConfigProto& cfg,
+                                 DeviceBase* cpu_device, Cluster* cluster,
+                                 OptimizedGraphCache* cache,
+                                 GraphDef* optimized_graph) {
+  std::vector<string> device_names;
+  if (cluster != nullptr) {
+    device_names = cluster->GetDeviceNames();
+  }
+  const uint64 key = OptimizedGraphCache::ComputeKey(
+      item.graph, device_names, cfg.graph_options().rewrite_options());
+
+  Status lookup = cache->Lookup(key, optimized_graph);
+  if (lookup.ok()) {
+    VLOG(1) << "Optimized graph cache hit for item " << item.id;
+    return Status::OK();
+  }
+  if (!errors::IsNotFound(lookup)) {
+    LOG(WARNING) << "Optimized graph cache lookup failed, re-optimizing: "
+                 << lookup.error_message();
+  }
+
+  TF_RETURN_IF_ERROR(
+      RunMetaOptimizer(item, cfg, cpu_device, cluster, optimized_graph));
+
+  Status store = cache->Store(key, *optimized_graph);
+  if (!store.ok()) {
+    LOG(WARNING) << "Failed to store the optimized graph in the cache: "
+                 << store.error_message();
+  }
+  return Status::OK();
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
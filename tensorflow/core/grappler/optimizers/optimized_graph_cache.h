@@ -0,0 +1,88 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OPTIMIZED_GRAPH_CACHE_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OPTIMIZED_GRAPH_CACHE_H_
+
+#include <vector>
+
+#include "tensorflow/core/framework/device_base.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/rewriter_config.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+
+class Cluster;
+
+// Persistent cache of Grappler-optimized graphs. Entries are keyed by a
+// fingerprint of the input graph, the devices it is going to run on, and the
+// rewriter configuration, so a fleet of identical replicas can optimize a
+// graph once and let every other replica fetch the result at startup instead
+// of re-running the meta optimizer.
+//
+// The cache directory may live on any filesystem registered with the given
+// Env (local paths, gs://, s3://, ...). Each entry is stored as the
+// serialized optimized GraphDef plus a fingerprint of its contents that is
+// re-checked on fetch, so truncated or corrupted entries are rejected rather
+// than deserialized.
+class OptimizedGraphCache {
+ public:
+  OptimizedGraphCache(Env* env, const string& cache_dir)
+      : env_(env), cache_dir_(cache_dir) {}
+
+  // Computes a stable cache key for optimizing `graph` with
+  // `rewriter_config` on the given set of devices. The graph and the config
+  // are serialized deterministically so the key is stable across processes.
+  static uint64 ComputeKey(const GraphDef& graph,
+                           const std::vector<string>& device_names,
+                           const RewriterConfig& rewriter_config);
+
+  // Fetches the optimized graph stored under `key`. Returns NotFound if no
+  // entry exists, and DataLoss if the entry fails verification.
+  Status Lookup(uint64 key, GraphDef* optimized_graph) const;
+
+  // Stores `optimized_graph` under `key`. The contents fingerprint is
+  // written last, so a concurrently fetching replica either sees a complete,
+  // verifiable entry or a NotFound.
+  Status Store(uint64 key, const GraphDef& optimized_graph) const;
+
+ private:
+  string GraphPath(uint64 key) const;
+  string FingerprintPath(uint64 key) const;
+
+  Env* const env_;
+  const string cache_dir_;
+};
+
+// Runs the meta optimizer through the cache: on a hit the optimized graph is
+// fetched and Grappler is skipped entirely; on a miss the graph is optimized
+// with RunMetaOptimizer and the result is stored for the other replicas.
+// Cache fetch or store failures other than NotFound are logged and treated
+// as misses, so a broken cache never fails session creation.
+Status RunMetaOptimizerWithCache(const GrapplerItem& item,
+                                 const ConfigProto& cfg,
+                                 DeviceBase* cpu_device, Cluster* cluster,
+                                 OptimizedGraphCache* cache,
+                                 GraphDef* optimized_graph);
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OPTIMIZED_GRAPH_CACHE_H_
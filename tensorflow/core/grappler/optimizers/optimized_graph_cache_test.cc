@@ -0,0 +1,127 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/optimized_graph_cache.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+GraphDef CreateTestGraph() {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a = ops::Const(s.WithOpName("a"), 1.0f, {2, 2});
+  Output b = ops::Const(s.WithOpName("b"), 2.0f, {2, 2});
+  Output add = ops::Add(s.WithOpName("add"), a, b);
+  GraphDef graph;
+  TF_CHECK_OK(s.ToGraphDef(&graph));
+  return graph;
+}
+
+TEST(OptimizedGraphCacheTest, KeyIsStableAndSensitiveToInputs) {
+  GraphDef graph = CreateTestGraph();
+  RewriterConfig config;
+  std::vector<string> devices = {"/cpu:0", "/gpu:0"};
+  std::vector<string> reordered_devices = {"/gpu:0", "/cpu:0"};
+
+  const uint64 key = OptimizedGraphCache::ComputeKey(graph, devices, config);
+  EXPECT_EQ(key, OptimizedGraphCache::ComputeKey(graph, devices, config));
+  // The device order does not matter.
+  EXPECT_EQ(key,
+            OptimizedGraphCache::ComputeKey(graph, reordered_devices, config));
+
+  // Changing the graph, the devices or the config changes the key.
+  GraphDef other_graph = graph;
+  other_graph.mutable_node(0)->set_name("renamed");
+  EXPECT_NE(key, OptimizedGraphCache::ComputeKey(other_graph, devices, config));
+  EXPECT_NE(key, OptimizedGraphCache::ComputeKey(graph, {"/cpu:0"}, config));
+  RewriterConfig other_config;
+  other_config.set_constant_folding(RewriterConfig::OFF);
+  EXPECT_NE(key, OptimizedGraphCache::ComputeKey(graph, devices, other_config));
+}
+
+TEST(OptimizedGraphCacheTest, StoreAndLookup) {
+  OptimizedGraphCache cache(Env::Default(),
+                            io::JoinPath(testing::TmpDir(), "graph_cache"));
+  GraphDef graph = CreateTestGraph();
+  const uint64 key = OptimizedGraphCache::ComputeKey(graph, {}, {});
+
+  GraphDef fetched;
+  Status lookup = cache.Lookup(key, &fetched);
+  EXPECT_TRUE(errors::IsNotFound(lookup));
+
+  TF_ASSERT_OK(cache.Store(key, graph));
+  TF_ASSERT_OK(cache.Lookup(key, &fetched));
+  EXPECT_EQ(graph.DebugString(), fetched.DebugString());
+}
+
+TEST(OptimizedGraphCacheTest, RejectsCorruptedEntries) {
+  const string cache_dir = io::JoinPath(testing::TmpDir(), "corrupt_cache");
+  OptimizedGraphCache cache(Env::Default(), cache_dir);
+  GraphDef graph = CreateTestGraph();
+  const uint64 key = OptimizedGraphCache::ComputeKey(graph, {}, {});
+  TF_ASSERT_OK(cache.Store(key, graph));
+
+  // Truncate the stored graph; the fingerprint no longer matches.
+  std::vector<string> files;
+  TF_ASSERT_OK(Env::Default()->GetChildren(cache_dir, &files));
+  for (const string& file : files) {
+    if (file.find(".graph.pb") != string::npos) {
+      TF_ASSERT_OK(WriteStringToFile(Env::Default(),
+                                     io::JoinPath(cache_dir, file), "garbage"));
+    }
+  }
+
+  GraphDef fetched;
+  Status lookup = cache.Lookup(key, &fetched);
+  EXPECT_TRUE(errors::IsDataLoss(lookup));
+}
+
+TEST(OptimizedGraphCacheTest, MetaOptimizerUsesCachedResult) {
+  OptimizedGraphCache cache(Env::Default(),
+                            io::JoinPath(testing::TmpDir(), "meta_cache"));
+  GrapplerItem item;
+  item.id = "test_item";
+  item.graph = CreateTestGraph();
+  item.fetch = {"add"};
+
+  ConfigProto config_proto;
+  GraphDef optimized;
+  TF_ASSERT_OK(RunMetaOptimizerWithCache(item, config_proto, nullptr, nullptr,
+                                         &cache, &optimized));
+
+  // The second run must be served from the cache and return the same graph.
+  GraphDef optimized_again;
+  TF_ASSERT_OK(RunMetaOptimizerWithCache(item, config_proto, nullptr, nullptr,
+                                         &cache, &optimized_again));
+  EXPECT_EQ(optimized.DebugString(), optimized_again.DebugString());
+
+  const uint64 key = OptimizedGraphCache::ComputeKey(
+      item.graph, {}, config_proto.graph_options().rewrite_options());
+  GraphDef cached;
+  TF_ASSERT_OK(cache.Lookup(key, &cached));
+  EXPECT_EQ(optimized.DebugString(), cached.DebugString());
+}
+
+}  // namespace
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -174,7 +174,7 @@ bool IsCpuCompatibleDataType(const NodeDef* contraction,
   if (IsConv2D(*contraction)) {
     return dtype == DT_FLOAT || dtype == DT_DOUBLE;
   } else if (IsMatMul(*contraction)) {
-    return dtype == DT_FLOAT;
+    return dtype == DT_FLOAT || dtype == DT_DOUBLE;
   } else {
     return false;
   }
@@ -328,8 +328,10 @@ bool FindContractionWithBiasAndActivation(
     ContractionWithBiasAddAndActivation* matched) {
   if (!EigenSupportsContractionOutputKernel()) return false;
 
-  // Root of the pattern must be an activation node.
-  if (!activation || !IsSupportedActivation(*activation) ||
+  // Root of the pattern must be an activation node. Tanh is only fused into
+  // the _FusedMatMul CPU kernel, which is checked below.
+  if (!activation ||
+      !(IsSupportedActivation(*activation) || IsTanh(*activation)) ||
       HasControlFaninOrFanout(ctx.graph_view, activation))
     return false;
 
@@ -345,6 +347,11 @@ bool FindContractionWithBiasAndActivation(
       IsInPreserveSet(ctx, base.bias_add))
     return false;
 
+  // Tanh is supported only by the _FusedMatMul CPU kernel.
+  if (IsTanh(*activation) && !(IsMatMul(*base.contraction) &&
+                               IsCpuCompatibleMatMul(base.contraction)))
+    return false;
+
   // Check that data type and data format are supported on assigned device.
   const ContractionWithBiasAddAndActivation pattern{base.contraction,
                                                     base.bias_add, activation};
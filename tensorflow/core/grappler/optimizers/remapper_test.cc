@@ -313,7 +313,7 @@ TEST_F(RemapperTest, FuseMatMulWithBiasAndActivation) {
 
   using ::tensorflow::ops::Placeholder;
 
-  for (const string& activation : {"Relu", "Relu6", "Elu"}) {
+  for (const string& activation : {"Relu", "Relu6", "Elu", "Tanh"}) {
     tensorflow::Scope s = tensorflow::Scope::NewRootScope();
 
     auto lhs_shape = ops::Placeholder::Shape({8, 32});
@@ -337,6 +337,8 @@ TEST_F(RemapperTest, FuseMatMulWithBiasAndActivation) {
         return ops::Identity(fetch, ops::Relu6(activate, bias_add));
       } else if (activation == "Elu") {
         return ops::Identity(fetch, ops::Elu(activate, bias_add));
+      } else if (activation == "Tanh") {
+        return ops::Identity(fetch, ops::Tanh(activate, bias_add));
       }
 
       return ops::Identity(fetch, bias);
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/grappler_item.h"
@@ -710,22 +711,308 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
   }
 };
 
+// Rewrites a ConcatV2 over same-typed tensors into a zero-copy view of a
+// ScopedAllocator backing tensor.  The producers of the concatenated
+// tensors are annotated to allocate their outputs directly at the
+// appropriate offsets of a single backing allocation, after which the
+// concatenation itself requires no data movement.  This is primarily of
+// value for gradient packing, where many small gradient tensors are
+// flattened and concatenated into one tensor prior to an all-reduce.
+class ConcatRewriter : public ScopedAllocatorOptimizer::Rewriter {
+ public:
+  ~ConcatRewriter() override {}
+
+  bool RewritesSingleInstance() const override { return true; }
+
+  // Unlike the elementwise case each ConcatV2 is rewritten on its own:
+  // its inputs, not parallel instances of the op, share the
+  // ScopedAllocator.
+  Status Rewrite(ScopedAllocatorOptimizer* sa_opti, int64 invocation_count,
+                 GraphDef* graph, const string& op_name,
+                 const std::vector<NodeDef*>& ops, bool* applied) override {
+    for (NodeDef* nd : ops) {
+      bool rewritten = false;
+      LOG_WARNING_AND_RETURN_IF_ERROR(
+          RewriteOne(sa_opti, invocation_count, graph, nd, &rewritten));
+      *applied = *applied || rewritten;
+    }
+    return Status::OK();
+  }
+
+ private:
+  // Returns true if axis_node is a compile-time constant with scalar
+  // value 0, i.e. the concatenation is along the outermost dimension.
+  // Only then is the dense concatenation identical to the backing
+  // tensor layout.
+  static bool IsZeroAxis(const NodeDef& axis_node) {
+    if (!IsConstant(axis_node)) return false;
+    Tensor axis_tensor;
+    if (!GetNodeAttr(AttrSlice(axis_node), "value", &axis_tensor).ok()) {
+      return false;
+    }
+    if (axis_tensor.NumElements() != 1) return false;
+    if (axis_tensor.dtype() == DT_INT32) {
+      return axis_tensor.flat<int32>()(0) == 0;
+    }
+    if (axis_tensor.dtype() == DT_INT64) {
+      return axis_tensor.flat<int64>()(0) == 0;
+    }
+    return false;
+  }
+
+  // Returns true if node may output a buffer that it did not allocate
+  // itself, e.g. a constant, a variable, or a buffer-forwarding op.
+  // Such an output cannot be redirected into a ScopedAllocator backing
+  // tensor.  The list is conservative, not exhaustive.
+  static bool MayForwardOrAliasBuffer(const NodeDef& node) {
+    return IsConstant(node) || IsHostConstant(node) || IsPlaceholder(node) ||
+           IsVariable(node) || IsReadVariableOp(node) || IsIdentity(node) ||
+           IsIdentityN(node) || IsReshape(node) || IsSqueeze(node) ||
+           IsRecv(node) || IsControlFlow(node) || IsConcat(node) ||
+           node.op() == "ExpandDims" || node.op() == "StopGradient" ||
+           node.op() == "Snapshot";
+  }
+
+  // Rewrites a single ConcatV2 node, if eligible.  Failure to qualify
+  // is not an error: ConcatV2 is ubiquitous and most instances will not
+  // meet the layout constraints, so ineligible nodes are skipped with a
+  // VLOG rather than aborting the optimization.
+  Status RewriteOne(ScopedAllocatorOptimizer* sa_opti, int64 invocation_count,
+                    GraphDef* graph, NodeDef* nd, bool* applied) {
+    NodeMap* node_map = sa_opti->node_map();
+    if (sa_opti->IsNodePreserved(nd->name())) {
+      VLOG(2) << "Not rewriting " << nd->name() << ": preserved node";
+      return Status::OK();
+    }
+    AttrSlice n_attrs = AttrSlice(*nd);
+    DataType dtype;
+    int32 num_inputs;
+    LOG_WARNING_AND_RETURN_IF_ERROR(GetNodeAttr(n_attrs, "T", &dtype));
+    LOG_WARNING_AND_RETURN_IF_ERROR(GetNodeAttr(n_attrs, "N", &num_inputs));
+    if (num_inputs < 2 || DataTypeSize(dtype) == 0 ||
+        (Allocator::kAllocatorAlignment % DataTypeSize(dtype)) != 0 ||
+        nd->input_size() < num_inputs + 1) {
+      return Status::OK();
+    }
+    NodeDef* axis_node = node_map->GetNode(nd->input(num_inputs));
+    if (axis_node == nullptr || !IsZeroAxis(*axis_node)) {
+      VLOG(2) << "Not rewriting " << nd->name()
+              << ": axis is not a constant 0";
+      return Status::OK();
+    }
+    // The replacement _ScopedAllocatorConcat reshapes the backing tensor
+    // to the shape of the original output, which must be fully known.
+    if (!graph_properties_->HasOutputProperties(nd->name())) {
+      VLOG(2) << "Not rewriting " << nd->name() << ": no output shape";
+      return Status::OK();
+    }
+    const OpInfo::TensorProperties& output_props =
+        graph_properties_->GetOutputProperties(nd->name())[0];
+    if (output_props.shape().unknown_rank() ||
+        !TensorShape::IsValid(output_props.shape())) {
+      VLOG(2) << "Not rewriting " << nd->name() << ": output shape unknown";
+      return Status::OK();
+    }
+    TensorShape output_shape(output_props.shape());
+
+    // Gather the input edges, checking that each producer is eligible
+    // to allocate its output from a ScopedAllocator backing tensor.
+    std::vector<InputDesc> inputs;
+    std::vector<TensorShape> input_shapes;
+    std::set<string> seen_tensors;
+    for (int i = 0; i < num_inputs; ++i) {
+      int position = 0;
+      string input_node_name = ParseNodeName(nd->input(i), &position);
+      NodeDef* inode = node_map->GetNode(input_node_name);
+      if (inode == nullptr) {
+        return errors::Internal("Did not find node ", input_node_name);
+      }
+      if (inode->device() != nd->device() || MayForwardOrAliasBuffer(*inode)) {
+        VLOG(2) << "Not rewriting " << nd->name() << ": input "
+                << input_node_name
+                << " cannot allocate from a ScopedAllocator";
+        return Status::OK();
+      }
+      int32 unused;
+      if (GetNodeAttr(AttrSlice(*inode), "sa_id", &unused).ok() ||
+          HasNodeAttr(*inode, "_scoped_allocator")) {
+        VLOG(2) << "Not rewriting " << nd->name() << ": input "
+                << input_node_name
+                << " is already committed to a ScopedAllocator";
+        return Status::OK();
+      }
+      // Each input must be a distinct tensor, otherwise two fields of
+      // the backing tensor would have to alias.
+      if (!seen_tensors
+               .insert(strings::StrCat(input_node_name, ":", position))
+               .second) {
+        VLOG(2) << "Not rewriting " << nd->name() << ": duplicate input "
+                << nd->input(i);
+        return Status::OK();
+      }
+      if (!graph_properties_->HasOutputProperties(input_node_name)) {
+        VLOG(2) << "Not rewriting " << nd->name() << ": input "
+                << input_node_name << " lacks output shape";
+        return Status::OK();
+      }
+      const std::vector<OpInfo::TensorProperties>& prop_list =
+          graph_properties_->GetOutputProperties(input_node_name);
+      if (position < 0 || position >= prop_list.size()) {
+        return errors::Internal("Bad output slot on edge ", nd->input(i));
+      }
+      const OpInfo::TensorProperties& props = prop_list[position];
+      if (props.dtype() != dtype || props.shape().unknown_rank() ||
+          !TensorShape::IsValid(props.shape())) {
+        VLOG(2) << "Not rewriting " << nd->name() << ": input "
+                << input_node_name << " has wrong type or unknown shape";
+        return Status::OK();
+      }
+      TensorShape input_shape(props.shape());
+      // Fields in the backing tensor are aligned to kAllocatorAlignment.
+      // Every field except the last must exactly fill its aligned slot,
+      // otherwise the backing tensor would contain padding bytes and no
+      // longer be a dense concatenation of the inputs.
+      const int64 bytes = input_shape.num_elements() * DataTypeSize(dtype);
+      if (bytes == 0 || (i < num_inputs - 1 &&
+                         (bytes % Allocator::kAllocatorAlignment) != 0)) {
+        VLOG(2) << "Not rewriting " << nd->name() << ": input " << i
+                << " of " << bytes
+                << " bytes does not fill an aligned backing tensor slot";
+        return Status::OK();
+      }
+      input_shapes.push_back(input_shape);
+      inputs.emplace_back(inode, position, nd);
+    }
+
+    std::vector<ScopedAllocator::Field> sa_fields;
+    int64 num_bytes = ScopedAllocatorMgr::PopulateFields(
+        0 /*scope_id*/, input_shapes, dtype, &sa_fields);
+    if (num_bytes != output_shape.num_elements() * DataTypeSize(dtype)) {
+      // Defensive: the alignment checks above should make the backing
+      // tensor exactly as large as the concatenated output.
+      VLOG(2) << "Not rewriting " << nd->name() << ": backing size "
+              << num_bytes << " != output size";
+      return Status::OK();
+    }
+    TensorShape sa_shape({num_bytes / DataTypeSize(dtype)});
+
+    // Build the ScopedAllocator node and mark the producers to allocate
+    // their outputs from its backing tensor.
+    int sa_id = sa_opti->NewScopedAllocatorId(num_inputs);
+    string sa_name =
+        strings::StrCat("scoped_allocator_", sa_id, "_", invocation_count);
+    NodeDefBuilder sa_builder(sa_name, "_ScopedAllocator");
+    sa_builder.Device(nd->device());
+    sa_builder.Attr("sa_name", sa_name);
+    sa_builder.Attr("T", dtype);
+    sa_builder.Attr("id", sa_id);
+    sa_builder.Attr("shapes", input_shapes);
+    sa_builder.Attr("shape", sa_shape);
+    sa_builder.Attr("expected_call_count", static_cast<int64>(num_inputs));
+    NodeDef* sa_node = graph->add_node();
+    LOG_WARNING_AND_RETURN_IF_ERROR(sa_builder.Finalize(sa_node));
+    node_map->AddNode(sa_name, sa_node);
+    for (int i = 0; i < num_inputs; ++i) {
+      InputDesc& desc = inputs[i];
+      desc.from_node_def->add_input(strings::StrCat("^", sa_name));
+      ScopedAllocatorOptimizer::ExtendNodeAttr(
+          "_scoped_allocator", {desc.output_slot, sa_id + 1 + i},
+          desc.from_node_def);
+      node_map->AddOutput(sa_name, desc.from_node_def->name());
+    }
+
+    // Replace the ConcatV2 with a _ScopedAllocatorConcat that outputs a
+    // reshaped view of the backing tensor.
+    string sac_name = strings::StrCat("scoped_allocator_concat_", sa_id, "_",
+                                      invocation_count);
+    NodeDefBuilder sac_builder(sac_name, "_ScopedAllocatorConcat");
+    sac_builder.Device(nd->device());
+    sac_builder.Attr("sa_name", sa_name);
+    sac_builder.Attr("id", sa_id);
+    sac_builder.Attr("T", dtype);
+    sac_builder.Attr("shape", output_shape);
+    sac_builder.Attr("reshape", true);
+    sac_builder.Attr("N", num_inputs);
+    sac_builder.Input(NodeDefBuilder::NodeOut(sa_name, 0, dtype));
+    std::vector<NodeDefBuilder::NodeOut> sac_inputs;
+    for (int i = 0; i < num_inputs; ++i) {
+      sac_inputs.push_back(NodeDefBuilder::NodeOut(
+          inputs[i].from_node_def->name(), inputs[i].output_slot, dtype));
+    }
+    sac_builder.Input(sac_inputs);
+    NodeDef* sac_node = graph->add_node();
+    LOG_WARNING_AND_RETURN_IF_ERROR(sac_builder.Finalize(sac_node));
+    node_map->AddNode(sac_name, sac_node);
+    node_map->AddOutput(sa_name, sac_name);
+    for (int i = 0; i < num_inputs; ++i) {
+      node_map->AddOutput(inputs[i].from_node_def->name(), sac_name);
+    }
+    // Carry over any control inputs of the old concat node.  The axis
+    // input is dropped; if the axis constant becomes an orphan it will
+    // be removed by a later pruning pass.
+    for (int i = num_inputs + 1; i < nd->input_size(); ++i) {
+      int position = 0;
+      string ctl_node_name = ParseNodeName(nd->input(i), &position);
+      CHECK_EQ(position, -1) << "unexpected data input " << nd->input(i);
+      sac_node->add_input(nd->input(i));
+      node_map->AddOutput(ctl_node_name, sac_name);
+    }
+
+    // Redirect all consumers of the old concat node to the new view,
+    // then remove it from the graph.
+    std::set<NodeDef*> output_nodes = node_map->GetOutputs(nd->name());
+    for (NodeDef* consumer : output_nodes) {
+      for (int i = 0; i < consumer->input_size(); ++i) {
+        int position = 0;
+        string input_node_name = ParseNodeName(consumer->input(i), &position);
+        if (input_node_name != nd->name()) continue;
+        if (position == -1) {
+          *consumer->mutable_input(i) = strings::StrCat("^", sac_name);
+        } else {
+          CHECK_EQ(0, position)
+              << "name " << consumer->input(i) << " pos " << position;
+          *consumer->mutable_input(i) = strings::StrCat(sac_name, ":0");
+        }
+        node_map->AddOutput(sac_name, consumer->name());
+      }
+      node_map->RemoveOutput(nd->name(), consumer->name());
+    }
+    node_map->RemoveInputs(nd->name());
+    nd->clear_input();
+    node_map->RemoveOutputs(nd->name());
+    RemoveNode(nd, graph, node_map);
+
+    VLOG(1) << "Rewrote " << sac_name << " over " << num_inputs
+            << " inputs replacing ConcatV2";
+    *applied = true;
+    return Status::OK();
+  }
+};
+
 ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
     RewriterConfig::Toggle opt_level, const ScopedAllocatorOptions& opts)
-    : opt_level_(opt_level) {
+    : opt_level_(opt_level), max_bytes_per_group_(opts.max_bytes_per_group()) {
   VLOG(1) << "ScopedAllocatorOptimizer::ScopedAllocatorOptimizer";
   Rewriter* r = new UnaryElementwiseRewriter();
   to_delete_.push_back(r);
+  Rewriter* concat_rewriter = new ConcatRewriter();
+  to_delete_.push_back(concat_rewriter);
   if (opts.enable_op_size() == 0) {
     // Opts handled by default:
     for (const auto& op_name : {"CollectiveReduce"}) {
       op_name_set_.insert(op_name);
       rewriters_[op_name] = r;
     }
+    // Gradient packing concats are also handled by default: a ConcatV2
+    // whose inputs can all be laid out in one backing allocation becomes
+    // a zero-copy view of that allocation.
+    op_name_set_.insert("ConcatV2");
+    rewriters_["ConcatV2"] = concat_rewriter;
   } else {
     for (const auto& op_name : opts.enable_op()) {
       op_name_set_.insert(op_name);
-      rewriters_[op_name] = r;
+      rewriters_[op_name] =
+          (op_name == "ConcatV2") ? concat_rewriter : r;
     }
   }
 }
@@ -879,6 +1166,50 @@ void PartitionByLoopStructure(const FrameView& frame_view,
   }
 }
 
+// Returns the size in bytes of the single output of node n, or -1 if the
+// type or shape is not fully known.
+int64 OutputBytes(const GraphProperties& graph_properties, const NodeDef& n) {
+  DataType dtype;
+  if (!GetNodeAttr(AttrSlice(n), "T", &dtype).ok()) return -1;
+  if (!graph_properties.HasOutputProperties(n.name())) return -1;
+  const std::vector<OpInfo::TensorProperties>& prop_list =
+      graph_properties.GetOutputProperties(n.name());
+  if (prop_list.size() != 1) return -1;
+  const TensorShapeProto& shape = prop_list[0].shape();
+  if (!TensorShape::IsValid(shape) || shape.unknown_rank()) return -1;
+  return TensorShape(shape).num_elements() * DataTypeSize(dtype);
+}
+
+// Splits an ordered set of fusible nodes into consecutive groups whose
+// total output size is approximately max_bytes.  Since each group becomes
+// one fused op, capping the group size lets the first fused op (e.g. a
+// collective over the first bucket of gradients) launch as soon as its own
+// inputs are ready rather than waiting for the entire set to be produced.
+// A single node larger than max_bytes gets a group by itself.  If any node
+// lacks complete shape data the nodes are left in one group; the rewriter
+// will detect that and leave the graph unchanged.
+void PartitionBySize(const GraphProperties& graph_properties, int64 max_bytes,
+                     std::vector<NodeDef*> nodes,
+                     std::vector<std::vector<NodeDef*>>* size_groups) {
+  std::vector<std::vector<NodeDef*>> groups;
+  int64 group_bytes = 0;
+  for (NodeDef* nd : nodes) {
+    int64 bytes = OutputBytes(graph_properties, *nd);
+    if (bytes < 0) {
+      size_groups->clear();
+      size_groups->push_back(std::move(nodes));
+      return;
+    }
+    if (groups.empty() || (group_bytes > 0 && group_bytes + bytes > max_bytes)) {
+      groups.push_back({});
+      group_bytes = 0;
+    }
+    groups.back().push_back(nd);
+    group_bytes += bytes;
+  }
+  *size_groups = std::move(groups);
+}
+
 }  // namespace
 
 Status ScopedAllocatorOptimizer::ProcessGraphDef(
@@ -917,21 +1248,37 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
         // in the same Tree struct.  Split those groups into subgroups that
         // share identical loop nesting.
         status = ApplyToAll(root.get(), [this, rewriter, graph, &frame_view,
-                                         &op_name, invocation_count](Tree* t) {
+                                         &graph_properties, &op_name,
+                                         invocation_count](Tree* t) {
           VLOG(2) << "applied to tree node " << t->edge_ << " at depth "
                   << t->depth_ << " of size " << t->nodes_.size();
-          if (t->nodes_.size() > 1) {
+          if (t->nodes_.size() > 1 ||
+              (rewriter->RewritesSingleInstance() && !t->nodes_.empty())) {
             std::vector<std::vector<NodeDef*>> loop_groups;
             PartitionByLoopStructure(frame_view, t->nodes_, &loop_groups);
             for (auto& lg : loop_groups) {
-              if (lg.size() > 1) {
-                bool applied = false;
+              if (lg.size() > 1 || rewriter->RewritesSingleInstance()) {
                 Status s = OrderNodeSet(&lg);
                 TF_RETURN_IF_ERROR(s);
-                VLOG(1) << "Applying Rewriter for " << op_name;
-                s = rewriter->Rewrite(this, invocation_count, graph, op_name,
-                                      lg, &applied);
-                LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                // Optionally cap the byte size of each fusion group so the
+                // fused ops can execute incrementally as their inputs become
+                // ready.
+                std::vector<std::vector<NodeDef*>> size_groups;
+                if (max_bytes_per_group_ > 0) {
+                  PartitionBySize(graph_properties, max_bytes_per_group_,
+                                  std::move(lg), &size_groups);
+                } else {
+                  size_groups.push_back(std::move(lg));
+                }
+                for (auto& sg : size_groups) {
+                  if (sg.size() > 1 || rewriter->RewritesSingleInstance()) {
+                    bool applied = false;
+                    VLOG(1) << "Applying Rewriter for " << op_name;
+                    s = rewriter->Rewrite(this, invocation_count, graph,
+                                          op_name, sg, &applied);
+                    LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                  }
+                }
               }
             }
           }
@@ -70,6 +70,12 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
 
   NodeMap* node_map() { return node_map_.get(); }
 
+  // Returns true if node_name must not be removed from the graph, e.g.
+  // because it is a fetch node.
+  bool IsNodePreserved(const string& node_name) const {
+    return nodes_to_preserve_.find(node_name) != nodes_to_preserve_.end();
+  }
+
   // Appends values to the attr value under name in node_def, if present.
   // If not present does an assignment.
   static void ExtendNodeAttr(StringPiece name, const std::vector<int32>& values,
@@ -87,6 +93,11 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
                            const std::vector<NodeDef*>& nodes,
                            bool* applied) = 0;
 
+    // If true, Rewrite may be called on a single instance of the Op.
+    // Otherwise it is only called on groups of two or more parallel
+    // instances.
+    virtual bool RewritesSingleInstance() const { return false; }
+
     void SetGraphProperties(const GraphProperties& graph_properties) {
       graph_properties_ = &graph_properties;
       CHECK(graph_properties_);
@@ -102,6 +113,10 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
   Status OrderNodeSet(std::vector<NodeDef*>* nodes) const;
 
   RewriterConfig::Toggle opt_level_;
+  // If > 0, fusion groups are split into consecutive subgroups of at most
+  // this many bytes of op output, so that each fused op can launch as soon
+  // as its own inputs are ready.  See ScopedAllocatorOptions.
+  int64 max_bytes_per_group_;
   std::unordered_set<string> nodes_to_preserve_;
   OpNameSet op_name_set_;
   std::unordered_map<string, Rewriter*> rewriters_;
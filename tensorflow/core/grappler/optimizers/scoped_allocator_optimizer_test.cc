@@ -104,6 +104,62 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
     TF_CHECK_OK(s.ToGraphDef(graph_def));
   }
 
+  // Constructs a graph with four parallel Abs ops, each with its own
+  // input and Reshape consumer.  Used for testing size-capped fusion
+  // groups: each Abs output is a 2x2 float, i.e. 16 bytes.
+  void BuildFourAbsGraph(GraphDef* graph_def) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    s = s.WithDevice("/job:localhost/replica:0/task:0/device:CPU:0");
+
+    Output a =
+        ops::Const<float>(s.WithOpName("a"), {1.0, 0.0, 0.0, -1.0}, {2, 2});
+    Output b =
+        ops::Const<float>(s.WithOpName("b"), {1.0, -2.0, 3.0, 4.0}, {2, 2});
+    Output c =
+        ops::Const<float>(s.WithOpName("c"), {-5.0, -2.0, 0.0, -2.0}, {2, 2});
+    Output d =
+        ops::Const<float>(s.WithOpName("d"), {2.0, 1.0, -1.0, 0.0}, {2, 2});
+    Output a1 = ops::Abs(s.WithOpName("a1"), ops::Add(s.WithOpName("s1"), a, b));
+    Output a2 = ops::Abs(s.WithOpName("a2"), ops::Add(s.WithOpName("s2"), b, c));
+    Output a3 = ops::Abs(s.WithOpName("a3"), ops::Add(s.WithOpName("s3"), c, d));
+    Output a4 = ops::Abs(s.WithOpName("a4"), ops::Add(s.WithOpName("s4"), d, a));
+    Output r1 = ops::Reshape(s.WithOpName("r1"), a1, {1, 4});
+    Output r2 = ops::Reshape(s.WithOpName("r2"), a2, {4, 1});
+    Output r3 = ops::Reshape(s.WithOpName("r3"), a3, {1, 4});
+    Output r4 = ops::Reshape(s.WithOpName("r4"), a4, {4, 1});
+    TF_CHECK_OK(s.ToGraphDef(graph_def));
+  }
+
+  // Constructs the following graph.
+  //
+  // The intended optimization is to have s1 and s2 allocate from a new
+  // ScopedAllocator, then replace the concat with a zero-copy view of
+  // the backing tensor.
+  /*
+        a    b    c
+         \  / \  /
+          s1   s2
+           \   /
+          concat
+            |
+           out
+  */
+  void BuildConcatGraph(GraphDef* graph_def) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    s = s.WithDevice("/job:localhost/replica:0/task:0/device:CPU:0");
+
+    // 16 floats == 64 bytes, so each input exactly fills an aligned
+    // slot of the backing tensor.
+    Output a = ops::Const<float>(s.WithOpName("a"), 1.0, {4, 4});
+    Output b = ops::Const<float>(s.WithOpName("b"), 2.0, {4, 4});
+    Output c = ops::Const<float>(s.WithOpName("c"), 3.0, {4, 4});
+    Output s1 = ops::Add(s.WithOpName("s1"), a, b);
+    Output s2 = ops::Add(s.WithOpName("s2"), b, c);
+    Output concat = ops::Concat(s.WithOpName("concat"), {s1, s2}, 0);
+    Output out = ops::Identity(s.WithOpName("out"), concat);
+    TF_CHECK_OK(s.ToGraphDef(graph_def));
+  }
+
   void SetShapes(GraphDef* graph_def) {
     TensorShapeProto shape_proto;
     shape_proto.add_dim()->set_size(2);
@@ -239,6 +295,129 @@ TEST_F(ScopedAllocatorOptimizerTest, UnaryExecute) {
   ValidateValues(outputs, expected_r1, expected_r2);
 }
 
+TEST_F(ScopedAllocatorOptimizerTest, SizeCappedGroups) {
+  // Tests that max_bytes_per_group splits a fusible set into consecutive
+  // subgroups: four 16-byte Abs outputs with a 32 byte cap should produce
+  // two fused groups of two, {a1, a2} and {a3, a4}, instead of one group
+  // of four.
+  GrapplerItem item;
+  BuildFourAbsGraph(&item.graph);
+  SetShapes(&item.graph);
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("Abs");
+  opts.set_max_bytes_per_group(32);
+  ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+
+  GraphDef optimized_graph;
+  TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+
+  // Collect the data inputs of every _ScopedAllocatorConcat node; input 0
+  // is the backing tensor reference.
+  std::vector<std::unordered_set<string>> group_inputs;
+  for (const NodeDef& n : optimized_graph.node()) {
+    if (n.op() == "_ScopedAllocatorConcat") {
+      std::unordered_set<string> inputs;
+      for (int i = 1; i < n.input_size(); ++i) {
+        inputs.insert(n.input(i));
+      }
+      group_inputs.push_back(std::move(inputs));
+    }
+  }
+  ASSERT_EQ(2, group_inputs.size());
+  for (const auto& inputs : group_inputs) {
+    EXPECT_EQ(2, inputs.size());
+    // Nodes are ordered by name before grouping, so each group covers a
+    // consecutive pair.
+    if (inputs.find("a1") != inputs.end()) {
+      EXPECT_NE(inputs.find("a2"), inputs.end());
+    } else {
+      EXPECT_NE(inputs.find("a3"), inputs.end());
+      EXPECT_NE(inputs.find("a4"), inputs.end());
+    }
+  }
+}
+
+TEST_F(ScopedAllocatorOptimizerTest, ConcatRewriteOnly) {
+  // Tests that a ConcatV2 over aligned same-typed tensors is replaced
+  // with a zero-copy view of a ScopedAllocator backing tensor.
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph);
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("ConcatV2");
+  ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+
+  GraphDef optimized_graph;
+  TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+
+  // Examine the resulting graph def.  The generated node names include a
+  // process-wide invocation count, so find the new nodes by op.
+  NodeMap node_map(&optimized_graph);
+  NodeDef* sa_node = nullptr;
+  NodeDef* sac_node = nullptr;
+  for (NodeDef& n : *optimized_graph.mutable_node()) {
+    if (n.op() == "_ScopedAllocator") {
+      sa_node = &n;
+    } else if (n.op() == "_ScopedAllocatorConcat") {
+      sac_node = &n;
+    } else {
+      EXPECT_NE(n.name(), "concat");
+    }
+  }
+  ASSERT_TRUE(sa_node);
+  ASSERT_TRUE(sac_node);
+  {
+    auto& nd_set = node_map.GetOutputs(sa_node->name());
+    ASSERT_EQ(3, nd_set.size());
+    std::unordered_set<string> expected = {sac_node->name(), "s1", "s2"};
+    for (auto it : nd_set) {
+      ASSERT_NE(expected.find(it->name()), expected.end())
+          << "Failed to find " << it->name();
+    }
+  }
+  {
+    auto& nd_set = node_map.GetOutputs(sac_node->name());
+    ASSERT_EQ(1, nd_set.size());
+    for (auto it : nd_set) {
+      ASSERT_EQ("out", it->name());
+    }
+  }
+}
+
+TEST_F(ScopedAllocatorOptimizerTest, ConcatExecute) {
+  // Builds the same graph as ConcatRewriteOnly but also executes it and
+  // validates that the backing tensor view matches the concatenation.
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph);
+
+  ConfigProto config;
+  GraphOptions* gopt = config.mutable_graph_options();
+  OptimizerOptions* opts = gopt->mutable_optimizer_options();
+  opts->set_do_common_subexpression_elimination(false);
+  opts->set_do_constant_folding(false);
+  opts->set_do_function_inlining(false);
+  opts->set_opt_level(OptimizerOptions::L0);
+  RewriterConfig* rwcfg = gopt->mutable_rewrite_options();
+  rwcfg->clear_optimizers();
+  (*rwcfg->add_optimizers()) = "scoped_allocator";
+  rwcfg->mutable_scoped_allocator_opts()->add_enable_op("ConcatV2");
+  std::unique_ptr<Session> session(CreateSession(item.graph, config));
+
+  std::vector<string> output_names = {"out:0"};
+  std::vector<std::pair<string, Tensor>> inputs;
+  std::vector<string> target_nodes = {};
+  std::vector<Tensor> outputs;
+  Status s = session->Run(inputs, output_names, target_nodes, &outputs);
+  TF_ASSERT_OK(s);
+  ASSERT_EQ(1, outputs.size());
+  // s1 == 16 x 3, s2 == 16 x 5.
+  ASSERT_EQ(32, outputs[0].NumElements());
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_EQ(i < 16 ? 3.0 : 5.0, outputs[0].flat<float>()(i));
+  }
+}
+
 // Tests static ScopedAllocatorOptimizer::ExtendNodeAttr.
 // Maybe this should be moved elsewhere?
 TEST_F(ScopedAllocatorOptimizerTest, Extend) {
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/split_lib.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/macros.h"
 
@@ -241,9 +242,15 @@ class BatchResource : public ResourceBase {
 
   // Ingests data from one invocation of the batch op. The data is enqueued to
   // be combined with others into a batch, asynchronously.
+  //
+  // If 'bucketize_by_shape' is true, the batcher queue name is additionally
+  // keyed on the non-batch dimensions of the input tensors, so that only
+  // invocations with matching shapes are batched together and concatenating
+  // them requires no padding.
   Status RegisterInput(int64 guid, OpKernelContext* context,
                        const string& batcher_queue_name,
-                       AsyncOpKernel::DoneCallback done_callback) {
+                       AsyncOpKernel::DoneCallback done_callback,
+                       bool bucketize_by_shape = false) {
     std::unique_ptr<BatchTask> batch_components(new BatchTask);
     batch_components->guid = guid;
     batch_components->propagated_context = Context(ContextKind::kThread);
@@ -274,9 +281,20 @@ class BatchResource : public ResourceBase {
     batch_components->context = context;
     batch_components->done_callback = std::move(done_callback);
 
+    string batcher_queue_key = batcher_queue_name;
+    if (bucketize_by_shape) {
+      for (const Tensor& tensor : batch_components->inputs) {
+        strings::StrAppend(&batcher_queue_key, "/");
+        for (int d = 1; d < tensor.shape().dims(); ++d) {
+          strings::StrAppend(&batcher_queue_key, tensor.shape().dim_size(d),
+                             "x");
+        }
+      }
+    }
+
     BatcherQueue* batcher_queue;
     TF_RETURN_IF_ERROR(
-        LookupOrCreateBatcherQueue(batcher_queue_name, &batcher_queue));
+        LookupOrCreateBatcherQueue(batcher_queue_key, &batcher_queue));
     return batcher_queue->Schedule(&batch_components);
   }
 
@@ -719,6 +737,7 @@ class BatchFunctionKernel : public AsyncOpKernel {
     OP_REQUIRES_OK(c,
                    c->GetAttr("max_enqueued_batches", &max_enqueued_batches_));
     OP_REQUIRES_OK(c, c->GetAttr("allowed_batch_sizes", &allowed_batch_sizes_));
+    OP_REQUIRES_OK(c, c->GetAttr("bucketize_by_shape", &bucketize_by_shape_));
     OP_REQUIRES_OK(c, ValidateAllowedBatchSizes());
 
     auto lib = c->function_library();
@@ -746,8 +765,8 @@ class BatchFunctionKernel : public AsyncOpKernel {
                          c->resource_manager()->LookupOrCreate(
                              container_, shared_name_, &br, creator),
                          done);
-    const Status status =
-        br->RegisterInput(random::New64(), c, batcher_queue_, done);
+    const Status status = br->RegisterInput(random::New64(), c, batcher_queue_,
+                                            done, bucketize_by_shape_);
     br->Unref();
     OP_REQUIRES_OK_ASYNC(c, status, done);
     // Assume br calls done, so nothing to do here.
@@ -779,6 +798,7 @@ class BatchFunctionKernel : public AsyncOpKernel {
   string container_;
   string shared_name_;
   string batcher_queue_;
+  bool bucketize_by_shape_;
   int32 num_batch_threads_;
   int32 max_batch_size_;
   int32 batch_timeout_micros_;
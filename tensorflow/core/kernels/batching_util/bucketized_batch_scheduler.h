@@ -0,0 +1,260 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BUCKETIZED_BATCH_SCHEDULER_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BUCKETIZED_BATCH_SCHEDULER_H_
+
+#include <stddef.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace serving {
+
+// A BatchScheduler implementation that partitions tasks into "buckets" and
+// only forms batches from tasks belonging to the same bucket. Each task is
+// assigned a bucket via a caller-supplied key function; tasks with equal keys
+// may be combined into a batch, while tasks with differing keys never are.
+//
+// The motivating use-case is batching of requests whose tensors have varying
+// non-batch dimensions (e.g. variable sequence lengths). A plain
+// BasicBatchScheduler groups such requests arbitrarily, forcing the
+// process-batch callback to pad every member up to the largest member, which
+// wastes compute on the padding. By deriving the bucket key from the tensor
+// shapes (possibly quantized, e.g. sequence length rounded up to a multiple
+// of 32), each batch is shape-homogeneous (or nearly so) and padding waste is
+// bounded by the quantization.
+//
+// Internally, each bucket maps to one queue of a SharedBatchScheduler, so all
+// buckets share a single pool of batch threads and the scheduling behavior of
+// each bucket matches that of a BasicBatchScheduler with the bucket's
+// parameters. Buckets are created lazily the first time a task keyed to them
+// is scheduled, and per-bucket batching parameters may be overridden via
+// Options::bucket_options (e.g. a longer timeout for rare shapes).
+//
+// The process-batch callback receives the bucket key alongside the batch, so
+// it knows the shape class it is processing without inspecting the tasks. If
+// sub-max-size batches from several buckets must occasionally be merged to
+// keep the hardware busy under low load, that merging (and the attendant
+// padding) is the callback's decision to make; the scheduler itself never
+// mixes buckets within a batch.
+template <typename TaskType>
+class BucketizedBatchScheduler : public BatchScheduler<TaskType> {
+ public:
+  // Batching parameters for one bucket. These have the same semantics as the
+  // corresponding fields of BasicBatchScheduler::Options.
+  struct BucketOptions {
+    // The maximum size of each batch formed from this bucket's tasks.
+    int max_batch_size = 1000;
+
+    // If a task has been enqueued for this amount of time (in microseconds),
+    // and a thread is available, the scheduler processes the bucket's open
+    // batch even if it is below 'max_batch_size'.
+    int64 batch_timeout_micros = 0;
+
+    // The maximum allowable number of enqueued (accepted by Schedule() but
+    // not yet being processed on a batch thread) tasks, in terms of batches,
+    // per bucket. If this limit is reached, Schedule() returns an UNAVAILABLE
+    // error for tasks keyed to the affected bucket.
+    int max_enqueued_batches = 10;
+  };
+
+  struct Options {
+    // Maps a task to the key of the bucket it must be batched in. Must be
+    // set, and must be thread-safe. Typically derived from the task's tensor
+    // shapes, excluding the batch (zeroth) dimension.
+    std::function<string(const TaskType&)> bucket_key_fn;
+
+    // Batching parameters applied to buckets with no entry in
+    // 'bucket_options'.
+    BucketOptions default_bucket_options;
+
+    // Per-bucket parameter overrides, keyed by bucket key.
+    std::map<string, BucketOptions> bucket_options;
+
+    // The name to use for the pool of batch threads, shared by all buckets.
+    string thread_pool_name = {"bucketized_batch_threads"};
+
+    // The number of threads to use to process batches, shared by all buckets.
+    // Must be >= 1, and should be tuned carefully.
+    int num_batch_threads = port::NumSchedulableCPUs();
+
+    // The following options are typically only overridden by test code.
+
+    // The environment to use.
+    Env* env = Env::Default();
+  };
+
+  // The process-batch callback. Invoked on a batch thread with the key of the
+  // bucket the batch was formed from; every task in 'batch' has that key.
+  using ProcessBatchCallback = std::function<void(
+      const string& bucket_key, std::unique_ptr<Batch<TaskType>>)>;
+
+  static Status Create(const Options& options,
+                       ProcessBatchCallback process_batch_callback,
+                       std::unique_ptr<BucketizedBatchScheduler>* scheduler);
+
+  ~BucketizedBatchScheduler() override = default;
+
+  // Routes 'task' to the queue of the bucket given by
+  // 'options.bucket_key_fn', creating that bucket's queue if this is the
+  // first task keyed to it.
+  Status Schedule(std::unique_ptr<TaskType>* task) override;
+
+  // Returns the number of enqueued tasks, summed across all buckets.
+  size_t NumEnqueuedTasks() const override;
+
+  // Returns the scheduling capacity, summed across the buckets created so
+  // far. (A task keyed to a not-yet-created bucket sees that bucket's full
+  // capacity, which is not reflected here.)
+  size_t SchedulingCapacity() const override;
+
+  // Returns the maximum task size of the default bucket options. Individual
+  // buckets with overridden options may reject larger or accept smaller
+  // tasks.
+  size_t max_task_size() const override {
+    return options_.default_bucket_options.max_batch_size;
+  }
+
+ private:
+  BucketizedBatchScheduler(
+      const Options& options, ProcessBatchCallback process_batch_callback,
+      std::shared_ptr<SharedBatchScheduler<TaskType>> shared_scheduler);
+
+  // Looks up the queue for 'bucket_key', adding a queue to
+  // 'shared_scheduler_' with the bucket's options if none exists yet.
+  Status LookupOrCreateBucketQueue(const string& bucket_key,
+                                   BatchScheduler<TaskType>** queue);
+
+  const Options options_;
+  const ProcessBatchCallback process_batch_callback_;
+
+  // The underlying scheduler, on which each bucket owns one queue.
+  std::shared_ptr<SharedBatchScheduler<TaskType>> shared_scheduler_;
+
+  mutable mutex mu_;
+
+  // The per-bucket queues, keyed by bucket key.
+  std::map<string, std::unique_ptr<BatchScheduler<TaskType>>> bucket_queues_
+      GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(BucketizedBatchScheduler);
+};
+
+//////////
+// Implementation details follow. API users need not read.
+
+template <typename TaskType>
+Status BucketizedBatchScheduler<TaskType>::Create(
+    const Options& options, ProcessBatchCallback process_batch_callback,
+    std::unique_ptr<BucketizedBatchScheduler>* scheduler) {
+  if (options.bucket_key_fn == nullptr) {
+    return errors::InvalidArgument("bucket_key_fn must be set");
+  }
+  typename SharedBatchScheduler<TaskType>::Options shared_scheduler_options;
+  shared_scheduler_options.thread_pool_name = options.thread_pool_name;
+  shared_scheduler_options.num_batch_threads = options.num_batch_threads;
+  shared_scheduler_options.env = options.env;
+  std::shared_ptr<SharedBatchScheduler<TaskType>> shared_scheduler;
+  TF_RETURN_IF_ERROR(SharedBatchScheduler<TaskType>::Create(
+      shared_scheduler_options, &shared_scheduler));
+
+  scheduler->reset(new BucketizedBatchScheduler<TaskType>(
+      options, std::move(process_batch_callback), std::move(shared_scheduler)));
+  return Status::OK();
+}
+
+template <typename TaskType>
+Status BucketizedBatchScheduler<TaskType>::Schedule(
+    std::unique_ptr<TaskType>* task) {
+  const string bucket_key = options_.bucket_key_fn(**task);
+  BatchScheduler<TaskType>* bucket_queue;
+  TF_RETURN_IF_ERROR(LookupOrCreateBucketQueue(bucket_key, &bucket_queue));
+  return bucket_queue->Schedule(task);
+}
+
+template <typename TaskType>
+size_t BucketizedBatchScheduler<TaskType>::NumEnqueuedTasks() const {
+  size_t num_enqueued_tasks = 0;
+  mutex_lock l(mu_);
+  for (const auto& entry : bucket_queues_) {
+    num_enqueued_tasks += entry.second->NumEnqueuedTasks();
+  }
+  return num_enqueued_tasks;
+}
+
+template <typename TaskType>
+size_t BucketizedBatchScheduler<TaskType>::SchedulingCapacity() const {
+  size_t scheduling_capacity = 0;
+  mutex_lock l(mu_);
+  for (const auto& entry : bucket_queues_) {
+    scheduling_capacity += entry.second->SchedulingCapacity();
+  }
+  return scheduling_capacity;
+}
+
+template <typename TaskType>
+BucketizedBatchScheduler<TaskType>::BucketizedBatchScheduler(
+    const Options& options, ProcessBatchCallback process_batch_callback,
+    std::shared_ptr<SharedBatchScheduler<TaskType>> shared_scheduler)
+    : options_(options),
+      process_batch_callback_(std::move(process_batch_callback)),
+      shared_scheduler_(std::move(shared_scheduler)) {}
+
+template <typename TaskType>
+Status BucketizedBatchScheduler<TaskType>::LookupOrCreateBucketQueue(
+    const string& bucket_key, BatchScheduler<TaskType>** queue) {
+  mutex_lock l(mu_);
+  const auto it = bucket_queues_.find(bucket_key);
+  if (it != bucket_queues_.end()) {
+    *queue = it->second.get();
+    return Status::OK();
+  }
+
+  const auto options_it = options_.bucket_options.find(bucket_key);
+  const BucketOptions& bucket_options =
+      options_it != options_.bucket_options.end()
+          ? options_it->second
+          : options_.default_bucket_options;
+  typename SharedBatchScheduler<TaskType>::QueueOptions queue_options;
+  queue_options.max_batch_size = bucket_options.max_batch_size;
+  queue_options.batch_timeout_micros = bucket_options.batch_timeout_micros;
+  queue_options.max_enqueued_batches = bucket_options.max_enqueued_batches;
+  std::unique_ptr<BatchScheduler<TaskType>> new_queue;
+  auto process_batch_callback = process_batch_callback_;
+  TF_RETURN_IF_ERROR(shared_scheduler_->AddQueue(
+      queue_options,
+      [bucket_key, process_batch_callback](
+          std::unique_ptr<Batch<TaskType>> batch) {
+        process_batch_callback(bucket_key, std::move(batch));
+      },
+      &new_queue));
+  *queue = new_queue.get();
+  bucket_queues_[bucket_key] = std::move(new_queue);
+  return Status::OK();
+}
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BUCKETIZED_BATCH_SCHEDULER_H_
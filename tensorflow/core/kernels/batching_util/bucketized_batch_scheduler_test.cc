@@ -0,0 +1,168 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/bucketized_batch_scheduler.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// A task with a size and a "shape" from which its bucket key is derived.
+class FakeShapedTask : public BatchTask {
+ public:
+  FakeShapedTask(size_t size, int shape) : size_(size), shape_(shape) {}
+
+  ~FakeShapedTask() override = default;
+
+  size_t size() const override { return size_; }
+
+  int shape() const { return shape_; }
+
+ private:
+  const size_t size_;
+  const int shape_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FakeShapedTask);
+};
+
+// Creates a FakeShapedTask of size 'task_size' and shape 'shape', and calls
+// 'scheduler->Schedule()' on that task. Returns the resulting status.
+Status ScheduleTask(size_t task_size, int shape,
+                    BatchScheduler<FakeShapedTask>* scheduler) {
+  std::unique_ptr<FakeShapedTask> task(new FakeShapedTask(task_size, shape));
+  Status status = scheduler->Schedule(&task);
+  // Schedule() should have consumed 'task' iff it returned Status::OK.
+  CHECK_EQ(status.ok(), task == nullptr);
+  return status;
+}
+
+// Since the per-bucket queues are SharedBatchScheduler queues, we only test
+// the bucket routing here. The queue behavior is covered by
+// shared_batch_scheduler_test.cc.
+
+TEST(BucketizedBatchSchedulerTest, BatchesAreShapeHomogeneous) {
+  mutex mu;
+  std::map<string, std::vector<int>> shapes_per_bucket;
+  int num_batches = 0;
+  Notification all_batches_processed;
+  auto callback = [&](const string& bucket_key,
+                      std::unique_ptr<Batch<FakeShapedTask>> batch) {
+    ASSERT_TRUE(batch->IsClosed());
+    mutex_lock l(mu);
+    for (int i = 0; i < batch->num_tasks(); ++i) {
+      shapes_per_bucket[bucket_key].push_back(batch->task(i).shape());
+    }
+    ++num_batches;
+    if (num_batches == 2) {
+      all_batches_processed.Notify();
+    }
+  };
+
+  BucketizedBatchScheduler<FakeShapedTask>::Options options;
+  options.bucket_key_fn = [](const FakeShapedTask& task) {
+    return strings::StrCat(task.shape());
+  };
+  options.default_bucket_options.max_batch_size = 10;
+  options.default_bucket_options.batch_timeout_micros =
+      100 * 1000;  // 100 milliseconds
+  options.num_batch_threads = 2;
+  std::unique_ptr<BucketizedBatchScheduler<FakeShapedTask>> scheduler;
+  TF_ASSERT_OK(BucketizedBatchScheduler<FakeShapedTask>::Create(
+      options, callback, &scheduler));
+
+  // Interleave tasks of two shapes; each shape should come back in its own
+  // batch.
+  TF_ASSERT_OK(ScheduleTask(3, /*shape=*/32, scheduler.get()));
+  TF_ASSERT_OK(ScheduleTask(2, /*shape=*/64, scheduler.get()));
+  TF_ASSERT_OK(ScheduleTask(5, /*shape=*/32, scheduler.get()));
+  TF_ASSERT_OK(ScheduleTask(4, /*shape=*/64, scheduler.get()));
+  EXPECT_EQ(4, scheduler->NumEnqueuedTasks());
+
+  all_batches_processed.WaitForNotification();
+  mutex_lock l(mu);
+  EXPECT_EQ((std::vector<int>{32, 32}), shapes_per_bucket["32"]);
+  EXPECT_EQ((std::vector<int>{64, 64}), shapes_per_bucket["64"]);
+}
+
+TEST(BucketizedBatchSchedulerTest, PerBucketOptionsOverrideDefaults) {
+  mutex mu;
+  std::vector<std::pair<string, int>> batches;  // (bucket key, num tasks)
+  Notification first_batch_processed;
+  auto callback = [&](const string& bucket_key,
+                      std::unique_ptr<Batch<FakeShapedTask>> batch) {
+    mutex_lock l(mu);
+    batches.push_back({bucket_key, batch->num_tasks()});
+    if (batches.size() == 1) {
+      first_batch_processed.Notify();
+    }
+  };
+
+  BucketizedBatchScheduler<FakeShapedTask>::Options options;
+  options.bucket_key_fn = [](const FakeShapedTask& task) {
+    return strings::StrCat(task.shape());
+  };
+  // A long default timeout, but bucket "32" fills at two tasks.
+  options.default_bucket_options.max_batch_size = 10;
+  options.default_bucket_options.batch_timeout_micros = 60 * 1000 * 1000;
+  options.bucket_options["32"].max_batch_size = 2;
+  options.num_batch_threads = 1;
+  std::unique_ptr<BucketizedBatchScheduler<FakeShapedTask>> scheduler;
+  TF_ASSERT_OK(BucketizedBatchScheduler<FakeShapedTask>::Create(
+      options, callback, &scheduler));
+
+  TF_ASSERT_OK(ScheduleTask(1, /*shape=*/64, scheduler.get()));
+  TF_ASSERT_OK(ScheduleTask(1, /*shape=*/32, scheduler.get()));
+  TF_ASSERT_OK(ScheduleTask(1, /*shape=*/32, scheduler.get()));
+
+  // Bucket "32" reached its overridden max batch size and gets processed;
+  // bucket "64" is still waiting out its timeout.
+  first_batch_processed.WaitForNotification();
+  {
+    mutex_lock l(mu);
+    ASSERT_EQ(1, batches.size());
+    EXPECT_EQ("32", batches[0].first);
+    EXPECT_EQ(2, batches[0].second);
+  }
+  EXPECT_EQ(1, scheduler->NumEnqueuedTasks());
+}
+
+TEST(BucketizedBatchSchedulerTest, MissingBucketKeyFnFailsCreate) {
+  BucketizedBatchScheduler<FakeShapedTask>::Options options;
+  std::unique_ptr<BucketizedBatchScheduler<FakeShapedTask>> scheduler;
+  const Status status = BucketizedBatchScheduler<FakeShapedTask>::Create(
+      options,
+      [](const string& bucket_key,
+         std::unique_ptr<Batch<FakeShapedTask>> batch) {},
+      &scheduler);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(error::INVALID_ARGUMENT, status.code());
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
@@ -17,11 +17,13 @@ limitations under the License.
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_SHARED_BATCH_SCHEDULER_H_
 
 #include <stddef.h>
+#include <algorithm>
 #include <deque>
 #include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -158,6 +160,22 @@ class SharedBatchScheduler
     // See the class documentation above for guidelines on how to tune this
     // parameter.
     size_t max_enqueued_batches = 10;
+
+    // If positive, enables closed-loop adaptation of the two batching
+    // parameters above against this latency objective (in microseconds).
+    //
+    // The queue tracks the end-to-end latency of every processed batch: the
+    // time from the batch receiving its first task until the process-batch
+    // callback returns. After each window of processed batches, if the worst
+    // latency in the window exceeded the objective, the effective maximum
+    // batch size and timeout are halved (favoring latency); otherwise they
+    // are nudged back up by 1/16th of their configured values (favoring
+    // throughput). 'max_batch_size' and 'batch_timeout_micros' always remain
+    // upper bounds on the adapted values.
+    //
+    // Adaptation is per queue, so co-served task types settle on independent
+    // operating points. Leave as 0 to keep the static parameters.
+    int64 latency_slo_micros = 0;
   };
   Status AddQueue(const QueueOptions& options,
                   std::function<void(std::unique_ptr<Batch<TaskType>>)>
@@ -274,9 +292,20 @@ class Queue {
   }
 
  private:
+  // The number of processed batches over which tail latency is observed
+  // before the effective parameters are re-evaluated, when
+  // 'options_.latency_slo_micros' is positive.
+  static constexpr int64 kSloAdaptationWindowNumBatches = 16;
+
   // Same as IsEmpty(), but assumes the caller already holds a lock on 'mu_'.
   bool IsEmptyInternal() const EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Feeds one processed batch's end-to-end latency into the adaptation
+  // window, and adjusts the effective batching parameters at window
+  // boundaries. Only called when 'options_.latency_slo_micros' is positive.
+  void RecordBatchLatencyAndMaybeAdapt(uint64 latency_micros)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Closes the open batch residing at the back of 'batches_', and inserts a
   // fresh open batch behind it.
   void StartNewBatch() EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -326,6 +355,23 @@ class Queue {
   // 'empty_notification_' is non-null it calls 'empty_notification_->Notify()'.
   Notification* empty_notification_ GUARDED_BY(mu_) = nullptr;
 
+  // The effective batching parameters: equal to the configured ones unless
+  // 'options_.latency_slo_micros' is positive, in which case they are adapted
+  // within [1, options_.max_batch_size] and [0, options_.batch_timeout_micros]
+  // respectively by RecordBatchLatencyAndMaybeAdapt().
+  size_t adaptive_max_batch_size_ GUARDED_BY(mu_);
+  int64 adaptive_batch_timeout_micros_ GUARDED_BY(mu_);
+
+  // The time at which each non-empty batch received its first task, keyed by
+  // batch. Only populated when 'options_.latency_slo_micros' is positive;
+  // entries are removed when the batch is processed.
+  std::unordered_map<const Batch<TaskType>*, uint64> batch_start_times_
+      GUARDED_BY(mu_);
+
+  // Tail-latency observations for the current adaptation window.
+  uint64 window_max_latency_micros_ GUARDED_BY(mu_) = 0;
+  int64 window_num_batches_ GUARDED_BY(mu_) = 0;
+
   TF_DISALLOW_COPY_AND_ASSIGN(Queue);
 };
 
@@ -408,6 +454,11 @@ Status SharedBatchScheduler<TaskType>::AddQueue(
         "max_enqueued_batches must be non-negative; was ",
         options.max_enqueued_batches);
   }
+  if (options.latency_slo_micros < 0) {
+    return errors::InvalidArgument(
+        "latency_slo_micros must be non-negative; was ",
+        options.latency_slo_micros);
+  }
 
   auto schedulable_batch_callback = [this] {
     mutex_lock l(mu_);
@@ -510,7 +561,9 @@ Queue<TaskType>::Queue(
     : options_(options),
       env_(env),
       process_batch_callback_(process_batch_callback),
-      schedulable_batch_callback_(schedulable_batch_callback) {
+      schedulable_batch_callback_(schedulable_batch_callback),
+      adaptive_max_batch_size_(options.max_batch_size),
+      adaptive_batch_timeout_micros_(options.batch_timeout_micros) {
   // Create an initial, open batch.
   batches_.emplace_back(new Batch<TaskType>);
 }
@@ -538,7 +591,10 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
 
     DCHECK(!closed_);
 
-    if (batches_.back()->size() + (*task)->size() > options_.max_batch_size) {
+    // A task admitted by the size check above always fits in an empty batch,
+    // even if the adapted maximum batch size has dropped below the task size.
+    if (!batches_.back()->empty() &&
+        batches_.back()->size() + (*task)->size() > adaptive_max_batch_size_) {
       if (batches_.size() >= options_.max_enqueued_batches) {
         return errors::Unavailable(
             "The batch scheduling queue to which this task was submitted is "
@@ -548,6 +604,10 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
     }
     if (batches_.back()->empty()) {
       open_batch_start_time_micros_ = env_->NowMicros();
+      if (options_.latency_slo_micros > 0) {
+        batch_start_times_[batches_.back().get()] =
+            open_batch_start_time_micros_;
+      }
     }
     batches_.back()->AddTask(std::move(*task));
 
@@ -616,10 +676,24 @@ std::unique_ptr<Batch<TaskType>> Queue<TaskType>::ScheduleBatch() {
 
 template <typename TaskType>
 void Queue<TaskType>::ProcessBatch(std::unique_ptr<Batch<TaskType>> batch) {
+  uint64 batch_start_time_micros = 0;
+  if (options_.latency_slo_micros > 0) {
+    mutex_lock l(mu_);
+    auto it = batch_start_times_.find(batch.get());
+    if (it != batch_start_times_.end()) {
+      batch_start_time_micros = it->second;
+      batch_start_times_.erase(it);
+    }
+  }
+
   process_batch_callback_(std::move(batch));
 
   {
     mutex_lock l(mu_);
+    if (options_.latency_slo_micros > 0 && batch_start_time_micros != 0) {
+      RecordBatchLatencyAndMaybeAdapt(env_->NowMicros() -
+                                      batch_start_time_micros);
+    }
     --num_batches_being_processed_;
     if (empty_notification_ != nullptr && IsEmptyInternal()) {
       empty_notification_->Notify();
@@ -667,9 +741,41 @@ bool Queue<TaskType>::IsOpenBatchSchedulable() const {
   if (open_batch->empty()) {
     return false;
   }
-  return closed_ || open_batch->size() >= options_.max_batch_size ||
+  return closed_ || open_batch->size() >= adaptive_max_batch_size_ ||
          env_->NowMicros() >=
-             open_batch_start_time_micros_ + options_.batch_timeout_micros;
+             open_batch_start_time_micros_ + adaptive_batch_timeout_micros_;
+}
+
+template <typename TaskType>
+void Queue<TaskType>::RecordBatchLatencyAndMaybeAdapt(uint64 latency_micros) {
+  window_max_latency_micros_ =
+      std::max(window_max_latency_micros_, latency_micros);
+  ++window_num_batches_;
+  if (window_num_batches_ < kSloAdaptationWindowNumBatches) {
+    return;
+  }
+
+  if (window_max_latency_micros_ >
+      static_cast<uint64>(options_.latency_slo_micros)) {
+    // The tail breached the SLO: back off multiplicatively, trading batch
+    // efficiency for latency.
+    adaptive_max_batch_size_ =
+        std::max<size_t>(1, adaptive_max_batch_size_ / 2);
+    adaptive_batch_timeout_micros_ /= 2;
+  } else {
+    // The whole window met the SLO: creep back up toward the configured
+    // parameters to recover throughput.
+    adaptive_max_batch_size_ =
+        std::min(options_.max_batch_size,
+                 adaptive_max_batch_size_ +
+                     std::max<size_t>(1, options_.max_batch_size / 16));
+    adaptive_batch_timeout_micros_ =
+        std::min(options_.batch_timeout_micros,
+                 adaptive_batch_timeout_micros_ +
+                     std::max<int64>(1, options_.batch_timeout_micros / 16));
+  }
+  window_max_latency_micros_ = 0;
+  window_num_batches_ = 0;
 }
 
 template <typename TaskType>
@@ -523,6 +523,89 @@ TEST(SharedBatchSchedulerTest, OneFullQueueDoesntBlockOtherQueues) {
   queue_0_proceed.Notify();
 }
 
+TEST(SharedBatchSchedulerTest, LatencySloAdaptsEffectiveParameters) {
+  mutex mu;
+  std::vector<size_t> batch_sizes;
+  int64 process_delay_micros = 100 * 1000;  // Breaches the 20 ms SLO below.
+  auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+    ASSERT_TRUE(batch->IsClosed());
+    int64 delay_micros;
+    {
+      mutex_lock l(mu);
+      delay_micros = process_delay_micros;
+    }
+    Env::Default()->SleepForMicroseconds(delay_micros);
+    mutex_lock l(mu);
+    batch_sizes.push_back(batch->size());
+  };
+  auto num_processed = [&mu, &batch_sizes] {
+    mutex_lock l(mu);
+    return batch_sizes.size();
+  };
+  auto wait_until_processed = [&](size_t n) {
+    while (num_processed() < n) {
+      Env::Default()->SleepForMicroseconds(100);
+    }
+  };
+
+  SharedBatchScheduler<FakeTask>::Options options;
+  options.num_batch_threads = 1;
+  std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+  TF_ASSERT_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+  SharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+  queue_options.max_batch_size = 4;
+  queue_options.batch_timeout_micros = 10 * 1000 * 1000;  // 10 seconds
+  queue_options.max_enqueued_batches = 100;
+  queue_options.latency_slo_micros = 20 * 1000;  // 20 milliseconds
+  std::unique_ptr<BatchScheduler<FakeTask>> queue;
+  TF_ASSERT_OK(scheduler->AddQueue(queue_options, callback, &queue));
+
+  // Sixteen full batches whose processing breaches the SLO: at the window
+  // boundary the effective maximum batch size should halve from 4 to 2.
+  for (int i = 0; i < 16; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    }
+    wait_until_processed(i + 1);
+  }
+  {
+    mutex_lock l(mu);
+    for (int i = 0; i < 16; ++i) {
+      EXPECT_EQ(4, batch_sizes[i]);
+    }
+    // Processing is instant from here on, so the SLO is met again.
+    process_delay_micros = 0;
+  }
+
+  // With the adapted maximum of 2, four tasks now form two batches of two.
+  for (int j = 0; j < 4; ++j) {
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+  }
+  wait_until_processed(18);
+  {
+    mutex_lock l(mu);
+    EXPECT_EQ(2, batch_sizes[16]);
+    EXPECT_EQ(2, batch_sizes[17]);
+  }
+
+  // Fill out a window of SLO-compliant batches: at the next boundary the
+  // effective maximum batch size should creep back up from 2 to 3.
+  for (int i = 0; i < 14; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    }
+    wait_until_processed(19 + i);
+  }
+  for (int j = 0; j < 3; ++j) {
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+  }
+  wait_until_processed(33);
+  {
+    mutex_lock l(mu);
+    EXPECT_EQ(3, batch_sizes[32]);
+  }
+}
+
 TEST(SharedBatchSchedulerTest, QueueDestructorBlocksUntilAllTasksProcessed) {
   test_util::FakeClockEnv env(Env::Default());
   Notification start_teardown, stop_teardown;
@@ -125,8 +125,20 @@ void ConcatCPUImpl(
       }
     }
   };
-  Shard(worker_threads->num_threads, worker_threads->workers, output->size(),
-        cost_per_unit, work);
+  if (std::is_same<T, string>::value) {
+    Shard(worker_threads->num_threads, worker_threads->workers, output->size(),
+          cost_per_unit, work);
+    return;
+  }
+  // For POD types the copy is bound by memory bandwidth, not compute, so
+  // give each worker a single contiguous output range instead of letting the
+  // cost model chop a large concat into many small blocks whose scheduling
+  // overhead dominates the copy itself.
+  const int64 total = output->size();
+  const int64 block_size = std::max<int64>(
+      4096, (total + worker_threads->num_threads - 1) /
+                worker_threads->num_threads);
+  worker_threads->workers->TransformRangeConcurrently(block_size, total, work);
 }
 
 #ifdef TENSORFLOW_USE_SYCL
@@ -110,6 +110,10 @@ class ConvParameters {
     for (int64 val : stride) hash_code_ = Hash64Combine(hash_code_, val);
     for (int64 val : padding) hash_code_ = Hash64Combine(hash_code_, val);
     hash_code_ = Hash64Combine(hash_code_, dtype);
+    // The fingerprint so far identifies the convolution itself; fold in the
+    // device ordinal last so that stable_hash() below can expose the
+    // device-independent part for the persistent autotune cache.
+    stable_hash_code_ = hash_code_;
     hash_code_ = Hash64Combine(hash_code_, device_id);
   }
   bool operator==(const ConvParameters& other) const {
@@ -121,6 +125,10 @@ class ConvParameters {
   }
   uint64 hash() const { return hash_code_; }
 
+  // Fingerprint of the convolution signature alone, excluding the local
+  // device ordinal, so it is comparable across processes and hosts.
+  uint64 stable_hash() const { return stable_hash_code_; }
+
   string ToString() const {
     // clang-format off
     return strings::StrCat(
@@ -166,6 +174,7 @@ class ConvParameters {
   }
 
   uint64 hash_code_;
+  uint64 stable_hash_code_;
 
  private:
   friend struct ConvParametersPeer;  // For testing purposes.
@@ -201,6 +210,27 @@ class ConvParameters {
   int device_id_;
 };
 
+// Enables the persistent autotune cache (see gpu_utils.h) for the
+// convolution autotune maps. Entries are keyed by the convolution signature
+// alone; the GPU model and cuDNN version are recorded in the cache file
+// header, so files only ever serve configurations measured on an identical
+// setup.
+template <>
+struct AutoTunePersistenceTraits<ConvParameters, se::dnn::AlgorithmConfig> {
+  static constexpr bool kSupported = true;
+  static uint64 StableKey(const ConvParameters& params) {
+    return params.stable_hash();
+  }
+  static bool SerializeConfig(const se::dnn::AlgorithmConfig& config,
+                              string* out) {
+    return autotune_cache_internal::SerializeAlgorithmConfig(config, out);
+  }
+  static bool DeserializeConfig(const string& in,
+                                se::dnn::AlgorithmConfig* config) {
+    return autotune_cache_internal::DeserializeAlgorithmConfig(in, config);
+  }
+};
+
 typedef Eigen::GpuDevice GPUDevice;
 
 }  // namespace tensorflow
@@ -298,34 +298,52 @@ class CTCBeamSearchDecoderOp : public OpKernel {
                                 batch_size, num_classes);
     }
 
-    ctc::CTCBeamSearchDecoder<> beam_search(num_classes, beam_width_,
-                                            &beam_scorer_, 1 /* batch_size */,
-                                            merge_repeated_);
-    Tensor input_chip(DT_FLOAT, TensorShape({num_classes}));
-    auto input_chip_t = input_chip.flat<float>();
-
     std::vector<std::vector<std::vector<int> > > best_paths(batch_size);
-    std::vector<float> log_probs;
+    std::vector<Status> status_of_batch(batch_size);
 
+    // Shard batch elements across the intra-op pool.  Each shard runs
+    // its own decoder so beam state (and the beam entry pool it reuses
+    // across batch elements) stays thread-local; the default beam
+    // scorer is stateless, so one instance can serve all shards.
     // Assumption: the blank index is num_classes - 1
-    for (int b = 0; b < batch_size; ++b) {
-      auto& best_paths_b = best_paths[b];
-      best_paths_b.resize(decode_helper_.GetTopPaths());
-      for (int t = 0; t < seq_len_t(b); ++t) {
-        input_chip_t = input_list_t[t].chip(b, 0);
-        auto input_bi =
-            Eigen::Map<const Eigen::ArrayXf>(input_chip_t.data(), num_classes);
-        beam_search.Step(input_bi);
-      }
-      OP_REQUIRES_OK(
-          ctx, beam_search.TopPaths(decode_helper_.GetTopPaths(), &best_paths_b,
-                                    &log_probs, merge_repeated_));
+    auto decode = [&](const int64 begin, const int64 end) {
+      ctc::CTCBeamSearchDecoder<> beam_search(num_classes, beam_width_,
+                                              &beam_scorer_, 1 /* batch_size */,
+                                              merge_repeated_);
+      Tensor input_chip(DT_FLOAT, TensorShape({num_classes}));
+      auto input_chip_t = input_chip.flat<float>();
+      std::vector<float> log_probs;
+
+      for (int64 b = begin; b < end; ++b) {
+        auto& best_paths_b = best_paths[b];
+        best_paths_b.resize(decode_helper_.GetTopPaths());
+        for (int t = 0; t < seq_len_t(b); ++t) {
+          input_chip_t = input_list_t[t].chip(b, 0);
+          auto input_bi = Eigen::Map<const Eigen::ArrayXf>(input_chip_t.data(),
+                                                           num_classes);
+          beam_search.Step(input_bi);
+        }
+        status_of_batch[b] =
+            beam_search.TopPaths(decode_helper_.GetTopPaths(), &best_paths_b,
+                                 &log_probs, merge_repeated_);
 
-      beam_search.Reset();
+        beam_search.Reset();
 
-      for (int bp = 0; bp < decode_helper_.GetTopPaths(); ++bp) {
-        log_prob_t(b, bp) = log_probs[bp];
+        if (!status_of_batch[b].ok()) continue;
+        for (int bp = 0; bp < decode_helper_.GetTopPaths(); ++bp) {
+          log_prob_t(b, bp) = log_probs[bp];
+        }
       }
+    };
+
+    const int64 kCostPerUnit = 50 * max_time * num_classes * beam_width_;
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
+          kCostPerUnit, decode);
+
+    for (int64 b = 0; b < batch_size; ++b) {
+      OP_REQUIRES_OK(ctx, status_of_batch[b]);
     }
 
     OP_REQUIRES_OK(ctx, decode_helper_.StoreAllDecodedSequences(
@@ -154,6 +154,10 @@ class BatchDatasetOp : public UnaryDatasetOpKernel {
             *end_of_sequence = true;
             return Status::OK();
           }
+          if (input_impl_->SupportsSlicedOutput() &&
+              InputShapesFullyDefined()) {
+            return GetBatchSlicedLocked(ctx, out_tensors, end_of_sequence);
+          }
           batch_elements.reserve(dataset()->batch_size_);
           *end_of_sequence = false;
           for (int i = 0; i < dataset()->batch_size_ && !*end_of_sequence;
@@ -279,6 +283,82 @@ class BatchDatasetOp : public UnaryDatasetOpKernel {
       }
 
      private:
+      // Returns true if every component shape of the input is fully
+      // defined, i.e. the batch tensors can be allocated up front.
+      bool InputShapesFullyDefined() const {
+        for (const PartialTensorShape& shape :
+             dataset()->input_->output_shapes()) {
+          if (!shape.IsFullyDefined()) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      // Fast path for inputs that support `GetNextSlice()`: allocates the
+      // batch tensors once and has the input write each element directly
+      // into its row, eliminating the per-element allocate-and-copy pair
+      // of the generic path above.
+      Status GetBatchSlicedLocked(IteratorContext* ctx,
+                                  std::vector<Tensor>* out_tensors,
+                                  bool* end_of_sequence)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const DataTypeVector& dtypes = dataset()->input_->output_dtypes();
+        const std::vector<PartialTensorShape>& shapes =
+            dataset()->input_->output_shapes();
+        std::vector<Tensor> batch_tensors;
+        batch_tensors.reserve(dtypes.size());
+        for (size_t component_index = 0; component_index < dtypes.size();
+             ++component_index) {
+          TensorShape component_shape;
+          shapes[component_index].AsTensorShape(&component_shape);
+          TensorShape batch_component_shape({dataset()->batch_size_});
+          batch_component_shape.AppendShape(component_shape);
+          batch_tensors.emplace_back(ctx->allocator({}),
+                                     dtypes[component_index],
+                                     batch_component_shape);
+          if (!batch_tensors.back().IsInitialized()) {
+            return errors::ResourceExhausted(
+                "Failed to allocate memory for the batch of component ",
+                component_index);
+          }
+        }
+
+        int64 num_batch_elements = 0;
+        *end_of_sequence = false;
+        while (num_batch_elements < dataset()->batch_size_ &&
+               !*end_of_sequence) {
+          TF_RETURN_IF_ERROR(input_impl_->GetNextSlice(
+              ctx, &batch_tensors, num_batch_elements, end_of_sequence));
+          if (!*end_of_sequence) {
+            ++num_batch_elements;
+          } else {
+            input_impl_.reset();
+          }
+        }
+
+        if (num_batch_elements == 0 ||
+            (dataset()->drop_remainder_ &&
+             num_batch_elements < dataset()->batch_size_)) {
+          *end_of_sequence = true;
+          return Status::OK();
+        }
+
+        for (size_t component_index = 0; component_index < dtypes.size();
+             ++component_index) {
+          if (num_batch_elements == dataset()->batch_size_) {
+            out_tensors->push_back(std::move(batch_tensors[component_index]));
+          } else {
+            // A partial final batch aliases the leading rows of the full
+            // allocation; slices starting at row 0 are always aligned.
+            out_tensors->push_back(
+                batch_tensors[component_index].Slice(0, num_batch_elements));
+          }
+        }
+        *end_of_sequence = false;
+        return Status::OK();
+      }
+
       mutex mu_;
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
     };
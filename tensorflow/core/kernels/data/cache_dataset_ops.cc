@@ -16,8 +16,13 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/snappy.h"
+#include "tensorflow/core/protobuf/data/experimental/snapshot.pb.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
@@ -27,6 +32,46 @@ namespace {
 // See documentation in ../../ops/dataset_ops.cc for a high-level description of
 // the following op.
 
+// When true, file-backed caches are written in the compressed block format
+// (see `BlockWriterIterator`) instead of a tensor bundle. Readers mmap the
+// cache file and decompress one block at a time, so repeated epochs are
+// served from the OS page cache and the mapped pages are shared across all
+// processes reading the same cache file on a host.
+bool CompressedBlockCacheEnabled() {
+  bool enabled = false;
+  Status status = ReadBoolFromEnvVar("TF_DATA_CACHE_COMPRESSED_BLOCKS", false,
+                                     &enabled);
+  if (!status.ok()) {
+    LOG(ERROR) << "CompressedBlockCacheEnabled: " << status.error_message();
+  }
+  return enabled;
+}
+
+// Layout of a compressed block cache file:
+//
+//   block 0 .. block N-1   each block is the snappy compression of a sequence
+//                          of <fixed64 length><serialized SnapshotRecord>
+//                          entries, one per element
+//   index                  N entries of <fixed64 block offset>
+//                          <fixed64 compressed length>
+//                          <fixed64 uncompressed length>
+//                          <fixed64 index of the block's first element>
+//   footer                 <fixed64 index offset><fixed64 num elements>
+//                          <fixed32 version><fixed32 magic>
+const uint32 kBlockCacheMagic = 0x54464243;  // "TFBC"
+const uint32 kBlockCacheVersion = 1;
+const size_t kBlockCacheIndexEntrySize = 4 * sizeof(uint64);
+const size_t kBlockCacheFooterSize = 2 * sizeof(uint64) + 2 * sizeof(uint32);
+
+// Target uncompressed size of a block. Blocks are the unit of lazy
+// decompression, so this bounds both the decompression latency of a random
+// seek and the reader's resident memory.
+const size_t kBlockCacheTargetBlockBytes = 1 << 20;  // 1 MB.
+
+string BlockCacheFilename(const string& filename) {
+  return strings::StrCat(filename, ".blocks");
+}
+
 class CacheDatasetOp : public UnaryDatasetOpKernel {
  public:
   explicit CacheDatasetOp(OpKernelConstruction* ctx)
@@ -60,7 +105,8 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
           item_index_padding_size_(StringPaddingSize(kMaxItems)),
           tensor_format_string_(strings::Printf("%%%zuzu_%%%zuzu",
                                                 item_index_padding_size_,
-                                                tensor_index_padding_size_)) {
+                                                tensor_index_padding_size_)),
+          compressed_blocks_(CompressedBlockCacheEnabled()) {
       input_->Ref();
       DCHECK_EQ(item_index_padding_size_, 7);
     }
@@ -115,7 +161,11 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
           : DatasetIterator<FileDataset>(params) {
         if (params.dataset->env_
                 ->FileExists(MetaFilename(params.dataset->filename_))
-                .ok()) {
+                .ok() ||
+            (params.dataset->compressed_blocks_ &&
+             params.dataset->env_
+                 ->FileExists(BlockCacheFilename(params.dataset->filename_))
+                 .ok())) {
           mode_ = Mode::read;
         } else {
           mode_ = Mode::write;
@@ -156,9 +206,13 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
           mode_ = static_cast<Mode>(temp);
         }
         if (mode_ == Mode::write &&
-            dataset()
-                ->env_->FileExists(MetaFilename(dataset()->filename_))
-                .ok()) {
+            (dataset()
+                 ->env_->FileExists(MetaFilename(dataset()->filename_))
+                 .ok() ||
+             (dataset()->compressed_blocks_ &&
+              dataset()
+                  ->env_->FileExists(BlockCacheFilename(dataset()->filename_))
+                  .ok()))) {
           // This could happen if the cache was completely written after the
           // checkpoint was saved.
           LOG(WARNING)
@@ -527,6 +581,330 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
         bool iterator_restored_ GUARDED_BY(mu_);
       };  // FileReaderIterator
 
+      // Writes the cache in the compressed block format described at the top
+      // of this file: elements are serialized into blocks of roughly
+      // `kBlockCacheTargetBlockBytes`, each block is snappy-compressed, and
+      // an index mapping element indices to block offsets is appended so
+      // that `BlockReaderIterator` can mmap the file and decompress blocks
+      // lazily.
+      //
+      // Unlike `FileWriterIterator`, partially written caches are not
+      // checkpointable: the file is written in a single pass into a
+      // temporary location and renamed into place once the input has been
+      // exhausted, so an interrupted run leaves no cache behind.
+      class BlockWriterIterator : public DatasetIterator<FileDataset> {
+       public:
+        explicit BlockWriterIterator(const Params& params)
+            : DatasetIterator<FileDataset>(params),
+              filename_(BlockCacheFilename(dataset()->filename_)),
+              tmp_filename_(strings::StrCat(filename_, ".tmp")) {}
+
+        ~BlockWriterIterator() override {
+          mutex_lock l(mu_);
+          if (file_ && !iteration_completed_) {
+            // Clean up the partial file; the cache must be rewritten from
+            // scratch on the next run.
+            file_->Close().IgnoreError();
+            file_.reset();
+            dataset()->env_->DeleteFile(tmp_filename_).IgnoreError();
+          }
+        }
+
+        Status Initialize(IteratorContext* ctx) override {
+          mutex_lock l(mu_);
+          return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
+        }
+
+        Status GetNextInternal(IteratorContext* ctx,
+                               std::vector<Tensor>* out_tensors,
+                               bool* end_of_sequence) override {
+          mutex_lock l(mu_);
+          if (iteration_completed_) {
+            *end_of_sequence = true;
+            return Status::OK();
+          }
+          if (!file_) {
+            TF_RETURN_IF_ERROR(
+                dataset()->env_->NewWritableFile(tmp_filename_, &file_));
+          }
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, out_tensors, end_of_sequence));
+          if (*end_of_sequence) {
+            TF_RETURN_IF_ERROR(Finish());
+            return Status::OK();
+          }
+          experimental::SnapshotRecord record;
+          for (const Tensor& t : *out_tensors) {
+            t.AsProtoTensorContent(record.add_tensor());
+          }
+          const string serialized = record.SerializeAsString();
+          char length_header[sizeof(uint64)];
+          core::EncodeFixed64(length_header, serialized.size());
+          block_buffer_.append(length_header, sizeof(uint64));
+          block_buffer_.append(serialized);
+          cur_index_++;
+          if (block_buffer_.size() >= kBlockCacheTargetBlockBytes) {
+            TF_RETURN_IF_ERROR(FlushBlock());
+          }
+          return Status::OK();
+        }
+
+       protected:
+        std::shared_ptr<model::Node> CreateNode(
+            IteratorContext* ctx, model::Node::Args args) const override {
+          return model::MakeKnownRatioNode(std::move(args),
+                                           /*ratio=*/1);
+        }
+
+        Status SaveInternal(IteratorStateWriter* writer) override {
+          return errors::Unimplemented(
+              "Checkpointing a partially written compressed block cache is "
+              "not supported.");
+        }
+
+        Status RestoreInternal(IteratorContext* ctx,
+                               IteratorStateReader* reader) override {
+          return errors::Unimplemented(
+              "Checkpointing a partially written compressed block cache is "
+              "not supported.");
+        }
+
+       private:
+        // Compresses the buffered elements, appends the resulting block to
+        // the file, and records its index entry.
+        Status FlushBlock() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          if (block_buffer_.empty()) {
+            return Status::OK();
+          }
+          string compressed;
+          if (!port::Snappy_Compress(block_buffer_.data(),
+                                     block_buffer_.size(), &compressed)) {
+            return errors::Internal(
+                "Failed to compress a cache block of size ",
+                block_buffer_.size());
+          }
+          char entry[kBlockCacheIndexEntrySize];
+          core::EncodeFixed64(entry, file_offset_);
+          core::EncodeFixed64(entry + 8, compressed.size());
+          core::EncodeFixed64(entry + 16, block_buffer_.size());
+          core::EncodeFixed64(entry + 24, first_element_index_);
+          index_.append(entry, kBlockCacheIndexEntrySize);
+          TF_RETURN_IF_ERROR(file_->Append(compressed));
+          file_offset_ += compressed.size();
+          first_element_index_ = cur_index_;
+          block_buffer_.clear();
+          return Status::OK();
+        }
+
+        // Appends the index and footer, then renames the finished file into
+        // place so that subsequent iterators read the cache.
+        Status Finish() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          iteration_completed_ = true;
+          input_impl_.reset();
+          TF_RETURN_IF_ERROR(FlushBlock());
+          const uint64 index_offset = file_offset_;
+          TF_RETURN_IF_ERROR(file_->Append(index_));
+          char footer[kBlockCacheFooterSize];
+          core::EncodeFixed64(footer, index_offset);
+          core::EncodeFixed64(footer + 8, cur_index_);
+          core::EncodeFixed32(footer + 16, kBlockCacheVersion);
+          core::EncodeFixed32(footer + 20, kBlockCacheMagic);
+          TF_RETURN_IF_ERROR(file_->Append(StringPiece(footer, sizeof(footer))));
+          TF_RETURN_IF_ERROR(file_->Close());
+          file_.reset();
+          return dataset()->env_->RenameFile(tmp_filename_, filename_);
+        }
+
+        mutex mu_;
+        const string filename_;
+        const string tmp_filename_;
+        std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
+        std::unique_ptr<WritableFile> file_ GUARDED_BY(mu_);
+        string block_buffer_ GUARDED_BY(mu_);
+        string index_ GUARDED_BY(mu_);
+        uint64 file_offset_ GUARDED_BY(mu_) = 0;
+        uint64 first_element_index_ GUARDED_BY(mu_) = 0;
+        uint64 cur_index_ GUARDED_BY(mu_) = 0;
+        bool iteration_completed_ GUARDED_BY(mu_) = false;
+      };  // BlockWriterIterator
+
+      // Reads a cache written by `BlockWriterIterator`. The file is mapped
+      // read-only, so repeated epochs are served from the OS page cache and
+      // the mapping is shared across processes; only the current block is
+      // decompressed into private memory.
+      class BlockReaderIterator : public DatasetIterator<FileDataset> {
+       public:
+        explicit BlockReaderIterator(const Params& params)
+            : DatasetIterator<FileDataset>(params) {}
+
+        Status Initialize(IteratorContext* ctx) override {
+          mutex_lock l(mu_);
+          TF_RETURN_IF_ERROR(dataset()->env_->NewReadOnlyMemoryRegionFromFile(
+              BlockCacheFilename(dataset()->filename_), &region_));
+          const char* base = static_cast<const char*>(region_->data());
+          const uint64 length = region_->length();
+          if (length < kBlockCacheFooterSize) {
+            return errors::DataLoss("Compressed block cache is truncated: ",
+                                    length, " bytes");
+          }
+          const char* footer = base + length - kBlockCacheFooterSize;
+          if (core::DecodeFixed32(footer + 20) != kBlockCacheMagic) {
+            return errors::DataLoss(
+                "Bad magic number in compressed block cache ",
+                BlockCacheFilename(dataset()->filename_));
+          }
+          const uint32 version = core::DecodeFixed32(footer + 16);
+          if (version != kBlockCacheVersion) {
+            return errors::DataLoss("Unsupported compressed block cache ",
+                                    "version: ", version);
+          }
+          index_offset_ = core::DecodeFixed64(footer);
+          num_elements_ = core::DecodeFixed64(footer + 8);
+          const uint64 index_bytes = length - kBlockCacheFooterSize;
+          if (index_offset_ > index_bytes ||
+              (index_bytes - index_offset_) % kBlockCacheIndexEntrySize != 0) {
+            return errors::DataLoss(
+                "Malformed index in compressed block cache ",
+                BlockCacheFilename(dataset()->filename_));
+          }
+          index_base_ = base + index_offset_;
+          num_blocks_ = (index_bytes - index_offset_) / kBlockCacheIndexEntrySize;
+          return Status::OK();
+        }
+
+        Status GetNextInternal(IteratorContext* ctx,
+                               std::vector<Tensor>* out_tensors,
+                               bool* end_of_sequence) override {
+          mutex_lock l(mu_);
+          if (cur_index_ >= num_elements_) {
+            *end_of_sequence = true;
+            return Status::OK();
+          }
+          if (cur_index_ != loaded_next_element_ ||
+              block_pos_ >= block_.size()) {
+            TF_RETURN_IF_ERROR(LoadBlockForElement(cur_index_));
+          }
+          if (block_pos_ + sizeof(uint64) > block_.size()) {
+            return errors::DataLoss("Truncated cache block for element ",
+                                    cur_index_);
+          }
+          const uint64 record_size =
+              core::DecodeFixed64(block_.data() + block_pos_);
+          block_pos_ += sizeof(uint64);
+          if (block_pos_ + record_size > block_.size()) {
+            return errors::DataLoss("Truncated cache record for element ",
+                                    cur_index_);
+          }
+          experimental::SnapshotRecord record;
+          if (!record.ParseFromArray(block_.data() + block_pos_,
+                                     record_size)) {
+            return errors::DataLoss("Failed to parse cache record for ",
+                                    "element ", cur_index_);
+          }
+          block_pos_ += record_size;
+          out_tensors->clear();
+          out_tensors->reserve(record.tensor_size());
+          for (const TensorProto& proto : record.tensor()) {
+            Tensor t;
+            if (!t.FromProto(proto)) {
+              return errors::DataLoss("Failed to parse cache tensor for ",
+                                      "element ", cur_index_);
+            }
+            out_tensors->push_back(std::move(t));
+          }
+          cur_index_++;
+          loaded_next_element_ = cur_index_;
+          *end_of_sequence = false;
+          return Status::OK();
+        }
+
+       protected:
+        std::shared_ptr<model::Node> CreateNode(
+            IteratorContext* ctx, model::Node::Args args) const override {
+          return model::MakeKnownRatioNode(std::move(args),
+                                           /*ratio=*/1);
+        }
+
+        Status SaveInternal(IteratorStateWriter* writer) override {
+          mutex_lock l(mu_);
+          return writer->WriteScalar(full_name("cur_index"),
+                                     static_cast<int64>(cur_index_));
+        }
+
+        Status RestoreInternal(IteratorContext* ctx,
+                               IteratorStateReader* reader) override {
+          mutex_lock l(mu_);
+          int64 temp;
+          TF_RETURN_IF_ERROR(reader->ReadScalar(full_name("cur_index"), &temp));
+          cur_index_ = static_cast<uint64>(temp);
+          // The block containing `cur_index_` is loaded lazily by the next
+          // `GetNextInternal` call.
+          loaded_next_element_ = -1;
+          block_.clear();
+          block_pos_ = 0;
+          return Status::OK();
+        }
+
+       private:
+        // Decompresses the block containing `element_index` and positions
+        // `block_pos_` at that element.
+        Status LoadBlockForElement(uint64 element_index)
+            EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          // Find the last block whose first element is <= `element_index`.
+          uint64 lo = 0;
+          uint64 hi = num_blocks_;
+          while (hi - lo > 1) {
+            uint64 mid = lo + (hi - lo) / 2;
+            const uint64 first = core::DecodeFixed64(
+                index_base_ + mid * kBlockCacheIndexEntrySize + 24);
+            if (first <= element_index) {
+              lo = mid;
+            } else {
+              hi = mid;
+            }
+          }
+          const char* entry = index_base_ + lo * kBlockCacheIndexEntrySize;
+          const uint64 offset = core::DecodeFixed64(entry);
+          const uint64 compressed_size = core::DecodeFixed64(entry + 8);
+          const uint64 uncompressed_size = core::DecodeFixed64(entry + 16);
+          const uint64 first_element = core::DecodeFixed64(entry + 24);
+          if (offset + compressed_size > index_offset_) {
+            return errors::DataLoss("Cache block ", lo,
+                                    " extends past the block index");
+          }
+          const char* base = static_cast<const char*>(region_->data());
+          block_.resize(uncompressed_size);
+          if (!port::Snappy_Uncompress(base + offset, compressed_size,
+                                       &block_[0])) {
+            return errors::DataLoss("Failed to decompress cache block ", lo);
+          }
+          // Skip over the elements that precede `element_index`.
+          block_pos_ = 0;
+          for (uint64 i = first_element; i < element_index; ++i) {
+            if (block_pos_ + sizeof(uint64) > block_.size()) {
+              return errors::DataLoss("Truncated cache block ", lo);
+            }
+            block_pos_ +=
+                sizeof(uint64) + core::DecodeFixed64(block_.data() + block_pos_);
+          }
+          loaded_next_element_ = element_index;
+          return Status::OK();
+        }
+
+        mutex mu_;
+        std::unique_ptr<ReadOnlyMemoryRegion> region_ GUARDED_BY(mu_);
+        const char* index_base_ GUARDED_BY(mu_) = nullptr;
+        uint64 index_offset_ GUARDED_BY(mu_) = 0;
+        uint64 num_blocks_ GUARDED_BY(mu_) = 0;
+        uint64 num_elements_ GUARDED_BY(mu_) = 0;
+        uint64 cur_index_ GUARDED_BY(mu_) = 0;
+        // Index of the element that `block_pos_` points at, or -1 if no
+        // block is loaded.
+        int64 loaded_next_element_ GUARDED_BY(mu_) = -1;
+        string block_ GUARDED_BY(mu_);
+        size_t block_pos_ GUARDED_BY(mu_) = 0;
+      };  // BlockReaderIterator
+
       void InitializeIterator() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         // We intentionally use the same prefix for both `FileReaderIterator`
         // and `FileWriterIterator`. Since at any time there will be at most
@@ -538,14 +916,30 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
         // `FileReaderIterator` and seek to the `cur_index`.
         switch (mode_) {
           case Mode::read:
-            iterator_ = absl::make_unique<FileReaderIterator>(
-                FileReaderIterator::Params{dataset(),
-                                           strings::StrCat(prefix(), "Impl")});
+            if (dataset()->compressed_blocks_ &&
+                dataset()
+                    ->env_
+                    ->FileExists(BlockCacheFilename(dataset()->filename_))
+                    .ok()) {
+              iterator_ = absl::make_unique<BlockReaderIterator>(
+                  BlockReaderIterator::Params{
+                      dataset(), strings::StrCat(prefix(), "Impl")});
+            } else {
+              iterator_ = absl::make_unique<FileReaderIterator>(
+                  FileReaderIterator::Params{
+                      dataset(), strings::StrCat(prefix(), "Impl")});
+            }
             break;
           case Mode::write:
-            iterator_ = absl::make_unique<FileWriterIterator>(
-                FileWriterIterator::Params{dataset(),
-                                           strings::StrCat(prefix(), "Impl")});
+            if (dataset()->compressed_blocks_) {
+              iterator_ = absl::make_unique<BlockWriterIterator>(
+                  BlockWriterIterator::Params{
+                      dataset(), strings::StrCat(prefix(), "Impl")});
+            } else {
+              iterator_ = absl::make_unique<FileWriterIterator>(
+                  FileWriterIterator::Params{
+                      dataset(), strings::StrCat(prefix(), "Impl")});
+            }
         }
       }
 
@@ -563,6 +957,9 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
     static const size_t kMaxItems = 10000000;  // 10 million
     const size_t item_index_padding_size_;
     const string tensor_format_string_;
+    // Whether to use the compressed block cache format; see
+    // `CompressedBlockCacheEnabled`.
+    const bool compressed_blocks_;
   };  // FileDataset
 
   class MemoryDataset : public DatasetBase {
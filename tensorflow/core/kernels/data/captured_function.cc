@@ -194,6 +194,69 @@ Status CreateShortCircuitInfo(OpKernelConstruction* ctx,
   return Status::OK();
 }
 
+// The single-threaded executor runs kernels one at a time on the calling
+// thread, so routing a large function body through it would serialize work
+// that the default executor could overlap.
+constexpr int kMaxSingleThreadedFunctionNodes = 16;
+
+// Returns true if `op` introduces control flow or graph partitioning, which
+// the single-threaded executor does not support.
+bool IsControlFlowOrPartitionOp(const string& op) {
+  return op == "Switch" || op == "Merge" || op == "Enter" || op == "Exit" ||
+         op == "NextIteration" || op == "LoopCond" || op == "If" ||
+         op == "While" || op == "StatelessIf" || op == "StatelessWhile" ||
+         op == "PartitionedCall" || op == "StatefulPartitionedCall" ||
+         op == "_Send" || op == "_Recv";
+}
+
+// Determines whether `func_name` can be executed by the single-threaded
+// executor: a short, stateless body with no control flow, reference-typed
+// outputs, or nested function calls. For such functions, a flat kernel
+// sequence run on the calling thread is cheaper than a dispatch through the
+// default executor.
+Status IsEligibleForSingleThreadedExecutor(
+    const FunctionLibraryDefinition& lib_def, const string& func_name,
+    bool* eligible) {
+  *eligible = false;
+  const FunctionDef* fdef = lib_def.Find(func_name);
+  if (fdef == nullptr) {
+    return errors::FailedPrecondition(strings::StrCat(
+        "Could not find required function definition ", func_name));
+  }
+  if (fdef->node_def_size() > kMaxSingleThreadedFunctionNodes) {
+    return Status::OK();
+  }
+  for (const NodeDef& node : fdef->node_def()) {
+    if (IsControlFlowOrPartitionOp(node.op()) ||
+        lib_def.Find(node.op()) != nullptr) {
+      return Status::OK();
+    }
+    for (const auto& attr : node.attr()) {
+      // A function-valued attr indicates a nested function call (e.g.
+      // `MapDataset`), which we conservatively keep on the default executor.
+      if (attr.second.has_func() || attr.second.list().func_size() > 0) {
+        return Status::OK();
+      }
+    }
+    const OpDef* op_def;
+    Status s = lib_def.LookUpOpDef(node.op(), &op_def);
+    if (!s.ok()) {
+      // Be conservative about ops that are not registered in this process.
+      return Status::OK();
+    }
+    if (op_def->is_stateful()) {
+      return Status::OK();
+    }
+    for (const auto& output_arg : op_def->output_arg()) {
+      if (output_arg.is_ref()) {
+        return Status::OK();
+      }
+    }
+  }
+  *eligible = true;
+  return Status::OK();
+}
+
 Status CreateFunctionLibraryDefinition(
     const FunctionLibraryDefinition* lib_def, const string& func_name,
     std::unique_ptr<FunctionLibraryDefinition>* result) {
@@ -254,6 +317,9 @@ Status FunctionMetadata::Create(
       (*out_metadata)->func_.name(), &(*out_metadata)->lib_def_));
   TF_RETURN_IF_ERROR(CreateShortCircuitInfo(
       ctx, (*out_metadata)->func_, &(*out_metadata)->short_circuit_info_));
+  TF_RETURN_IF_ERROR(IsEligibleForSingleThreadedExecutor(
+      *(*out_metadata)->lib_def_, (*out_metadata)->func_.name(),
+      &(*out_metadata)->use_single_threaded_executor_));
   return Status::OK();
 }
 
@@ -311,7 +377,10 @@ Status CapturedFunction::Instantiate(
   FunctionLibraryRuntime::InstantiateOptions inst_opts;
   inst_opts.lib_def = metadata_->lib_def();
   inst_opts.create_kernels_eagerly = true;
-  if (!metadata_->use_inter_op_parallelism()) {
+  if (!metadata_->use_inter_op_parallelism() ||
+      (metadata_->use_single_threaded_executor() &&
+       !metadata_->is_multi_device_function() &&
+       lib->device()->device_type() == DEVICE_CPU)) {
     inst_opts.executor_type = "SINGLE_THREADED_EXECUTOR";
   }
   inst_opts.is_multi_device_function = metadata_->is_multi_device_function();
@@ -150,6 +150,13 @@ class FunctionMetadata {
   // function.
   bool use_inter_op_parallelism() const { return use_inter_op_parallelism_; }
 
+  // Indicates whether the function has a short, stateless, control-flow-free
+  // body that should be executed as a flat kernel sequence on the calling
+  // thread, bypassing the default executor's dispatch overhead.
+  bool use_single_threaded_executor() const {
+    return use_single_threaded_executor_;
+  }
+
  private:
   FunctionMetadata(NameAttrList&& func, Params params)
       : func_(std::move(func)),
@@ -161,6 +168,7 @@ class FunctionMetadata {
   std::unique_ptr<FunctionLibraryDefinition> lib_def_ = nullptr;
   ShortCircuitInfo short_circuit_info_;
   bool use_inter_op_parallelism_ = true;
+  bool use_single_threaded_executor_ = false;
 };
 
 // A `CapturedFunction` encapsulates a TensorFlow function, plus any "captured"
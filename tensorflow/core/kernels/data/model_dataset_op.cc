@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -157,6 +158,15 @@ class ModelDatasetOp : public UnaryDatasetOpKernel {
       }
 
       void OptimizeThread(const std::shared_ptr<IteratorContext>& ctx) {
+        // An optional pipeline-wide byte budget for the buffers of
+        // Prefetch and ParallelMap; 0 leaves the buffers unconstrained.
+        int64 ram_budget_mb = 0;
+        Status status = ReadInt64FromEnvVar("TF_DATA_BUFFER_BUDGET_IN_MB", 0,
+                                            &ram_budget_mb);
+        if (!status.ok()) {
+          LOG(ERROR) << "OptimizeThread: " << status.error_message();
+        }
+        const int64 ram_budget_bytes = ram_budget_mb << 20;
         int64 last_optimization_ms = 0;
         int64 optimization_period_ms = 10;
         int64 current_time_ms =
@@ -177,6 +187,16 @@ class ModelDatasetOp : public UnaryDatasetOpKernel {
             if (cancelled_) return;
           }
           model_->Optimize(dataset()->cpu_budget_);
+          if (ram_budget_bytes > 0) {
+            model_->OptimizeBuffers(ram_budget_bytes);
+          }
+          // Publish per-iterator counters so that dashboards can locate
+          // input-pipeline bottlenecks without attaching a profiler.
+          for (const auto& node_metrics : model_->CollectMetrics()) {
+            metrics::RecordTFDataIteratorMetrics(
+                node_metrics.name, node_metrics.num_elements,
+                node_metrics.processing_time, node_metrics.buffered_bytes);
+          }
           // Exponentially increase the period of running the optimization
           // until a threshold is reached.
           if (optimization_period_ms != kOptimizationPeriodThresholdMs) {
@@ -12,8 +12,10 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <cstring>
 #include <deque>
 
+#include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/function.h"
@@ -26,11 +28,27 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
+// Returns true if the background thread should re-materialize buffered
+// elements in pinned (GPU host) memory. The consumers of a multi-device
+// iterator are typically GPUs, and a host-to-device copy from pageable
+// memory has to be staged by the driver on the compute-critical path;
+// copying from pinned memory is a direct DMA that overlaps compute.
+bool PinnedStagingEnabled() {
+  bool pinned_staging = false;
+  Status status = ReadBoolFromEnvVar("TF_DATA_MDI_PINNED_STAGING", false,
+                                     &pinned_staging);
+  if (!status.ok()) {
+    LOG(ERROR) << "MultiDeviceIterator: " << status.error_message();
+  }
+  return pinned_staging;
+}
+
 struct HostBufferElement {
   Status status;
   bool end_of_sequence;
@@ -133,6 +151,10 @@ class MultiDeviceIterator : public ResourceBase {
           size_(size),
           max_buffer_size_(max_buffer_size),
           incarnation_id_(incarnation_id),
+          pinned_allocator_(PinnedStagingEnabled()
+                                ? GPUProcessState::singleton()
+                                      ->GetGpuHostAllocator(0)
+                                : nullptr),
           host_iterator_(std::move(host_iterator)),
           parent_(parent) {}
 
@@ -288,6 +310,11 @@ class MultiDeviceIterator : public ResourceBase {
           end_of_iterator = true;
         }
 
+        if (pinned_allocator_ != nullptr && elem.status.ok() &&
+            !elem.end_of_sequence) {
+          StageElementPinned(&elem);
+        }
+
         {
           mutex_lock l(mu_);
           // Try to find a callback, else just push stuff into buffer.
@@ -320,6 +347,27 @@ class MultiDeviceIterator : public ResourceBase {
       }
     }
 
+    // Re-materializes the DMA-compatible tensors of `*elem` in pinned host
+    // memory. Runs on the background thread, off the consumers' critical
+    // path. On allocation failure the original (pageable) tensors are kept.
+    void StageElementPinned(HostBufferElement* elem) {
+      for (Tensor& t : elem->value) {
+        if (!DataTypeCanUseMemcpy(t.dtype())) {
+          continue;
+        }
+        Tensor staged(pinned_allocator_, t.dtype(), t.shape());
+        if (!staged.IsInitialized()) {
+          return;
+        }
+        StringPiece src = t.tensor_data();
+        if (!src.empty()) {
+          memcpy(const_cast<char*>(staged.tensor_data().data()), src.data(),
+                 src.size());
+        }
+        t = std::move(staged);
+      }
+    }
+
     struct HostBuffer {
       condition_variable cond_var;
       std::deque<HostBufferElement> data;
@@ -339,6 +387,7 @@ class MultiDeviceIterator : public ResourceBase {
     const size_t size_;
     const int64 max_buffer_size_;
     const int64 incarnation_id_;
+    Allocator* const pinned_allocator_;  // Not owned; nullptr if disabled.
     const std::unique_ptr<IteratorBase> host_iterator_;
     MultiDeviceIterator* const parent_;  // Not owned.
   };
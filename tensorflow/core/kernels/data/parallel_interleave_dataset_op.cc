@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -40,6 +41,24 @@ namespace {
 
 constexpr char kDatasetName[] = "ParallelInterleaveV2";
 
+// Number of input iterators to instantiate speculatively ahead of the
+// interleave cycle. Each future element opens its input (e.g. a remote file)
+// and fills its first block of results in the background, so cycling to a
+// new input does not block the consumer on open latency. Defaults to
+// 2 * cycle_length; values < 1 are ignored.
+int64 FutureElementsLimit(int64 cycle_length) {
+  int64 limit = 0;
+  Status status = ReadInt64FromEnvVar("TF_DATA_INTERLEAVE_PREFETCH_ITERATORS",
+                                      0, &limit);
+  if (!status.ok()) {
+    LOG(ERROR) << "FutureElementsLimit: " << status.error_message();
+  }
+  if (limit < 1) {
+    return 2 * cycle_length;
+  }
+  return limit;
+}
+
 // See documentation in ../../ops/dataset_ops.cc for a high-level
 // description of the following op.
 
@@ -193,6 +212,8 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
             num_parallel_calls_(std::make_shared<model::SharedState>(
                 params.dataset->num_parallel_calls_, mu_, cond_var_)),
             sloppy_(sloppy),
+            future_elements_limit_(
+                FutureElementsLimit(params.dataset->cycle_length_)),
             current_elements_(params.dataset->cycle_length_),
             thread_pool_(absl::make_unique<thread::ThreadPool>(
                 Env::Default(), ThreadOptions(),
@@ -589,7 +610,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
         auto cleanup = gtl::MakeCleanup([this, ctx] { RecordStop(ctx.get()); });
         auto busy = [this]() EXCLUSIVE_LOCKS_REQUIRED(*mu_) -> bool {
           // TODO(jsimsa): Autotune the number of iterators to prefetch.
-          return future_elements_.size() >= 2 * dataset()->cycle_length_;
+          return future_elements_.size() >= future_elements_limit_;
         };
         while (true) {
           mutex_lock l(*mu_);
@@ -889,6 +910,10 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
       // Determines whether outputs can be produced in non-deterministic order.
       const bool sloppy_;
 
+      // Maximum number of speculatively instantiated input iterators; see
+      // `FutureElementsLimit`.
+      const int64 future_elements_limit_;
+
       // Iterator for input elements.
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(*mu_);
 
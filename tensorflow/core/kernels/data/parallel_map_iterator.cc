@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/parallel_map_iterator.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <functional>
@@ -26,11 +27,27 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
+// Maximum number of positions ahead of the oldest in-flight element a
+// completed element may be emitted when deterministic output is
+// requested.  0 (the default) preserves strict input order; sloppy
+// mode ignores this and reorders without bound.  This bounds how long
+// one straggler (e.g. a large image) can stall the output window.
+int64 MaxReorderFromEnv() {
+  int64 max_reorder = 0;
+  Status status = ReadInt64FromEnvVar("TF_DATA_PARALLEL_MAP_MAX_REORDER", 0,
+                                      &max_reorder);
+  if (!status.ok()) {
+    LOG(ERROR) << "ParallelMapIterator: " << status.error_message();
+  }
+  return std::max(max_reorder, int64{0});
+}
+
 class ParallelMapIterator : public DatasetBaseIterator {
  public:
   struct Params {
@@ -58,7 +75,8 @@ class ParallelMapIterator : public DatasetBaseIterator {
         num_parallel_calls_(std::make_shared<model::SharedState>(
             params.num_parallel_calls, mu_, cond_var_)),
         sloppy_(params.sloppy),
-        preserve_cardinality_(params.preserve_cardinality) {
+        preserve_cardinality_(params.preserve_cardinality),
+        max_reorder_(MaxReorderFromEnv()) {
     key_prefix_ = base_params.dataset->node_name();
   }
 
@@ -341,6 +359,22 @@ class ParallelMapIterator : public DatasetBaseIterator {
           return false;
         }
       }
+    } else if (max_reorder_ > 0) {
+      // Bounded reordering: emit the earliest completed element that is
+      // at most `max_reorder_` positions ahead of strict input order,
+      // so one straggler only delays elements outside the window.
+      int64 position = 0;
+      for (auto it = invocation_results_.begin();
+           it != invocation_results_.end() && position <= max_reorder_;
+           ++it, ++position) {
+        if ((*it)->notification.HasBeenNotified() &&
+            (it == invocation_results_.begin() || !(*it)->end_of_input)) {
+          std::swap(*result, *it);
+          invocation_results_.erase(it);
+          cond_var_->notify_all();
+          return false;
+        }
+      }
     } else if (!invocation_results_.empty()) {
       std::swap(*result, invocation_results_.front());
       invocation_results_.pop_front();
@@ -403,6 +437,9 @@ class ParallelMapIterator : public DatasetBaseIterator {
   // Determines whether outputs can be produced in non-deterministic order.
   const bool sloppy_;
   const bool preserve_cardinality_;
+  // Size of the bounded-reordering window applied when `sloppy_` is
+  // false; see `MaxReorderFromEnv`.
+  const int64 max_reorder_;
   // Counts the number of outstanding calls.
   int64 num_calls_ GUARDED_BY(*mu_) = 0;
   std::unique_ptr<IteratorBase> input_impl_;
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/data/prefetch_autotuner.h"
 
+#include <algorithm>
+
 namespace tensorflow {
 namespace data {
 
@@ -33,7 +35,41 @@ namespace {
 size_t kBufferLimitThreshold = 2048;
 }  // namespace
 
+void PrefetchAutotuner::RecordBufferedBytes(int64 buffered_bytes,
+                                            size_t current_buffer_size) {
+  if (current_buffer_size == 0 || buffered_bytes <= 0) {
+    return;
+  }
+  const double estimate =
+      static_cast<double>(buffered_bytes) / current_buffer_size;
+  if (bytes_per_element_ == 0.0) {
+    bytes_per_element_ = estimate;
+  } else {
+    // Exponential moving average so one oversized element does not
+    // permanently skew the footprint estimate.
+    bytes_per_element_ = 0.9 * bytes_per_element_ + 0.1 * estimate;
+  }
+}
+
+int64 PrefetchAutotuner::AffordableLimit() const {
+  if (byte_budget_ <= 0 || bytes_per_element_ <= 0.0) {
+    return buffer_limit_;
+  }
+  return std::max(int64{1},
+                  static_cast<int64>(byte_budget_ / bytes_per_element_));
+}
+
 void PrefetchAutotuner::RecordConsumption(size_t current_buffer_size) {
+  if (mode_ != Mode::kDisabled && byte_budget_ > 0) {
+    const int64 affordable = AffordableLimit();
+    if (buffer_limit_ > affordable) {
+      // Our share of the pipeline budget shrank; yield memory to
+      // hotter buffers.
+      buffer_limit_ = affordable;
+      mode_ = Mode::kUpswing;
+      return;
+    }
+  }
   switch (mode_) {
     case Mode::kDisabled:
       return;
@@ -44,12 +80,19 @@ void PrefetchAutotuner::RecordConsumption(size_t current_buffer_size) {
       return;
     case Mode::kDownswing:
       if (current_buffer_size == 0) {
+        int64 new_limit;
         if (buffer_limit_ >= kBufferLimitThreshold) {
-          buffer_limit_ += kBufferLimitThreshold;
+          new_limit = buffer_limit_ + kBufferLimitThreshold;
         } else {
-          buffer_limit_ *= 2;
+          new_limit = buffer_limit_ * 2;
+        }
+        if (byte_budget_ > 0) {
+          new_limit = std::min(new_limit, AffordableLimit());
+        }
+        if (new_limit > buffer_limit_) {
+          buffer_limit_ = new_limit;
+          mode_ = Mode::kUpswing;
         }
-        mode_ = Mode::kUpswing;
       }
       return;
   }
@@ -33,8 +33,8 @@ namespace data {
 // if the prefetching thread is able to successfully fill the buffer at its
 // current size.
 //
-// Note: in the current implementation, we never decrease the buffer_limit().
-// This should change in the future!
+// Note: in the current implementation, the buffer_limit() only decreases when
+// a byte budget is in effect (see SetByteBudget); otherwise it only grows.
 //
 // PrefetchAutotuner is NOT thread safe.
 class PrefetchAutotuner {
@@ -48,6 +48,17 @@ class PrefetchAutotuner {
   void RecordConsumption(size_t current_buffer_size);
   void RecordEmpty() { RecordConsumption(0); }
 
+  // Sets the byte budget for the buffer; 0 (the default) means
+  // unlimited.  Budgets are distributed across the pipeline's buffers
+  // by `model::Model::OptimizeBuffers`.  When the budget would be
+  // exceeded the buffer limit stops growing, and if the budget shrinks
+  // below the current footprint the limit is reduced.
+  void SetByteBudget(int64 budget_bytes) { byte_budget_ = budget_bytes; }
+
+  // Records the number of bytes currently buffered, used to estimate
+  // the per-element footprint that the byte budget is applied to.
+  void RecordBufferedBytes(int64 buffered_bytes, size_t current_buffer_size);
+
  private:
   // PrefetchAutotuner operates as a state machine.
   enum class Mode {
@@ -63,7 +74,13 @@ class PrefetchAutotuner {
     kDownswing,
   };
 
+  // Returns the largest buffer limit the byte budget allows, or the
+  // current limit if no budget or footprint estimate is available.
+  int64 AffordableLimit() const;
+
   int64 buffer_limit_;
+  int64 byte_budget_ = 0;
+  double bytes_per_element_ = 0.0;
   Mode mode_ = Mode::kDisabled;
 };
 
@@ -79,6 +79,39 @@ TEST(PrefetchAutotuner, EnabledSteady) {
   }
 }
 
+TEST(PrefetchAutotuner, ByteBudgetCapsGrowth) {
+  PrefetchAutotuner t(PrefetchAutotuner::kAutoTune);
+  // Each element occupies 100 bytes; the budget fits 4 of them.
+  t.SetByteBudget(400);
+  t.RecordBufferedBytes(100, 1);
+  EXPECT_EQ(1, t.buffer_limit());
+  t.RecordConsumption(1);
+  t.RecordConsumption(0);  // Expect buffer limit to increase.
+  EXPECT_EQ(2, t.buffer_limit());
+  t.RecordBufferedBytes(200, 2);
+  t.RecordConsumption(2);
+  t.RecordConsumption(0);  // Expect buffer limit to increase.
+  EXPECT_EQ(4, t.buffer_limit());
+  t.RecordBufferedBytes(400, 4);
+  t.RecordConsumption(4);
+  t.RecordConsumption(0);  // Budget exhausted; expect no increase.
+  EXPECT_EQ(4, t.buffer_limit());
+}
+
+TEST(PrefetchAutotuner, ByteBudgetShrinksColdBuffer) {
+  PrefetchAutotuner t(PrefetchAutotuner::kAutoTune);
+  t.RecordConsumption(1);
+  t.RecordConsumption(0);
+  t.RecordConsumption(2);
+  t.RecordConsumption(0);
+  EXPECT_EQ(4, t.buffer_limit());
+  // A shrinking budget share reduces the limit below its current value.
+  t.SetByteBudget(200);
+  t.RecordBufferedBytes(400, 4);
+  t.RecordConsumption(4);
+  EXPECT_EQ(2, t.buffer_limit());
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
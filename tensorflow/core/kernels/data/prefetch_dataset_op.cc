@@ -285,6 +285,15 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
         *out_tensors = std::move(buffer_.front().value);
         RecordBufferDequeue(ctx, *out_tensors);
       }
+      if (model_node() != nullptr) {
+        // Feed the autotuner its share of the pipeline-wide buffer
+        // budget and the measured footprint of the buffered elements.
+        auto_tuner_.SetByteBudget(model_node()->buffer_budget_bytes());
+        // The front element was already dequeued from the model's
+        // accounting but not yet popped from the buffer.
+        auto_tuner_.RecordBufferedBytes(model_node()->buffered_bytes(),
+                                        buffer_.size() - 1);
+      }
       auto_tuner_.RecordConsumption(buffer_.size());
       buffer_.pop_front();
       *end_of_sequence = false;
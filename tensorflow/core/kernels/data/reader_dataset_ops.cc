@@ -12,16 +12,21 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <algorithm>
+
 #include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -737,6 +742,35 @@ REGISTER_KERNEL_BUILDER(Name("FixedLengthRecordDatasetV2").Device(DEVICE_CPU),
 
 constexpr char kTFRecordDatasetName[] = "TFRecord";
 
+// Returns true if uncompressed TFRecord files should be read through a
+// read-only memory mapping instead of `SequentialRecordReader`. The mapped
+// path avoids the input stream's per-record copy and makes the data CRC
+// check optional (see `TFRecordCrcSampleRate()`), which helps parse-bound
+// pipelines replaying records from local SSD.
+bool TFRecordMmapEnabled() {
+  bool mmap_enabled = false;
+  Status status =
+      ReadBoolFromEnvVar("TF_DATA_TFRECORD_MMAP", false, &mmap_enabled);
+  if (!status.ok()) {
+    LOG(ERROR) << "TFRecordDataset: " << status.error_message();
+  }
+  return mmap_enabled;
+}
+
+// Returns N such that the memory-mapped read path verifies the masked data
+// CRC of one in every N records (1 == verify every record, the default).
+// Only applies when `TF_DATA_TFRECORD_MMAP` is set; the buffered read path
+// always verifies.
+int64 TFRecordCrcSampleRate() {
+  int64 sample_rate = 1;
+  Status status = ReadInt64FromEnvVar("TF_DATA_TFRECORD_CRC_SAMPLE_RATE", 1,
+                                      &sample_rate);
+  if (!status.ok()) {
+    LOG(ERROR) << "TFRecordDataset: " << status.error_message();
+  }
+  return std::max(sample_rate, int64{1});
+}
+
 class TFRecordDatasetOp : public DatasetOpKernel {
  public:
   using DatasetOpKernel::DatasetOpKernel;
@@ -823,50 +857,32 @@ class TFRecordDatasetOp : public DatasetOpKernel {
     class Iterator : public DatasetIterator<Dataset> {
      public:
       explicit Iterator(const Params& params)
-          : DatasetIterator<Dataset>(params) {}
+          : DatasetIterator<Dataset>(params),
+            mmap_enabled_(TFRecordMmapEnabled()),
+            crc_sample_rate_(TFRecordCrcSampleRate()) {}
 
       Status GetNextInternal(IteratorContext* ctx,
                              std::vector<Tensor>* out_tensors,
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
-        do {
-          // We are currently processing a file, so try to read the next record.
-          if (reader_) {
-            out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
-                                      TensorShape({}));
-            Status s =
-                reader_->ReadRecord(&out_tensors->back().scalar<string>()());
-            if (s.ok()) {
-              metrics::RecordTFDataBytesRead(
-                  kTFRecordDatasetName,
-                  out_tensors->back().scalar<string>()().size());
-              *end_of_sequence = false;
-              return Status::OK();
-            }
-            out_tensors->pop_back();
-            if (!errors::IsOutOfRange(s)) {
-              // In case of other errors e.g., DataLoss, we still move forward
-              // the file index so that it works with ignore_errors.
-              // Otherwise the same file will repeat.
-              ResetStreamsLocked();
-              ++current_file_index_;
-              return s;
-            }
-
-            // We have reached the end of the current file, so maybe
-            // move on to next file.
-            ResetStreamsLocked();
-            ++current_file_index_;
-          }
+        out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
+                                  TensorShape({}));
+        Status s = ReadNextRecordLocked(
+            ctx, &out_tensors->back().scalar<string>()(), end_of_sequence);
+        if (!s.ok() || *end_of_sequence) {
+          out_tensors->pop_back();
+        }
+        return s;
+      }
 
-          // Iteration ends when there are no more files to process.
-          if (current_file_index_ == dataset()->filenames_.size()) {
-            *end_of_sequence = true;
-            return Status::OK();
-          }
+      bool SupportsSlicedOutput() const override { return true; }
 
-          TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-        } while (true);
+      Status GetNextSlice(IteratorContext* ctx,
+                          std::vector<Tensor>* batch_tensors, int64 index,
+                          bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        return ReadNextRecordLocked(
+            ctx, &(*batch_tensors)[0].flat<string>()(index), end_of_sequence);
       }
 
      protected:
@@ -883,6 +899,9 @@ class TFRecordDatasetOp : public DatasetOpKernel {
         if (reader_) {
           TF_RETURN_IF_ERROR(
               writer->WriteScalar(full_name("offset"), reader_->TellOffset()));
+        } else if (region_) {
+          TF_RETURN_IF_ERROR(writer->WriteScalar(
+              full_name("offset"), static_cast<int64>(mmap_offset_)));
         }
         return Status::OK();
       }
@@ -899,12 +918,59 @@ class TFRecordDatasetOp : public DatasetOpKernel {
           int64 offset;
           TF_RETURN_IF_ERROR(reader->ReadScalar(full_name("offset"), &offset));
           TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-          TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+          if (region_) {
+            // Both paths checkpoint a byte offset into the file, so a
+            // checkpoint written by one path can be restored by the other.
+            mmap_offset_ = static_cast<uint64>(offset);
+          } else {
+            TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+          }
         }
         return Status::OK();
       }
 
      private:
+      // Reads the next record into `*record`, advancing through the file
+      // list as needed. `*record` is left unmodified at end of sequence.
+      Status ReadNextRecordLocked(IteratorContext* ctx, string* record,
+                                  bool* end_of_sequence)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        do {
+          // We are currently processing a file, so try to read the next record.
+          if (reader_ || region_) {
+            Status s = region_ ? ReadRecordFromRegionLocked(record)
+                               : reader_->ReadRecord(record);
+            if (s.ok()) {
+              metrics::RecordTFDataBytesRead(kTFRecordDatasetName,
+                                             record->size());
+              *end_of_sequence = false;
+              return Status::OK();
+            }
+            if (!errors::IsOutOfRange(s)) {
+              // In case of other errors e.g., DataLoss, we still move forward
+              // the file index so that it works with ignore_errors.
+              // Otherwise the same file will repeat.
+              ResetStreamsLocked();
+              ++current_file_index_;
+              return s;
+            }
+
+            // We have reached the end of the current file, so maybe
+            // move on to next file.
+            ResetStreamsLocked();
+            ++current_file_index_;
+          }
+
+          // Iteration ends when there are no more files to process.
+          if (current_file_index_ == dataset()->filenames_.size()) {
+            *end_of_sequence = true;
+            return Status::OK();
+          }
+
+          TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+        } while (true);
+      }
+
       // Sets up reader streams to read from the file at `current_file_index_`.
       Status SetupStreamsLocked(Env* env) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         if (current_file_index_ >= dataset()->filenames_.size()) {
@@ -916,6 +982,17 @@ class TFRecordDatasetOp : public DatasetOpKernel {
         // Actually move on to next file.
         const string& next_filename =
             dataset()->filenames_[current_file_index_];
+        if (mmap_enabled_ && dataset()->compression_type_.empty()) {
+          Status s = env->NewReadOnlyMemoryRegionFromFile(next_filename,
+                                                          &region_);
+          if (s.ok()) {
+            mmap_offset_ = 0;
+            return Status::OK();
+          }
+          LOG(WARNING) << "Failed to memory-map " << next_filename << ": "
+                       << s.error_message()
+                       << "; falling back to buffered reads.";
+        }
         TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file_));
         reader_ = absl::make_unique<io::SequentialRecordReader>(
             file_.get(), dataset()->options_);
@@ -926,8 +1003,54 @@ class TFRecordDatasetOp : public DatasetOpKernel {
       void ResetStreamsLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         reader_.reset();
         file_.reset();
+        region_.reset();
+      }
+
+      // Reads the record at `mmap_offset_` directly out of the mapped file.
+      // The record length CRC is always checked, since a corrupt length
+      // would otherwise derail the reader for the rest of the file; the
+      // data CRC is checked for one in every `crc_sample_rate_` records.
+      Status ReadRecordFromRegionLocked(string* record)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const char* base = reinterpret_cast<const char*>(region_->data());
+        const uint64 file_size = region_->length();
+        if (mmap_offset_ == file_size) {
+          return errors::OutOfRange("eof");
+        }
+        if (mmap_offset_ + io::RecordReader::kHeaderSize > file_size) {
+          return errors::DataLoss("truncated record header at ",
+                                  mmap_offset_);
+        }
+        const char* header = base + mmap_offset_;
+        const uint64 length = core::DecodeFixed64(header);
+        if (core::DecodeFixed32(header + sizeof(uint64)) !=
+            crc32c::Mask(crc32c::Value(header, sizeof(uint64)))) {
+          return errors::DataLoss("corrupted record length at ",
+                                  mmap_offset_);
+        }
+        const uint64 data_offset = mmap_offset_ + io::RecordReader::kHeaderSize;
+        if (data_offset + length + io::RecordReader::kFooterSize > file_size) {
+          return errors::DataLoss("truncated record at ", mmap_offset_);
+        }
+        const char* data = base + data_offset;
+        if (crc_sample_rate_ <= 1 ||
+            num_records_read_ % crc_sample_rate_ == 0) {
+          if (core::DecodeFixed32(data + length) !=
+              crc32c::Mask(crc32c::Value(data, length))) {
+            return errors::DataLoss("corrupted record at ", mmap_offset_);
+          }
+        }
+        // DT_STRING tensors own their payload, so one copy out of the
+        // mapped region is unavoidable.
+        record->assign(data, length);
+        mmap_offset_ = data_offset + length + io::RecordReader::kFooterSize;
+        ++num_records_read_;
+        return Status::OK();
       }
 
+      const bool mmap_enabled_;
+      const int64 crc_sample_rate_;
+
       mutex mu_;
       size_t current_file_index_ GUARDED_BY(mu_) = 0;
 
@@ -935,6 +1058,12 @@ class TFRecordDatasetOp : public DatasetOpKernel {
       // we must destroy `reader_` before `file_`.
       std::unique_ptr<RandomAccessFile> file_ GUARDED_BY(mu_);
       std::unique_ptr<io::SequentialRecordReader> reader_ GUARDED_BY(mu_);
+
+      // Set instead of `file_` and `reader_` when the current file is
+      // memory-mapped.
+      std::unique_ptr<ReadOnlyMemoryRegion> region_ GUARDED_BY(mu_);
+      uint64 mmap_offset_ GUARDED_BY(mu_) = 0;
+      int64 num_records_read_ GUARDED_BY(mu_) = 0;
     };
 
     const std::vector<string> filenames_;
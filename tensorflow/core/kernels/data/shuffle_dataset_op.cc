@@ -13,16 +13,26 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <deque>
+#include <set>
 #include <vector>
 
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
+#include "tensorflow/core/protobuf/data/experimental/snapshot.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -32,6 +42,62 @@ const int64 kLogIntervalMicros = 10 * 1000000;  // 10 seconds.
 
 const int64 kMaxEpochsInBuffer = 3;
 
+// Number of spill files written concurrently when external shuffling is
+// enabled. Each incoming element is routed to one of these files uniformly at
+// random, so together with the random file visitation order and the in-memory
+// shuffle of each file at readback, the output order is near-uniform.
+const int kExternalShuffleNumBuckets = 16;
+
+const int64 kExternalShuffleReaderBufferSize = 8 << 20;  // 8 MB.
+
+// When set to a writable directory, the shuffle buffer is spilled to
+// size-capped record files in that directory instead of holding `buffer_size`
+// elements in host memory. This makes it possible to shuffle datasets much
+// larger than RAM with a fixed memory footprint and sequential disk I/O.
+// Returns an empty string when external shuffling is disabled.
+string ExternalShuffleDir() {
+  string dir;
+  Status status = ReadStringFromEnvVar("TF_DATA_EXTERNAL_SHUFFLE_DIR", "", &dir);
+  if (!status.ok()) {
+    LOG(ERROR) << "ExternalShuffleDir: " << status.error_message();
+  }
+  return dir;
+}
+
+// Cap on the size of an individual spill file. Each file is loaded back into
+// memory and shuffled as a unit, so this bounds the RAM footprint of external
+// shuffling.
+int64 ExternalShuffleMaxFileBytes() {
+  int64 max_file_mb = 256;
+  Status status = ReadInt64FromEnvVar("TF_DATA_EXTERNAL_SHUFFLE_FILE_MB", 256,
+                                      &max_file_mb);
+  if (!status.ok()) {
+    LOG(ERROR) << "ExternalShuffleMaxFileBytes: " << status.error_message();
+  }
+  return std::max(max_file_mb, int64{1}) << 20;
+}
+
+// Number of delta files an incremental shuffle-buffer checkpoint may
+// accumulate before the next save writes a full snapshot of the live buffer
+// instead of another delta, bounding the cost of a restore.
+const int64 kMaxShuffleCheckpointDeltas = 8;
+
+// When set to a writable directory, checkpoints of the shuffle buffer are
+// written incrementally to record files in that directory: each save persists
+// only the buffer slots that changed since the previous save, and the graph
+// checkpoint stores just the file names. For large buffers this makes
+// periodic input-pipeline checkpoints cost seconds instead of minutes.
+// Returns an empty string when incremental checkpointing is disabled.
+string ShuffleCheckpointDir() {
+  string dir;
+  Status status =
+      ReadStringFromEnvVar("TF_DATA_SHUFFLE_CHECKPOINT_DIR", "", &dir);
+  if (!status.ok()) {
+    LOG(ERROR) << "ShuffleCheckpointDir: " << status.error_message();
+  }
+  return dir;
+}
+
 // See documentation in ../../ops/dataset_ops.cc for a high-level
 // description of the following op.
 
@@ -86,16 +152,53 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
             epoch_(0),
             num_elements_(0),
             parent_generator_(seed, seed2),
-            generator_(&parent_generator_) {
-        buffer_ = absl::make_unique<std::vector<Tensor>[]>(
-            params.dataset->buffer_size_);
+            generator_(&parent_generator_),
+            external_dir_(ExternalShuffleDir()),
+            checkpoint_dir_(ShuffleCheckpointDir()) {
+        if (!external_dir_.empty() && params.dataset->count_ != 1) {
+          LOG(WARNING) << "TF_DATA_EXTERNAL_SHUFFLE_DIR is ignored because "
+                          "the shuffle dataset repeats its input; falling "
+                          "back to the in-memory shuffle buffer.";
+        }
+        external_shuffle_ =
+            !external_dir_.empty() && params.dataset->count_ == 1;
+        incremental_checkpoint_ = !checkpoint_dir_.empty() && !external_shuffle_;
+        if (!external_shuffle_) {
+          buffer_ = absl::make_unique<std::vector<Tensor>[]>(
+              params.dataset->buffer_size_);
+        }
         slices_.push_back(absl::make_unique<Slice>(0, 0));
       }
 
+      ~Iterator() override {
+        string run_dir;
+        {
+          mutex_lock l(mu_);
+          cancelled_ = true;
+          readback_cond_.notify_all();
+          run_dir = external_run_dir_;
+        }
+        // Joins the readback thread, if one was started.
+        readback_thread_.reset();
+        if (!run_dir.empty()) {
+          int64 undeleted_files = 0;
+          int64 undeleted_dirs = 0;
+          Status s = Env::Default()->DeleteRecursively(
+              run_dir, &undeleted_files, &undeleted_dirs);
+          if (!s.ok()) {
+            LOG(WARNING) << "Failed to delete external shuffle directory "
+                         << run_dir << ": " << s;
+          }
+        }
+      }
+
       Status GetNextInternal(IteratorContext* ctx,
                              std::vector<Tensor>* out_tensors,
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
+        if (external_shuffle_) {
+          return GetNextExternalLocked(ctx, &l, out_tensors, end_of_sequence);
+        }
         int64 start_micros = ctx->env()->NowMicros();
         int64 num_log_entries = 0;
         bool first_call = false;
@@ -144,6 +247,10 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
             this->RecordBufferEnqueue(ctx, input_element);
             buffer_[slices_.back()->end % this->dataset()->buffer_size_] =
                 std::move(input_element);
+            if (incremental_checkpoint_) {
+              dirty_indices_.insert(slices_.back()->end %
+                                    this->dataset()->buffer_size_);
+            }
             num_elements_++;
             slices_.back()->end++;
           } else {
@@ -181,6 +288,11 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
           std::swap(
               buffer_[index],
               buffer_[slices_.front()->start % this->dataset()->buffer_size_]);
+          if (incremental_checkpoint_) {
+            // `index` now holds the former front of the slice; the front
+            // slot itself becomes dead and need not be marked.
+            dirty_indices_.insert(index);
+          }
           slices_.front()->start++;
           num_elements_--;
         } else {
@@ -207,6 +319,11 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
 
       Status SaveInternal(IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
+        if (external_shuffle_) {
+          return errors::Unimplemented(
+              "Checkpointing is not supported when "
+              "TF_DATA_EXTERNAL_SHUFFLE_DIR is set.");
+        }
         // Save state needed to restore the random number generators.
         TF_RETURN_IF_ERROR(writer->WriteScalar(
             this->full_name("num_random_samples"), num_random_samples_));
@@ -237,6 +354,9 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
           TF_RETURN_IF_ERROR(writer->WriteScalar(
               this->full_name(strings::StrCat("slices_end_", i)),
               slices_[i]->end));
+          if (incremental_checkpoint_) {
+            continue;
+          }
           for (size_t j = slices_[i]->start; j < slices_[i]->end; ++j) {
             size_t index = j % this->dataset()->buffer_size_;
             TF_RETURN_IF_ERROR(writer->WriteScalar(
@@ -250,12 +370,34 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
           }
         }
 
+        if (incremental_checkpoint_) {
+          // Persist the buffer contents to a side file holding only the
+          // slots dirtied since the previous save; the checkpoint itself
+          // records just the chain of delta files.
+          TF_RETURN_IF_ERROR(WriteCheckpointDeltaLocked());
+          TF_RETURN_IF_ERROR(writer->WriteScalar(
+              this->full_name("checkpoint_run_dir"), checkpoint_run_dir_));
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(this->full_name("delta_files_size"),
+                                  static_cast<int64>(delta_files_.size())));
+          for (size_t i = 0; i < delta_files_.size(); ++i) {
+            TF_RETURN_IF_ERROR(writer->WriteScalar(
+                this->full_name(strings::StrCat("delta_file_", i)),
+                delta_files_[i]));
+          }
+        }
+
         return Status::OK();
       }
 
       Status RestoreInternal(IteratorContext* ctx,
                              IteratorStateReader* reader) override {
         mutex_lock l(mu_);
+        if (external_shuffle_) {
+          return errors::Unimplemented(
+              "Checkpointing is not supported when "
+              "TF_DATA_EXTERNAL_SHUFFLE_DIR is set.");
+        }
         // Restore the random number generators.
         TF_RETURN_IF_ERROR(reader->ReadScalar(
             this->full_name("num_random_samples"), &num_random_samples_));
@@ -287,6 +429,8 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
         }
         buffer_ = absl::make_unique<std::vector<Tensor>[]>(
             this->dataset()->buffer_size_);
+        const bool restore_from_deltas =
+            reader->Contains(this->full_name("checkpoint_run_dir"));
         for (size_t i = 0; i < slices_size; ++i) {
           int64 start;
           TF_RETURN_IF_ERROR(reader->ReadScalar(
@@ -295,6 +439,9 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
           TF_RETURN_IF_ERROR(reader->ReadScalar(
               this->full_name(strings::StrCat("slices_end_", i)), &end));
           slices_.push_back(absl::make_unique<Slice>(start, end));
+          if (restore_from_deltas) {
+            continue;
+          }
           for (size_t j = start; j < end; ++j) {
             size_t index = j % this->dataset()->buffer_size_;
             int64 list_size;
@@ -310,6 +457,24 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
           }
         }
 
+        if (restore_from_deltas) {
+          TF_RETURN_IF_ERROR(reader->ReadScalar(
+              this->full_name("checkpoint_run_dir"), &checkpoint_run_dir_));
+          int64 delta_files_size;
+          TF_RETURN_IF_ERROR(reader->ReadScalar(
+              this->full_name("delta_files_size"), &delta_files_size));
+          delta_files_.clear();
+          for (int64 i = 0; i < delta_files_size; ++i) {
+            string filename;
+            TF_RETURN_IF_ERROR(reader->ReadScalar(
+                this->full_name(strings::StrCat("delta_file_", i)),
+                &filename));
+            delta_files_.push_back(std::move(filename));
+          }
+          TF_RETURN_IF_ERROR(ReadCheckpointDeltasLocked(ctx->env()));
+          dirty_indices_.clear();
+        }
+
         return Status::OK();
       }
 
@@ -337,6 +502,329 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
         return out;
       }
 
+      // One of the concurrently written spill files used by external
+      // shuffling.
+      struct SpillBucket {
+        std::unique_ptr<WritableFile> file;
+        std::unique_ptr<io::RecordWriter> writer;
+        string filename;
+        int64 bytes = 0;
+      };
+
+      // Finishes writing `bucket` and queues its file for readback.
+      Status CloseSpillBucket(SpillBucket* bucket)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        TF_RETURN_IF_ERROR(bucket->writer->Close());
+        bucket->writer.reset();
+        TF_RETURN_IF_ERROR(bucket->file->Close());
+        bucket->file.reset();
+        spilled_files_.push_back(std::move(bucket->filename));
+        bucket->bytes = 0;
+        return Status::OK();
+      }
+
+      // Consumes the entire input, routing each element to one of
+      // `kExternalShuffleNumBuckets` spill files chosen uniformly at random.
+      // A bucket file is rotated once it exceeds the size cap so that any
+      // single file can later be shuffled within a fixed RAM footprint.
+      Status SpillInputLocked(IteratorContext* ctx)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        external_run_dir_ = io::JoinPath(
+            external_dir_,
+            strings::StrCat("tf_data_shuffle_", random::New64()));
+        TF_RETURN_IF_ERROR(ctx->env()->RecursivelyCreateDir(external_run_dir_));
+        const int64 max_file_bytes = ExternalShuffleMaxFileBytes();
+        TF_RETURN_IF_ERROR(this->dataset()->input_->MakeIterator(
+            ctx, this->prefix(), &input_impl_));
+        std::vector<SpillBucket> buckets(kExternalShuffleNumBuckets);
+        int64 next_file_id = 0;
+        int64 num_elements = 0;
+        int64 start_micros = ctx->env()->NowMicros();
+        int64 num_log_entries = 0;
+        while (true) {
+          if (ctx->env()->NowMicros() >
+              ((num_log_entries + 1) * kLogIntervalMicros) + start_micros) {
+            num_log_entries++;
+            LOG(INFO) << "Spilling shuffle buffer to disk (this may take a "
+                         "while): "
+                      << num_elements << " elements written";
+          }
+          std::vector<Tensor> element;
+          bool end_of_input_sequence = false;
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, &element, &end_of_input_sequence));
+          if (end_of_input_sequence) {
+            break;
+          }
+          SpillBucket* bucket = &buckets[Random() % kExternalShuffleNumBuckets];
+          if (!bucket->writer) {
+            bucket->filename = io::JoinPath(
+                external_run_dir_,
+                strings::StrCat("bucket_", next_file_id++, ".tfrecord"));
+            TF_RETURN_IF_ERROR(
+                ctx->env()->NewWritableFile(bucket->filename, &bucket->file));
+            bucket->writer =
+                absl::make_unique<io::RecordWriter>(bucket->file.get());
+          }
+          experimental::SnapshotRecord record;
+          for (const auto& t : element) {
+            t.AsProtoTensorContent(record.add_tensor());
+          }
+          const string serialized = record.SerializeAsString();
+          TF_RETURN_IF_ERROR(bucket->writer->WriteRecord(serialized));
+          bucket->bytes += serialized.size();
+          num_elements++;
+          if (bucket->bytes >= max_file_bytes) {
+            TF_RETURN_IF_ERROR(CloseSpillBucket(bucket));
+          }
+        }
+        input_impl_.reset();
+        for (auto& bucket : buckets) {
+          if (bucket.writer) {
+            TF_RETURN_IF_ERROR(CloseSpillBucket(&bucket));
+          }
+        }
+        LOG(INFO) << "Spilled " << num_elements << " elements to "
+                  << spilled_files_.size() << " files under "
+                  << external_run_dir_;
+        return Status::OK();
+      }
+
+      // Reads all elements of a spill file into memory and then deletes the
+      // file to reclaim the disk space eagerly.
+      Status ReadSpillFile(Env* env, const string& filename,
+                           std::vector<std::vector<Tensor>>* elements) {
+        std::unique_ptr<RandomAccessFile> file;
+        TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+        io::RecordReaderOptions options;
+        options.buffer_size = kExternalShuffleReaderBufferSize;
+        io::SequentialRecordReader reader(file.get(), options);
+        while (true) {
+          string record_bytes;
+          Status s = reader.ReadRecord(&record_bytes);
+          if (errors::IsOutOfRange(s)) {
+            break;
+          }
+          TF_RETURN_IF_ERROR(s);
+          experimental::SnapshotRecord record;
+          if (!record.ParseFromString(record_bytes)) {
+            return errors::DataLoss(
+                "Failed to parse spilled shuffle record in ", filename);
+          }
+          std::vector<Tensor> element;
+          element.reserve(record.tensor_size());
+          for (const auto& proto : record.tensor()) {
+            Tensor t;
+            if (!t.FromProto(proto)) {
+              return errors::DataLoss(
+                  "Failed to parse spilled shuffle tensor in ", filename);
+            }
+            element.push_back(std::move(t));
+          }
+          elements->push_back(std::move(element));
+        }
+        Status s = env->DeleteFile(filename);
+        if (!s.ok()) {
+          LOG(WARNING) << "Failed to delete spill file " << filename << ": "
+                       << s;
+        }
+        return Status::OK();
+      }
+
+      // Appends one delta file holding the live buffer slots dirtied since
+      // the previous save, or a full snapshot of the live buffer when the
+      // delta chain has grown past `kMaxShuffleCheckpointDeltas`. Files are
+      // never deleted here: earlier checkpoints may still reference them,
+      // so the directory follows the same retention policy as the
+      // checkpoints that point into it.
+      Status WriteCheckpointDeltaLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        Env* env = Env::Default();
+        if (checkpoint_run_dir_.empty()) {
+          checkpoint_run_dir_ = io::JoinPath(
+              checkpoint_dir_,
+              strings::StrCat("tf_data_shuffle_ckpt_", random::New64()));
+          TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(checkpoint_run_dir_));
+        }
+        const bool full_snapshot =
+            delta_files_.size() >=
+            static_cast<size_t>(kMaxShuffleCheckpointDeltas);
+        if (full_snapshot) {
+          delta_files_.clear();
+        }
+        const string filename = io::JoinPath(
+            checkpoint_run_dir_,
+            strings::StrCat("delta_", random::New64(), ".tfrecord"));
+        std::unique_ptr<WritableFile> file;
+        TF_RETURN_IF_ERROR(env->NewWritableFile(filename, &file));
+        io::RecordWriter writer(file.get());
+        int64 num_slots = 0;
+        for (const auto& slice : slices_) {
+          for (int64 j = slice->start; j < slice->end; ++j) {
+            size_t index = j % this->dataset()->buffer_size_;
+            if (!full_snapshot && dirty_indices_.count(index) == 0) {
+              continue;
+            }
+            experimental::SnapshotRecord record;
+            for (const auto& t : buffer_[index]) {
+              t.AsProtoTensorContent(record.add_tensor());
+            }
+            string data;
+            core::PutFixed64(&data, index);
+            record.AppendToString(&data);
+            TF_RETURN_IF_ERROR(writer.WriteRecord(data));
+            num_slots++;
+          }
+        }
+        TF_RETURN_IF_ERROR(writer.Close());
+        TF_RETURN_IF_ERROR(file->Close());
+        dirty_indices_.clear();
+        if (num_slots == 0) {
+          // Nothing changed since the last save; do not lengthen the chain.
+          Status s = env->DeleteFile(filename);
+          if (!s.ok()) {
+            LOG(WARNING) << "Failed to delete empty shuffle checkpoint delta "
+                         << filename << ": " << s;
+          }
+          return Status::OK();
+        }
+        delta_files_.push_back(filename);
+        return Status::OK();
+      }
+
+      // Replays the delta files referenced by a restored checkpoint, in
+      // order, to reconstruct the live buffer slots.
+      Status ReadCheckpointDeltasLocked(Env* env)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        for (const string& filename : delta_files_) {
+          std::unique_ptr<RandomAccessFile> file;
+          TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+          io::RecordReaderOptions options;
+          options.buffer_size = kExternalShuffleReaderBufferSize;
+          io::SequentialRecordReader reader(file.get(), options);
+          while (true) {
+            string record_bytes;
+            Status s = reader.ReadRecord(&record_bytes);
+            if (errors::IsOutOfRange(s)) {
+              break;
+            }
+            TF_RETURN_IF_ERROR(s);
+            if (record_bytes.size() < sizeof(uint64)) {
+              return errors::DataLoss(
+                  "Malformed shuffle checkpoint record in ", filename);
+            }
+            size_t index = core::DecodeFixed64(record_bytes.data());
+            if (index >= static_cast<size_t>(this->dataset()->buffer_size_)) {
+              return errors::DataLoss("Shuffle checkpoint slot ", index,
+                                      " is out of range in ", filename);
+            }
+            experimental::SnapshotRecord record;
+            if (!record.ParseFromArray(
+                    record_bytes.data() + sizeof(uint64),
+                    record_bytes.size() - sizeof(uint64))) {
+              return errors::DataLoss(
+                  "Failed to parse shuffle checkpoint record in ", filename);
+            }
+            std::vector<Tensor> element;
+            element.reserve(record.tensor_size());
+            for (const auto& proto : record.tensor()) {
+              Tensor t;
+              if (!t.FromProto(proto)) {
+                return errors::DataLoss(
+                    "Failed to parse shuffle checkpoint tensor in ", filename);
+              }
+              element.push_back(std::move(t));
+            }
+            buffer_[index] = std::move(element);
+          }
+        }
+        return Status::OK();
+      }
+
+      // Loads spill files back into memory one file ahead of consumption so
+      // that sequential disk reads overlap with downstream processing.
+      void ReadbackThread(Env* env) {
+        while (true) {
+          string filename;
+          {
+            mutex_lock l(mu_);
+            while (!cancelled_ && next_bucket_ready_) {
+              readback_cond_.wait(l);
+            }
+            if (cancelled_) {
+              return;
+            }
+            if (next_file_index_ >= spilled_files_.size()) {
+              return;
+            }
+            filename = spilled_files_[next_file_index_++];
+          }
+          std::vector<std::vector<Tensor>> elements;
+          Status s = ReadSpillFile(env, filename, &elements);
+          mutex_lock l(mu_);
+          readback_status_.Update(s);
+          next_bucket_ = std::move(elements);
+          next_bucket_ready_ = true;
+          readback_cond_.notify_all();
+          if (!readback_status_.ok()) {
+            return;
+          }
+        }
+      }
+
+      // Implements `GetNextInternal` when external shuffling is enabled. The
+      // first call spills the entire input to disk; subsequent calls emit
+      // elements from in-memory shuffled buckets that the readback thread
+      // loads one file ahead of consumption.
+      Status GetNextExternalLocked(IteratorContext* ctx, mutex_lock* l,
+                                   std::vector<Tensor>* out_tensors,
+                                   bool* end_of_sequence)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (!spill_done_) {
+          TF_RETURN_IF_ERROR(SpillInputLocked(ctx));
+          spill_done_ = true;
+          // Visit the spill files in random order.
+          for (size_t i = spilled_files_.size(); i > 1; --i) {
+            std::swap(spilled_files_[i - 1], spilled_files_[Random() % i]);
+          }
+          if (!spilled_files_.empty()) {
+            Env* env = ctx->env();
+            readback_thread_ = ctx->StartThread(
+                "tf_data_external_shuffle",
+                [this, env]() { ReadbackThread(env); });
+          }
+        }
+        while (true) {
+          if (current_bucket_pos_ < current_bucket_.size()) {
+            *out_tensors = std::move(current_bucket_[current_bucket_pos_++]);
+            *end_of_sequence = false;
+            if (current_bucket_pos_ == current_bucket_.size()) {
+              current_bucket_.clear();
+              current_bucket_pos_ = 0;
+            }
+            return Status::OK();
+          }
+          if (next_bucket_ready_) {
+            TF_RETURN_IF_ERROR(readback_status_);
+            current_bucket_ = std::move(next_bucket_);
+            next_bucket_.clear();
+            next_bucket_ready_ = false;
+            num_files_consumed_++;
+            readback_cond_.notify_all();
+            // Shuffle the loaded bucket in memory.
+            for (size_t i = current_bucket_.size(); i > 1; --i) {
+              std::swap(current_bucket_[i - 1],
+                        current_bucket_[Random() % i]);
+            }
+            continue;
+          }
+          if (num_files_consumed_ == spilled_files_.size()) {
+            *end_of_sequence = true;
+            return Status::OK();
+          }
+          readback_cond_.wait(*l);
+        }
+      }
+
       std::unique_ptr<std::vector<Tensor>[]> buffer_ GUARDED_BY(mu_);
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
       int64 epoch_ GUARDED_BY(mu_);
@@ -346,6 +834,32 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
       random::SingleSampleAdapter<random::PhiloxRandom> generator_
           GUARDED_BY(mu_);
       int64 num_random_samples_ GUARDED_BY(mu_) = 0;
+
+      // External-shuffle state; unused unless `external_shuffle_` is true.
+      // See `ExternalShuffleDir` for a description of the mode.
+      const string external_dir_;
+      bool external_shuffle_ = false;
+      string external_run_dir_ GUARDED_BY(mu_);
+      bool spill_done_ GUARDED_BY(mu_) = false;
+      std::vector<string> spilled_files_ GUARDED_BY(mu_);
+      std::vector<std::vector<Tensor>> current_bucket_ GUARDED_BY(mu_);
+      size_t current_bucket_pos_ GUARDED_BY(mu_) = 0;
+      std::vector<std::vector<Tensor>> next_bucket_ GUARDED_BY(mu_);
+      bool next_bucket_ready_ GUARDED_BY(mu_) = false;
+      Status readback_status_ GUARDED_BY(mu_);
+      size_t next_file_index_ GUARDED_BY(mu_) = 0;
+      size_t num_files_consumed_ GUARDED_BY(mu_) = 0;
+      bool cancelled_ GUARDED_BY(mu_) = false;
+      condition_variable readback_cond_;
+      std::unique_ptr<Thread> readback_thread_;
+
+      // Incremental-checkpoint state; unused unless `incremental_checkpoint_`
+      // is true. See `ShuffleCheckpointDir` for a description of the mode.
+      const string checkpoint_dir_;
+      bool incremental_checkpoint_ = false;
+      string checkpoint_run_dir_ GUARDED_BY(mu_);
+      std::vector<string> delta_files_ GUARDED_BY(mu_);
+      std::set<size_t> dirty_indices_ GUARDED_BY(mu_);
     };
 
     const DatasetBase* const input_;
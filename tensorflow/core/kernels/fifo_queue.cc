@@ -30,13 +30,39 @@ limitations under the License.
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/batch_util.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Opt-in for the lock-free ring variant. Read once per process; the
+// storage layout of a shared queue must not depend on which op created
+// it.
+bool LockFreeRingEnabled() {
+  static const bool enabled = [] {
+    bool value = false;
+    Status s = ReadBoolFromEnvVar("TF_FIFO_QUEUE_LOCK_FREE_RING", false,
+                                  &value);
+    if (!s.ok()) {
+      LOG(WARNING) << "Could not parse TF_FIFO_QUEUE_LOCK_FREE_RING: " << s;
+    }
+    return value;
+  }();
+  return enabled;
+}
+
+}  // namespace
+
 FIFOQueue::FIFOQueue(int capacity, const DataTypeVector& component_dtypes,
                      const std::vector<TensorShape>& component_shapes,
-                     const string& name)
-    : TypedQueue(capacity, component_dtypes, component_shapes, name) {}
+                     const string& name, bool allow_lock_free_ring)
+    : TypedQueue(capacity, component_dtypes, component_shapes, name) {
+  if (allow_lock_free_ring && LockFreeRingEnabled() && capacity > 0 &&
+      capacity < kUnbounded) {
+    ring_.reset(new MpmcRingBuffer<Element>(capacity));
+  }
+}
 
 void FIFOQueue::DequeueLocked(OpKernelContext* ctx, Tuple* tuple) {
   DCHECK_GT(queues_[0].size(), size_t{0});
@@ -47,8 +73,110 @@ void FIFOQueue::DequeueLocked(OpKernelContext* ctx, Tuple* tuple) {
   }
 }
 
+void FIFOQueue::FlushIfWaiters() {
+  // An attempt may have registered between the fast path's waiter check
+  // and its ring operation; re-checking after the operation closes the
+  // race (both sides use sequentially consistent operations, so either
+  // this load sees the waiter or the waiter's first run sees the ring
+  // operation).
+  if (num_pending_attempts_.load() != 0) FlushUnlocked();
+}
+
+bool FIFOQueue::TryFastEnqueue(const Tuple& tuple) {
+  if (ring_ == nullptr || closed_hint_.load() ||
+      num_pending_attempts_.load() != 0) {
+    return false;
+  }
+  Element element;
+  element.reserve(num_components());
+  for (int i = 0; i < num_components(); ++i) {
+    element.push_back(PersistentTensor(tuple[i]));
+  }
+  return ring_->TryPush(&element);
+}
+
+bool FIFOQueue::TryFastDequeue(OpKernelContext* ctx, Tuple* tuple) {
+  if (ring_ == nullptr || num_pending_attempts_.load() != 0) return false;
+  Element element;
+  if (!ring_->TryPop(&element)) return false;
+  tuple->reserve(num_components());
+  for (int i = 0; i < num_components(); ++i) {
+    tuple->push_back(*element[i].AccessTensor(ctx));
+  }
+  return true;
+}
+
+bool FIFOQueue::TryFastDequeueMany(int num_elements, OpKernelContext* ctx,
+                                   Tuple* tuple) {
+  if (ring_ == nullptr || num_pending_attempts_.load() != 0) return false;
+  if (ring_->size() < num_elements) return false;
+  // Allocate the batch before claiming elements so that an allocation
+  // failure leaves the ring untouched (the slow path will then report
+  // it).
+  Tuple batch;
+  batch.reserve(num_components());
+  for (int i = 0; i < num_components(); ++i) {
+    Tensor component;
+    if (!ctx->allocate_temp(component_dtypes_[i],
+                            ManyOutShape(i, num_elements), &component)
+             .ok()) {
+      return false;
+    }
+    batch.emplace_back(component);
+  }
+  std::vector<Element> elements;
+  if (!ring_->TryPopN(num_elements, &elements)) return false;
+  for (int64 index = 0; index < num_elements; ++index) {
+    for (int i = 0; i < num_components(); ++i) {
+      ctx->SetStatus(batch_util::CopyElementToSlice(
+          std::move(*elements[index][i].AccessTensor(ctx)), &batch[i], index));
+      if (!ctx->status().ok()) return true;  // caller reports the error
+    }
+  }
+  *tuple = std::move(batch);
+  return true;
+}
+
+int64 FIFOQueue::NumElementsLocked() const {
+  if (ring_ != nullptr) return ring_->size();
+  return static_cast<int64>(queues_[0].size());
+}
+
+bool FIFOQueue::HasSpaceLocked() const {
+  return NumElementsLocked() < static_cast<int64>(capacity_);
+}
+
+bool FIFOQueue::TryStoreLocked(Element* element) {
+  if (ring_ != nullptr) return ring_->TryPush(element);
+  if (queues_[0].size() >= static_cast<size_t>(capacity_)) return false;
+  for (int i = 0; i < num_components(); ++i) {
+    queues_[i].push_back(std::move((*element)[i]));
+  }
+  return true;
+}
+
+bool FIFOQueue::TryLoadLocked(OpKernelContext* ctx, Tuple* tuple) {
+  if (ring_ != nullptr) {
+    Element element;
+    if (!ring_->TryPop(&element)) return false;
+    tuple->reserve(num_components());
+    for (int i = 0; i < num_components(); ++i) {
+      tuple->push_back(*element[i].AccessTensor(ctx));
+    }
+    return true;
+  }
+  if (queues_[0].empty()) return false;
+  DequeueLocked(ctx, tuple);
+  return true;
+}
+
 void FIFOQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
                            DoneCallback callback) {
+  if (TryFastEnqueue(tuple)) {
+    FlushIfWaiters();
+    callback();
+    return;
+  }
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -65,14 +193,12 @@ void FIFOQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
                   errors::Cancelled("FIFOQueue '", name_, "' is closed."));
               return kComplete;
             }
-            if (queues_[0].size() < static_cast<size_t>(capacity_)) {
-              for (int i = 0; i < num_components(); ++i) {
-                queues_[i].push_back(PersistentTensor(tuple[i]));
-              }
-              return kComplete;
-            } else {
-              return kNoProgress;
+            Element element;
+            element.reserve(num_components());
+            for (int i = 0; i < num_components(); ++i) {
+              element.push_back(PersistentTensor(tuple[i]));
             }
+            return TryStoreLocked(&element) ? kComplete : kNoProgress;
           });
     }
   }
@@ -124,17 +250,22 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
               return kComplete;
             }
             RunResult result = kNoProgress;
-            while (queues_[0].size() < static_cast<size_t>(capacity_)) {
-              result = kProgress;
+            while (HasSpaceLocked()) {
               const int64 index =
                   tuple[0].dim_size(0) - attempt->elements_requested;
+              Element element;
+              element.reserve(num_components());
               for (int i = 0; i < num_components(); ++i) {
-                PersistentTensor element;
+                PersistentTensor component;
                 attempt->context->SetStatus(GetElementComponentFromBatch(
-                    tuple, index, i, attempt->context, &element));
+                    tuple, index, i, attempt->context, &component));
                 if (!attempt->context->status().ok()) return kComplete;
-                queues_[i].push_back(element);
+                element.push_back(component);
               }
+              // With the ring enabled, a fast-path enqueue may have taken
+              // the space since HasSpaceLocked().
+              if (!TryStoreLocked(&element)) return result;
+              result = kProgress;
               --attempt->elements_requested;
               if (attempt->elements_requested == 0) {
                 return kComplete;
@@ -153,6 +284,14 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
 }
 
 void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
+  {
+    Tuple tuple;
+    if (TryFastDequeue(ctx, &tuple)) {
+      FlushIfWaiters();
+      callback(tuple);
+      return;
+    }
+  }
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -165,7 +304,7 @@ void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
       dequeue_attempts_.emplace_back(
           1, [callback]() { callback(Tuple()); }, ctx, cm, token,
           [callback, this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-            const int64 queue_size = queues_[0].size();
+            const int64 queue_size = NumElementsLocked();
             if (closed_ && queue_size == 0) {
               attempt->context->SetStatus(errors::OutOfRange(
                   "FIFOQueue '", name_, "' is closed and has ",
@@ -173,14 +312,12 @@ void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
                   queue_size, ")"));
               return kComplete;
             }
-            if (queue_size > 0) {
-              Tuple tuple;
-              DequeueLocked(attempt->context, &tuple);
+            Tuple tuple;
+            if (TryLoadLocked(attempt->context, &tuple)) {
               attempt->done_callback = [callback, tuple]() { callback(tuple); };
               return kComplete;
-            } else {
-              return kNoProgress;
             }
+            return kNoProgress;
           });
     }
   }
@@ -244,6 +381,21 @@ void FIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
     return;
   }
 
+  {
+    // Batched fast path: claim the whole contiguous range of slots with
+    // one compare-and-swap if every element is already available.
+    Tuple tuple;
+    if (TryFastDequeueMany(num_elements, ctx, &tuple)) {
+      FlushIfWaiters();
+      if (ctx->status().ok()) {
+        callback(tuple);
+      } else {
+        callback(Tuple());
+      }
+      return;
+    }
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -257,52 +409,145 @@ void FIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
           num_elements, [callback]() { callback(Tuple()); }, ctx, cm, token,
           [callback, allow_small_batch,
            this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-            int64 queue_size = queues_[0].size();
+            int64 queue_size = NumElementsLocked();
 
             if (closed_ && queue_size < attempt->elements_requested) {
               // If we don't have enough for a full dequeue, we have
               // to reset the attempt tuple.
-              if (!attempt->tuple.empty()) {
-                // Restore already-dequeued elements to the front of the
-                // queue.
-                for (int64 i = attempt->tuple[0].dim_size(0) -
-                               attempt->elements_requested - 1;
-                     i >= 0; --i) {
-                  for (int j = 0; j < num_components(); ++j) {
-                    PersistentTensor element;
-                    Status s = GetElementComponentFromBatch(
-                        attempt->tuple, i, j, attempt->context, &element);
-                    if (!s.ok()) {
+              if (ring_ != nullptr) {
+                const int64 already =
+                    attempt->tuple.empty()
+                        ? 0
+                        : attempt->tuple[0].dim_size(0) -
+                              attempt->elements_requested;
+                if (allow_small_batch && already + queue_size > 0) {
+                  // The ring has no front to restore elements to, so
+                  // shrink the batch in place instead: keep the rows
+                  // dequeued so far and request only what is left.
+                  Tuple small;
+                  small.reserve(num_components());
+                  for (int i = 0; i < num_components(); ++i) {
+                    const TensorShape shape =
+                        ManyOutShape(i, already + queue_size);
+                    Tensor component;
+                    attempt->context->SetStatus(attempt->context->allocate_temp(
+                        component_dtypes_[i], shape, &component));
+                    if (!attempt->context->status().ok()) return kComplete;
+                    small.emplace_back(component);
+                  }
+                  for (int64 r = 0; r < already; ++r) {
+                    for (int i = 0; i < num_components(); ++i) {
+                      PersistentTensor component;
+                      Status s = GetElementComponentFromBatch(
+                          attempt->tuple, r, i, attempt->context, &component);
+                      if (s.ok()) {
+                        s = batch_util::CopyElementToSlice(
+                            std::move(
+                                *component.AccessTensor(attempt->context)),
+                            &small[i], r);
+                      }
+                      if (!s.ok()) {
+                        attempt->context->SetStatus(errors::DataLoss(
+                            "Failed to shrink partially-dequeued batch "
+                            "from FIFOQueue: ",
+                            s.error_message()));
+                        return kComplete;
+                      }
+                    }
+                  }
+                  attempt->tuple = std::move(small);
+                  attempt->elements_requested = queue_size;
+                  if (attempt->elements_requested == 0) {
+                    const Tuple& tuple = attempt->tuple;
+                    attempt->done_callback = [callback, tuple]() {
+                      callback(tuple);
+                    };
+                    return kComplete;
+                  }
+                } else {
+                  // Return the rows dequeued so far to the ring. It has
+                  // no front, so they land behind whatever elements were
+                  // left in it; the queue is already closed with too few
+                  // elements, so this only affects the order seen by
+                  // later small-batch dequeues.
+                  for (int64 r = 0; r < already; ++r) {
+                    Element element;
+                    element.reserve(num_components());
+                    Status s;
+                    for (int i = 0; i < num_components(); ++i) {
+                      PersistentTensor component;
+                      s = GetElementComponentFromBatch(
+                          attempt->tuple, r, i, attempt->context, &component);
+                      if (!s.ok()) break;
+                      element.push_back(component);
+                    }
+                    if (!s.ok() || !ring_->TryPush(&element)) {
                       attempt->context->SetStatus(
                           errors::DataLoss("Failed to restore element from "
                                            "partially-dequeued batch "
                                            "to FIFOQueue: ",
                                            s.error_message()));
+                      break;
                     }
-                    queues_[j].push_front(element);
                   }
+                  if (allow_small_batch) {
+                    // There may be some other attempts containing
+                    // values.  If so, we'll yield and wait for them
+                    // to add elements to the queue.
+                    if (!enqueue_attempts_.empty()) return kProgress;
+                  }
+                  if (attempt->context->status().ok()) {
+                    attempt->context->SetStatus(errors::OutOfRange(
+                        "FIFOQueue '", name_, "' is closed and has ",
+                        "insufficient elements (requested ",
+                        attempt->elements_requested, ", current size ",
+                        queue_size, ")"));
+                  }
+                  return kComplete;
                 }
-              }
-              if (allow_small_batch && !queues_[0].empty()) {
-                // Request all remaining elements in the queue.
-                queue_size = queues_[0].size();
-                attempt->tuple.clear();
-                attempt->elements_requested = queue_size;
               } else {
-                if (allow_small_batch) {
-                  // There may be some other attempts containing
-                  // values.  If so, we'll yield and wait for them
-                  // to add elements to the queue.
-                  if (!enqueue_attempts_.empty()) return kProgress;
+                if (!attempt->tuple.empty()) {
+                  // Restore already-dequeued elements to the front of
+                  // the queue.
+                  for (int64 i = attempt->tuple[0].dim_size(0) -
+                                 attempt->elements_requested - 1;
+                       i >= 0; --i) {
+                    for (int j = 0; j < num_components(); ++j) {
+                      PersistentTensor element;
+                      Status s = GetElementComponentFromBatch(
+                          attempt->tuple, i, j, attempt->context, &element);
+                      if (!s.ok()) {
+                        attempt->context->SetStatus(
+                            errors::DataLoss("Failed to restore element from "
+                                             "partially-dequeued batch "
+                                             "to FIFOQueue: ",
+                                             s.error_message()));
+                      }
+                      queues_[j].push_front(element);
+                    }
+                  }
                 }
-                if (attempt->context->status().ok()) {
-                  attempt->context->SetStatus(errors::OutOfRange(
-                      "FIFOQueue '", name_, "' is closed and has ",
-                      "insufficient elements (requested ",
-                      attempt->elements_requested, ", current size ",
-                      queue_size, ")"));
+                if (allow_small_batch && !queues_[0].empty()) {
+                  // Request all remaining elements in the queue.
+                  queue_size = queues_[0].size();
+                  attempt->tuple.clear();
+                  attempt->elements_requested = queue_size;
+                } else {
+                  if (allow_small_batch) {
+                    // There may be some other attempts containing
+                    // values.  If so, we'll yield and wait for them
+                    // to add elements to the queue.
+                    if (!enqueue_attempts_.empty()) return kProgress;
+                  }
+                  if (attempt->context->status().ok()) {
+                    attempt->context->SetStatus(errors::OutOfRange(
+                        "FIFOQueue '", name_, "' is closed and has ",
+                        "insufficient elements (requested ",
+                        attempt->elements_requested, ", current size ",
+                        queue_size, ")"));
+                  }
+                  return kComplete;
                 }
-                return kComplete;
               }
             }
 
@@ -323,9 +568,9 @@ void FIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
                   attempt->tuple.emplace_back(element);
                 }
               }
-              result = kProgress;
               Tuple tuple;
-              DequeueLocked(attempt->context, &tuple);
+              if (!TryLoadLocked(attempt->context, &tuple)) return result;
+              result = kProgress;
               const int64 index =
                   attempt->tuple[0].dim_size(0) - attempt->elements_requested;
               for (int i = 0; i < num_components(); ++i) {
@@ -17,12 +17,14 @@ limitations under the License.
 #define TENSORFLOW_CORE_KERNELS_FIFO_QUEUE_H_
 
 #include <deque>
+#include <memory>
 #include <vector>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/mpmc_ring_buffer.h"
 #include "tensorflow/core/kernels/queue_op.h"
 #include "tensorflow/core/kernels/typed_queue.h"
 #include "tensorflow/core/platform/macros.h"
@@ -33,9 +35,14 @@ namespace tensorflow {
 
 class FIFOQueue : public TypedQueue<std::deque<PersistentTensor> > {
  public:
+  // When "allow_lock_free_ring" is true, the queue is bounded, and the
+  // TF_FIFO_QUEUE_LOCK_FREE_RING environment variable is set, elements
+  // are stored in a lock-free MPMC ring instead of queues_, and
+  // operations that can complete immediately bypass mu_ entirely.
+  // Subclasses that access queues_ directly must pass false.
   FIFOQueue(int32 capacity, const DataTypeVector& component_dtypes,
             const std::vector<TensorShape>& component_shapes,
-            const string& name);
+            const string& name, bool allow_lock_free_ring = true);
 
   // Implementations of QueueInterface methods --------------------------------
 
@@ -50,6 +57,7 @@ class FIFOQueue : public TypedQueue<std::deque<PersistentTensor> > {
   Status MatchesNodeDef(const NodeDef& node_def) override;
 
   int32 size() const override {
+    if (ring_ != nullptr) return ring_->size();
     mutex_lock lock(mu_);
     return queues_[0].size();
   }
@@ -67,6 +75,34 @@ class FIFOQueue : public TypedQueue<std::deque<PersistentTensor> > {
                                              PersistentTensor* out_element);
 
  private:
+  // One stored element: its tensors, one per component.
+  typedef std::vector<PersistentTensor> Element;
+
+  // Fast paths that complete on ring_ without taking mu_ or registering
+  // a cancellation callback. They return false if the caller must go
+  // through the attempt machinery instead (ring disabled, queue possibly
+  // closed, attempts pending, or the ring full/empty).
+  bool TryFastEnqueue(const Tuple& tuple);
+  bool TryFastDequeue(OpKernelContext* ctx, Tuple* tuple);
+  bool TryFastDequeueMany(int num_elements, OpKernelContext* ctx,
+                          Tuple* tuple);
+
+  // Wakes pending attempts if any registered while a fast path ran; see
+  // the comment in QueueBase::FlushUnlocked.
+  void FlushIfWaiters();
+
+  // Storage helpers used by the attempt closures; they operate on ring_
+  // when the lock-free variant is enabled and on queues_ otherwise.
+  int64 NumElementsLocked() const EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool HasSpaceLocked() const EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool TryStoreLocked(Element* element) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool TryLoadLocked(OpKernelContext* ctx, Tuple* tuple)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Element storage when the lock-free variant is enabled; queues_ is
+  // unused in that case.
+  std::unique_ptr<MpmcRingBuffer<Element>> ring_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(FIFOQueue);
 };
 
@@ -45,7 +45,13 @@ void ArgOp::Compute(OpKernelContext* ctx) {
   auto frame = ctx->call_frame();
   OP_REQUIRES(ctx, frame != nullptr, errors::Internal("no call frame"));
   Tensor val;
-  OP_REQUIRES_OK(ctx, frame->GetArg(index_, &val));
+  if (frame->CanConsumeArg(index_)) {
+    // Takes over the frame's reference so that in-place ops downstream can
+    // observe unique buffer ownership and forward the argument's buffer.
+    frame->ConsumeArg(index_, &val);
+  } else {
+    OP_REQUIRES_OK(ctx, frame->GetArg(index_, &val));
+  }
   OP_REQUIRES(ctx, val.dtype() == dtype_,
               errors::InvalidArgument("Type mismatch: actual ",
                                       DataTypeString(val.dtype()),
@@ -23,9 +23,13 @@ limitations under the License.
 #include "absl/types/span.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/stream_executor.h"
 
@@ -41,6 +45,204 @@ inline se::DeviceMemory<T> AsDeviceMemory(const T* cuda_memory, uint64 size) {
   return typed;
 }
 
+// Persistence support for AutoTuneMap, below.
+//
+// When TF_AUTOTUNE_CACHE_DIR is set, autotune maps whose key/config types
+// specialize AutoTunePersistenceTraits write accepted configs to one file
+// per map under that directory and preload them at startup, so warmed-up
+// algorithm choices survive process restarts and can be shared fleet-wide
+// (e.g. by placing the directory on a network filesystem or syncing it
+// through an object store). Entries are keyed by a fingerprint of the
+// parameters that excludes the local device ordinal, and each file starts
+// with a header recording the GPU model and DNN library version it was
+// produced with; files written for a different configuration are ignored.
+// A small fraction of preloaded entries (TF_AUTOTUNE_CACHE_REVALIDATE_PROB,
+// default 0.01) are deliberately dropped so that some processes in the
+// fleet re-measure and stale entries self-correct.
+template <typename Parameters, typename Config>
+struct AutoTunePersistenceTraits {
+  // Persistence is opt-in per (Parameters, Config) pair; see
+  // conv_ops_gpu.h for the convolution specialization.
+  static constexpr bool kSupported = false;
+  static uint64 StableKey(const Parameters& params) { return 0; }
+  static bool SerializeConfig(const Config& config, string* out) {
+    return false;
+  }
+  static bool DeserializeConfig(const string& in, Config* config) {
+    return false;
+  }
+};
+
+namespace autotune_cache_internal {
+
+inline const string& CacheDir() {
+  static const string* dir = [] {
+    const char* value = getenv("TF_AUTOTUNE_CACHE_DIR");
+    return new string(value == nullptr ? "" : value);
+  }();
+  return *dir;
+}
+
+inline bool CacheEnabled() { return !CacheDir().empty(); }
+
+// Returns true if a preloaded entry should be dropped so that this process
+// re-measures it and refreshes the cache.
+inline bool ShouldRevalidate() {
+  static const double probability = [] {
+    double result = 0.01;
+    const char* value = getenv("TF_AUTOTUNE_CACHE_REVALIDATE_PROB");
+    if (value != nullptr) {
+      double parsed;
+      if (strings::safe_strtod(value, &parsed) && parsed >= 0.0 &&
+          parsed <= 1.0) {
+        result = parsed;
+      }
+    }
+    return result;
+  }();
+  return random::New64() <
+         static_cast<uint64>(probability * static_cast<double>(kuint64max));
+}
+
+// Identifies the device and DNN library the cached measurements were taken
+// on. Cache files recording a different fingerprint are ignored, so a
+// shared cache directory is safe across heterogeneous hosts. Multi-GPU
+// hosts are assumed to be homogeneous; device 0 is used.
+inline const string& DeviceFingerprint() {
+  static const string* fingerprint = [] {
+    string result = "unknown_device";
+    auto platform = se::MultiPlatformManager::PlatformWithName("CUDA");
+    if (!platform.ok()) {
+      platform = se::MultiPlatformManager::PlatformWithName("ROCM");
+    }
+    if (platform.ok() && platform.ValueOrDie()->VisibleDeviceCount() > 0) {
+      auto executor = platform.ValueOrDie()->ExecutorForDevice(0);
+      if (executor.ok()) {
+        se::StreamExecutor* stream_exec = executor.ValueOrDie();
+        result = stream_exec->GetDeviceDescription().name();
+        if (auto* dnn = stream_exec->AsDnn()) {
+          auto version = dnn->GetVersion();
+          if (version.ok()) {
+            strings::StrAppend(&result, " dnn ",
+                               version.ValueOrDie().major_version(), ".",
+                               version.ValueOrDie().minor_version(), ".",
+                               version.ValueOrDie().patch());
+          }
+        }
+      }
+    }
+    return new string(result);
+  }();
+  return *fingerprint;
+}
+
+inline string CacheFileHeader() {
+  return strings::StrCat("tf_autotune_cache ", DeviceFingerprint());
+}
+
+inline string CacheFileName(const string& map_name) {
+  string basename = map_name;
+  for (char& c : basename) {
+    if (!(isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-')) {
+      c = '_';
+    }
+  }
+  return io::JoinPath(CacheDir(), strings::StrCat(basename, ".autotune"));
+}
+
+// Reads the persisted entries for the named map into *entries. Missing
+// files and malformed lines are silently skipped; a file written for a
+// different device or DNN library version is ignored wholesale. Later
+// lines win for duplicate keys, so appenders never need to rewrite.
+inline void LoadEntries(const string& map_name,
+                        std::unordered_map<uint64, string>* entries) {
+  const string filename = CacheFileName(map_name);
+  string contents;
+  if (!ReadFileToString(Env::Default(), filename, &contents).ok()) {
+    return;  // No cache for this map yet.
+  }
+  std::vector<string> lines = str_util::Split(contents, '\n');
+  if (lines.empty() || lines[0] != CacheFileHeader()) {
+    LOG(WARNING) << "Ignoring autotune cache file " << filename
+                 << ": it was written for a different device or DNN "
+                 << "library version.";
+    return;
+  }
+  for (size_t i = 1; i < lines.size(); ++i) {
+    const size_t space = lines[i].find(' ');
+    if (space == string::npos) continue;
+    uint64 key;
+    if (!strings::safe_strtou64(lines[i].substr(0, space), &key)) continue;
+    (*entries)[key] = lines[i].substr(space + 1);
+  }
+  VLOG(1) << "Preloaded " << entries->size() << " autotune entries for "
+          << map_name << " from " << filename;
+}
+
+// Appends one accepted entry to the named map's cache file. Concurrent
+// writers on a shared filesystem may race; each record is a single short
+// append and the loader skips malformed lines, so the worst case is a lost
+// or duplicated entry, which the next accepting process rewrites.
+inline void AppendEntry(const string& map_name, uint64 key,
+                        const string& value) {
+  const string filename = CacheFileName(map_name);
+  Env* env = Env::Default();
+  const bool new_file = !env->FileExists(filename).ok();
+  std::unique_ptr<WritableFile> file;
+  Status s = env->NewAppendableFile(filename, &file);
+  if (s.ok()) {
+    string record;
+    if (new_file) {
+      strings::StrAppend(&record, CacheFileHeader(), "\n");
+    }
+    strings::StrAppend(&record, key, " ", value, "\n");
+    s = file->Append(record);
+    if (s.ok()) s = file->Close();
+  }
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to persist autotune entry to " << filename << ": "
+                 << s;
+  }
+}
+
+// (De)serialization for AlgorithmConfig-valued autotune maps: six integer
+// fields covering the presence, id and tensor-op mode of the main and
+// no-scratch algorithms.
+inline bool SerializeAlgorithmConfig(const se::dnn::AlgorithmConfig& config,
+                                     string* out) {
+  const auto& algorithm = config.algorithm();
+  const auto& algorithm_no_scratch = config.algorithm_no_scratch();
+  *out = strings::StrCat(
+      algorithm ? 1 : 0, " ", algorithm ? algorithm->algo_id() : 0, " ",
+      algorithm && algorithm->tensor_ops_enabled() ? 1 : 0, " ",
+      algorithm_no_scratch ? 1 : 0, " ",
+      algorithm_no_scratch ? algorithm_no_scratch->algo_id() : 0, " ",
+      algorithm_no_scratch && algorithm_no_scratch->tensor_ops_enabled() ? 1
+                                                                         : 0);
+  return true;
+}
+
+inline bool DeserializeAlgorithmConfig(const string& in,
+                                       se::dnn::AlgorithmConfig* config) {
+  std::vector<string> fields = str_util::Split(in, ' ');
+  int64 values[6];
+  if (fields.size() != 6) return false;
+  for (int i = 0; i < 6; ++i) {
+    if (!strings::safe_strto64(fields[i], &values[i])) return false;
+  }
+  *config = se::dnn::AlgorithmConfig();
+  if (values[0] != 0) {
+    config->set_algorithm(se::dnn::AlgorithmDesc(values[1], values[2] != 0));
+  }
+  if (values[3] != 0) {
+    config->set_algorithm_no_scratch(
+        se::dnn::AlgorithmDesc(values[4], values[5] != 0));
+  }
+  return true;
+}
+
+}  // namespace autotune_cache_internal
+
 // A helper class that looks up the best autotuned config from parameters.
 // Due to the noisy nature of autotune, especially with multiple devices, it
 // only accepts a config if its margin exceeds a threshold.
@@ -54,9 +256,12 @@ inline se::DeviceMemory<T> AsDeviceMemory(const T* cuda_memory, uint64 size) {
 template <typename Parameters, typename Config>
 class AutoTuneMap {
  public:
-  bool Find(const Parameters& params, Config* config) const {
+  bool Find(const Parameters& params, Config* config) {
     mutex_lock lock(mu_);
     auto iter = params_config_map_.find(params);
+    if (iter == params_config_map_.end() && !persisted_entries_.empty()) {
+      iter = PromotePersisted(params);
+    }
     if (iter == params_config_map_.end() ||
         (iter->second.score < min_score_threshold_ &&
          iter->second.count <= max_autotune_count_)) {
@@ -96,6 +301,7 @@ class AutoTuneMap {
     }
     if (new_score >= min_score_threshold_) {
       VLOG(1) << GetActionSummary("accepts", params, config);
+      PersistEntry(params, config);
     } else if (autotune_global_count_ >= max_autotune_global_count_) {
       // The autotuning exceeds the max iteration threshold and we accept the
       // the winner if it exists in the map, otherwise we accept the current
@@ -108,12 +314,14 @@ class AutoTuneMap {
         }
         params_config_map_.insert(
             std::make_pair(params, ValueType{config, min_score_threshold_, 1}));
+        PersistEntry(params, config);
       } else {
         int promotes_times = min_score_threshold_ - winner->second.score;
         for (int i = 0; i < promotes_times; ++i) {
           VLOG(1) << GetActionSummary("promotes", params, config);
         }
         winner->second.score = min_score_threshold_;
+        PersistEntry(params, winner->second.config);
       }
       VLOG(1) << GetActionSummary("accepts", params, config);
     }
@@ -138,6 +346,10 @@ class AutoTuneMap {
         5 * min_score_threshold_ * min_score_threshold_, min_warmup_iterations);
     max_autotune_global_count_ = 2 * max_autotune_count_;
     autotune_global_count_ = 0;
+    if (PersistenceTraits::kSupported &&
+        autotune_cache_internal::CacheEnabled()) {
+      autotune_cache_internal::LoadEntries(name_, &persisted_entries_);
+    }
   }
 
   template <class Group, class Params, class Cfg>
@@ -156,14 +368,61 @@ class AutoTuneMap {
                            config.ToString().c_str());
   }
 
+  typedef AutoTunePersistenceTraits<Parameters, Config> PersistenceTraits;
+
   mutable mutex mu_;
   struct ValueType {
     Config config;
     int32 score;
     int32 count;
   };
-  std::unordered_map<Parameters, ValueType, Hasher> params_config_map_
-      GUARDED_BY(mu_);
+
+  typedef std::unordered_map<Parameters, ValueType, Hasher> ConfigMap;
+
+  // Installs the persisted config for params, if there is one, as an
+  // already-accepted in-memory entry and returns an iterator to it. With a
+  // small probability the entry is dropped instead, so that this process
+  // re-measures the shape and rewrites any stale cache entry. The entry is
+  // kept around for other parameters that share the same stable key (the
+  // same shape on another device ordinal, say); once promoted, later
+  // lookups for the same parameters hit the in-memory map directly.
+  typename ConfigMap::iterator PromotePersisted(const Parameters& params)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto persisted =
+        persisted_entries_.find(PersistenceTraits::StableKey(params));
+    if (persisted == persisted_entries_.end()) {
+      return params_config_map_.end();
+    }
+    Config config;
+    if (!PersistenceTraits::DeserializeConfig(persisted->second, &config) ||
+        autotune_cache_internal::ShouldRevalidate()) {
+      // Dropping the entry makes this process (and this shape on every
+      // device ordinal) re-measure and overwrite it.
+      persisted_entries_.erase(persisted);
+      return params_config_map_.end();
+    }
+    VLOG(1) << GetActionSummary("preloads", params, config);
+    return params_config_map_
+        .insert(std::make_pair(params,
+                               ValueType{config, min_score_threshold_, 1}))
+        .first;
+  }
+
+  // Writes an accepted config through to the persistent cache, if enabled.
+  void PersistEntry(const Parameters& params, const Config& config)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (!PersistenceTraits::kSupported ||
+        !autotune_cache_internal::CacheEnabled()) {
+      return;
+    }
+    string serialized;
+    if (!PersistenceTraits::SerializeConfig(config, &serialized)) return;
+    autotune_cache_internal::AppendEntry(
+        name_, PersistenceTraits::StableKey(params), serialized);
+  }
+
+  ConfigMap params_config_map_ GUARDED_BY(mu_);
+  std::unordered_map<uint64, string> persisted_entries_ GUARDED_BY(mu_);
   string name_;
   int32 min_score_threshold_;
   int32 max_autotune_count_;
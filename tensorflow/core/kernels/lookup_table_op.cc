@@ -34,6 +34,13 @@ namespace lookup {
 // is specified. Each individual value must be a scalar. If vector values are
 // required, use MutableHashTableOfTensors.
 //
+// The map is split into kNumShards stripes, each guarded by its own mutex
+// and selected by key hash, so that concurrent lookups issued by a large
+// intra-op pool do not serialize on a single lock. Batched operations group
+// their keys by stripe first and acquire each stripe lock at most once per
+// batch. Reads take the stripe lock in shared mode, so lookups only contend
+// with writers touching the same stripe.
+//
 // This table is mutable and thread safe - Insert can be called at any time.
 //
 // Sample use case:
@@ -50,8 +57,12 @@ class MutableHashTableOfScalars final : public LookupInterface {
   MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
 
   size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
+    size_t ret = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      ret += shard.table.size();
+    }
+    return ret;
   }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
@@ -60,10 +71,20 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = key.flat<K>();
     auto value_values = value->flat<V>();
 
-    tf_shared_lock l(mu_);
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      value_values(i) = gtl::FindWithDefault(
-          table_, SubtleMustCopyIfIntegral(key_values(i)), default_val);
+    int64 counts[kNumShards];
+    gtl::InlinedVector<int64, 32> order;
+    GroupKeysByShard(key_values, counts, &order);
+
+    int64 pos = 0;
+    for (int s = 0; s < kNumShards; ++s) {
+      if (counts[s] == 0) continue;
+      const Shard& shard = shards_[s];
+      tf_shared_lock l(shard.mu);
+      for (const int64 end = pos + counts[s]; pos < end; ++pos) {
+        const int64 i = order[pos];
+        value_values(i) = gtl::FindWithDefault(
+            shard.table, SubtleMustCopyIfIntegral(key_values(i)), default_val);
+      }
     }
 
     return Status::OK();
@@ -73,13 +94,23 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = keys.flat<K>();
     const auto value_values = values.flat<V>();
 
-    mutex_lock l(mu_);
-    if (clear) {
-      table_.clear();
-    }
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          SubtleMustCopyIfIntegral(value_values(i)));
+    int64 counts[kNumShards];
+    gtl::InlinedVector<int64, 32> order;
+    GroupKeysByShard(key_values, counts, &order);
+
+    int64 pos = 0;
+    for (int s = 0; s < kNumShards; ++s) {
+      if (counts[s] == 0 && !clear) continue;
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      if (clear) {
+        shard.table.clear();
+      }
+      for (const int64 end = pos + counts[s]; pos < end; ++pos) {
+        const int64 i = order[pos];
+        gtl::InsertOrUpdate(&shard.table, SubtleMustCopyIfIntegral(key_values(i)),
+                            SubtleMustCopyIfIntegral(value_values(i)));
+      }
     }
     return Status::OK();
   }
@@ -92,9 +123,18 @@ class MutableHashTableOfScalars final : public LookupInterface {
   Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
+    int64 counts[kNumShards];
+    gtl::InlinedVector<int64, 32> order;
+    GroupKeysByShard(key_values, counts, &order);
+
+    int64 pos = 0;
+    for (int s = 0; s < kNumShards; ++s) {
+      if (counts[s] == 0) continue;
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      for (const int64 end = pos + counts[s]; pos < end; ++pos) {
+        shard.table.erase(SubtleMustCopyIfIntegral(key_values(order[pos])));
+      }
     }
     return Status::OK();
   }
@@ -105,8 +145,15 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64 size = table_.size();
+    // Hold every stripe lock so the export is a consistent snapshot, as it
+    // was with a single table-wide lock.
+    std::vector<tf_shared_lock> locks;
+    locks.reserve(kNumShards);
+    int64 size = 0;
+    for (Shard& shard : shards_) {
+      locks.emplace_back(shard.mu);
+      size += shard.table.size();
+    }
 
     Tensor* keys;
     Tensor* values;
@@ -118,9 +165,11 @@ class MutableHashTableOfScalars final : public LookupInterface {
     auto keys_data = keys->flat<K>();
     auto values_data = values->flat<V>();
     int64 i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      keys_data(i) = it->first;
-      values_data(i) = it->second;
+    for (const Shard& shard : shards_) {
+      for (auto it = shard.table.begin(); it != shard.table.end(); ++it, ++i) {
+        keys_data(i) = it->first;
+        values_data(i) = it->second;
+      }
     }
     return Status::OK();
   }
@@ -135,21 +184,61 @@ class MutableHashTableOfScalars final : public LookupInterface {
 
   int64 MemoryUsed() const override {
     int64 ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      for (unsigned i = 0; i < shard.table.bucket_count(); ++i) {
+        size_t bucket_size = shard.table.bucket_size(i);
+        if (bucket_size == 0) {
+          ret++;
+        } else {
+          ret += bucket_size;
+        }
       }
     }
     return sizeof(MutableHashTableOfScalars) + ret;
   }
 
  private:
-  mutable mutex mu_;
-  std::unordered_map<K, V> table_ GUARDED_BY(mu_);
+  // Number of independently locked stripes.  Must be a power of two so a
+  // stripe can be selected by masking the key hash.
+  static constexpr int kNumShards = 16;
+
+  struct Shard {
+    mutable mutex mu;
+    std::unordered_map<K, V> table GUARDED_BY(mu);
+  };
+
+  static size_t ShardIndex(const K& key) {
+    return tensorflow::hash<K>()(key) & (kNumShards - 1);
+  }
+
+  // Fills 'order' with key indices grouped by stripe: the indices of the
+  // keys that hash to stripe s occupy counts[0] + ... + counts[s-1] onwards.
+  template <typename KeyFlat>
+  static void GroupKeysByShard(const KeyFlat& key_values,
+                               int64 counts[kNumShards],
+                               gtl::InlinedVector<int64, 32>* order) {
+    const int64 num_keys = key_values.size();
+    gtl::InlinedVector<uint8, 64> shard_ids(num_keys);
+    for (int s = 0; s < kNumShards; ++s) counts[s] = 0;
+    for (int64 i = 0; i < num_keys; ++i) {
+      const size_t s = ShardIndex(key_values(i));
+      shard_ids[i] = static_cast<uint8>(s);
+      ++counts[s];
+    }
+    int64 offsets[kNumShards];
+    int64 total = 0;
+    for (int s = 0; s < kNumShards; ++s) {
+      offsets[s] = total;
+      total += counts[s];
+    }
+    order->resize(num_keys);
+    for (int64 i = 0; i < num_keys; ++i) {
+      (*order)[offsets[shard_ids[i]]++] = i;
+    }
+  }
+
+  Shard shards_[kNumShards];
 };
 
 // Lookup table that wraps an unordered_map. Behaves identical to
@@ -92,6 +92,10 @@ struct LaunchFusedMatMulOp<CPUDevice, T> {
         out.device(d) =
             lhs.contract(rhs, dim_pair, WithBiasAddAndElu<T>(bias_add_args));
         break;
+      case FusedComputationType::kBiasAddWithTanh:
+        out.device(d) =
+            lhs.contract(rhs, dim_pair, WithBiasAddAndTanh<T>(bias_add_args));
+        break;
       case FusedComputationType::kUndefined:
         OP_REQUIRES_OK(context, errors::Internal("Fusion type is undefined"));
         break;
@@ -116,7 +120,8 @@ class FusedMatMulOp : public OpKernel {
       patterns = {{FCT::kBiasAdd, {"BiasAdd"}},
                   {FCT::kBiasAddWithRelu, {"BiasAdd", "Relu"}},
                   {FCT::kBiasAddWithRelu6, {"BiasAdd", "Relu6"}},
-                  {FCT::kBiasAddWithElu, {"BiasAdd", "Elu"}}};
+                  {FCT::kBiasAddWithElu, {"BiasAdd", "Elu"}},
+                  {FCT::kBiasAddWithTanh, {"BiasAdd", "Tanh"}}};
     }
 
     OP_REQUIRES_OK(context, InitializeFusedComputation(
@@ -191,6 +196,7 @@ class FusedMatMulOp : public OpKernel {
 
 #ifndef EIGEN_USE_LIBXSMM
 TF_CALL_float(REGISTER_FUSED_CPU_MATMUL);
+TF_CALL_double(REGISTER_FUSED_CPU_MATMUL);
 #endif  // !EIGEN_USE_LIBXSMM
 
 #undef REGISTER_FUSED_CPU_MATMUL
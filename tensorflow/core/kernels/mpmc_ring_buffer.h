@@ -0,0 +1,167 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_MPMC_RING_BUFFER_H_
+#define TENSORFLOW_CORE_KERNELS_MPMC_RING_BUFFER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// A bounded multi-producer multi-consumer FIFO ring without locks, after
+// Vyukov's bounded MPMC queue. Each slot carries a sequence number that
+// says whose turn the slot is; claiming a slot is a single
+// compare-and-swap on the matching position counter, so producers never
+// contend with consumers and same-side contention costs one retry.
+//
+// All operations are non-blocking: they either complete immediately or
+// return false, leaving the output argument untouched. A false return
+// may be spurious while an operation on another thread is mid-flight, so
+// callers that must make progress need their own retry or fallback.
+//
+// The capacity is not rounded up; a full ring holds exactly "capacity"
+// elements. All atomic operations use the default sequentially
+// consistent ordering so callers can reason about races between ring
+// operations and their own flags (see FIFOQueue's fast paths).
+template <typename T>
+class MpmcRingBuffer {
+ public:
+  explicit MpmcRingBuffer(int64 capacity)
+      : capacity_(capacity), cells_(new Cell[capacity]) {
+    DCHECK_GT(capacity, 0);
+    for (int64 i = 0; i < capacity; ++i) {
+      cells_[i].sequence.store(i);
+    }
+    enqueue_pos_.store(0);
+    dequeue_pos_.store(0);
+  }
+
+  // Moves *value into the ring. Returns false if the ring is full.
+  bool TryPush(T* value) {
+    Cell* cell;
+    uint64 pos = enqueue_pos_.load();
+    for (;;) {
+      cell = &cells_[pos % capacity_];
+      const uint64 seq = cell->sequence.load();
+      const int64 dif = static_cast<int64>(seq) - static_cast<int64>(pos);
+      if (dif == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1)) break;
+      } else if (dif < 0) {
+        return false;  // Full: the slot is still owned by a consumer.
+      } else {
+        pos = enqueue_pos_.load();
+      }
+    }
+    cell->value = std::move(*value);
+    cell->sequence.store(pos + 1);
+    return true;
+  }
+
+  // Moves the oldest element into *out. Returns false if the ring is
+  // empty.
+  bool TryPop(T* out) {
+    Cell* cell;
+    uint64 pos = dequeue_pos_.load();
+    for (;;) {
+      cell = &cells_[pos % capacity_];
+      const uint64 seq = cell->sequence.load();
+      const int64 dif = static_cast<int64>(seq) - static_cast<int64>(pos + 1);
+      if (dif == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1)) break;
+      } else if (dif < 0) {
+        return false;  // Empty: the slot has not been produced yet.
+      } else {
+        pos = dequeue_pos_.load();
+      }
+    }
+    *out = std::move(cell->value);
+    cell->sequence.store(pos + capacity_);
+    return true;
+  }
+
+  // Moves the oldest "count" elements into *out, appended in FIFO order,
+  // claiming the whole range with one compare-and-swap so no other
+  // consumer can take an element from the middle of the batch. All or
+  // nothing: returns false without touching *out if fewer than "count"
+  // elements are ready.
+  bool TryPopN(int64 count, std::vector<T>* out) {
+    DCHECK_GT(count, 0);
+    if (count > capacity_) return false;
+    uint64 pos = dequeue_pos_.load();
+    for (;;) {
+      // Every slot in [pos, pos + count) must hold a fully produced
+      // element before the range can be claimed. Producers claim slots
+      // in order but may finish writing them out of order, so each slot
+      // is checked individually.
+      bool ready = true;
+      for (int64 i = 0; i < count; ++i) {
+        const uint64 seq = cells_[(pos + i) % capacity_].sequence.load();
+        if (seq != pos + i + 1) {
+          ready = false;
+          break;
+        }
+      }
+      if (!ready) {
+        const uint64 moved = dequeue_pos_.load();
+        if (moved == pos) return false;
+        pos = moved;
+        continue;
+      }
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + count)) break;
+    }
+    out->reserve(out->size() + count);
+    for (int64 i = 0; i < count; ++i) {
+      Cell* cell = &cells_[(pos + i) % capacity_];
+      out->push_back(std::move(cell->value));
+      cell->sequence.store(pos + i + capacity_);
+    }
+    return true;
+  }
+
+  // May transiently over- or under-count while operations are in flight
+  // on other threads.
+  int64 size() const {
+    int64 size = static_cast<int64>(enqueue_pos_.load()) -
+                 static_cast<int64>(dequeue_pos_.load());
+    if (size < 0) size = 0;
+    if (size > capacity_) size = capacity_;
+    return size;
+  }
+
+  int64 capacity() const { return capacity_; }
+
+ private:
+  struct Cell {
+    std::atomic<uint64> sequence;
+    T value;
+  };
+
+  const int64 capacity_;
+  const std::unique_ptr<Cell[]> cells_;
+  std::atomic<uint64> enqueue_pos_;
+  std::atomic<uint64> dequeue_pos_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MpmcRingBuffer);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_MPMC_RING_BUFFER_H_
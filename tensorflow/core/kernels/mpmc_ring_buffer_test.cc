@@ -0,0 +1,171 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/mpmc_ring_buffer.h"
+
+#include <atomic>
+#include <vector>
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(MpmcRingBufferTest, PushPopFifoOrder) {
+  MpmcRingBuffer<int64> ring(4);
+  EXPECT_EQ(4, ring.capacity());
+  EXPECT_EQ(0, ring.size());
+  for (int64 i = 0; i < 4; ++i) {
+    int64 value = i;
+    EXPECT_TRUE(ring.TryPush(&value));
+  }
+  EXPECT_EQ(4, ring.size());
+  int64 overflow = 99;
+  EXPECT_FALSE(ring.TryPush(&overflow));
+  for (int64 i = 0; i < 4; ++i) {
+    int64 value = -1;
+    EXPECT_TRUE(ring.TryPop(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_EQ(0, ring.size());
+  int64 value = -1;
+  EXPECT_FALSE(ring.TryPop(&value));
+}
+
+TEST(MpmcRingBufferTest, Wraparound) {
+  MpmcRingBuffer<int64> ring(3);
+  // Push and pop enough elements that every slot is reused several
+  // times and the positions run well past the capacity.
+  for (int64 i = 0; i < 20; ++i) {
+    int64 value = i;
+    ASSERT_TRUE(ring.TryPush(&value));
+    value = -1;
+    ASSERT_TRUE(ring.TryPop(&value));
+    ASSERT_EQ(i, value);
+  }
+  EXPECT_EQ(0, ring.size());
+}
+
+TEST(MpmcRingBufferTest, TryPopNAllOrNothing) {
+  MpmcRingBuffer<int64> ring(8);
+  for (int64 i = 0; i < 5; ++i) {
+    int64 value = i;
+    ASSERT_TRUE(ring.TryPush(&value));
+  }
+  std::vector<int64> out;
+  EXPECT_FALSE(ring.TryPopN(6, &out));
+  EXPECT_TRUE(out.empty());
+  EXPECT_EQ(5, ring.size());
+  EXPECT_TRUE(ring.TryPopN(3, &out));
+  ASSERT_EQ(3, out.size());
+  for (int64 i = 0; i < 3; ++i) {
+    EXPECT_EQ(i, out[i]);
+  }
+  EXPECT_TRUE(ring.TryPopN(2, &out));
+  ASSERT_EQ(5, out.size());
+  EXPECT_EQ(3, out[3]);
+  EXPECT_EQ(4, out[4]);
+  EXPECT_FALSE(ring.TryPopN(1, &out));
+  EXPECT_FALSE(ring.TryPopN(9, &out));  // More than the capacity.
+}
+
+TEST(MpmcRingBufferTest, ConcurrentPushPop) {
+  static const int kNumProducers = 4;
+  static const int kNumConsumers = 4;
+  static const int64 kPerProducer = 20000;
+  MpmcRingBuffer<int64> ring(64);
+  std::vector<std::vector<int64>> consumed(kNumConsumers);
+  std::atomic<int64> num_consumed(0);
+  {
+    thread::ThreadPool threads(Env::Default(), "mpmc_ring_buffer_test",
+                               kNumProducers + kNumConsumers);
+    for (int p = 0; p < kNumProducers; ++p) {
+      threads.Schedule([p, &ring]() {
+        // Encode the producer id and a per-producer sequence number so
+        // consumers can check per-producer FIFO order.
+        for (int64 i = 0; i < kPerProducer; ++i) {
+          int64 value = p * kPerProducer + i;
+          while (!ring.TryPush(&value)) {
+          }
+        }
+      });
+    }
+    for (int c = 0; c < kNumConsumers; ++c) {
+      threads.Schedule([c, &ring, &consumed, &num_consumed]() {
+        while (num_consumed.load() < kNumProducers * kPerProducer) {
+          int64 value;
+          if (ring.TryPop(&value)) {
+            consumed[c].push_back(value);
+            ++num_consumed;
+          }
+        }
+      });
+    }
+  }
+  EXPECT_EQ(kNumProducers * kPerProducer, num_consumed.load());
+  // Each producer's values must appear in increasing order within each
+  // consumer, and every value must be seen exactly once.
+  std::vector<bool> seen(kNumProducers * kPerProducer, false);
+  for (int c = 0; c < kNumConsumers; ++c) {
+    std::vector<int64> last(kNumProducers, -1);
+    for (int64 value : consumed[c]) {
+      ASSERT_FALSE(seen[value]);
+      seen[value] = true;
+      const int64 producer = value / kPerProducer;
+      EXPECT_LT(last[producer], value);
+      last[producer] = value;
+    }
+  }
+}
+
+TEST(MpmcRingBufferTest, ConcurrentBatchedPop) {
+  static const int kNumProducers = 4;
+  static const int64 kPerProducer = 8000;
+  static const int64 kBatchSize = 10;
+  MpmcRingBuffer<int64> ring(40);
+  std::vector<int64> popped;
+  {
+    thread::ThreadPool threads(Env::Default(), "mpmc_ring_buffer_test",
+                               kNumProducers + 1);
+    for (int p = 0; p < kNumProducers; ++p) {
+      threads.Schedule([p, &ring]() {
+        for (int64 i = 0; i < kPerProducer; ++i) {
+          int64 value = p * kPerProducer + i;
+          while (!ring.TryPush(&value)) {
+          }
+        }
+      });
+    }
+    threads.Schedule([&ring, &popped]() {
+      const int64 total = kNumProducers * kPerProducer;
+      while (static_cast<int64>(popped.size()) < total) {
+        ring.TryPopN(kBatchSize, &popped);
+      }
+    });
+  }
+  ASSERT_EQ(kNumProducers * kPerProducer, popped.size());
+  std::vector<int64> last(kNumProducers, -1);
+  for (int64 value : popped) {
+    const int64 producer = value / kPerProducer;
+    EXPECT_LT(last[producer], value);
+    last[producer] = value;
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -37,7 +37,8 @@ PaddingFIFOQueue::PaddingFIFOQueue(
     int capacity, const DataTypeVector& component_dtypes,
     const std::vector<PartialTensorShape>& partial_shapes, const string& name)
     : FIFOQueue(capacity, component_dtypes,
-                ConvertShapesPartialDimensionsToZero(partial_shapes), name),
+                ConvertShapesPartialDimensionsToZero(partial_shapes), name,
+                /*allow_lock_free_ring=*/false),
       partial_shapes_(partial_shapes) {}
 
 Status PaddingFIFOQueue::Initialize() {
@@ -222,6 +222,7 @@ void QueueBase::CloseAndCancel() {
   {
     mutex_lock lock(mu_);
     closed_ = true;
+    closed_hint_.store(true);
     for (Attempt& attempt : enqueue_attempts_) {
       if (!attempt.is_cancelled) {
         attempt.is_cancelled = true;
@@ -253,6 +254,7 @@ void QueueBase::Close(OpKernelContext* ctx, bool cancel_pending_enqueues,
                   errors::Cancelled("Queue '", name_, "' is already closed."));
             } else {
               closed_ = true;
+              closed_hint_.store(true);
             }
             return kComplete;
           });
@@ -316,11 +318,20 @@ void QueueBase::FlushUnlocked() {
   Ref();
   {
     mutex_lock lock(mu_);
+    // Refresh the mirror before running attempts so that a fast path
+    // re-checking it concurrently is guaranteed either to see the
+    // pending attempts or to have its effect on the queue seen by them
+    // (both sides use sequentially consistent operations). Every site
+    // that appends an attempt calls FlushUnlocked() right afterwards.
+    num_pending_attempts_.store(enqueue_attempts_.size() +
+                                dequeue_attempts_.size());
     bool changed;
     do {
       changed = TryAttemptLocked(kEnqueue, &clean_up);
       changed = TryAttemptLocked(kDequeue, &clean_up) || changed;
     } while (changed);
+    num_pending_attempts_.store(enqueue_attempts_.size() +
+                                dequeue_attempts_.size());
   }
   Unref();
   for (const auto& to_clean : clean_up) {
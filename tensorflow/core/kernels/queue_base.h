@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_QUEUE_BASE_H_
 #define TENSORFLOW_CORE_KERNELS_QUEUE_BASE_H_
 
+#include <atomic>
 #include <deque>
 #include <vector>
 
@@ -177,6 +178,16 @@ class QueueBase : public QueueInterface {
   std::deque<Attempt> enqueue_attempts_ GUARDED_BY(mu_);
   std::deque<Attempt> dequeue_attempts_ GUARDED_BY(mu_);
 
+  // Lock-free mirrors of state guarded by mu_, so implementations with
+  // fast paths (see FIFOQueue) can decide whether bypassing mu_ is safe
+  // without acquiring it. Writers must hold mu_: the attempt count is
+  // refreshed by FlushUnlocked(), which every site that appends an
+  // attempt calls right afterwards, and the closed hint is set alongside
+  // closed_. Both may be stale by one registration; fast paths must
+  // tolerate that (see the comment in FlushUnlocked).
+  std::atomic<int64> num_pending_attempts_{0};
+  std::atomic<bool> closed_hint_{false};
+
   TF_DISALLOW_COPY_AND_ASSIGN(QueueBase);
 };
 
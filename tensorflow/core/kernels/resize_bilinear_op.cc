@@ -109,14 +109,15 @@ inline float compute_lerp(const float top_left, const float top_right,
 
 template <typename T>
 void resize_image(
-    typename TTypes<T, 4>::ConstTensor images, const int batch_size,
-    const int64 in_height, const int64 in_width, const int64 out_height,
-    const int64 out_width, const int channels,
+    const CPUDevice& d, typename TTypes<T, 4>::ConstTensor images,
+    const int batch_size, const int64 in_height, const int64 in_width,
+    const int64 out_height, const int64 out_width, const int channels,
     const std::vector<CachedInterpolation>& xs,
     const std::vector<CachedInterpolation>& ys,
     typename TTypes<float, 4>::Tensor output) TF_ATTRIBUTE_NOINLINE;
 template <typename T>
-void resize_image(typename TTypes<T, 4>::ConstTensor images,
+void resize_image(const CPUDevice& d,
+                  typename TTypes<T, 4>::ConstTensor images,
                   const int batch_size, const int64 in_height,
                   const int64 in_width, const int64 out_height,
                   const int64 out_width, const int channels,
@@ -127,16 +128,24 @@ void resize_image(typename TTypes<T, 4>::ConstTensor images,
   const int64 in_batch_num_values = in_height * in_row_size;
   const int64 out_row_size = out_width * channels;
 
-  const T* input_b_ptr = images.data();
+  const T* input_ptr = images.data();
+  float* output_ptr = output.data();
   const CachedInterpolation* xs = xs_vec.data();
 
-  if (channels == 3) {
-    float* output_y_ptr = output.data();
-    for (int b = 0; b < batch_size; ++b) {
-      for (int64 y = 0; y < out_height; ++y) {
-        const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
-        const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
-        const float ys_lerp = ys[y].lerp;
+  // One output row is the unit of work: rows write disjoint output ranges
+  // and read at most two input rows each, so they can be handed to the
+  // intra-op pool independently, across images as well as within one.  The
+  // interpolation weights are computed once and shared by every row.
+  auto resize_rows = [&, xs](Eigen::Index start_row, Eigen::Index end_row) {
+    for (Eigen::Index r = start_row; r < end_row; ++r) {
+      const int64 b = r / out_height;
+      const int64 y = r - b * out_height;
+      const T* input_b_ptr = input_ptr + b * in_batch_num_values;
+      const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
+      const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
+      const float ys_lerp = ys[y].lerp;
+      float* output_y_ptr = output_ptr + r * out_row_size;
+      if (channels == 3) {
         for (int64 x = 0; x < out_width; ++x) {
           const int64 xs_lower = xs[x].lower;
           const int64 xs_upper = xs[x].upper;
@@ -171,17 +180,7 @@ void resize_image(typename TTypes<T, 4>::ConstTensor images,
               compute_lerp(top_left2, top_right2, bottom_left2, bottom_right2,
                            xs_lerp, ys_lerp);
         }
-        output_y_ptr += out_row_size;
-      }
-      input_b_ptr += in_batch_num_values;
-    }
-  } else {
-    float* output_y_ptr = output.data();
-    for (int b = 0; b < batch_size; ++b) {
-      for (int64 y = 0; y < out_height; ++y) {
-        const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
-        const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
-        const float ys_lerp = ys[y].lerp;
+      } else {
         for (int64 x = 0; x < out_width; ++x) {
           auto xs_lower = xs[x].lower;
           auto xs_upper = xs[x].upper;
@@ -196,11 +195,17 @@ void resize_image(typename TTypes<T, 4>::ConstTensor images,
                              xs_lerp, ys_lerp);
           }
         }
-        output_y_ptr += out_row_size;
       }
-      input_b_ptr += in_batch_num_values;
     }
-  }
+  };
+
+  // Per-row cost: four gathered input reads and one output write per
+  // channel, and the seven flops of compute_lerp.  Eigen keeps small
+  // resizes on the calling thread.
+  const Eigen::TensorOpCost cost(out_row_size * sizeof(T) * 4,
+                                 out_row_size * sizeof(float),
+                                 out_row_size * 7);
+  d.parallelFor(batch_size * out_height, cost, resize_rows);
 }
 
 }  // namespace
@@ -249,7 +254,7 @@ struct ResizeBilinear<CPUDevice, T> {
       xs[i].upper *= channels;
     }
 
-    resize_image<T>(images, batch_size, in_height, in_width, out_height,
+    resize_image<T>(d, images, batch_size, in_height, in_width, out_height,
                     out_width, channels, xs, ys, output);
   }
 };
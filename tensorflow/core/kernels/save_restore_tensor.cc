@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -309,9 +310,28 @@ struct RestoreOp {
   string shape_and_slice;
   string reader_prefix;
 
+  // Placement of the tensor within the bundle, used to order concurrent
+  // restores so that every data shard is read sequentially.  Value-initialized
+  // by the aggregate initialization in RestoreTensorsV2.
+  int32 shard_id;
+  int64 offset;
+
   ::tensorflow::Status status;
 };
 
+// Returns the number of threads used to restore large tensors.  Overridable
+// with the TF_NUM_RESTORE_THREADS environment variable, e.g. to match the
+// queue depth that saturates the storage the checkpoint is read from.
+int64 GetNumRestoreThreads() {
+  int64 num_threads;
+  Status s = ReadInt64FromEnvVar("TF_NUM_RESTORE_THREADS", 8, &num_threads);
+  if (!s.ok()) {
+    LOG(WARNING) << "Invalid TF_NUM_RESTORE_THREADS: " << s.error_message();
+    return 8;
+  }
+  return std::max<int64>(1, num_threads);
+}
+
 }  // namespace
 
 Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
@@ -363,19 +383,37 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     auto op =
         new RestoreOp{context, i, tensor_name, shape_and_slice, prefix_string};
     if (op->should_run_in_pool(&default_reader)) {
+      // Ignore status here; a lookup failure will be caught when the
+      // restore itself runs.
+      int64 ignored_size;
+      default_reader
+          .LookupTensorPlacement(tensor_name, &op->shard_id, &op->offset,
+                                 &ignored_size)
+          .IgnoreError();
       pool_restore_ops.emplace_back(op);
     } else {
       direct_restore_ops.emplace_back(op);
     }
   }
 
+  // Schedule the threaded restores in (shard, offset) order.  Each worker
+  // opens its own reader (and hence its own file handles), so with this
+  // ordering concurrent workers stream through different regions of the
+  // bundle instead of seeking randomly within the same shard.
+  std::sort(pool_restore_ops.begin(), pool_restore_ops.end(),
+            [](const std::unique_ptr<RestoreOp>& a,
+               const std::unique_ptr<RestoreOp>& b) {
+              if (a->shard_id != b->shard_id) return a->shard_id < b->shard_id;
+              return a->offset < b->offset;
+            });
+
   {
     // Schedule any threaded operations first, skipping thread pool creation if
     // we don't have any expensive operations.
     std::unique_ptr<thread::ThreadPool> reader_pool;
     if (!pool_restore_ops.empty()) {
-      reader_pool.reset(
-          new thread::ThreadPool(Env::Default(), "restore_tensors", 8));
+      reader_pool.reset(new thread::ThreadPool(
+          Env::Default(), "restore_tensors", GetNumRestoreThreads()));
       for (auto& op : pool_restore_ops) {
         reader_pool->Schedule([&op]() { op->run_with_new_reader(); });
       }
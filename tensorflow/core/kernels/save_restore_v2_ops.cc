@@ -15,6 +15,7 @@ limitations under the License.
 
 // See docs in ../ops/io_ops.cc.
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -25,10 +26,13 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
@@ -85,6 +89,167 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Number of concurrent bundle writers used by SaveV2, read from the
+// TF_SAVEV2_PARALLEL_WRITERS environment variable.  The default of 0 (or
+// 1) keeps the historical single-writer path; values above 1 enable the
+// parallel path below.  Read per save rather than latched: saves are
+// infrequent and this lets long-running jobs adjust the setting.
+int64 SaveV2ParallelWriters() {
+  int64 value = 0;
+  Status s = ReadInt64FromEnvVar("TF_SAVEV2_PARALLEL_WRITERS", 0, &value);
+  if (!s.ok()) {
+    LOG(WARNING) << "Could not parse TF_SAVEV2_PARALLEL_WRITERS: " << s;
+  }
+  return value;
+}
+
+// One bundle entry written by the parallel save path: either a whole
+// input tensor, or a sub-range of one expressed as a slice of the full
+// shape.  "full_shape" and "slice" are meaningful only when "has_slice"
+// is set.
+struct SaveItem {
+  string name;
+  Tensor tensor;
+  bool has_slice;
+  TensorShape full_shape;
+  TensorSlice slice;
+};
+
+// Minimum number of bytes per sub-range when a large tensor is split
+// across writers.  Keeps slices big enough that per-slice metadata and
+// checksum overhead stay negligible next to the raw write.
+const int64 kMinSliceBytes = 64 << 20;
+
+// Writes the tensors to "num_writers" bundles concurrently and merges
+// their metadata into a single bundle under "prefix_string".  Tensors
+// without a caller-provided slice spec that are large enough are split
+// into sub-ranges along their first dimension, stored as slices of the
+// full shape; BundleReader transparently reassembles such entries on
+// restore, so checkpoints written this way need no reader changes.
+Status ParallelSave(OpKernelContext* context, const string& prefix_string,
+                    const Tensor& tensor_names,
+                    const Tensor& shape_and_slices, int num_writers) {
+  const int kFixedInputs = 3;  // Prefix, tensor names, shape_and_slices.
+  const int num_tensors = static_cast<int>(tensor_names.NumElements());
+  const auto& tensor_names_flat = tensor_names.flat<string>();
+  const auto& shape_and_slices_flat = shape_and_slices.flat<string>();
+
+  // Builds the save plan: one item per bundle entry to write.
+  std::vector<SaveItem> items;
+  for (int i = 0; i < num_tensors; ++i) {
+    const string& tensor_name = tensor_names_flat(i);
+    const Tensor& tensor = context->input(i + kFixedInputs);
+
+    if (!shape_and_slices_flat(i).empty()) {
+      // The caller already described this tensor as a slice of a larger
+      // one (e.g. a partitioned variable); keep its spec intact and let
+      // the writer assignment below spread such slices across bundles.
+      const string& shape_spec = shape_and_slices_flat(i);
+      TensorShape shape;
+      TensorSlice slice(tensor.dims());
+      TensorShape slice_shape;
+      TF_RETURN_IF_ERROR(checkpoint::ParseShapeAndSlice(shape_spec, &shape,
+                                                        &slice, &slice_shape));
+      if (!slice_shape.IsSameSize(tensor.shape())) {
+        return errors::InvalidArgument(
+            "Slice in shape_and_slice specification does not match the "
+            "shape of the tensor to  save: ",
+            shape_spec, ", tensor: ", tensor.shape().DebugString());
+      }
+      items.push_back({tensor_name, tensor, true, shape, slice});
+      continue;
+    }
+
+    const int64 total_bytes = static_cast<int64>(tensor.TotalBytes());
+    int64 num_pieces = 1;
+    if (tensor.dims() > 0 && total_bytes >= 2 * kMinSliceBytes) {
+      num_pieces = std::min(
+          {static_cast<int64>(num_writers), tensor.dim_size(0),
+           total_bytes / kMinSliceBytes});
+    }
+    if (num_pieces <= 1) {
+      items.push_back({tensor_name, tensor, false, TensorShape(),
+                       TensorSlice()});
+      continue;
+    }
+    const int64 dim0 = tensor.dim_size(0);
+    for (int64 p = 0; p < num_pieces; ++p) {
+      const int64 start = dim0 * p / num_pieces;
+      const int64 limit = dim0 * (p + 1) / num_pieces;
+      TensorSlice slice(tensor.dims());
+      slice.set_start(0, start);
+      slice.set_length(0, limit - start);
+      // Tensor::Slice() shares the underlying buffer, so the sub-range
+      // costs no copy; the writer streams its bytes directly.
+      items.push_back({tensor_name, tensor.Slice(start, limit), true,
+                       tensor.shape(), slice});
+    }
+  }
+
+  // Assigns items to writers, largest first, each going to the writer
+  // with the fewest bytes so far, so that save time tracks the largest
+  // per-writer total rather than the sum.
+  const int num_used =
+      std::min(num_writers, static_cast<int>(items.size()));
+  std::vector<int> order(items.size());
+  for (int i = 0; i < static_cast<int>(items.size()); ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&items](int a, int b) {
+    return items[a].tensor.TotalBytes() > items[b].tensor.TotalBytes();
+  });
+  std::vector<std::vector<int>> assignments(num_used);
+  std::vector<int64> assigned_bytes(num_used, 0);
+  for (int idx : order) {
+    const int w = std::min_element(assigned_bytes.begin(),
+                                   assigned_bytes.end()) -
+                  assigned_bytes.begin();
+    assignments[w].push_back(idx);
+    assigned_bytes[w] += items[idx].tensor.TotalBytes();
+  }
+  // Restores plan order within each writer for a deterministic layout.
+  for (std::vector<int>& assignment : assignments) {
+    std::sort(assignment.begin(), assignment.end());
+  }
+
+  // Each writer streams its share into a temporary bundle next to the
+  // final prefix.  BundleWriter appends sequentially to one data file, so
+  // concurrency requires one writer (and one data file) per task.
+  std::vector<string> part_prefixes(num_used);
+  std::vector<Status> writer_status(num_used);
+  {
+    thread::ThreadPool pool(Env::Default(), "savev2_parallel_writers",
+                            num_used);
+    for (int w = 0; w < num_used; ++w) {
+      part_prefixes[w] = strings::StrCat(prefix_string, "_part_tmp_", w);
+      pool.Schedule([&items, &assignments, &part_prefixes, &writer_status,
+                     w] {
+        BundleWriter writer(Env::Default(), part_prefixes[w]);
+        Status s = writer.status();
+        for (int idx : assignments[w]) {
+          if (!s.ok()) break;
+          const SaveItem& item = items[idx];
+          if (item.has_slice) {
+            s = writer.AddSlice(item.name, item.full_shape, item.slice,
+                                item.tensor);
+          } else {
+            s = writer.Add(item.name, item.tensor);
+          }
+        }
+        if (s.ok()) s = writer.Finish();
+        writer_status[w] = s;
+      });
+    }
+    // The pool destructor joins all writers.
+  }
+  for (const Status& s : writer_status) {
+    TF_RETURN_IF_ERROR(s);
+  }
+
+  // A single metadata merge produces the final bundle: the per-writer
+  // data files are renamed under "prefix_string" and the temporary
+  // metadata files are removed.
+  return MergeBundles(Env::Default(), part_prefixes, prefix_string);
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
@@ -105,6 +270,19 @@ class SaveV2 : public OpKernel {
     const auto& tensor_names_flat = tensor_names.flat<string>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<string>();
 
+    // With TF_SAVEV2_PARALLEL_WRITERS > 1, large saves stream through
+    // several concurrent bundle writers whose metadata is merged once at
+    // the end; see ParallelSave() above.  The resulting checkpoint is a
+    // regular bundle, readable by any RestoreV2.
+    const int64 num_writers = SaveV2ParallelWriters();
+    if (num_writers > 1 && num_tensors > 0) {
+      OP_REQUIRES_OK(context,
+                     ParallelSave(context, prefix_string, tensor_names,
+                                  shape_and_slices,
+                                  static_cast<int>(num_writers)));
+      return;
+    }
+
     BundleWriter writer(Env::Default(), prefix_string);
     OP_REQUIRES_OK(context, writer.status());
     VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <complex>
+#include <cstdlib>
 #include <string>
 
 #include "tensorflow/core/framework/fake_input.h"
@@ -47,6 +48,17 @@ class SaveV2OpTest : public OpsTestBase {
                      .Finalize(node_def()));
     TF_ASSERT_OK(InitOp());
   }
+
+  void MakeParallelOp() {
+    TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                     .Input(FakeInput())  // prefix
+                     .Input(FakeInput())  // tensor_names
+                     .Input(FakeInput())  // shape_and_slices
+                     .Input(FakeInput(
+                         {DT_INT32, DT_FLOAT, DT_INT64}))  // tensors
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
 };
 
 TEST_F(SaveV2OpTest, Simple) {
@@ -338,5 +350,90 @@ TEST_F(SaveV2OpTest, Simple) {
   }
 }
 
+TEST_F(SaveV2OpTest, ParallelWriters) {
+  // Routes the save through several concurrent bundle writers and checks
+  // that the merged checkpoint reads back like a regular single bundle.
+  setenv("TF_SAVEV2_PARALLEL_WRITERS", "3", 1 /* overwrite */);
+  const string prefix = io::JoinPath(testing::TmpDir(), "tensor_parallel");
+  const string tensornames[] = {"tensor_int", "tensor_float", "tensor_int64"};
+
+  MakeParallelOp();
+  // Add a file name
+  AddInput<string>(TensorShape({}),
+                   [&prefix](int x) -> string { return prefix; });
+
+  // Add the tensor names
+  AddInput<string>(TensorShape({3}),
+                   [&tensornames](int x) -> string { return tensornames[x]; });
+
+  // Add the slice specs
+  AddInput<string>(TensorShape({3}),
+                   [](int x) -> string { return "" /* saves in full */; });
+
+  // Add a 1-d integer tensor
+  AddInput<int32>(TensorShape({10}), [](int x) -> int32 { return x + 1; });
+
+  // Add a 2-d float tensor
+  AddInput<float>(TensorShape({2, 4}),
+                  [](int x) -> float { return static_cast<float>(x) / 10; });
+
+  // Add a 1-d int64 tensor
+  AddInput<int64>(TensorShape({9}), [](int x) -> int64 { return x - 9; });
+  TF_ASSERT_OK(RunOpKernel());
+  unsetenv("TF_SAVEV2_PARALLEL_WRITERS");
+
+  // Check that the merged checkpoint file is properly written
+  BundleReader reader(Env::Default(), prefix);
+  TF_EXPECT_OK(reader.status());
+
+  {
+    // The 1-d integer tensor
+    TensorShape shape;
+    TF_EXPECT_OK(reader.LookupTensorShape("tensor_int", &shape));
+    TensorShape expected({10});
+    EXPECT_TRUE(shape.IsSameSize(expected));
+
+    // We expect the tensor value to be correct.
+    Tensor val;
+    TF_EXPECT_OK(reader.Lookup("tensor_int", &val));
+    EXPECT_EQ(DT_INT32, val.dtype());
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(i + 1, val.template flat<int>()(i));
+    }
+  }
+
+  {
+    // The 2-d float tensor
+    TensorShape shape;
+    TF_EXPECT_OK(reader.LookupTensorShape("tensor_float", &shape));
+    TensorShape expected({2, 4});
+    EXPECT_TRUE(shape.IsSameSize(expected));
+
+    // We expect the tensor value to be correct.
+    Tensor val;
+    TF_EXPECT_OK(reader.Lookup("tensor_float", &val));
+    EXPECT_EQ(DT_FLOAT, val.dtype());
+    for (int i = 0; i < 8; ++i) {
+      EXPECT_EQ(static_cast<float>(i) / 10, val.template flat<float>()(i));
+    }
+  }
+
+  {
+    // The 1-d int64 tensor
+    TensorShape shape;
+    TF_EXPECT_OK(reader.LookupTensorShape("tensor_int64", &shape));
+    TensorShape expected({9});
+    EXPECT_TRUE(shape.IsSameSize(expected));
+
+    // We expect the tensor value to be correct.
+    Tensor val;
+    TF_EXPECT_OK(reader.Lookup("tensor_int64", &val));
+    EXPECT_EQ(DT_INT64, val.dtype());
+    for (int i = 0; i < 9; ++i) {
+      EXPECT_EQ(i - 9, val.template flat<int64>()(i));
+    }
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
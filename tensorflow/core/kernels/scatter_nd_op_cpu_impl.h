@@ -20,7 +20,9 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <atomic>
+#include <vector>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
@@ -86,6 +88,11 @@ class UpdateExecutor<Input, Update, Output, scatter_nd_op::UpdateOp::SUB> {
 
 namespace functor {
 
+// Minimum number of updates for which the CPU functor buckets updates by
+// output range and applies the buckets in parallel. Below this the
+// bucketing pass costs more than it saves.
+constexpr Eigen::DenseIndex kScatterNdParallelMinBatch = 4096;
+
 // Implementation of update functor for CPU.
 template <typename T, typename Index, scatter_nd_op::UpdateOp OP, int IXDIM>
 struct ScatterNdFunctor<CPUDevice, T, Index, OP, IXDIM> {
@@ -112,6 +119,79 @@ struct ScatterNdFunctor<CPUDevice, T, Index, OP, IXDIM> {
       }
     }
 
+    const Eigen::DenseIndex num_output_rows = Toutput.dimension(0);
+    if (batch_size >= kScatterNdParallelMinBatch && d.numThreads() > 1 &&
+        num_output_rows > 0) {
+      // Two-phase parallel path: bucket updates by contiguous ranges of the
+      // output's first dimension, then apply each bucket with exclusive
+      // ownership of its output rows - no two workers touch the same row, so
+      // no atomics are needed. Updates keep their original order within a
+      // bucket, and duplicates always land in the same bucket, so the result
+      // is identical to the serial loop for every update op.
+      std::vector<Index> flat_index(batch_size);
+      Eigen::DenseIndex valid_batch = batch_size;
+      for (Eigen::DenseIndex loc = 0; loc < batch_size; ++loc) {
+        Index i = 0;
+        bool out_of_bounds = false;
+        for (int dim = 0; dim < IXDIM; ++dim) {
+          const Index ix_d = internal::SubtleMustCopy(Tindices(loc, dim));
+          out_of_bounds |= !FastBoundsCheck(ix_d, output_shape_prefix[dim]);
+          i += ix_d * batch_strides[dim];
+        }
+        if (TF_PREDICT_FALSE(out_of_bounds)) {
+          // Match the serial loop: updates before the first bad index are
+          // still applied.
+          error_loc = loc;
+          valid_batch = loc;
+          break;
+        }
+        flat_index[loc] = i;
+      }
+
+      const Eigen::DenseIndex num_buckets = std::min<Eigen::DenseIndex>(
+          4 * static_cast<Eigen::DenseIndex>(d.numThreads()), num_output_rows);
+      const Eigen::DenseIndex rows_per_bucket =
+          (num_output_rows + num_buckets - 1) / num_buckets;
+      // Stable counting sort of update locations into buckets.
+      std::vector<Eigen::DenseIndex> bucket_start(num_buckets + 1, 0);
+      for (Eigen::DenseIndex loc = 0; loc < valid_batch; ++loc) {
+        ++bucket_start[flat_index[loc] / rows_per_bucket + 1];
+      }
+      for (Eigen::DenseIndex b = 0; b < num_buckets; ++b) {
+        bucket_start[b + 1] += bucket_start[b];
+      }
+      std::vector<Eigen::DenseIndex> ordered_locs(valid_batch);
+      std::vector<Eigen::DenseIndex> fill(bucket_start.begin(),
+                                          bucket_start.begin() + num_buckets);
+      for (Eigen::DenseIndex loc = 0; loc < valid_batch; ++loc) {
+        ordered_locs[fill[flat_index[loc] / rows_per_bucket]++] = loc;
+      }
+
+      auto apply_buckets = [&](Eigen::DenseIndex first,
+                               Eigen::DenseIndex last) {
+        for (Eigen::DenseIndex b = first; b < last; ++b) {
+          for (Eigen::DenseIndex p = bucket_start[b]; p < bucket_start[b + 1];
+               ++p) {
+            const Eigen::DenseIndex loc = ordered_locs[p];
+            // Evaluate on the default device: the workers themselves are the
+            // parallelism, and slices are too small to subdivide further.
+            auto input_chip = Toutput.template chip<0>(flat_index[loc]);
+            auto update_chip = Tupdates.template chip<0>(loc);
+            update_executor::UpdateExecutor<
+                decltype(input_chip), decltype(update_chip),
+                decltype(input_chip)&, OP>::Execute(input_chip, update_chip,
+                                                    input_chip);
+          }
+        }
+      };
+      const double bucket_cost =
+          static_cast<double>(valid_batch) * slice_size / num_buckets;
+      d.parallelFor(num_buckets,
+                    Eigen::TensorOpCost(bucket_cost, bucket_cost, bucket_cost),
+                    apply_buckets);
+      return error_loc;
+    }
+
     for (Eigen::DenseIndex loc = 0; loc < batch_size; ++loc) {
       Index i = 0;
       bool out_of_bounds = false;
@@ -36,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -119,80 +120,92 @@ class SegmentReductionOp : public OpKernel {
 #else
     Eigen::IndexList<Eigen::type2index<0> > dims_to_reduce;
 #endif
-    Index start = 0, end = 1;
-
-    Index uninitialized_index = 0;  // Index from which the output is not set.
-    Index out_index = internal::SubtleMustCopy(segment_vec(start));
-
-    // TODO(agarwal): if this loop becomes a bottleneck, consider sharding it
-    // across threads.
     Eigen::DSizes<Eigen::DenseIndex, 1> out_slice_shape(num_col);
-    while (end <= num_indices) {
-      // We initialize next_index to 0 to avoid "warning: 'next_index' may be
-      // used uninitialized in this function" in the Mac build (since the
-      // compiler isn't smart enough to realize the code is safe).
-      Index next_index = 0;
-      if (end < num_indices) {
-        next_index = internal::SubtleMustCopy(segment_vec(end));
-        if (out_index == next_index) {
+
+    // Input rows are sharded across the intra-op pool; a worker processes
+    // exactly the segments that *begin* inside its row range, including the
+    // rows of such a segment that spill past the range. Every segment is
+    // therefore reduced in full by one worker with the same in-order Eigen
+    // reduction regardless of how the rows were partitioned, which keeps the
+    // result bitwise identical to the serial pass for any thread count.
+    auto reduce_segments = [&](int64 start_row, int64 end_row) {
+      Index start = start_row;
+      // Skip rows that continue a segment begun in the previous range.
+      while (start < end_row && start > 0 &&
+             internal::SubtleMustCopy(segment_vec(start)) ==
+                 internal::SubtleMustCopy(segment_vec(start - 1))) {
+        ++start;
+      }
+      // Index from which this worker's slice of the output is not set.
+      Index uninitialized_index =
+          start > 0 ? internal::SubtleMustCopy(segment_vec(start - 1)) + 1 : 0;
+      while (start < end_row) {
+        const Index out_index = internal::SubtleMustCopy(segment_vec(start));
+        // Verify that the segment ids are growing; every row pair that
+        // crosses a segment boundary is checked by the worker that owns the
+        // segment starting at that boundary.
+        OP_REQUIRES(context, out_index >= uninitialized_index,
+                    errors::InvalidArgument("segment ids are not increasing"));
+        OP_REQUIRES(
+            context, FastBoundsCheck(out_index, output_rows),
+            errors::InvalidArgument(
+                "Segment id ", out_index, " out of range [0, ", output_rows,
+                "), possibly because 'segment_ids' input is not sorted."));
+        Index end = start + 1;
+        while (end < num_indices &&
+               internal::SubtleMustCopy(segment_vec(end)) == out_index) {
           ++end;
-          continue;
         }
-        // We have a new segment here.  Verify that the segment ids are growing.
-        OP_REQUIRES(context, out_index < next_index,
-                    errors::InvalidArgument("segment ids are not increasing"));
-      }
-
-      // Process segment [start, end)
-      const T* in_slice_ptr = &input_flat(start, 0);
-      typedef Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor>,
-                               Eigen::Unaligned>
-          OutT;
-
-      OP_REQUIRES(
-          context, FastBoundsCheck(out_index, output_rows),
-          errors::InvalidArgument(
-              "Segment id ", out_index, " out of range [0, ", output_rows,
-              "), possibly because 'segment_ids' input is not sorted."));
 
-      // If there is a gap between two indices, we need to set that gap to the
-      // default value.
-      if (out_index > uninitialized_index) {
-        Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
-            out_index - uninitialized_index, num_col);
-        Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>, Eigen::Unaligned>
-            gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
-        gap_slice.setConstant(T(default_value));
-      }
+        // If there is a gap between two indices, we need to set that gap to
+        // the default value.
+        if (out_index > uninitialized_index) {
+          Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
+              out_index - uninitialized_index, num_col);
+          Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                           Eigen::Unaligned>
+              gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
+          gap_slice.setConstant(T(default_value));
+        }
 
-      T* out_slice_ptr = &output_flat(out_index, 0);
-      OutT out_slice(out_slice_ptr, out_slice_shape);
-      // We don't use out_slice.device(context->eigen_device<Device>)
-      // because these pieces of work are likely to be very small and
-      // the context switching overhead dwarfs any benefit we get from
-      // using another thread to do this work.
-      if (start == end - 1) {
-        typedef Eigen::TensorMap<Eigen::Tensor<const T, 1, Eigen::RowMajor>,
-                                 Eigen::Unaligned>
-            InT;
-        InT in_slice(in_slice_ptr, out_slice_shape);
-        out_slice = in_slice;
-      } else {
-        Eigen::DSizes<Eigen::DenseIndex, 2> in_slice_shape(end - start,
-                                                           num_col);
-        typedef Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor>,
+        // Process segment [start, end)
+        const T* in_slice_ptr = &input_flat(start, 0);
+        typedef Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor>,
                                  Eigen::Unaligned>
-            InT;
-        InT in_slice(in_slice_ptr, in_slice_shape);
-
-        out_slice = in_slice.reduce(dims_to_reduce, Reducer());
+            OutT;
+        T* out_slice_ptr = &output_flat(out_index, 0);
+        OutT out_slice(out_slice_ptr, out_slice_shape);
+        // We don't use out_slice.device(context->eigen_device<Device>)
+        // because these pieces of work are likely to be very small and
+        // the context switching overhead dwarfs any benefit we get from
+        // using another thread to do this work.
+        if (start == end - 1) {
+          typedef Eigen::TensorMap<Eigen::Tensor<const T, 1, Eigen::RowMajor>,
+                                   Eigen::Unaligned>
+              InT;
+          InT in_slice(in_slice_ptr, out_slice_shape);
+          out_slice = in_slice;
+        } else {
+          Eigen::DSizes<Eigen::DenseIndex, 2> in_slice_shape(end - start,
+                                                             num_col);
+          typedef Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor>,
+                                   Eigen::Unaligned>
+              InT;
+          InT in_slice(in_slice_ptr, in_slice_shape);
+
+          out_slice = in_slice.reduce(dims_to_reduce, Reducer());
+        }
+        uninitialized_index = out_index + 1;
+        start = end;
       }
-      if (end >= num_indices) break;
-      start = end;
-      ++end;
-      uninitialized_index = out_index + 1;
-      out_index = next_index;
-    }
+    };
+
+    const int64 cost_per_row =
+        num_col * (Eigen::TensorOpCost::AddCost<T>() +
+                   Eigen::TensorOpCost::AddCost<Index>());
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers, num_indices,
+          cost_per_row, reduce_segments);
   }
 };
 
@@ -63,11 +63,11 @@ SendOp::SendOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
                         reinterpret_cast<int64*>(&send_device_incarnation)));
   string tensor_name;
   OP_REQUIRES_OK(ctx, ctx->GetAttr("tensor_name", &tensor_name));
-  key_prefix_ = GetRendezvousKeyPrefix(send_device, recv_device,
-                                       send_device_incarnation, tensor_name);
+  const string key_prefix = GetRendezvousKeyPrefix(
+      send_device, recv_device, send_device_incarnation, tensor_name);
   // The vast majority of Send nodes are outside any loop context, so
   // proactively cache the rendezvous key for the top-level.
-  GetRendezvousKey(key_prefix_, {0, 0}, &parsed_key_.buf_);
+  GetRendezvousKey(key_prefix, {0, 0}, &parsed_key_.buf_);
   OP_REQUIRES_OK(ctx, Rendezvous::ParseKey(parsed_key_.buf_, &parsed_key_));
   if (!ctx->GetAttr("_hostmem_sendrecv", &hostmem_sendrecv_).ok()) {
     hostmem_sendrecv_ = false;
@@ -95,11 +95,11 @@ void SendOp::Compute(OpKernelContext* ctx) {
                                            ctx->is_input_dead()));
     return;
   } else {
-    Rendezvous::ParsedKey in_loop_parsed;
-    GetRendezvousKey(key_prefix_, frame_iter, &in_loop_parsed.buf_);
+    // Derive the key for this frame/iteration from the key parsed at kernel
+    // construction; only the trailing frame_id:iter_id component differs.
+    Rendezvous::ParsedKey in_loop_parsed = parsed_key_;
+    in_loop_parsed.SetFrameAndIter(frame_iter);
     VLOG(2) << "Send " << in_loop_parsed.buf_;
-    OP_REQUIRES_OK(ctx,
-                   Rendezvous::ParseKey(in_loop_parsed.buf_, &in_loop_parsed));
 
     ctx->SetStatus(ctx->rendezvous()->Send(in_loop_parsed, args, ctx->input(0),
                                            ctx->is_input_dead()));
@@ -130,11 +130,11 @@ RecvOp::RecvOp(OpKernelConstruction* ctx) : AsyncOpKernel(ctx) {
                         reinterpret_cast<int64*>(&send_device_incarnation)));
   string tensor_name;
   OP_REQUIRES_OK(ctx, ctx->GetAttr("tensor_name", &tensor_name));
-  key_prefix_ = GetRendezvousKeyPrefix(send_device, recv_device,
-                                       send_device_incarnation, tensor_name);
+  const string key_prefix = GetRendezvousKeyPrefix(
+      send_device, recv_device, send_device_incarnation, tensor_name);
   // The vast majority of Recv nodes are outside any loop context, so
   // proactively cache the rendezvous key for the top-level.
-  GetRendezvousKey(key_prefix_, {0, 0}, &parsed_key_.buf_);
+  GetRendezvousKey(key_prefix, {0, 0}, &parsed_key_.buf_);
   OP_REQUIRES_OK(ctx, Rendezvous::ParseKey(parsed_key_.buf_, &parsed_key_));
   if (!ctx->GetAttr("_hostmem_sendrecv", &hostmem_sendrecv_).ok()) {
     hostmem_sendrecv_ = false;
@@ -182,11 +182,11 @@ void RecvOp::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
     ctx->rendezvous()->RecvAsync(parsed_key_, args,
                                  make_recv_callback(ctx, std::move(done)));
   } else {
-    Rendezvous::ParsedKey in_loop_parsed;
-    GetRendezvousKey(key_prefix_, frame_iter, &in_loop_parsed.buf_);
+    // Derive the key for this frame/iteration from the key parsed at kernel
+    // construction; only the trailing frame_id:iter_id component differs.
+    Rendezvous::ParsedKey in_loop_parsed = parsed_key_;
+    in_loop_parsed.SetFrameAndIter(frame_iter);
     VLOG(2) << "Recv " << in_loop_parsed.buf_;
-    OP_REQUIRES_OK_ASYNC(
-        ctx, Rendezvous::ParseKey(in_loop_parsed.buf_, &in_loop_parsed), done);
     ctx->rendezvous()->RecvAsync(in_loop_parsed, args,
                                  make_recv_callback(ctx, std::move(done)));
   }
@@ -27,7 +27,6 @@ class SendOp : public OpKernel {
   void Compute(OpKernelContext* ctx) override;
 
  private:
-  string key_prefix_;
   Rendezvous::ParsedKey parsed_key_;
   bool hostmem_sendrecv_;
 
@@ -40,7 +39,6 @@ class RecvOp : public AsyncOpKernel {
   void ComputeAsync(OpKernelContext* ctx, DoneCallback done) override;
 
  private:
-  string key_prefix_;
   Rendezvous::ParsedKey parsed_key_;
   bool hostmem_sendrecv_;
 
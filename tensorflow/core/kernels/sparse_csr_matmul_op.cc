@@ -0,0 +1,268 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/sparse_ops.cc.
+
+#include <algorithm>
+#include <vector>
+
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Compressed sparse row representation of a rank-2 SparseTensor, built once
+// and then shared through the resource manager by every kernel holding the
+// handle. Materializing the row-pointer / column-index structure up front
+// removes the per-call COO index decoding that SparseTensorDenseMatMul pays
+// when the same sparsity pattern is multiplied many times.
+template <typename T>
+class CSRMatrix : public ResourceBase {
+ public:
+  CSRMatrix(int64 rows, int64 cols, std::vector<int64> row_ptr,
+            std::vector<int64> col_ind, std::vector<T> values)
+      : rows_(rows),
+        cols_(cols),
+        row_ptr_(std::move(row_ptr)),
+        col_ind_(std::move(col_ind)),
+        values_(std::move(values)) {}
+
+  int64 rows() const { return rows_; }
+  int64 cols() const { return cols_; }
+  int64 nnz() const { return static_cast<int64>(col_ind_.size()); }
+
+  // Entries of row m are stored at positions [row_ptr()[m], row_ptr()[m + 1])
+  // of col_ind() and values(), in the order they appeared in the input.
+  const std::vector<int64>& row_ptr() const { return row_ptr_; }
+  const std::vector<int64>& col_ind() const { return col_ind_; }
+  const std::vector<T>& values() const { return values_; }
+
+  string DebugString() const override {
+    return strings::StrCat("CSRMatrix[", rows_, ", ", cols_, "] with ", nnz(),
+                           " nonzeros");
+  }
+
+  int64 MemoryUsed() const override {
+    return static_cast<int64>(row_ptr_.size() * sizeof(int64) +
+                              col_ind_.size() * sizeof(int64) +
+                              values_.size() * sizeof(T));
+  }
+
+ private:
+  const int64 rows_;
+  const int64 cols_;
+  const std::vector<int64> row_ptr_;
+  const std::vector<int64> col_ind_;
+  const std::vector<T> values_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CSRMatrix);
+};
+
+}  // namespace
+
+template <typename T>
+class SparseTensorToCSRMatrixOp : public OpKernel {
+ public:
+  explicit SparseTensorToCSRMatrixOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {}
+
+  ~SparseTensorToCSRMatrixOp() override {
+    if (matrix_ != nullptr) {
+      matrix_->Unref();
+      if (cinfo_.resource_is_private_to_kernel()) {
+        if (!cinfo_.resource_manager()
+                 ->template Delete<CSRMatrix<T>>(cinfo_.container(),
+                                                 cinfo_.name())
+                 .ok()) {
+          // Do nothing; the resource may have been deleted by session resets.
+        }
+      }
+    }
+  }
+
+  void Compute(OpKernelContext* ctx) override LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    if (matrix_ == nullptr) {
+      OP_REQUIRES_OK(ctx, cinfo_.Init(ctx->resource_manager(), def()));
+      CSRMatrix<T>* matrix = nullptr;
+      auto creator = [ctx](CSRMatrix<T>** ret) { return BuildCSR(ctx, ret); };
+      OP_REQUIRES_OK(ctx, cinfo_.resource_manager()
+                              ->template LookupOrCreate<CSRMatrix<T>>(
+                                  cinfo_.container(), cinfo_.name(), &matrix,
+                                  creator));
+      matrix_ = matrix;
+    }
+    OP_REQUIRES_OK(ctx, MakeResourceHandleToOutput(
+                            ctx, 0, cinfo_.container(), cinfo_.name(),
+                            MakeTypeIndex<CSRMatrix<T>>()));
+  }
+
+ private:
+  static Status BuildCSR(OpKernelContext* ctx, CSRMatrix<T>** ret) {
+    const Tensor& indices = ctx->input(0);
+    const Tensor& values = ctx->input(1);
+    const Tensor& dense_shape = ctx->input(2);
+
+    if (!TensorShapeUtils::IsMatrix(indices.shape())) {
+      return errors::InvalidArgument("indices must be a matrix, but got shape ",
+                                     indices.shape().DebugString());
+    }
+    if (!TensorShapeUtils::IsVector(values.shape())) {
+      return errors::InvalidArgument("values must be a vector, but got shape ",
+                                     values.shape().DebugString());
+    }
+    if (dense_shape.NumElements() != 2 || indices.dim_size(1) != 2) {
+      return errors::InvalidArgument(
+          "only rank-2 SparseTensors can be converted to CSR form");
+    }
+    const int64 nnz = indices.dim_size(0);
+    if (nnz != values.NumElements()) {
+      return errors::InvalidArgument("indices has ", nnz, " rows but values has ",
+                                     values.NumElements(), " entries");
+    }
+    auto shape_vec = dense_shape.vec<int64>();
+    const int64 rows = shape_vec(0);
+    const int64 cols = shape_vec(1);
+    if (rows < 0 || cols < 0) {
+      return errors::InvalidArgument("dense_shape must be non-negative");
+    }
+
+    auto indices_mat = indices.matrix<int64>();
+    auto values_vec = values.vec<T>();
+
+    // Counting sort by row: one pass to count entries per row, a prefix sum
+    // to form the row pointers, and one pass to place column indices and
+    // values. Entries within a row keep their input order.
+    std::vector<int64> row_ptr(rows + 1, 0);
+    for (int64 i = 0; i < nnz; ++i) {
+      const int64 r = internal::SubtleMustCopy(indices_mat(i, 0));
+      const int64 c = internal::SubtleMustCopy(indices_mat(i, 1));
+      if (!FastBoundsCheck(r, rows) || !FastBoundsCheck(c, cols)) {
+        return errors::InvalidArgument("index (", r, ", ", c,
+                                       ") out of bounds for shape (", rows,
+                                       ", ", cols, ")");
+      }
+      ++row_ptr[r + 1];
+    }
+    for (int64 r = 0; r < rows; ++r) {
+      row_ptr[r + 1] += row_ptr[r];
+    }
+    std::vector<int64> col_ind(nnz);
+    std::vector<T> csr_values(nnz);
+    std::vector<int64> fill(row_ptr.begin(), row_ptr.end() - 1);
+    for (int64 i = 0; i < nnz; ++i) {
+      const int64 pos = fill[indices_mat(i, 0)]++;
+      col_ind[pos] = indices_mat(i, 1);
+      csr_values[pos] = values_vec(i);
+    }
+
+    *ret = new CSRMatrix<T>(rows, cols, std::move(row_ptr), std::move(col_ind),
+                            std::move(csr_values));
+    return Status::OK();
+  }
+
+  mutex mu_;
+  ContainerInfo cinfo_ GUARDED_BY(mu_);
+  CSRMatrix<T>* matrix_ GUARDED_BY(mu_) = nullptr;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SparseTensorToCSRMatrixOp);
+};
+
+template <typename T>
+class CSRMatrixDenseMatMulOp : public OpKernel {
+ public:
+  explicit CSRMatrixDenseMatMulOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    CSRMatrix<T>* matrix = nullptr;
+    OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &matrix));
+    core::ScopedUnref unref(matrix);
+
+    const Tensor& b = ctx->input(1);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsMatrix(b.shape()),
+                errors::InvalidArgument("Tensor 'b' is not a matrix"));
+    OP_REQUIRES(
+        ctx, b.dim_size(0) == matrix->cols(),
+        errors::InvalidArgument(
+            "Cannot multiply A and B because inner dimension does not match: ",
+            matrix->cols(), " vs. ", b.dim_size(0)));
+
+    const int64 rows = matrix->rows();
+    const int64 n = b.dim_size(1);
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, TensorShape({rows, n}), &out));
+    if (out->NumElements() == 0) {
+      return;
+    }
+
+    const int64* row_ptr = matrix->row_ptr().data();
+    const int64* col_ind = matrix->col_ind().data();
+    const T* values = matrix->values().data();
+    const T* b_data = b.flat<T>().data();
+    T* out_data = out->flat<T>().data();
+
+    // Rows of the output are independent, so shard over them; within a row
+    // the inner loop is a dense axpy over the columns of B, which the
+    // compiler vectorizes.
+    auto multiply_rows = [row_ptr, col_ind, values, b_data, out_data, n](
+                             int64 row_begin, int64 row_end) {
+      for (int64 m = row_begin; m < row_end; ++m) {
+        T* out_row = out_data + m * n;
+        std::fill(out_row, out_row + n, T(0));
+        for (int64 i = row_ptr[m]; i < row_ptr[m + 1]; ++i) {
+          const T a_value = values[i];
+          const T* b_row = b_data + col_ind[i] * n;
+          for (int64 j = 0; j < n; ++j) {
+            out_row[j] += a_value * b_row[j];
+          }
+        }
+      }
+    };
+    auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+    const int64 avg_nnz_per_row =
+        rows > 0 ? (matrix->nnz() + rows - 1) / rows : 0;
+    // Roughly one multiply-add per (nonzero, column) pair.
+    const int64 cost_per_row = (avg_nnz_per_row + 1) * n * 2;
+    Shard(worker_threads.num_threads, worker_threads.workers, rows,
+          cost_per_row, multiply_rows);
+  }
+};
+
+#define REGISTER_CSR_KERNELS(T)                                          \
+  REGISTER_KERNEL_BUILDER(Name("SparseTensorToCSRMatrix")                \
+                              .Device(DEVICE_CPU)                        \
+                              .TypeConstraint<T>("T"),                   \
+                          SparseTensorToCSRMatrixOp<T>);                 \
+  REGISTER_KERNEL_BUILDER(                                               \
+      Name("CSRMatrixDenseMatMul").Device(DEVICE_CPU).TypeConstraint<T>( \
+          "T"),                                                          \
+      CSRMatrixDenseMatMulOp<T>);
+
+TF_CALL_float(REGISTER_CSR_KERNELS);
+TF_CALL_double(REGISTER_CSR_KERNELS);
+#undef REGISTER_CSR_KERNELS
+
+}  // namespace tensorflow
@@ -133,6 +133,52 @@ class StridedSliceOp : public OpKernel {
       return;
     }
 
+    // Optimization #2b, slice is memory contiguous but starts in a dimension
+    // other than 0.  This covers the common feature-carving pattern where
+    // every dimension before the sliced one is pinned to a single index and
+    // every dimension after it is taken in full: the result is one contiguous
+    // range of the input buffer, so it can alias the input at an offset the
+    // same way Tensor::Slice does for dim 0, saving both the copy and the
+    // allocation.
+    if (is_simple_slice && new_axis_mask == 0 &&
+        processing_shape.dims() == input.dims() &&
+        processing_shape.num_elements() > 0) {
+      int dim = 0;
+      while (dim < input.dims() && end[dim] - begin[dim] == 1) ++dim;
+      // 'dim' is the outermost dimension with more than one result element;
+      // for contiguity every dimension after it must be taken in full.
+      bool contiguous = true;
+      for (int i = dim + 1; i < input.dims(); ++i) {
+        if (begin[i] != 0 || end[i] != input.dim_size(i)) {
+          contiguous = false;
+          break;
+        }
+      }
+      if (contiguous) {
+        int64 offset = 0;
+        for (int i = 0; i < input.dims(); ++i) {
+          offset = offset * input.dim_size(i) + begin[i];
+        }
+        const int64 num_slice_elems = processing_shape.num_elements();
+        const TensorShape flat_shape({input.NumElements()});
+        if (IsDim0SliceAligned<T>(flat_shape, offset,
+                                  offset + num_slice_elems)) {
+          VLOG(1) << "Strided slice contiguous view: "
+                  << input.shape().DebugString();
+          Tensor flat;
+          OP_REQUIRES(context, flat.CopyFrom(input, flat_shape),
+                      errors::Internal("Copy failed"));
+          Tensor tmp;
+          OP_REQUIRES(context,
+                      tmp.CopyFrom(flat.Slice(offset, offset + num_slice_elems),
+                                   final_shape),
+                      errors::Internal("Copy failed"));
+          context->set_output(0, tmp);
+          return;
+        }
+      }
+    }
+
     Tensor* result = nullptr;
     OP_REQUIRES_OK(context, context->allocate_output(0, final_shape, &result));
     const int input_dims = input.dims();
@@ -15,6 +15,7 @@ limitations under the License.
 
 // See docs in ../ops/string_ops.cc.
 
+#include <algorithm>
 #include <string>
 
 #include "tensorflow/core/framework/kernel_def_builder.h"
@@ -24,83 +25,90 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
+
+// Guess that we'll be unpacking a handful of tokens per example.
+constexpr int kReserveSize = 4;
 // Split input string `str` based on a character delimiter.
-// Returns a vector of StringPieces which are valid as long as input `str`
-// is valid.
+// Appends StringPieces to `*result`, which are valid as long as input `str`
+// is valid.  The split helpers append to a caller-owned vector so a batch of
+// inputs shares one token buffer instead of allocating a vector per example.
 // Note: The single character delimiter is a common case and is implemented as
 // a series of finds in the input string, making it much more effcient than
 // SplitOnCharSet.
 template <typename Predicate>
-std::vector<StringPiece> SplitOnChar(const string& str, const char delim,
-                                     Predicate p) {
-  std::vector<StringPiece> result;
+void SplitOnChar(const string& str, const char delim, Predicate p,
+                 std::vector<StringPiece>* result) {
   StringPiece text(str);
   auto f = text.find(delim);
   while (f != StringPiece::npos) {
     StringPiece token = text.substr(0, f);
     if (p(token)) {
-      result.emplace_back(token);
+      result->emplace_back(token);
     }
     text.remove_prefix(f + 1);
     f = text.find(delim);
   }
   if (p(text)) {
-    result.push_back(text);
+    result->push_back(text);
   }
-  return result;
 }
 
 // Split input string `str` based on a set of character delimiters.
-// Returns a vector of StringPieces which are valid as long as input `str`
+// Appends StringPieces to `*result`, which are valid as long as input `str`
 // is valid.
 // Based on str_util::Split.
 template <typename Predicate>
-std::vector<StringPiece> SplitOnCharSet(const string& str,
-                                        const string& delim_set, Predicate p) {
-  std::vector<StringPiece> result;
+void SplitOnCharSet(const string& str, const string& delim_set, Predicate p,
+                    std::vector<StringPiece>* result) {
   StringPiece text(str);
-  StringPiece delims(delim_set);
+  // A 256-entry membership table turns the per-character scan of the
+  // delimiter set into a single array lookup.
+  bool is_delim[256] = {};
+  for (const char d : delim_set) {
+    is_delim[static_cast<uint8>(d)] = true;
+  }
   size_t token_start = 0;
   for (size_t i = 0; i < text.size() + 1; i++) {
-    if ((i == text.size()) || (delims.find(text[i]) != StringPiece::npos)) {
+    if ((i == text.size()) || is_delim[static_cast<uint8>(text[i])]) {
       StringPiece token(text.data() + token_start, i - token_start);
       if (p(token)) {
-        result.emplace_back(token);
+        result->emplace_back(token);
       }
       token_start = i + 1;
     }
   }
-  return result;
 }
 
 // Split input string `str` based on given delimiter.
-// Returns a vector of StringPieces which are valid as long as input `str`
+// Appends StringPieces to `*result`, which are valid as long as input `str`
 // is valid.
 template <typename Predicate>
-std::vector<StringPiece> Split(const string& str, const string& delimiter,
-                               Predicate predicate) {
+void Split(const string& str, const string& delimiter, Predicate predicate,
+           std::vector<StringPiece>* result) {
   if (str.empty()) {
-    return std::vector<StringPiece>();
+    return;
   }
   if (delimiter.empty()) {
-    std::vector<StringPiece> result;
-    result.resize(str.size());
+    result->reserve(result->size() + str.size());
     for (size_t i = 0; i < str.size(); ++i) {
-      result[i] = StringPiece(str.data() + i, 1);
+      result->push_back(StringPiece(str.data() + i, 1));
     }
-    return result;
+    return;
   }
   if (delimiter.size() == 1) {
-    return SplitOnChar(str, delimiter[0], predicate);
+    SplitOnChar(str, delimiter[0], predicate, result);
+    return;
   }
-  return SplitOnCharSet(str, delimiter, predicate);
+  SplitOnCharSet(str, delimiter, predicate, result);
 }
 
-std::vector<StringPiece> SplitV2(const string& str, StringPiece sep,
-                                 int maxsplit) {
+void SplitV2(const string& str, StringPiece sep, int maxsplit,
+             std::vector<StringPiece>* result) {
   // This SplitV2 method matches the behavior of python's str.split:
   //   If sep is given, consecutive delimiters are not grouped together
   //   and are deemed to delimit empty strings (for example, '1,,2'.split(',')
@@ -115,12 +123,10 @@ std::vector<StringPiece> SplitV2(const string& str, StringPiece sep,
   //   splitting an empty string or a string consisting of just whitespace
   //   with a None separator returns [].
 
-  std::vector<StringPiece> result;
-
   StringPiece text(str);
   if (maxsplit == 0) {
-    result.emplace_back(text);
-    return result;
+    result->emplace_back(text);
+    return;
   }
 
   if (sep.empty()) {
@@ -129,32 +135,79 @@ std::vector<StringPiece> SplitV2(const string& str, StringPiece sep,
     str_util::RemoveLeadingWhitespace(&text);
     int split = 0;
     while (str_util::ConsumeNonWhitespace(&text, &token)) {
-      result.push_back(token);
+      result->push_back(token);
       str_util::RemoveLeadingWhitespace(&text);
       ++split;
       if (maxsplit > 0 && split == maxsplit) {
-        result.push_back(text);
-        return result;
+        result->push_back(text);
+        return;
       }
     }
-    return result;
+    return;
   }
   auto p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
   int split = 0;
   while (p != text.end()) {
     StringPiece token = text.substr(0, p - text.begin());
-    result.push_back(token);
+    result->push_back(token);
     text.remove_prefix(token.size());
     text.remove_prefix(sep.size());
     ++split;
     if (maxsplit > 0 && split == maxsplit) {
-      result.push_back(StringPiece(text));
-      return result;
+      result->push_back(StringPiece(text));
+      return;
     }
     p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
   }
-  result.push_back(text);
-  return result;
+  result->push_back(text);
+}
+
+// Tokens for the contiguous range of input elements [start, start + n), where
+// n == num_tokens.size(). All tokens of the range share one buffer; the
+// tokens of element start + k are the num_tokens[k] entries following the
+// tokens of the preceding elements.
+struct SplitChunk {
+  int64 start;
+  std::vector<StringPiece> tokens;
+  std::vector<int64> num_tokens;
+};
+
+// Splits every element of the string vector `input_tensor`, sharding elements
+// across the intra-op threadpool. `split_fn(element, &tokens)` appends the
+// tokens of one element. Each shard appends to a private buffer, so no
+// per-element vector is materialized; stitching the chunks back together in
+// element order yields the same result as a serial pass.
+template <typename SplitFn>
+void SplitBatchParallel(OpKernelContext* ctx, const Tensor& input_tensor,
+                        const SplitFn& split_fn,
+                        std::vector<SplitChunk>* chunks) {
+  const auto input_vec = input_tensor.vec<string>();
+  const int64 batch_size = input_vec.dimension(0);
+  mutex mu;
+  auto work = [&input_vec, &split_fn, chunks, &mu](int64 start, int64 end) {
+    SplitChunk chunk;
+    chunk.start = start;
+    chunk.num_tokens.reserve(end - start);
+    chunk.tokens.reserve((end - start) * kReserveSize);
+    for (int64 i = start; i < end; ++i) {
+      const size_t previous_size = chunk.tokens.size();
+      split_fn(input_vec(i), &chunk.tokens);
+      chunk.num_tokens.push_back(chunk.tokens.size() - previous_size);
+    }
+    mutex_lock l(mu);
+    chunks->push_back(std::move(chunk));
+  };
+  auto* worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+  // The scan cost is proportional to the number of input bytes; TotalBytes()
+  // accounts for the string payloads of a DT_STRING tensor.
+  const int64 cost_per_unit =
+      20 + (batch_size > 0 ? input_tensor.TotalBytes() / batch_size : 0);
+  Shard(worker_threads->num_threads, worker_threads->workers, batch_size,
+        cost_per_unit, work);
+  std::sort(chunks->begin(), chunks->end(),
+            [](const SplitChunk& a, const SplitChunk& b) {
+              return a.start < b.start;
+            });
 }
 
 }  // namespace
@@ -190,24 +243,30 @@ class StringSplitOp : public OpKernel {
     const auto delimiter_vec = delimiter_tensor->flat<string>();
     const string& delimiter = delimiter_vec(0);
     // Empty delimiter means split the input character by character.
-    std::vector<StringPiece> tokens;
-    // Guess that we'll be unpacking a handful of tokens per example.
-    static constexpr int kReserveSize = 4;
-    tokens.reserve(batch_size * kReserveSize);
+    std::vector<SplitChunk> chunks;
+    if (skip_empty_) {
+      SplitBatchParallel(
+          ctx, *input_tensor,
+          [&delimiter](const string& str, std::vector<StringPiece>* tokens) {
+            Split(str, delimiter, str_util::SkipEmpty(), tokens);
+          },
+          &chunks);
+    } else {
+      SplitBatchParallel(
+          ctx, *input_tensor,
+          [&delimiter](const string& str, std::vector<StringPiece>* tokens) {
+            Split(str, delimiter, str_util::AllowEmpty(), tokens);
+          },
+          &chunks);
+    }
 
     int64 output_size = 0;
     int64 max_num_entries = 0;
-    std::vector<int64> num_indices(batch_size);
-    for (int64 i = 0; i < batch_size; ++i) {
-      std::vector<StringPiece> parts =
-          skip_empty_ ? Split(input_vec(i), delimiter, str_util::SkipEmpty())
-                      : Split(input_vec(i), delimiter, str_util::AllowEmpty());
-      int64 n_entries = parts.size();
-      num_indices[i] = n_entries;
-      output_size += n_entries;
-      max_num_entries = std::max(max_num_entries, n_entries);
-      tokens.insert(tokens.end(), std::make_move_iterator(parts.begin()),
-                    std::make_move_iterator(parts.end()));
+    for (const SplitChunk& chunk : chunks) {
+      for (const int64 n_entries : chunk.num_tokens) {
+        output_size += n_entries;
+        max_num_entries = std::max(max_num_entries, n_entries);
+      }
     }
 
     Tensor* sp_indices_t;
@@ -225,12 +284,16 @@ class StringSplitOp : public OpKernel {
     sp_shape(0) = batch_size;
     sp_shape(1) = max_num_entries;
     size_t c = 0;
-    for (size_t i = 0; i < batch_size; ++i) {
-      for (size_t j = 0; j < num_indices[i]; ++j) {
-        sp_indices(c, 0) = i;
-        sp_indices(c, 1) = j;
-        sp_tokens(c).assign(tokens[c].data(), tokens[c].size());
-        ++c;
+    for (const SplitChunk& chunk : chunks) {
+      size_t t = 0;
+      for (size_t k = 0; k < chunk.num_tokens.size(); ++k) {
+        for (int64 j = 0; j < chunk.num_tokens[k]; ++j) {
+          sp_indices(c, 0) = chunk.start + k;
+          sp_indices(c, 1) = j;
+          sp_tokens(c).assign(chunk.tokens[t].data(), chunk.tokens[t].size());
+          ++c;
+          ++t;
+        }
       }
     }
   }
@@ -263,21 +326,22 @@ class StringSplitV2Op : public OpKernel {
                                         sep_tensor->shape().DebugString()));
     const auto sep_vec = sep_tensor->flat<string>();
     StringPiece sep(sep_vec(0));
-    std::vector<StringPiece> tokens;
-    // Guess that we'll be unpacking a handful of tokens per example.
-    static constexpr int kReserveSize = 4;
-    tokens.reserve(batch_size * kReserveSize);
+    std::vector<SplitChunk> chunks;
+    const int maxsplit = maxsplit_;
+    SplitBatchParallel(
+        ctx, *input_tensor,
+        [sep, maxsplit](const string& str, std::vector<StringPiece>* tokens) {
+          SplitV2(str, sep, maxsplit, tokens);
+        },
+        &chunks);
 
     int64 output_size = 0;
     int64 max_num_entries = 0;
-    std::vector<int64> num_indices(batch_size);
-    for (int64 i = 0; i < batch_size; ++i) {
-      std::vector<StringPiece> parts = SplitV2(input_vec(i), sep, maxsplit_);
-      int64 n_entries = parts.size();
-      num_indices[i] = n_entries;
-      output_size += n_entries;
-      max_num_entries = std::max(max_num_entries, n_entries);
-      tokens.insert(tokens.end(), parts.begin(), parts.end());
+    for (const SplitChunk& chunk : chunks) {
+      for (const int64 n_entries : chunk.num_tokens) {
+        output_size += n_entries;
+        max_num_entries = std::max(max_num_entries, n_entries);
+      }
     }
 
     Tensor* sp_indices_t;
@@ -295,12 +359,16 @@ class StringSplitV2Op : public OpKernel {
     sp_shape(0) = batch_size;
     sp_shape(1) = max_num_entries;
     size_t c = 0;
-    for (size_t i = 0; i < batch_size; ++i) {
-      for (size_t j = 0; j < num_indices[i]; ++j) {
-        sp_indices(c, 0) = i;
-        sp_indices(c, 1) = j;
-        sp_tokens(c).assign(tokens[c].data(), tokens[c].size());
-        ++c;
+    for (const SplitChunk& chunk : chunks) {
+      size_t t = 0;
+      for (size_t k = 0; k < chunk.num_tokens.size(); ++k) {
+        for (int64 j = 0; j < chunk.num_tokens[k]; ++j) {
+          sp_indices(c, 0) = chunk.start + k;
+          sp_indices(c, 1) = j;
+          sp_tokens(c).assign(chunk.tokens[t].data(), chunk.tokens[t].size());
+          ++c;
+          ++t;
+        }
       }
     }
   }
@@ -99,6 +99,67 @@ class TopK : public OpKernel {
 
 namespace functor {
 
+namespace {
+
+// Size of the strided sample used to estimate the k-th largest value of a
+// row, and the minimum row width for which the sampled-threshold selection
+// path is attempted. Below that width the heap is competitive and the
+// estimate would be drawn from too few values.
+constexpr int64 kTopKSampleSize = 1024;
+constexpr int64 kTopKSelectionMinCols = 4096;
+
+// Attempts to compute the top `k` indices of the row `input_data` without a
+// heap: estimate the k-th largest value from a strided sample, compact the
+// candidates that reach the estimate in one branch-light pass, and run exact
+// selection on the survivors only. Writes the result to `output_indices` and
+// returns true on success; returns false when the estimate was too
+// aggressive and fewer than `k` candidates survived, in which case the
+// caller must fall back to the full scan. `samples` and `survivors` are
+// scratch space reused across rows.
+template <typename T, typename Comparator>
+bool SelectTopKFromSample(const T* input_data, const int64 num_cols,
+                          const int k, const bool sorted,
+                          const Comparator& stable_comp,
+                          std::vector<T>* samples,
+                          std::vector<int32>* survivors,
+                          int32* output_indices) {
+  samples->clear();
+  const int64 stride = num_cols / kTopKSampleSize;
+  for (int64 c = 0; c < num_cols; c += stride) {
+    samples->push_back(input_data[c]);
+  }
+  // Aim the threshold at global rank ~2k, so that a sample that happens to
+  // over-represent large values still leaves at least k survivors.
+  const int64 num_samples = samples->size();
+  const int64 sample_rank =
+      std::min(num_samples - 1,
+               std::max(int64{0}, int64{2} * k * num_samples / num_cols));
+  std::nth_element(samples->begin(), samples->begin() + sample_rank,
+                   samples->end(),
+                   [](const T& a, const T& b) { return b < a; });
+  const T threshold = (*samples)[sample_rank];
+  survivors->clear();
+  for (int64 c = 0; c < num_cols; ++c) {
+    if (!(input_data[c] < threshold)) {
+      survivors->push_back(c);
+    }
+  }
+  if (survivors->size() < static_cast<size_t>(k)) {
+    return false;
+  }
+  // `stable_comp` is a strict total order (ties broken by index), so exact
+  // selection over the survivors yields the same top-k set as the heap.
+  std::nth_element(survivors->begin(), survivors->begin() + k - 1,
+                   survivors->end(), stable_comp);
+  if (sorted) {
+    std::sort(survivors->begin(), survivors->begin() + k, stable_comp);
+  }
+  std::copy(survivors->begin(), survivors->begin() + k, output_indices);
+  return true;
+}
+
+}  // namespace
+
 template <typename T>
 struct TopKFunctor<CPUDevice, T> {
   static EIGEN_ALWAYS_INLINE Status
@@ -134,7 +195,17 @@ struct TopKFunctor<CPUDevice, T> {
       return Status::OK();
     }
 
+    // For wide rows where only a small fraction of candidates is kept
+    // (retrieval-style workloads), per-element heap maintenance is branchy
+    // and cache-hostile; prefer the sampled-threshold selection path.
+    const bool use_selection = k < num_cols &&
+                               num_cols >= kTopKSelectionMinCols &&
+                               k <= num_cols / 8;
+
     auto SortIndices = [&](int start_batch, int limit_batch) {
+      // Scratch reused across the rows of this shard by the selection path.
+      std::vector<T> samples;
+      std::vector<int32> survivors;
       for (int32 b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
         const auto stable_comp = [input_data](const int32 a, const int32 b) {
@@ -176,6 +247,12 @@ struct TopKFunctor<CPUDevice, T> {
             }
             run_begin = run_end;
           }
+        } else if (use_selection &&
+                   SelectTopKFromSample(input_data, num_cols, k, sorted,
+                                        stable_comp, &samples, &survivors,
+                                        &indices(b, 0))) {
+          // Top-k indices were written by the selection path; fall through
+          // to the value copy below.
         } else {
           // Use the TopN heap object to sort.
           gtl::TopN<int32, decltype(stable_comp)> filter(k, stable_comp);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <functional>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 
@@ -24,11 +25,201 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 
+namespace {
+
+// Minimum number of elements per shard before UniqueOp runs its hash passes
+// in parallel; below this the serial map is competitive.
+constexpr int64 kUniqueShardMinElements = 1 << 16;
+
+// Open-addressing hash table that maps the value at an input position to the
+// position of that value's first occurrence in the probed range. Slots hold
+// positions only, so the table is one flat array of int32. Capacity is a
+// power of two of at least twice the hint, which keeps the load factor low
+// enough that the doubling fallback is rarely taken.
+template <typename T>
+class FlatPositionTable {
+ public:
+  static constexpr int32 kEmpty = -1;
+
+  FlatPositionTable(const T* data, int64 capacity_hint) : data_(data) {
+    int64 capacity = 64;
+    while (capacity < 2 * capacity_hint) {
+      capacity <<= 1;
+    }
+    slots_.assign(capacity, int32{kEmpty});
+    mask_ = capacity - 1;
+  }
+
+  // Returns the slot holding the first occurrence of data[pos], claiming a
+  // slot for pos if the value has not been seen before. Note that slot
+  // numbers are invalidated if a later insertion grows the table; callers
+  // that need stable handles must record positions, not slots.
+  int64 InsertOrFind(int64 pos, bool* inserted) {
+    if (8 * (size_ + 1) > 7 * (mask_ + 1)) {
+      Grow();
+    }
+    const int64 slot = FindSlot(data_[pos]);
+    if (slots_[slot] == kEmpty) {
+      slots_[slot] = static_cast<int32>(pos);
+      ++size_;
+      *inserted = true;
+    } else {
+      *inserted = false;
+    }
+    return slot;
+  }
+
+  // Returns the slot holding `value`, or the empty slot where it would be
+  // inserted.
+  int64 FindSlot(const T& value) const {
+    int64 slot = static_cast<int64>(
+                     Hash64Combine(hash<T>{}(value), 0x9e3779b97f4a7c15ULL)) &
+                 mask_;
+    while (slots_[slot] != kEmpty && !(data_[slots_[slot]] == value)) {
+      slot = (slot + 1) & mask_;
+    }
+    return slot;
+  }
+
+  int64 capacity() const { return mask_ + 1; }
+  int64 size() const { return size_; }
+
+ private:
+  void Grow() {
+    std::vector<int32> old_slots = std::move(slots_);
+    slots_.assign(2 * old_slots.size(), int32{kEmpty});
+    mask_ = static_cast<int64>(slots_.size()) - 1;
+    for (const int32 pos : old_slots) {
+      if (pos != kEmpty) {
+        slots_[FindSlot(data_[pos])] = pos;
+      }
+    }
+  }
+
+  const T* data_;      // Not owned.
+  std::vector<int32> slots_;
+  int64 mask_;
+  int64 size_ = 0;
+};
+
+// Parallel unique pass over a flat scalar input. Contiguous shards each
+// build a private pre-sized flat table, the shard results are merged in
+// shard order - shards cover increasing position ranges, so this preserves
+// first-occurrence output order - and a second parallel pass resolves every
+// element against the merged assignment. Fills `idx_vec`, appends the unique
+// values to `uniques` in first-occurrence order, and returns their number.
+template <typename T, typename TIndex>
+int64 ParallelUnique(OpKernelContext* context, const T* data, const int64 n,
+                     typename TTypes<TIndex>::Vec idx_vec,
+                     std::vector<T>* uniques) {
+  auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+
+  // Estimate the cardinality from a strided sample so that inputs with few
+  // distinct values (the common recommendation-ids case) get small,
+  // cache-resident shard tables instead of tables sized for the worst case.
+  constexpr int64 kSampleSize = 1024;
+  const int64 stride = std::max<int64>(1, n / kSampleSize);
+  FlatPositionTable<T> sample_table(data, kSampleSize);
+  int64 num_samples = 0;
+  int64 distinct_samples = 0;
+  for (int64 i = 0; i < n; i += stride) {
+    bool inserted;
+    sample_table.InsertOrFind(i, &inserted);
+    ++num_samples;
+    if (inserted) {
+      ++distinct_samples;
+    }
+  }
+  const int64 estimated_cardinality =
+      distinct_samples == num_samples
+          ? n
+          : std::max<int64>(256, 2 * n * distinct_samples / num_samples);
+
+  const int64 num_shards = std::max<int64>(
+      1, std::min<int64>(worker_threads.num_threads,
+                         n / kUniqueShardMinElements));
+  const int64 shard_size = (n + num_shards - 1) / num_shards;
+
+  struct UniqueShard {
+    int64 begin;
+    int64 end;
+    std::unique_ptr<FlatPositionTable<T>> table;
+    // Positions of the shard's first occurrences, in scan order.
+    std::vector<int32> first_positions;
+    // Final slot number -> global unique id, filled during the merge.
+    std::vector<TIndex> global_by_slot;
+  };
+  std::vector<UniqueShard> shards(num_shards);
+
+  auto build_tables = [&](int64 first_shard, int64 last_shard) {
+    for (int64 s = first_shard; s < last_shard; ++s) {
+      UniqueShard& shard = shards[s];
+      shard.begin = s * shard_size;
+      shard.end = std::min(n, shard.begin + shard_size);
+      const int64 hint =
+          std::min(shard.end - shard.begin, estimated_cardinality);
+      shard.table.reset(new FlatPositionTable<T>(data, hint));
+      for (int64 i = shard.begin; i < shard.end; ++i) {
+        bool inserted;
+        shard.table->InsertOrFind(i, &inserted);
+        if (inserted) {
+          shard.first_positions.push_back(static_cast<int32>(i));
+        }
+      }
+    }
+  };
+  // ~25ns per element covers the hash-and-probe of one insert; the per-shard
+  // cost is high enough that every shard lands on its own thread.
+  Shard(worker_threads.num_threads, worker_threads.workers, num_shards,
+        shard_size * 25, build_tables);
+
+  int64 total_first_positions = 0;
+  for (const UniqueShard& shard : shards) {
+    total_first_positions += shard.first_positions.size();
+  }
+
+  // Serial merge in shard order. The global table is sized from the actual
+  // number of shard-local firsts, so it never rehashes and its slot numbers
+  // stay valid for the id map below.
+  FlatPositionTable<T> global_table(data, total_first_positions);
+  std::vector<TIndex> global_ids(global_table.capacity());
+  TIndex next_id = 0;
+  for (UniqueShard& shard : shards) {
+    shard.global_by_slot.resize(shard.table->capacity());
+    for (const int32 pos : shard.first_positions) {
+      bool inserted;
+      const int64 global_slot = global_table.InsertOrFind(pos, &inserted);
+      if (inserted) {
+        global_ids[global_slot] = next_id++;
+        uniques->push_back(data[pos]);
+      }
+      shard.global_by_slot[shard.table->FindSlot(data[pos])] =
+          global_ids[global_slot];
+    }
+  }
+
+  auto resolve_ids = [&](int64 first_shard, int64 last_shard) {
+    for (int64 s = first_shard; s < last_shard; ++s) {
+      const UniqueShard& shard = shards[s];
+      for (int64 i = shard.begin; i < shard.end; ++i) {
+        idx_vec(i) = shard.global_by_slot[shard.table->FindSlot(data[i])];
+      }
+    }
+  };
+  Shard(worker_threads.num_threads, worker_threads.workers, num_shards,
+        shard_size * 25, resolve_ids);
+
+  return next_id;
+}
+
+}  // namespace
+
 template <typename T, typename TIndex>
 class UniqueOp : public OpKernel {
  public:
@@ -106,26 +297,42 @@ class UniqueOp : public OpKernel {
       auto Tin = input.flat<T>();
       const int64 N = static_cast<int64>(Tin.size());
 
-      std::unordered_map<T, TIndex> uniq;
-      uniq.reserve(2 * N);
-      for (Eigen::Index i = 0, j = 0; i < N; ++i) {
-        auto it = uniq.insert(std::make_pair(Tin(i), j));
-        idx_vec(i) = it.first->second;
-        if (it.second) {
-          ++j;
+      auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+      if (N >= 2 * kUniqueShardMinElements && worker_threads->num_threads > 1) {
+        std::vector<T> uniques;
+        uniq_size = ParallelUnique<T, TIndex>(context, Tin.data(), N, idx_vec,
+                                              &uniques);
+        TensorShape output_shape(input.shape());
+        output_shape.set_dim(axis, uniq_size);
+        Tensor* output = nullptr;
+        OP_REQUIRES_OK(context,
+                       context->allocate_output(0, output_shape, &output));
+        auto Tout = output->flat<T>();
+        for (int64 i = 0; i < uniq_size; ++i) {
+          Tout(i) = std::move(uniques[i]);
+        }
+      } else {
+        std::unordered_map<T, TIndex> uniq;
+        uniq.reserve(2 * N);
+        for (Eigen::Index i = 0, j = 0; i < N; ++i) {
+          auto it = uniq.insert(std::make_pair(Tin(i), j));
+          idx_vec(i) = it.first->second;
+          if (it.second) {
+            ++j;
+          }
         }
-      }
 
-      uniq_size = static_cast<int64>(uniq.size());
-      TensorShape output_shape(input.shape());
-      output_shape.set_dim(axis, uniq_size);
-      Tensor* output = nullptr;
-      OP_REQUIRES_OK(context,
-                     context->allocate_output(0, output_shape, &output));
-      auto Tout = output->flat<T>();
+        uniq_size = static_cast<int64>(uniq.size());
+        TensorShape output_shape(input.shape());
+        output_shape.set_dim(axis, uniq_size);
+        Tensor* output = nullptr;
+        OP_REQUIRES_OK(context,
+                       context->allocate_output(0, output_shape, &output));
+        auto Tout = output->flat<T>();
 
-      for (auto it : uniq) {
-        Tout(it.second) = it.first;
+        for (auto it : uniq) {
+          Tout(it.second) = it.first;
+        }
       }
     } else {
       // General implementation when unique is run over multiple elements.
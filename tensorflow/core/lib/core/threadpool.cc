@@ -103,7 +103,123 @@ struct ThreadPool::Impl : Eigen::ThreadPoolTempl<EigenEnvironment> {
         [&fn](Eigen::Index first, Eigen::Index last) { fn(first, last); });
   }
 
+  // A scheduling domain: a named contiguous thread range plus counters.
+  // Counters are atomics since tasks complete on arbitrary threads;
+  // the struct is heap-allocated so that task closures can hold a stable
+  // pointer while domains_ grows.
+  struct Domain {
+    Domain(string n, int s, int l) : name(std::move(n)), start(s), limit(l) {}
+    const string name;
+    const int start;  // First thread in the domain.
+    const int limit;  // One past the last thread in the domain.
+    std::atomic<int64> scheduled{0};
+    std::atomic<int64> completed{0};
+    std::atomic<int64> foreign_executions{0};
+  };
+
+  int AddDomain(const string& name, int start_thread, int num_threads) {
+    CHECK_GE(start_thread, 0);
+    CHECK_GT(num_threads, 0);
+    CHECK_LE(start_thread + num_threads, NumThreads());
+    mutex_lock l(domains_mu_);
+    for (const auto& d : domains_) {
+      CHECK(start_thread >= d->limit || start_thread + num_threads <= d->start)
+          << "Scheduling domain \"" << name << "\" overlaps \"" << d->name
+          << "\"";
+    }
+    domains_.push_back(std::unique_ptr<Domain>(
+        new Domain(name, start_thread, start_thread + num_threads)));
+    // Restrict each domain thread's steal partition to its own domain;
+    // uncovered threads keep the whole pool. Idle threads still pick up
+    // other domains' work via the global steal pass before blocking.
+    std::vector<std::pair<unsigned, unsigned>> partitions(
+        NumThreads(), {0, static_cast<unsigned>(NumThreads())});
+    for (const auto& d : domains_) {
+      for (int t = d->start; t < d->limit; ++t) {
+        partitions[t] = {static_cast<unsigned>(d->start),
+                         static_cast<unsigned>(d->limit)};
+      }
+    }
+    SetStealPartitions(partitions);
+    return domains_.size() - 1;
+  }
+
+  Domain* domain(int index) const {
+    mutex_lock l(domains_mu_);
+    CHECK_GE(index, 0);
+    CHECK_LT(index, static_cast<int>(domains_.size()));
+    return domains_[index].get();
+  }
+
+  void ScheduleInDomain(int index, std::function<void()> fn) {
+    Domain* d = domain(index);
+    d->scheduled.fetch_add(1, std::memory_order_relaxed);
+    ScheduleWithHint(
+        [this, d, fn = std::move(fn)]() {
+          const int tid = CurrentThreadId();
+          if (tid < d->start || tid >= d->limit) {
+            d->foreign_executions.fetch_add(1, std::memory_order_relaxed);
+          }
+          fn();
+          d->completed.fetch_add(1, std::memory_order_relaxed);
+        },
+        d->start, d->limit);
+  }
+
+  // Presents a domain's thread range as a pool of its own, so that Eigen's
+  // parallelFor shards for the domain size and queues every shard inside
+  // the domain.
+  class DomainProxy : public Eigen::ThreadPoolInterface {
+   public:
+    DomainProxy(Impl* pool, int index, Domain* d)
+        : pool_(pool), index_(index), domain_(d) {}
+
+    void Schedule(std::function<void()> fn) override {
+      pool_->ScheduleInDomain(index_, std::move(fn));
+    }
+
+    void ScheduleWithHint(std::function<void()> fn, int, int) override {
+      pool_->ScheduleInDomain(index_, std::move(fn));
+    }
+
+    void Cancel() override { pool_->Cancel(); }
+
+    int NumThreads() const override { return domain_->limit - domain_->start; }
+
+    int CurrentThreadId() const override { return pool_->CurrentThreadId(); }
+
+   private:
+    Impl* const pool_;
+    const int index_;
+    Domain* const domain_;
+  };
+
+  void ParallelForInDomain(int index, int64 total, int64 cost_per_unit,
+                           std::function<void(int64, int64)> fn) {
+    CHECK_GE(total, 0);
+    CHECK_EQ(total, (int64)(Eigen::Index)total);
+    Domain* d = domain(index);
+    DomainProxy proxy(this, index, d);
+    Eigen::ThreadPoolDevice device(&proxy, proxy.NumThreads(), allocator_);
+    device.parallelFor(
+        total, Eigen::TensorOpCost(0, 0, cost_per_unit),
+        [&fn](Eigen::Index first, Eigen::Index last) { fn(first, last); });
+  }
+
+  ThreadPool::SchedulingDomainStats GetDomainStats(int index) const {
+    Domain* d = domain(index);
+    ThreadPool::SchedulingDomainStats stats;
+    stats.scheduled = d->scheduled.load(std::memory_order_relaxed);
+    stats.pending =
+        stats.scheduled - d->completed.load(std::memory_order_relaxed);
+    stats.foreign_executions =
+        d->foreign_executions.load(std::memory_order_relaxed);
+    return stats;
+  }
+
   Eigen::Allocator* allocator_;
+  mutable mutex domains_mu_;
+  std::vector<std::unique_ptr<Domain>> domains_ GUARDED_BY(domains_mu_);
 };
 
 ThreadPool::ThreadPool(Env* env, const string& name, int num_threads)
@@ -204,6 +320,27 @@ void ThreadPool::ScheduleWithHint(std::function<void()> fn, int start,
   impl_->ScheduleWithHint(std::move(fn), start, limit);
 }
 
+int ThreadPool::AddSchedulingDomain(const string& name, int start_thread,
+                                    int num_threads) {
+  return impl_->AddDomain(name, start_thread, num_threads);
+}
+
+void ThreadPool::ScheduleInDomain(int domain, std::function<void()> fn) {
+  CHECK(fn != nullptr);
+  impl_->ScheduleInDomain(domain, std::move(fn));
+}
+
+void ThreadPool::ParallelForInDomain(int domain, int64 total,
+                                     int64 cost_per_unit,
+                                     std::function<void(int64, int64)> fn) {
+  impl_->ParallelForInDomain(domain, total, cost_per_unit, std::move(fn));
+}
+
+ThreadPool::SchedulingDomainStats ThreadPool::GetSchedulingDomainStats(
+    int domain) const {
+  return impl_->GetDomainStats(domain);
+}
+
 void ThreadPool::SetStealPartitions(
     const std::vector<std::pair<unsigned, unsigned>>& partitions) {
   impl_->SetStealPartitions(partitions);
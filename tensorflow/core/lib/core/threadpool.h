@@ -115,6 +115,46 @@ class ThreadPool {
       int64 total, int64 cost_per_unit,
       const std::function<void(int64, int64, int)>& fn);
 
+  // Scheduling domains --------------------------------------------------
+  //
+  // A scheduling domain names a contiguous range of threads in the pool.
+  // Tasks scheduled into a domain are queued on that range, and the pool's
+  // steal partitions are configured so that each thread steals within its
+  // own domain first and only picks up another domain's work in the
+  // idle-time global-steal pass before blocking. This keeps co-located
+  // workloads sharing one pool (e.g. an input pipeline and a model
+  // executor) from trashing each other's caches.
+
+  // Counters accumulated for one scheduling domain.
+  struct SchedulingDomainStats {
+    // Tasks ever scheduled into the domain.
+    int64 scheduled = 0;
+    // Tasks scheduled but not yet finished (queue depth plus running).
+    int64 pending = 0;
+    // Tasks executed by a thread outside the domain's range, i.e. picked
+    // up by idle-time stealing from another domain.
+    int64 foreign_executions = 0;
+  };
+
+  // Defines a domain covering threads [start_thread, start_thread +
+  // num_threads) and returns its domain id. Domains may not overlap.
+  // Threads not covered by any domain keep the whole pool as their steal
+  // partition.
+  // REQUIRES: 0 <= start_thread, num_threads > 0,
+  //           start_thread + num_threads <= NumThreads().
+  int AddSchedulingDomain(const string& name, int start_thread,
+                          int num_threads);
+
+  // Schedules fn() for execution on the given domain's threads.
+  void ScheduleInDomain(int domain, std::function<void()> fn);
+
+  // As ParallelFor, but shards the work across the domain's threads only.
+  void ParallelForInDomain(int domain, int64 total, int64 cost_per_unit,
+                           std::function<void(int64, int64)> fn);
+
+  // Returns a snapshot of the given domain's counters.
+  SchedulingDomainStats GetSchedulingDomainStats(int domain) const;
+
   // Returns the number of threads in the pool.
   int NumThreads() const;
 
@@ -190,6 +190,68 @@ TEST(ThreadPool, ParallelForWithWorkerId) {
   }
 }
 
+TEST(ThreadPool, SchedulingDomains) {
+  ThreadPool pool(Env::Default(), "test", 4);
+  const int input = pool.AddSchedulingDomain("input", 0, 2);
+  const int compute = pool.AddSchedulingDomain("compute", 2, 2);
+
+  const int kWorkItems = 32;
+  std::atomic<bool> work[kWorkItems];
+  for (int i = 0; i < kWorkItems; i++) {
+    work[i] = false;
+  }
+  mutex mu;
+  condition_variable done;
+  int remaining = kWorkItems;
+  for (int i = 0; i < kWorkItems; i++) {
+    const int domain = (i % 2 == 0) ? input : compute;
+    pool.ScheduleInDomain(domain, [&, i]() {
+      ASSERT_FALSE(work[i].exchange(true));
+      mutex_lock l(mu);
+      if (--remaining == 0) done.notify_all();
+    });
+  }
+  {
+    mutex_lock l(mu);
+    while (remaining > 0) done.wait(l);
+  }
+  for (int i = 0; i < kWorkItems; i++) {
+    ASSERT_TRUE(work[i]);
+  }
+  ThreadPool::SchedulingDomainStats stats =
+      pool.GetSchedulingDomainStats(input);
+  EXPECT_EQ(kWorkItems / 2, stats.scheduled);
+  EXPECT_EQ(0, stats.pending);
+  stats = pool.GetSchedulingDomainStats(compute);
+  EXPECT_EQ(kWorkItems / 2, stats.scheduled);
+  EXPECT_EQ(0, stats.pending);
+}
+
+TEST(ThreadPool, ParallelForInDomain) {
+  ThreadPool pool(Env::Default(), "test", 4);
+  const int compute = pool.AddSchedulingDomain("compute", 2, 2);
+
+  // Make ParallelForInDomain use as many domain threads as possible.
+  const int64 kHugeCost = 1 << 30;
+  const int kWorkItems = 15;
+  std::atomic<bool> work[kWorkItems];
+  for (int i = 0; i < kWorkItems; i++) {
+    work[i] = false;
+  }
+  pool.ParallelForInDomain(compute, kWorkItems, kHugeCost,
+                           [&work](int64 begin, int64 end) {
+                             for (int64 i = begin; i < end; ++i) {
+                               ASSERT_FALSE(work[i].exchange(true));
+                             }
+                           });
+  for (int i = 0; i < kWorkItems; i++) {
+    ASSERT_TRUE(work[i]);
+  }
+  const ThreadPool::SchedulingDomainStats stats =
+      pool.GetSchedulingDomainStats(compute);
+  EXPECT_EQ(0, stats.pending);
+}
+
 static void BM_Sequential(int iters) {
   ThreadPool pool(Env::Default(), "test", kNumThreads);
   // Decrement count sequentially until 0.
@@ -19,6 +19,8 @@ limitations under the License.
 #include "tensorflow/core/lib/hash/crc32c.h"
 
 #include <stdint.h>
+#include <string.h>
+
 #include "tensorflow/core/lib/core/coding.h"
 
 namespace tensorflow {
@@ -263,6 +265,99 @@ uint32 Extend(uint32 crc, const char *buf, size_t size) {
   return l ^ 0xffffffffu;
 }
 
+namespace {
+
+// Shifting a CRC over a run of zero bytes is a linear map over GF(2), so
+// it can be represented as a 32x32 bit matrix (one column per input bit)
+// and an arbitrary shift built by repeated squaring. This mirrors zlib's
+// crc32_combine(), with the Castagnoli polynomial substituted.
+
+// Multiplies vector `vec` by matrix `mat`.
+uint32 MatrixTimes(const uint32 *mat, uint32 vec) {
+  uint32 sum = 0;
+  for (int i = 0; i < 32; i++) {
+    sum ^= mat[i] & (0u - ((vec >> i) & 1));
+  }
+  return sum;
+}
+
+// square = mat * mat.
+void MatrixSquare(uint32 *square, const uint32 *mat) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = MatrixTimes(mat, mat[n]);
+  }
+}
+
+// Fills `odd` with the operator that advances a CRC register over four
+// zero bits, the starting point for the squaring ladders below.
+void BuildFourZeroBitOperator(uint32 *odd) {
+  uint32 even[32];
+  odd[0] = 0x82f63b78u;  // CRC32C polynomial, reflected
+  uint32 row = 1;
+  for (int n = 1; n < 32; n++) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  MatrixSquare(even, odd);  // Two zero bits.
+  MatrixSquare(odd, even);  // Four zero bits.
+}
+
+}  // namespace
+
+uint32 Combine(uint32 crc_a, uint32 crc_b, size_t size_b) {
+  if (size_b == 0) return crc_a;
+  uint32 odd[32];
+  uint32 even[32];
+  BuildFourZeroBitOperator(odd);
+  // Advance crc_a over size_b zero bytes: apply the 8-bit, 16-bit, ...
+  // operator for each set bit of size_b, ping-ponging between the two
+  // matrices while squaring.
+  do {
+    MatrixSquare(even, odd);
+    if (size_b & 1) crc_a = MatrixTimes(even, crc_a);
+    size_b >>= 1;
+    if (size_b == 0) break;
+    MatrixSquare(odd, even);
+    if (size_b & 1) crc_a = MatrixTimes(odd, crc_a);
+    size_b >>= 1;
+  } while (size_b != 0);
+  return crc_a ^ crc_b;
+}
+
+// The two entry points below are used by crc32c_accelerate.cc (which
+// declares them extern, as this file does for the accelerated routines) to
+// merge interleaved hardware CRC streams.
+
+// Fills `mat` with the operator advancing a raw (un-inverted) CRC register
+// over num_bytes zero bytes.
+void BuildZeroByteOperator(size_t num_bytes, uint32 *mat) {
+  uint32 odd[32];
+  uint32 even[32];
+  uint32 tmp[32];
+  BuildFourZeroBitOperator(odd);
+  for (int n = 0; n < 32; n++) mat[n] = 1u << n;  // Identity.
+  do {
+    MatrixSquare(even, odd);
+    if (num_bytes & 1) {
+      for (int n = 0; n < 32; n++) tmp[n] = MatrixTimes(even, mat[n]);
+      memcpy(mat, tmp, sizeof(tmp));
+    }
+    num_bytes >>= 1;
+    if (num_bytes == 0) break;
+    MatrixSquare(odd, even);
+    if (num_bytes & 1) {
+      for (int n = 0; n < 32; n++) tmp[n] = MatrixTimes(odd, mat[n]);
+      memcpy(mat, tmp, sizeof(tmp));
+    }
+    num_bytes >>= 1;
+  } while (num_bytes != 0);
+}
+
+// Applies an operator built by BuildZeroByteOperator.
+uint32 ApplyZeroByteOperator(const uint32 *mat, uint32 value) {
+  return MatrixTimes(mat, value);
+}
+
 #if defined(PLATFORM_GOOGLE)
 uint32 Extend(uint32 crc, const absl::Cord &cord) {
   absl::CordReader reader(cord);
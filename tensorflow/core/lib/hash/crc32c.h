@@ -35,6 +35,12 @@ extern uint32 Extend(uint32 init_crc, const char* data, size_t n);
 // Return the crc32c of data[0,n-1]
 inline uint32 Value(const char* data, size_t n) { return Extend(0, data, n); }
 
+// Given crc_a = crc32c(A), crc_b = crc32c(B) and size_b = B's length,
+// return the crc32c of concat(A, B) without touching the data again.
+// This lets callers checksum chunks of a stream on separate threads and
+// merge the per-chunk results in order.
+extern uint32 Combine(uint32 crc_a, uint32 crc_b, size_t size_b);
+
 #if defined(PLATFORM_GOOGLE)
 extern uint32 Extend(uint32 init_crc, const absl::Cord& cord);
 inline uint32 Value(const absl::Cord& cord) { return Extend(0, cord); }
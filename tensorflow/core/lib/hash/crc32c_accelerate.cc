@@ -16,7 +16,7 @@ limitations under the License.
 #include <stddef.h>
 #include <stdint.h>
 
-// SSE4.2 accelerated CRC32c.
+// SSE4.2 / ARMv8 accelerated CRC32c.
 
 // See if the SSE4.2 crc32c instruction is available.
 #undef USE_SSE_CRC32C
@@ -37,14 +37,57 @@ limitations under the License.
 #undef USE_SSE_CRC32C
 #endif
 
+// See if the ARMv8 CRC32 extension instructions are available.
+#undef USE_ARM_CRC32C
+#if !defined(USE_SSE_CRC32C) && defined(__aarch64__) && \
+    defined(__ARM_FEATURE_CRC32)
+#define USE_ARM_CRC32C 1
+#endif
+
 #ifdef USE_SSE_CRC32C
 #include <nmmintrin.h>
 #endif
 
+#ifdef USE_ARM_CRC32C
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
 namespace tensorflow {
 namespace crc32c {
 
-#ifndef USE_SSE_CRC32C
+// Implemented in crc32c.cc; used to merge interleaved CRC streams.
+extern void BuildZeroByteOperator(size_t num_bytes, uint32_t *mat);
+extern uint32_t ApplyZeroByteOperator(const uint32_t *mat, uint32_t value);
+
+#if defined(USE_SSE_CRC32C) || defined(USE_ARM_CRC32C)
+
+namespace {
+
+// The hardware CRC instructions have multi-cycle latency but single-cycle
+// throughput, so large buffers are processed as three independent streams
+// of kBlockSize bytes per round, merged afterwards: the CRC register
+// recurrence is affine, so a stream seeded with zero folds in by shifting
+// the preceding stream's register over kBlockSize zero bytes (a
+// precomputed 32x32 GF(2) operator) and xoring.
+constexpr int kBlockSize = 4096;
+
+const uint32_t *BlockOperator() {
+  static const uint32_t *mat = [] {
+    uint32_t *result = new uint32_t[32];
+    BuildZeroByteOperator(kBlockSize, result);
+    return result;
+  }();
+  return mat;
+}
+
+}  // namespace
+
+#endif  // USE_SSE_CRC32C || USE_ARM_CRC32C
+
+#if !defined(USE_SSE_CRC32C) && !defined(USE_ARM_CRC32C)
 
 bool CanAccelerate() { return false; }
 uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
@@ -52,7 +95,7 @@ uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
   return 0;
 }
 
-#else
+#elif defined(USE_SSE_CRC32C)
 
 // SSE4.2 optimized crc32c computation.
 bool CanAccelerate() { return __builtin_cpu_supports("sse4.2"); }
@@ -75,8 +118,32 @@ uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
     }
   }
 
-  // Process bytes 16 at a time
   uint64_t l64 = l;
+
+  // Process large buffers as three interleaved streams.
+  if (e - p >= 3 * kBlockSize) {
+    const uint32_t *block_operator = BlockOperator();
+    while (e - p >= 3 * kBlockSize) {
+      uint64_t c0 = l64;
+      uint64_t c1 = 0;
+      uint64_t c2 = 0;
+      for (int i = 0; i < kBlockSize; i += 8) {
+        c0 = _mm_crc32_u64(c0, *reinterpret_cast<const uint64_t *>(p + i));
+        c1 = _mm_crc32_u64(
+            c1, *reinterpret_cast<const uint64_t *>(p + kBlockSize + i));
+        c2 = _mm_crc32_u64(
+            c2, *reinterpret_cast<const uint64_t *>(p + 2 * kBlockSize + i));
+      }
+      const uint32_t m01 =
+          ApplyZeroByteOperator(block_operator, static_cast<uint32_t>(c0)) ^
+          static_cast<uint32_t>(c1);
+      l64 = ApplyZeroByteOperator(block_operator, m01) ^
+            static_cast<uint32_t>(c2);
+      p += 3 * kBlockSize;
+    }
+  }
+
+  // Process bytes 16 at a time
   while ((e - p) >= 16) {
     l64 = _mm_crc32_u64(l64, *reinterpret_cast<const uint64_t *>(p));
     l64 = _mm_crc32_u64(l64, *reinterpret_cast<const uint64_t *>(p + 8));
@@ -93,6 +160,75 @@ uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
   return l ^ 0xffffffffu;
 }
 
+#else  // USE_ARM_CRC32C
+
+// ARMv8 CRC32 extension optimized crc32c computation.
+bool CanAccelerate() {
+#if defined(__linux__) && defined(HWCAP_CRC32)
+  return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+  // The compiler was told the target implements the CRC32 extension
+  // (__ARM_FEATURE_CRC32), so trust it when no runtime probe is available.
+  return true;
+#endif
+}
+
+uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(buf);
+  const uint8_t *e = p + size;
+  uint32_t l = crc ^ 0xffffffffu;
+
+  // Advance p until aligned to 8-bytes..
+  // Point x at first 7-byte aligned byte in string.  This might be
+  // just past the end of the string.
+  const uintptr_t pval = reinterpret_cast<uintptr_t>(p);
+  const uint8_t *x = reinterpret_cast<const uint8_t *>(((pval + 7) >> 3) << 3);
+  if (x <= e) {
+    // Process bytes until finished or p is 8-byte aligned
+    while (p != x) {
+      l = __crc32cb(l, *p);
+      p++;
+    }
+  }
+
+  // Process large buffers as three interleaved streams.
+  if (e - p >= 3 * kBlockSize) {
+    const uint32_t *block_operator = BlockOperator();
+    while (e - p >= 3 * kBlockSize) {
+      uint32_t c0 = l;
+      uint32_t c1 = 0;
+      uint32_t c2 = 0;
+      for (int i = 0; i < kBlockSize; i += 8) {
+        c0 = __crc32cd(c0, *reinterpret_cast<const uint64_t *>(p + i));
+        c1 = __crc32cd(
+            c1, *reinterpret_cast<const uint64_t *>(p + kBlockSize + i));
+        c2 = __crc32cd(
+            c2, *reinterpret_cast<const uint64_t *>(p + 2 * kBlockSize + i));
+      }
+      l = ApplyZeroByteOperator(block_operator,
+                                ApplyZeroByteOperator(block_operator, c0) ^
+                                    c1) ^
+          c2;
+      p += 3 * kBlockSize;
+    }
+  }
+
+  // Process bytes 16 at a time
+  while ((e - p) >= 16) {
+    l = __crc32cd(l, *reinterpret_cast<const uint64_t *>(p));
+    l = __crc32cd(l, *reinterpret_cast<const uint64_t *>(p + 8));
+    p += 16;
+  }
+
+  // Process remaining bytes one at a time.
+  while (p < e) {
+    l = __crc32cb(l, *p);
+    p++;
+  }
+
+  return l ^ 0xffffffffu;
+}
+
 #endif
 
 }  // namespace crc32c
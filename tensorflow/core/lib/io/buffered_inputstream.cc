@@ -123,6 +123,40 @@ Status BufferedInputStream::ReadNBytes(int64 bytes_to_read, string* result) {
   return s;
 }
 
+Status BufferedInputStream::ReadSlice(int64 bytes_to_read, StringPiece* result,
+                                      string* scratch) {
+  if (bytes_to_read < 0) {
+    return errors::InvalidArgument("Can't read a negative number of bytes: ",
+                                   bytes_to_read);
+  }
+  *result = StringPiece();
+  if (!file_status_.ok() && bytes_to_read > 0) {
+    return file_status_;
+  }
+  if (bytes_to_read > 0 && pos_ == limit_ &&
+      static_cast<size_t>(bytes_to_read) <= size_) {
+    // The buffer is exhausted but the request would fit in it; refill so that
+    // the read below can be served without a copy.
+    Status s = FillBuffer();
+    if (limit_ == 0) {
+      DCHECK(!s.ok());
+      file_status_ = s;
+      return s;
+    }
+  }
+  if (static_cast<size_t>(bytes_to_read) <= limit_ - pos_) {
+    // Fast path: point the caller directly at the buffered data.
+    *result = StringPiece(buf_.data() + pos_, bytes_to_read);
+    pos_ += bytes_to_read;
+    return Status::OK();
+  }
+  // Slow path: the requested range straddles the end of the buffer (or is
+  // larger than the buffer), so assemble it in *scratch.
+  Status s = ReadNBytes(bytes_to_read, scratch);
+  *result = StringPiece(*scratch);
+  return s;
+}
+
 Status BufferedInputStream::SkipNBytes(int64 bytes_to_skip) {
   if (bytes_to_skip < 0) {
     return errors::InvalidArgument("Can only skip forward, not ",
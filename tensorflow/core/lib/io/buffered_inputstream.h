@@ -43,6 +43,17 @@ class BufferedInputStream : public InputStreamInterface {
 
   Status ReadNBytes(int64 bytes_to_read, string* result) override;
 
+  // Reads the next bytes_to_read bytes and points *result at them, avoiding a
+  // copy whenever the requested range is already contained in the internal
+  // buffer.  In that case *result aliases the buffer and is only valid until
+  // the next call on this stream.  When the range straddles a buffer boundary
+  // (or is larger than the buffer), the bytes are assembled in *scratch and
+  // *result points into *scratch instead.
+  //
+  // Returns the same statuses as ReadNBytes; on OUT_OF_RANGE, *result holds
+  // the bytes that could be read before the end of the file.
+  Status ReadSlice(int64 bytes_to_read, StringPiece* result, string* scratch);
+
   Status SkipNBytes(int64 bytes_to_skip) override;
 
   int64 Tell() const override;
@@ -190,6 +190,66 @@ TEST(BufferedInputStream, ReadNBytes) {
   }
 }
 
+TEST(BufferedInputStream, ReadSlice) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/buffer_test";
+  TF_ASSERT_OK(WriteStringToFile(env, fname, "0123456789"));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file));
+
+  for (auto buf_size : BufferSizes()) {
+    std::unique_ptr<RandomAccessInputStream> input_stream(
+        new RandomAccessInputStream(file.get()));
+    StringPiece read;
+    string scratch;
+    BufferedInputStream in(input_stream.get(), buf_size);
+    EXPECT_EQ(0, in.Tell());
+    TF_ASSERT_OK(in.ReadSlice(3, &read, &scratch));
+    EXPECT_EQ(read, "012");
+    EXPECT_EQ(3, in.Tell());
+    TF_ASSERT_OK(in.ReadSlice(0, &read, &scratch));
+    EXPECT_EQ(read, "");
+    EXPECT_EQ(3, in.Tell());
+    TF_ASSERT_OK(in.ReadSlice(4, &read, &scratch));
+    EXPECT_EQ(read, "3456");
+    EXPECT_EQ(7, in.Tell());
+    EXPECT_TRUE(errors::IsOutOfRange(in.ReadSlice(5, &read, &scratch)));
+    EXPECT_EQ(read, "789");
+    EXPECT_EQ(10, in.Tell());
+    EXPECT_TRUE(errors::IsOutOfRange(in.ReadSlice(5, &read, &scratch)));
+    EXPECT_EQ(read, "");
+    EXPECT_EQ(10, in.Tell());
+    TF_ASSERT_OK(in.ReadSlice(0, &read, &scratch));
+    EXPECT_EQ(read, "");
+    EXPECT_EQ(10, in.Tell());
+  }
+}
+
+TEST(BufferedInputStream, ReadSliceBorrowsBuffer) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/buffer_test";
+  TF_ASSERT_OK(WriteStringToFile(env, fname, "0123456789"));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file));
+
+  std::unique_ptr<RandomAccessInputStream> input_stream(
+      new RandomAccessInputStream(file.get()));
+  StringPiece read;
+  string scratch;
+  // The buffer is large enough for the whole file, so reads must be served
+  // directly out of it without touching the scratch string.
+  BufferedInputStream in(input_stream.get(), 1024);
+  TF_ASSERT_OK(in.ReadSlice(4, &read, &scratch));
+  EXPECT_EQ(read, "0123");
+  EXPECT_TRUE(scratch.empty());
+  const char* borrowed = read.data();
+  TF_ASSERT_OK(in.ReadSlice(4, &read, &scratch));
+  EXPECT_EQ(read, "4567");
+  EXPECT_TRUE(scratch.empty());
+  // Consecutive borrowed slices point into the same internal buffer.
+  EXPECT_EQ(borrowed + 4, read.data());
+}
+
 TEST(BufferedInputStream, SkipNBytes) {
   Env* env = Env::Default();
   string fname = testing::TmpDir() + "/buffered_inputstream_test";
@@ -0,0 +1,146 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/prefetched_inputstream.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace io {
+
+PrefetchedInputStream::PrefetchedInputStream(InputStreamInterface* input_stream,
+                                             size_t buffer_bytes,
+                                             int64 readahead_depth,
+                                             bool owns_input_stream)
+    : input_stream_(input_stream),
+      buffer_bytes_(buffer_bytes),
+      depth_(std::max<int64>(1, readahead_depth)),
+      owns_input_stream_(owns_input_stream) {
+  thread_.reset(Env::Default()->StartThread(
+      ThreadOptions(), "input_readahead", [this]() { PrefetchLoop(); }));
+}
+
+PrefetchedInputStream::~PrefetchedInputStream() {
+  {
+    mutex_lock l(mu_);
+    cancelled_ = true;
+    space_ready_.notify_all();
+    buffer_ready_.notify_all();
+  }
+  thread_.reset();  // Joins the background thread.
+  if (owns_input_stream_) {
+    delete input_stream_;
+  }
+}
+
+void PrefetchedInputStream::PrefetchLoop() {
+  while (true) {
+    {
+      mutex_lock l(mu_);
+      while (!cancelled_ && !reset_requested_ &&
+             (buffers_.size() >= static_cast<size_t>(depth_) ||
+              !fill_status_.ok())) {
+        space_ready_.wait(l);
+      }
+      if (cancelled_) return;
+      if (reset_requested_) {
+        // The consumer already dropped the queued buffers; rewinding the
+        // wrapped stream is done here so that it is only ever touched from
+        // this thread.
+        fill_status_ = input_stream_->Reset();
+        reset_requested_ = false;
+        buffer_ready_.notify_all();
+        continue;
+      }
+    }
+    // Fill outside the lock so that the consumer never waits behind I/O for
+    // data that has already been read ahead.
+    string buf;
+    Status s = input_stream_->ReadNBytes(buffer_bytes_, &buf);
+    {
+      mutex_lock l(mu_);
+      if (cancelled_) return;
+      if (reset_requested_) continue;  // The fill is stale; discard it.
+      if (!buf.empty()) {
+        buffers_.push_back(std::move(buf));
+      }
+      if (!s.ok()) {
+        fill_status_ = s;
+      }
+      buffer_ready_.notify_all();
+    }
+  }
+}
+
+Status PrefetchedInputStream::ReadNBytes(int64 bytes_to_read, string* result) {
+  if (bytes_to_read < 0) {
+    return errors::InvalidArgument("Can't read a negative number of bytes: ",
+                                   bytes_to_read);
+  }
+  result->clear();
+  result->reserve(bytes_to_read);
+  mutex_lock l(mu_);
+  while (static_cast<int64>(result->size()) < bytes_to_read) {
+    if (buffers_.empty()) {
+      if (!fill_status_.ok()) break;
+      buffer_ready_.wait(l);
+      continue;
+    }
+    const string& front = buffers_.front();
+    const size_t bytes_needed = bytes_to_read - result->size();
+    const size_t n = std::min(front.size() - front_pos_, bytes_needed);
+    result->append(front, front_pos_, n);
+    front_pos_ += n;
+    pos_ += n;
+    if (front_pos_ == front.size()) {
+      buffers_.pop_front();
+      front_pos_ = 0;
+      space_ready_.notify_all();
+    }
+  }
+  if (static_cast<int64>(result->size()) < bytes_to_read) {
+    // As with BufferedInputStream, a short read surfaces the underlying
+    // status (typically OUT_OF_RANGE at end of file) along with whatever
+    // bytes were available.
+    return fill_status_;
+  }
+  return Status::OK();
+}
+
+int64 PrefetchedInputStream::Tell() const {
+  mutex_lock l(mu_);
+  return pos_;
+}
+
+Status PrefetchedInputStream::Reset() {
+  mutex_lock l(mu_);
+  buffers_.clear();
+  front_pos_ = 0;
+  pos_ = 0;
+  fill_status_ = Status::OK();
+  reset_requested_ = true;
+  space_ready_.notify_all();
+  // Wait until the background thread has rewound the wrapped stream, so that
+  // data read ahead before the Reset() cannot leak into subsequent reads.
+  while (reset_requested_ && !cancelled_) {
+    buffer_ready_.wait(l);
+  }
+  return fill_status_;
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,86 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_PREFETCHED_INPUTSTREAM_H_
+#define TENSORFLOW_CORE_LIB_IO_PREFETCHED_INPUTSTREAM_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/lib/io/inputstream_interface.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace io {
+
+// Provides buffering on top of an InputStreamInterface, like
+// BufferedInputStream, but fills the buffers from a background thread: while
+// the caller consumes one buffer, up to `readahead_depth` further buffers of
+// `buffer_bytes` each are read ahead. This hides the per-refill latency of
+// high-latency sources (e.g. remote file systems) from the reading thread.
+//
+// All reads must be sequential; seeking is only possible via Reset(). A
+// single instance is NOT safe for concurrent use by multiple threads. The
+// wrapped input stream is accessed only from the background thread.
+class PrefetchedInputStream : public InputStreamInterface {
+ public:
+  // Does not take ownership of input_stream unless owns_input_stream is set
+  // to true; input_stream must outlive *this otherwise.
+  PrefetchedInputStream(InputStreamInterface* input_stream, size_t buffer_bytes,
+                        int64 readahead_depth, bool owns_input_stream = false);
+
+  ~PrefetchedInputStream() override;
+
+  Status ReadNBytes(int64 bytes_to_read, string* result) override;
+
+  int64 Tell() const override;
+
+  Status Reset() override;
+
+ private:
+  // Body of the background thread: keeps the queue of ready buffers at
+  // readahead_depth until an error or end of file, and services Reset().
+  void PrefetchLoop();
+
+  InputStreamInterface* input_stream_;  // not owned, unless owns_input_stream_
+  const size_t buffer_bytes_;           // size of one readahead buffer.
+  const int64 depth_;                   // maximum number of ready buffers.
+  const bool owns_input_stream_;
+
+  mutable mutex mu_;
+  condition_variable buffer_ready_;  // a buffer was queued, or state changed.
+  condition_variable space_ready_;   // the queue has room, or state changed.
+  // Buffers that have been filled but not yet consumed; the front buffer is
+  // consumed starting at front_pos_.
+  std::deque<string> buffers_ GUARDED_BY(mu_);
+  size_t front_pos_ GUARDED_BY(mu_) = 0;
+  // Status of the most recent fill. Once non-OK (including OUT_OF_RANGE at
+  // end of file), the background thread stops filling until Reset().
+  Status fill_status_ GUARDED_BY(mu_);
+  bool reset_requested_ GUARDED_BY(mu_) = false;
+  bool cancelled_ GUARDED_BY(mu_) = false;
+  int64 pos_ GUARDED_BY(mu_) = 0;  // bytes handed to the caller so far.
+
+  std::unique_ptr<Thread> thread_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PrefetchedInputStream);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_PREFETCHED_INPUTSTREAM_H_
@@ -0,0 +1,119 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/prefetched_inputstream.h"
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/random_inputstream.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+static std::vector<int> BufferSizes() {
+  return {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 65536};
+}
+
+TEST(PrefetchedInputStream, ReadNBytes) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/prefetched_inputstream_test";
+  TF_ASSERT_OK(WriteStringToFile(env, fname, "0123456789"));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file));
+
+  for (auto buf_size : BufferSizes()) {
+    for (int64 depth : {1, 2, 4}) {
+      std::unique_ptr<RandomAccessInputStream> input_stream(
+          new RandomAccessInputStream(file.get()));
+      PrefetchedInputStream in(input_stream.get(), buf_size, depth);
+      string read;
+      EXPECT_EQ(0, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(3, &read));
+      EXPECT_EQ(read, "012");
+      EXPECT_EQ(3, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(0, &read));
+      EXPECT_EQ(read, "");
+      EXPECT_EQ(3, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(4, &read));
+      EXPECT_EQ(read, "3456");
+      EXPECT_EQ(7, in.Tell());
+      EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(5, &read)));
+      EXPECT_EQ(read, "789");
+      EXPECT_EQ(10, in.Tell());
+      EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(5, &read)));
+      EXPECT_EQ(read, "");
+      EXPECT_EQ(10, in.Tell());
+    }
+  }
+}
+
+TEST(PrefetchedInputStream, SkipNBytes) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/prefetched_inputstream_test";
+  TF_ASSERT_OK(WriteStringToFile(env, fname, "0123456789"));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file));
+
+  for (auto buf_size : BufferSizes()) {
+    std::unique_ptr<RandomAccessInputStream> input_stream(
+        new RandomAccessInputStream(file.get()));
+    PrefetchedInputStream in(input_stream.get(), buf_size, 2);
+    string read;
+    TF_ASSERT_OK(in.SkipNBytes(3));
+    EXPECT_EQ(3, in.Tell());
+    TF_ASSERT_OK(in.ReadNBytes(2, &read));
+    EXPECT_EQ(read, "34");
+    EXPECT_EQ(5, in.Tell());
+    TF_ASSERT_OK(in.SkipNBytes(2));
+    EXPECT_EQ(7, in.Tell());
+    TF_ASSERT_OK(in.ReadNBytes(3, &read));
+    EXPECT_EQ(read, "789");
+    EXPECT_EQ(10, in.Tell());
+    EXPECT_TRUE(errors::IsOutOfRange(in.SkipNBytes(1)));
+  }
+}
+
+TEST(PrefetchedInputStream, Reset) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/prefetched_inputstream_test";
+  TF_ASSERT_OK(WriteStringToFile(env, fname, "0123456789"));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file));
+
+  for (auto buf_size : BufferSizes()) {
+    std::unique_ptr<RandomAccessInputStream> input_stream(
+        new RandomAccessInputStream(file.get()));
+    PrefetchedInputStream in(input_stream.get(), buf_size, 2);
+    string read;
+    TF_ASSERT_OK(in.ReadNBytes(4, &read));
+    EXPECT_EQ(read, "0123");
+    TF_ASSERT_OK(in.Reset());
+    EXPECT_EQ(0, in.Tell());
+    TF_ASSERT_OK(in.ReadNBytes(4, &read));
+    EXPECT_EQ(read, "0123");
+    // Reset after hitting end of file clears the cached status.
+    TF_ASSERT_OK(in.SkipNBytes(6));
+    EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(1, &read)));
+    TF_ASSERT_OK(in.Reset());
+    TF_ASSERT_OK(in.ReadNBytes(10, &read));
+    EXPECT_EQ(read, "0123456789");
+  }
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
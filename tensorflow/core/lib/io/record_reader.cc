@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/compression.h"
+#include "tensorflow/core/lib/io/prefetched_inputstream.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/platform/env.h"
 
@@ -46,6 +47,14 @@ RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
                << " No compression will be used.";
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
+#endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kZstd) {
+    options.compression_type = io::RecordReaderOptions::ZSTD_COMPRESSION;
+#if defined(IS_SLIM_BUILD)
+    LOG(ERROR) << "Compression is not supported but compression_type is set."
+               << " No compression will be used.";
+#else
+    options.zstd_options = io::ZstdCompressionOptions::DEFAULT();
 #endif  // IS_SLIM_BUILD
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
@@ -60,8 +69,15 @@ RecordReader::RecordReader(RandomAccessFile* file,
       input_stream_(new RandomAccessInputStream(file)),
       last_read_failed_(false) {
   if (options.buffer_size > 0) {
-    input_stream_.reset(new BufferedInputStream(input_stream_.release(),
-                                                options.buffer_size, true));
+    if (options.readahead_depth > 0) {
+      input_stream_.reset(
+          new PrefetchedInputStream(input_stream_.release(),
+                                    options.buffer_size,
+                                    options.readahead_depth, true));
+    } else {
+      input_stream_.reset(new BufferedInputStream(input_stream_.release(),
+                                                  options.buffer_size, true));
+    }
   }
   if (options.compression_type == RecordReaderOptions::ZLIB_COMPRESSION) {
 // We don't have zlib available on all embedded platforms, so fail.
@@ -71,6 +87,13 @@ RecordReader::RecordReader(RandomAccessFile* file,
     input_stream_.reset(new ZlibInputStream(
         input_stream_.release(), options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options, true));
+#endif  // IS_SLIM_BUILD
+  } else if (options.compression_type == RecordReaderOptions::ZSTD_COMPRESSION) {
+#if defined(IS_SLIM_BUILD)
+    LOG(FATAL) << "Zstd compression is unsupported on mobile platforms.";
+#else   // IS_SLIM_BUILD
+    input_stream_.reset(new ZstdInputStream(input_stream_.release(),
+                                            options.zstd_options, true));
 #endif  // IS_SLIM_BUILD
   } else if (options.compression_type == RecordReaderOptions::NONE) {
     // Nothing to do.
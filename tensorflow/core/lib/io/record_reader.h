@@ -22,6 +22,8 @@ limitations under the License.
 #if !defined(IS_SLIM_BUILD)
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/lib/io/zstd/zstd_compression_options.h"
+#include "tensorflow/core/lib/io/zstd/zstd_inputstream.h"
 #endif  // IS_SLIM_BUILD
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
@@ -34,7 +36,7 @@ namespace io {
 
 class RecordReaderOptions {
  public:
-  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1 };
+  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1, ZSTD_COMPRESSION = 2 };
   CompressionType compression_type = NONE;
 
   // If buffer_size is non-zero, then all reads must be sequential, and no
@@ -42,12 +44,20 @@ class RecordReaderOptions {
   // compressed files.) Consider using SequentialRecordReader.
   int64 buffer_size = 0;
 
+  // If readahead_depth is non-zero (and buffer_size is non-zero), buffers of
+  // buffer_size bytes are filled by a background thread, keeping up to
+  // readahead_depth buffers ready while the current one is consumed. This
+  // hides the per-refill latency of remote file systems from the reading
+  // thread. As with buffer_size, all reads must be sequential.
+  int64 readahead_depth = 0;
+
   static RecordReaderOptions CreateRecordReaderOptions(
       const string& compression_type);
 
 #if !defined(IS_SLIM_BUILD)
-  // Options specific to zlib compression.
+  // Options specific to zlib and zstd compression.
   ZlibCompressionOptions zlib_options;
+  ZstdCompressionOptions zstd_options;
 #endif  // IS_SLIM_BUILD
 };
 
@@ -117,6 +117,46 @@ TEST(RecordReaderWriterTest, TestZlibSyncFlush) {
   VerifyFlush(options);
 }
 
+TEST(RecordReaderWriterTest, TestCoalescedFlush) {
+  io::RecordWriterOptions options;
+  options.buffer_size = 1 << 20;
+  // Flush must push coalesced records to the file even when the buffer is
+  // not yet full.
+  VerifyFlush(options);
+}
+
+TEST(RecordReaderWriterTest, TestCoalescedBasics) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_coalesced_test";
+
+  for (auto buf_size : BufferSizes()) {
+    {
+      std::unique_ptr<WritableFile> file;
+      TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+      io::RecordWriterOptions options;
+      options.buffer_size = buf_size;
+      io::RecordWriter writer(file.get(), options);
+      TF_EXPECT_OK(writer.WriteRecord("abc"));
+      TF_EXPECT_OK(writer.WriteRecord("defg"));
+      TF_CHECK_OK(writer.Close());
+    }
+    {
+      std::unique_ptr<RandomAccessFile> read_file;
+      TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+      io::RecordReader reader(read_file.get());
+      uint64 offset = 0;
+      string record;
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ("abc", record);
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ("defg", record);
+      EXPECT_EQ(error::OUT_OF_RANGE,
+                reader.ReadRecord(&offset, &record).code());
+    }
+  }
+}
+
 TEST(RecordReaderWriterTest, TestBasics) {
   Env* env = Env::Default();
   string fname = testing::TmpDir() + "/record_reader_writer_test";
@@ -26,6 +26,10 @@ namespace {
 bool IsZlibCompressed(RecordWriterOptions options) {
   return options.compression_type == RecordWriterOptions::ZLIB_COMPRESSION;
 }
+
+bool IsZstdCompressed(RecordWriterOptions options) {
+  return options.compression_type == RecordWriterOptions::ZSTD_COMPRESSION;
+}
 }  // namespace
 
 RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
@@ -46,6 +50,14 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
                << " No compression will be used.";
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
+#endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kZstd) {
+    options.compression_type = io::RecordWriterOptions::ZSTD_COMPRESSION;
+#if defined(IS_SLIM_BUILD)
+    LOG(ERROR) << "Compression is not supported but compression_type is set."
+               << " No compression will be used.";
+#else
+    options.zstd_options = io::ZstdCompressionOptions::DEFAULT();
 #endif  // IS_SLIM_BUILD
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
@@ -71,12 +83,28 @@ RecordWriter::RecordWriter(WritableFile* dest,
                  << s.ToString();
     }
     dest_ = zlib_output_buffer;
+#endif  // IS_SLIM_BUILD
+  } else if (IsZstdCompressed(options)) {
+#if defined(IS_SLIM_BUILD)
+    LOG(FATAL) << "Zstd compression is unsupported on mobile platforms.";
+#else   // IS_SLIM_BUILD
+    ZstdOutputBuffer* zstd_output_buffer =
+        new ZstdOutputBuffer(dest, options.zstd_options);
+    Status s = zstd_output_buffer->Init();
+    if (!s.ok()) {
+      LOG(FATAL) << "Failed to initialize Zstd outputbuffer. Error: "
+                 << s.ToString();
+    }
+    dest_ = zstd_output_buffer;
 #endif  // IS_SLIM_BUILD
   } else if (options.compression_type == RecordWriterOptions::NONE) {
     // Nothing to do
   } else {
     LOG(FATAL) << "Unspecified compression type :" << options.compression_type;
   }
+  if (options.buffer_size > 0) {
+    buffer_.reserve(options.buffer_size);
+  }
 }
 
 RecordWriter::~RecordWriter() {
@@ -102,6 +130,21 @@ Status RecordWriter::WriteRecord(StringPiece data) {
   char footer[kFooterSize];
   PopulateHeader(header, data.data(), data.size());
   PopulateFooter(footer, data.data(), data.size());
+  if (options_.buffer_size > 0 &&
+      data.size() < static_cast<size_t>(options_.buffer_size)) {
+    // Coalesce small records so the file layer sees one large append per
+    // buffer_size bytes instead of three small ones per record.
+    buffer_.append(header, sizeof(header));
+    buffer_.append(data.data(), data.size());
+    buffer_.append(footer, sizeof(footer));
+    if (buffer_.size() >= static_cast<size_t>(options_.buffer_size)) {
+      return FlushBuffer();
+    }
+    return Status::OK();
+  }
+  // Payloads at least as large as the buffer skip the coalescing copy; flush
+  // what is pending first so records stay in order.
+  TF_RETURN_IF_ERROR(FlushBuffer());
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
   return dest_->Append(StringPiece(footer, sizeof(footer)));
@@ -122,16 +165,26 @@ Status RecordWriter::WriteRecord(const absl::Cord& data) {
   char footer[kFooterSize];
   PopulateHeader(header, data);
   PopulateFooter(footer, data);
+  TF_RETURN_IF_ERROR(FlushBuffer());
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
   return dest_->Append(StringPiece(footer, sizeof(footer)));
 }
 #endif
 
+Status RecordWriter::FlushBuffer() {
+  if (!buffer_.empty()) {
+    TF_RETURN_IF_ERROR(dest_->Append(buffer_));
+    buffer_.clear();
+  }
+  return Status::OK();
+}
+
 Status RecordWriter::Close() {
   if (dest_ == nullptr) return Status::OK();
+  TF_RETURN_IF_ERROR(FlushBuffer());
 #if !defined(IS_SLIM_BUILD)
-  if (IsZlibCompressed(options_)) {
+  if (IsZlibCompressed(options_) || IsZstdCompressed(options_)) {
     Status s = dest_->Close();
     delete dest_;
     dest_ = nullptr;
@@ -146,7 +199,8 @@ Status RecordWriter::Flush() {
     return Status(::tensorflow::error::FAILED_PRECONDITION,
                   "Writer not initialized or previously closed");
   }
-  if (IsZlibCompressed(options_)) {
+  TF_RETURN_IF_ERROR(FlushBuffer());
+  if (IsZlibCompressed(options_) || IsZstdCompressed(options_)) {
     return dest_->Flush();
   }
   return Status::OK();
@@ -23,6 +23,8 @@ limitations under the License.
 #if !defined(IS_SLIM_BUILD)
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_outputbuffer.h"
+#include "tensorflow/core/lib/io/zstd/zstd_compression_options.h"
+#include "tensorflow/core/lib/io/zstd/zstd_outputbuffer.h"
 #endif  // IS_SLIM_BUILD
 #include "tensorflow/core/platform/cord.h"
 #include "tensorflow/core/platform/macros.h"
@@ -36,15 +38,22 @@ namespace io {
 
 class RecordWriterOptions {
  public:
-  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1 };
+  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1, ZSTD_COMPRESSION = 2 };
   CompressionType compression_type = NONE;
 
+  // If buffer_size is non-zero, records are coalesced into an internal
+  // buffer and appended to the file in chunks of at least buffer_size bytes,
+  // instead of issuing three small Append calls per record. Buffered data is
+  // pushed to the file by Flush() and Close().
+  int64 buffer_size = 0;
+
   static RecordWriterOptions CreateRecordWriterOptions(
       const string& compression_type);
 
-// Options specific to zlib compression.
+// Options specific to zlib and zstd compression.
 #if !defined(IS_SLIM_BUILD)
   tensorflow::io::ZlibCompressionOptions zlib_options;
+  tensorflow::io::ZstdCompressionOptions zstd_options;
 #endif  // IS_SLIM_BUILD
 };
 
@@ -101,8 +110,13 @@ class RecordWriter {
 #endif
 
  private:
+  // Appends any coalesced records to the file and empties the buffer.
+  Status FlushBuffer();
+
   WritableFile* dest_;
   RecordWriterOptions options_;
+  // Coalescing buffer; only used when options_.buffer_size > 0.
+  string buffer_;
 
   inline static uint32 MaskedCrc(const char* data, size_t n) {
     return crc32c::Mask(crc32c::Value(data, n));
@@ -55,7 +55,8 @@ Status TestMultipleWrites(size_t compress_input_buf_size,
                           size_t uncompress_input_buf_size,
                           size_t uncompress_output_buf_size, int num_writes = 1,
                           bool with_flush = false, int num_copies = 1,
-                          bool corrupt_compressed_file = false) {
+                          bool corrupt_compressed_file = false,
+                          int num_decompression_threads = 0) {
   Env* env = Env::Default();
 
   string fname = testing::TmpDir() + "/snappy_buffers_test";
@@ -115,7 +116,8 @@ Status TestMultipleWrites(size_t compress_input_buf_size,
   std::unique_ptr<RandomAccessFile> file_reader;
   TF_RETURN_IF_ERROR(env->NewRandomAccessFile(fname, &file_reader));
   io::SnappyInputBuffer in(file_reader.get(), uncompress_input_buf_size,
-                           uncompress_output_buf_size);
+                           uncompress_output_buf_size,
+                           num_decompression_threads);
 
   // Run the test twice, resetting the stream after the first attempt.
   for (int attempt = 0; attempt < 2; ++attempt) {
@@ -177,6 +179,29 @@ TEST(SnappyBuffers, CorruptBlock) {
                             " bytes from file. ", "Possible data corruption."));
 }
 
+TEST(SnappyBuffers, ParallelDecompression) {
+  if (!SnappyCompressionSupported()) {
+    fprintf(stderr, "skipping compression tests\n");
+    return;
+  }
+  for (int num_threads : {2, 4, 8}) {
+    TF_CHECK_OK(TestMultipleWrites(10000, 10000, 10000, 10000, 6, true, 1,
+                                   false, num_threads));
+  }
+}
+
+TEST(SnappyBuffers, ParallelCorruptBlock) {
+  if (!SnappyCompressionSupported()) {
+    fprintf(stderr, "skipping compression tests\n");
+    return;
+  }
+  // The blocks before the corruption must still be served before the error is
+  // reported, just as with inline decompression.
+  CHECK_EQ(TestMultipleWrites(10000, 10000, 700, 10000, 2, true, 1, true, 4),
+           errors::DataLoss("Failed to read ", COMPRESSED_RECORD_SIZE,
+                            " bytes from file. ", "Possible data corruption."));
+}
+
 TEST(SnappyBuffers, CorruptBlockLargeInputBuffer) {
   if (!SnappyCompressionSupported()) {
     fprintf(stderr, "skipping compression tests\n");
@@ -15,19 +15,31 @@ limitations under the License.
 
 #include "tensorflow/core/lib/io/snappy/snappy_inputbuffer.h"
 
+#include <vector>
+
+#include "tensorflow/core/lib/core/blocking_counter.h"
+
 namespace tensorflow {
 namespace io {
 SnappyInputBuffer::SnappyInputBuffer(
     RandomAccessFile* file,
     size_t input_buffer_bytes,  // size of input_buffer_
-    size_t output_buffer_bytes  // size of output_buffer_
-    )
+    size_t output_buffer_bytes,  // size of output_buffer_
+    int num_decompression_threads)
     : file_(file),
       input_buffer_capacity_(input_buffer_bytes),
       output_buffer_capacity_(output_buffer_bytes),
       input_buffer_(new char[input_buffer_capacity_]),
       output_buffer_(new char[output_buffer_capacity_]),
-      next_in_(input_buffer_.get()) {}
+      next_in_(input_buffer_.get()),
+      num_decompression_threads_(num_decompression_threads) {
+  if (num_decompression_threads_ > 1) {
+    // The calling thread inflates one block of every batch itself, so the
+    // pool only needs workers for the remaining blocks.
+    pool_.reset(new thread::ThreadPool(Env::Default(), "snappy_inflate",
+                                       num_decompression_threads_ - 1));
+  }
+}
 
 Status SnappyInputBuffer::ReadNBytes(int64 bytes_to_read, string* result) {
   result->clear();
@@ -39,7 +51,11 @@ Status SnappyInputBuffer::ReadNBytes(int64 bytes_to_read, string* result) {
     DCHECK(avail_out_ == 0);
 
     // Now that the cache is empty we need to inflate more data.
-    TF_RETURN_IF_ERROR(Inflate());
+    if (num_decompression_threads_ > 1) {
+      TF_RETURN_IF_ERROR(InflateParallel());
+    } else {
+      TF_RETURN_IF_ERROR(Inflate());
+    }
 
     bytes_to_read -= ReadBytesFromCache(bytes_to_read, result);
   }
@@ -57,12 +73,31 @@ Status SnappyInputBuffer::Reset() {
   avail_in_ = 0;
   avail_out_ = 0;
   next_in_ = input_buffer_.get();
+  decompressed_blocks_.clear();
+  block_pos_ = 0;
+  deferred_status_ = Status::OK();
 
   return Status::OK();
 }
 
 size_t SnappyInputBuffer::ReadBytesFromCache(size_t bytes_to_read,
                                              string* result) {
+  if (num_decompression_threads_ > 1) {
+    size_t total_read_bytes = 0;
+    while (bytes_to_read > 0 && !decompressed_blocks_.empty()) {
+      const string& block = decompressed_blocks_.front();
+      size_t can_read_bytes = std::min(bytes_to_read, block.size() - block_pos_);
+      result->append(block, block_pos_, can_read_bytes);
+      block_pos_ += can_read_bytes;
+      bytes_to_read -= can_read_bytes;
+      total_read_bytes += can_read_bytes;
+      if (block_pos_ == block.size()) {
+        decompressed_blocks_.pop_front();
+        block_pos_ = 0;
+      }
+    }
+    return total_read_bytes;
+  }
   size_t can_read_bytes = std::min(bytes_to_read, avail_out_);
   if (can_read_bytes > 0) {
     result->append(next_out_, can_read_bytes);
@@ -73,6 +108,93 @@ size_t SnappyInputBuffer::ReadBytesFromCache(size_t bytes_to_read,
   return can_read_bytes;
 }
 
+Status SnappyInputBuffer::ReadCompressedBlock(string* block) {
+  // Read length of compressed block.
+  uint32 compressed_block_length;
+  TF_RETURN_IF_ERROR(ReadCompressedBlockLength(&compressed_block_length));
+
+  // If the entire block is not in cache do a read from file.
+  if (avail_in_ < compressed_block_length) {
+    TF_RETURN_IF_ERROR(ReadFromFile());
+    if (avail_in_ < compressed_block_length) {
+      if (compressed_block_length > input_buffer_capacity_) {
+        return errors::ResourceExhausted(
+            "Input buffer(size: ", input_buffer_capacity_,
+            " bytes) too small. Should be larger ", "than ",
+            compressed_block_length, " bytes.");
+      } else {
+        return errors::DataLoss(
+            strings::StrCat("Failed to read ", compressed_block_length,
+                            " bytes from file. Possible data corruption."));
+      }
+    }
+  }
+
+  block->assign(next_in_, compressed_block_length);
+  next_in_ += compressed_block_length;
+  avail_in_ -= compressed_block_length;
+  return Status::OK();
+}
+
+Status SnappyInputBuffer::InflateParallel() {
+  if (!deferred_status_.ok()) {
+    return deferred_status_;
+  }
+
+  // Gather up to num_decompression_threads_ compressed blocks.  An error
+  // part-way through a batch is deferred so that the blocks read before it
+  // are still served, exactly as they would be when inflating inline.
+  std::vector<string> compressed(num_decompression_threads_);
+  int num_blocks = 0;
+  while (num_blocks < num_decompression_threads_) {
+    Status s = ReadCompressedBlock(&compressed[num_blocks]);
+    if (!s.ok()) {
+      if (num_blocks == 0) return s;
+      deferred_status_ = s;
+      break;
+    }
+    num_blocks++;
+  }
+
+  // Inflate the batch in parallel: workers take blocks 1..n-1, the calling
+  // thread inflates block 0.
+  std::vector<string> uncompressed(num_blocks);
+  std::vector<Status> statuses(num_blocks);
+  auto inflate_block = [&](int i) {
+    const string& input = compressed[i];
+    size_t uncompressed_length;
+    if (!port::Snappy_GetUncompressedLength(input.data(), input.size(),
+                                            &uncompressed_length)) {
+      statuses[i] =
+          errors::DataLoss("Parsing error in Snappy_GetUncompressedLength");
+      return;
+    }
+    if (uncompressed_length == 0) return;
+    uncompressed[i].resize(uncompressed_length);
+    if (!port::Snappy_Uncompress(input.data(), input.size(),
+                                 &uncompressed[i][0])) {
+      statuses[i] = errors::DataLoss("Snappy_Uncompress failed");
+    }
+  };
+  BlockingCounter counter(num_blocks - 1);
+  for (int i = 1; i < num_blocks; i++) {
+    pool_->Schedule([&inflate_block, &counter, i]() {
+      inflate_block(i);
+      counter.DecrementCount();
+    });
+  }
+  inflate_block(0);
+  counter.Wait();
+
+  for (int i = 0; i < num_blocks; i++) {
+    TF_RETURN_IF_ERROR(statuses[i]);
+    if (!uncompressed[i].empty()) {
+      decompressed_blocks_.push_back(std::move(uncompressed[i]));
+    }
+  }
+  return Status::OK();
+}
+
 Status SnappyInputBuffer::Inflate() {
   // Read length of compressed block.
   uint32 compressed_block_length;
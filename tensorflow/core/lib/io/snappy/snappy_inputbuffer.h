@@ -16,8 +16,10 @@ limitations under the License.
 #ifndef TENSORFLOW_LIB_IO_SNAPPY_INPUTBUFFER_H_
 #define TENSORFLOW_LIB_IO_SNAPPY_INPUTBUFFER_H_
 
+#include <deque>
 #include <string>
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
@@ -38,8 +40,15 @@ class SnappyInputBuffer : public InputStreamInterface {
   // `input_buffer_bytes` bytes for reading contents from `file` and another
   // buffer with size `output_buffer_bytes` for caching decompressed contents.
   // Does *not* take ownership of "file".
+  //
+  // If `num_decompression_threads` is greater than 1, compressed blocks are
+  // inflated concurrently by a small worker pool.  Since every block in a
+  // snappy-compressed file is compressed independently, the outputs can be
+  // served in file order and the stream semantics are unchanged.  The default
+  // of 0 decompresses inline on the reader thread.
   SnappyInputBuffer(RandomAccessFile* file, size_t input_buffer_bytes,
-                    size_t output_buffer_bytes);
+                    size_t output_buffer_bytes,
+                    int num_decompression_threads = 0);
 
   // Reads bytes_to_read bytes into *result, overwriting *result.
   //
@@ -92,6 +101,15 @@ class SnappyInputBuffer : public InputStreamInterface {
   // The length is stored in 4 bytes in little endian notation.
   Status ReadCompressedBlockLength(uint32* length);
 
+  // Reads the next compressed block (length prefix plus payload) into *block.
+  // Used by the parallel decompression path.
+  Status ReadCompressedBlock(string* block);
+
+  // Gathers up to `num_decompression_threads_` compressed blocks, inflates
+  // them concurrently on `pool_` and appends the outputs, in file order, to
+  // `decompressed_blocks_`.
+  Status InflateParallel();
+
   RandomAccessFile* file_;         // Not owned
   int64 file_pos_ = 0;             // Next position to read from in `file_`
   size_t input_buffer_capacity_;   // Size of `input_buffer_`.
@@ -119,6 +137,24 @@ class SnappyInputBuffer : public InputStreamInterface {
   // Number of unread bytes bytes available at `next_out_` in `output_buffer_`.
   size_t avail_out_ = 0;
 
+  // Number of threads used to decompress blocks; 0 or 1 decompresses inline.
+  const int num_decompression_threads_;
+
+  // Worker pool for the parallel decompression path.  nullptr when inflating
+  // inline.
+  std::unique_ptr<thread::ThreadPool> pool_;
+
+  // Decompressed blocks not yet returned to the caller, in file order.  Only
+  // used by the parallel decompression path; the front block has been consumed
+  // up to `block_pos_`.
+  std::deque<string> decompressed_blocks_;
+  size_t block_pos_ = 0;
+
+  // First error encountered while gathering a batch of compressed blocks.  It
+  // is reported once all blocks read before it have been consumed, so callers
+  // observe the same prefix of the stream as with inline decompression.
+  Status deferred_status_ = Status::OK();
+
   TF_DISALLOW_COPY_AND_ASSIGN(SnappyInputBuffer);
 };
 
@@ -21,6 +21,8 @@ limitations under the License.
 namespace tensorflow {
 namespace table {
 
+class Cache;
+
 // DB contents are stored in a set of blocks, each of which holds a
 // sequence of key,value pairs.  Each block may be compressed before
 // being stored in a file.  The following enum describes which
@@ -60,6 +62,14 @@ struct Options {
   // incompressible, the kSnappyCompression implementation will
   // efficiently detect that and will switch to uncompressed mode.
   CompressionType compression = kSnappyCompression;
+
+  // If non-null, use the specified cache for blocks.  The cache may be
+  // shared by many tables in a process (keys are partitioned per table via
+  // Cache::NewId), so repeated reads of hot index and data blocks across
+  // readers are served from memory instead of the file system.
+  //
+  // Default: nullptr, which means do not cache blocks.
+  Cache* block_cache = nullptr;
 };
 
 }  // namespace table
@@ -0,0 +1,152 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/random_inputstream.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/lib/io/zstd/zstd_inputstream.h"
+#include "tensorflow/core/lib/io/zstd/zstd_outputbuffer.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+
+static string GetRecord() {
+  static const string lorem_ipsum =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit."
+      " Fusce vehicula tincidunt libero sit amet ultrices. Vestibulum non "
+      "felis augue. Duis vitae augue id lectus lacinia congue et ut purus. "
+      "Donec auctor, nisl at dapibus volutpat, diam ante lacinia dolor, vel"
+      "dignissim lacus nisi sed purus.";
+  return lorem_ipsum;
+}
+
+static string GenTestString(int copies = 1) {
+  string result = "";
+  for (int i = 0; i < copies; i++) {
+    result += GetRecord();
+  }
+  return result;
+}
+
+// Compresses `data` into `fname` and reads it back, verifying the round trip.
+static Status TestWriteAndRead(const io::ZstdCompressionOptions& options,
+                               int num_writes, int num_copies) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/zstd_buffers_test";
+  string data = GenTestString(num_copies);
+  string expected_result;
+
+  std::unique_ptr<WritableFile> file_writer;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(fname, &file_writer));
+  io::ZstdOutputBuffer out(file_writer.get(), options);
+  TF_RETURN_IF_ERROR(out.Init());
+
+  for (int i = 0; i < num_writes; i++) {
+    TF_RETURN_IF_ERROR(out.Append(StringPiece(data)));
+    strings::StrAppend(&expected_result, data);
+  }
+  TF_RETURN_IF_ERROR(out.Close());
+  TF_RETURN_IF_ERROR(file_writer->Flush());
+  TF_RETURN_IF_ERROR(file_writer->Close());
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(fname, &file_reader));
+  io::RandomAccessInputStream input_stream(file_reader.get());
+  io::ZstdInputStream in(&input_stream, options);
+
+  // Run the test twice, resetting the stream after the first attempt.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    string actual_result;
+    for (int i = 0; i < num_writes; i++) {
+      string decompressed_output;
+      TF_RETURN_IF_ERROR(in.ReadNBytes(data.size(), &decompressed_output));
+      strings::StrAppend(&actual_result, decompressed_output);
+    }
+    if (actual_result.compare(expected_result)) {
+      return errors::DataLoss("Actual and expected results don't match.");
+    }
+    TF_RETURN_IF_ERROR(in.Reset());
+  }
+  return Status::OK();
+}
+
+TEST(ZstdBuffers, MultipleWrites) {
+  if (!io::ZstdOutputBuffer::IsSupported()) {
+    fprintf(stderr, "Zstd disabled. Skipping test\n");
+    return;
+  }
+  TF_CHECK_OK(TestWriteAndRead(io::ZstdCompressionOptions::DEFAULT(), 2, 2));
+}
+
+TEST(ZstdBuffers, SmallInputBuffer) {
+  if (!io::ZstdOutputBuffer::IsSupported()) {
+    fprintf(stderr, "Zstd disabled. Skipping test\n");
+    return;
+  }
+  // Forces many small blocks, each an independent frame.
+  io::ZstdCompressionOptions options;
+  options.input_buffer_size = 100;
+  TF_CHECK_OK(TestWriteAndRead(options, 2, 3));
+}
+
+TEST(ZstdBuffers, Dictionary) {
+  if (!io::ZstdOutputBuffer::IsSupported()) {
+    fprintf(stderr, "Zstd disabled. Skipping test\n");
+    return;
+  }
+  io::ZstdCompressionOptions options;
+  options.dictionary = GetRecord();
+  options.input_buffer_size = 100;
+  TF_CHECK_OK(TestWriteAndRead(options, 2, 3));
+}
+
+TEST(ZstdBuffers, RecordWriterRoundTrip) {
+  if (!io::ZstdOutputBuffer::IsSupported()) {
+    fprintf(stderr, "Zstd disabled. Skipping test\n");
+    return;
+  }
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/zstd_record_test";
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriterOptions options =
+        io::RecordWriterOptions::CreateRecordWriterOptions("ZSTD");
+    io::RecordWriter writer(file.get(), options);
+    TF_EXPECT_OK(writer.WriteRecord("abc"));
+    TF_EXPECT_OK(writer.WriteRecord("defg"));
+    TF_CHECK_OK(writer.Close());
+  }
+  {
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReaderOptions options =
+        io::RecordReaderOptions::CreateRecordReaderOptions("ZSTD");
+    io::RecordReader reader(read_file.get(), options);
+    uint64 offset = 0;
+    string record;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("abc", record);
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("defg", record);
+    EXPECT_EQ(error::OUT_OF_RANGE, reader.ReadRecord(&offset, &record).code());
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,52 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_COMPRESSION_OPTIONS_H_
+#define TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_COMPRESSION_OPTIONS_H_
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+class ZstdCompressionOptions {
+ public:
+  static ZstdCompressionOptions DEFAULT() { return ZstdCompressionOptions(); }
+
+  // Compression level, in zstd's 1..22 range.  Higher levels trade
+  // compression speed for ratio; decompression speed is mostly unaffected.
+  // Defaults to zstd's own default.
+  int compression_level = 3;
+
+  // Optional shared dictionary.  When non-empty, every block is compressed
+  // and decompressed with this dictionary, which substantially improves the
+  // ratio for files made of many small, similar records.  The reader must be
+  // configured with the same dictionary as the writer.
+  string dictionary;
+
+  // Size of the buffer in which input data is collected before being
+  // compressed as one block.  This bounds the uncompressed size of a block,
+  // so readers must use an output buffer at least this large.
+  int64 input_buffer_size = 256 << 10;
+
+  // Size of the sink buffer where the compressed data produced by zstd is
+  // cached before being written to file.
+  int64 output_buffer_size = 256 << 10;
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_COMPRESSION_OPTIONS_H_
@@ -0,0 +1,149 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/zstd/zstd_inputstream.h"
+
+#if defined(TF_USE_ZSTD)
+#include <zstd.h>
+#endif  // TF_USE_ZSTD
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace io {
+
+ZstdInputStream::ZstdInputStream(InputStreamInterface* input_stream,
+                                 const ZstdCompressionOptions& options,
+                                 bool owns_input_stream)
+    : input_stream_(input_stream),
+      options_(options),
+      owns_input_stream_(owns_input_stream) {
+#if defined(TF_USE_ZSTD)
+  dctx_ = ZSTD_createDCtx();
+#endif  // TF_USE_ZSTD
+}
+
+ZstdInputStream::~ZstdInputStream() {
+#if defined(TF_USE_ZSTD)
+  if (dctx_ != nullptr) {
+    ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(dctx_));
+  }
+#endif  // TF_USE_ZSTD
+  if (owns_input_stream_) {
+    delete input_stream_;
+  }
+}
+
+Status ZstdInputStream::ReadNBytes(int64 bytes_to_read, string* result) {
+  if (bytes_to_read < 0) {
+    return errors::InvalidArgument("Can't read a negative number of bytes: ",
+                                   bytes_to_read);
+  }
+  result->clear();
+  result->reserve(bytes_to_read);
+  while (result->size() < static_cast<size_t>(bytes_to_read)) {
+    if (cache_pos_ == cached_.size()) {
+      TF_RETURN_IF_ERROR(Inflate());
+    }
+    const size_t chunk = std::min<size_t>(cached_.size() - cache_pos_,
+                                          bytes_to_read - result->size());
+    result->append(cached_, cache_pos_, chunk);
+    cache_pos_ += chunk;
+    bytes_read_ += chunk;
+  }
+  return Status::OK();
+}
+
+#if defined(TF_USE_ZSTD)
+
+Status ZstdInputStream::Inflate() {
+  // Read the 4 byte big endian compressed block length.
+  string length_bytes;
+  Status header_status = input_stream_->ReadNBytes(4, &length_bytes);
+  if (!header_status.ok()) {
+    if (errors::IsOutOfRange(header_status) && !length_bytes.empty()) {
+      return errors::DataLoss("Truncated block header in zstd stream");
+    }
+    // A clean end of stream, or a read error from the underlying stream.
+    return header_status;
+  }
+  uint32 compressed_length = 0;
+  for (int i = 0; i < 4; i++) {
+    compressed_length = (compressed_length << 8) |
+                        static_cast<unsigned char>(length_bytes[i]);
+  }
+
+  string compressed;
+  Status s = input_stream_->ReadNBytes(compressed_length, &compressed);
+  if (compressed.size() < compressed_length) {
+    if (errors::IsOutOfRange(s)) {
+      return errors::DataLoss("Truncated block in zstd stream");
+    }
+    return s;
+  }
+
+  const unsigned long long frame_size =
+      ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+  if (frame_size == ZSTD_CONTENTSIZE_ERROR ||
+      frame_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+    return errors::DataLoss("Invalid zstd frame header");
+  }
+  cached_.resize(frame_size);
+  cache_pos_ = 0;
+  if (frame_size == 0) {
+    return Status::OK();
+  }
+
+  size_t r;
+  if (options_.dictionary.empty()) {
+    r = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx*>(dctx_), &cached_[0],
+                            frame_size, compressed.data(), compressed.size());
+  } else {
+    r = ZSTD_decompress_usingDict(static_cast<ZSTD_DCtx*>(dctx_), &cached_[0],
+                                  frame_size, compressed.data(),
+                                  compressed.size(),
+                                  options_.dictionary.data(),
+                                  options_.dictionary.size());
+  }
+  if (ZSTD_isError(r)) {
+    return errors::DataLoss("ZSTD_decompress failed: ", ZSTD_getErrorName(r));
+  }
+  return Status::OK();
+}
+
+#else  // TF_USE_ZSTD
+
+Status ZstdInputStream::Inflate() {
+  return errors::Unimplemented(
+      "Zstd compression is not supported in this build. Rebuild with "
+      "TF_USE_ZSTD and link against libzstd.");
+}
+
+#endif  // TF_USE_ZSTD
+
+int64 ZstdInputStream::Tell() const { return bytes_read_; }
+
+Status ZstdInputStream::Reset() {
+  TF_RETURN_IF_ERROR(input_stream_->Reset());
+  cached_.clear();
+  cache_pos_ = 0;
+  bytes_read_ = 0;
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,92 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_INPUTSTREAM_H_
+#define TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_INPUTSTREAM_H_
+
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/io/inputstream_interface.h"
+#include "tensorflow/core/lib/io/zstd/zstd_compression_options.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// A ZstdInputStream reads a stream written by ZstdOutputBuffer: a sequence of
+// blocks, each a 4 byte big endian compressed length followed by an
+// independent zstd frame.  See zstd_outputbuffer.h for the format details.
+//
+// Zstd support is compiled in only when the build defines TF_USE_ZSTD and
+// links against libzstd; otherwise reads return an Unimplemented error.
+//
+// A given instance of a ZstdInputStream is NOT safe for concurrent use by
+// multiple threads.
+class ZstdInputStream : public InputStreamInterface {
+ public:
+  // Reads compressed blocks from `input_stream`.  `options` must match the
+  // options the stream was written with (in particular the dictionary).
+  //
+  // Takes ownership of `input_stream` iff `owns_input_stream` is true.
+  ZstdInputStream(InputStreamInterface* input_stream,
+                  const ZstdCompressionOptions& options,
+                  bool owns_input_stream = false);
+
+  ~ZstdInputStream() override;
+
+  // Reads bytes_to_read bytes into *result, overwriting *result.
+  //
+  // Return Status codes:
+  // OK:           If successful.
+  // OUT_OF_RANGE: If there are not enough bytes to read before
+  //               the end of the stream.
+  // DATA_LOSS:    If decompression failed or the stream is corrupt.
+  // others:       If reading from the underlying stream failed.
+  Status ReadNBytes(int64 bytes_to_read, string* result) override;
+
+  // Returns the number of uncompressed bytes read so far.
+  int64 Tell() const override;
+
+  Status Reset() override;
+
+ private:
+  // Reads and decompresses the next block from the underlying stream into
+  // `cached_`.
+  Status Inflate();
+
+  InputStreamInterface* input_stream_;  // May be owned, see owns_input_stream_.
+  const ZstdCompressionOptions options_;
+  const bool owns_input_stream_;
+
+  // ZSTD_DCtx*; kept as void* so this header does not require zstd headers.
+  void* dctx_ = nullptr;
+
+  // Decompressed bytes not yet returned to the caller; cached_[cache_pos_, ...)
+  // is still unread.
+  string cached_;
+  size_t cache_pos_ = 0;
+
+  // Number of uncompressed bytes returned to callers so far.
+  int64 bytes_read_ = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ZstdInputStream);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_INPUTSTREAM_H_
@@ -0,0 +1,183 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/zstd/zstd_outputbuffer.h"
+
+#if defined(TF_USE_ZSTD)
+#include <zstd.h>
+#endif  // TF_USE_ZSTD
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace io {
+
+ZstdOutputBuffer::ZstdOutputBuffer(WritableFile* file,
+                                   const ZstdCompressionOptions& options)
+    : file_(file), options_(options) {
+  input_buffer_.reserve(options_.input_buffer_size);
+  output_buffer_.reserve(options_.output_buffer_size);
+}
+
+#if defined(TF_USE_ZSTD)
+
+bool ZstdOutputBuffer::IsSupported() { return true; }
+
+ZstdOutputBuffer::~ZstdOutputBuffer() {
+  if (cctx_ != nullptr) {
+    LOG(WARNING) << "Deleting ZstdOutputBuffer without calling Close(). Data "
+                    "might be lost.";
+    ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(cctx_));
+  }
+}
+
+Status ZstdOutputBuffer::Init() {
+  cctx_ = ZSTD_createCCtx();
+  if (cctx_ == nullptr) {
+    return errors::Internal("Failed to create zstd compression context");
+  }
+  return Status::OK();
+}
+
+Status ZstdOutputBuffer::Append(StringPiece data) {
+  if (closed_) {
+    return errors::FailedPrecondition("Stream already closed");
+  }
+  while (!data.empty()) {
+    const size_t available = options_.input_buffer_size - input_buffer_.size();
+    const size_t chunk = std::min<size_t>(available, data.size());
+    input_buffer_.append(data.data(), chunk);
+    data.remove_prefix(chunk);
+    if (input_buffer_.size() == static_cast<size_t>(options_.input_buffer_size)) {
+      TF_RETURN_IF_ERROR(DeflateBuffered());
+    }
+  }
+  return Status::OK();
+}
+
+Status ZstdOutputBuffer::DeflateBuffered() {
+  if (input_buffer_.empty()) {
+    return Status::OK();
+  }
+  // Each buffered chunk becomes one independent zstd frame, preceded by a
+  // 4 byte big endian length of the compressed frame.
+  const size_t bound = ZSTD_compressBound(input_buffer_.size());
+  string compressed;
+  compressed.resize(bound);
+  size_t compressed_size;
+  if (options_.dictionary.empty()) {
+    compressed_size = ZSTD_compressCCtx(
+        static_cast<ZSTD_CCtx*>(cctx_), &compressed[0], bound,
+        input_buffer_.data(), input_buffer_.size(), options_.compression_level);
+  } else {
+    compressed_size = ZSTD_compress_usingDict(
+        static_cast<ZSTD_CCtx*>(cctx_), &compressed[0], bound,
+        input_buffer_.data(), input_buffer_.size(), options_.dictionary.data(),
+        options_.dictionary.size(), options_.compression_level);
+  }
+  if (ZSTD_isError(compressed_size)) {
+    return errors::DataLoss("ZSTD_compress failed: ",
+                            ZSTD_getErrorName(compressed_size));
+  }
+  input_buffer_.clear();
+
+  char length[4];
+  length[0] = compressed_size >> 24;
+  length[1] = compressed_size >> 16;
+  length[2] = compressed_size >> 8;
+  length[3] = compressed_size;
+  TF_RETURN_IF_ERROR(AddToOutputBuffer(length, sizeof(length)));
+  return AddToOutputBuffer(compressed.data(), compressed_size);
+}
+
+Status ZstdOutputBuffer::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  TF_RETURN_IF_ERROR(DeflateBuffered());
+  TF_RETURN_IF_ERROR(FlushOutputBufferToFile());
+  ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(cctx_));
+  cctx_ = nullptr;
+  closed_ = true;
+  return Status::OK();
+}
+
+#else  // TF_USE_ZSTD
+
+bool ZstdOutputBuffer::IsSupported() { return false; }
+
+ZstdOutputBuffer::~ZstdOutputBuffer() {}
+
+Status ZstdOutputBuffer::Init() {
+  return errors::Unimplemented(
+      "Zstd compression is not supported in this build. Rebuild with "
+      "TF_USE_ZSTD and link against libzstd.");
+}
+
+Status ZstdOutputBuffer::Append(StringPiece data) { return Init(); }
+
+Status ZstdOutputBuffer::DeflateBuffered() { return Init(); }
+
+Status ZstdOutputBuffer::Close() { return Init(); }
+
+#endif  // TF_USE_ZSTD
+
+Status ZstdOutputBuffer::AddToOutputBuffer(const char* data, size_t length) {
+  while (length > 0) {
+    const size_t available =
+        options_.output_buffer_size - output_buffer_.size();
+    const size_t chunk = std::min<size_t>(available, length);
+    output_buffer_.append(data, chunk);
+    data += chunk;
+    length -= chunk;
+    if (output_buffer_.size() ==
+        static_cast<size_t>(options_.output_buffer_size)) {
+      TF_RETURN_IF_ERROR(FlushOutputBufferToFile());
+    }
+  }
+  return Status::OK();
+}
+
+Status ZstdOutputBuffer::FlushOutputBufferToFile() {
+  if (!output_buffer_.empty()) {
+    TF_RETURN_IF_ERROR(file_->Append(output_buffer_));
+    output_buffer_.clear();
+  }
+  return Status::OK();
+}
+
+Status ZstdOutputBuffer::Flush() {
+  if (closed_) {
+    return errors::FailedPrecondition("Stream already closed");
+  }
+  TF_RETURN_IF_ERROR(DeflateBuffered());
+  return FlushOutputBufferToFile();
+}
+
+Status ZstdOutputBuffer::Name(StringPiece* result) const {
+  return file_->Name(result);
+}
+
+Status ZstdOutputBuffer::Sync() {
+  TF_RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
+Status ZstdOutputBuffer::Tell(int64* position) { return file_->Tell(position); }
+
+}  // namespace io
+}  // namespace tensorflow
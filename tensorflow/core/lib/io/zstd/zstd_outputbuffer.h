@@ -0,0 +1,127 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_OUTPUTBUFFER_H_
+#define TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_OUTPUTBUFFER_H_
+
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/io/zstd/zstd_compression_options.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// Compresses input data with zstd (https://facebook.github.io/zstd/) and
+// writes it to `file`.
+//
+// Input data is collected in a buffer of size `input_buffer_size` (from the
+// options) and compressed as one block when the buffer fills up or the stream
+// is flushed.
+//
+// Output file format:
+// The file consists of a sequence of compressed blocks.  Each block starts
+// with a 4 byte header storing the length (in bytes) of the _compressed_
+// block excluding this header, followed by a complete, independent zstd
+// frame.  Because every frame is self-contained, blocks can be decompressed
+// in isolation, which keeps the format seekable at block granularity.
+//
+// Zstd support is compiled in only when the build defines TF_USE_ZSTD and
+// links against libzstd; otherwise Init() returns an Unimplemented error.
+//
+// A given instance of ZstdOutputBuffer is NOT safe for concurrent use by
+// multiple threads.
+class ZstdOutputBuffer : public WritableFile {
+ public:
+  // Does not take ownership of `file`.
+  ZstdOutputBuffer(WritableFile* file, const ZstdCompressionOptions& options);
+
+  ~ZstdOutputBuffer() override;
+
+  // Returns true if zstd support was compiled into this binary.
+  static bool IsSupported();
+
+  // Initializes the compression context.  This call is required before any
+  // other operation on the buffer.
+  Status Init();
+
+  // Adds `data` to the compression pipeline.
+  //
+  // The input data is buffered and compressed in bulk when the buffer gets
+  // full.  The compressed output may not be immediately written to file but
+  // rather cached in an output buffer that gets written when full.
+  //
+  // To immediately write contents to file call `Flush()`.
+  Status Append(StringPiece data) override;
+
+  // Compresses any cached input and writes all output to file.
+  Status Flush() override;
+
+  // Compresses any cached input and writes all output to file.  This must be
+  // called before the destructor to avoid any data loss.
+  //
+  // After calling this, any further calls to `Append()`, `Flush()` or
+  // `Close()` will fail.
+  Status Close() override;
+
+  // Returns the name of the underlying file.
+  Status Name(StringPiece* result) const override;
+
+  // Compresses any cached input, writes all output to file and syncs it.
+  Status Sync() override;
+
+  // Returns the write position in the underlying file.  The position does not
+  // reflect buffered, un-flushed data.
+  Status Tell(int64* position) override;
+
+ private:
+  // Compresses the contents of `input_buffer_` as one framed block and
+  // appends the result to `output_buffer_`, flushing the latter to file when
+  // it gets full.
+  Status DeflateBuffered();
+
+  // Appends `data` to `output_buffer_`, flushing buffer contents to file when
+  // the buffer gets full.
+  Status AddToOutputBuffer(const char* data, size_t length);
+
+  // Appends contents of `output_buffer_` to `file_`.
+  Status FlushOutputBufferToFile();
+
+  WritableFile* file_;  // Not owned.
+  const ZstdCompressionOptions options_;
+
+  // Uncompressed input pending compression.
+  string input_buffer_;
+
+  // Compressed output pending a write to `file_`.
+  string output_buffer_;
+
+  // ZSTD_CCtx*; kept as void* so this header does not require zstd headers.
+  void* cctx_ = nullptr;
+
+  bool closed_ = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ZstdOutputBuffer);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_ZSTD_ZSTD_OUTPUTBUFFER_H_
@@ -0,0 +1,44 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_MONITORING_CELL_STRIPES_H_
+#define TENSORFLOW_CORE_LIB_MONITORING_CELL_STRIPES_H_
+
+#include <atomic>
+
+namespace tensorflow {
+namespace monitoring {
+namespace internal {
+
+// Returns a stripe index in [0, num_stripes) that is stable for the calling
+// thread. Metric cells shard their hot-path state into stripes indexed by
+// this value, so that each thread updates its own stripe and updates stay
+// wait-free with no cache-line bouncing between threads; readers aggregate
+// across stripes at collection time.
+//
+// Threads are assigned stripes round-robin, so stripes are only shared once
+// more than num_stripes threads touch cells.
+inline int CellStripe(const int num_stripes) {
+  static std::atomic<int> next_stripe{0};
+  static thread_local const int stripe =
+      next_stripe.fetch_add(1, std::memory_order_relaxed);
+  return stripe % num_stripes;
+}
+
+}  // namespace internal
+}  // namespace monitoring
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_MONITORING_CELL_STRIPES_H_
@@ -32,6 +32,7 @@ limitations under the License.
 #include <map>
 
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/monitoring/cell_stripes.h"
 #include "tensorflow/core/lib/monitoring/collection_registry.h"
 #include "tensorflow/core/lib/monitoring/metric_def.h"
 #include "tensorflow/core/platform/logging.h"
@@ -50,21 +51,28 @@ namespace monitoring {
 // to which both cells belong) and performance (since map indexing and
 // associated locking are both avoided).
 //
-// This class is thread-safe.
+// This class is thread-safe. The value is striped across cache lines with
+// one stripe per thread (round-robin once there are more threads than
+// stripes), so concurrent increments are wait-free and do not contend;
+// value() aggregates the stripes and is intended for collection-time reads.
 class CounterCell {
  public:
-  explicit CounterCell(int64 value) : value_(value) {}
+  explicit CounterCell(int64 value) { stripes_[0].value = value; }
   ~CounterCell() {}
 
-  // Atomically increments the value by step.
+  // Increments the value by step, touching only the calling thread's stripe.
   // REQUIRES: Step be non-negative.
   void IncrementBy(int64 step);
 
-  // Retrieves the current value.
+  // Retrieves the current value, summed across all stripes.
   int64 value() const;
 
  private:
-  std::atomic<int64> value_;
+  static constexpr int kNumStripes = 16;
+  struct alignas(64) Stripe {
+    std::atomic<int64> value{0};
+  };
+  Stripe stripes_[kNumStripes];
 
   TF_DISALLOW_COPY_AND_ASSIGN(CounterCell);
 };
@@ -99,6 +107,10 @@ class Counter {
 
   // Retrieves the cell for the specified labels, creating it on demand if
   // not already present.
+  //
+  // The returned pointer stays valid for the lifetime of the Counter, so hot
+  // paths should look the cell up once (e.g. into a function-local static)
+  // rather than calling GetCell per update; the lookup takes a lock.
   template <typename... Labels>
   CounterCell* GetCell(const Labels&... labels) LOCKS_EXCLUDED(mu_);
 
@@ -147,10 +159,17 @@ class Counter {
 
 inline void CounterCell::IncrementBy(const int64 step) {
   DCHECK_LE(0, step) << "Must not decrement cumulative metrics.";
-  value_ += step;
+  stripes_[internal::CellStripe(kNumStripes)].value.fetch_add(
+      step, std::memory_order_relaxed);
 }
 
-inline int64 CounterCell::value() const { return value_; }
+inline int64 CounterCell::value() const {
+  int64 sum = 0;
+  for (const Stripe& stripe : stripes_) {
+    sum += stripe.value.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
 
 template <int NumLabels>
 template <typename... MetricDefArgs>
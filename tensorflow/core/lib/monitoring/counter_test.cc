@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/lib/monitoring/counter.h"
 
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -86,6 +88,27 @@ TEST(UnlabeledCounterDeathTest, DiesOnDecrement) {
       "decrement");
 }
 
+auto* concurrent_counter = Counter<0>::New(
+    "/tensorflow/test/concurrent_counter",
+    "Counter incremented from many threads at once.");
+
+TEST(UnlabeledCounterTest, ConcurrentIncrements) {
+  auto* cell = concurrent_counter->GetCell();
+  const int kNumThreads = 10;
+  const int kIncrementsPerThread = 1000;
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    for (int i = 0; i < kNumThreads; ++i) {
+      pool.Schedule([cell]() {
+        for (int j = 0; j < kIncrementsPerThread; ++j) {
+          cell->IncrementBy(1);
+        }
+      });
+    }
+  }
+  EXPECT_EQ(kNumThreads * kIncrementsPerThread, cell->value());
+}
+
 TEST(LabeledCounterTest, SameName) {
   auto* same_counter = Counter<1>::New("/tensorflow/test/counter_with_labels",
                                        "Counter with one label.", "MyLabel");
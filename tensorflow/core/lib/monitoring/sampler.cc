@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/lib/monitoring/sampler.h"
 
+#include <algorithm>
+
 // clang-format off
 // Required for IS_MOBILE_PLATFORM
 #include "tensorflow/core/platform/platform.h"
@@ -96,6 +98,27 @@ class ExponentialBuckets : public Buckets {
 
 }  // namespace
 
+HistogramProto SamplerCell::value() const {
+  HistogramProto pb;
+  stripes_[0]->EncodeToProto(&pb, true /* preserve_zero_buckets */);
+  for (int i = 1; i < kNumStripes; ++i) {
+    HistogramProto stripe_pb;
+    stripes_[i]->EncodeToProto(&stripe_pb, true /* preserve_zero_buckets */);
+    // All stripes share the same bucket limits, so merging is element-wise.
+    // An empty stripe reports min == DBL_MAX and max == -DBL_MAX, which the
+    // min/max folds below ignore naturally.
+    pb.set_min(std::min(pb.min(), stripe_pb.min()));
+    pb.set_max(std::max(pb.max(), stripe_pb.max()));
+    pb.set_num(pb.num() + stripe_pb.num());
+    pb.set_sum(pb.sum() + stripe_pb.sum());
+    pb.set_sum_squares(pb.sum_squares() + stripe_pb.sum_squares());
+    for (int b = 0; b < pb.bucket_size(); ++b) {
+      pb.set_bucket(b, pb.bucket(b) + stripe_pb.bucket(b));
+    }
+  }
+  return pb;
+}
+
 // static
 std::unique_ptr<Buckets> Buckets::Explicit(std::vector<double> bucket_limits) {
   return std::unique_ptr<Buckets>(
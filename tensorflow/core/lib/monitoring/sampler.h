@@ -34,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/histogram/histogram.h"
+#include "tensorflow/core/lib/monitoring/cell_stripes.h"
 #include "tensorflow/core/lib/monitoring/collection_registry.h"
 #include "tensorflow/core/lib/monitoring/metric_def.h"
 #include "tensorflow/core/platform/macros.h"
@@ -51,22 +52,32 @@ namespace monitoring {
 // to which both cells belong) and performance (since map indexing and
 // associated locking are both avoided).
 //
-// This class is thread-safe.
+// This class is thread-safe. Samples go into one of several histogram
+// stripes, one per thread (round-robin once there are more threads than
+// stripes), so the histogram lock taken by Add is effectively uncontended;
+// value() merges the stripes and is intended for collection-time reads.
 class SamplerCell {
  public:
-  SamplerCell(const std::vector<double>& bucket_limits)
-      : histogram_(bucket_limits) {}
+  explicit SamplerCell(const std::vector<double>& bucket_limits) {
+    stripes_.reserve(kNumStripes);
+    for (int i = 0; i < kNumStripes; ++i) {
+      stripes_.emplace_back(
+          new histogram::ThreadSafeHistogram(bucket_limits));
+    }
+  }
 
   ~SamplerCell() {}
 
-  // Atomically adds a sample.
+  // Adds a sample to the calling thread's stripe.
   void Add(double sample);
 
-  // Returns the current histogram value as a proto.
+  // Returns the current histogram value, merged across all stripes, as a
+  // proto.
   HistogramProto value() const;
 
  private:
-  histogram::ThreadSafeHistogram histogram_;
+  static constexpr int kNumStripes = 8;
+  std::vector<std::unique_ptr<histogram::ThreadSafeHistogram>> stripes_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(SamplerCell);
 };
@@ -136,6 +147,10 @@ class Sampler {
 
   // Retrieves the cell for the specified labels, creating it on demand if
   // not already present.
+  //
+  // The returned pointer stays valid for the lifetime of the Sampler, so hot
+  // paths should look the cell up once (e.g. into a function-local static)
+  // rather than calling GetCell per sample; the lookup takes a lock.
   template <typename... Labels>
   SamplerCell* GetCell(const Labels&... labels) LOCKS_EXCLUDED(mu_);
 
@@ -194,12 +209,8 @@ class Sampler {
 //  Implementation details follow. API readers may skip.
 ////
 
-inline void SamplerCell::Add(const double sample) { histogram_.Add(sample); }
-
-inline HistogramProto SamplerCell::value() const {
-  HistogramProto pb;
-  histogram_.EncodeToProto(&pb, true /* preserve_zero_buckets */);
-  return pb;
+inline void SamplerCell::Add(const double sample) {
+  stripes_[internal::CellStripe(kNumStripes)]->Add(sample);
 }
 
 template <int NumLabels>
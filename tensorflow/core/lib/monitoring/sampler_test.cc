@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/lib/monitoring/sampler.h"
 
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -112,6 +114,32 @@ TEST(ExponentialSamplerTest, ExponentialBucketBoundaries) {
   EqHistograms(expected, cell->value());
 }
 
+auto* concurrent_sampler =
+    Sampler<0>::New({"/tensorflow/test/concurrent_sampler",
+                     "Sampler with samples added from many threads at once."},
+                    Buckets::Explicit({1.0, 2.0}));
+
+TEST(UnlabeledSamplerTest, ConcurrentAdds) {
+  auto* cell = concurrent_sampler->GetCell();
+  const int kNumThreads = 10;
+  const int kAddsPerThread = 100;
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    for (int i = 0; i < kNumThreads; ++i) {
+      pool.Schedule([cell]() {
+        for (int j = 0; j < kAddsPerThread; ++j) {
+          cell->Add(1.5);
+        }
+      });
+    }
+  }
+  const HistogramProto value = cell->value();
+  EXPECT_EQ(kNumThreads * kAddsPerThread, value.num());
+  EXPECT_EQ(1.5 * kNumThreads * kAddsPerThread, value.sum());
+  EXPECT_EQ(1.5, value.min());
+  EXPECT_EQ(1.5, value.max());
+}
+
 TEST(ExplicitSamplerTest, SameName) {
   auto* same_sampler = Sampler<1>::New({"/tensorflow/test/sampler_with_labels",
                                         "Sampler with one label.", "MyLabel"},
@@ -32,6 +32,7 @@ REGISTER_OP("BatchFunction")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
     .Attr("batching_queue: string = ''")
+    .Attr("bucketize_by_shape: bool = false")
     .Attr("Tin: list(type)")
     .Attr("Tcaptured: list(type) >= 0")
     .Attr("Tout: list(type)")
@@ -82,6 +82,36 @@ REGISTER_OP("SparseAdd")
       return Status::OK();
     });
 
+REGISTER_OP("SparseTensorToCSRMatrix")
+    .Input("indices: int64")
+    .Input("values: T")
+    .Input("dense_shape: int64")
+    .Output("matrix: resource")
+    .Attr("T: {float, double}")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 2, &unused));  // indices
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &unused));  // values
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));  // dense_shape
+      c->set_output(0, c->Scalar());
+      return Status::OK();
+    });
+
+REGISTER_OP("CSRMatrixDenseMatMul")
+    .Input("matrix: resource")
+    .Input("b: T")
+    .Output("product: T")
+    .Attr("T: {float, double}")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle b;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 2, &b));
+      c->set_output(0, c->Matrix(InferenceContext::kUnknownDim, c->Dim(b, 1)));
+      return Status::OK();
+    });
+
 REGISTER_OP("SparseTensorDenseMatMul")
     .Input("a_indices: Tindices")
     .Input("a_values: T")
@@ -0,0 +1,194 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/caching_file_system.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/io/path.h"
+
+namespace tensorflow {
+
+CachingFileSystem::CachingFileSystem(
+    std::unique_ptr<FileSystem> base_file_system, const Options& options,
+    Env* env)
+    : base_file_system_(std::move(base_file_system)),
+      options_(options),
+      env_(env) {
+  stat_cache_.Configure(options_.max_age_seconds, options_.max_entries, env_);
+  listing_cache_.Configure(options_.max_age_seconds, options_.max_entries,
+                           env_);
+  matching_cache_.Configure(options_.max_age_seconds, options_.max_entries,
+                            env_);
+}
+
+bool CachingFileSystem::ShouldCache(const Status& status) const {
+  if (status.ok()) return true;
+  return options_.cache_negative_lookups &&
+         status.code() == error::NOT_FOUND;
+}
+
+Status CachingFileSystem::CachedStat(const string& fname,
+                                     bool allow_listing_probe,
+                                     StatEntry* entry) {
+  if (stat_cache_.Lookup(fname, entry)) {
+    return entry->status;
+  }
+  if (allow_listing_probe && options_.prefetch_sibling_metadata) {
+    // Answer the existence question from the parent's listing, fetching it
+    // once: the siblings a shard-discovery loop is about to probe get
+    // answered from the same listing.
+    const string dir(io::Dirname(fname));
+    std::vector<string> children;
+    if (!dir.empty() && GetChildren(dir, &children).ok()) {
+      const string base(io::Basename(fname));
+      if (std::find(children.begin(), children.end(), base) !=
+          children.end()) {
+        // Present, but the listing carries no statistics; leave the stat
+        // cache alone so a later Stat still fetches them.
+        entry->status = Status::OK();
+        return entry->status;
+      }
+      entry->status = errors::NotFound(fname, " not found");
+      if (ShouldCache(entry->status)) {
+        stat_cache_.Insert(fname, *entry);
+      }
+      return entry->status;
+    }
+  }
+  entry->status = base_file_system_->Stat(fname, &entry->stat);
+  if (ShouldCache(entry->status)) {
+    stat_cache_.Insert(fname, *entry);
+  }
+  return entry->status;
+}
+
+Status CachingFileSystem::Stat(const string& fname, FileStatistics* stat) {
+  StatEntry entry;
+  TF_RETURN_IF_ERROR(CachedStat(fname, false /* allow_listing_probe */,
+                                &entry));
+  *stat = entry.stat;
+  return Status::OK();
+}
+
+Status CachingFileSystem::FileExists(const string& fname) {
+  StatEntry entry;
+  return CachedStat(fname, true /* allow_listing_probe */, &entry);
+}
+
+Status CachingFileSystem::GetFileSize(const string& fname,
+                                      uint64* file_size) {
+  StatEntry entry;
+  TF_RETURN_IF_ERROR(CachedStat(fname, false /* allow_listing_probe */,
+                                &entry));
+  *file_size = entry.stat.length;
+  return Status::OK();
+}
+
+Status CachingFileSystem::GetChildren(const string& dir,
+                                      std::vector<string>* result) {
+  std::pair<Status, std::vector<string>> listing;
+  if (!listing_cache_.Lookup(dir, &listing)) {
+    listing.first = base_file_system_->GetChildren(dir, &listing.second);
+    if (ShouldCache(listing.first)) {
+      listing_cache_.Insert(dir, listing);
+    }
+  }
+  *result = listing.second;
+  return listing.first;
+}
+
+Status CachingFileSystem::GetMatchingPaths(const string& pattern,
+                                           std::vector<string>* result) {
+  std::pair<Status, std::vector<string>> matches;
+  if (!matching_cache_.Lookup(pattern, &matches)) {
+    matches.first = base_file_system_->GetMatchingPaths(pattern,
+                                                        &matches.second);
+    if (ShouldCache(matches.first)) {
+      matching_cache_.Insert(pattern, matches);
+    }
+  }
+  *result = matches.second;
+  return matches.first;
+}
+
+Status CachingFileSystem::NewRandomAccessFile(
+    const string& fname, std::unique_ptr<RandomAccessFile>* result) {
+  return base_file_system_->NewRandomAccessFile(fname, result);
+}
+
+Status CachingFileSystem::NewReadOnlyMemoryRegionFromFile(
+    const string& fname, std::unique_ptr<ReadOnlyMemoryRegion>* result) {
+  return base_file_system_->NewReadOnlyMemoryRegionFromFile(fname, result);
+}
+
+Status CachingFileSystem::IsDirectory(const string& fname) {
+  return base_file_system_->IsDirectory(fname);
+}
+
+Status CachingFileSystem::NewWritableFile(
+    const string& fname, std::unique_ptr<WritableFile>* result) {
+  InvalidatePath(fname);
+  return base_file_system_->NewWritableFile(fname, result);
+}
+
+Status CachingFileSystem::NewAppendableFile(
+    const string& fname, std::unique_ptr<WritableFile>* result) {
+  InvalidatePath(fname);
+  return base_file_system_->NewAppendableFile(fname, result);
+}
+
+Status CachingFileSystem::DeleteFile(const string& fname) {
+  InvalidatePath(fname);
+  return base_file_system_->DeleteFile(fname);
+}
+
+Status CachingFileSystem::CreateDir(const string& dirname) {
+  InvalidatePath(dirname);
+  return base_file_system_->CreateDir(dirname);
+}
+
+Status CachingFileSystem::DeleteDir(const string& dirname) {
+  InvalidatePath(dirname);
+  return base_file_system_->DeleteDir(dirname);
+}
+
+Status CachingFileSystem::RenameFile(const string& src, const string& target) {
+  InvalidatePath(src);
+  InvalidatePath(target);
+  return base_file_system_->RenameFile(src, target);
+}
+
+string CachingFileSystem::TranslateName(const string& name) const {
+  return base_file_system_->TranslateName(name);
+}
+
+void CachingFileSystem::InvalidatePath(const string& fname) {
+  stat_cache_.Delete(fname);
+  listing_cache_.Delete(fname);
+  listing_cache_.Delete(string(io::Dirname(fname)));
+  // Glob results cannot be invalidated per path; drop them wholesale.
+  matching_cache_.Clear();
+}
+
+void CachingFileSystem::FlushCaches() {
+  stat_cache_.Clear();
+  listing_cache_.Clear();
+  matching_cache_.Clear();
+  base_file_system_->FlushCaches();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,207 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_PLATFORM_CACHING_FILE_SYSTEM_H_
+#define TENSORFLOW_CORE_PLATFORM_CACHING_FILE_SYSTEM_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// A wrapper that caches metadata lookups of another file system.
+//
+// Stat, FileExists, GetFileSize, GetChildren and GetMatchingPaths results
+// are held in TTL-bound caches, including negative results (NOT_FOUND), so
+// repeated shard-discovery patterns — stat every shard, list the same
+// directories, re-evaluate the same glob — hit the backing store once per
+// TTL instead of once per call. When sibling prefetch is on, the first
+// existence probe in a directory lists the directory once and answers all
+// later probes for its siblings from that listing.
+//
+// Mutations issued through this wrapper (writes, deletes, renames, mkdir)
+// invalidate the affected entries and the parent's listing; writers that
+// bypass the wrapper can use InvalidatePath, and FlushCaches drops
+// everything. Within the TTL, changes made by other processes are not
+// visible — this trade-off is what makes the wrapper opt-in:
+//
+//   env->RegisterFileSystem("cached-gs", []() -> FileSystem* {
+//     return new CachingFileSystem(..., options, Env::Default());
+//   });
+class CachingFileSystem : public FileSystem {
+ public:
+  struct Options {
+    // How long cached entries stay valid, in seconds.
+    uint64 max_age_seconds = 60;
+    // Bound on the number of entries in each cache; least recently used
+    // entries are evicted first.
+    size_t max_entries = 1 << 16;
+    // If true, NOT_FOUND results are cached like successes.
+    bool cache_negative_lookups = true;
+    // If true, the first FileExists miss under a directory lists that
+    // directory and answers later probes for siblings from the listing.
+    bool prefetch_sibling_metadata = true;
+  };
+
+  CachingFileSystem(std::unique_ptr<FileSystem> base_file_system,
+                    const Options& options, Env* env);
+
+  ~CachingFileSystem() override = default;
+
+  // Cached metadata operations.
+  Status Stat(const string& fname, FileStatistics* stat) override;
+  Status FileExists(const string& fname) override;
+  Status GetFileSize(const string& fname, uint64* file_size) override;
+  Status GetChildren(const string& dir, std::vector<string>* result) override;
+  Status GetMatchingPaths(const string& pattern,
+                          std::vector<string>* result) override;
+
+  // Pass-throughs for reads.
+  Status NewRandomAccessFile(
+      const string& fname, std::unique_ptr<RandomAccessFile>* result) override;
+  Status NewReadOnlyMemoryRegionFromFile(
+      const string& fname,
+      std::unique_ptr<ReadOnlyMemoryRegion>* result) override;
+  Status IsDirectory(const string& fname) override;
+
+  // Mutations: forwarded to the base file system, invalidating affected
+  // cache entries on the way.
+  Status NewWritableFile(const string& fname,
+                         std::unique_ptr<WritableFile>* result) override;
+  Status NewAppendableFile(const string& fname,
+                           std::unique_ptr<WritableFile>* result) override;
+  Status DeleteFile(const string& fname) override;
+  Status CreateDir(const string& dirname) override;
+  Status DeleteDir(const string& dirname) override;
+  Status RenameFile(const string& src, const string& target) override;
+
+  string TranslateName(const string& name) const override;
+
+  // Drops the cached metadata for fname and its parent's listing. For use
+  // by writers that mutate the backing store without going through this
+  // wrapper.
+  void InvalidatePath(const string& fname);
+
+  // Drops all cached metadata and flushes the base file system's caches.
+  void FlushCaches() override;
+
+ private:
+  // A TTL-bound LRU map from path (or pattern) to T.
+  template <typename T>
+  class MetadataCache {
+   public:
+    void Configure(uint64 max_age_seconds, size_t max_entries, Env* env) {
+      max_age_seconds_ = max_age_seconds;
+      max_entries_ = max_entries;
+      env_ = env;
+    }
+
+    bool Lookup(const string& key, T* value) {
+      mutex_lock l(mu_);
+      const auto it = entries_.find(key);
+      if (it == entries_.end()) return false;
+      if (env_->NowSeconds() - it->second.insert_time_seconds >
+          max_age_seconds_) {
+        lru_.erase(it->second.lru_position);
+        entries_.erase(it);
+        return false;
+      }
+      lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+      *value = it->second.value;
+      return true;
+    }
+
+    void Insert(const string& key, const T& value) {
+      mutex_lock l(mu_);
+      const auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        lru_.erase(it->second.lru_position);
+        entries_.erase(it);
+      }
+      lru_.push_front(key);
+      entries_.emplace(
+          key, Entry{value, env_->NowSeconds(), lru_.begin()});
+      if (entries_.size() > max_entries_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+      }
+    }
+
+    void Delete(const string& key) {
+      mutex_lock l(mu_);
+      const auto it = entries_.find(key);
+      if (it == entries_.end()) return;
+      lru_.erase(it->second.lru_position);
+      entries_.erase(it);
+    }
+
+    void Clear() {
+      mutex_lock l(mu_);
+      entries_.clear();
+      lru_.clear();
+    }
+
+   private:
+    struct Entry {
+      T value;
+      uint64 insert_time_seconds;
+      std::list<string>::iterator lru_position;
+    };
+
+    uint64 max_age_seconds_ = 0;
+    size_t max_entries_ = 0;
+    Env* env_ = nullptr;
+    mutex mu_;
+    std::map<string, Entry> entries_ GUARDED_BY(mu_);
+    // Most recently used first.
+    std::list<string> lru_ GUARDED_BY(mu_);
+  };
+
+  // A stat outcome: OK with statistics, or a cached NOT_FOUND.
+  struct StatEntry {
+    Status status;
+    FileStatistics stat;
+  };
+
+  // Looks fname up in the stat cache, consulting the base file system (or,
+  // if allowed, the parent listing) on a miss.
+  Status CachedStat(const string& fname, bool allow_listing_probe,
+                    StatEntry* entry);
+
+  // True if the result of a metadata call should be cached.
+  bool ShouldCache(const Status& status) const;
+
+  const std::unique_ptr<FileSystem> base_file_system_;
+  const Options options_;
+  Env* const env_;
+
+  MetadataCache<StatEntry> stat_cache_;
+  MetadataCache<std::pair<Status, std::vector<string>>> listing_cache_;
+  MetadataCache<std::pair<Status, std::vector<string>>> matching_cache_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CachingFileSystem);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PLATFORM_CACHING_FILE_SYSTEM_H_
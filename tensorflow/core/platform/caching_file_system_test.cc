@@ -0,0 +1,212 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/caching_file_system.h"
+
+#include <map>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/null_file_system.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// An Env whose clock the test can advance, to exercise TTL expiry.
+class FakeClockEnv : public EnvWrapper {
+ public:
+  FakeClockEnv() : EnvWrapper(Env::Default()) {}
+  uint64 NowSeconds() const override { return now_seconds_; }
+  void AdvanceSeconds(uint64 seconds) { now_seconds_ += seconds; }
+
+ private:
+  uint64 now_seconds_ = 1000;
+};
+
+// An in-memory file system that counts metadata calls.
+class CountingFileSystem : public NullFileSystem {
+ public:
+  Status Stat(const string& fname, FileStatistics* stat) override {
+    ++stat_calls;
+    const auto it = files_.find(fname);
+    if (it == files_.end()) {
+      return errors::NotFound(fname, " not found");
+    }
+    stat->length = it->second;
+    return Status::OK();
+  }
+
+  Status FileExists(const string& fname) override {
+    FileStatistics stat;
+    return Stat(fname, &stat);
+  }
+
+  Status GetFileSize(const string& fname, uint64* file_size) override {
+    FileStatistics stat;
+    TF_RETURN_IF_ERROR(Stat(fname, &stat));
+    *file_size = stat.length;
+    return Status::OK();
+  }
+
+  Status GetChildren(const string& dir,
+                     std::vector<string>* result) override {
+    ++get_children_calls;
+    result->clear();
+    const string prefix = dir + "/";
+    for (const auto& file : files_) {
+      if (file.first.compare(0, prefix.size(), prefix) == 0) {
+        result->push_back(file.first.substr(prefix.size()));
+      }
+    }
+    return Status::OK();
+  }
+
+  Status DeleteFile(const string& fname) override {
+    files_.erase(fname);
+    return Status::OK();
+  }
+
+  void AddFile(const string& fname, uint64 length) { files_[fname] = length; }
+
+  int stat_calls = 0;
+  int get_children_calls = 0;
+
+ private:
+  std::map<string, uint64> files_;
+};
+
+CachingFileSystem::Options NoPrefetchOptions() {
+  CachingFileSystem::Options options;
+  options.prefetch_sibling_metadata = false;
+  return options;
+}
+
+TEST(CachingFileSystemTest, StatServedFromCache) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  base->AddFile("/dir/a", 42);
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base), NoPrefetchOptions(),
+                       &env);
+
+  FileStatistics stat;
+  TF_EXPECT_OK(fs.Stat("/dir/a", &stat));
+  EXPECT_EQ(42, stat.length);
+  uint64 size = 0;
+  TF_EXPECT_OK(fs.GetFileSize("/dir/a", &size));
+  EXPECT_EQ(42, size);
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  EXPECT_EQ(1, base->stat_calls);
+}
+
+TEST(CachingFileSystemTest, NegativeLookupsCached) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base), NoPrefetchOptions(),
+                       &env);
+
+  FileStatistics stat;
+  EXPECT_TRUE(errors::IsNotFound(fs.Stat("/dir/missing", &stat)));
+  EXPECT_TRUE(errors::IsNotFound(fs.FileExists("/dir/missing")));
+  EXPECT_EQ(1, base->stat_calls);
+}
+
+TEST(CachingFileSystemTest, EntriesExpireAfterTtl) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  base->AddFile("/dir/a", 1);
+  CachingFileSystem::Options options = NoPrefetchOptions();
+  options.max_age_seconds = 10;
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base), options, &env);
+
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  env.AdvanceSeconds(11);
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  EXPECT_EQ(2, base->stat_calls);
+}
+
+TEST(CachingFileSystemTest, SiblingPrefetchAnswersExistenceFromListing) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  base->AddFile("/dir/shard-00000", 1);
+  base->AddFile("/dir/shard-00001", 1);
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base),
+                       CachingFileSystem::Options(), &env);
+
+  TF_EXPECT_OK(fs.FileExists("/dir/shard-00000"));
+  TF_EXPECT_OK(fs.FileExists("/dir/shard-00001"));
+  EXPECT_TRUE(errors::IsNotFound(fs.FileExists("/dir/shard-00002")));
+  // All three probes were answered from a single listing of /dir.
+  EXPECT_EQ(1, base->get_children_calls);
+  EXPECT_EQ(0, base->stat_calls);
+}
+
+TEST(CachingFileSystemTest, GetChildrenCached) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  base->AddFile("/dir/a", 1);
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base), NoPrefetchOptions(),
+                       &env);
+
+  std::vector<string> children;
+  TF_EXPECT_OK(fs.GetChildren("/dir", &children));
+  EXPECT_EQ(1, children.size());
+  TF_EXPECT_OK(fs.GetChildren("/dir", &children));
+  EXPECT_EQ(1, base->get_children_calls);
+}
+
+TEST(CachingFileSystemTest, MutationsInvalidate) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  base->AddFile("/dir/a", 1);
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base), NoPrefetchOptions(),
+                       &env);
+
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  TF_EXPECT_OK(fs.DeleteFile("/dir/a"));
+  EXPECT_TRUE(errors::IsNotFound(fs.FileExists("/dir/a")));
+}
+
+TEST(CachingFileSystemTest, InvalidatePathDropsEntry) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  base->AddFile("/dir/a", 1);
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base), NoPrefetchOptions(),
+                       &env);
+
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  fs.InvalidatePath("/dir/a");
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  EXPECT_EQ(2, base->stat_calls);
+}
+
+TEST(CachingFileSystemTest, FlushCachesDropsEverything) {
+  FakeClockEnv env;
+  auto* base = new CountingFileSystem;
+  base->AddFile("/dir/a", 1);
+  CachingFileSystem fs(std::unique_ptr<FileSystem>(base), NoPrefetchOptions(),
+                       &env);
+
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  std::vector<string> children;
+  TF_EXPECT_OK(fs.GetChildren("/dir", &children));
+  fs.FlushCaches();
+  TF_EXPECT_OK(fs.FileExists("/dir/a"));
+  TF_EXPECT_OK(fs.GetChildren("/dir", &children));
+  EXPECT_EQ(2, base->stat_calls);
+  EXPECT_EQ(2, base->get_children_calls);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -86,6 +86,11 @@ class CurlHttpRequest : public HttpRequest {
   /// the given offset.
   Status SetPutFromFile(const string& body_filepath, size_t offset) override;
 
+  /// \brief Makes the request a PUT request.
+  ///
+  /// The request body will be taken from the specified buffer.
+  void SetPutFromBuffer(const char* buffer, size_t size) override;
+
   /// Makes the request a PUT request with an empty body.
   void SetPutEmptyBody() override;
 
@@ -42,6 +42,7 @@ class TestHttpRequest : public HttpRequest {
   Status SetPutFromFile(const string& body_filepath, size_t offset) override {
     return Status::OK();
   }
+  void SetPutFromBuffer(const char* buffer, size_t size) override {}
   void SetPutEmptyBody() override {}
   void SetPostFromBuffer(const char* buffer, size_t size) override {}
   void SetPostEmptyBody() override {}
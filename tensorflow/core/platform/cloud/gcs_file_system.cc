@@ -79,6 +79,17 @@ constexpr size_t kDefaultMaxCacheSize = 0;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that overrides the number of blocks fetched
+// speculatively ahead of a sequential reader. A value of 0 (the default)
+// disables readahead.
+constexpr char kReadaheadBlocks[] = "GCS_READ_CACHE_READAHEAD_BLOCKS";
+constexpr size_t kDefaultReadaheadBlocks = 0;
+// The environment variable that enables pipelined uploads and overrides the
+// chunk size used for them. Specified in MB and rounded to a multiple of
+// 256 KB as required by the GCS resumable upload API. A value of 0 (the
+// default) uploads the whole file on Flush()/Close(), after all appends.
+constexpr char kUploadChunkSize[] = "GCS_UPLOAD_CHUNK_SIZE_MB";
+constexpr size_t kDefaultUploadChunkSize = 0;
 // The environment variable that overrides the maximum age of entries in the
 // Stat cache. A value of 0 (the default) means nothing is cached.
 constexpr char kStatCacheMaxAge[] = "GCS_STAT_CACHE_MAX_AGE";
@@ -418,21 +429,25 @@ class BufferedGcsRandomAccessFile : public RandomAccessFile {
 /// \brief GCS-based implementation of a writeable file.
 ///
 /// Since GCS objects are immutable, this implementation writes to a local
-/// tmp file and copies it to GCS on flush/close.
+/// tmp file and copies it to GCS on flush/close. If `upload_chunk_size` is
+/// greater than zero, full chunks are additionally streamed to a resumable
+/// upload session from a background thread while the writer keeps appending,
+/// so that flush/close only has to upload the remaining tail.
 class GcsWritableFile : public WritableFile {
  public:
   GcsWritableFile(const string& bucket, const string& object,
                   GcsFileSystem* filesystem,
                   GcsFileSystem::TimeoutConfig* timeouts,
                   std::function<void()> file_cache_erase,
-                  RetryConfig retry_config)
+                  RetryConfig retry_config, size_t upload_chunk_size)
       : bucket_(bucket),
         object_(object),
         filesystem_(filesystem),
         timeouts_(timeouts),
         file_cache_erase_(std::move(file_cache_erase)),
         sync_needed_(true),
-        retry_config_(retry_config) {
+        retry_config_(retry_config),
+        upload_chunk_size_(upload_chunk_size) {
     // TODO: to make it safer, outfile_ should be constructed from an FD
     if (GetTmpFilename(&tmp_content_filename_).ok()) {
       outfile_.open(tmp_content_filename_,
@@ -449,20 +464,24 @@ class GcsWritableFile : public WritableFile {
                   GcsFileSystem* filesystem, const string& tmp_content_filename,
                   GcsFileSystem::TimeoutConfig* timeouts,
                   std::function<void()> file_cache_erase,
-                  RetryConfig retry_config)
+                  RetryConfig retry_config, size_t upload_chunk_size)
       : bucket_(bucket),
         object_(object),
         filesystem_(filesystem),
         timeouts_(timeouts),
         file_cache_erase_(std::move(file_cache_erase)),
         sync_needed_(true),
-        retry_config_(retry_config) {
+        retry_config_(retry_config),
+        upload_chunk_size_(upload_chunk_size) {
     tmp_content_filename_ = tmp_content_filename;
     outfile_.open(tmp_content_filename_,
                   std::ofstream::binary | std::ofstream::app);
   }
 
-  ~GcsWritableFile() override { Close().IgnoreError(); }
+  ~GcsWritableFile() override {
+    Close().IgnoreError();
+    StopUploadThread();
+  }
 
   Status Append(StringPiece data) override {
     TF_RETURN_IF_ERROR(CheckWritable());
@@ -472,12 +491,17 @@ class GcsWritableFile : public WritableFile {
       return errors::Internal(
           "Could not append to the internal temporary file.");
     }
+    if (upload_chunk_size_ > 0) {
+      TF_RETURN_IF_ERROR(MaybeUploadChunks());
+    }
     return Status::OK();
   }
 
   Status Close() override {
     if (outfile_.is_open()) {
-      TF_RETURN_IF_ERROR(Sync());
+      Status sync_status = Sync();
+      StopUploadThread();
+      TF_RETURN_IF_ERROR(sync_status);
       outfile_.close();
       std::remove(tmp_content_filename_.c_str());
     }
@@ -523,9 +547,17 @@ class GcsWritableFile : public WritableFile {
       return errors::Internal(
           "Could not write to the internal temporary file.");
     }
+    // If chunks have been streamed to a session in the background, finalize
+    // that session by uploading the remaining tail; otherwise upload the
+    // whole file to a new session.
     string session_uri;
-    TF_RETURN_IF_ERROR(CreateNewUploadSession(&session_uri));
-    uint64 already_uploaded = 0;
+    uint64 start_offset = 0;
+    TF_RETURN_IF_ERROR(WaitForPipelinedChunks(&session_uri, &start_offset));
+    if (session_uri.empty()) {
+      start_offset = 0;
+      TF_RETURN_IF_ERROR(CreateNewUploadSession(&session_uri));
+    }
+    uint64 already_uploaded = start_offset;
     bool first_attempt = true;
     const Status upload_status = RetryingUtils::CallWithRetries(
         [&first_attempt, &already_uploaded, &session_uri, this]() {
@@ -575,10 +607,12 @@ class GcsWritableFile : public WritableFile {
   }
 
   /// Initiates a new resumable upload session.
-  Status CreateNewUploadSession(string* session_uri) {
-    uint64 file_size;
-    TF_RETURN_IF_ERROR(GetCurrentFileSize(&file_size));
-
+  ///
+  /// If `announce_content_length` is false, the total object size is not
+  /// included in the request; this is required when chunks are streamed to
+  /// the session before the writer has finished appending.
+  Status CreateNewUploadSession(string* session_uri,
+                                bool announce_content_length = true) {
     std::vector<char> output_buffer;
     std::unique_ptr<HttpRequest> request;
     TF_RETURN_IF_ERROR(filesystem_->CreateHttpRequest(&request));
@@ -586,7 +620,11 @@ class GcsWritableFile : public WritableFile {
     request->SetUri(strings::StrCat(
         kGcsUploadUriBase, "b/", bucket_,
         "/o?uploadType=resumable&name=", request->EscapeString(object_)));
-    request->AddHeader("X-Upload-Content-Length", std::to_string(file_size));
+    if (announce_content_length) {
+      uint64 file_size;
+      TF_RETURN_IF_ERROR(GetCurrentFileSize(&file_size));
+      request->AddHeader("X-Upload-Content-Length", std::to_string(file_size));
+    }
     request->SetPostEmptyBody();
     request->SetResultBuffer(&output_buffer);
     request->SetTimeouts(timeouts_->connect, timeouts_->idle,
@@ -663,9 +701,16 @@ class GcsWritableFile : public WritableFile {
     TF_RETURN_IF_ERROR(filesystem_->CreateHttpRequest(&request));
     request->SetUri(session_uri);
     if (file_size > 0) {
-      request->AddHeader("Content-Range",
-                         strings::StrCat("bytes ", start_offset, "-",
-                                         file_size - 1, "/", file_size));
+      if (start_offset == file_size) {
+        // Everything was already streamed as chunks; this request only
+        // announces the total size to finalize the session.
+        request->AddHeader("Content-Range",
+                           strings::StrCat("bytes */", file_size));
+      } else {
+        request->AddHeader("Content-Range",
+                           strings::StrCat("bytes ", start_offset, "-",
+                                           file_size - 1, "/", file_size));
+      }
     }
     request->SetTimeouts(timeouts_->connect, timeouts_->idle, timeouts_->write);
 
@@ -678,6 +723,148 @@ class GcsWritableFile : public WritableFile {
     return Status::OK();
   }
 
+  /// If at least one full chunk has accumulated since the last hand-off,
+  /// passes it to the background worker for streaming to GCS.
+  Status MaybeUploadChunks() {
+    uint64 file_size;
+    TF_RETURN_IF_ERROR(GetCurrentFileSize(&file_size));
+    mutex_lock l(upload_mu_);
+    if (upload_cancelled_ || !upload_status_.ok()) {
+      // A chunk upload failed; Sync() will fall back to a whole-file upload.
+      return Status::OK();
+    }
+    if (file_size < upload_target_ + upload_chunk_size_) {
+      return Status::OK();
+    }
+    // The worker reads the handed-off range back from the temporary file, so
+    // the data must hit the filesystem before the hand-off.
+    outfile_.flush();
+    if (!outfile_.good()) {
+      return errors::Internal("Could not flush the internal temporary file.");
+    }
+    upload_target_ +=
+        (file_size - upload_target_) / upload_chunk_size_ * upload_chunk_size_;
+    if (!upload_thread_) {
+      upload_thread_.reset(Env::Default()->StartThread(
+          ThreadOptions(), "gcs_upload", [this]() { UploadChunkLoop(); }));
+    }
+    upload_cv_.notify_all();
+    return Status::OK();
+  }
+
+  /// Body of the background upload thread: streams handed-off chunks, in
+  /// order, to a resumable upload session. Stops at the first failed chunk;
+  /// Sync() then restarts with a whole-file upload.
+  void UploadChunkLoop() {
+    while (true) {
+      uint64 start, end;
+      string session_uri;
+      {
+        mutex_lock l(upload_mu_);
+        while (uploaded_ == upload_target_ && !upload_cancelled_) {
+          upload_cv_.wait(l);
+        }
+        if (upload_cancelled_) {
+          return;
+        }
+        start = uploaded_;
+        end = upload_target_;
+        session_uri = upload_session_uri_;
+      }
+      Status status;
+      if (session_uri.empty()) {
+        // The final object size is not known yet, so the session must be
+        // created without announcing a content length.
+        status = CreateNewUploadSession(&session_uri,
+                                        false /* announce_content_length */);
+      }
+      if (status.ok()) {
+        status = UploadChunkToSession(session_uri, start, end);
+      }
+      mutex_lock l(upload_mu_);
+      if (!status.ok()) {
+        upload_status_ = status;
+        upload_cv_.notify_all();
+        return;
+      }
+      upload_session_uri_ = session_uri;
+      uploaded_ = end;
+      upload_cv_.notify_all();
+    }
+  }
+
+  /// Uploads bytes [start, end) of the temporary file as one non-final chunk
+  /// of the given resumable upload session.
+  Status UploadChunkToSession(const string& session_uri, uint64 start,
+                              uint64 end) {
+    string chunk;
+    chunk.resize(end - start);
+    {
+      std::ifstream source(tmp_content_filename_, std::ifstream::binary);
+      source.seekg(start);
+      source.read(&chunk[0], chunk.size());
+      if (!source) {
+        return errors::Internal(
+            "Could not read back the internal temporary file.");
+      }
+    }
+    std::unique_ptr<HttpRequest> request;
+    TF_RETURN_IF_ERROR(filesystem_->CreateHttpRequest(&request));
+    request->SetUri(session_uri);
+    request->AddHeader("Content-Range", strings::StrCat("bytes ", start, "-",
+                                                        end - 1, "/*"));
+    request->SetTimeouts(timeouts_->connect, timeouts_->idle, timeouts_->write);
+    request->SetPutFromBuffer(chunk.data(), chunk.size());
+    const Status& status = request->Send();
+    // A "308 Resume Incomplete" response means the chunk was accepted and the
+    // session expects more data, which is exactly what a non-final chunk
+    // should produce.
+    if (!status.ok() &&
+        request->GetResponseCode() != HTTP_CODE_RESUME_INCOMPLETE) {
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(status, " when uploading ", GetGcsPath());
+    }
+    return Status::OK();
+  }
+
+  /// Waits until the background worker has drained its queue, then returns
+  /// the streaming session (if any) so that Sync() can finalize it with the
+  /// remaining tail of the file. If a chunk upload failed, the session is
+  /// abandoned and `session_uri` is left empty, making Sync() fall back to a
+  /// fresh whole-file upload. Either way, subsequent appends start a new
+  /// streaming session.
+  Status WaitForPipelinedChunks(string* session_uri, uint64* start_offset) {
+    if (upload_chunk_size_ == 0) {
+      return Status::OK();
+    }
+    mutex_lock l(upload_mu_);
+    while (upload_status_.ok() && uploaded_ < upload_target_) {
+      upload_cv_.wait(l);
+    }
+    if (upload_status_.ok()) {
+      *session_uri = upload_session_uri_;
+      *start_offset = uploaded_;
+    } else {
+      LOG(WARNING) << "Streaming upload of " << GetGcsPath()
+                   << " failed: " << upload_status_
+                   << ". Falling back to a whole-file upload.";
+    }
+    upload_session_uri_.clear();
+    upload_target_ = 0;
+    uploaded_ = 0;
+    upload_status_ = Status::OK();
+    return Status::OK();
+  }
+
+  /// Stops the background upload thread, if it was started.
+  void StopUploadThread() {
+    {
+      mutex_lock l(upload_mu_);
+      upload_cancelled_ = true;
+      upload_cv_.notify_all();
+    }
+    upload_thread_.reset();  // Joins the thread.
+  }
+
   string GetGcsPath() const {
     return strings::StrCat("gs://", bucket_, "/", object_);
   }
@@ -691,6 +878,22 @@ class GcsWritableFile : public WritableFile {
   std::function<void()> file_cache_erase_;
   bool sync_needed_;  // whether there is buffered data that needs to be synced
   RetryConfig retry_config_;
+
+  /// Chunk size for streaming uploads; 0 disables streaming. Non-final
+  /// chunks of a resumable upload must be multiples of 256 KB.
+  const size_t upload_chunk_size_;
+  mutex upload_mu_;
+  condition_variable upload_cv_;
+  /// Offset up to which data has been handed to the upload thread, and the
+  /// offset up to which it has actually been uploaded.
+  uint64 upload_target_ GUARDED_BY(upload_mu_) = 0;
+  uint64 uploaded_ GUARDED_BY(upload_mu_) = 0;
+  /// The resumable upload session chunks are streamed to, once created.
+  string upload_session_uri_ GUARDED_BY(upload_mu_);
+  /// The first error encountered by the upload thread, if any.
+  Status upload_status_ GUARDED_BY(upload_mu_);
+  bool upload_cancelled_ GUARDED_BY(upload_mu_) = false;
+  std::unique_ptr<Thread> upload_thread_;
 };
 
 class GcsReadOnlyMemoryRegion : public ReadOnlyMemoryRegion {
@@ -771,9 +974,23 @@ GcsFileSystem::GcsFileSystem() {
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
+
+  readahead_blocks_ = kDefaultReadaheadBlocks;
+  if (GetEnvVar(kReadaheadBlocks, strings::safe_strtou64, &value)) {
+    readahead_blocks_ = value;
+  }
+
+  upload_chunk_size_ = kDefaultUploadChunkSize;
+  if (GetEnvVar(kUploadChunkSize, strings::safe_strtou64, &value)) {
+    // The GCS API requires non-final chunks of a resumable upload to be
+    // multiples of 256 KB.
+    upload_chunk_size_ = (value * 1024 * 1024 / (256 * 1024)) * (256 * 1024);
+  }
+
   VLOG(1) << "GCS cache max size = " << max_bytes << " ; "
           << "block size = " << block_size_ << " ; "
-          << "max staleness = " << max_staleness;
+          << "max staleness = " << max_staleness << " ; "
+          << "readahead blocks = " << readahead_blocks_;
   file_block_cache_ = MakeFileBlockCache(block_size_, max_bytes, max_staleness);
   // Apply overrides for the stat cache max age and max entries, if provided.
   uint64 stat_cache_max_age = kStatCacheDefaultMaxAge;
@@ -995,7 +1212,8 @@ std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
              size_t* bytes_transferred) {
         return LoadBufferFromGCS(filename, offset, n, buffer,
                                  bytes_transferred);
-      }));
+      },
+      readahead_blocks_));
   return file_block_cache;
 }
 
@@ -1067,7 +1285,7 @@ Status GcsFileSystem::NewWritableFile(const string& fname,
   TF_RETURN_IF_ERROR(ParseGcsPath(fname, false, &bucket, &object));
   result->reset(new GcsWritableFile(bucket, object, this, &timeouts_,
                                     [this, fname]() { ClearFileCaches(fname); },
-                                    retry_config_));
+                                    retry_config_, upload_chunk_size_));
   return Status::OK();
 }
 
@@ -1107,7 +1325,8 @@ Status GcsFileSystem::NewAppendableFile(const string& fname,
   TF_RETURN_IF_ERROR(ParseGcsPath(fname, false, &bucket, &object));
   result->reset(new GcsWritableFile(
       bucket, object, this, old_content_filename, &timeouts_,
-      [this, fname]() { ClearFileCaches(fname); }, retry_config_));
+      [this, fname]() { ClearFileCaches(fname); }, retry_config_,
+      upload_chunk_size_));
   return Status::OK();
 }
 
@@ -312,6 +312,15 @@ class GcsFileSystem : public FileSystem {
   // Reads smaller than block_size_ will trigger a read of block_size_.
   uint64 block_size_;
 
+  // Number of blocks the block cache fetches speculatively ahead of a
+  // sequential reader; 0 disables readahead. Must be declared before
+  // file_block_cache_, which is built from it.
+  size_t readahead_blocks_ = 0;
+
+  // Chunk size for pipelined resumable uploads; 0 means whole-file uploads on
+  // Flush()/Close(). Always a multiple of 256 KB when non-zero.
+  size_t upload_chunk_size_ = 0;
+
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
@@ -125,6 +125,11 @@ class HttpRequest {
   /// the given offset.
   virtual Status SetPutFromFile(const string& body_filepath, size_t offset) = 0;
 
+  /// \brief Makes the request a PUT request.
+  ///
+  /// The request body will be taken from the specified buffer.
+  virtual void SetPutFromBuffer(const char* buffer, size_t size) = 0;
+
   /// Makes the request a PUT request with an empty body.
   virtual void SetPutEmptyBody() = 0;
 
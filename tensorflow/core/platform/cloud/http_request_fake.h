@@ -96,6 +96,10 @@ class FakeHttpRequest : public CurlHttpRequest {
     actual_request_ += "Put body: " + content + "\n";
     return Status::OK();
   }
+  void SetPutFromBuffer(const char* buffer, size_t size) override {
+    actual_request_ +=
+        strings::StrCat("Put body: ", StringPiece(buffer, size), "\n");
+  }
   void SetPostFromBuffer(const char* buffer, size_t size) override {
     if (captured_post_body_) {
       *captured_post_body_ = string(buffer, size);
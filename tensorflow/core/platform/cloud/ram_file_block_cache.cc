@@ -177,6 +177,7 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
     finish += block_size_;
   }
   size_t total_bytes_transferred = 0;
+  bool hit_eof = false;
   // Now iterate through the blocks, reading them one at a time.
   for (size_t pos = start; pos < finish; pos += block_size_) {
     Key key = std::make_pair(filename, pos);
@@ -214,13 +215,59 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
     }
     if (data.size() < block_size_) {
       // The block was a partial block and thus signals EOF at its upper bound.
+      hit_eof = true;
       break;
     }
   }
+  if (readahead_pool_ && !hit_eof) {
+    ScheduleReadahead(filename, offset, offset + n, finish);
+  }
   *bytes_transferred = total_bytes_transferred;
   return Status::OK();
 }
 
+void RamFileBlockCache::ScheduleReadahead(const string& filename, size_t offset,
+                                          size_t read_end, size_t next_block) {
+  size_t start, end;
+  {
+    mutex_lock lock(mu_);
+    ReadaheadState& state = readahead_state_[filename];
+    const bool sequential = offset == state.next_offset;
+    state.next_offset = read_end;
+    if (!sequential) {
+      // The scan position moved; previously scheduled blocks are stale.
+      state.scheduled_end = 0;
+      return;
+    }
+    end = next_block + readahead_blocks_ * block_size_;
+    start = std::max(next_block, state.scheduled_end);
+    if (start >= end) {
+      return;
+    }
+    state.scheduled_end = end;
+  }
+  readahead_pool_->Schedule([this, filename, start, end]() {
+    // Fetch the blocks in file order, stopping at the first partial block or
+    // error: a partial block signals EOF, and blocks past it must not be
+    // inserted since the cache treats a partial block followed by a block at a
+    // higher offset as corruption. A foreground read of a failed block will
+    // rediscover the error by fetching it itself.
+    for (size_t pos = start; pos < end; pos += block_size_) {
+      Key key = std::make_pair(filename, pos);
+      std::shared_ptr<Block> block = Lookup(key);
+      if (!MaybeFetch(key, block).ok() || !UpdateLRU(key, block).ok() ||
+          block->data.size() < block_size_) {
+        mutex_lock lock(mu_);
+        auto it = readahead_state_.find(filename);
+        if (it != readahead_state_.end() && it->second.scheduled_end == end) {
+          it->second.scheduled_end = pos;
+        }
+        return;
+      }
+    }
+  });
+}
+
 bool RamFileBlockCache::ValidateAndUpdateFileSignature(const string& filename,
                                                        int64 file_signature) {
   mutex_lock lock(mu_);
@@ -265,6 +312,7 @@ void RamFileBlockCache::Flush() {
   block_map_.clear();
   lru_list_.clear();
   lra_list_.clear();
+  readahead_state_.clear();
   cache_size_ = 0;
 }
 
@@ -274,6 +322,7 @@ void RamFileBlockCache::RemoveFile(const string& filename) {
 }
 
 void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
+  readahead_state_.erase(filename);
   Key begin = std::make_pair(filename, 0);
   auto it = block_map_.lower_bound(begin);
   while (it != block_map_.end() && it->first.first == filename) {
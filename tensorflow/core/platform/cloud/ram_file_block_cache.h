@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 #define TENSORFLOW_CORE_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 
+#include <algorithm>
 #include <functional>
 #include <list>
 #include <map>
@@ -24,6 +25,7 @@ limitations under the License.
 #include <vector>
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/cloud/file_block_cache.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -49,22 +51,35 @@ class RamFileBlockCache : public FileBlockCache {
                                size_t* bytes_transferred)>
       BlockFetcher;
 
+  /// If `readahead_blocks` is greater than zero, sequential reads through the
+  /// cache speculatively fetch up to that many blocks past the current read
+  /// position from a background thread pool, so that the next reads are served
+  /// from memory.
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
-                    BlockFetcher block_fetcher, Env* env = Env::Default())
+                    BlockFetcher block_fetcher, size_t readahead_blocks = 0,
+                    Env* env = Env::Default())
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
         block_fetcher_(block_fetcher),
+        readahead_blocks_(readahead_blocks),
         env_(env) {
     if (max_staleness_ > 0) {
       pruning_thread_.reset(env_->StartThread(ThreadOptions(), "TF_prune_FBC",
                                               [this] { Prune(); }));
     }
+    if (readahead_blocks_ > 0 && IsCacheEnabled()) {
+      readahead_pool_.reset(
+          new thread::ThreadPool(env_, "TF_gcs_readahead",
+                                 std::min<size_t>(readahead_blocks_, 16)));
+    }
     VLOG(1) << "GCS file block cache is "
             << (IsCacheEnabled() ? "enabled" : "disabled");
   }
 
   ~RamFileBlockCache() override {
+    // Drain pending readahead work before tearing down the block map.
+    readahead_pool_.reset();
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -128,6 +143,8 @@ class RamFileBlockCache : public FileBlockCache {
   const uint64 max_staleness_;
   /// The callback to read a block from the underlying filesystem.
   const BlockFetcher block_fetcher_;
+  /// The number of blocks to speculatively fetch ahead of a sequential reader.
+  const size_t readahead_blocks_;
   /// The Env from which we read timestamps.
   Env* const env_;  // not owned
 
@@ -213,6 +230,11 @@ class RamFileBlockCache : public FileBlockCache {
   /// cache size accordingly.
   void RemoveBlock(BlockMap::iterator entry) EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// If the read `[offset, read_end)` of `filename` continues a sequential
+  /// scan, schedule a background fetch of the blocks starting at `next_block`.
+  void ScheduleReadahead(const string& filename, size_t offset, size_t read_end,
+                         size_t next_block) LOCKS_EXCLUDED(mu_);
+
   /// The cache pruning thread that removes files with expired blocks.
   std::unique_ptr<Thread> pruning_thread_;
 
@@ -241,6 +263,24 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64> file_signature_map_ GUARDED_BY(mu_);
+
+  /// \brief Per-file readahead bookkeeping.
+  ///
+  /// `next_offset` is the byte offset at which a read is considered to
+  /// continue a sequential scan; `scheduled_end` is the upper bound of the
+  /// blocks already handed to the readahead pool, to avoid rescheduling the
+  /// same blocks on every read.
+  struct ReadaheadState {
+    size_t next_offset = 0;
+    size_t scheduled_end = 0;
+  };
+
+  /// Sequential access tracking for readahead, keyed by filename.
+  std::map<string, ReadaheadState> readahead_state_ GUARDED_BY(mu_);
+
+  /// The pool executing speculative block fetches. Destroyed first so that
+  /// in-flight readahead work drains before the rest of the cache state.
+  std::unique_ptr<thread::ThreadPool> readahead_pool_;
 };
 
 }  // namespace tensorflow
@@ -324,7 +324,8 @@ TEST(RamFileBlockCacheTest, MaxStaleness) {
   std::unique_ptr<NowSecondsEnv> env(new NowSecondsEnv);
   // Create a cache with max staleness of 2 seconds, and verify that it works as
   // expected.
-  RamFileBlockCache cache1(8, 16, 2 /* max staleness */, fetcher, env.get());
+  RamFileBlockCache cache1(8, 16, 2 /* max staleness */, fetcher,
+                           0 /* readahead_blocks */, env.get());
   // Execute the first read to load the block.
   TF_EXPECT_OK(ReadCache(&cache1, "", 0, 1, &out));
   EXPECT_EQ(calls, 1);
@@ -340,7 +341,8 @@ TEST(RamFileBlockCacheTest, MaxStaleness) {
   // as expected.
   calls = 0;
   env->SetNowSeconds(0);
-  RamFileBlockCache cache2(8, 16, 0 /* max staleness */, fetcher, env.get());
+  RamFileBlockCache cache2(8, 16, 0 /* max staleness */, fetcher,
+                           0 /* readahead_blocks */, env.get());
   // Execute the first read to load the block.
   TF_EXPECT_OK(ReadCache(&cache2, "", 0, 1, &out));
   EXPECT_EQ(calls, 1);
@@ -427,7 +429,8 @@ TEST(RamFileBlockCacheTest, Prune) {
   std::unique_ptr<NowSecondsEnv> env(new NowSecondsEnv);
   uint64 now = Env::Default()->NowSeconds();
   env->SetNowSeconds(now);
-  RamFileBlockCache cache(8, 32, 1 /* max staleness */, fetcher, env.get());
+  RamFileBlockCache cache(8, 32, 1 /* max staleness */, fetcher,
+                          0 /* readahead_blocks */, env.get());
   // Read three blocks into the cache, and advance the timestamp by one second
   // with each read. Start with a block of "a" at the current timestamp `now`.
   TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
@@ -560,5 +563,54 @@ TEST(RamFileBlockCacheTest, Flush) {
   EXPECT_EQ(calls, 2);
 }
 
+TEST(RamFileBlockCacheTest, Readahead) {
+  const size_t block_size = 8;
+  const size_t file_size = 32;
+  mutex mu;
+  std::set<size_t> fetched;
+  auto fetcher = [&mu, &fetched, file_size](const string& filename,
+                                            size_t offset, size_t n,
+                                            char* buffer,
+                                            size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      fetched.insert(offset);
+    }
+    if (offset < file_size) {
+      size_t bytes_to_copy = std::min(file_size - offset, n);
+      memset(buffer, 'x', bytes_to_copy);
+      *bytes_transferred = bytes_to_copy;
+    } else {
+      *bytes_transferred = 0;
+    }
+    return Status::OK();
+  };
+  RamFileBlockCache cache(block_size, file_size, 0, fetcher,
+                          2 /* readahead_blocks */);
+  std::vector<char> out;
+  // A read starting at offset 0 begins a sequential scan, so the two blocks
+  // past the read should be fetched in the background.
+  TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+  EXPECT_EQ(out.size(), block_size);
+  uint64 start = Env::Default()->NowSeconds();
+  bool readahead_done = false;
+  do {
+    Env::Default()->SleepForMicroseconds(1000);
+    mutex_lock l(mu);
+    readahead_done = fetched.count(block_size) > 0 &&
+                     fetched.count(2 * block_size) > 0;
+  } while (!readahead_done && Env::Default()->NowSeconds() - start < 10);
+  {
+    mutex_lock l(mu);
+    EXPECT_EQ(fetched.count(block_size), 1);
+    EXPECT_EQ(fetched.count(2 * block_size), 1);
+    // The readahead must not run past the blocks it was asked to fetch.
+    EXPECT_EQ(fetched.count(3 * block_size), 0);
+  }
+  // The readahead blocks should now be served from the cache.
+  TF_EXPECT_OK(ReadCache(&cache, "", block_size, 2 * block_size, &out));
+  EXPECT_EQ(out.size(), 2 * block_size);
+}
+
 }  // namespace
 }  // namespace tensorflow
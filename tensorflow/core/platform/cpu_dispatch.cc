@@ -0,0 +1,93 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/cpu_dispatch.h"
+
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+#include "absl/strings/str_split.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace port {
+namespace {
+
+// Choices made so far, for CpuDispatchDebugString.
+struct DispatchChoices {
+  mutex mu;
+  std::map<string, string> choices GUARDED_BY(mu);
+};
+
+DispatchChoices* GlobalDispatchChoices() {
+  static DispatchChoices* choices = new DispatchChoices;
+  return choices;
+}
+
+// Parsed TF_CPU_DISPATCH_OVERRIDE: "Name=variant,Other=variant".
+const std::map<string, string>& DispatchOverrides() {
+  static const std::map<string, string>* overrides = []() {
+    auto* result = new std::map<string, string>;
+    const char* env = std::getenv("TF_CPU_DISPATCH_OVERRIDE");
+    if (env != nullptr) {
+      for (const absl::string_view entry : absl::StrSplit(env, ',')) {
+        const std::vector<string> parts = absl::StrSplit(entry, '=');
+        if (parts.size() == 2) {
+          (*result)[parts[0]] = parts[1];
+        } else if (!entry.empty()) {
+          LOG(WARNING) << "Ignoring malformed TF_CPU_DISPATCH_OVERRIDE "
+                       << "entry: " << entry;
+        }
+      }
+    }
+    return result;
+  }();
+  return *overrides;
+}
+
+}  // namespace
+
+namespace internal {
+
+string CpuDispatchOverrideFor(const string& name) {
+  const auto& overrides = DispatchOverrides();
+  const auto it = overrides.find(name);
+  return it == overrides.end() ? string() : it->second;
+}
+
+void RecordCpuDispatchChoice(const string& name, const string& variant) {
+  VLOG(1) << "CPU dispatch: " << name << " -> " << variant;
+  DispatchChoices* choices = GlobalDispatchChoices();
+  mutex_lock l(choices->mu);
+  choices->choices[name] = variant;
+}
+
+}  // namespace internal
+
+string CpuDispatchDebugString() {
+  DispatchChoices* choices = GlobalDispatchChoices();
+  mutex_lock l(choices->mu);
+  string out;
+  for (const auto& choice : choices->choices) {
+    strings::StrAppend(&out, choice.first, ": ", choice.second, "\n");
+  }
+  return out;
+}
+
+}  // namespace port
+}  // namespace tensorflow
@@ -0,0 +1,132 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_PLATFORM_CPU_DISPATCH_H_
+#define TENSORFLOW_CORE_PLATFORM_CPU_DISPATCH_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace port {
+
+// Uniform runtime dispatch over CPU-feature-specific implementations.
+//
+// A routine with SIMD variants declares one dispatcher, listing variants
+// best-first, and resolves it once into a direct function pointer:
+//
+//   void ConvertScalar(const float* src, uint16* dst, int64 n);
+//   void ConvertAvx2(const float* src, uint16* dst, int64 n);
+//
+//   void Convert(const float* src, uint16* dst, int64 n) {
+//     static const auto* fn =
+//         CpuDispatcher<decltype(&ConvertScalar)>("Convert", "scalar",
+//                                                 &ConvertScalar)
+//             .AddVariant(CPUFeature::AVX2, "avx2", &ConvertAvx2)
+//             .Resolve();
+//     fn(src, dst, n);
+//   }
+//
+// After resolution the call costs a load and an indirect call; no feature
+// test runs on the hot path. The first variant whose required feature the
+// host supports wins; the fallback needs no feature and always applies.
+//
+// For A/B testing, TF_CPU_DISPATCH_OVERRIDE=Convert=scalar,Other=avx2
+// forces named variants (ignored with a warning if the variant is missing
+// or unsupported on the host). Each resolution is logged, and
+// CpuDispatchDebugString() returns the full list of choices made so far
+// for startup logging.
+
+namespace internal {
+// Returns the variant name forced for dispatcher `name` by
+// TF_CPU_DISPATCH_OVERRIDE, or the empty string.
+string CpuDispatchOverrideFor(const string& name);
+// Records (for CpuDispatchDebugString) and logs the resolved choice.
+void RecordCpuDispatchChoice(const string& name, const string& variant);
+}  // namespace internal
+
+// One line per resolved dispatcher: "<name>: <variant>".
+string CpuDispatchDebugString();
+
+template <typename FnPtr>
+class CpuDispatcher {
+ public:
+  // The fallback runs on any host and is chosen when nothing better is
+  // supported.
+  CpuDispatcher(string name, string fallback_name, FnPtr fallback)
+      : name_(std::move(name)),
+        fallback_name_(std::move(fallback_name)),
+        fallback_(fallback) {}
+
+  // Registers a variant requiring `feature`. Variants are considered in
+  // registration order, so list the best (widest) one first.
+  CpuDispatcher& AddVariant(CPUFeature feature, string variant_name,
+                            FnPtr fn) {
+    variants_.push_back(Variant{std::move(variant_name), fn, feature});
+    return *this;
+  }
+
+  // Picks the variant to use on this host, records and logs the choice, and
+  // returns its function pointer. Call once and cache the result.
+  FnPtr Resolve() const {
+    const string override_name = internal::CpuDispatchOverrideFor(name_);
+    if (!override_name.empty()) {
+      for (const Variant& variant : variants_) {
+        if (variant.name == override_name &&
+            TestCPUFeature(variant.feature)) {
+          internal::RecordCpuDispatchChoice(name_, variant.name);
+          return variant.fn;
+        }
+      }
+      if (fallback_name_ == override_name) {
+        internal::RecordCpuDispatchChoice(name_, fallback_name_);
+        return fallback_;
+      }
+      LOG(WARNING) << "TF_CPU_DISPATCH_OVERRIDE requests variant \""
+                   << override_name << "\" of \"" << name_
+                   << "\", which is not registered or not supported on "
+                      "this CPU; ignoring.";
+    }
+    for (const Variant& variant : variants_) {
+      if (TestCPUFeature(variant.feature)) {
+        internal::RecordCpuDispatchChoice(name_, variant.name);
+        return variant.fn;
+      }
+    }
+    internal::RecordCpuDispatchChoice(name_, fallback_name_);
+    return fallback_;
+  }
+
+ private:
+  struct Variant {
+    string name;
+    FnPtr fn;
+    CPUFeature feature;
+  };
+
+  const string name_;
+  const string fallback_name_;
+  const FnPtr fallback_;
+  std::vector<Variant> variants_;
+};
+
+}  // namespace port
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PLATFORM_CPU_DISPATCH_H_
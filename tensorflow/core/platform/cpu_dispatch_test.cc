@@ -0,0 +1,80 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/cpu_dispatch.h"
+
+#include <cstdlib>
+
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace port {
+namespace {
+
+// The override environment variable is parsed once per process, so it must
+// be in place before the first dispatcher resolves.
+const bool kOverridesInstalled = []() {
+  setenv("TF_CPU_DISPATCH_OVERRIDE",
+         "Overridden=scalar,BadVariant=missing,malformed", 1 /* overwrite */);
+  return true;
+}();
+
+int Scalar() { return 1; }
+int Avx2() { return 2; }
+
+typedef int (*TestFn)();
+
+TEST(CpuDispatchTest, PicksBestSupportedVariant) {
+  const TestFn fn = CpuDispatcher<TestFn>("BestSupported", "scalar", Scalar)
+                        .AddVariant(CPUFeature::AVX2, "avx2", Avx2)
+                        .Resolve();
+  const int expected = TestCPUFeature(CPUFeature::AVX2) ? 2 : 1;
+  EXPECT_EQ(expected, fn());
+}
+
+TEST(CpuDispatchTest, FallbackWithoutVariants) {
+  const TestFn fn =
+      CpuDispatcher<TestFn>("FallbackOnly", "scalar", Scalar).Resolve();
+  EXPECT_EQ(1, fn());
+}
+
+TEST(CpuDispatchTest, OverrideForcesVariant) {
+  ASSERT_TRUE(kOverridesInstalled);
+  const TestFn fn = CpuDispatcher<TestFn>("Overridden", "scalar", Scalar)
+                        .AddVariant(CPUFeature::AVX2, "avx2", Avx2)
+                        .Resolve();
+  // Even on AVX2 hosts the override forces the fallback.
+  EXPECT_EQ(1, fn());
+}
+
+TEST(CpuDispatchTest, UnknownOverrideIgnored) {
+  ASSERT_TRUE(kOverridesInstalled);
+  const TestFn fn = CpuDispatcher<TestFn>("BadVariant", "scalar", Scalar)
+                        .AddVariant(CPUFeature::AVX2, "avx2", Avx2)
+                        .Resolve();
+  const int expected = TestCPUFeature(CPUFeature::AVX2) ? 2 : 1;
+  EXPECT_EQ(expected, fn());
+}
+
+TEST(CpuDispatchTest, DebugStringListsChoices) {
+  CpuDispatcher<TestFn>("ListedInDebugString", "scalar", Scalar).Resolve();
+  EXPECT_TRUE(str_util::StrContains(CpuDispatchDebugString(),
+                                    "ListedInDebugString: scalar"));
+}
+
+}  // namespace
+}  // namespace port
+}  // namespace tensorflow
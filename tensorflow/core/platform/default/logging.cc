@@ -27,12 +27,142 @@ limitations under the License.
 #include <string.h>
 #include <time.h>
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace tensorflow {
 namespace internal {
 
+namespace {
+
+// Asynchronous sink used when TF_CPP_ASYNC_LOGGING is set to a nonzero
+// value: logging threads append formatted lines to a per-thread buffer and
+// return, and a background flusher writes the buffers to stderr. Buffers
+// are bounded; lines that would exceed the bound are counted and dropped.
+//
+// This file sits below the rest of the platform layer (see the dependency
+// comments elsewhere in it), so the sink is built on std threading
+// primitives rather than Env or tensorflow::mutex.
+class AsyncLogSink {
+ public:
+  static AsyncLogSink* Global() {
+    static AsyncLogSink* sink = new AsyncLogSink;
+    return sink;
+  }
+
+  // Appends one formatted line to the calling thread's buffer, dropping it
+  // if the buffer is full.
+  void Append(const string& line) {
+    ThreadBuffer* buffer = PerThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mu);
+    if (buffer->data.size() + line.size() > kMaxBufferBytes) {
+      dropped_since_flush_.fetch_add(1, std::memory_order_relaxed);
+      total_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    buffer->data.append(line);
+  }
+
+  // Writes everything buffered so far to stderr. Called periodically by the
+  // flusher thread, and inline before any synchronous write so that a
+  // thread's earlier asynchronous messages are never reordered after its
+  // ERROR or FATAL output.
+  void Flush() {
+    std::vector<ThreadBuffer*> buffers;
+    {
+      std::lock_guard<std::mutex> lock(registry_mu_);
+      buffers = buffers_;
+    }
+    for (ThreadBuffer* buffer : buffers) {
+      string lines;
+      {
+        std::lock_guard<std::mutex> lock(buffer->mu);
+        lines.swap(buffer->data);
+      }
+      if (!lines.empty()) {
+        fwrite(lines.data(), 1, lines.size(), stderr);
+      }
+    }
+    const int64 dropped =
+        dropped_since_flush_.exchange(0, std::memory_order_relaxed);
+    if (dropped != 0) {
+      fprintf(stderr, "... dropped %lld log messages (buffers full)\n",
+              static_cast<long long>(dropped));
+    }
+  }
+
+  int64 TotalDropped() const {
+    return total_dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Per-thread cap; with the flusher draining every kFlushIntervalMillis
+  // this bounds both memory and the age of unflushed messages.
+  static constexpr size_t kMaxBufferBytes = 64 << 10;
+  static constexpr int kFlushIntervalMillis = 50;
+
+  struct ThreadBuffer {
+    std::mutex mu;
+    string data;
+  };
+
+  AsyncLogSink() {
+    std::thread([this]() {
+      while (true) {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kFlushIntervalMillis));
+        Flush();
+      }
+    }).detach();
+  }
+
+  // The registry keeps ownership so the flusher can drain buffers of
+  // threads that have already exited.
+  ThreadBuffer* PerThreadBuffer() {
+    static thread_local ThreadBuffer* buffer = [this]() {
+      ThreadBuffer* result = new ThreadBuffer;
+      std::lock_guard<std::mutex> lock(registry_mu_);
+      buffers_.push_back(result);
+      return result;
+    }();
+    return buffer;
+  }
+
+  std::mutex registry_mu_;
+  std::vector<ThreadBuffer*> buffers_;  // Guarded by registry_mu_.
+  std::atomic<int64> dropped_since_flush_{0};
+  std::atomic<int64> total_dropped_{0};
+};
+
+constexpr size_t AsyncLogSink::kMaxBufferBytes;
+constexpr int AsyncLogSink::kFlushIntervalMillis;
+
+bool AsyncLogEnabled() {
+  // Parsed directly to avoid helpers defined further down in this file.
+  static const bool enabled = []() {
+    const char* env = getenv("TF_CPP_ASYNC_LOGGING");
+    return env != nullptr && strtol(env, nullptr, 10) != 0;
+  }();
+  return enabled;
+}
+
+}  // namespace
+
+void FlushAsyncLog() {
+  if (AsyncLogEnabled()) {
+    AsyncLogSink::Global()->Flush();
+  }
+}
+
+int64 AsyncLogDroppedMessageCount() {
+  return AsyncLogEnabled() ? AsyncLogSink::Global()->TotalDropped() : 0;
+}
+
 #if defined(PLATFORM_POSIX_ANDROID)
 void LogMessage::GenerateLogMessage() {
   int android_log_level;
@@ -86,6 +216,20 @@ void LogMessage::GenerateLogMessage() {
   strftime(time_buffer, time_buffer_size, "%Y-%m-%d %H:%M:%S",
            localtime(&now_seconds));
 
+  if (severity_ < ERROR && AsyncLogEnabled()) {
+    // Hand the formatted line to the background flusher; the logging thread
+    // never blocks on stderr. ERROR and FATAL stay synchronous below so
+    // they are on stderr before any crash.
+    char prefix[512];
+    snprintf(prefix, sizeof(prefix), "%s.%06d: %c %s:%d] ", time_buffer,
+             micros_remainder, "IWEF"[severity_], fname_, line_);
+    AsyncLogSink::Global()->Append(prefix + str() + "\n");
+    return;
+  }
+  // Drain buffered messages first so this thread's earlier asynchronous
+  // output is not reordered after the synchronous line.
+  FlushAsyncLog();
+
   // TODO(jeff,sanjay): Replace this with something that logs through the env.
   fprintf(stderr, "%s.%06d: %c %s:%d] %s\n", time_buffer, micros_remainder,
           "IWEF"[severity_], fname_, line_, str().c_str());
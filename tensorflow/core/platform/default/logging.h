@@ -340,6 +340,21 @@ int64 MinLogLevelFromEnv();
 
 int64 MinVLogLevelFromEnv();
 
+// When the TF_CPP_ASYNC_LOGGING environment variable is set to a nonzero
+// value, INFO and WARNING messages are buffered per thread and written to
+// stderr by a background flusher instead of under the logging call; ERROR
+// and FATAL messages first drain the buffers and then write synchronously.
+// Buffer memory is bounded, so bursts can drop messages; drops are counted
+// and reported in the flushed output.
+
+// Writes any buffered asynchronous log messages to stderr. A no-op when
+// asynchronous logging is off.
+void FlushAsyncLog();
+
+// Returns the number of messages dropped so far because a thread's
+// asynchronous log buffer was full.
+int64 AsyncLogDroppedMessageCount();
+
 }  // namespace internal
 }  // namespace tensorflow
 
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/cord.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/null_file_system.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
@@ -90,6 +91,40 @@ TEST_F(DefaultEnvTest, IncompleteReadOutOfRange) {
   EXPECT_EQ(input, result);
 }
 
+TEST_F(DefaultEnvTest, ReadBatch) {
+  const string filename = io::JoinPath(BaseDir(), "read_batch");
+  const string input = CreateTestFile(env_, filename, 1024);
+  std::unique_ptr<RandomAccessFile> f;
+  TF_EXPECT_OK(env_->NewRandomAccessFile(filename, &f));
+
+  // Submit a batch of reads, including one that runs past EOF.
+  std::vector<RandomAccessFile::ReadRequest> batch(4);
+  std::vector<char> scratch(4 * 256);
+  for (int i = 0; i < 4; i++) {
+    batch[i].offset = 256 * i;
+    batch[i].n = 256;
+    batch[i].scratch = &scratch[256 * i];
+  }
+  batch[3].offset = 1024 - 128;
+  Notification done;
+  Status batch_status;
+  f->ReadBatch(&batch, [&done, &batch_status](Status s) {
+    batch_status = s;
+    done.Notify();
+  });
+  done.WaitForNotification();
+
+  // The batch fails overall because of the out-of-range read, but every
+  // request holds its own result and status.
+  EXPECT_EQ(error::OUT_OF_RANGE, batch_status.code());
+  for (int i = 0; i < 3; i++) {
+    TF_EXPECT_OK(batch[i].status);
+    EXPECT_EQ(input.substr(256 * i, 256), batch[i].result);
+  }
+  EXPECT_EQ(error::OUT_OF_RANGE, batch[3].status.code());
+  EXPECT_EQ(input.substr(1024 - 128), batch[3].result);
+}
+
 TEST_F(DefaultEnvTest, ReadFileToString) {
   for (const int length : {0, 1, 1212, 2553, 4928, 8196, 9000, (1 << 20) - 1,
                            1 << 20, (1 << 20) + 1, (256 << 20) + 100}) {
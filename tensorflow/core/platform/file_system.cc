@@ -51,6 +51,17 @@ void FileSystem::FlushCaches() {}
 
 RandomAccessFile::~RandomAccessFile() {}
 
+void RandomAccessFile::ReadBatch(std::vector<ReadRequest>* batch,
+                                 std::function<void(Status)> done) const {
+  Status overall_status;
+  for (ReadRequest& request : *batch) {
+    request.status =
+        Read(request.offset, request.n, &request.result, request.scratch);
+    overall_status.Update(request.status);
+  }
+  done(overall_status);
+}
+
 WritableFile::~WritableFile() {}
 
 FileSystemRegistry::~FileSystemRegistry() {}
@@ -260,6 +260,35 @@ class RandomAccessFile {
   virtual Status Read(uint64 offset, size_t n, StringPiece* result,
                       char* scratch) const = 0;
 
+  /// A single read within a batch submitted to ReadBatch(). The caller fills
+  /// in `offset`, `n` and `scratch`; the file implementation fills in
+  /// `result` and `status` with the same semantics as Read().
+  struct ReadRequest {
+    uint64 offset = 0;
+    size_t n = 0;
+    char* scratch = nullptr;
+    StringPiece result;
+    Status status;
+  };
+
+  /// \brief Submits a batch of reads and invokes `done` once all of them
+  /// have completed.
+  ///
+  /// Each request is carried out with the same semantics as Read(), with its
+  /// result and status stored in the request itself. The status passed to
+  /// `done` is OK if every request succeeded, and otherwise one of the
+  /// failing request statuses. Both `*batch` and this file must remain live
+  /// until `done` is invoked; `done` may run on the calling thread or on an
+  /// internal I/O thread.
+  ///
+  /// The default implementation performs the reads sequentially on the
+  /// calling thread. Filesystems that can issue reads concurrently override
+  /// this, so that callers scale by queue depth rather than by thread count.
+  ///
+  /// Safe for concurrent use by multiple threads.
+  virtual void ReadBatch(std::vector<ReadRequest>* batch,
+                         std::function<void(Status)> done) const;
+
  private:
   TF_DISALLOW_COPY_AND_ASSIGN(RandomAccessFile);
 };
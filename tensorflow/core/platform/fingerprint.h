@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_PLATFORM_FINGERPRINT_H_
 #define TENSORFLOW_CORE_PLATFORM_FINGERPRINT_H_
 
+#include <algorithm>
+#include <string>
+
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/platform/types.h"
 
@@ -102,6 +105,71 @@ inline Fprint128 Fingerprint128(StringPiece s) {
 #endif
 }
 
+// Fingerprints `num` buffers in one call, writing Fingerprint64(inputs[i])
+// to outputs[i]. Each output is bit-identical to a one-at-a-time call, so
+// batched and unbatched results can be mixed freely (e.g. in a fingerprint
+// cache). Prefer this form when hashing many small buffers such as
+// serialized NodeDefs or dataset records: it amortizes per-call overhead
+// today, and lets a future implementation hash several buffers at once
+// without touching callers.
+inline void Fingerprint64Batch(const StringPiece* inputs, const size_t num,
+                               uint64* outputs) {
+  for (size_t i = 0; i < num; ++i) {
+    outputs[i] = Fingerprint64(inputs[i]);
+  }
+}
+
+// Incrementally fingerprints a byte stream without materializing it, for
+// inputs too large to hold in one buffer (e.g. large tensor contents).
+// Input is consumed in fixed-size internal blocks, so the result depends
+// only on the concatenated bytes, not on how they were split across
+// Append() calls. Like Fingerprint64 the result will never change, but it
+// is a distinct fingerprint: it only matches Fingerprint64 of the whole
+// stream for streams of at most one block.
+class Fingerprint64Stream {
+ public:
+  // Absorbs `data` into the stream.
+  void Append(StringPiece data) {
+    while (!data.empty()) {
+      // Full blocks are hashed straight out of the caller's buffer; only
+      // block fragments spanning Append() calls are copied.
+      if (block_.empty() && data.size() >= kBlockSize) {
+        IngestBlock(StringPiece(data.data(), kBlockSize));
+        data.remove_prefix(kBlockSize);
+        continue;
+      }
+      const size_t take = std::min(data.size(), kBlockSize - block_.size());
+      block_.append(data.data(), take);
+      data.remove_prefix(take);
+      if (block_.size() == kBlockSize) {
+        IngestBlock(block_);
+        block_.clear();
+      }
+    }
+  }
+
+  // Returns the fingerprint of everything appended so far. May be called
+  // at any point; appending afterwards is fine.
+  uint64 Fingerprint() const {
+    if (!any_block_) return Fingerprint64(block_);
+    if (block_.empty()) return fp_;
+    return FingerprintCat64(fp_, Fingerprint64(block_));
+  }
+
+ private:
+  static constexpr size_t kBlockSize = 8192;
+
+  void IngestBlock(StringPiece block) {
+    fp_ = any_block_ ? FingerprintCat64(fp_, Fingerprint64(block))
+                     : Fingerprint64(block);
+    any_block_ = true;
+  }
+
+  uint64 fp_ = 0;
+  bool any_block_ = false;
+  string block_;
+};
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_PLATFORM_FINGERPRINT_H_
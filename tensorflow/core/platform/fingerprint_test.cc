@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/platform/fingerprint.h"
 
 #include <unordered_set>
+#include <vector>
 
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/types.h"
@@ -69,5 +70,48 @@ TEST(FingerprintCat64, Idempotence) {
             FingerprintCat64(Fingerprint64("Hello"), Fingerprint64("World")));
 }
 
+TEST(Fingerprint64Batch, MatchesSingleBufferCalls) {
+  const std::vector<StringPiece> inputs = {"Hello", "", "World", "Hello"};
+  std::vector<uint64> outputs(inputs.size());
+  Fingerprint64Batch(inputs.data(), inputs.size(), outputs.data());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(Fingerprint64(inputs[i]), outputs[i]);
+  }
+}
+
+TEST(Fingerprint64Stream, ShortStreamMatchesFingerprint64) {
+  // Streams of at most one internal block match the one-shot fingerprint,
+  // however the bytes are sliced.
+  Fingerprint64Stream stream;
+  stream.Append("Hello");
+  stream.Append("World");
+  EXPECT_EQ(Fingerprint64("HelloWorld"), stream.Fingerprint());
+
+  Fingerprint64Stream empty;
+  EXPECT_EQ(Fingerprint64(""), empty.Fingerprint());
+}
+
+TEST(Fingerprint64Stream, IndependentOfAppendBoundaries) {
+  // Spans several internal blocks plus a partial tail.
+  string data;
+  for (int i = 0; i < 3 * 8192 + 100; ++i) {
+    data.push_back('a' + (i * 7) % 26);
+  }
+
+  Fingerprint64Stream one_shot;
+  one_shot.Append(data);
+
+  Fingerprint64Stream byte_at_a_time;
+  for (size_t i = 0; i < data.size(); ++i) {
+    byte_at_a_time.Append(StringPiece(data.data() + i, 1));
+    // Intermediate reads must not disturb the stream.
+    byte_at_a_time.Fingerprint();
+  }
+
+  EXPECT_EQ(one_shot.Fingerprint(), byte_at_a_time.Fingerprint());
+  // Multi-block streams use a distinct (but equally frozen) fingerprint.
+  EXPECT_NE(Fingerprint64(data), one_shot.Fingerprint());
+}
+
 }  // namespace
 }  // namespace tensorflow
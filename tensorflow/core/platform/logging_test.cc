@@ -88,6 +88,13 @@ TEST(LoggingDeathTest, FailedChecks) {
 #endif
 }
 
+TEST(Logging, AsyncLogAccessors) {
+  // Async logging is off unless TF_CPP_ASYNC_LOGGING is set; the accessors
+  // are no-ops then but must still be callable.
+  internal::FlushAsyncLog();
+  EXPECT_GE(internal::AsyncLogDroppedMessageCount(), 0);
+}
+
 TEST(InternalLogString, Basic) {
   // Just make sure that this code compiles (we don't actually verify
   // the output)
@@ -18,6 +18,10 @@ limitations under the License.
 #include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
 #include <sys/mman.h>
 #if defined(__linux__)
 #include <sys/sendfile.h>
@@ -30,10 +34,13 @@ limitations under the License.
 
 #include "tensorflow/core/lib/core/error_codes.pb.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system_helper.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/posix/error.h"
 #include "tensorflow/core/platform/posix/posix_file_system.h"
 
@@ -42,6 +49,24 @@ namespace tensorflow {
 // 128KB of copy buffer
 constexpr size_t kPosixCopyFileBufferSize = 128 * 1024;
 
+// Returns the process-wide pool used to carry out batched preads. The pool
+// size bounds the number of reads in flight and can be overridden with the
+// TF_PREAD_POOL_THREADS environment variable.
+static thread::ThreadPool* PReadPool() {
+  static thread::ThreadPool* pool = []() {
+    int64 num_threads = 16;
+    const char* env = getenv("TF_PREAD_POOL_THREADS");
+    int64 env_value;
+    if (env != nullptr && strings::safe_strto64(env, &env_value) &&
+        env_value > 0) {
+      num_threads = env_value;
+    }
+    return new thread::ThreadPool(Env::Default(), "pread",
+                                  static_cast<int>(num_threads));
+  }();
+  return pool;
+}
+
 // pread() based random-access
 class PosixRandomAccessFile : public RandomAccessFile {
  private:
@@ -88,6 +113,43 @@ class PosixRandomAccessFile : public RandomAccessFile {
     *result = StringPiece(scratch, dst - scratch);
     return s;
   }
+
+  void ReadBatch(std::vector<ReadRequest>* batch,
+                 std::function<void(Status)> done) const override {
+    if (batch->size() <= 1) {
+      RandomAccessFile::ReadBatch(batch, std::move(done));
+      return;
+    }
+    // Issue the preads concurrently on the shared pool; the request that
+    // finishes last merges the statuses and runs the completion callback.
+    struct BatchState {
+      explicit BatchState(size_t size) : remaining(size) {}
+      std::atomic<int64> remaining;
+      mutex mu;
+      Status status;  // Guarded by mu.
+      std::function<void(Status)> done;
+    };
+    auto state = std::make_shared<BatchState>(batch->size());
+    state->done = std::move(done);
+    for (ReadRequest& request : *batch) {
+      ReadRequest* r = &request;
+      PReadPool()->Schedule([this, r, state]() {
+        r->status = Read(r->offset, r->n, &r->result, r->scratch);
+        if (!r->status.ok()) {
+          mutex_lock l(state->mu);
+          state->status.Update(r->status);
+        }
+        if (state->remaining.fetch_sub(1) == 1) {
+          Status batch_status;
+          {
+            mutex_lock l(state->mu);
+            batch_status = state->status;
+          }
+          state->done(batch_status);
+        }
+      });
+    }
+  }
 };
 
 class PosixWritableFile : public WritableFile {
@@ -0,0 +1,136 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/trace_ring.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/profile_utils/cpu_utils.h"
+
+namespace tensorflow {
+namespace tracing {
+namespace {
+
+// Per-thread ring of records. Rings are created on a thread's first record,
+// registered process-wide for collection, and intentionally never freed:
+// dumps must be able to read the rings of threads that have since exited.
+struct Ring {
+  static constexpr int kNumRecords = 1 << 13;
+
+  explicit Ring(int id) : thread_id(id) {}
+
+  const int thread_id;
+  TraceRingRecord records[Ring::kNumRecords];
+  // Total records ever written; the slot of record i is i % kNumRecords.
+  // Written only by the owning thread, read by dumpers.
+  std::atomic<uint64> next{0};
+};
+
+class RingRegistry {
+ public:
+  static RingRegistry* Global() {
+    static RingRegistry* registry = new RingRegistry;
+    return registry;
+  }
+
+  Ring* CreateRing() {
+    mutex_lock l(mu_);
+    rings_.push_back(
+        std::unique_ptr<Ring>(new Ring(static_cast<int>(rings_.size()))));
+    return rings_.back().get();
+  }
+
+  std::vector<Ring*> Rings() const {
+    mutex_lock l(mu_);
+    std::vector<Ring*> rings;
+    rings.reserve(rings_.size());
+    for (const auto& ring : rings_) {
+      rings.push_back(ring.get());
+    }
+    return rings;
+  }
+
+ private:
+  mutable mutex mu_;
+  std::vector<std::unique_ptr<Ring>> rings_ GUARDED_BY(mu_);
+};
+
+Ring* ThreadRing() {
+  static thread_local Ring* ring = RingRegistry::Global()->CreateRing();
+  return ring;
+}
+
+}  // namespace
+
+std::atomic<bool> TraceRing::enabled_{false};
+
+void TraceRing::Enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+void TraceRing::Disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+void TraceRing::RecordImpl(EventCategory category,
+                           TraceRingRecord::Phase phase, uint64 activity_id,
+                           uint64 correlation_id) {
+  Ring* ring = ThreadRing();
+  const uint64 index = ring->next.load(std::memory_order_relaxed);
+  TraceRingRecord* record = &ring->records[index % Ring::kNumRecords];
+  record->timestamp = profile_utils::CpuUtils::GetCurrentClockCycle();
+  record->activity_id = activity_id;
+  record->correlation_id = correlation_id;
+  record->category = static_cast<uint32>(category);
+  record->phase = static_cast<uint32>(phase);
+  ring->next.store(index + 1, std::memory_order_release);
+}
+
+string TraceRing::DumpChromeTrace(uint64 correlation_id) {
+  const double cycles_per_micro =
+      static_cast<double>(profile_utils::CpuUtils::GetCycleCounterFrequency()) /
+      1e6;
+  string json = "{\"traceEvents\":[";
+  bool first = true;
+  for (Ring* ring : RingRegistry::Global()->Rings()) {
+    const uint64 next = ring->next.load(std::memory_order_acquire);
+    const uint64 num_records = static_cast<uint64>(Ring::kNumRecords);
+    const uint64 begin = next > num_records ? next - num_records : 0;
+    for (uint64 i = begin; i < next; ++i) {
+      const TraceRingRecord& record = ring->records[i % Ring::kNumRecords];
+      if (correlation_id != 0 && record.correlation_id != correlation_id) {
+        continue;
+      }
+      if (!first) {
+        strings::StrAppend(&json, ",");
+      }
+      first = false;
+      strings::StrAppend(
+          &json, "{\"ph\":\"",
+          record.phase == TraceRingRecord::kBegin ? "B" : "E",
+          "\",\"pid\":0,\"tid\":", ring->thread_id, ",\"ts\":",
+          static_cast<double>(record.timestamp) / cycles_per_micro,
+          ",\"name\":\"",
+          GetEventCategoryName(static_cast<EventCategory>(record.category)),
+          ":", record.activity_id,
+          "\",\"args\":{\"correlation_id\":", record.correlation_id, "}}");
+    }
+  }
+  strings::StrAppend(&json, "]}");
+  return json;
+}
+
+}  // namespace tracing
+}  // namespace tensorflow
@@ -0,0 +1,122 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_PLATFORM_TRACE_RING_H_
+#define TENSORFLOW_CORE_PLATFORM_TRACE_RING_H_
+
+// A lightweight, always-compiled-in tracing surface intended to stay enabled
+// in production. Unlike the EventCollector interface in tracing.h, recording
+// does not go through virtual calls or allocate: each thread owns a
+// fixed-size ring of POD records, and recording a span boundary is a relaxed
+// atomic load of the enabled flag plus a handful of stores into the ring.
+// The ring wraps, so at any moment it holds the most recent activity of the
+// thread — enough to reconstruct the exact step that caused a tail-latency
+// outlier after the fact.
+//
+// Records carry a correlation id, by convention the step id of the executor
+// run that produced them, so spans from different threads belonging to the
+// same step can be grouped at dump time.
+
+#include <atomic>
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/tracing.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace tracing {
+
+// One span boundary. POD; written in place in the ring.
+struct TraceRingRecord {
+  enum Phase : uint32 { kBegin = 0, kEnd = 1 };
+
+  uint64 timestamp;       // CPU cycle counter at the boundary.
+  uint64 activity_id;     // Caller-defined, e.g. the graph node id.
+  uint64 correlation_id;  // Caller-defined, by convention the step id.
+  uint32 category;        // An EventCategory value.
+  uint32 phase;           // A Phase value.
+};
+
+// Process-wide control and collection surface for the per-thread rings.
+class TraceRing {
+ public:
+  // Turns recording on/off. Both are cheap; Enable may be left on in
+  // production.
+  static void Enable();
+  static void Disable();
+
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Appends a record to the calling thread's ring. No-op unless enabled.
+  static void Record(EventCategory category, TraceRingRecord::Phase phase,
+                     uint64 activity_id, uint64 correlation_id) {
+    if (TF_PREDICT_TRUE(!IsEnabled())) return;
+    RecordImpl(category, phase, activity_id, correlation_id);
+  }
+
+  // Renders the contents of every thread's ring as a JSON string in chrome
+  // tracing ("catapult") format, with cycle timestamps converted to
+  // microseconds and the correlation id attached to each event.
+  //
+  // Call Disable() first: records written concurrently with the dump may be
+  // torn. Records whose step does not match `correlation_id` are skipped
+  // unless `correlation_id` is zero, which dumps everything.
+  static string DumpChromeTrace(uint64 correlation_id = 0);
+
+ private:
+  static void RecordImpl(EventCategory category, TraceRingRecord::Phase phase,
+                         uint64 activity_id, uint64 correlation_id);
+
+  static std::atomic<bool> enabled_;
+};
+
+// Records a begin/end pair around a scope. The enabled flag is checked once,
+// at construction.
+class ScopedRingActivity {
+ public:
+  ScopedRingActivity(EventCategory category, uint64 activity_id,
+                     uint64 correlation_id)
+      : category_(category),
+        activity_id_(activity_id),
+        correlation_id_(correlation_id),
+        enabled_(TraceRing::IsEnabled()) {
+    if (TF_PREDICT_FALSE(enabled_)) {
+      TraceRing::Record(category_, TraceRingRecord::kBegin, activity_id_,
+                        correlation_id_);
+    }
+  }
+
+  ~ScopedRingActivity() {
+    if (TF_PREDICT_FALSE(enabled_)) {
+      TraceRing::Record(category_, TraceRingRecord::kEnd, activity_id_,
+                        correlation_id_);
+    }
+  }
+
+ private:
+  const EventCategory category_;
+  const uint64 activity_id_;
+  const uint64 correlation_id_;
+  const bool enabled_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedRingActivity);
+};
+
+}  // namespace tracing
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PLATFORM_TRACE_RING_H_
@@ -0,0 +1,90 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/trace_ring.h"
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace tracing {
+namespace {
+
+TEST(TraceRingTest, DisabledRecordsNothing) {
+  TraceRing::Disable();
+  {
+    ScopedRingActivity activity(EventCategory::kCompute, 1 /* activity */,
+                                42 /* correlation */);
+  }
+  const string json = TraceRing::DumpChromeTrace(42);
+  EXPECT_EQ("{\"traceEvents\":[]}", json);
+}
+
+TEST(TraceRingTest, RecordsSpansWithCorrelationId) {
+  TraceRing::Enable();
+  {
+    ScopedRingActivity activity(EventCategory::kCompute, 7 /* activity */,
+                                99 /* correlation */);
+  }
+  TraceRing::Disable();
+
+  const string json = TraceRing::DumpChromeTrace(99);
+  EXPECT_TRUE(str_util::StrContains(json, "\"ph\":\"B\"")) << json;
+  EXPECT_TRUE(str_util::StrContains(json, "\"ph\":\"E\"")) << json;
+  EXPECT_TRUE(str_util::StrContains(json, "Compute:7")) << json;
+  EXPECT_TRUE(str_util::StrContains(json, "\"correlation_id\":99")) << json;
+}
+
+TEST(TraceRingTest, CollectsAcrossThreads) {
+  TraceRing::Enable();
+  {
+    thread::ThreadPool pool(Env::Default(), "test", 4);
+    for (int i = 0; i < 4; ++i) {
+      pool.Schedule([i]() {
+        ScopedRingActivity activity(EventCategory::kRunClosure,
+                                    100 + i /* activity */,
+                                    1234 /* correlation */);
+      });
+    }
+  }
+  TraceRing::Disable();
+
+  const string json = TraceRing::DumpChromeTrace(1234);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(str_util::StrContains(
+        json, strings::StrCat("RunClosure:", 100 + i)))
+        << json;
+  }
+}
+
+TEST(TraceRingTest, DumpFiltersByCorrelationId) {
+  TraceRing::Enable();
+  {
+    ScopedRingActivity activity(EventCategory::kCompute, 8 /* activity */,
+                                555 /* correlation */);
+  }
+  TraceRing::Disable();
+
+  EXPECT_FALSE(
+      str_util::StrContains(TraceRing::DumpChromeTrace(556), "Compute:8"));
+  EXPECT_TRUE(
+      str_util::StrContains(TraceRing::DumpChromeTrace(555), "Compute:8"));
+}
+
+}  // namespace
+}  // namespace tracing
+}  // namespace tensorflow
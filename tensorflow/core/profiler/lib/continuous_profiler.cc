@@ -0,0 +1,147 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/continuous_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/profiler/lib/profiler_session.h"
+
+namespace tensorflow {
+namespace {
+
+std::atomic<ContinuousProfiler*> global_continuous_profiler{nullptr};
+
+// Extracts the op type from a node's stats. Timeline labels have the form
+// "name = OpType(inputs)"; nodes without one (e.g. eager kernels) are keyed
+// by node name, which is the op type in that case.
+string OpTypeForNodeStats(const NodeExecStats& node_stats) {
+  const string& label = node_stats.timeline_label();
+  const size_t eq = label.find(" = ");
+  if (eq == string::npos) {
+    return node_stats.node_name();
+  }
+  const size_t begin = eq + 3;
+  const size_t paren = label.find('(', begin);
+  return label.substr(begin,
+                      paren == string::npos ? string::npos : paren - begin);
+}
+
+}  // namespace
+
+ContinuousProfiler::ContinuousProfiler(ProfilerContext* const context,
+                                       const Options& options)
+    : context_(context), options_(options) {
+  if (options_.sample_interval_ms > 0) {
+    thread_.reset(Env::Default()->StartThread(
+        ThreadOptions(), "continuous_profiler", [this]() { SampleLoop(); }));
+  }
+}
+
+ContinuousProfiler::~ContinuousProfiler() {
+  {
+    mutex_lock l(mu_);
+    shutdown_ = true;
+    shutdown_cv_.notify_all();
+  }
+  thread_.reset();  // Joins the sampling thread.
+}
+
+void ContinuousProfiler::SampleLoop() {
+  while (true) {
+    {
+      mutex_lock l(mu_);
+      if (!shutdown_) {
+        WaitForMilliseconds(&l, &shutdown_cv_, options_.sample_interval_ms);
+      }
+      if (shutdown_) return;
+    }
+
+    std::unique_ptr<ProfilerSession> session =
+        ProfilerSession::Create(context_);
+    if (!session->Status().ok()) {
+      // Another profiler holds the context (e.g. a request-driven trace is
+      // in flight); skip this window rather than fight over it.
+      continue;
+    }
+    {
+      mutex_lock l(mu_);
+      if (!shutdown_) {
+        WaitForMilliseconds(&l, &shutdown_cv_, options_.sample_duration_ms);
+      }
+    }
+    RunMetadata run_metadata;
+    if (session->CollectData(&run_metadata).ok()) {
+      session.reset();  // Stop tracing before the (locked) aggregation.
+      AggregateRunMetadata(run_metadata);
+    }
+  }
+}
+
+void ContinuousProfiler::AggregateRunMetadata(
+    const RunMetadata& run_metadata) {
+  mutex_lock l(mu_);
+  ++windows_collected_;
+  for (const DeviceStepStats& dev_stats :
+       run_metadata.step_stats().dev_stats()) {
+    for (const NodeExecStats& node_stats : dev_stats.node_stats()) {
+      OpAggregate& aggregate = aggregates_[OpTypeForNodeStats(node_stats)];
+      ++aggregate.occurrences;
+      aggregate.total_time_us += node_stats.all_end_rel_micros();
+      for (const AllocatorMemoryUsed& memory : node_stats.memory()) {
+        aggregate.total_bytes += memory.total_bytes();
+      }
+    }
+  }
+}
+
+string ContinuousProfiler::Summary() const {
+  mutex_lock l(mu_);
+  std::vector<std::pair<string, OpAggregate>> rows(aggregates_.begin(),
+                                                   aggregates_.end());
+  std::sort(rows.begin(), rows.end(),
+            [](const std::pair<string, OpAggregate>& a,
+               const std::pair<string, OpAggregate>& b) {
+              return a.second.total_time_us > b.second.total_time_us;
+            });
+  string out = strings::Printf(
+      "Continuous profile over %lld sampling windows.\n"
+      "%-32s %12s %16s %16s\n",
+      static_cast<long long>(windows_collected_), "op_type", "count",
+      "total_time_us", "total_bytes");
+  for (const auto& row : rows) {
+    strings::Appendf(&out, "%-32s %12lld %16lld %16lld\n", row.first.c_str(),
+                     static_cast<long long>(row.second.occurrences),
+                     static_cast<long long>(row.second.total_time_us),
+                     static_cast<long long>(row.second.total_bytes));
+  }
+  return out;
+}
+
+void SetContinuousProfiler(ContinuousProfiler* profiler) {
+  global_continuous_profiler.store(profiler, std::memory_order_release);
+}
+
+ContinuousProfiler* GetContinuousProfiler() {
+  return global_continuous_profiler.load(std::memory_order_acquire);
+}
+
+}  // namespace tensorflow
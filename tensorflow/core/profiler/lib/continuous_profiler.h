@@ -0,0 +1,101 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_PROFILER_LIB_CONTINUOUS_PROFILER_H_
+#define TENSORFLOW_CORE_PROFILER_LIB_CONTINUOUS_PROFILER_H_
+
+#include <map>
+#include <memory>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/profiler/internal/profiler_interface.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+
+// A low-overhead profiling mode meant to run for the lifetime of the process.
+// Instead of tracing on request, it periodically opens a short ProfilerSession
+// window, folds the collected RunMetadata into per-op-type aggregates (sample
+// count, total time, total allocated bytes), and throws the raw trace away.
+// The aggregates stay a few kilobytes regardless of uptime and can be pulled
+// at any time through the ProfilerService Monitor RPC, so shifts in the
+// kernel mix show up on dashboards without anyone attaching a tool.
+//
+// Thread-safety: ContinuousProfiler is thread-safe.
+class ContinuousProfiler {
+ public:
+  struct Options {
+    // Time between the start of consecutive sampling windows. Non-positive
+    // disables the background thread; data can then only be added through
+    // AggregateRunMetadata, which tests use.
+    int64 sample_interval_ms = 60 * 1000;
+    // Length of each sampling window. Kept short so that the duty cycle, and
+    // with it the tracing overhead, stays small.
+    int64 sample_duration_ms = 100;
+  };
+
+  ContinuousProfiler(ProfilerContext* context, const Options& options);
+
+  // Stops the sampling thread, blocking until it exits.
+  ~ContinuousProfiler();
+
+  // Folds the per-node stats in run_metadata into the per-op-type aggregates.
+  // Called by the sampling thread after each window; exposed for tests and
+  // for callers that already have RunMetadata in hand.
+  void AggregateRunMetadata(const RunMetadata& run_metadata)
+      LOCKS_EXCLUDED(mu_);
+
+  // Renders the aggregates as a human-readable table, one op type per line,
+  // suitable for a MonitorResponse.
+  string Summary() const LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct OpAggregate {
+    int64 occurrences = 0;
+    int64 total_time_us = 0;
+    int64 total_bytes = 0;
+  };
+
+  // Body of the sampling thread: opens a window every sample_interval_ms.
+  void SampleLoop();
+
+  ProfilerContext* const context_;
+  const Options options_;
+
+  mutable mutex mu_;
+  condition_variable shutdown_cv_;
+  bool shutdown_ GUARDED_BY(mu_) = false;
+  int64 windows_collected_ GUARDED_BY(mu_) = 0;
+  std::map<string, OpAggregate> aggregates_ GUARDED_BY(mu_);
+
+  // Last member, so that the thread never observes partially constructed
+  // state and is joined before anything else is destroyed.
+  std::unique_ptr<Thread> thread_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ContinuousProfiler);
+};
+
+// Process-wide registration, used by the ProfilerService Monitor handler to
+// find the running instance. Pass nullptr to unregister. Does not take
+// ownership.
+void SetContinuousProfiler(ContinuousProfiler* profiler);
+ContinuousProfiler* GetContinuousProfiler();
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PROFILER_LIB_CONTINUOUS_PROFILER_H_
@@ -0,0 +1,95 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/continuous_profiler.h"
+
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+ContinuousProfiler::Options ManualOptions() {
+  ContinuousProfiler::Options options;
+  options.sample_interval_ms = 0;  // No sampling thread; aggregate manually.
+  return options;
+}
+
+NodeExecStats MakeNodeStats(const string& node_name,
+                            const string& timeline_label, int64 time_us,
+                            int64 bytes) {
+  NodeExecStats stats;
+  stats.set_node_name(node_name);
+  stats.set_timeline_label(timeline_label);
+  stats.set_all_end_rel_micros(time_us);
+  if (bytes != 0) {
+    stats.add_memory()->set_total_bytes(bytes);
+  }
+  return stats;
+}
+
+TEST(ContinuousProfilerTest, AggregatesByOpType) {
+  ContinuousProfiler profiler(nullptr, ManualOptions());
+
+  RunMetadata run_metadata;
+  DeviceStepStats* dev_stats =
+      run_metadata.mutable_step_stats()->add_dev_stats();
+  *dev_stats->add_node_stats() =
+      MakeNodeStats("m1", "m1 = MatMul(a, b)", 100, 1 << 20);
+  *dev_stats->add_node_stats() =
+      MakeNodeStats("m2", "m2 = MatMul(c, d)", 50, 1 << 20);
+  *dev_stats->add_node_stats() = MakeNodeStats("r", "r = Relu(m2)", 10, 0);
+  profiler.AggregateRunMetadata(run_metadata);
+  profiler.AggregateRunMetadata(run_metadata);
+
+  const string summary = profiler.Summary();
+  EXPECT_TRUE(str_util::StrContains(summary, "2 sampling windows"))
+      << summary;
+  // 4 MatMuls totalling 300us and 4MiB; 2 Relus totalling 20us.
+  EXPECT_TRUE(str_util::StrContains(
+      summary, strings::Printf("%-32s %12d %16d %16d", "MatMul", 4, 300,
+                               4 << 20)))
+      << summary;
+  EXPECT_TRUE(str_util::StrContains(
+      summary, strings::Printf("%-32s %12d %16d %16d", "Relu", 2, 20, 0)))
+      << summary;
+}
+
+TEST(ContinuousProfilerTest, FallsBackToNodeNameWithoutTimelineLabel) {
+  ContinuousProfiler profiler(nullptr, ManualOptions());
+
+  RunMetadata run_metadata;
+  DeviceStepStats* dev_stats =
+      run_metadata.mutable_step_stats()->add_dev_stats();
+  *dev_stats->add_node_stats() = MakeNodeStats("Conv2D", "", 42, 0);
+  profiler.AggregateRunMetadata(run_metadata);
+
+  EXPECT_TRUE(str_util::StrContains(profiler.Summary(), "Conv2D"));
+}
+
+TEST(ContinuousProfilerTest, GlobalRegistration) {
+  EXPECT_EQ(nullptr, GetContinuousProfiler());
+  {
+    ContinuousProfiler profiler(nullptr, ManualOptions());
+    SetContinuousProfiler(&profiler);
+    EXPECT_EQ(&profiler, GetContinuousProfiler());
+    SetContinuousProfiler(nullptr);
+  }
+  EXPECT_EQ(nullptr, GetContinuousProfiler());
+}
+
+}  // namespace
+}  // namespace tensorflow
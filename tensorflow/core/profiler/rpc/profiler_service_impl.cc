@@ -16,7 +16,9 @@ limitations under the License.
 #include "tensorflow/core/profiler/rpc/profiler_service_impl.h"
 #include "grpcpp/support/status.h"
 #include "tensorflow/core/common_runtime/eager/context.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/grpc_services.h"
+#include "tensorflow/core/profiler/lib/continuous_profiler.h"
 #include "tensorflow/core/profiler/lib/profiler_session.h"
 #include "tensorflow/core/util/ptr_util.h"
 
@@ -31,7 +33,19 @@ class ProfilerServiceImpl : public grpc::ProfilerService::Service {
 
   ::grpc::Status Monitor(::grpc::ServerContext* ctx, const MonitorRequest* req,
                          MonitorResponse* response) override {
-    return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "unimplemented.");
+    ContinuousProfiler* continuous_profiler = GetContinuousProfiler();
+    if (continuous_profiler == nullptr) {
+      return ::grpc::Status(::grpc::StatusCode::UNAVAILABLE,
+                            "continuous profiler is not running.");
+    }
+    string data;
+    if (req->timestamp()) {
+      strings::StrAppend(&data, "timestamp_us: ",
+                         Env::Default()->NowMicros(), "\n");
+    }
+    strings::StrAppend(&data, continuous_profiler->Summary());
+    response->set_data(data);
+    return ::grpc::Status::OK;
   }
 
   ::grpc::Status Profile(::grpc::ServerContext* ctx, const ProfileRequest* req,
@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/summary/summary_db_writer.h"
 
 #include <deque>
+#include <vector>
 
 #include "tensorflow/core/summary/summary_converter.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -79,6 +80,12 @@ const int64 kPreallocateRows = 1000;
 // allow writers in other processes a chance to schedule.
 const uint64 kFlushBytes = 1024 * 1024;
 
+// Tensor appends are queued in memory and committed to the database by a
+// background thread, so the step thread pays only for an enqueue. If the
+// queue grows beyond this many tensor bytes, enqueuers block until the
+// committer catches up.
+const uint64 kMaxQueueBytes = 64 * 1024 * 1024;
+
 double DoubleTime(uint64 micros) {
   // TODO(@jart): Follow precise definitions for time laid out in schema.
   // TODO(@jart): Use monotonic clock from gRPC codebase.
@@ -629,12 +636,12 @@ class SeriesWriter {
     DCHECK(series_ > 0);
   }
 
-  Status Append(Sqlite* db, int64 step, uint64 now, double computed_time,
-                const Tensor& t) SQLITE_TRANSACTIONS_EXCLUDED(*db)
-      LOCKS_EXCLUDED(mu_) {
+  Status Append(Sqlite* db, SqliteTransaction* txn, int64 step, uint64 now,
+                double computed_time, const Tensor& t)
+      SQLITE_EXCLUSIVE_TRANSACTIONS_REQUIRED(*db) LOCKS_EXCLUDED(mu_) {
     mutex_lock lock(mu_);
     if (rowids_.empty()) {
-      Status s = Reserve(db, t);
+      Status s = Reserve(db, txn, t);
       if (!s.ok()) {
         rowids_.clear();
         return s;
@@ -673,16 +680,14 @@ class SeriesWriter {
 
  private:
   Status Write(Sqlite* db, int64 rowid, int64 step, double computed_time,
-               const Tensor& t) SQLITE_TRANSACTIONS_EXCLUDED(*db) {
+               const Tensor& t) SQLITE_EXCLUSIVE_TRANSACTIONS_REQUIRED(*db) {
     if (t.dtype() == DT_STRING) {
       if (t.dims() == 0) {
         return Update(db, step, computed_time, t, t.scalar<string>()(), rowid);
       } else {
-        SqliteTransaction txn(*db);
         TF_RETURN_IF_ERROR(
             Update(db, step, computed_time, t, StringPiece(), rowid));
-        TF_RETURN_IF_ERROR(UpdateNdString(db, t, rowid));
-        return txn.Commit();
+        return UpdateNdString(db, t, rowid);
       }
     } else {
       return Update(db, step, computed_time, t, t.tensor_data(), rowid);
@@ -745,20 +750,19 @@ class SeriesWriter {
     return Status::OK();
   }
 
-  Status Reserve(Sqlite* db, const Tensor& t) SQLITE_TRANSACTIONS_EXCLUDED(*db)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    SqliteTransaction txn(*db);  // only for performance
+  Status Reserve(Sqlite* db, SqliteTransaction* txn, const Tensor& t)
+      SQLITE_EXCLUSIVE_TRANSACTIONS_REQUIRED(*db)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     unflushed_bytes_ = 0;
     if (t.dtype() == DT_STRING) {
       if (t.dims() == 0) {
-        TF_RETURN_IF_ERROR(ReserveData(db, &txn, t.scalar<string>()().size()));
+        return ReserveData(db, txn, t.scalar<string>()().size());
       } else {
-        TF_RETURN_IF_ERROR(ReserveTensors(db, &txn, kReserveMinBytes));
+        return ReserveTensors(db, txn, kReserveMinBytes);
       }
     } else {
-      TF_RETURN_IF_ERROR(ReserveData(db, &txn, t.tensor_data().size()));
+      return ReserveData(db, txn, t.tensor_data().size());
     }
-    return txn.Commit();
   }
 
   Status ReserveData(Sqlite* db, SqliteTransaction* txn, size_t size)
@@ -828,11 +832,11 @@ class RunWriter {
  public:
   explicit RunWriter(RunMetadata* meta) : meta_{meta} {}
 
-  Status Append(Sqlite* db, int64 tag_id, int64 step, uint64 now,
-                double computed_time, const Tensor& t)
-      SQLITE_TRANSACTIONS_EXCLUDED(*db) LOCKS_EXCLUDED(mu_) {
+  Status Append(Sqlite* db, SqliteTransaction* txn, int64 tag_id, int64 step,
+                uint64 now, double computed_time, const Tensor& t)
+      SQLITE_EXCLUSIVE_TRANSACTIONS_REQUIRED(*db) LOCKS_EXCLUDED(mu_) {
     SeriesWriter* writer = GetSeriesWriter(tag_id);
-    return writer->Append(db, step, now, computed_time, t);
+    return writer->Append(db, txn, step, now, computed_time, t);
   }
 
   Status Finish(Sqlite* db) SQLITE_TRANSACTIONS_EXCLUDED(*db)
@@ -871,6 +875,11 @@ class RunWriter {
 
 /// \brief SQLite implementation of SummaryWriterInterface.
 ///
+/// Tensor writes are appended to an in-memory write-ahead queue and
+/// committed to the database in large batched transactions by a
+/// background thread, so the calling thread pays only for an enqueue.
+/// Flush() blocks until everything queued so far is durable.
+///
 /// This class is thread safe.
 class SummaryDbWriter : public SummaryWriterInterface {
  public:
@@ -884,9 +893,23 @@ class SummaryDbWriter : public SummaryWriterInterface {
         run_{&meta_} {
     DCHECK(env_ != nullptr);
     db_->Ref();
+    committer_.reset(env_->StartThread(ThreadOptions(), "summary_db_writer",
+                                       [this] { RunCommitterThread(); }));
   }
 
   ~SummaryDbWriter() override {
+    {
+      mutex_lock lock(mu_);
+      shutdown_ = true;
+      wakeup_.notify_one();
+    }
+    committer_.reset();  // joins, after draining anything still queued
+    {
+      mutex_lock lock(mu_);
+      if (!status_.ok()) {
+        LOG(ERROR) << "Dropped queued summaries: " << status_.ToString();
+      }
+    }
     core::ScopedUnref unref(db_);
     Status s = run_.Finish(db_);
     if (!s.ok()) {
@@ -911,7 +934,13 @@ class SummaryDbWriter : public SummaryWriterInterface {
     }
   }
 
-  Status Flush() override { return Status::OK(); }
+  Status Flush() override LOCKS_EXCLUDED(mu_) {
+    mutex_lock lock(mu_);
+    while (status_.ok() && (!queue_.empty() || is_committing_)) {
+      drained_.wait(lock);
+    }
+    return status_;
+  }
 
   Status WriteTensor(int64 global_step, Tensor t, const string& tag,
                      const string& serialized_metadata) override {
@@ -975,20 +1004,98 @@ class SummaryDbWriter : public SummaryWriterInterface {
   string DebugString() const override { return "SummaryDbWriter"; }
 
  private:
+  // A summary accepted from the caller but not yet committed to the
+  // database. The Tensor buffer is reference counted, so queueing one
+  // costs no copy of the payload.
+  struct PendingSummary {
+    int64 step;
+    Tensor tensor;
+    string tag;
+    SummaryMetadata metadata;
+    uint64 now;
+    double computed_time;
+  };
+
   Status Write(int64 step, const Tensor& t, const string& tag,
                const SummaryMetadata& metadata) {
     uint64 now = env_->NowMicros();
-    double computed_time = DoubleTime(now);
-    int64 tag_id;
-    TF_RETURN_IF_ERROR(
-        meta_.GetTagId(db_, now, computed_time, tag, &tag_id, metadata));
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(
-        run_.Append(db_, tag_id, step, now, computed_time, t),
-        meta_.user_name(), "/", meta_.experiment_name(), "/", meta_.run_name(),
-        "/", tag, "@", step);
+    return Enqueue(step, t, tag, metadata, now, DoubleTime(now));
+  }
+
+  // Hands a summary to the committer thread. Returns the first error the
+  // committer encountered, if any; summaries enqueued after a failure are
+  // rejected rather than silently dropped.
+  Status Enqueue(int64 step, const Tensor& t, const string& tag,
+                 const SummaryMetadata& metadata, uint64 now,
+                 double computed_time) LOCKS_EXCLUDED(mu_) {
+    mutex_lock lock(mu_);
+    // Block rather than buffer without bound if the committer can't keep
+    // up; kMaxQueueBytes caps the memory the queue may hold.
+    while (status_.ok() && queue_bytes_ >= kMaxQueueBytes) {
+      drained_.wait(lock);
+    }
+    TF_RETURN_IF_ERROR(status_);
+    queue_bytes_ += t.TotalBytes();
+    queue_.push_back(
+        PendingSummary{step, t, tag, metadata, now, computed_time});
+    wakeup_.notify_one();
     return Status::OK();
   }
 
+  void RunCommitterThread() LOCKS_EXCLUDED(mu_) {
+    std::vector<PendingSummary> batch;
+    while (true) {
+      {
+        mutex_lock lock(mu_);
+        while (queue_.empty() && !shutdown_) {
+          wakeup_.wait(lock);
+        }
+        if (queue_.empty() && shutdown_) return;
+        batch.swap(queue_);
+        is_committing_ = true;
+      }
+      Status s = CommitBatch(&batch);
+      uint64 bytes = 0;
+      for (const PendingSummary& p : batch) {
+        bytes += p.tensor.TotalBytes();
+      }
+      batch.clear();
+      {
+        mutex_lock lock(mu_);
+        is_committing_ = false;
+        queue_bytes_ -= bytes;
+        if (!s.ok() && status_.ok()) status_ = s;
+        drained_.notify_all();
+      }
+    }
+  }
+
+  // Commits a drained batch inside as few transactions as possible. The
+  // transaction is only for performance; each summary lands in its own
+  // preallocated row, so partial commits can't corrupt the series.
+  Status CommitBatch(std::vector<PendingSummary>* batch)
+      SQLITE_TRANSACTIONS_EXCLUDED(*db_) {
+    SqliteTransaction txn(*db_);
+    uint64 unflushed_bytes = 0;
+    for (const PendingSummary& p : *batch) {
+      int64 tag_id;
+      TF_RETURN_IF_ERROR(meta_.GetTagId(db_, p.now, p.computed_time, p.tag,
+                                        &tag_id, p.metadata));
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(
+          run_.Append(db_, &txn, tag_id, p.step, p.now, p.computed_time,
+                      p.tensor),
+          meta_.user_name(), "/", meta_.experiment_name(), "/",
+          meta_.run_name(), "/", p.tag, "@", p.step);
+      unflushed_bytes += p.tensor.TotalBytes();
+      if (unflushed_bytes >= kFlushBytes) {
+        TF_RETURN_WITH_CONTEXT_IF_ERROR(txn.Commit(), "flushing ",
+                                        unflushed_bytes, " bytes");
+        unflushed_bytes = 0;
+      }
+    }
+    return txn.Commit();
+  }
+
   Status MigrateEvent(std::unique_ptr<Event> e) {
     switch (e->what_case()) {
       case Event::WhatCase::kSummary: {
@@ -1052,10 +1159,7 @@ class SummaryDbWriter : public SummaryWriterInterface {
     Tensor t;
     if (!t.FromProto(s->tensor())) return errors::InvalidArgument("bad proto");
     TF_RETURN_IF_ERROR(CheckSupportedType(t));
-    int64 tag_id;
-    TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
-                                      &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Enqueue(e->step(), t, s->tag(), s->metadata(), now, e->wall_time());
   }
 
   // TODO(jart): Refactor Summary -> Tensor logic into separate file.
@@ -1064,11 +1168,8 @@ class SummaryDbWriter : public SummaryWriterInterface {
     // See tensorboard/plugins/scalar/summary.py and data_compat.py
     Tensor t{DT_FLOAT, {}};
     t.scalar<float>()() = s->simple_value();
-    int64 tag_id;
     PatchPluginName(s->mutable_metadata(), kScalarPluginName);
-    TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
-                                      &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Enqueue(e->step(), t, s->tag(), s->metadata(), now, e->wall_time());
   }
 
   Status MigrateHistogram(const Event* e, Summary::Value* s, uint64 now) {
@@ -1095,11 +1196,8 @@ class SummaryDbWriter : public SummaryWriterInterface {
       data(j++) = histo.bucket_limit(i);
       data(j++) = histo.bucket(i);
     }
-    int64 tag_id;
     PatchPluginName(s->mutable_metadata(), kHistogramPluginName);
-    TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
-                                      &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Enqueue(e->step(), t, s->tag(), s->metadata(), now, e->wall_time());
   }
 
   Status MigrateImage(const Event* e, Summary::Value* s, uint64 now) {
@@ -1109,11 +1207,8 @@ class SummaryDbWriter : public SummaryWriterInterface {
     t.flat<string>()(0) = strings::StrCat(img->width());
     t.flat<string>()(1) = strings::StrCat(img->height());
     t.flat<string>()(2) = std::move(*img->mutable_encoded_image_string());
-    int64 tag_id;
     PatchPluginName(s->mutable_metadata(), kImagePluginName);
-    TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
-                                      &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Enqueue(e->step(), t, s->tag(), s->metadata(), now, e->wall_time());
   }
 
   Status MigrateAudio(const Event* e, Summary::Value* s, uint64 now) {
@@ -1122,11 +1217,8 @@ class SummaryDbWriter : public SummaryWriterInterface {
     auto wav = s->mutable_audio();
     t.flat<string>()(0) = std::move(*wav->mutable_encoded_audio_string());
     t.flat<string>()(1) = "";
-    int64 tag_id;
     PatchPluginName(s->mutable_metadata(), kAudioPluginName);
-    TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
-                                      &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Enqueue(e->step(), t, s->tag(), s->metadata(), now, e->wall_time());
   }
 
   Env* const env_;
@@ -1134,6 +1226,15 @@ class SummaryDbWriter : public SummaryWriterInterface {
   IdAllocator ids_;
   RunMetadata meta_;
   RunWriter run_;
+  mutex mu_;
+  condition_variable wakeup_;   // signaled when work is queued or shutting down
+  condition_variable drained_;  // signaled when the committer finishes a batch
+  std::vector<PendingSummary> queue_ GUARDED_BY(mu_);
+  uint64 queue_bytes_ GUARDED_BY(mu_) = 0;
+  bool is_committing_ GUARDED_BY(mu_) = false;
+  bool shutdown_ GUARDED_BY(mu_) = false;
+  Status status_ GUARDED_BY(mu_);
+  std::unique_ptr<Thread> committer_;
 };
 
 }  // namespace
@@ -0,0 +1,90 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/benchmark_baseline.h"
+
+#include <unordered_map>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
+
+namespace tensorflow {
+
+Status ReadBenchmarkEntriesFromPrefix(Env* env, const string& prefix,
+                                      BenchmarkEntries* entries) {
+  std::vector<string> files;
+  TF_RETURN_IF_ERROR(
+      env->GetMatchingPaths(strings::StrCat(prefix, "*"), &files));
+  for (const string& file : files) {
+    string contents;
+    TF_RETURN_IF_ERROR(ReadFileToString(env, file, &contents));
+    BenchmarkEntries parsed;
+    if (!parsed.ParseFromString(contents)) {
+      return errors::DataLoss("Failed to parse benchmark entries from: ",
+                              file);
+    }
+    for (const BenchmarkEntry& entry : parsed.entry()) {
+      *entries->add_entry() = entry;
+    }
+  }
+  return Status::OK();
+}
+
+std::vector<BenchmarkComparison> CompareBenchmarkEntries(
+    const BenchmarkEntries& baseline, const BenchmarkEntries& current,
+    const BenchmarkComparisonOptions& options) {
+  std::unordered_map<string, const BenchmarkEntry*> baseline_by_name;
+  for (const BenchmarkEntry& entry : baseline.entry()) {
+    baseline_by_name[entry.name()] = &entry;
+  }
+  std::vector<BenchmarkComparison> comparisons;
+  for (const BenchmarkEntry& entry : current.entry()) {
+    const auto it = baseline_by_name.find(entry.name());
+    if (it == baseline_by_name.end()) continue;
+    BenchmarkComparison comparison;
+    comparison.name = entry.name();
+    comparison.baseline_wall_time = it->second->wall_time();
+    comparison.current_wall_time = entry.wall_time();
+    if (comparison.baseline_wall_time > 0.0) {
+      comparison.ratio =
+          comparison.current_wall_time / comparison.baseline_wall_time;
+      comparison.regressed =
+          comparison.current_wall_time >
+          comparison.baseline_wall_time * options.max_wall_time_ratio;
+    }
+    comparisons.push_back(comparison);
+  }
+  return comparisons;
+}
+
+string BenchmarkComparisonReport(
+    const std::vector<BenchmarkComparison>& comparisons,
+    bool* any_regressed) {
+  *any_regressed = false;
+  string report = strings::Printf("%-40s %14s %14s %7s\n", "Benchmark",
+                                  "Baseline(ns)", "Current(ns)", "Ratio");
+  for (const BenchmarkComparison& comparison : comparisons) {
+    strings::Appendf(&report, "%-40s %14.0f %14.0f %7.2f%s\n",
+                     comparison.name.c_str(),
+                     comparison.baseline_wall_time * 1e9,
+                     comparison.current_wall_time * 1e9, comparison.ratio,
+                     comparison.regressed ? "  REGRESSED" : "");
+    if (comparison.regressed) *any_regressed = true;
+  }
+  return report;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,77 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_UTIL_BENCHMARK_BASELINE_H_
+#define TENSORFLOW_CORE_UTIL_BENCHMARK_BASELINE_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/test_log.pb.h"
+
+namespace tensorflow {
+
+// Utilities for comparing benchmark results against a stored baseline.
+//
+// Benchmarks built on platform/test_benchmark.h write one BenchmarkEntries
+// protobuf per benchmark when TEST_REPORT_FILE_PREFIX is set (see
+// util/reporter.h). A typical regression check runs the same suite under
+// two prefixes:
+//
+//   TEST_REPORT_FILE_PREFIX=/tmp/baseline_ ./runtime_benchmarks
+//   ... install the candidate build ...
+//   TEST_REPORT_FILE_PREFIX=/tmp/candidate_ ./runtime_benchmarks
+//
+// then loads both prefixes and reports entries whose per-iteration wall
+// time grew by more than the configured ratio.
+
+struct BenchmarkComparisonOptions {
+  // A benchmark counts as regressed when its per-iteration wall time
+  // exceeds baseline * max_wall_time_ratio.
+  double max_wall_time_ratio = 1.25;
+};
+
+// One benchmark present in both the baseline and the current run.
+struct BenchmarkComparison {
+  string name;
+  double baseline_wall_time = 0.0;  // Seconds per iteration.
+  double current_wall_time = 0.0;   // Seconds per iteration.
+  double ratio = 0.0;               // current / baseline.
+  bool regressed = false;
+};
+
+// Reads every BenchmarkEntries file matching "<prefix>*" and appends the
+// parsed entries to *entries.
+Status ReadBenchmarkEntriesFromPrefix(Env* env, const string& prefix,
+                                      BenchmarkEntries* entries);
+
+// Compares `current` against `baseline` by benchmark name, in the order of
+// `current`. Benchmarks present on only one side are skipped: a renamed or
+// new benchmark should not fail the comparison.
+std::vector<BenchmarkComparison> CompareBenchmarkEntries(
+    const BenchmarkEntries& baseline, const BenchmarkEntries& current,
+    const BenchmarkComparisonOptions& options);
+
+// Renders the comparisons as a table, marking regressed entries. Sets
+// *any_regressed to whether at least one entry regressed.
+string BenchmarkComparisonReport(
+    const std::vector<BenchmarkComparison>& comparisons, bool* any_regressed);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_BENCHMARK_BASELINE_H_
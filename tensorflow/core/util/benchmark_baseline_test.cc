@@ -0,0 +1,109 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/benchmark_baseline.h"
+
+#include <set>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+void AddEntry(BenchmarkEntries* entries, const string& name,
+              double wall_time) {
+  BenchmarkEntry* entry = entries->add_entry();
+  entry->set_name(name);
+  entry->set_iters(1000);
+  entry->set_wall_time(wall_time);
+}
+
+TEST(BenchmarkBaselineTest, FlagsRegressions) {
+  BenchmarkEntries baseline;
+  AddEntry(&baseline, "BM_Stable", 100e-9);
+  AddEntry(&baseline, "BM_Slower", 100e-9);
+  AddEntry(&baseline, "BM_RemovedSinceBaseline", 50e-9);
+
+  BenchmarkEntries current;
+  AddEntry(&current, "BM_Stable", 105e-9);
+  AddEntry(&current, "BM_Slower", 200e-9);
+  AddEntry(&current, "BM_NewSinceBaseline", 70e-9);
+
+  BenchmarkComparisonOptions options;
+  options.max_wall_time_ratio = 1.25;
+  const std::vector<BenchmarkComparison> comparisons =
+      CompareBenchmarkEntries(baseline, current, options);
+
+  // Benchmarks present on only one side are skipped.
+  ASSERT_EQ(2, comparisons.size());
+  EXPECT_EQ("BM_Stable", comparisons[0].name);
+  EXPECT_FALSE(comparisons[0].regressed);
+  EXPECT_EQ("BM_Slower", comparisons[1].name);
+  EXPECT_TRUE(comparisons[1].regressed);
+  EXPECT_NEAR(2.0, comparisons[1].ratio, 1e-6);
+
+  bool any_regressed = false;
+  const string report = BenchmarkComparisonReport(comparisons, &any_regressed);
+  EXPECT_TRUE(any_regressed);
+  EXPECT_TRUE(str_util::StrContains(report, "BM_Slower"));
+  EXPECT_TRUE(str_util::StrContains(report, "REGRESSED"));
+}
+
+TEST(BenchmarkBaselineTest, NoRegressions) {
+  BenchmarkEntries baseline;
+  AddEntry(&baseline, "BM_Stable", 100e-9);
+  BenchmarkEntries current;
+  AddEntry(&current, "BM_Stable", 100e-9);
+
+  const std::vector<BenchmarkComparison> comparisons =
+      CompareBenchmarkEntries(baseline, current,
+                              BenchmarkComparisonOptions());
+  ASSERT_EQ(1, comparisons.size());
+  bool any_regressed = true;
+  BenchmarkComparisonReport(comparisons, &any_regressed);
+  EXPECT_FALSE(any_regressed);
+}
+
+TEST(BenchmarkBaselineTest, ReadsEntriesWrittenUnderPrefix) {
+  Env* env = Env::Default();
+  const string prefix = io::JoinPath(testing::TmpDir(), "bench_baseline_");
+
+  // One BenchmarkEntries file per benchmark, as util/reporter.h writes them.
+  for (int i = 0; i < 2; ++i) {
+    BenchmarkEntries entries;
+    AddEntry(&entries, strings::StrCat("BM_FromFile", i), 100e-9);
+    TF_ASSERT_OK(WriteStringToFile(env, strings::StrCat(prefix, "file", i),
+                                   entries.SerializeAsString()));
+  }
+
+  BenchmarkEntries read;
+  TF_ASSERT_OK(ReadBenchmarkEntriesFromPrefix(env, prefix, &read));
+  ASSERT_EQ(2, read.entry_size());
+  // Matching files may be listed in any order.
+  std::set<string> names;
+  for (const BenchmarkEntry& entry : read.entry()) {
+    names.insert(entry.name());
+  }
+  EXPECT_EQ(1, names.count("BM_FromFile0"));
+  EXPECT_EQ(1, names.count("BM_FromFile1"));
+}
+
+}  // namespace
+}  // namespace tensorflow
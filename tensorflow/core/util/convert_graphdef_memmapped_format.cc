@@ -0,0 +1,116 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/util/convert_graphdef_memmapped_format.h"
+
+#include <unordered_set>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/memmapped_file_system.h"
+#include "tensorflow/core/util/memmapped_file_system_writer.h"
+
+namespace tensorflow {
+namespace {
+
+// Region names may contain only [A-Za-z0-9_.], but node names commonly
+// contain '/'. Replaces every disallowed character with '_'.
+string SanitizedRegionName(const string& node_name) {
+  string result = node_name;
+  for (char& c : result) {
+    const bool valid = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                       (c >= '0' && c <= '9') || c == '_' || c == '.';
+    if (!valid) {
+      c = '_';
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+Status ConvertConstantsToImmutable(const GraphDef& graph_def,
+                                   uint64 min_conversion_size_bytes, Env* env,
+                                   const string& output_filename) {
+  MemmappedFileSystemWriter writer;
+  TF_RETURN_IF_ERROR(writer.InitializeToFile(env, output_filename));
+
+  GraphDef converted_graph_def = graph_def;
+  std::unordered_set<string> used_region_names;
+  for (NodeDef& node : *converted_graph_def.mutable_node()) {
+    if (node.op() != "Const") {
+      continue;
+    }
+    const auto& attributes = node.attr();
+    const auto dtype_attr = attributes.find("dtype");
+    const auto value_attr = attributes.find("value");
+    if (dtype_attr == attributes.end() || value_attr == attributes.end()) {
+      return errors::InvalidArgument("Const node ", node.name(),
+                                     " is missing a dtype or value attribute");
+    }
+    const DataType dtype = dtype_attr->second.type();
+    // Constants whose in-memory representation contains pointers (e.g.
+    // DT_STRING) cannot be served from a memmapped region.
+    if (!DataTypeCanUseMemcpy(dtype)) {
+      continue;
+    }
+    Tensor parsed_tensor(dtype);
+    if (!parsed_tensor.FromProto(cpu_allocator(),
+                                 value_attr->second.tensor())) {
+      return errors::InvalidArgument("Cannot parse the value of node ",
+                                     node.name());
+    }
+    if (parsed_tensor.TotalBytes() < min_conversion_size_bytes) {
+      continue;
+    }
+    // Node names are unique, but sanitizing them can introduce collisions.
+    string region_name =
+        strings::StrCat(MemmappedFileSystem::kMemmappedPackagePrefix,
+                        SanitizedRegionName(node.name()));
+    while (!used_region_names.insert(region_name).second) {
+      strings::StrAppend(&region_name, "_");
+    }
+    TF_RETURN_IF_ERROR(writer.SaveTensor(parsed_tensor, region_name));
+
+    // Rewrite the node to serve its value from the saved region.
+    node.set_op("ImmutableConst");
+    node.clear_attr();
+    auto& attr = *node.mutable_attr();
+    attr["dtype"].set_type(dtype);
+    parsed_tensor.shape().AsProto(attr["shape"].mutable_shape());
+    attr["memory_region_name"].set_s(region_name);
+  }
+  TF_RETURN_IF_ERROR(writer.SaveProtobuf(
+      converted_graph_def,
+      MemmappedFileSystem::kMemmappedPackageDefaultGraphDef));
+  return writer.FlushAndClose();
+}
+
+Status ConvertGraphDefToMemmappedFormat(const string& in_graph_filename,
+                                        const string& out_graph_filename,
+                                        uint64 min_conversion_size_bytes) {
+  Env* env = Env::Default();
+  GraphDef graph_def;
+  TF_RETURN_IF_ERROR(ReadBinaryProto(env, in_graph_filename, &graph_def));
+  return ConvertConstantsToImmutable(graph_def, min_conversion_size_bytes, env,
+                                     out_graph_filename);
+}
+
+}  // namespace tensorflow
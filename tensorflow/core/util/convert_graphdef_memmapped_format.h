@@ -0,0 +1,51 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_UTIL_CONVERT_GRAPHDEF_MEMMAPPED_FORMAT_H_
+#define TENSORFLOW_CORE_UTIL_CONVERT_GRAPHDEF_MEMMAPPED_FORMAT_H_
+
+#include <string>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+
+// Rewrites a frozen inference GraphDef into the memmapped package format
+// understood by MemmappedEnv (see memmapped_file_system.h). The contents of
+// every large Const node are saved at an aligned offset of the package and
+// the node is replaced by an ImmutableConst node that serves its value
+// directly from the memmapped region, so that concurrent processes serving
+// the same model share a single page-cache copy of the weights. The
+// rewritten GraphDef itself is saved in the package under
+// MemmappedFileSystem::kMemmappedPackageDefaultGraphDef.
+//
+// Only constants of at least min_conversion_size_bytes are converted:
+// converting small constants would only grow the package because of the
+// alignment padding. Constants whose in-memory representation contains
+// pointers (e.g. DT_STRING) are never converted.
+Status ConvertConstantsToImmutable(const GraphDef& graph_def,
+                                   uint64 min_conversion_size_bytes, Env* env,
+                                   const string& output_filename);
+
+// Reads a binary GraphDef from in_graph_filename and writes the converted
+// package to out_graph_filename.
+Status ConvertGraphDefToMemmappedFormat(const string& in_graph_filename,
+                                        const string& out_graph_filename,
+                                        uint64 min_conversion_size_bytes);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_CONVERT_GRAPHDEF_MEMMAPPED_FORMAT_H_
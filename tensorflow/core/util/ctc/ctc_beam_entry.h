@@ -19,6 +19,8 @@ limitations under the License.
 
 #include <algorithm>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 #include "third_party/eigen3/Eigen/Core"
@@ -56,11 +58,16 @@ struct BeamProbability {
 template <class CTCBeamState>
 class BeamRoot;
 
+template <class CTCBeamState>
+class BeamEntryPool;
+
 template <class CTCBeamState = EmptyBeamState>
 struct BeamEntry {
   // BeamRoot<CTCBeamState>::AddEntry() serves as the factory method.
   friend BeamEntry<CTCBeamState>* BeamRoot<CTCBeamState>::AddEntry(
       BeamEntry<CTCBeamState>* p, int l);
+  // BeamEntryPool constructs entries in its pooled storage.
+  friend class BeamEntryPool<CTCBeamState>;
   inline bool Active() const { return newp.total != kLogZero; }
   // Return the child at the given index, or construct a new one in-place if
   // none was found.
@@ -108,25 +115,81 @@ struct BeamEntry {
   TF_DISALLOW_COPY_AND_ASSIGN(BeamEntry);
 };
 
-// This class owns all instances of BeamEntry.  This is used to avoid recursive
-// destructor call during destruction.
+// A pool of BeamEntry storage.  Entries are constructed in chunked
+// storage and recycled through a free list when their BeamRoot is
+// destroyed, so repeated decodes reuse the memory of earlier ones
+// instead of allocating every entry on the heap.  The pool is not
+// thread-safe; decoders running in parallel must each use their own.
+template <class CTCBeamState = EmptyBeamState>
+class BeamEntryPool {
+ public:
+  BeamEntryPool() {}
+  BeamEntryPool(const BeamEntryPool&) = delete;
+  BeamEntryPool& operator=(const BeamEntryPool&) = delete;
+
+  BeamEntry<CTCBeamState>* Allocate(BeamEntry<CTCBeamState>* p, int l,
+                                    BeamRoot<CTCBeamState>* beam_root) {
+    void* storage;
+    if (!free_list_.empty()) {
+      storage = free_list_.back();
+      free_list_.pop_back();
+    } else {
+      if (chunks_.empty() || chunk_used_ == kChunkSize) {
+        chunks_.emplace_back(new Storage[kChunkSize]);
+        chunk_used_ = 0;
+      }
+      storage = &chunks_.back()[chunk_used_++];
+    }
+    return new (storage) BeamEntry<CTCBeamState>(p, l, beam_root);
+  }
+
+  void Release(BeamEntry<CTCBeamState>* entry) {
+    entry->~BeamEntry<CTCBeamState>();
+    free_list_.push_back(entry);
+  }
+
+ private:
+  static const int kChunkSize = 512;
+  typedef typename std::aligned_storage<sizeof(BeamEntry<CTCBeamState>),
+                                        alignof(BeamEntry<CTCBeamState>)>::type
+      Storage;
+
+  std::vector<std::unique_ptr<Storage[]>> chunks_;
+  int chunk_used_ = 0;
+  std::vector<void*> free_list_;
+};
+
+// This class tracks all instances of BeamEntry allocated for it and
+// returns them to the pool on destruction.  Releasing the entries
+// iteratively avoids a recursive destructor call through the tree.
 template <class CTCBeamState = EmptyBeamState>
 class BeamRoot {
  public:
-  BeamRoot(BeamEntry<CTCBeamState>* p, int l) { root_entry_ = AddEntry(p, l); }
+  // The pool must outlive this object and all entries allocated from it.
+  BeamRoot(BeamEntry<CTCBeamState>* p, int l,
+           BeamEntryPool<CTCBeamState>* pool)
+      : pool_(pool) {
+    root_entry_ = AddEntry(p, l);
+  }
   BeamRoot(const BeamRoot&) = delete;
   BeamRoot& operator=(const BeamRoot&) = delete;
+  ~BeamRoot() {
+    for (BeamEntry<CTCBeamState>* entry : beam_entries_) {
+      pool_->Release(entry);
+    }
+  }
 
   BeamEntry<CTCBeamState>* AddEntry(BeamEntry<CTCBeamState>* p, int l) {
-    auto* new_entry = new BeamEntry<CTCBeamState>(p, l, this);
-    beam_entries_.emplace_back(new_entry);
+    BeamEntry<CTCBeamState>* new_entry = pool_->Allocate(p, l, this);
+    beam_entries_.push_back(new_entry);
     return new_entry;
   }
   BeamEntry<CTCBeamState>* RootEntry() const { return root_entry_; }
 
  private:
   BeamEntry<CTCBeamState>* root_entry_ = nullptr;
-  std::vector<std::unique_ptr<BeamEntry<CTCBeamState>>> beam_entries_;
+  std::vector<BeamEntry<CTCBeamState>*> beam_entries_;
+  BeamEntryPool<CTCBeamState>* pool_;
 };
 
 // BeamComparer is the default beam comparer provided in CTCBeamSearch.
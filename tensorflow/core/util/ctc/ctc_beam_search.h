@@ -74,6 +74,7 @@ class CTCBeamSearchDecoder : public CTCDecoder {
   //   P(l=abc? @ t=3) = P(a @ 0)*P(b @ 1)*P(c @ 2)*P(? @ 3)
   // but we calculate it recursively for speed purposes.
   typedef ctc_beam_search::BeamEntry<CTCBeamState> BeamEntry;
+  typedef ctc_beam_search::BeamEntryPool<CTCBeamState> BeamEntryPool;
   typedef ctc_beam_search::BeamRoot<CTCBeamState> BeamRoot;
   typedef ctc_beam_search::BeamProbability BeamProbability;
 
@@ -148,6 +149,7 @@ class CTCBeamSearchDecoder : public CTCDecoder {
   float label_selection_margin_ = -1;  // -1 means unlimited.
 
   gtl::TopN<BeamEntry*, CTCBeamComparer> leaves_;
+  BeamEntryPool entry_pool_;
   std::unique_ptr<BeamRoot> beam_root_;
   BaseBeamScorer<CTCBeamState>* beam_scorer_;
 
@@ -384,8 +386,10 @@ void CTCBeamSearchDecoder<CTCBeamState, CTCBeamComparer>::Reset() {
   leaves_.Reset();
 
   // This beam root, and all of its children, will be in memory until
-  // the next reset.
-  beam_root_.reset(new BeamRoot(nullptr, -1));
+  // the next reset.  Destroy the old root first so its entries are back
+  // on the pool's free list before the new root allocates.
+  beam_root_.reset();
+  beam_root_.reset(new BeamRoot(nullptr, -1, &entry_pool_));
   beam_root_->RootEntry()->newp.total = 0.0;  // ln(1)
   beam_root_->RootEntry()->newp.blank = 0.0;  // ln(1)
 
@@ -26,15 +26,35 @@ limitations under the License.
 #include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/event.pb.h"
 
 namespace tensorflow {
 
+namespace {
+
+// When positive, enables the asynchronous writing mode: see the queue members
+// in events_writer.h.
+constexpr char kMaxQueueEnvVar[] = "TF_EVENTS_WRITER_MAX_QUEUE";
+
+size_t MaxQueueFromEnv() {
+  int64 max_queue = 0;
+  Status status = ReadInt64FromEnvVar(kMaxQueueEnvVar, 0, &max_queue);
+  if (!status.ok() || max_queue < 0) {
+    LOG(ERROR) << "Invalid value of " << kMaxQueueEnvVar << ": " << status;
+    return 0;
+  }
+  return max_queue;
+}
+
+}  // namespace
+
 EventsWriter::EventsWriter(const string& file_prefix)
     // TODO(jeff,sanjay): Pass in env and use that here instead of Env::Default
     : env_(Env::Default()),
       file_prefix_(file_prefix),
-      num_outstanding_events_(0) {}
+      num_outstanding_events_(0),
+      max_queue_size_(MaxQueueFromEnv()) {}
 
 EventsWriter::~EventsWriter() {
   Close().IgnoreError();  // Autoclose in destructor.
@@ -51,6 +71,8 @@ Status EventsWriter::InitIfNeeded() {
   if (recordio_writer_ != nullptr) {
     CHECK(!filename_.empty());
     if (!FileStillExists().ok()) {
+      // Make sure the background writer is no longer touching the old file.
+      DrainQueue();
       // Warn user of data loss and let .reset() below do basic cleanup.
       if (num_outstanding_events_ > 0) {
         LOG(WARNING) << "Re-initialization, attempting to open a new file, "
@@ -109,10 +131,73 @@ void EventsWriter::WriteSerializedEvent(StringPiece event_str) {
       return;
     }
   }
+  if (max_queue_size_ > 0) {
+    EnqueueSerializedEvent(event_str);
+    return;
+  }
   num_outstanding_events_++;
   recordio_writer_->WriteRecord(event_str).IgnoreError();
 }
 
+void EventsWriter::EnqueueSerializedEvent(StringPiece event_str) {
+  if (writer_thread_ == nullptr) {
+    writer_thread_.reset(env_->StartThread(ThreadOptions(), "events_writer",
+                                           [this]() { WriterLoop(); }));
+  }
+  mutex_lock l(queue_mu_);
+  if (queue_.size() >= max_queue_size_) {
+    // Drop the oldest enqueued event to bound memory. The number of dropped
+    // events is reported on the next Flush().
+    queue_.pop_front();
+    ++dropped_events_;
+  }
+  queue_.emplace_back(event_str.data(), event_str.size());
+  queue_cv_.notify_one();
+}
+
+void EventsWriter::WriterLoop() {
+  while (true) {
+    std::deque<string> batch;
+    {
+      mutex_lock l(queue_mu_);
+      while (queue_.empty() && !writer_cancelled_) {
+        queue_cv_.wait(l);
+      }
+      if (queue_.empty() && writer_cancelled_) {
+        return;
+      }
+      // Take everything that is currently enqueued, so that consecutive
+      // events are appended to the file as one coalesced batch.
+      batch.swap(queue_);
+      writing_batch_ = true;
+    }
+    for (const string& event_str : batch) {
+      recordio_writer_->WriteRecord(event_str).IgnoreError();
+    }
+    {
+      mutex_lock l(queue_mu_);
+      num_outstanding_events_ += batch.size();
+      writing_batch_ = false;
+      drained_cv_.notify_all();
+    }
+  }
+}
+
+void EventsWriter::DrainQueue() {
+  if (writer_thread_ == nullptr) {
+    return;
+  }
+  mutex_lock l(queue_mu_);
+  while (!queue_.empty() || writing_batch_) {
+    drained_cv_.wait(l);
+  }
+  if (dropped_events_ > 0) {
+    LOG(WARNING) << "Dropped " << dropped_events_
+                 << " events to bound the queue of " << filename_;
+    dropped_events_ = 0;
+  }
+}
+
 // NOTE(touts); This is NOT the function called by the Python code.
 // Python calls WriteSerializedEvent(), see events_writer.i.
 void EventsWriter::WriteEvent(const Event& event) {
@@ -122,6 +207,7 @@ void EventsWriter::WriteEvent(const Event& event) {
 }
 
 Status EventsWriter::Flush() {
+  DrainQueue();
   if (num_outstanding_events_ == 0) return Status::OK();
   CHECK(recordio_file_ != nullptr) << "Unexpected NULL file";
 
@@ -150,6 +236,16 @@ Status EventsWriter::Flush() {
 
 Status EventsWriter::Close() {
   Status status = Flush();
+  if (writer_thread_ != nullptr) {
+    {
+      mutex_lock l(queue_mu_);
+      writer_cancelled_ = true;
+      queue_cv_.notify_one();
+    }
+    writer_thread_.reset();  // Joins the writer thread.
+    mutex_lock l(queue_mu_);
+    writer_cancelled_ = false;
+  }
   if (recordio_file_ != nullptr) {
     Status close_status = recordio_file_->Close();
     if (!close_status.ok()) {
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_EVENTS_WRITER_H_
 #define TENSORFLOW_CORE_UTIL_EVENTS_WRITER_H_
 
+#include <deque>
 #include <memory>
 #include <string>
 
@@ -23,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/event.pb.h"
 
@@ -73,7 +75,8 @@ class EventsWriter {
   // and/or check for success.
   //   Flush() pushes outstanding events to disk.  Returns false if the
   // events file could not be created, or if the file exists but could not
-  // be written too.
+  // be written too.  In the asynchronous mode, first drains the queue of
+  // pending events.
   //   Close() calls Flush() and then closes the current events file.
   // Returns true only if both the flush and the closure were successful.
   Status Flush();
@@ -82,6 +85,9 @@ class EventsWriter {
  private:
   Status FileStillExists();  // OK if event_file_path_ exists.
   Status InitIfNeeded();
+  void EnqueueSerializedEvent(tensorflow::StringPiece event_str);
+  void WriterLoop();
+  void DrainQueue();
 
   Env* env_;
   const string file_prefix_;
@@ -90,6 +96,22 @@ class EventsWriter {
   std::unique_ptr<WritableFile> recordio_file_;
   std::unique_ptr<io::RecordWriter> recordio_writer_;
   int num_outstanding_events_;
+
+  // When non-zero, events are enqueued (up to max_queue_size_ entries, with
+  // drop-oldest backpressure) and appended to the file in coalesced batches
+  // by a background thread, so that heavy summary logging stays off the
+  // caller's critical path. Controlled by the TF_EVENTS_WRITER_MAX_QUEUE
+  // environment variable; Flush() and Close() drain the queue before syncing.
+  const size_t max_queue_size_;
+  mutex queue_mu_;
+  condition_variable queue_cv_;
+  condition_variable drained_cv_;
+  std::deque<string> queue_ GUARDED_BY(queue_mu_);
+  bool writing_batch_ GUARDED_BY(queue_mu_) = false;
+  bool writer_cancelled_ GUARDED_BY(queue_mu_) = false;
+  int64 dropped_events_ GUARDED_BY(queue_mu_) = 0;
+  std::unique_ptr<Thread> writer_thread_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(EventsWriter);
 };
 
@@ -117,6 +117,32 @@ TEST(EventWriter, WriteFlush) {
   VerifyFile(filename);
 }
 
+TEST(EventWriter, AsyncWriteFlush) {
+  setenv("TF_EVENTS_WRITER_MAX_QUEUE", "128", 1);
+  {
+    string file_prefix = GetDirName("/asyncwriteflush_test");
+    EventsWriter writer(file_prefix);
+    WriteFile(&writer);
+    TF_EXPECT_OK(writer.Flush());
+    string filename = writer.FileName();
+    VerifyFile(filename);
+  }
+  unsetenv("TF_EVENTS_WRITER_MAX_QUEUE");
+}
+
+TEST(EventWriter, AsyncWriteClose) {
+  setenv("TF_EVENTS_WRITER_MAX_QUEUE", "128", 1);
+  {
+    string file_prefix = GetDirName("/asyncwriteclose_test");
+    EventsWriter writer(file_prefix);
+    WriteFile(&writer);
+    TF_EXPECT_OK(writer.Close());
+    string filename = writer.FileName();
+    VerifyFile(filename);
+  }
+  unsetenv("TF_EVENTS_WRITER_MAX_QUEUE");
+}
+
 TEST(EventWriter, WriteClose) {
   string file_prefix = GetDirName("/writeclose_test");
   EventsWriter writer(file_prefix);
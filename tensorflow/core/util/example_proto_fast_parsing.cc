@@ -64,6 +64,29 @@ constexpr uint8 kVarintTag(uint32 tag) { return (tag << 3) | 0; }
 constexpr uint8 kDelimitedTag(uint32 tag) { return (tag << 3) | 2; }
 constexpr uint8 kFixed32Tag(uint32 tag) { return (tag << 3) | 5; }
 
+// Decodes a single varint from the range [p, limit). On success stores the
+// decoded value in `value` and returns a pointer just past the consumed
+// bytes; on malformed or truncated input returns nullptr. This is a
+// direct-buffer replacement for CodedInputStream::ReadVarint64 in packed-list
+// hot loops, where the per-call overhead of the stream dominates the decode.
+inline const uint8* ParseVarint64Raw(const uint8* p, const uint8* limit,
+                                     protobuf_uint64* value) {
+  if (p < limit && *p < 0x80) {  // Common case: single-byte varint.
+    *value = *p;
+    return p + 1;
+  }
+  protobuf_uint64 result = 0;
+  for (int shift = 0; p < limit && shift <= 63; shift += 7) {
+    const uint8 byte = *p++;
+    result |= static_cast<protobuf_uint64>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      *value = result;
+      return p;
+    }
+  }
+  return nullptr;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -240,10 +263,23 @@ class Feature {
         if (!stream.ReadVarint32(&packed_length)) return false;
         auto packed_limit = stream.PushLimit(packed_length);
 
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64>(n));
+        // The stream is backed by a flat buffer, so the packed payload is
+        // contiguous; decode straight out of it instead of paying the
+        // CodedInputStream overhead for every element.
+        if (packed_length > 0) {
+          const void* data;
+          int size;
+          if (!stream.GetDirectBufferPointer(&data, &size)) return false;
+          if (static_cast<uint32>(size) < packed_length) return false;
+          const uint8* p = static_cast<const uint8*>(data);
+          const uint8* end = p + packed_length;
+          while (p < end) {
+            protobuf_uint64 n;  // There is no API for int64
+            p = ParseVarint64Raw(p, end, &n);
+            if (p == nullptr) return false;
+            int64_list->push_back(static_cast<int64>(n));
+          }
+          if (!stream.Skip(packed_length)) return false;
         }
 
         stream.PopLimit(packed_limit);
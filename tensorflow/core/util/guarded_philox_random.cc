@@ -53,9 +53,12 @@ void GuardedPhiloxRandom::Init(random::PhiloxRandom::ResultType counter,
 
 random::PhiloxRandom GuardedPhiloxRandom::ReserveSamples128(int64 samples) {
   CHECK(initialized_);
-  mutex_lock lock(mu_);
+  // Init happened-before any reservation, so generator_ is read-only here and
+  // splitting the stream only needs an atomic bump of the sample offset.
+  const uint64 offset = sample_offset_.fetch_add(static_cast<uint64>(samples),
+                                                 std::memory_order_relaxed);
   auto local = generator_;
-  generator_.Skip(samples);
+  local.Skip(offset);
   return local;
 }
 
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_GUARDED_PHILOX_RANDOM_H_
 #define TENSORFLOW_CORE_UTIL_GUARDED_PHILOX_RANDOM_H_
 
+#include <atomic>
+
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/platform/macros.h"
@@ -40,7 +42,7 @@ namespace tensorflow {
 class GuardedPhiloxRandom {
  public:
   // Must call Init to finish initialization
-  GuardedPhiloxRandom() : initialized_(false) {}
+  GuardedPhiloxRandom() : sample_offset_(0), initialized_(false) {}
 
   // Initialize the generator from attributes "seed" and "seed2".
   // If both seeds are unspecified, use random seeds.
@@ -53,8 +55,10 @@ class GuardedPhiloxRandom {
             random::PhiloxRandom::Key key);
 
   // Reserve a certain number of 128-bit samples.
-  // This function is thread safe.  The returned generator is valid for the
-  // given number of samples, and can be used without a lock.
+  // This function is thread safe and lock free: the reservation is a single
+  // atomic fetch-add on the outstanding-sample count, so concurrent kernels
+  // sharing a generator do not serialize on a mutex.  The returned generator
+  // is valid for the given number of samples, and can be used without a lock.
   random::PhiloxRandom ReserveSamples128(int64 samples);
 
   // Reserve a certain number of 32-bit samples.
@@ -71,7 +75,13 @@ class GuardedPhiloxRandom {
 
  private:
   mutex mu_;
-  random::PhiloxRandom generator_ GUARDED_BY(mu_);
+  // The base generator is written once under mu_ by Init, which must
+  // happen-before any reservation; after that it is only read.  Each
+  // reservation advances sample_offset_ instead of the generator itself.
+  // The 64-bit offset bounds the lifetime of one generator to 2^64 128-bit
+  // samples, which is far beyond what any kernel instance draws.
+  random::PhiloxRandom generator_;
+  std::atomic<uint64> sample_offset_;
   bool initialized_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(GuardedPhiloxRandom);
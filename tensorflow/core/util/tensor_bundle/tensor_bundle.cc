@@ -38,10 +38,12 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/io/cache.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/io/table_builder.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_slice_util.h"
 
@@ -714,6 +716,28 @@ Status MergeBundles(Env* env, gtl::ArraySlice<string> prefixes,
 
 // Interface for reading a tensor bundle.
 
+// Returns the block cache shared by the metadata tables of all BundleReaders
+// in the process, so that servers which open many bundles (e.g. parameter
+// servers restoring hundreds of shards) read each hot index block from disk
+// only once.  The capacity in megabytes is controlled by the
+// TF_TABLE_INDEX_CACHE_SIZE_MB environment variable; the default of 0
+// disables the cache.  Returns nullptr when the cache is disabled.
+static table::Cache* TableIndexBlockCache() {
+  static table::Cache* cache = []() -> table::Cache* {
+    int64 cache_size_mb;
+    Status s =
+        ReadInt64FromEnvVar("TF_TABLE_INDEX_CACHE_SIZE_MB", 0, &cache_size_mb);
+    if (!s.ok()) {
+      LOG(WARNING) << "Invalid TF_TABLE_INDEX_CACHE_SIZE_MB: "
+                   << s.error_message();
+      return nullptr;
+    }
+    if (cache_size_mb <= 0) return nullptr;
+    return table::NewLRUCache(cache_size_mb << 20);
+  }();
+  return cache;
+}
+
 BundleReader::BundleReader(Env* env, StringPiece prefix)
     : env_(env),
       prefix_(prefix),
@@ -730,7 +754,9 @@ BundleReader::BundleReader(Env* env, StringPiece prefix)
   status_ = env_->NewRandomAccessFile(filename, &wrapper);
   if (!status_.ok()) return;
   metadata_ = wrapper.release();
-  status_ = table::Table::Open(table::Options(), metadata_, file_size, &table_);
+  table::Options o;
+  o.block_cache = TableIndexBlockCache();
+  status_ = table::Table::Open(o, metadata_, file_size, &table_);
   if (!status_.ok()) return;
   iter_ = table_->NewIterator();
 
@@ -1063,6 +1089,16 @@ Status BundleReader::LookupTensorShape(StringPiece key, TensorShape* shape) {
   return LookupDtypeAndShape(key, &ignored, shape);
 }
 
+Status BundleReader::LookupTensorPlacement(StringPiece key, int32* shard_id,
+                                           int64* offset, int64* size) {
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  *shard_id = entry.shard_id();
+  *offset = entry.offset();
+  *size = entry.size();
+  return Status::OK();
+}
+
 string BundleReader::DebugString() {
   // Format used below emulates that of TensorSliceReader::DebugString().
   string shape_str;
@@ -1080,7 +1116,24 @@ string BundleReader::DebugString() {
   return shape_str;
 }
 
-FileOutputBuffer::~FileOutputBuffer() { delete file_; }
+FileOutputBuffer::FileOutputBuffer(WritableFile* file, size_t buffer_size)
+    : file_(file), position_(0), buffer_size_(buffer_size) {
+  DCHECK_GT(buffer_size, 0);
+  buffer_.resize(buffer_size);
+  flush_buffer_.resize(buffer_size);
+  writer_thread_.reset(Env::Default()->StartThread(
+      ThreadOptions(), "bundle_writer", [this]() { WriteLoop(); }));
+}
+
+FileOutputBuffer::~FileOutputBuffer() {
+  {
+    mutex_lock l(mu_);
+    cancelled_ = true;
+    work_ready_.notify_one();
+  }
+  writer_thread_.reset();  // Joins.
+  delete file_;
+}
 
 Status FileOutputBuffer::Append(StringPiece data) {
   // In the below, it is critical to calculate the checksum on the actually
@@ -1114,15 +1167,52 @@ Status FileOutputBuffer::Append(StringPiece data) {
 
 Status FileOutputBuffer::Close() {
   TF_RETURN_IF_ERROR(FlushBuffer());
+  {
+    // Wait for the final chunk to reach the file and stop the writer.
+    mutex_lock l(mu_);
+    while (flush_size_ != 0) write_done_.wait(l);
+    cancelled_ = true;
+    work_ready_.notify_one();
+    TF_RETURN_IF_ERROR(write_status_);
+  }
+  writer_thread_.reset();  // Joins.
   return file_->Close();
 }
 
 Status FileOutputBuffer::FlushBuffer() {
   if (position_ > 0) {
-    TF_RETURN_IF_ERROR(file_->Append(StringPiece(&buffer_[0], position_)));
+    mutex_lock l(mu_);
+    // At most one chunk may be in flight; wait until the writer is idle, then
+    // trade buffers with it so the caller can keep filling the other one.
+    while (flush_size_ != 0) write_done_.wait(l);
+    TF_RETURN_IF_ERROR(write_status_);
+    buffer_.swap(flush_buffer_);
+    flush_size_ = position_;
     position_ = 0;
+    work_ready_.notify_one();
   }
   return Status::OK();
 }
 
+void FileOutputBuffer::WriteLoop() {
+  while (true) {
+    StringPiece chunk;
+    {
+      mutex_lock l(mu_);
+      while (flush_size_ == 0 && !cancelled_) work_ready_.wait(l);
+      if (cancelled_) return;
+      chunk = StringPiece(&flush_buffer_[0], flush_size_);
+    }
+    // The append happens outside the lock; flush_size_ != 0 keeps the caller
+    // from touching flush_buffer_ until it completes.
+    Status s = file_->Append(chunk);
+    {
+      mutex_lock l(mu_);
+      if (!s.ok() && write_status_.ok()) write_status_ = s;
+      flush_size_ = 0;
+      write_done_.notify_one();
+    }
+  }
+}
+
 }  // namespace tensorflow
@@ -77,6 +77,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_slice_set.h"
@@ -204,6 +205,13 @@ class BundleReader {
   Status LookupTensorShape(StringPiece key,
                            TensorShape* shape) TF_MUST_USE_RESULT;
 
+  // Looks up where the tensor keyed by "key" is stored: the data shard it
+  // lives in and its byte offset and stored size within that shard.  Callers
+  // restoring many tensors can use this to order their reads so that each
+  // shard file is read sequentially instead of with random seeks.
+  Status LookupTensorPlacement(StringPiece key, int32* shard_id, int64* offset,
+                               int64* size) TF_MUST_USE_RESULT;
+
   // Looks up the tensor keyed by "key".  If "key" refers to a partitioned
   // tensor, attempts to look up the full contents using all stored slices.
   //
@@ -308,13 +316,16 @@ class BundleReader {
 // A buffering wrapper for a WritableFile.  Useful if the caller wishes to issue
 // small writes to a file (e.g. writing out a list of small varints).
 // External synchronization must be used in the presence of concurrent callers.
+//
+// Writes are double-buffered: a background thread appends filled buffers to
+// the underlying file while the calling thread copies and checksums the next
+// chunk into a second buffer.  This overlaps tensor serialization with file
+// I/O, so a save stalls the caller only for the memcpy/crc32c time unless the
+// file cannot keep up.  Any write error is surfaced by a later Append() or by
+// Close().
 class FileOutputBuffer {
  public:
-  FileOutputBuffer(WritableFile* file, size_t buffer_size)
-      : file_(file), position_(0), buffer_size_(buffer_size) {
-    DCHECK_GT(buffer_size, 0);
-    buffer_.resize(buffer_size);
-  }
+  FileOutputBuffer(WritableFile* file, size_t buffer_size);
   ~FileOutputBuffer();
 
   // Buffered append.
@@ -329,19 +340,37 @@ class FileOutputBuffer {
   Status Close();
 
  private:
-  // Appends the buffered data to the underlying file. Does NOT flush the file.
+  // Hands the buffered data to the background thread for appending to the
+  // underlying file; waits for any in-flight append first.  Does NOT flush
+  // the file.
   Status FlushBuffer();
 
-  WritableFile* file_;  // Owned.
+  // Body of the background thread: appends handed-off buffers to file_.
+  void WriteLoop();
 
-  // buffer_[0, position_) holds the buffered data not yet appended to the
-  // underlying file.
+  WritableFile* file_;  // Owned.  Written only by the background thread.
+
+  // buffer_[0, position_) holds the buffered data not yet handed off to the
+  // background thread.
   size_t position_;
   const size_t buffer_size_;
   std::vector<char> buffer_;
 
   // Checksum of all appended bytes since construction or last clear_crc32c().
   uint32 crc32c_ = 0;
+
+  mutex mu_;
+  condition_variable work_ready_;  // a buffer was handed off, or cancelled_.
+  condition_variable write_done_;  // the in-flight append finished.
+  // flush_buffer_[0, flush_size_) is the chunk currently owned by the
+  // background thread; flush_size_ == 0 means the thread is idle.
+  std::vector<char> flush_buffer_;
+  size_t flush_size_ GUARDED_BY(mu_) = 0;
+  // First error from the background thread; sticky until Close().
+  Status write_status_ GUARDED_BY(mu_);
+  bool cancelled_ GUARDED_BY(mu_) = false;
+
+  std::unique_ptr<Thread> writer_thread_;
 };
 
 }  // namespace tensorflow
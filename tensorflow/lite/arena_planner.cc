@@ -13,10 +13,21 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/arena_planner.h"
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 namespace tflite {
 
+namespace {
+
+int64_t AlignOffset(int64_t offset, int alignment) {
+  return offset % alignment == 0 ? offset
+                                 : offset + (alignment - offset % alignment);
+}
+
+}  // namespace
+
 struct AllocationInfo {
   // The node index requesting this allocation.
   int node;
@@ -36,6 +47,7 @@ ArenaPlanner::ArenaPlanner(TfLiteContext* context,
       persistent_arena_(kDefaultArenaAlignment),
       preserve_inputs_(preserve_inputs),
       preserve_intermediates_(preserve_intermediates),
+      has_nonpersistent_memory_(false),
       tensor_alignment_(tensor_alignment) {}
 
 ArenaPlanner::~ArenaPlanner() {}
@@ -204,9 +216,161 @@ TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
   return kTfLiteOk;
 }
 
+TfLiteStatus ArenaPlanner::ReleaseNonPersistentMemory() {
+  TF_LITE_ENSURE_STATUS(arena_.ReleaseBuffer());
+  has_nonpersistent_memory_ = false;
+  // Set the data pointers of the affected tensors to null so that stale
+  // reads fail fast instead of touching memory now owned by the pool.
+  for (int i = 0; i < graph_info_->num_tensors(); ++i) {
+    TfLiteTensor& tensor = *graph_info_->tensor(i);
+    if (tensor.allocation_type == kTfLiteArenaRw) {
+      tensor.data.raw = nullptr;
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus ArenaPlanner::AcquireNonPersistentMemory() {
+  // The allocation plan is unchanged; only the backing buffer needs to be
+  // leased again and the tensor pointers re-resolved against its base.
+  TF_LITE_ENSURE_STATUS(arena_.Commit(context_));
+  has_nonpersistent_memory_ = true;
+  for (int i = 0; i < graph_info_->num_tensors(); ++i) {
+    TfLiteTensor& tensor = *graph_info_->tensor(i);
+    if (tensor.allocation_type == kTfLiteArenaRw) {
+      TF_LITE_ENSURE_STATUS(ResolveTensorAllocation(i));
+    }
+  }
+  return kTfLiteOk;
+}
+
+bool ArenaPlanner::HasNonPersistentMemory() {
+  return has_nonpersistent_memory_;
+}
+
+TfLiteStatus ArenaPlanner::ComputeOfflinePlan(std::vector<int64_t>* offsets) {
+  const int num_tensors = graph_info_->num_tensors();
+  const int num_nodes = graph_info_->num_nodes();
+
+  // First and last node during which each tensor must be resident. Tensors
+  // that are never deallocated (e.g. graph outputs) stay alive past the last
+  // node.
+  std::vector<int> first_node(num_tensors, -1);
+  std::vector<int> last_node(num_tensors, num_nodes);
+  for (const auto& alloc_info : alloc_queue_) {
+    if (alloc_info.type == AllocationInfo::ALLOC) {
+      first_node[alloc_info.tensor] = alloc_info.node;
+    } else {
+      // The DEALLOC entry is emitted by the last node reading the tensor, so
+      // the tensor is still in use while that node runs.
+      last_node[alloc_info.tensor] = alloc_info.node;
+    }
+  }
+  // Temporary tensors are not part of the allocation queue; they only live
+  // while their node executes.
+  for (int i = 0; i < num_nodes; ++i) {
+    TfLiteIntArray* node_temporaries = graph_info_->node(i).temporaries;
+    for (int j = 0; j < node_temporaries->size; ++j) {
+      int tensor_index = node_temporaries->data[j];
+      first_node[tensor_index] = i;
+      last_node[tensor_index] = i;
+    }
+  }
+
+  offsets->assign(num_tensors, kOfflinePlanNoAllocation);
+
+  // Place the largest tensors first: they are the hardest to fit, and the
+  // smaller ones are more likely to slot into the gaps they leave behind.
+  std::vector<int> tensor_order;
+  for (int i = 0; i < num_tensors; ++i) {
+    const TfLiteTensor& tensor = *graph_info_->tensor(i);
+    if (first_node[i] >= 0 && tensor.allocation_type == kTfLiteArenaRw &&
+        tensor.bytes > 0) {
+      tensor_order.push_back(i);
+    }
+  }
+  std::sort(tensor_order.begin(), tensor_order.end(), [this](int a, int b) {
+    const size_t bytes_a = graph_info_->tensor(a)->bytes;
+    const size_t bytes_b = graph_info_->tensor(b)->bytes;
+    if (bytes_a != bytes_b) return bytes_a > bytes_b;
+    return a < b;
+  });
+
+  for (int tensor_index : tensor_order) {
+    const int64_t size = graph_info_->tensor(tensor_index)->bytes;
+
+    // Collect the already placed tensors whose lifetimes overlap with this
+    // one; only they constrain where it can go.
+    std::vector<std::pair<int64_t, int64_t>> conflicts;  // {offset, size}
+    for (int other : tensor_order) {
+      if ((*offsets)[other] == kOfflinePlanNoAllocation) continue;
+      if (first_node[other] > last_node[tensor_index] ||
+          first_node[tensor_index] > last_node[other]) {
+        continue;
+      }
+      conflicts.emplace_back(
+          (*offsets)[other],
+          static_cast<int64_t>(graph_info_->tensor(other)->bytes));
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+
+    // Best fit: take the smallest gap between conflicting tensors that is
+    // still large enough, or go past all of them.
+    int64_t best_offset = -1;
+    int64_t best_fit = std::numeric_limits<int64_t>::max();
+    int64_t current_offset = 0;
+    for (const auto& conflict : conflicts) {
+      int64_t aligned_offset = AlignOffset(current_offset, tensor_alignment_);
+      if (aligned_offset + size <= conflict.first &&
+          conflict.first - current_offset < best_fit) {
+        best_offset = aligned_offset;
+        best_fit = conflict.first - current_offset;
+      }
+      current_offset = std::max(current_offset,
+                                conflict.first + conflict.second);
+    }
+    if (best_offset < 0) {
+      best_offset = AlignOffset(current_offset, tensor_alignment_);
+    }
+    (*offsets)[tensor_index] = best_offset;
+  }
+
+  return kTfLiteOk;
+}
+
+TfLiteStatus ArenaPlanner::ExecuteOfflinePlan(
+    const std::vector<int64_t>& offsets) {
+  TF_LITE_ENSURE_EQ(context_, offsets.size(), graph_info_->num_tensors());
+  TF_LITE_ENSURE_STATUS(ResetAllocations());
+
+  for (int i = 0; i < graph_info_->num_tensors(); ++i) {
+    TfLiteTensor& tensor = *graph_info_->tensor(i);
+    if (tensor.allocation_type == kTfLiteArenaRw) {
+      if (offsets[i] == kOfflinePlanNoAllocation) continue;
+      TF_LITE_ENSURE(context_, offsets[i] >= 0);
+      TF_LITE_ENSURE_STATUS(
+          arena_.AllocateAt(context_, offsets[i], tensor.bytes, &allocs_[i]));
+    }
+    // Persistent tensors are not part of the plan; their arena never reuses
+    // memory, so the regular allocator is already optimal for them.
+    if (tensor.allocation_type == kTfLiteArenaRwPersistent) {
+      TF_LITE_ENSURE_STATUS(persistent_arena_.Allocate(
+          context_, tensor_alignment_, tensor.bytes, &allocs_[i]));
+    }
+  }
+
+  TF_LITE_ENSURE_STATUS(Commit());
+  for (int i = 0; i < graph_info_->num_tensors(); ++i) {
+    TF_LITE_ENSURE_STATUS(ResolveTensorAllocation(i));
+  }
+
+  return kTfLiteOk;
+}
+
 TfLiteStatus ArenaPlanner::Commit() {
   TF_LITE_ENSURE_STATUS(arena_.Commit(context_));
   TF_LITE_ENSURE_STATUS(persistent_arena_.Commit(context_));
+  has_nonpersistent_memory_ = true;
   return kTfLiteOk;
 }
 
@@ -297,6 +461,11 @@ TfLiteStatus ArenaPlanner::CalculateAllocationOfInternalTensors(
 
 TfLiteStatus ArenaPlanner::CalculateDeallocationOfInternalTensors(
     int node_index) {
+  // When intermediates are preserved no memory may be reused, so temporaries
+  // are kept alive just like the regular intermediate tensors.
+  if (preserve_intermediates_) {
+    return kTfLiteOk;
+  }
   if (node_index < graph_info_->num_nodes()) {
     const TfLiteNode& node = graph_info_->node(node_index);
     TfLiteIntArray* node_temporaries = node.temporaries;
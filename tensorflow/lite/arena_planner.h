@@ -29,6 +29,10 @@ namespace tflite {
 constexpr const int kDefaultArenaAlignment = 64;
 constexpr const int kDefaultTensorAlignment = 64;
 
+// Offset used in an offline plan for tensors that don't get arena memory
+// (e.g. dynamic or zero-sized tensors).
+constexpr const int64_t kOfflinePlanNoAllocation = -1;
+
 struct AllocationInfo;
 
 // A memory planner that makes all the allocations using arenas.
@@ -60,6 +64,27 @@ class ArenaPlanner : public MemoryPlanner {
   TfLiteStatus ResetAllocations() override;
   TfLiteStatus PlanAllocations() override;
   TfLiteStatus ExecuteAllocations(int first_node, int last_node) override;
+  TfLiteStatus ReleaseNonPersistentMemory() override;
+  TfLiteStatus AcquireNonPersistentMemory() override;
+  bool HasNonPersistentMemory() override;
+
+  // Computes an offset for every arena tensor ahead of time, without touching
+  // the arenas. Tensor lifetimes are derived from the allocation plan, and
+  // tensors are placed largest-first at the best-fitting offset among the
+  // tensors whose lifetimes overlap theirs. This typically packs the arena
+  // tighter than the incremental first-fit done by ExecuteAllocations, and
+  // the offsets are plain numbers that can be stored next to the model (e.g.
+  // in a metadata buffer) and handed to ExecuteOfflinePlan later on.
+  // PlanAllocations() must have been called first. Entries for tensors that
+  // don't get arena memory are set to kOfflinePlanNoAllocation.
+  TfLiteStatus ComputeOfflinePlan(std::vector<int64_t>* offsets);
+
+  // Applies a precomputed offset plan, e.g. one produced earlier by
+  // ComputeOfflinePlan(), skipping the execution-order planning walk
+  // entirely. The plan is only valid for the exact graph and tensor sizes it
+  // was computed for; graphs with dynamic tensors must keep using
+  // ExecuteAllocations() instead.
+  TfLiteStatus ExecuteOfflinePlan(const std::vector<int64_t>& offsets);
 
   // Returns the base arena location for a given allocation type.
   int64_t BasePointer(TfLiteAllocationType type);
@@ -118,6 +143,10 @@ class ArenaPlanner : public MemoryPlanner {
   // results can be queried after running (modulo running delegates).
   bool preserve_intermediates_;
 
+  // False while the non-persistent arena buffer is handed back to the
+  // process-wide buffer pool. See ReleaseNonPersistentMemory().
+  bool has_nonpersistent_memory_;
+
   // Number of bytes that tensor buffers should be aligned to.
   int tensor_alignment_;
 };
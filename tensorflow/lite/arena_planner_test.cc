@@ -506,6 +506,57 @@ TEST_F(ArenaPlannerTest, LargerGraphAndStepwiseAllocation) {
   EXPECT_EQ(GetOffset(10), 0);
 }
 
+TEST_F(ArenaPlannerTest, OfflinePlanSimpleGraph) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+
+  std::vector<int64_t> offsets;
+  ASSERT_EQ(planner_->ComputeOfflinePlan(&offsets), kTfLiteOk);
+  ASSERT_EQ(offsets.size(), graph.tensors()->size());
+
+  // Tensors are placed largest first: #5 (18 bytes), #4 (15), #3 (12),
+  // #2 (9), #1 (6), #0 (3). Each one takes the best-fitting spot among the
+  // tensors it overlaps with in time. In particular #1 dies before #4 and #5
+  // are born, so it can sit at offset 0 below #5, and the output #3 reuses
+  // the space just vacated by #2.
+  EXPECT_EQ(offsets[5], 0);
+  EXPECT_EQ(offsets[4], 20);
+  EXPECT_EQ(offsets[3], 36);
+  EXPECT_EQ(offsets[2], 36);
+  EXPECT_EQ(offsets[1], 0);
+  EXPECT_EQ(offsets[0], 48);
+
+  // Applying the plan must hand every tensor its planned offset.
+  ASSERT_EQ(planner_->ExecuteOfflinePlan(offsets), kTfLiteOk);
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    EXPECT_EQ(GetOffset(i), offsets[i]);
+  }
+}
+
+TEST_F(ArenaPlannerTest, ExecuteOfflinePlanWithPrecomputedOffsets) {
+  TestGraph graph({1}, {{{1}, {2}, {}}}, {2});
+  SetGraph(&graph);
+
+  // Simulate a plan loaded from storage instead of one computed here.
+  std::vector<int64_t> offsets = {kOfflinePlanNoAllocation, 8, 32};
+  ASSERT_EQ(planner_->ExecuteOfflinePlan(offsets), kTfLiteOk);
+
+  EXPECT_TRUE((*graph.tensors())[0].data.raw == nullptr);
+  EXPECT_EQ(GetOffset(1), 8);
+  EXPECT_EQ(GetOffset(2), 32);
+
+  // A plan sized for a different graph is rejected.
+  std::vector<int64_t> truncated_offsets = {kOfflinePlanNoAllocation, 8};
+  EXPECT_EQ(planner_->ExecuteOfflinePlan(truncated_offsets), kTfLiteError);
+}
+
 TEST_F(ArenaPlannerTest, ModifiedGraph) {
   TestGraph graph({0, 1},
                   {
@@ -15,7 +15,11 @@ limitations under the License.
 
 #include "tensorflow/lite/core/subgraph.h"
 
+#include <algorithm>
 #include <complex>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "tensorflow/lite/arena_planner.h"
 #include "tensorflow/lite/c/c_api_internal.h"
@@ -305,8 +309,19 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
                                            &node_subsets);
 
   execution_plan_.clear();
+  UnsealInvocation();
 
   for (auto& node_subset : node_subsets) {
+    // Partitions whose boundary copies are expected to cost more than the
+    // delegate saves stay on the CPU.
+    if (node_subset.type == NodeSubset::kTfPartition &&
+        !PartitionIsProfitable(node_subset)) {
+      TFLITE_LOG(tflite::TFLITE_LOG_INFO,
+                 "Keeping partition of %zu node(s) on the CPU: below the "
+                 "configured delegation profitability threshold.",
+                 node_subset.nodes.size());
+      node_subset.type = NodeSubset::kTfNonPartition;
+    }
     // Subsets claimed by the delegate should have a "macro" op created, the
     // other node_subsets (kTfNonPartition) just have their nodes added back to
     // the execution plan.
@@ -503,10 +518,16 @@ TfLiteStatus Subgraph::AllocateTensors() {
   // allocation as the client may have done the resize manually.
   if (state_ != kStateUninvokable &&
       !HasDynamicTensorImpl(*context_, inputs())) {
+    if (memory_planner_ && !memory_planner_->HasNonPersistentMemory()) {
+      // The plan is still valid; only the released arena buffer needs to be
+      // leased back.
+      TF_LITE_ENSURE_STATUS(memory_planner_->AcquireNonPersistentMemory());
+    }
     return kTfLiteOk;
   }
 
   next_execution_plan_index_to_prepare_ = 0;
+  UnsealInvocation();
   if (memory_planner_) {
     TF_LITE_ENSURE_STATUS(memory_planner_->ResetAllocations());
   }
@@ -524,6 +545,20 @@ TfLiteStatus Subgraph::AllocateTensors() {
   return kTfLiteOk;
 }
 
+TfLiteStatus Subgraph::ReleaseNonPersistentMemory() {
+  if (memory_planner_) {
+    TF_LITE_ENSURE_STATUS(memory_planner_->ReleaseNonPersistentMemory());
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::AcquireNonPersistentMemory() {
+  if (memory_planner_) {
+    TF_LITE_ENSURE_STATUS(memory_planner_->AcquireNonPersistentMemory());
+  }
+  return kTfLiteOk;
+}
+
 // TODO(ycling): Support non-zero default values.
 TfLiteStatus Subgraph::ResetVariableTensors() {
   for (auto& tensor : tensors_) {
@@ -553,6 +588,7 @@ TfLiteStatus Subgraph::AddNodeWithParameters(
     return kTfLiteError;
   }
   state_ = kStateUninvokable;
+  UnsealInvocation();
 
   TF_LITE_ENSURE_OK(context_, CheckTensorIndices("node inputs", inputs.data(),
                                                  inputs.size()));
@@ -663,9 +699,13 @@ TfLiteStatus Subgraph::PrepareOpsStartingAt(
 
 TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   if (!memory_planner_) {
+    // In parallel execution mode ops run out of execution plan order, so two
+    // concurrently live tensors must never share arena space; preserving
+    // intermediates disables all memory reuse.
     memory_planner_.reset(new ArenaPlanner(
         context_, std::unique_ptr<GraphInfo>(new InterpreterInfo(this)),
-        /*preserve_inputs=*/true, /*preserve_intermediates*/ false));
+        /*preserve_inputs=*/true,
+        /*preserve_intermediates=*/parallel_execution_));
     memory_planner_->PlanAllocations();
   }
 
@@ -692,6 +732,13 @@ TfLiteStatus Subgraph::Invoke() {
     return kTfLiteError;
   }
 
+  if (memory_planner_ && !memory_planner_->HasNonPersistentMemory()) {
+    ReportError(
+        "Non-persistent memory was released and must be acquired again "
+        "before Invoke().");
+    return kTfLiteError;
+  }
+
   // This is only needed for UseNNAPI(true);
   if (should_apply_nnapi_delegate_ && !applied_nnapi_delegate_) {
     TF_LITE_ENSURE_OK(context_, ModifyGraphWithDelegate(NnApiDelegate()));
@@ -699,63 +746,288 @@ TfLiteStatus Subgraph::Invoke() {
     applied_nnapi_delegate_ = true;
   }
 
+  // In parallel execution mode the whole plan must be prepared and statically
+  // allocated before ops can run out of order; graphs with dynamic tensors
+  // fall back to the serial path below.
+  if (parallel_execution_) {
+    if (next_execution_plan_index_to_prepare_ <
+        static_cast<int>(execution_plan_.size())) {
+      TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
+    }
+    if (next_execution_plan_index_to_prepare_ >=
+            static_cast<int>(execution_plan_.size()) &&
+        !has_dynamic_tensors_) {
+      return InvokeParallel();
+    }
+  }
+
+  // Sealed fast path: every per-node check below was already performed when
+  // the call list was captured, so the ops can be run directly.
+  int first_execution_plan_index = 0;
+  if (invocation_sealed_) {
+    for (size_t i = 0; i < sealed_calls_.size(); ++i) {
+      if (check_cancelled_func_ != nullptr &&
+          check_cancelled_func_(cancellation_data_)) {
+        ReportError("Client requested cancel during Invoke()");
+        return kTfLiteError;
+      }
+      // Copied so the entry survives a mid-run unseal.
+      const SealedCall call = sealed_calls_[i];
+      if (call.invoke(context_, call.node) == kTfLiteError) {
+        UnsealInvocation();
+        return ReportOpError(context_, *call.node,
+                             nodes_and_registration_[call.node_index].second,
+                             call.node_index, "failed to invoke");
+      }
+      if (!invocation_sealed_) {
+        // An op resized a tensor mid-run; re-prepare everything downstream
+        // and finish through the fully validated path below.
+        next_execution_plan_index_to_prepare_ = i + 1;
+        first_execution_plan_index = i + 1;
+        break;
+      }
+    }
+    if (invocation_sealed_) {
+      return kTfLiteOk;
+    }
+  }
+
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
   // called.
-  for (int execution_plan_index = 0;
+  bool saw_tensor_resize = false;
+  for (int execution_plan_index = first_execution_plan_index;
        execution_plan_index < execution_plan_.size(); execution_plan_index++) {
     if (execution_plan_index == next_execution_plan_index_to_prepare_) {
       TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
       TF_LITE_ENSURE(context_, next_execution_plan_index_to_prepare_ >=
                                    execution_plan_index);
     }
-    int node_index = execution_plan_[execution_plan_index];
-    TfLiteNode& node = nodes_and_registration_[node_index].first;
-    const TfLiteRegistration& registration =
-        nodes_and_registration_[node_index].second;
-    TFLITE_SCOPED_OPERATOR_PROFILE(profiler_, node_index);
+    TfLiteStatus node_status = InvokeNode(execution_plan_index);
+    if (node_status != kTfLiteOk) {
+      return node_status;
+    }
+    saw_tensor_resize |= tensor_resized_since_op_invoke_;
+  }
 
-    // TODO(ycling): This is an extra loop through inputs to check if the data
-    // need to be copied from Delegate buffer to raw memory, which is often not
-    // needed. We may want to cache this in prepare to know if this needs to be
-    // done for a node or not.
-    for (int i = 0; i < node.inputs->size; ++i) {
-      int tensor_index = node.inputs->data[i];
-      if (tensor_index == kOptionalTensor) {
-        continue;
+  // This run went through every check and touched the whole plan without any
+  // tensor changing shape, so the next Invoke() can take the fast path.
+  if (sealed_invocation_allowed_ && !invocation_sealed_ &&
+      !parallel_execution_ && profiler_ == nullptr &&
+      first_execution_plan_index == 0 && !saw_tensor_resize &&
+      !has_dynamic_tensors_ &&
+      next_execution_plan_index_to_prepare_ >=
+          static_cast<int>(execution_plan_.size())) {
+    SealInvocation();
+  }
+
+  return status;
+}
+
+TfLiteStatus Subgraph::InvokeNode(int execution_plan_index) {
+  int node_index = execution_plan_[execution_plan_index];
+  TfLiteNode& node = nodes_and_registration_[node_index].first;
+  const TfLiteRegistration& registration =
+      nodes_and_registration_[node_index].second;
+  TFLITE_SCOPED_OPERATOR_PROFILE(profiler_, node_index);
+
+  // TODO(ycling): This is an extra loop through inputs to check if the data
+  // need to be copied from Delegate buffer to raw memory, which is often not
+  // needed. We may want to cache this in prepare to know if this needs to be
+  // done for a node or not.
+  for (int i = 0; i < node.inputs->size; ++i) {
+    int tensor_index = node.inputs->data[i];
+    if (tensor_index == kOptionalTensor) {
+      continue;
+    }
+    TfLiteTensor* tensor = &tensors_[tensor_index];
+    if (tensor->delegate && tensor->delegate != node.delegate &&
+        tensor->data_is_stale) {
+      TF_LITE_ENSURE_STATUS(EnsureTensorDataIsReadable(tensor_index));
+    }
+  }
+
+  if (check_cancelled_func_ != nullptr &&
+      check_cancelled_func_(cancellation_data_)) {
+    ReportError("Client requested cancel during Invoke()");
+    return kTfLiteError;
+  }
+
+  EnsureTensorsVectorCapacity();
+  tensor_resized_since_op_invoke_ = false;
+  if (OpInvoke(registration, &node) == kTfLiteError) {
+    return ReportOpError(context_, node, registration, node_index,
+                         "failed to invoke");
+  }
+
+  // Force execution prep for downstream ops if the latest op triggered the
+  // resize of a dynamic tensor.
+  if (tensor_resized_since_op_invoke_ &&
+      HasDynamicTensor(*context_, node.outputs)) {
+    next_execution_plan_index_to_prepare_ = execution_plan_index + 1;
+  }
+
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::InvokeParallel() {
+  const int plan_size = execution_plan_.size();
+
+  // Derive the dependency DAG: how many producers each node still waits for,
+  // and which nodes each node unblocks once it finishes. Edges follow tensor
+  // producers to consumers; nodes touching variable tensors are additionally
+  // chained in plan order since they may update state in place.
+  std::vector<int> pending_producers(plan_size, 0);
+  std::vector<std::vector<int>> dependents(plan_size);
+  {
+    std::vector<int> producer(tensors_.size(), -1);
+    int last_stateful = -1;
+    for (int i = 0; i < plan_size; ++i) {
+      const TfLiteNode& node =
+          nodes_and_registration_[execution_plan_[i]].first;
+      bool stateful = false;
+      for (int j = 0; j < node.inputs->size; ++j) {
+        const int tensor_index = node.inputs->data[j];
+        if (tensor_index == kOptionalTensor) continue;
+        if (producer[tensor_index] >= 0) {
+          dependents[producer[tensor_index]].push_back(i);
+          ++pending_producers[i];
+        }
+        if (tensors_[tensor_index].is_variable) stateful = true;
       }
-      TfLiteTensor* tensor = &tensors_[tensor_index];
-      if (tensor->delegate && tensor->delegate != node.delegate &&
-          tensor->data_is_stale) {
-        TF_LITE_ENSURE_STATUS(EnsureTensorDataIsReadable(tensor_index));
+      for (int j = 0; j < node.outputs->size; ++j) {
+        producer[node.outputs->data[j]] = i;
+      }
+      if (stateful) {
+        if (last_stateful >= 0) {
+          dependents[last_stateful].push_back(i);
+          ++pending_producers[i];
+        }
+        last_stateful = i;
       }
     }
+  }
 
-    if (check_cancelled_func_ != nullptr &&
-        check_cancelled_func_(cancellation_data_)) {
-      ReportError("Client requested cancel during Invoke()");
-      return kTfLiteError;
-    }
+  std::mutex mu;
+  std::condition_variable ready_cv;
+  std::vector<int> ready;
+  int remaining = plan_size;
+  TfLiteStatus status = kTfLiteOk;
+  for (int i = 0; i < plan_size; ++i) {
+    if (pending_producers[i] == 0) ready.push_back(i);
+  }
 
-    EnsureTensorsVectorCapacity();
-    tensor_resized_since_op_invoke_ = false;
-    if (OpInvoke(registration, &node) == kTfLiteError) {
-      return ReportOpError(context_, node, registration, node_index,
-                           "failed to invoke");
+  auto run_worker = [&]() {
+    std::unique_lock<std::mutex> lock(mu);
+    while (status == kTfLiteOk && remaining > 0) {
+      if (ready.empty()) {
+        ready_cv.wait(lock);
+        continue;
+      }
+      const int plan_index = ready.back();
+      ready.pop_back();
+      lock.unlock();
+      const TfLiteStatus node_status = InvokeNode(plan_index);
+      lock.lock();
+      --remaining;
+      if (node_status != kTfLiteOk) {
+        status = node_status;
+      } else {
+        for (int dependent : dependents[plan_index]) {
+          if (--pending_producers[dependent] == 0) {
+            ready.push_back(dependent);
+          }
+        }
+      }
+      // Wake the other workers, either to pick up newly ready nodes or to
+      // notice that the run is over.
+      ready_cv.notify_all();
     }
+    ready_cv.notify_all();
+  };
 
-    // Force execution prep for downstream ops if the latest op triggered the
-    // resize of a dynamic tensor.
-    if (tensor_resized_since_op_invoke_ &&
-        HasDynamicTensor(*context_, node.outputs)) {
-      next_execution_plan_index_to_prepare_ = execution_plan_index + 1;
-    }
+  int num_workers = parallel_num_workers_ > 0
+                        ? parallel_num_workers_
+                        : context_->recommended_num_threads;
+  num_workers = std::max(1, std::min(num_workers, plan_size));
+
+  std::vector<std::thread> workers;
+  for (int i = 1; i < num_workers; ++i) {
+    workers.emplace_back(run_worker);
+  }
+  run_worker();
+  for (auto& worker : workers) {
+    worker.join();
   }
 
   return status;
 }
 
+void Subgraph::SetParallelExecution(bool enable, int num_workers) {
+  parallel_execution_ = enable;
+  parallel_num_workers_ = num_workers;
+}
+
+void Subgraph::SetDelegatePartitioningParams(int min_nodes_per_partition,
+                                             size_t max_transfer_bytes_per_node) {
+  min_nodes_per_partition_ = min_nodes_per_partition;
+  max_transfer_bytes_per_node_ = max_transfer_bytes_per_node;
+}
+
+bool Subgraph::PartitionIsProfitable(const NodeSubset& node_subset) const {
+  const int num_nodes = node_subset.nodes.size();
+  if (num_nodes < min_nodes_per_partition_) return false;
+  if (max_transfer_bytes_per_node_ == 0) return true;
+  // Weight tensors are excluded: they are transferred to the accelerator
+  // once at preparation time, not per inference.
+  size_t transfer_bytes = 0;
+  for (int tensor_index : node_subset.input_tensors) {
+    const TfLiteTensor& tensor = tensors_[tensor_index];
+    if (tensor.allocation_type == kTfLiteMmapRo) continue;
+    transfer_bytes += tensor.bytes;
+  }
+  for (int tensor_index : node_subset.output_tensors) {
+    transfer_bytes += tensors_[tensor_index].bytes;
+  }
+  return transfer_bytes <= max_transfer_bytes_per_node_ * num_nodes;
+}
+
+void Subgraph::SealInvocation() {
+  sealed_calls_.clear();
+  sealed_calls_.reserve(execution_plan_.size());
+  for (int execution_plan_index = 0;
+       execution_plan_index < execution_plan_.size(); execution_plan_index++) {
+    int node_index = execution_plan_[execution_plan_index];
+    TfLiteNode& node = nodes_and_registration_[node_index].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[node_index].second;
+    if (registration.invoke == nullptr) {
+      sealed_calls_.clear();
+      return;
+    }
+    // Tensors backed by delegate buffer handles may need their data copied
+    // back before every read, a check the fast path skips.
+    for (int i = 0; i < node.inputs->size; ++i) {
+      int tensor_index = node.inputs->data[i];
+      if (tensor_index == kOptionalTensor) continue;
+      if (tensors_[tensor_index].delegate != nullptr) {
+        sealed_calls_.clear();
+        return;
+      }
+    }
+    sealed_calls_.push_back({registration.invoke, &node, node_index});
+  }
+  invocation_sealed_ = true;
+}
+
+void Subgraph::SetSealedInvocation(bool enable) {
+  sealed_invocation_allowed_ = enable;
+  if (!enable) {
+    UnsealInvocation();
+  }
+}
+
 TfLiteStatus Subgraph::ResizeTensor(TfLiteContext* context,
                                     TfLiteTensor* tensor,
                                     TfLiteIntArray* new_size) {
@@ -939,11 +1211,14 @@ TfLiteStatus Subgraph::SetExecutionPlan(const std::vector<int>& new_plan) {
                                  node_index < nodes_and_registration_.size());
   }
   execution_plan_ = new_plan;
+  UnsealInvocation();
   return kTfLiteOk;
 }
 
 TfLiteStatus Subgraph::ResizeTensorImpl(TfLiteTensor* tensor,
                                         TfLiteIntArray* new_size) {
+  // A shape change invalidates the sealed fast-path call list.
+  UnsealInvocation();
   // Note that in theory we could resize kTfLiteArenaRwPersistent tensors too.
   if (tensor->allocation_type == kTfLiteArenaRw ||
       tensor->allocation_type == kTfLiteDynamic ||
@@ -29,6 +29,7 @@ namespace tflite {
 
 // Forward declare since NNAPIDelegate uses Interpreter.
 class NNAPIDelegate;
+struct NodeSubset;
 
 class Subgraph {
  public:
@@ -208,6 +209,20 @@ class Subgraph {
   // Returns status of success or failure.
   TfLiteStatus AllocateTensors();
 
+  // Hands the memory backing non-persistent (intermediate) tensors back to
+  // a process-wide buffer pool, e.g. while another temporally exclusive
+  // model runs. The allocation plan is kept. Invoking the subgraph in this
+  // state is an error: call AcquireNonPersistentMemory() first, and then
+  // re-fill the input tensors, whose memory is also non-persistent.
+  // WARNING: This is an experimental API and subject to change.
+  TfLiteStatus ReleaseNonPersistentMemory();
+
+  // Leases a buffer back from the pool after ReleaseNonPersistentMemory()
+  // and re-resolves the tensor pointers against its base. Cheap compared to
+  // AllocateTensors() since no planning is redone.
+  // WARNING: This is an experimental API and subject to change.
+  TfLiteStatus AcquireNonPersistentMemory();
+
   // Invoke the subgraph (run the whole graph in dependency order).
   //
   // NOTE: It is possible that the interpreter is not in a ready state
@@ -221,6 +236,37 @@ class Subgraph {
 
   void UseNNAPI(bool enable);
 
+  // Enables an execution mode where Invoke() derives an op dependency DAG
+  // from the graph and dispatches ops whose inputs are all ready to a small
+  // pool of worker threads, instead of walking the execution plan serially.
+  // `num_workers` bounds the pool size; values < 1 fall back to the context's
+  // recommended number of threads. Must be called before AllocateTensors()
+  // so that the memory plan keeps concurrently live tensors from sharing
+  // arena space. Graphs with dynamic tensors keep using the serial path.
+  // WARNING: This is an experimental API and subject to change.
+  void SetParallelExecution(bool enable, int num_workers);
+
+  // Enables the sealed fast-path invocation mode: after a successful, fully
+  // validated Invoke() on a statically allocated graph, the subgraph
+  // captures a flat list of (invoke function, node) pairs, and subsequent
+  // Invoke() calls run that list directly with the per-node validation
+  // hoisted out. The seal is dropped automatically whenever the graph, the
+  // execution plan or a tensor shape changes.
+  // WARNING: This is an experimental API and subject to change.
+  void SetSealedInvocation(bool enable);
+
+  // Configures profitability filtering for delegate partitioning. Partitions
+  // with fewer than `min_nodes_per_partition` nodes, or moving more than
+  // `max_transfer_bytes_per_node` bytes of boundary tensor data per delegated
+  // node, are kept on the CPU instead of being handed to the delegate, since
+  // copying tensors across the delegate boundary several times per frame can
+  // cost more than the accelerator saves. A `max_transfer_bytes_per_node` of
+  // 0 disables the transfer check; the defaults keep every partition. Must be
+  // called before ModifyGraphWithDelegate().
+  // WARNING: This is an experimental API and subject to change.
+  void SetDelegatePartitioningParams(int min_nodes_per_partition,
+                                     size_t max_transfer_bytes_per_node);
+
   // Return the subgraph specific context.
   TfLiteContext* context() { return context_; }
 
@@ -293,6 +339,12 @@ class Subgraph {
   bool HasDynamicTensors() { return has_dynamic_tensors_; }
 
  private:
+  // Returns true if handing `node_subset` to a delegate is expected to pay
+  // for its boundary tensor copies, per the thresholds configured with
+  // SetDelegatePartitioningParams(). Read-only (weight) boundary tensors are
+  // not counted since they are transferred once, not per inference.
+  bool PartitionIsProfitable(const NodeSubset& node_subset) const;
+
   // Prevent 'context_' from accessing functions that are only available to
   // delegated kernels.
   void SwitchToKernelContext();
@@ -341,6 +393,28 @@ class Subgraph {
   TfLiteStatus PrepareOpsStartingAt(int first_execution_plan_index,
                                     int* last_execution_plan_index_prepared);
 
+  // Invoke the node at the given position in the execution plan. Factored
+  // out of Invoke() so the serial and parallel paths share it.
+  TfLiteStatus InvokeNode(int execution_plan_index);
+
+  // Run the whole execution plan on a pool of worker threads, dispatching
+  // each op once all of its producers have finished. Requires that all ops
+  // have been prepared and statically allocated.
+  TfLiteStatus InvokeParallel();
+
+  // Captures the flat fast-path call list for the current execution plan.
+  // Gives up without sealing when a node can't be run unchecked, e.g. when
+  // one of its inputs is backed by a delegate buffer handle that may need to
+  // be refreshed before every read.
+  void SealInvocation();
+
+  // Drops the captured fast-path call list, if any; the next Invoke() goes
+  // through full validation again.
+  void UnsealInvocation() {
+    invocation_sealed_ = false;
+    sealed_calls_.clear();
+  }
+
   // Tensors needed by the interpreter. Use `AddTensors` to add more blank
   // tensor entries. Note, `tensors_.data()` needs to be synchronized to the
   // `context_` whenever this std::vector is reallocated. Currently this
@@ -516,6 +590,13 @@ class Subgraph {
   bool should_apply_nnapi_delegate_ = false;
   bool applied_nnapi_delegate_ = false;
 
+  // Delegate partitions below this node count stay on the CPU.
+  int min_nodes_per_partition_ = 1;
+
+  // If non-zero, delegate partitions moving more than this many bytes of
+  // boundary tensor data per delegated node stay on the CPU.
+  size_t max_transfer_bytes_per_node_ = 0;
+
   std::unique_ptr<MemoryPlanner> memory_planner_;
 
   // Tracking bit for whether a tensor was resized in the course of an op
@@ -538,6 +619,32 @@ class Subgraph {
   // The value is invalid before `PrepareOpStartingAt` is called.
   bool has_dynamic_tensors_ = true;
 
+  // If true, Invoke() runs independent ops concurrently on a pool of worker
+  // threads instead of serially in execution plan order.
+  bool parallel_execution_ = false;
+
+  // Number of workers used by the parallel execution mode; values < 1 mean
+  // use the context's recommended number of threads.
+  int parallel_num_workers_ = 0;
+
+  // One entry of the sealed fast-path call list: the op's invoke function
+  // applied to its node, plus the node index for error reporting.
+  struct SealedCall {
+    TfLiteStatus (*invoke)(TfLiteContext*, TfLiteNode*);
+    TfLiteNode* node;
+    int node_index;
+  };
+
+  // If true, Invoke() may capture a sealed fast-path call list (see
+  // SetSealedInvocation).
+  bool sealed_invocation_allowed_ = false;
+
+  // True while `sealed_calls_` holds a valid fast-path call list.
+  bool invocation_sealed_ = false;
+
+  // The captured call list, in execution plan order.
+  std::vector<SealedCall> sealed_calls_;
+
   // Reference to cancellation function that can cancel a request in the middle
   // of a call to Invoke(). When this function returns True, a kTfLiteError is
   // thrown by Invoke().
@@ -183,6 +183,13 @@ struct NNFreeExecution {
   }
 };
 
+// RAII NN API Burst Destructor for use with std::unique_ptr
+struct NNFreeBurst {
+  void operator()(ANeuralNetworksBurst* burst) {
+    NnApiImplementation()->ANeuralNetworksBurst_free(burst);
+  }
+};
+
 // Manage NNAPI shared memory handle
 class NNMemory {
  public:
@@ -1272,6 +1279,20 @@ class NNAPIDelegateKernel {
       RETURN_TFLITE_ERROR_IF_NN_ERROR(context, finish_result);
       nn_compilation_.reset(compilation);
     }
+
+    // Create a reusable burst object so that repeated invocations share
+    // execution resources (e.g. mapped memory pools) inside the driver
+    // instead of re-acquiring them per frame. Burst execution is optional;
+    // when unavailable the per-execution compute path is used.
+    if (!nn_burst_ && nnapi_->android_sdk_version >= kMinSdkVersionForNNAPI12 &&
+        nnapi_->ANeuralNetworksBurst_create != nullptr &&
+        nnapi_->ANeuralNetworksExecution_burstCompute != nullptr) {
+      ANeuralNetworksBurst* burst = nullptr;
+      if (nnapi_->ANeuralNetworksBurst_create(nn_compilation_.get(), &burst) ==
+          ANEURALNETWORKS_NO_ERROR) {
+        nn_burst_.reset(burst);
+      }
+    }
     return kTfLiteOk;
   }
 
@@ -1348,6 +1369,12 @@ class NNAPIDelegateKernel {
       const int wait_result = nnapi_->ANeuralNetworksEvent_wait(event);
       nnapi_->ANeuralNetworksEvent_free(event);
       RETURN_TFLITE_ERROR_IF_NN_ERROR(context, wait_result);
+    } else if (nn_burst_) {
+      // Computing on the reusable burst object lets the driver keep
+      // execution resources alive across invocations.
+      RETURN_TFLITE_ERROR_IF_NN_ERROR(
+          context, nnapi_->ANeuralNetworksExecution_burstCompute(
+                       execution, nn_burst_.get()));
     } else {
       // Use synchronous execution for NNAPI 1.2+.
       RETURN_TFLITE_ERROR_IF_NN_ERROR(
@@ -1376,6 +1403,9 @@ class NNAPIDelegateKernel {
   std::unique_ptr<ANeuralNetworksModel, NNFreeModel> nn_model_;
   std::unique_ptr<ANeuralNetworksCompilation, NNFreeCompilation>
       nn_compilation_;
+  // Reusable burst object tied to nn_compilation_; must be destroyed before
+  // the compilation it was created from.
+  std::unique_ptr<ANeuralNetworksBurst, NNFreeBurst> nn_burst_;
   // Node indices that this delegate is responsible for. Indices here
   // indexes into the nodes array in the TfLiteContext.
   std::vector<int> nodes_;
@@ -97,6 +97,14 @@ TfLiteStatus Interpreter::AllocateTensors() {
   return primary_subgraph().AllocateTensors();
 }
 
+TfLiteStatus Interpreter::ReleaseNonPersistentMemory() {
+  return primary_subgraph().ReleaseNonPersistentMemory();
+}
+
+TfLiteStatus Interpreter::AcquireNonPersistentMemory() {
+  return primary_subgraph().AcquireNonPersistentMemory();
+}
+
 void Interpreter::ReserveNodes(int count) {
   primary_subgraph().ReserveNodes(count);
 }
@@ -141,6 +149,91 @@ TfLiteStatus Interpreter::Invoke() {
   return kTfLiteOk;
 }
 
+TfLiteStatus Interpreter::BatchRun(
+    int batch_size, const std::vector<const void*>& input_batches,
+    const std::vector<void*>& output_batches) {
+  TF_LITE_ENSURE(context_, batch_size > 0);
+  TF_LITE_ENSURE_EQ(context_, input_batches.size(), inputs().size());
+  TF_LITE_ENSURE_EQ(context_, output_batches.size(), outputs().size());
+
+  // Make sure the per-example shapes and byte sizes are known.
+  TF_LITE_ENSURE_STATUS(AllocateTensors());
+
+  std::vector<std::vector<int>> single_dims(inputs().size());
+  std::vector<size_t> input_bytes(inputs().size());
+  for (size_t i = 0; i < inputs().size(); ++i) {
+    TfLiteTensor* input = tensor(inputs()[i]);
+    TF_LITE_ENSURE(context_, input->dims != nullptr && input->dims->size > 0);
+    single_dims[i].assign(input->dims->data,
+                          input->dims->data + input->dims->size);
+    input_bytes[i] = input->bytes;
+  }
+  std::vector<size_t> output_bytes(outputs().size());
+  for (size_t o = 0; o < outputs().size(); ++o) {
+    output_bytes[o] = tensor(outputs()[o])->bytes;
+  }
+
+  // Try to run the whole batch in one pass by scaling the batch dimension.
+  // The batched pass is only usable if every kernel accepts the batched
+  // shapes and every input and output scales linearly with the batch.
+  bool batched = batch_size > 1;
+  size_t num_resized = 0;
+  for (size_t i = 0; i < inputs().size() && batched; ++i) {
+    std::vector<int> batched_dims = single_dims[i];
+    batched_dims[0] *= batch_size;
+    batched = ResizeInputTensor(inputs()[i], batched_dims) == kTfLiteOk;
+    if (batched) ++num_resized;
+  }
+  if (batched) batched = AllocateTensors() == kTfLiteOk;
+  for (size_t i = 0; i < inputs().size() && batched; ++i) {
+    batched = tensor(inputs()[i])->bytes == batch_size * input_bytes[i];
+  }
+  for (size_t o = 0; o < outputs().size() && batched; ++o) {
+    batched = tensor(outputs()[o])->bytes == batch_size * output_bytes[o];
+  }
+
+  if (batched) {
+    for (size_t i = 0; i < inputs().size(); ++i) {
+      memcpy(tensor(inputs()[i])->data.raw, input_batches[i],
+             batch_size * input_bytes[i]);
+    }
+    TfLiteStatus status = Invoke();
+    if (status == kTfLiteOk) {
+      for (size_t o = 0; o < outputs().size(); ++o) {
+        memcpy(output_batches[o], tensor(outputs()[o])->data.raw,
+               batch_size * output_bytes[o]);
+      }
+    }
+    // Restore the per-example shapes so subsequent Invoke() calls see the
+    // original signature.
+    for (size_t i = 0; i < inputs().size(); ++i) {
+      TF_LITE_ENSURE_STATUS(ResizeInputTensor(inputs()[i], single_dims[i]));
+    }
+    TF_LITE_ENSURE_STATUS(AllocateTensors());
+    return status;
+  }
+
+  // Fall back to a per-example loop, restoring the per-example shapes of any
+  // inputs the batched attempt managed to resize.
+  for (size_t i = 0; i < num_resized; ++i) {
+    TF_LITE_ENSURE_STATUS(ResizeInputTensor(inputs()[i], single_dims[i]));
+  }
+  TF_LITE_ENSURE_STATUS(AllocateTensors());
+  for (int b = 0; b < batch_size; ++b) {
+    for (size_t i = 0; i < inputs().size(); ++i) {
+      memcpy(tensor(inputs()[i])->data.raw,
+             static_cast<const char*>(input_batches[i]) + b * input_bytes[i],
+             input_bytes[i]);
+    }
+    TF_LITE_ENSURE_STATUS(Invoke());
+    for (size_t o = 0; o < outputs().size(); ++o) {
+      memcpy(static_cast<char*>(output_batches[o]) + b * output_bytes[o],
+             tensor(outputs()[o])->data.raw, output_bytes[o]);
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus Interpreter::AddTensors(int tensors_to_add,
                                      int* first_new_tensor_index) {
   return primary_subgraph().AddTensors(tensors_to_add, first_new_tensor_index);
@@ -205,6 +298,22 @@ void Interpreter::SetNumThreads(int num_threads) {
   }
 }
 
+void Interpreter::SetParallelExecution(bool enable, int num_workers) {
+  primary_subgraph().SetParallelExecution(enable, num_workers);
+}
+
+void Interpreter::SetSealedInvocation(bool enable) {
+  primary_subgraph().SetSealedInvocation(enable);
+}
+
+void Interpreter::SetDelegatePartitioningParams(
+    int min_nodes_per_partition, size_t max_transfer_bytes_per_node) {
+  for (auto& subgraph : subgraphs_) {
+    subgraph->SetDelegatePartitioningParams(min_nodes_per_partition,
+                                            max_transfer_bytes_per_node);
+  }
+}
+
 void Interpreter::SetAllowFp16PrecisionForFp32(bool allow) {
   for (auto& subgraph : subgraphs_) {
     subgraph->context()->allow_fp32_relax_to_fp16 = allow;
@@ -237,6 +346,9 @@ TfLiteStatus Interpreter::SetBufferHandle(int tensor_index,
   TF_LITE_ENSURE(context_,
                  tensor->delegate == nullptr || tensor->delegate == delegate);
   tensor->delegate = delegate;
+  // The tensor may need its data refreshed from the buffer handle before
+  // every read, which the sealed fast path would skip.
+  primary_subgraph().UnsealInvocation();
   if (tensor->buffer_handle != kTfLiteNullBufferHandle) {
     TF_LITE_ENSURE(context_, tensor->delegate->FreeBufferHandle != nullptr);
     tensor->delegate->FreeBufferHandle(context_, tensor->delegate,
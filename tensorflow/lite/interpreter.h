@@ -335,6 +335,22 @@ class Interpreter {
   // Returns status of success or failure.
   TfLiteStatus AllocateTensors();
 
+  // Hands the memory backing non-persistent (intermediate) tensors back to
+  // a process-wide buffer pool, e.g. while another loaded model that never
+  // runs at the same time does its inference. With N temporally exclusive
+  // interpreters releasing between runs, the combined arena footprint
+  // approaches the largest single model instead of the sum of all of them.
+  // The allocation plan is kept; call AcquireNonPersistentMemory() before
+  // the next Invoke() and then re-fill the input tensors, whose memory is
+  // also non-persistent.
+  // WARNING: This is an experimental API and subject to change.
+  TfLiteStatus ReleaseNonPersistentMemory();
+
+  // Leases a buffer back from the pool after ReleaseNonPersistentMemory().
+  // Cheap compared to AllocateTensors() since no planning is redone.
+  // WARNING: This is an experimental API and subject to change.
+  TfLiteStatus AcquireNonPersistentMemory();
+
   // Invoke the interpreter (run the whole graph in dependency order).
   //
   // NOTE: It is possible that the interpreter is not in a ready state
@@ -343,12 +359,59 @@ class Interpreter {
   // Returns status of success or failure.
   TfLiteStatus Invoke();
 
+  // Runs the graph over a batch of `batch_size` examples, amortizing
+  // per-node dispatch, profiling hooks and delegate boundaries across the
+  // batch. `input_batches` holds one pointer per interpreter input, each
+  // referencing `batch_size` examples laid out contiguously; similarly
+  // `output_batches` holds one pointer per interpreter output with room for
+  // `batch_size` results. The leading dimension of every input is treated as
+  // the batch dimension and is scaled by `batch_size` for a single batched
+  // pass over the graph; if any kernel rejects the batched shapes during
+  // preparation, the batch falls back to an internal per-example loop.
+  // Restores the original input shapes before returning. Not supported for
+  // models with string tensors as inputs or outputs.
+  // WARNING: This is an experimental API and subject to change.
+  TfLiteStatus BatchRun(int batch_size,
+                        const std::vector<const void*>& input_batches,
+                        const std::vector<void*>& output_batches);
+
   // Enable or disable the NN API (true to enable)
   void UseNNAPI(bool enable);
 
   // Set the number of threads available to the interpreter.
   void SetNumThreads(int num_threads);
 
+  // Enables an opt-in execution mode where independent ops are dispatched to
+  // a pool of `num_workers` worker threads instead of running serially in
+  // execution plan order. Values of `num_workers` < 1 fall back to the
+  // number of threads set with SetNumThreads(). Must be called before
+  // AllocateTensors(). Disabled by default, so single-threaded latency paths
+  // are unaffected.
+  // WARNING: This is an experimental API and subject to change.
+  void SetParallelExecution(bool enable, int num_workers = 0);
+
+  // Enables a fast path for repeated fixed-shape inference: after a
+  // successful, fully validated Invoke() the interpreter captures a flat
+  // list of (invoke function, node) pairs, and subsequent Invoke() calls
+  // run that list directly with per-node validation hoisted out. The seal
+  // is dropped automatically when the graph or a tensor shape changes,
+  // e.g. on ResizeInputTensor(). Disabled by default.
+  // WARNING: This is an experimental API and subject to change.
+  void SetSealedInvocation(bool enable);
+
+  // Configures profitability filtering for delegate partitioning. Partitions
+  // with fewer than `min_nodes_per_partition` nodes, or moving more than
+  // `max_transfer_bytes_per_node` bytes of boundary tensor data per delegated
+  // node, are kept on the CPU instead of being handed to the delegate;
+  // delegation that ping-pongs tensors between the accelerator and the CPU
+  // can be slower than not delegating at all, purely from boundary copies.
+  // A `max_transfer_bytes_per_node` of 0 disables the transfer check; the
+  // defaults keep every partition. Must be called before
+  // ModifyGraphWithDelegate().
+  // WARNING: This is an experimental API and subject to change.
+  void SetDelegatePartitioningParams(int min_nodes_per_partition,
+                                     size_t max_transfer_bytes_per_node);
+
   // Allow float16 precision for FP32 calculation when possible.
   // default: not allow.
   // WARNING: This is an experimental API and subject to change.
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/lite/interpreter.h"
 
+#include <algorithm>
+#include <mutex>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "third_party/eigen3/Eigen/Core"
@@ -594,6 +597,180 @@ TEST(BasicInterpreter, OneOpInterpreter) {
   ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
 }
 
+TEST(BasicInterpreter, ReleaseAndAcquireNonPersistentMemory) {
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(2), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({1}), kTfLiteOk);
+
+  TfLiteQuantizationParams quantized;
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(0, kTfLiteFloat32, "in",
+                                                     {3}, quantized),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(1, kTfLiteFloat32, "out",
+                                                     {3}, quantized),
+            kTfLiteOk);
+
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < input->dims->data[0]; ++i) {
+      output->data.f[i] = input->data.f[i];
+    }
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  auto fill_input = [&interpreter]() {
+    float* input = interpreter.typed_input_tensor<float>(0);
+    for (int i = 0; i < 3; ++i) {
+      input[i] = i * 2.0f;
+    }
+  };
+  auto check_output = [&interpreter]() {
+    float* output = interpreter.typed_output_tensor<float>(0);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(output[i], i * 2.0f);
+    }
+  };
+
+  fill_input();
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  check_output();
+
+  // While the memory is released, invoking is an error; after acquiring it
+  // back, inputs must be re-filled since their memory is non-persistent.
+  ASSERT_EQ(interpreter.ReleaseNonPersistentMemory(), kTfLiteOk);
+  ASSERT_NE(interpreter.Invoke(), kTfLiteOk);
+  ASSERT_EQ(interpreter.AcquireNonPersistentMemory(), kTfLiteOk);
+  fill_input();
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  check_output();
+
+  // AllocateTensors() also recovers from the released state.
+  ASSERT_EQ(interpreter.ReleaseNonPersistentMemory(), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  fill_input();
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  check_output();
+}
+
+TEST(BasicInterpreter, BatchRun) {
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(2), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({1}), kTfLiteOk);
+
+  TfLiteQuantizationParams quantized;
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(0, kTfLiteFloat32, "in",
+                                                     {3}, quantized),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(1, kTfLiteFloat32, "out",
+                                                     {3}, quantized),
+            kTfLiteOk);
+
+  // A simple copy op that accepts any input shape, so the whole batch runs
+  // in a single batched pass.
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < input->dims->data[0]; ++i) {
+      output->data.f[i] = input->data.f[i];
+    }
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  constexpr int kBatchSize = 4;
+  std::vector<float> input_batch(kBatchSize * 3);
+  for (size_t i = 0; i < input_batch.size(); ++i) {
+    input_batch[i] = i * 2.0f;
+  }
+  std::vector<float> output_batch(kBatchSize * 3, -1.0f);
+  ASSERT_EQ(interpreter.BatchRun(kBatchSize, {input_batch.data()},
+                                 {output_batch.data()}),
+            kTfLiteOk);
+  for (size_t i = 0; i < output_batch.size(); ++i) {
+    EXPECT_EQ(output_batch[i], i * 2.0f);
+  }
+
+  // The per-example input shape is restored and the interpreter remains
+  // invokable afterwards.
+  ASSERT_EQ(interpreter.tensor(0)->dims->data[0], 3);
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+}
+
+TEST(BasicInterpreter, BatchRunFallbackToPerExampleLoop) {
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(2), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({1}), kTfLiteOk);
+
+  TfLiteQuantizationParams quantized;
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(0, kTfLiteFloat32, "in",
+                                                     {1, 3}, quantized),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(1, kTfLiteFloat32, "out",
+                                                     {1, 3}, quantized),
+            kTfLiteOk);
+
+  // A copy op that only supports a single example at a time, forcing
+  // BatchRun() into its internal per-example loop.
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    TF_LITE_ENSURE_EQ(context, input->dims->data[0], 1);
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < input->dims->data[1]; ++i) {
+      output->data.f[i] = input->data.f[i];
+    }
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  constexpr int kBatchSize = 3;
+  std::vector<float> input_batch(kBatchSize * 3);
+  for (size_t i = 0; i < input_batch.size(); ++i) {
+    input_batch[i] = i * 3.0f;
+  }
+  std::vector<float> output_batch(kBatchSize * 3, -1.0f);
+  ASSERT_EQ(interpreter.BatchRun(kBatchSize, {input_batch.data()},
+                                 {output_batch.data()}),
+            kTfLiteOk);
+  for (size_t i = 0; i < output_batch.size(); ++i) {
+    EXPECT_EQ(output_batch[i], i * 3.0f);
+  }
+}
+
 // Forcefully divides tensor allocation in three steps: one before invocation
 // and two more at invocation time. This happens because we use string tensors
 // and their sizes can't be determined until invocation time.
@@ -1049,6 +1226,135 @@ TEST_F(TestExecutionPlan, NullExecutionPlan) {
   ASSERT_EQ(run_order_, std::vector<int>());
 }
 
+TEST_F(TestExecutionPlan, SealedInvocation) {
+  interpreter_.SetSealedInvocation(true);
+
+  // The first call runs fully validated and captures the call list; the
+  // later calls run the sealed fast path. All of them must execute the
+  // whole plan in order.
+  ASSERT_EQ(interpreter_.Invoke(), kTfLiteOk);
+  ASSERT_EQ(interpreter_.Invoke(), kTfLiteOk);
+  ASSERT_EQ(interpreter_.Invoke(), kTfLiteOk);
+  ASSERT_EQ(run_order_, std::vector<int>({0, 1, 0, 1, 0, 1}));
+
+  // Resizing an input drops the seal; the next Invoke revalidates and still
+  // runs the whole plan.
+  ASSERT_EQ(interpreter_.ResizeInputTensor(0, {5}), kTfLiteOk);
+  ASSERT_EQ(interpreter_.AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter_.Invoke(), kTfLiteOk);
+  ASSERT_EQ(run_order_, std::vector<int>({0, 1, 0, 1, 0, 1, 0, 1}));
+}
+
+// Test fixture for the parallel execution mode. It builds a diamond of copy
+// nodes: node 0 produces tensor 1, which feeds two independent copy nodes
+// that each produce one of the graph outputs. Node execution is recorded
+// under a mutex since nodes may run on worker threads.
+class TestParallelExecution : public ::testing::Test {
+ protected:
+  struct RunLog {
+    std::mutex mu;
+    std::vector<int> order;
+  };
+
+  // Op-local data; malloc'ed (and free'd by the interpreter) since nodes are
+  // a C99 interface, so it must not own heap allocated data.
+  struct NodeData {
+    int node_id;
+    RunLog* log;
+  };
+
+  TfLiteRegistration CopyOpRegistration() {
+    TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+
+    reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+      // Set output size to input size
+      TfLiteTensor* tensor0 = &context->tensors[node->inputs->data[0]];
+      TfLiteTensor* tensor1 = &context->tensors[node->outputs->data[0]];
+      TfLiteIntArray* newSize = TfLiteIntArrayCopy(tensor0->dims);
+      return context->ResizeTensor(context, tensor1, newSize);
+    };
+
+    reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+      NodeData* node_data = reinterpret_cast<NodeData*>(node->builtin_data);
+      // Copy input data to output data.
+      TfLiteTensor* a0 = &context->tensors[node->inputs->data[0]];
+      TfLiteTensor* a1 = &context->tensors[node->outputs->data[0]];
+      int num = a0->dims->data[0];
+      for (int i = 0; i < num; i++) {
+        a1->data.f[i] = a0->data.f[i];
+      }
+      std::lock_guard<std::mutex> lock(node_data->log->mu);
+      node_data->log->order.push_back(node_data->node_id);
+      return kTfLiteOk;
+    };
+    return reg;
+  }
+
+  void MakeCopyNode(int node_id, int input, int output) {
+    TfLiteRegistration copy_op = CopyOpRegistration();
+    NodeData* node_data =
+        reinterpret_cast<NodeData*>(malloc(sizeof(NodeData)));
+    node_data->node_id = node_id;
+    node_data->log = &run_log_;
+    ASSERT_EQ(interpreter_.AddNodeWithParameters(
+                  {input}, {output}, nullptr, 0,
+                  reinterpret_cast<void*>(node_data), &copy_op),
+              kTfLiteOk);
+  }
+
+  void SetUp() final {
+    ASSERT_EQ(interpreter_.AddTensors(4), kTfLiteOk);
+    interpreter_.SetInputs({0});
+    interpreter_.SetOutputs({2, 3});
+    TfLiteQuantizationParams quantized;
+    for (int tensor_index = 0; tensor_index < 4; tensor_index++) {
+      ASSERT_EQ(interpreter_.SetTensorParametersReadWrite(
+                    tensor_index, kTfLiteFloat32, "", {3}, quantized),
+                kTfLiteOk);
+    }
+
+    MakeCopyNode(0, 0, 1);
+    MakeCopyNode(1, 1, 2);
+    MakeCopyNode(2, 1, 3);
+  }
+
+  Interpreter interpreter_;
+  RunLog run_log_;
+};
+
+TEST_F(TestParallelExecution, HonorsDependenciesAndCopiesData) {
+  interpreter_.SetParallelExecution(true, /*num_workers=*/2);
+  ASSERT_EQ(interpreter_.AllocateTensors(), kTfLiteOk);
+
+  TfLiteTensor* input = interpreter_.tensor(0);
+  for (int i = 0; i < 3; i++) {
+    input->data.f[i] = i * 1.5f;
+  }
+
+  ASSERT_EQ(interpreter_.Invoke(), kTfLiteOk);
+
+  // The producer must run before either consumer; the two consumers may run
+  // in any order (possibly concurrently).
+  ASSERT_EQ(run_log_.order.size(), 3u);
+  EXPECT_EQ(run_log_.order[0], 0);
+  std::vector<int> sorted_order = run_log_.order;
+  std::sort(sorted_order.begin(), sorted_order.end());
+  EXPECT_EQ(sorted_order, std::vector<int>({0, 1, 2}));
+
+  for (int output_index : {2, 3}) {
+    TfLiteTensor* output = interpreter_.tensor(output_index);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_EQ(output->data.f[i], i * 1.5f);
+    }
+  }
+}
+
+TEST_F(TestParallelExecution, SerialByDefault) {
+  ASSERT_EQ(interpreter_.AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter_.Invoke(), kTfLiteOk);
+  ASSERT_EQ(run_log_.order, std::vector<int>({0, 1, 2}));
+}
+
 // Build a kernel registration for an op that copies its one input
 // to an output
 TfLiteRegistration AddOpRegistration() {
@@ -1296,6 +1602,38 @@ TEST_F(TestDelegate, ComplexDelegate) {
             SimpleDelegate::FakeFusedRegistration().custom_name);
 }
 
+TEST_F(TestDelegate, PartitioningMinNodesKeepsSmallPartitionsOnCpu) {
+  // A single-node partition below the minimum node count is not worth its
+  // boundary copies and stays on the CPU.
+  interpreter_->SetDelegatePartitioningParams(/*min_nodes_per_partition=*/2,
+                                              /*max_transfer_bytes_per_node=*/0);
+  delegate_ = std::unique_ptr<SimpleDelegate>(new SimpleDelegate({1}));
+  ASSERT_EQ(
+      interpreter_->ModifyGraphWithDelegate(delegate_->get_tf_lite_delegate()),
+      kTfLiteOk);
+
+  ASSERT_EQ(interpreter_->execution_plan().size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(interpreter_->execution_plan()[i], i);
+  }
+}
+
+TEST_F(TestDelegate, PartitioningTransferCostKeepsPartitionsOnCpu) {
+  // The 3-node partition moves four 12-byte boundary tensors (16 bytes per
+  // delegated node), which exceeds the configured budget.
+  interpreter_->SetDelegatePartitioningParams(/*min_nodes_per_partition=*/1,
+                                              /*max_transfer_bytes_per_node=*/8);
+  delegate_ = std::unique_ptr<SimpleDelegate>(new SimpleDelegate({0, 1, 2}));
+  ASSERT_EQ(
+      interpreter_->ModifyGraphWithDelegate(delegate_->get_tf_lite_delegate()),
+      kTfLiteOk);
+
+  ASSERT_EQ(interpreter_->execution_plan().size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(interpreter_->execution_plan()[i], i);
+  }
+}
+
 TEST_F(TestDelegate, SetBufferHandleToInput) {
   delegate_ = std::unique_ptr<SimpleDelegate>(new SimpleDelegate({0, 1, 2}));
   TfLiteDelegate* delegate = delegate_->get_tf_lite_delegate();
@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
@@ -19,6 +20,10 @@ limitations under the License.
 #include <iostream>
 #include <limits>
 
+#if __aarch64__ && __clang__
+#include <arm_neon.h>
+#endif
+
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/c_api_internal.h"
 #include "tensorflow/lite/kernels/internal/optimized/integer_ops/softmax.h"
@@ -47,6 +52,9 @@ struct OpData {
   int input_left_shift = 0;
   int32_t input_range_radius = 0;
   int diff_min = 0;
+  // Exact 256-entry lookup table for 8-bit unary activations, built once at
+  // Prepare from the quantization parameters (see PopulateLookupTable).
+  uint8_t lut[256];
 };
 
 struct LogSoftmaxOpData : public OpData {
@@ -77,6 +85,86 @@ TfLiteStatus CheckOutputQuantParams(TfLiteContext* context,
   }
   return kTfLiteOk;
 }
+
+// Builds an exact 256-entry lookup table for an 8-bit unary activation: every
+// possible quantized input value is dequantized, passed through `transform`
+// in real arithmetic and re-quantized with the output parameters. The table
+// is indexed by the input's raw bit pattern, so the same apply path serves
+// both uint8 and int8 tensors.
+void PopulateLookupTable(OpData* data, const TfLiteTensor* input,
+                         const TfLiteTensor* output,
+                         float (*transform)(float)) {
+  const float inverse_scale = 1.0f / output->params.scale;
+  const int32_t max_val = input->type == kTfLiteUInt8 ? 255 : 127;
+  const int32_t min_val = input->type == kTfLiteUInt8 ? 0 : -128;
+  for (int32_t val = min_val; val <= max_val; ++val) {
+    const float dequantized =
+        input->params.scale * (val - input->params.zero_point);
+    const float transformed = transform(dequantized);
+    const float rescaled = std::round(transformed * inverse_scale);
+    const int32_t quantized =
+        static_cast<int32_t>(rescaled) + output->params.zero_point;
+    data->lut[static_cast<uint8_t>(val & 0xff)] = static_cast<uint8_t>(
+        std::max(std::min(quantized, max_val), min_val) & 0xff);
+  }
+}
+
+#if __aarch64__ && __clang__
+// Looks up each byte of `indices` in a 256-entry table held in 16 vector
+// registers, using four tbl shuffles over the table quarters selected by the
+// top two index bits.
+inline uint8x16_t aarch64_lookup_vector(const uint8x16x4_t table[4],
+                                        uint8x16_t indices) {
+  // Look up in 1st quarter of the table: top 2 bits of indices == 00.
+  uint8x16_t output1 = vqtbl4q_u8(table[0], indices);
+  // Look up in 2nd quarter of the table: top 2 bits of indices == 01.
+  uint8x16_t output2 =
+      vqtbl4q_u8(table[1], veorq_u8(indices, vdupq_n_u8(0x40)));
+  // Look up in 3rd quarter of the table: top 2 bits of indices == 10.
+  uint8x16_t output3 =
+      vqtbl4q_u8(table[2], veorq_u8(indices, vdupq_n_u8(0x80)));
+  // Look up in 4th quarter of the table: top 2 bits of indices == 11.
+  uint8x16_t output4 =
+      vqtbl4q_u8(table[3], veorq_u8(indices, vdupq_n_u8(0xc0)));
+
+  // Combine the results of the 4 lookups.
+  return vorrq_u8(vorrq_u8(output1, output2), vorrq_u8(output3, output4));
+}
+#endif
+
+// Applies the node's lookup table over the whole tensor. On ARM64 the table
+// fits in sixteen vector registers and is applied 16 bytes at a time with
+// tbl byte shuffles; elsewhere the scalar loop is still a single load per
+// element.
+void EvalUsingLookupTable(OpData* data, const TfLiteTensor* input,
+                          TfLiteTensor* output) {
+  const int size =
+      MatchingFlatSize(GetTensorShape(input), GetTensorShape(output));
+  uint8_t* output_data = GetTensorData<uint8_t>(output);
+  const uint8_t* input_data = GetTensorData<uint8_t>(input);
+  int i = 0;
+#if __aarch64__ && __clang__
+  // This code uses ARM64-only instructions.
+  // TODO(b/143709993): Port to ARMv7
+
+  // Load the tables into registers. (4*4 128-bit registers)
+  uint8x16x4_t table[4];
+  table[0] = vld1q_u8_x4(data->lut + 16 * 4 * 0);
+  table[1] = vld1q_u8_x4(data->lut + 16 * 4 * 1);
+  table[2] = vld1q_u8_x4(data->lut + 16 * 4 * 2);
+  table[3] = vld1q_u8_x4(data->lut + 16 * 4 * 3);
+
+  // Vectorized loop; process 16 elements at a time.
+  const int vectorized_end = size / 16 * 16;
+  for (; i < vectorized_end; i += 16) {
+    const uint8x16_t indices = vld1q_u8(input_data + i);
+    vst1q_u8(output_data + i, aarch64_lookup_vector(table, indices));
+  }
+#endif
+  for (; i < size; ++i) {
+    output_data[i] = data->lut[input_data[i]];
+  }
+}
 }  // namespace
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
@@ -175,6 +263,8 @@ TfLiteStatus TanhPrepare(TfLiteContext* context, TfLiteNode* node) {
                                      &data->input_left_shift);
     data->input_range_radius =
         CalculateInputRadius(kInputIntegerBits, data->input_left_shift);
+    PopulateLookupTable(data, input, output,
+                        [](float value) { return std::tanh(value); });
   } else if (input->type == kTfLiteInt16) {
     static constexpr int kInputIntegerBits = 3;
     static constexpr int kOutputFractionalBits = 15;
@@ -244,6 +334,9 @@ TfLiteStatus SigmoidPrepare(TfLiteContext* context, TfLiteNode* node) {
                                      &data->input_left_shift);
     data->input_range_radius =
         CalculateInputRadius(kInputIntegerBits, data->input_left_shift);
+    PopulateLookupTable(data, input, output, [](float value) {
+      return 1.0f / (1.0f + std::exp(-value));
+    });
   } else if (input->type == kTfLiteInt16) {
     static constexpr int kInputIntegerBits = 3;
     static constexpr int kOutputFractionalBits = 15;
@@ -519,23 +612,25 @@ TfLiteStatus TanhEval(TfLiteContext* context, TfLiteNode* node) {
       return kTfLiteOk;
     } break;
     case kTfLiteUInt8: {
+      if (kernel_type == kGenericOptimized) {
+        EvalUsingLookupTable(data, input, output);
+        return kTfLiteOk;
+      }
       TanhParams params;
       params.input_zero_point = input->params.zero_point;
       params.input_range_radius = data->input_range_radius;
       params.input_multiplier = data->input_multiplier;
       params.input_left_shift = data->input_left_shift;
-      if (kernel_type == kGenericOptimized) {
-        optimized_ops::Tanh(
-            params, GetTensorShape(input), GetTensorData<uint8_t>(input),
-            GetTensorShape(output), GetTensorData<uint8_t>(output));
-      } else {
-        reference_ops::Tanh(
-            params, GetTensorShape(input), GetTensorData<uint8_t>(input),
-            GetTensorShape(output), GetTensorData<uint8_t>(output));
-      }
+      reference_ops::Tanh(params, GetTensorShape(input),
+                          GetTensorData<uint8_t>(input), GetTensorShape(output),
+                          GetTensorData<uint8_t>(output));
       return kTfLiteOk;
     } break;
     case kTfLiteInt8: {
+      if (kernel_type == kGenericOptimized) {
+        EvalUsingLookupTable(data, input, output);
+        return kTfLiteOk;
+      }
       const auto input_shape = GetTensorShape(input);
       const auto output_shape = GetTensorShape(output);
       const int size = MatchingFlatSize(input_shape, output_shape);
@@ -588,23 +683,25 @@ TfLiteStatus SigmoidEval(TfLiteContext* context, TfLiteNode* node) {
       break;
     }
     case kTfLiteUInt8: {
+      if (kernel_type == kGenericOptimized) {
+        EvalUsingLookupTable(data, input, output);
+        break;
+      }
       LogisticParams params;
       params.input_zero_point = input->params.zero_point;
       params.input_range_radius = data->input_range_radius;
       params.input_multiplier = data->input_multiplier;
       params.input_left_shift = data->input_left_shift;
-      if (kernel_type == kGenericOptimized) {
-        optimized_ops::Logistic(
-            params, GetTensorShape(input), GetTensorData<uint8_t>(input),
-            GetTensorShape(output), GetTensorData<uint8_t>(output));
-      } else {
-        reference_ops::Logistic(
-            params, GetTensorShape(input), GetTensorData<uint8_t>(input),
-            GetTensorShape(output), GetTensorData<uint8_t>(output));
-      }
+      reference_ops::Logistic(
+          params, GetTensorShape(input), GetTensorData<uint8_t>(input),
+          GetTensorShape(output), GetTensorData<uint8_t>(output));
       break;
     }
     case kTfLiteInt8: {
+      if (kernel_type == kGenericOptimized) {
+        EvalUsingLookupTable(data, input, output);
+        break;
+      }
       const int input_size =
           MatchingFlatSize(GetTensorShape(input), GetTensorShape(output));
       reference_integer_ops::Logistic(
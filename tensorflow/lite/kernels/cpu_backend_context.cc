@@ -15,18 +15,68 @@ limitations under the License.
 
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 
+#include <utility>
+
 #include "public/gemmlowp.h"
 #include "tensorflow/lite/experimental/ruy/context.h"
 
 namespace tflite {
 
+constexpr std::size_t PrepackedMatrixCache::kBufferAlignment;
+
+PrepackedMatrixCache* PrepackedMatrixCache::GetInstance() {
+  // Leaked on purpose: contexts may release entries during static
+  // destruction, in arbitrary order relative to a static cache's destructor.
+  static PrepackedMatrixCache* instance = new PrepackedMatrixCache;
+  return instance;
+}
+
+ruy::PrepackedMatrix* PrepackedMatrixCache::Acquire(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  it->second.ref_count++;
+  return &it->second.matrix;
+}
+
+ruy::PrepackedMatrix* PrepackedMatrixCache::Insert(
+    const Key& key, const ruy::PrepackedMatrix& matrix,
+    std::vector<std::unique_ptr<char[]>> buffers) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = entries_[key];
+  if (entry.ref_count == 0) {
+    entry.matrix = matrix;
+    entry.buffers = std::move(buffers);
+  }
+  entry.ref_count++;
+  return &entry.matrix;
+}
+
+void PrepackedMatrixCache::Release(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  it->second.ref_count--;
+  if (it->second.ref_count == 0) {
+    entries_.erase(it);
+  }
+}
+
 CpuBackendContext::CpuBackendContext()
     : ruy_context_(new ruy::Context),
       gemmlowp_context_(new gemmlowp::GemmContext) {
   set_max_num_threads(1);
 }
 
-CpuBackendContext::~CpuBackendContext() {}
+CpuBackendContext::~CpuBackendContext() {
+  for (const auto& ref : prepacked_refs_) {
+    PrepackedMatrixCache::GetInstance()->Release(ref.first);
+  }
+}
 
 void CpuBackendContext::set_max_num_threads(int max_num_threads) {
   max_num_threads_ = max_num_threads;
@@ -34,4 +84,29 @@ void CpuBackendContext::set_max_num_threads(int max_num_threads) {
   gemmlowp_context_->set_max_num_threads(max_num_threads);
 }
 
+void CpuBackendContext::SetUseCaching(bool enable) { use_caching_ = enable; }
+
+ruy::PrepackedMatrix* CpuBackendContext::GetPrepacked(
+    const PrepackedMatrixCache::Key& key) {
+  auto it = prepacked_refs_.find(key);
+  if (it != prepacked_refs_.end()) {
+    return it->second;
+  }
+  ruy::PrepackedMatrix* entry =
+      PrepackedMatrixCache::GetInstance()->Acquire(key);
+  if (entry != nullptr) {
+    prepacked_refs_.emplace(key, entry);
+  }
+  return entry;
+}
+
+ruy::PrepackedMatrix* CpuBackendContext::InsertPrepacked(
+    const PrepackedMatrixCache::Key& key, const ruy::PrepackedMatrix& matrix,
+    std::vector<std::unique_ptr<char[]>> buffers) {
+  ruy::PrepackedMatrix* entry = PrepackedMatrixCache::GetInstance()->Insert(
+      key, matrix, std::move(buffers));
+  prepacked_refs_.emplace(key, entry);
+  return entry;
+}
+
 }  // namespace tflite
@@ -16,13 +16,93 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_KERNELS_CPU_BACKEND_CONTEXT_H_
 #define TENSORFLOW_LITE_KERNELS_CPU_BACKEND_CONTEXT_H_
 
+#include <cstddef>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
 
 #include "public/gemmlowp.h"
 #include "tensorflow/lite/experimental/ruy/context.h"
+#include "tensorflow/lite/experimental/ruy/matrix.h"
 
 namespace tflite {
 
+// A process-wide cache of pre-packed Gemm weights matrices.
+//
+// Packing a weights matrix into the back-end's internal layout is pure
+// overhead when it is repeated on every Gemm call, and is paid once per
+// interpreter when an application runs several interpreters for the same
+// model. This cache lets all CpuBackendContext instances in the process
+// share a single packed copy of each weights matrix.
+//
+// Entries are refcounted by the CpuBackendContext instances holding them
+// and are destroyed when the last holder is destroyed.
+//
+// A cached pack is a copy of the source buffer's contents, so it is only
+// valid as long as those contents do not change. See
+// CpuBackendContext::SetUseCaching for the resulting usage restriction.
+class PrepackedMatrixCache {
+ public:
+  // Identifies one packed weights matrix. The source buffer address is the
+  // primary key; the shape and the sizes of the Gemm scalar types
+  // disambiguate packed layouts, which are selected by the Gemm
+  // instantiation, not just by the weights data.
+  struct Key {
+    const void* data = nullptr;
+    int rows = 0;
+    int cols = 0;
+    int zero_point = 0;
+    int lhs_scalar_size = 0;
+    int rhs_scalar_size = 0;
+    int dst_scalar_size = 0;
+    int quantization_flavor = 0;
+
+    bool operator<(const Key& other) const {
+      return std::tie(data, rows, cols, zero_point, lhs_scalar_size,
+                      rhs_scalar_size, dst_scalar_size, quantization_flavor) <
+             std::tie(other.data, other.rows, other.cols, other.zero_point,
+                      other.lhs_scalar_size, other.rhs_scalar_size,
+                      other.dst_scalar_size, other.quantization_flavor);
+    }
+  };
+
+  // Alignment of the buffers holding packed data. Generous enough for the
+  // vector loads of any of the back-end's code paths.
+  static constexpr std::size_t kBufferAlignment = 64;
+
+  static PrepackedMatrixCache* GetInstance();
+
+  // Returns the entry for `key` and increments its refcount, or returns
+  // null if there is no such entry. A non-null result stays valid until
+  // the matching Release call.
+  ruy::PrepackedMatrix* Acquire(const Key& key);
+
+  // Stores `matrix` under `key`, taking ownership of `buffers`, which must
+  // own the memory that `matrix` points into. If another thread inserted an
+  // entry for `key` first, that entry wins and `buffers` is discarded.
+  // Either way, the returned entry has had its refcount incremented as if
+  // by Acquire.
+  ruy::PrepackedMatrix* Insert(const Key& key,
+                               const ruy::PrepackedMatrix& matrix,
+                               std::vector<std::unique_ptr<char[]>> buffers);
+
+  // Decrements the refcount taken by Acquire or Insert, destroying the
+  // entry when it drops to zero.
+  void Release(const Key& key);
+
+ private:
+  struct Entry {
+    ruy::PrepackedMatrix matrix;
+    std::vector<std::unique_ptr<char[]>> buffers;
+    int ref_count = 0;
+  };
+
+  std::mutex mutex_;
+  std::map<Key, Entry> entries_;
+};
+
 class CpuBackendContext final {
  public:
   CpuBackendContext();
@@ -49,6 +129,33 @@ class CpuBackendContext final {
   // See set_max_num_threads.
   int max_num_threads() const { return max_num_threads_; }
 
+  // Enables sharing pre-packed copies of Gemm weights matrices, process-wide,
+  // with every other CpuBackendContext that has caching enabled. Weights
+  // packing accounts for a substantial share of first-inference time, and
+  // without sharing each interpreter re-packs its own copy of the same
+  // weights.
+  //
+  // Packed copies are keyed by the weights data pointer, so this must only
+  // be enabled when every weights buffer passed to Gemm through this context
+  // is immutable and outlives this context. Disabled by default.
+  void SetUseCaching(bool enable);
+
+  // See SetUseCaching.
+  bool use_caching() const { return use_caching_; }
+
+  // Returns the shared pre-packed matrix for `key` if any context in the
+  // process already packed it, else null. The result stays valid for the
+  // lifetime of this context; repeat lookups of a key this context already
+  // holds are served locally, without touching the shared cache.
+  ruy::PrepackedMatrix* GetPrepacked(const PrepackedMatrixCache::Key& key);
+
+  // Publishes a freshly packed matrix to the shared cache and returns the
+  // canonical entry, which may be another context's equivalent pack if one
+  // was inserted concurrently. See PrepackedMatrixCache::Insert.
+  ruy::PrepackedMatrix* InsertPrepacked(
+      const PrepackedMatrixCache::Key& key, const ruy::PrepackedMatrix& matrix,
+      std::vector<std::unique_ptr<char[]>> buffers);
+
  private:
   // To enable a smooth transition from the current direct usage
   // of the underlying gemmlowp context to going through abstractions
@@ -62,6 +169,14 @@ class CpuBackendContext final {
   // See set_max_num_threads.
   int max_num_threads_;
 
+  // See SetUseCaching.
+  bool use_caching_ = false;
+
+  // The shared-cache entries this context holds references on. Also serves
+  // as a local lookup table so that steady-state inference does not contend
+  // on the shared cache's mutex.
+  std::map<PrepackedMatrixCache::Key, ruy::PrepackedMatrix*> prepacked_refs_;
+
   CpuBackendContext(const CpuBackendContext&) = delete;
 };
 
@@ -16,7 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_RUY_H_
 #define TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_RUY_H_
 
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "tensorflow/lite/experimental/ruy/ruy.h"
+#include "tensorflow/lite/experimental/ruy/ruy_advanced.h"
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
 
@@ -79,6 +85,44 @@ struct GemmImplUsingRuy {
     ruy::BasicSpec<AccumScalar, DstScalar> ruy_spec;
     MakeRuySpec(params, &ruy_spec);
 
+    if (context->use_caching()) {
+      // The LHS is the weights matrix in all TFLite usage of this Gemm (see
+      // the storage-orders comment in ValidateParams), so it is the operand
+      // whose packed form is worth sharing across calls and contexts.
+      PrepackedMatrixCache::Key key;
+      key.data = lhs_data;
+      key.rows = lhs_params.rows;
+      key.cols = lhs_params.cols;
+      key.zero_point = static_cast<int>(lhs_params.zero_point);
+      key.lhs_scalar_size = sizeof(LhsScalar);
+      key.rhs_scalar_size = sizeof(RhsScalar);
+      key.dst_scalar_size = sizeof(DstScalar);
+      key.quantization_flavor = static_cast<int>(quantization_flavor);
+      ruy::PrepackedMatrix* prepacked_lhs = context->GetPrepacked(key);
+      if (prepacked_lhs == nullptr) {
+        ruy::PrepackedMatrix fresh_prepacked_lhs;
+        std::vector<std::unique_ptr<char[]>> buffers;
+        auto alloc_fn = [&buffers](std::size_t num_bytes) -> void* {
+          // Over-allocate so that the packed block can be placed at the
+          // alignment that the cache guarantees.
+          constexpr std::size_t kAlign = PrepackedMatrixCache::kBufferAlignment;
+          buffers.emplace_back(new char[num_bytes + kAlign]);
+          const auto addr =
+              reinterpret_cast<std::uintptr_t>(buffers.back().get());
+          return reinterpret_cast<void*>((addr + kAlign - 1) & ~(kAlign - 1));
+        };
+        ruy::PrePackForMul<ruy::kAllPaths>(
+            ruy_lhs, ruy_rhs, ruy_spec, context->ruy_context(), &ruy_dst,
+            &fresh_prepacked_lhs, /*prepacked_rhs=*/nullptr, alloc_fn);
+        prepacked_lhs = context->InsertPrepacked(key, fresh_prepacked_lhs,
+                                                 std::move(buffers));
+      }
+      ruy::MulWithPrepacked<ruy::kAllPaths>(
+          ruy_lhs, ruy_rhs, ruy_spec, context->ruy_context(), &ruy_dst,
+          prepacked_lhs, /*prepacked_rhs=*/nullptr);
+      return;
+    }
+
     ruy::Mul<ruy::kAllPaths>(ruy_lhs, ruy_rhs, ruy_spec, context->ruy_context(),
                              &ruy_dst);
   }
@@ -491,6 +491,77 @@ void TestSomeGemm(int rows, int depth, int cols,
   }
 }
 
+// Exercises the pre-packed-weights caching path (see
+// CpuBackendContext::SetUseCaching): the first Gemm on a caching context
+// packs and publishes the weights, the repeat Gemm on the same context and
+// the Gemm on a second caching context both reuse the shared pack. All
+// three must agree with the reference result.
+template <typename LhsScalar, typename RhsScalar, typename AccumScalar,
+          typename DstScalar>
+void TestSomeGemmWithCaching(int rows, int depth, int cols) {
+  std::vector<LhsScalar> lhs_data;
+  std::vector<RhsScalar> rhs_data;
+  std::vector<AccumScalar> bias_data;
+  std::vector<DstScalar> dst_data;
+  MakeDeterministicPseudoRandomVector(rows * depth, &lhs_data);
+  MakeDeterministicPseudoRandomVector(depth * cols, &rhs_data);
+  MakeDeterministicPseudoRandomVector(rows, &bias_data);
+  MakeDeterministicPseudoRandomVector(rows * cols, &dst_data);
+
+  MatrixParams<LhsScalar> lhs_params;
+  lhs_params.order = cpu_backend_gemm::Order::kRowMajor;
+  lhs_params.rows = rows;
+  lhs_params.cols = depth;
+  if (!std::is_floating_point<LhsScalar>::value) {
+    lhs_params.zero_point = 1;
+  }
+
+  MatrixParams<RhsScalar> rhs_params;
+  rhs_params.order = cpu_backend_gemm::Order::kColMajor;
+  rhs_params.rows = depth;
+  rhs_params.cols = cols;
+  if (!std::is_floating_point<RhsScalar>::value) {
+    rhs_params.zero_point = 1;
+  }
+
+  MatrixParams<DstScalar> dst_params;
+  dst_params.order = cpu_backend_gemm::Order::kColMajor;
+  dst_params.rows = rows;
+  dst_params.cols = cols;
+  if (!std::is_floating_point<DstScalar>::value) {
+    dst_params.zero_point = 1;
+  }
+
+  CpuBackendContext reference_context;
+  GemmParams<AccumScalar, DstScalar> params;
+  params.bias = bias_data.data();
+  if (!std::is_floating_point<AccumScalar>::value) {
+    params.multiplier_fixedpoint = 1234567890;
+    params.multiplier_exponent = BisectReasonableMultiplierExponent(
+        -8 * static_cast<int>(sizeof(AccumScalar)), 0, lhs_params, lhs_data,
+        rhs_params, rhs_data, dst_params, &dst_data, params,
+        &reference_context);
+  }
+
+  std::vector<DstScalar> expected(rows * cols);
+  ReferenceGemm(lhs_params, lhs_data.data(), rhs_params, rhs_data.data(),
+                dst_params, expected.data(), params, &reference_context);
+
+  CpuBackendContext context_a;
+  context_a.SetUseCaching(true);
+  for (int repeat = 0; repeat < 2; repeat++) {
+    Gemm(lhs_params, lhs_data.data(), rhs_params, rhs_data.data(), dst_params,
+         dst_data.data(), params, &context_a);
+    CheckErrorForAccumulation<AccumScalar>(depth, dst_data, expected);
+  }
+
+  CpuBackendContext context_b;
+  context_b.SetUseCaching(true);
+  Gemm(lhs_params, lhs_data.data(), rhs_params, rhs_data.data(), dst_params,
+       dst_data.data(), params, &context_b);
+  CheckErrorForAccumulation<AccumScalar>(depth, dst_data, expected);
+}
+
 TEST(CpuBackendGemmSimpleTestAgainstGolden, Float) {
   TestSomeGemm<float, float, float, float>(2, 3, 4,
                                            {15, 34, 33, 79, 51, 124, 69, 169});
@@ -511,6 +582,20 @@ TEST(CpuBackendGemmSimpleTestAgainstGolden, Int8Int16) {
       3, 5, 4, {19, 48, 77, 48, 149, 250, 76, 249, 422, 105, 350, 595});
 }
 
+TEST(CpuBackendGemmWithCaching, Float) {
+  TestSomeGemmWithCaching<float, float, float, float>(31, 17, 11);
+}
+
+TEST(CpuBackendGemmWithCaching, Uint8) {
+  TestSomeGemmWithCaching<std::uint8_t, std::uint8_t, std::int32_t,
+                          std::uint8_t>(31, 17, 11);
+}
+
+TEST(CpuBackendGemmWithCaching, Int8) {
+  TestSomeGemmWithCaching<std::int8_t, std::int8_t, std::int32_t, std::int8_t>(
+      31, 17, 11);
+}
+
 template <typename tLhsScalar, typename tRhsScalar, typename tAccumScalar,
           typename tDstScalar>
 struct TypesTuple {
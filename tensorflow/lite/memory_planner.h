@@ -38,6 +38,19 @@ class MemoryPlanner {
   // have changed. All planned allocations remain, but can't be used until
   // ExecuteAllocations() is called.
   virtual TfLiteStatus ResetAllocations() = 0;
+
+  // Hands the memory backing non-persistent tensors back to the system (or
+  // to a shared pool), e.g. while another model runs. The allocation plan
+  // is kept; the graph cannot be invoked until AcquireNonPersistentMemory()
+  // is called.
+  virtual TfLiteStatus ReleaseNonPersistentMemory() = 0;
+
+  // Reclaims memory for non-persistent tensors after a
+  // ReleaseNonPersistentMemory() call, re-resolving their buffer pointers.
+  virtual TfLiteStatus AcquireNonPersistentMemory() = 0;
+
+  // Returns true unless non-persistent memory is currently released.
+  virtual bool HasNonPersistentMemory() = 0;
 };
 
 }  // namespace tflite
@@ -19,6 +19,10 @@ limitations under the License.
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <map>
+#include <mutex>
+#include <utility>
+
 #include "tensorflow/lite/allocation.h"
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/c_api_internal.h"
@@ -34,6 +38,64 @@ namespace {
 ErrorReporter* ValidateErrorReporter(ErrorReporter* e) {
   return e ? e : DefaultErrorReporter();
 }
+
+// Process-wide cache of resolved registration mappings. The mapping from a
+// model's operator codes to registrations is a pure function of the opcode
+// list and the resolver, so entries are keyed by a checksum of the opcode
+// content plus the resolver's address. Only sound for resolvers that are
+// immutable once used and live for the remainder of the process; see
+// InterpreterBuilder::SetRegistrationCaching().
+class RegistrationMappingCache {
+ public:
+  static RegistrationMappingCache* GetInstance() {
+    // Deliberately leaked to avoid static destruction order issues.
+    static RegistrationMappingCache* instance = new RegistrationMappingCache;
+    return instance;
+  }
+
+  bool Lookup(uint64_t checksum, const OpResolver* resolver,
+              std::vector<const TfLiteRegistration*>* mapping) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(std::make_pair(checksum, resolver));
+    if (it == entries_.end()) return false;
+    *mapping = it->second;
+    return true;
+  }
+
+  void Insert(uint64_t checksum, const OpResolver* resolver,
+              const std::vector<const TfLiteRegistration*>& mapping) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[std::make_pair(checksum, resolver)] = mapping;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::pair<uint64_t, const OpResolver*>,
+           std::vector<const TfLiteRegistration*>>
+      entries_;
+};
+
+// FNV-1a checksum over the content of the model's operator codes.
+uint64_t ChecksumOperatorCodes(
+    const flatbuffers::Vector<flatbuffers::Offset<OperatorCode>>& opcodes) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      hash = (hash ^ (value & 0xff)) * 1099511628211ULL;
+      value >>= 8;
+    }
+  };
+  for (const OperatorCode* opcode : opcodes) {
+    mix(static_cast<uint64_t>(opcode->builtin_code()));
+    mix(static_cast<uint64_t>(opcode->version()));
+    if (const auto* custom_code = opcode->custom_code()) {
+      for (char c : *custom_code) {
+        mix(static_cast<uint64_t>(c));
+      }
+    }
+  }
+  return hash;
+}
 }  // namespace
 
 const char* kEmptyTensorName = "";
@@ -199,12 +261,24 @@ InterpreterBuilder::InterpreterBuilder(const ::tflite::Model* model,
 
 InterpreterBuilder::~InterpreterBuilder() {}
 
+void InterpreterBuilder::SetRegistrationCaching(bool enable) {
+  use_registration_cache_ = enable;
+}
+
 TfLiteStatus InterpreterBuilder::BuildLocalIndexToRegistrationMapping() {
   TfLiteStatus status = kTfLiteOk;
   auto opcodes = model_->operator_codes();
   if (!opcodes) {
     return status;
   }
+  uint64_t checksum = 0;
+  if (use_registration_cache_) {
+    checksum = ChecksumOperatorCodes(*opcodes);
+    if (RegistrationMappingCache::GetInstance()->Lookup(
+            checksum, &op_resolver_, &flatbuffer_op_index_to_registration_)) {
+      return status;
+    }
+  }
   for (const OperatorCode* opcode : *opcodes) {
     const TfLiteRegistration* registration = nullptr;
     status = GetRegistrationFromOpCode(opcode, op_resolver_, error_reporter_,
@@ -214,6 +288,10 @@ TfLiteStatus InterpreterBuilder::BuildLocalIndexToRegistrationMapping() {
     }
     flatbuffer_op_index_to_registration_.push_back(registration);
   }
+  if (use_registration_cache_) {
+    RegistrationMappingCache::GetInstance()->Insert(
+        checksum, &op_resolver_, flatbuffer_op_index_to_registration_);
+  }
   return status;
 }
 
@@ -194,6 +194,15 @@ class InterpreterBuilder {
   TfLiteStatus operator()(std::unique_ptr<Interpreter>* interpreter,
                           int num_threads);
 
+  // Enables a process-wide cache of resolved registration mappings, keyed by
+  // a checksum of the model's operator codes and the resolver's address.
+  // Repeated loads of the same model then skip the per-opcode lookups in the
+  // resolver, trimming cold-start interpreter construction. Only enable this
+  // with a resolver that is not modified after its first use and that lives
+  // for the remainder of the process, such as the static builtin resolvers.
+  // WARNING: This is an experimental API and subject to change.
+  void SetRegistrationCaching(bool enable);
+
  private:
   TfLiteStatus BuildLocalIndexToRegistrationMapping();
   TfLiteStatus ParseNodes(
@@ -214,6 +223,7 @@ class InterpreterBuilder {
   std::vector<const TfLiteRegistration*> flatbuffer_op_index_to_registration_;
   std::vector<BuiltinOperator> flatbuffer_op_index_to_registration_types_;
   const Allocation* allocation_ = nullptr;
+  bool use_registration_cache_ = false;
 };
 
 }  // namespace tflite
@@ -195,6 +195,32 @@ TEST(BasicFlatBufferModel, TestModelInInterpreter) {
   }
 }
 
+TEST(BasicFlatBufferModel, TestRegistrationCaching) {
+  auto model = FlatBufferModel::BuildFromFile(
+      "tensorflow/lite/testdata/test_model.bin");
+  ASSERT_TRUE(model);
+
+  // The cache requires a resolver that lives for the rest of the process.
+  static TrivialResolver* resolver = new TrivialResolver(&dummy_reg);
+
+  std::unique_ptr<Interpreter> first;
+  InterpreterBuilder first_builder(*model, *resolver);
+  first_builder.SetRegistrationCaching(true);
+  ASSERT_EQ(first_builder(&first), kTfLiteOk);
+  ASSERT_NE(first, nullptr);
+
+  // The second build is served from the cache and produces an equivalent,
+  // working interpreter.
+  std::unique_ptr<Interpreter> second;
+  InterpreterBuilder second_builder(*model, *resolver);
+  second_builder.SetRegistrationCaching(true);
+  ASSERT_EQ(second_builder(&second), kTfLiteOk);
+  ASSERT_NE(second, nullptr);
+  ASSERT_EQ(second->nodes_size(), first->nodes_size());
+  ASSERT_EQ(second->AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(second->Invoke(), kTfLiteOk);
+}
+
 // Test that loading a model with TensorFlow ops fails when the flex delegate is
 // not linked into the target.
 TEST(FlexModel, FailureWithoutFlexDelegate) {
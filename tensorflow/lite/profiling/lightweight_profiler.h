@@ -0,0 +1,187 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_LIGHTWEIGHT_PROFILER_H_
+#define TENSORFLOW_LITE_PROFILING_LIGHTWEIGHT_PROFILER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/core/api/profiler.h"
+#include "tensorflow/lite/profiling/time.h"
+
+namespace tflite {
+namespace profiling {
+
+// Reads the cheapest cycle-granularity counter the target offers. The unit is
+// architecture dependent (TSC ticks on x86, the generic timer on ARM64,
+// microseconds elsewhere); durations are only meaningful relative to other
+// readings from the same device.
+inline uint64_t ProfileCycleCounter() {
+#if defined(__x86_64__)
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+#elif defined(__aarch64__)
+  uint64_t virtual_timer_value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(virtual_timer_value));
+  return virtual_timer_value;
+#else
+  return time::NowMicros();
+#endif
+}
+
+// A POD record of one profiled operator invocation.
+struct OpProfileRecord {
+  // Index of the operator node in the subgraph.
+  uint32_t op_index;
+  // Raw cycle counter readings taken around the op's invoke.
+  uint64_t begin_cycles;
+  uint64_t end_cycles;
+};
+
+// Aggregated timing statistics for one operator, with a log2-bucketed
+// duration histogram: bucket b counts invocations whose duration d satisfies
+// 2^b <= d < 2^(b+1) (bucket 0 also counts d == 0).
+struct OpProfileHistogram {
+  static constexpr int kNumBuckets = 64;
+
+  uint32_t op_index;
+  uint64_t count;
+  uint64_t total_cycles;
+  uint64_t min_cycles;
+  uint64_t max_cycles;
+  uint64_t bucket_counts[kNumBuckets];
+};
+
+// A profiler cheap enough to leave enabled in shipping builds: operator
+// invocations are written as POD records into a fixed-size ring buffer with a
+// raw cycle counter for timestamps. The hot path performs no allocation, no
+// locking and no system calls; when the buffer is full the oldest records are
+// overwritten silently. Non-operator events are ignored.
+//
+// Like BufferedProfiler, an instance must only be used from a single thread.
+// Extraction (GetRecords, GetOpHistograms) is the cold path and may be called
+// between Invoke() calls.
+class LightweightProfiler : public tflite::Profiler {
+ public:
+  explicit LightweightProfiler(size_t max_num_records = 4096)
+      : records_(RoundUpToPowerOfTwo(max_num_records)),
+        index_mask_(records_.size() - 1),
+        next_index_(0) {}
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      uint32_t event_metadata) override {
+    if (event_type != EventType::OPERATOR_INVOKE_EVENT) {
+      return kInvalidRecordHandle;
+    }
+    const uint32_t handle = next_index_++;
+    OpProfileRecord& record = records_[handle & index_mask_];
+    record.op_index = event_metadata;
+    record.end_cycles = 0;
+    record.begin_cycles = ProfileCycleCounter();
+    return handle;
+  }
+
+  void EndEvent(uint32_t event_handle) override {
+    const uint64_t end_cycles = ProfileCycleCounter();
+    if (event_handle == kInvalidRecordHandle ||
+        next_index_ - event_handle > records_.size()) {
+      // Never begun as an op event, or already overwritten.
+      return;
+    }
+    records_[event_handle & index_mask_].end_cycles = end_cycles;
+  }
+
+  // Discards all collected records.
+  void Reset() { next_index_ = 0; }
+
+  // Returns the completed records currently held in the ring buffer, oldest
+  // first. Incomplete records (an op whose EndEvent has not happened yet, or
+  // whose end was overwritten) are skipped.
+  std::vector<OpProfileRecord> GetRecords() const {
+    std::vector<OpProfileRecord> records;
+    const size_t size =
+        next_index_ < records_.size() ? next_index_ : records_.size();
+    records.reserve(size);
+    const uint32_t start = next_index_ - size;
+    for (size_t i = 0; i < size; ++i) {
+      const OpProfileRecord& record = records_[(start + i) & index_mask_];
+      if (record.end_cycles != 0) {
+        records.push_back(record);
+      }
+    }
+    return records;
+  }
+
+  // Aggregates the buffered records into one histogram per operator, ordered
+  // by ascending op index.
+  std::vector<OpProfileHistogram> GetOpHistograms() const {
+    std::vector<OpProfileHistogram> histograms;
+    for (const OpProfileRecord& record : GetRecords()) {
+      OpProfileHistogram* histogram = nullptr;
+      for (auto& candidate : histograms) {
+        if (candidate.op_index == record.op_index) {
+          histogram = &candidate;
+          break;
+        }
+      }
+      if (histogram == nullptr) {
+        histograms.push_back(OpProfileHistogram());
+        histogram = &histograms.back();
+        histogram->op_index = record.op_index;
+        histogram->min_cycles = ~static_cast<uint64_t>(0);
+      }
+      const uint64_t duration = record.end_cycles - record.begin_cycles;
+      histogram->count++;
+      histogram->total_cycles += duration;
+      if (duration < histogram->min_cycles) histogram->min_cycles = duration;
+      if (duration > histogram->max_cycles) histogram->max_cycles = duration;
+      histogram->bucket_counts[Log2Bucket(duration)]++;
+    }
+    for (size_t i = 1; i < histograms.size(); ++i) {
+      for (size_t j = i; j > 0 && histograms[j].op_index < histograms[j - 1].op_index;
+           --j) {
+        std::swap(histograms[j], histograms[j - 1]);
+      }
+    }
+    return histograms;
+  }
+
+ private:
+  static constexpr uint32_t kInvalidRecordHandle = static_cast<uint32_t>(~0);
+
+  static size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+  }
+
+  static int Log2Bucket(uint64_t duration) {
+    int bucket = 0;
+    while (duration >>= 1) bucket++;
+    return bucket;
+  }
+
+  std::vector<OpProfileRecord> records_;
+  const uint32_t index_mask_;
+  uint32_t next_index_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_LIGHTWEIGHT_PROFILER_H_
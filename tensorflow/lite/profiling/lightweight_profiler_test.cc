@@ -0,0 +1,106 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/lightweight_profiler.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/lite/testing/util.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+void ProfileOp(LightweightProfiler* profiler, int op_index) {
+  ScopedOperatorProfile profile(profiler, "OpInvoke", op_index);
+}
+
+TEST(LightweightProfilerTest, NonOperatorEventsAreIgnored) {
+  LightweightProfiler profiler;
+  {
+    ScopedProfile profile(&profiler, "NotAnOp");
+  }
+  EXPECT_TRUE(profiler.GetRecords().empty());
+}
+
+TEST(LightweightProfilerTest, RecordsOperatorInvocations) {
+  LightweightProfiler profiler;
+  ProfileOp(&profiler, 0);
+  ProfileOp(&profiler, 1);
+  ProfileOp(&profiler, 0);
+
+  auto records = profiler.GetRecords();
+  ASSERT_EQ(3, records.size());
+  EXPECT_EQ(0, records[0].op_index);
+  EXPECT_EQ(1, records[1].op_index);
+  EXPECT_EQ(0, records[2].op_index);
+  for (const auto& record : records) {
+    EXPECT_GE(record.end_cycles, record.begin_cycles);
+  }
+}
+
+TEST(LightweightProfilerTest, RingBufferOverwritesOldestRecords) {
+  // The requested capacity is rounded up to a power of two (4 here).
+  LightweightProfiler profiler(/*max_num_records=*/3);
+  for (int i = 0; i < 10; ++i) {
+    ProfileOp(&profiler, i);
+  }
+
+  auto records = profiler.GetRecords();
+  ASSERT_EQ(4, records.size());
+  EXPECT_EQ(6, records[0].op_index);
+  EXPECT_EQ(9, records[3].op_index);
+}
+
+TEST(LightweightProfilerTest, ResetDiscardsRecords) {
+  LightweightProfiler profiler;
+  ProfileOp(&profiler, 0);
+  profiler.Reset();
+  EXPECT_TRUE(profiler.GetRecords().empty());
+}
+
+TEST(LightweightProfilerTest, AggregatesPerOpHistograms) {
+  LightweightProfiler profiler;
+  ProfileOp(&profiler, 1);
+  ProfileOp(&profiler, 0);
+  ProfileOp(&profiler, 1);
+
+  auto histograms = profiler.GetOpHistograms();
+  ASSERT_EQ(2, histograms.size());
+  EXPECT_EQ(0, histograms[0].op_index);
+  EXPECT_EQ(1, histograms[0].count);
+  EXPECT_EQ(1, histograms[1].op_index);
+  EXPECT_EQ(2, histograms[1].count);
+
+  for (const auto& histogram : histograms) {
+    EXPECT_LE(histogram.min_cycles, histogram.max_cycles);
+    EXPECT_GE(histogram.total_cycles,
+              histogram.count > 0 ? histogram.min_cycles : 0);
+    uint64_t bucketed = 0;
+    for (int b = 0; b < OpProfileHistogram::kNumBuckets; ++b) {
+      bucketed += histogram.bucket_counts[b];
+    }
+    EXPECT_EQ(histogram.count, bucketed);
+  }
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  ::tflite::LogToStderr();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstring>
 #include <limits>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -32,6 +33,31 @@ T AlignTo(size_t alignment, T offset) {
 
 namespace tflite {
 
+ArenaBufferPool* ArenaBufferPool::GetInstance() {
+  // Leaked on purpose: arenas may return buffers during static destruction,
+  // in arbitrary order relative to a static pool's destructor.
+  static ArenaBufferPool* instance = new ArenaBufferPool;
+  return instance;
+}
+
+std::unique_ptr<char[]> ArenaBufferPool::Acquire(size_t size,
+                                                 size_t* actual_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buffers_.lower_bound(size);
+  if (it == buffers_.end()) {
+    return nullptr;
+  }
+  *actual_size = it->first;
+  std::unique_ptr<char[]> buffer = std::move(it->second);
+  buffers_.erase(it);
+  return buffer;
+}
+
+void ArenaBufferPool::Return(std::unique_ptr<char[]> buffer, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_.emplace(size, std::move(buffer));
+}
+
 TfLiteStatus SimpleMemoryArena::Allocate(TfLiteContext* context,
                                          size_t alignment, size_t size,
                                          ArenaAlloc* new_alloc) {
@@ -80,6 +106,31 @@ TfLiteStatus SimpleMemoryArena::Allocate(TfLiteContext* context,
   return kTfLiteOk;
 }
 
+TfLiteStatus SimpleMemoryArena::AllocateAt(TfLiteContext* context,
+                                           size_t offset, size_t size,
+                                           ArenaAlloc* new_alloc) {
+  new_alloc->offset = offset;
+  new_alloc->size = size;
+
+  if (size == 0) {
+    new_alloc->offset = 0;
+    return kTfLiteOk;
+  }
+
+  high_water_mark_ = std::max(high_water_mark_, offset + size);
+
+  // Keep the list sorted by offset. Overlaps with existing entries are
+  // allowed here, since a precomputed plan reuses the same region for
+  // tensors whose lifetimes do not overlap.
+  auto insertion_it = allocs_.begin();
+  while (insertion_it != allocs_.end() && *insertion_it < *new_alloc) {
+    ++insertion_it;
+  }
+  allocs_.insert(insertion_it, *new_alloc);
+
+  return kTfLiteOk;
+}
+
 TfLiteStatus SimpleMemoryArena::Deallocate(TfLiteContext* context,
                                            const ArenaAlloc& alloc) {
   if (alloc.size == 0) {
@@ -104,7 +155,15 @@ TfLiteStatus SimpleMemoryArena::Deallocate(TfLiteContext* context,
 TfLiteStatus SimpleMemoryArena::Commit(TfLiteContext* context) {
   size_t required_size = RequiredBufferSize();
   if (required_size > underlying_buffer_size_) {
-    char* new_alloc = new char[required_size];
+    // Prefer leasing a buffer that another arena released to the pool over
+    // allocating a fresh one.
+    size_t new_size = required_size;
+    std::unique_ptr<char[]> new_buffer =
+        ArenaBufferPool::GetInstance()->Acquire(required_size, &new_size);
+    if (new_buffer == nullptr) {
+      new_buffer.reset(new char[required_size]);
+    }
+    char* new_alloc = new_buffer.get();
     char* new_underlying_buffer_aligned_ptr = reinterpret_cast<char*>(
         AlignTo(arena_alignment_, reinterpret_cast<intptr_t>(new_alloc)));
 
@@ -120,8 +179,8 @@ TfLiteStatus SimpleMemoryArena::Commit(TfLiteContext* context) {
              copy_amount);
     }
 
-    underlying_buffer_.reset(new_alloc);
-    underlying_buffer_size_ = required_size;
+    underlying_buffer_ = std::move(new_buffer);
+    underlying_buffer_size_ = new_size;
     underlying_buffer_aligned_ptr_ = new_underlying_buffer_aligned_ptr;
   }
   committed_ = true;
@@ -148,4 +207,15 @@ TfLiteStatus SimpleMemoryArena::Clear() {
   return kTfLiteOk;
 }
 
+TfLiteStatus SimpleMemoryArena::ReleaseBuffer() {
+  committed_ = false;
+  if (underlying_buffer_ != nullptr) {
+    ArenaBufferPool::GetInstance()->Return(std::move(underlying_buffer_),
+                                           underlying_buffer_size_);
+    underlying_buffer_size_ = 0;
+    underlying_buffer_aligned_ptr_ = nullptr;
+  }
+  return kTfLiteOk;
+}
+
 }  // namespace tflite
@@ -16,7 +16,9 @@ limitations under the License.
 #define TENSORFLOW_LITE_SIMPLE_MEMORY_ARENA_H_
 
 #include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include "tensorflow/lite/c/c_api_internal.h"
 
 namespace tflite {
@@ -36,6 +38,30 @@ struct ArenaAlloc {
   }
 };
 
+// A process-wide pool of underlying arena buffers. Arenas that are only used
+// at different times (e.g. several loaded models that never run
+// simultaneously) can hand their buffer back to the pool between invocations
+// (see SimpleMemoryArena::ReleaseBuffer), so that the next arena to commit
+// leases an already-sized block instead of each arena holding a peak-sized
+// buffer for its whole lifetime. The pool only ever holds buffers that were
+// explicitly released; arenas that never release behave exactly as before.
+class ArenaBufferPool {
+ public:
+  static ArenaBufferPool* GetInstance();
+
+  // Removes and returns the smallest pooled buffer of at least 'size' bytes,
+  // or null if there is none. On success, 'actual_size' is set to the
+  // buffer's full size, which may exceed 'size'.
+  std::unique_ptr<char[]> Acquire(size_t size, size_t* actual_size);
+
+  // Adds 'buffer' of 'size' bytes to the pool.
+  void Return(std::unique_ptr<char[]> buffer, size_t size);
+
+ private:
+  std::mutex mutex_;
+  std::multimap<size_t, std::unique_ptr<char[]>> buffers_;
+};
+
 // This small class is responsible for allocating, deallocating and reusing
 // dynamic memory from a common underlying buffer. The arena can be used in
 // scenarios when the pattern of memory allocations and deallocations is
@@ -53,6 +79,13 @@ class SimpleMemoryArena {
   TfLiteStatus Allocate(TfLiteContext* context, size_t alignment, size_t size,
                         ArenaAlloc* new_alloc);
 
+  // Records an allocation at a caller-chosen offset, e.g. coming from a
+  // precomputed memory plan. Unlike Allocate, overlapping allocations are
+  // accepted; the caller is responsible for only using overlapping regions
+  // at different times.
+  TfLiteStatus AllocateAt(TfLiteContext* context, size_t offset, size_t size,
+                          ArenaAlloc* new_alloc);
+
   TfLiteStatus Deallocate(TfLiteContext* context, const ArenaAlloc& alloc);
 
   inline size_t RequiredBufferSize() {
@@ -69,6 +102,13 @@ class SimpleMemoryArena {
 
   TfLiteStatus Clear();
 
+  // Hands the underlying buffer back to the process-wide ArenaBufferPool,
+  // e.g. between invocations of temporally exclusive interpreters. All
+  // allocations are kept, but cannot be resolved until Commit() leases a
+  // buffer (possibly the same one) back from the pool; since the base
+  // pointer may change, previously resolved pointers become invalid.
+  TfLiteStatus ReleaseBuffer();
+
   int64_t BasePointer() const {
     return reinterpret_cast<int64_t>(underlying_buffer_aligned_ptr_);
   }
@@ -123,6 +123,40 @@ TEST(SimpleMemoryArenaTest, TestAfterClear) {
   EXPECT_EQ(allocs[8].offset, 8192);
 }
 
+TEST(SimpleMemoryArenaTest, ReleaseBufferAndPoolReuse) {
+  TfLiteContext context;
+  ArenaAlloc allocs[2];
+
+  // Use a distinctive size so this test only ever leases its own buffer back
+  // from the process-wide pool.
+  constexpr size_t kBufferSize = 100000;
+
+  SimpleMemoryArena arena_a(64);
+  ASSERT_EQ(arena_a.Allocate(&context, 32, kBufferSize, &allocs[0]), kTfLiteOk);
+  ASSERT_EQ(arena_a.Commit(&context), kTfLiteOk);
+  int64_t base_a = arena_a.BasePointer();
+  ASSERT_NE(base_a, 0);
+  ASSERT_EQ(arena_a.ReleaseBuffer(), kTfLiteOk);
+
+  // An arena that needs at most as much memory leases the released buffer
+  // from the pool instead of allocating its own.
+  SimpleMemoryArena arena_b(64);
+  ASSERT_EQ(arena_b.Allocate(&context, 32, kBufferSize - 2048, &allocs[1]),
+            kTfLiteOk);
+  ASSERT_EQ(arena_b.Commit(&context), kTfLiteOk);
+  EXPECT_EQ(arena_b.BasePointer(), base_a);
+  ASSERT_EQ(arena_b.ReleaseBuffer(), kTfLiteOk);
+
+  // The first arena leases the buffer back; its allocs resolve again since
+  // the plan was kept across the release.
+  ASSERT_EQ(arena_a.Commit(&context), kTfLiteOk);
+  EXPECT_EQ(arena_a.BasePointer(), base_a);
+  char* resolved_ptr = nullptr;
+  ASSERT_EQ(arena_a.ResolveAlloc(&context, allocs[0], &resolved_ptr),
+            kTfLiteOk);
+  EXPECT_NE(resolved_ptr, nullptr);
+}
+
 }  // namespace
 }  // namespace tflite
 
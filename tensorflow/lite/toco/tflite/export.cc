@@ -413,11 +413,22 @@ Offset<Vector<Offset<Operator>>> ExportOperators(
 
 Offset<Vector<Offset<Buffer>>> ExportBuffers(
     const Model& model, const std::vector<const Array*>& buffers_to_write,
-    FlatBufferBuilder* builder) {
+    FlatBufferBuilder* builder, const ExportParams& params) {
+  // Flatbuffers caps per-vector alignment at FLATBUFFERS_MAX_ALIGNMENT, which
+  // satisfies the natural alignment of every tensor type the runtime reads in
+  // place from a memory-mapped model file.
+  constexpr size_t kConstantBufferAlignment = FLATBUFFERS_MAX_ALIGNMENT;
   std::vector<Offset<Buffer>> buffer_vector;
   size_t index = 0;
   for (const Array* array_ptr : buffers_to_write) {
     const Array& array = *array_ptr;
+    if (params.align_constant_buffers && array.buffer &&
+        array.data_type != ArrayDataType::kString) {
+      const size_t num_bytes =
+          array.buffer->Length() * ElementSize(array.data_type);
+      builder->ForceVectorAlignment(num_bytes, sizeof(uint8_t),
+                                    kConstantBufferAlignment);
+    }
     Offset<Vector<uint8_t>> data_buffer = DataBuffer::Serialize(array, builder);
     buffer_vector.push_back(CreateBuffer(*builder, data_buffer));
     index++;
@@ -578,7 +589,7 @@ tensorflow::Status Export(
                                  /* name */ 0);
   std::vector<flatbuffers::Offset<SubGraph>> subgraphs = {subgraph};
 
-  auto buffers = ExportBuffers(model, buffers_to_write, &builder);
+  auto buffers = ExportBuffers(model, buffers_to_write, &builder, params);
   auto description = builder.CreateString("TOCO Converted.");
   auto new_model_location =
       CreateModel(builder, TFLITE_SCHEMA_VERSION, op_codes,
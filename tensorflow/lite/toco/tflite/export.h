@@ -28,6 +28,9 @@ struct ExportParams {
   bool allow_custom_ops = false;
   bool enable_select_tf_ops = false;
   bool quantize_weights = false;
+  // Align constant tensor buffers so the runtime can reference them in place
+  // from a memory-mapped model file.
+  bool align_constant_buffers = false;
 };
 
 // Transform the given tf.mini model into a TF Lite flatbuffer and deposit the
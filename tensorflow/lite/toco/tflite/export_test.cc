@@ -241,6 +241,28 @@ TEST_F(ExportTest, QuantizeWeights) {
   EXPECT_LT(quantized_result.size(), unquantized_result.size());
 }
 
+TEST_F(ExportTest, AlignConstantBuffers) {
+  BuildQuantizableTestModel();
+
+  ExportParams params;
+  params.allow_custom_ops = true;
+  params.align_constant_buffers = true;
+
+  string result;
+  auto status = Export(input_model_, &result, params);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+
+  // Every constant buffer payload should be aligned within the serialized
+  // model, so a memory-mapped model file can be read in place.
+  auto* model = ::tflite::GetModel(result.data());
+  for (const ::tflite::Buffer* buffer : *model->buffers()) {
+    if (!buffer->data()) continue;
+    const auto offset =
+        reinterpret_cast<const char*>(buffer->data()->data()) - result.data();
+    EXPECT_EQ(0, offset % FLATBUFFERS_MAX_ALIGNMENT);
+  }
+}
+
 class OpSetsTest : public ExportTest {
  public:
   enum OpSet { kTfLiteBuiltins, kSelectTfOps, kCustomOps };
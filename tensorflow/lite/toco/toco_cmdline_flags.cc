@@ -172,7 +172,13 @@ bool ParseTocoFlagsFromCommandLineFlags(
            parsed_flags.enable_select_tf_ops.default_value(), ""),
       // WARNING: Experimental interface, subject to change
       Flag("force_select_tf_ops", parsed_flags.force_select_tf_ops.bind(),
-           parsed_flags.force_select_tf_ops.default_value(), "")};
+           parsed_flags.force_select_tf_ops.default_value(), ""),
+      Flag("align_constant_buffers", parsed_flags.align_constant_buffers.bind(),
+           parsed_flags.align_constant_buffers.default_value(),
+           "Boolean indicating whether to align constant tensor buffers in "
+           "the emitted flatbuffer. Aligned buffers can be used in place from "
+           "a memory-mapped model file, reducing RAM usage on embedded "
+           "targets. Ignored if the output format is not TFLite.")};
   bool asked_for_help =
       *argc == 2 && (!strcmp(argv[1], "--help") || !strcmp(argv[1], "-help"));
   if (asked_for_help) {
@@ -269,6 +275,7 @@ void ReadTocoFlagsFromCommandLineFlags(const ParsedTocoFlags& parsed_toco_flags,
   READ_TOCO_FLAG(post_training_quantize, FlagRequirement::kNone);
   READ_TOCO_FLAG(enable_select_tf_ops, FlagRequirement::kNone);
   READ_TOCO_FLAG(force_select_tf_ops, FlagRequirement::kNone);
+  READ_TOCO_FLAG(align_constant_buffers, FlagRequirement::kNone);
 
   if (parsed_toco_flags.force_select_tf_ops.value() &&
       !parsed_toco_flags.enable_select_tf_ops.value()) {
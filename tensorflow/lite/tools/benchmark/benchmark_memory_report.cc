@@ -0,0 +1,318 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/tools/benchmark/benchmark_memory_report.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "tensorflow/lite/profiling/time.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+namespace benchmark {
+namespace {
+
+std::string GetOpName(const TfLiteRegistration& registration) {
+  const int code = registration.builtin_code;
+  if (code == tflite::BuiltinOperator_CUSTOM) {
+    const char* custom_name = registration.custom_name;
+    return custom_name ? custom_name : "UnknownCustomOp";
+  }
+  return tflite::EnumNamesBuiltinOperator()[code];
+}
+
+// Ops that only change layout or precision; their whole cost is memory
+// traffic, so they are flagged as overhead in the report.
+bool IsConversionOp(const TfLiteRegistration& registration) {
+  switch (registration.builtin_code) {
+    case tflite::BuiltinOperator_TRANSPOSE:
+    case tflite::BuiltinOperator_QUANTIZE:
+    case tflite::BuiltinOperator_DEQUANTIZE:
+    case tflite::BuiltinOperator_CAST:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t TensorBytes(const Interpreter& interpreter, int tensor_index) {
+  if (tensor_index < 0) return 0;  // Skip optional tensors.
+  const TfLiteTensor* tensor = interpreter.tensor(tensor_index);
+  if (tensor == nullptr) return 0;
+  return static_cast<int64_t>(tensor->bytes);
+}
+
+std::string FormatKb(int64_t bytes) {
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(1) << bytes / 1024.0;
+  return stream.str();
+}
+
+// Key for matching nodes across runs or models: the op name plus the
+// occurrence ordinal of that op in execution order.  This stays stable
+// when unrelated nodes are added or removed and node indices shift.
+std::vector<std::string> NodeKeys(const std::vector<NodeMemoryStats>& nodes) {
+  std::map<std::string, int> occurrences;
+  std::vector<std::string> keys;
+  keys.reserve(nodes.size());
+  for (const NodeMemoryStats& node : nodes) {
+    keys.push_back(node.op_name + "#" +
+                   std::to_string(occurrences[node.op_name]++));
+  }
+  return keys;
+}
+
+}  // namespace
+
+MemoryReport BuildMemoryReport(const Interpreter& interpreter) {
+  MemoryReport report;
+  for (int node_index : interpreter.execution_plan()) {
+    const auto* node_and_reg = interpreter.node_and_registration(node_index);
+    if (node_and_reg == nullptr) continue;
+    const TfLiteNode& node = node_and_reg->first;
+    const TfLiteRegistration& registration = node_and_reg->second;
+
+    NodeMemoryStats stats;
+    stats.node_index = node_index;
+    stats.op_name = GetOpName(registration);
+    stats.is_conversion_op = IsConversionOp(registration);
+
+    for (int i = 0; i < node.inputs->size; ++i) {
+      const int tensor_index = node.inputs->data[i];
+      const int64_t bytes = TensorBytes(interpreter, tensor_index);
+      stats.io_bytes += bytes;
+      const TfLiteTensor* tensor =
+          tensor_index < 0 ? nullptr : interpreter.tensor(tensor_index);
+      if (tensor != nullptr && tensor->allocation_type == kTfLiteMmapRo) {
+        stats.ro_bytes += bytes;
+      }
+    }
+
+    // Outputs and temporaries are attributed to the producing node.
+    auto account_produced = [&](const TfLiteIntArray* tensor_indices) {
+      for (int i = 0; i < tensor_indices->size; ++i) {
+        const int tensor_index = tensor_indices->data[i];
+        if (tensor_index < 0) continue;
+        const TfLiteTensor* tensor = interpreter.tensor(tensor_index);
+        if (tensor == nullptr) continue;
+        const int64_t bytes = static_cast<int64_t>(tensor->bytes);
+        switch (tensor->allocation_type) {
+          case kTfLiteArenaRw:
+          case kTfLiteArenaRwPersistent:
+            stats.arena_bytes += bytes;
+            break;
+          case kTfLiteDynamic:
+            stats.dynamic_bytes += bytes;
+            break;
+          default:
+            break;
+        }
+      }
+    };
+    account_produced(node.outputs);
+    account_produced(node.temporaries);
+    for (int i = 0; i < node.outputs->size; ++i) {
+      stats.io_bytes += TensorBytes(interpreter, node.outputs->data[i]);
+    }
+
+    if (stats.is_conversion_op) {
+      ++report.num_conversion_ops;
+      report.conversion_io_bytes += stats.io_bytes;
+    }
+    report.nodes.push_back(stats);
+  }
+
+  // Totals are computed over all tensors so tensors shared between
+  // nodes are counted once.
+  for (size_t t = 0; t < interpreter.tensors_size(); ++t) {
+    const TfLiteTensor* tensor = interpreter.tensor(t);
+    if (tensor == nullptr) continue;
+    const int64_t bytes = static_cast<int64_t>(tensor->bytes);
+    switch (tensor->allocation_type) {
+      case kTfLiteArenaRw:
+      case kTfLiteArenaRwPersistent:
+        report.total_arena_bytes += bytes;
+        break;
+      case kTfLiteMmapRo:
+        report.total_ro_bytes += bytes;
+        break;
+      case kTfLiteDynamic:
+        report.total_dynamic_bytes += bytes;
+        break;
+      default:
+        break;
+    }
+  }
+  return report;
+}
+
+double MeasureCopyBandwidth() {
+  // Copy between two buffers well beyond cache size, several times, and
+  // report the sustained rate.  This approximates the peak memory
+  // bandwidth a single thread can achieve on this device.
+  constexpr int64_t kBufferBytes = 16 * 1024 * 1024;
+  constexpr int kIterations = 8;
+  std::vector<char> src(kBufferBytes, 1);
+  std::vector<char> dst(kBufferBytes, 0);
+  // Warm up once so page faults don't count against the measurement.
+  std::memcpy(dst.data(), src.data(), kBufferBytes);
+  const uint64_t start_us = profiling::time::NowMicros();
+  for (int i = 0; i < kIterations; ++i) {
+    std::memcpy(dst.data(), src.data(), kBufferBytes);
+  }
+  const uint64_t elapsed_us = profiling::time::NowMicros() - start_us;
+  if (elapsed_us == 0) return 0;
+  // Each iteration reads and writes the buffer once.
+  return 2.0 * kIterations * kBufferBytes / elapsed_us;
+}
+
+std::string FormatMemoryReport(const MemoryReport& report) {
+  std::stringstream stream;
+  stream << "Memory report (bytes are per invocation):\n";
+  stream << std::setw(6) << "node" << std::setw(24) << "op" << std::setw(12)
+         << "arena KB" << std::setw(12) << "weights KB" << std::setw(12)
+         << "io KB";
+  if (report.copy_bandwidth_bytes_per_us > 0) {
+    stream << std::setw(12) << "floor us";
+  }
+  stream << "  flags\n";
+  for (const NodeMemoryStats& node : report.nodes) {
+    stream << std::setw(6) << node.node_index << std::setw(24) << node.op_name
+           << std::setw(12) << FormatKb(node.arena_bytes) << std::setw(12)
+           << FormatKb(node.ro_bytes) << std::setw(12)
+           << FormatKb(node.io_bytes);
+    if (report.copy_bandwidth_bytes_per_us > 0) {
+      std::stringstream floor;
+      floor << std::fixed << std::setprecision(1)
+            << node.io_bytes / report.copy_bandwidth_bytes_per_us;
+      stream << std::setw(12) << floor.str();
+    }
+    if (node.is_conversion_op) {
+      stream << "  [conversion]";
+    }
+    if (node.dynamic_bytes > 0) {
+      stream << "  [dynamic " << FormatKb(node.dynamic_bytes) << " KB]";
+    }
+    stream << "\n";
+  }
+  stream << "Arena total: " << FormatKb(report.total_arena_bytes)
+         << " KB, weights: " << FormatKb(report.total_ro_bytes)
+         << " KB, dynamic: " << FormatKb(report.total_dynamic_bytes)
+         << " KB\n";
+  if (report.num_conversion_ops > 0) {
+    stream << "Conversion overhead: " << report.num_conversion_ops
+           << " layout/quantization ops moving "
+           << FormatKb(report.conversion_io_bytes) << " KB per invocation\n";
+  }
+  if (report.copy_bandwidth_bytes_per_us > 0) {
+    stream << "Measured copy bandwidth: " << std::fixed << std::setprecision(2)
+           << report.copy_bandwidth_bytes_per_us / 1024.0
+           << " GB/s; 'floor us' is each node's io bytes at that rate, a"
+           << " lower bound to compare against op profiling times\n";
+  }
+  return stream.str();
+}
+
+bool WriteMemoryReportCsv(const MemoryReport& report,
+                          const std::string& path) {
+  std::ofstream output(path);
+  if (!output.good()) return false;
+  output << "node_index,op_name,arena_bytes,ro_bytes,dynamic_bytes,io_bytes,"
+            "conversion\n";
+  for (const NodeMemoryStats& node : report.nodes) {
+    output << node.node_index << "," << node.op_name << ","
+           << node.arena_bytes << "," << node.ro_bytes << ","
+           << node.dynamic_bytes << "," << node.io_bytes << ","
+           << (node.is_conversion_op ? 1 : 0) << "\n";
+  }
+  return output.good();
+}
+
+std::string DiffMemoryReportAgainstCsv(const MemoryReport& report,
+                                       const std::string& path) {
+  std::ifstream input(path);
+  if (!input.good()) {
+    return "Could not read baseline memory report: " + path;
+  }
+  std::string line;
+  std::getline(input, line);  // Skip the header.
+  std::map<std::string, NodeMemoryStats> baseline;
+  std::map<std::string, int> occurrences;
+  while (std::getline(input, line)) {
+    std::stringstream row(line);
+    std::string field;
+    NodeMemoryStats node;
+    if (!std::getline(row, field, ',')) continue;
+    node.node_index = std::atoi(field.c_str());
+    if (!std::getline(row, node.op_name, ',')) continue;
+    if (!std::getline(row, field, ',')) continue;
+    node.arena_bytes = std::atoll(field.c_str());
+    if (!std::getline(row, field, ',')) continue;
+    node.ro_bytes = std::atoll(field.c_str());
+    if (!std::getline(row, field, ',')) continue;
+    node.dynamic_bytes = std::atoll(field.c_str());
+    if (!std::getline(row, field, ',')) continue;
+    node.io_bytes = std::atoll(field.c_str());
+    baseline[node.op_name + "#" +
+             std::to_string(occurrences[node.op_name]++)] = node;
+  }
+
+  std::stringstream stream;
+  stream << "Memory report diff against " << path
+         << " (op#occurrence: current vs baseline):\n";
+  const std::vector<std::string> keys = NodeKeys(report.nodes);
+  bool any_change = false;
+  for (size_t i = 0; i < report.nodes.size(); ++i) {
+    const NodeMemoryStats& node = report.nodes[i];
+    auto it = baseline.find(keys[i]);
+    if (it == baseline.end()) {
+      stream << "  " << keys[i] << ": only in current run, arena "
+             << FormatKb(node.arena_bytes) << " KB, io "
+             << FormatKb(node.io_bytes) << " KB\n";
+      any_change = true;
+      continue;
+    }
+    const NodeMemoryStats& old = it->second;
+    if (node.arena_bytes != old.arena_bytes ||
+        node.io_bytes != old.io_bytes || node.ro_bytes != old.ro_bytes) {
+      stream << "  " << keys[i] << ": arena " << FormatKb(node.arena_bytes)
+             << " vs " << FormatKb(old.arena_bytes) << " KB, weights "
+             << FormatKb(node.ro_bytes) << " vs " << FormatKb(old.ro_bytes)
+             << " KB, io " << FormatKb(node.io_bytes) << " vs "
+             << FormatKb(old.io_bytes) << " KB\n";
+      any_change = true;
+    }
+    baseline.erase(it);
+  }
+  for (const auto& entry : baseline) {
+    stream << "  " << entry.first << ": only in baseline, arena "
+           << FormatKb(entry.second.arena_bytes) << " KB, io "
+           << FormatKb(entry.second.io_bytes) << " KB\n";
+    any_change = true;
+  }
+  if (!any_change) {
+    stream << "  no per-node differences\n";
+  }
+  return stream.str();
+}
+
+}  // namespace benchmark
+}  // namespace tflite
@@ -0,0 +1,88 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_MEMORY_REPORT_H_
+#define TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_MEMORY_REPORT_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/interpreter.h"
+
+namespace tflite {
+namespace benchmark {
+
+// Memory accounting for one node in the execution plan.  Output and
+// temporary tensors are attributed to the node that produces them.
+struct NodeMemoryStats {
+  int node_index = 0;
+  std::string op_name;
+  // Bytes of the node's output and temporary tensors that live in the
+  // interpreter's memory arenas.
+  int64_t arena_bytes = 0;
+  // Bytes of read-only (weight) tensors the node reads.
+  int64_t ro_bytes = 0;
+  // Bytes of dynamically allocated output tensors.
+  int64_t dynamic_bytes = 0;
+  // Bytes read plus written per invocation (all inputs and outputs);
+  // a lower bound on the node's memory traffic.
+  int64_t io_bytes = 0;
+  // True for ops that only convert layout or precision (TRANSPOSE,
+  // QUANTIZE, DEQUANTIZE, CAST) and are therefore pure overhead.
+  bool is_conversion_op = false;
+};
+
+// Whole-model memory breakdown, built from an interpreter whose tensors
+// have been allocated.
+struct MemoryReport {
+  std::vector<NodeMemoryStats> nodes;
+  // Totals over all tensors, by allocation type.
+  int64_t total_arena_bytes = 0;
+  int64_t total_ro_bytes = 0;
+  int64_t total_dynamic_bytes = 0;
+  // Traffic and count of the flagged conversion ops.
+  int64_t conversion_io_bytes = 0;
+  int num_conversion_ops = 0;
+  // Measured large-copy bandwidth in bytes per microsecond, or 0 if it
+  // was not measured.  Dividing a node's io_bytes by this gives the
+  // node's memory-bound floor latency.
+  double copy_bandwidth_bytes_per_us = 0;
+};
+
+// Walks the interpreter's execution plan and tensors to build the
+// report.  Does not fill in copy_bandwidth_bytes_per_us.
+MemoryReport BuildMemoryReport(const Interpreter& interpreter);
+
+// Measures the achievable large-copy bandwidth of this device with a
+// short memcpy loop, in bytes per microsecond.
+double MeasureCopyBandwidth();
+
+// Renders the report as a human-readable table with totals.
+std::string FormatMemoryReport(const MemoryReport& report);
+
+// Writes one CSV row per node, suitable for DiffMemoryReportAgainstCsv.
+// Returns false if the file could not be written.
+bool WriteMemoryReportCsv(const MemoryReport& report,
+                          const std::string& path);
+
+// Compares the report against a CSV written by a previous run (of this
+// or another model) and renders the per-node deltas.
+std::string DiffMemoryReportAgainstCsv(const MemoryReport& report,
+                                       const std::string& path);
+
+}  // namespace benchmark
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_MEMORY_REPORT_H_
@@ -20,6 +20,7 @@ limitations under the License.
 #include <gtest/gtest.h>
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/testing/util.h"
+#include "tensorflow/lite/tools/benchmark/benchmark_memory_report.h"
 #include "tensorflow/lite/tools/benchmark/benchmark_tflite_model.h"
 #include "tensorflow/lite/tools/command_line_flags.h"
 
@@ -49,6 +50,10 @@ BenchmarkParams CreateParams() {
   params.AddParam("use_legacy_nnapi", BenchmarkParam::Create<bool>(false));
   params.AddParam("use_gpu", BenchmarkParam::Create<bool>(false));
   params.AddParam("enable_op_profiling", BenchmarkParam::Create<bool>(false));
+  params.AddParam("enable_memory_report", BenchmarkParam::Create<bool>(false));
+  params.AddParam("memory_report_csv", BenchmarkParam::Create<std::string>(""));
+  params.AddParam("memory_report_diff",
+                  BenchmarkParam::Create<std::string>(""));
   return params;
 }
 
@@ -71,6 +76,22 @@ TEST(BenchmarkTest, DoesntCrash) {
   benchmark.Run();
 }
 
+TEST(BenchmarkTest, MemoryReportCoversExecutionPlan) {
+  ASSERT_THAT(g_model_path, testing::NotNull());
+
+  TestBenchmark benchmark(CreateParams());
+  benchmark.Init();
+
+  auto* interpreter = benchmark.GetInterpreter();
+  MemoryReport report = BuildMemoryReport(*interpreter);
+  EXPECT_EQ(report.nodes.size(), interpreter->execution_plan().size());
+  EXPECT_GT(report.total_arena_bytes, 0);
+  for (const NodeMemoryStats& node : report.nodes) {
+    EXPECT_GT(node.io_bytes, 0);
+  }
+  EXPECT_FALSE(FormatMemoryReport(report).empty());
+}
+
 TEST(BenchmarkTest, ParametersArePopulatedWhenInputShapeIsNotSpecified) {
   ASSERT_THAT(g_model_path, testing::NotNull());
 
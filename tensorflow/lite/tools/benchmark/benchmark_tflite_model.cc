@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/lite/profiling/buffered_profiler.h"
 #include "tensorflow/lite/profiling/profile_summarizer.h"
 #include "tensorflow/lite/string_util.h"
+#include "tensorflow/lite/tools/benchmark/benchmark_memory_report.h"
 #include "tensorflow/lite/tools/benchmark/logging.h"
 #include "tensorflow/lite/tools/evaluation/utils.h"
 
@@ -81,6 +82,36 @@ class GemmlowpProfilingListener : public BenchmarkListener {
   void OnBenchmarkEnd(const BenchmarkResults& results) override;
 };
 
+// Logs a whole-model memory and layout report when the benchmark ends,
+// optionally writing it to CSV and diffing it against a previous CSV.
+class MemoryReportListener : public BenchmarkListener {
+ public:
+  MemoryReportListener(Interpreter* interpreter, std::string csv_path,
+                       std::string diff_path)
+      : interpreter_(interpreter),
+        csv_path_(std::move(csv_path)),
+        diff_path_(std::move(diff_path)) {
+    TFLITE_BENCHMARK_CHECK(interpreter);
+  }
+
+  void OnBenchmarkEnd(const BenchmarkResults& results) override {
+    MemoryReport report = BuildMemoryReport(*interpreter_);
+    report.copy_bandwidth_bytes_per_us = MeasureCopyBandwidth();
+    TFLITE_LOG(INFO) << FormatMemoryReport(report);
+    if (!diff_path_.empty()) {
+      TFLITE_LOG(INFO) << DiffMemoryReportAgainstCsv(report, diff_path_);
+    }
+    if (!csv_path_.empty() && !WriteMemoryReportCsv(report, csv_path_)) {
+      TFLITE_LOG(ERROR) << "Failed to write memory report to " << csv_path_;
+    }
+  }
+
+ private:
+  Interpreter* interpreter_;
+  std::string csv_path_;
+  std::string diff_path_;
+};
+
 void ProfilingListener::OnSingleRunStart(RunType run_type) {
   if (run_type == REGULAR) {
     profiler_.Reset();
@@ -236,6 +267,12 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
   default_params.AddParam(
       "enable_op_profiling",
       BenchmarkParam::Create<bool>(kOpProfilingEnabledDefault));
+  default_params.AddParam("enable_memory_report",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("memory_report_csv",
+                          BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("memory_report_diff",
+                          BenchmarkParam::Create<std::string>(""));
   return default_params;
 }
 
@@ -270,7 +307,15 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
       CreateFlag<bool>("use_legacy_nnapi", &params_, "use legacy nnapi api"),
       CreateFlag<bool>("use_gpu", &params_, "use gpu"),
       CreateFlag<bool>("allow_fp16", &params_, "allow fp16"),
-      CreateFlag<bool>("enable_op_profiling", &params_, "enable op profiling")};
+      CreateFlag<bool>("enable_op_profiling", &params_, "enable op profiling"),
+      CreateFlag<bool>("enable_memory_report", &params_,
+                       "log per-op arena footprint, memory traffic and "
+                       "conversion-op overhead"),
+      CreateFlag<std::string>("memory_report_csv", &params_,
+                              "write the memory report to this CSV file"),
+      CreateFlag<std::string>("memory_report_diff", &params_,
+                              "diff the memory report against a CSV written "
+                              "by a previous run")};
 
   flags.insert(flags.end(), specific_flags.begin(), specific_flags.end());
   return flags;
@@ -291,6 +336,8 @@ void BenchmarkTfLiteModel::LogParams() {
                    << "]";
   TFLITE_LOG(INFO) << "Enable op profiling: ["
                    << params_.Get<bool>("enable_op_profiling") << "]";
+  TFLITE_LOG(INFO) << "Enable memory report: ["
+                   << params_.Get<bool>("enable_memory_report") << "]";
 }
 
 bool BenchmarkTfLiteModel::ValidateParams() {
@@ -483,6 +530,12 @@ void BenchmarkTfLiteModel::Init() {
     profiling_listener_.reset(new ProfilingListener(interpreter.get()));
     AddListener(profiling_listener_.get());
   }
+  if (params_.Get<bool>("enable_memory_report")) {
+    memory_report_listener_.reset(new MemoryReportListener(
+        interpreter.get(), params_.Get<std::string>("memory_report_csv"),
+        params_.Get<std::string>("memory_report_diff")));
+    AddListener(memory_report_listener_.get());
+  }
 #ifdef GEMMLOWP_PROFILING
   gemmlowp_profiling_listener_.reset(new GemmlowpProfilingListener());
   AddListener(gemmlowp_profiling_listener_.get());
@@ -71,6 +71,7 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   std::vector<InputTensorData> inputs_data_;
   std::unique_ptr<BenchmarkListener> profiling_listener_;
   std::unique_ptr<BenchmarkListener> gemmlowp_profiling_listener_;
+  std::unique_ptr<BenchmarkListener> memory_report_listener_;
   TfLiteDelegatePtrMap delegates_;
 };
 
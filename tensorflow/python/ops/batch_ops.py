@@ -34,7 +34,8 @@ def batch_function(num_batch_threads,
                    batch_timeout_micros,
                    allowed_batch_sizes=None,
                    max_enqueued_batches=10,
-                   autograph=True):
+                   autograph=True,
+                   bucketize_by_shape=False):
   """Batches the computation done by the decorated function.
 
   So, for example, in the following code
@@ -71,6 +72,9 @@ def batch_function(num_batch_threads,
     max_enqueued_batches: The maximum depth of the batch queue. Defaults to 10.
     autograph: Whether to use autograph to compile python and eager style code
      for efficient graph-mode execution.
+    bucketize_by_shape: If True, only invocations whose arguments have
+     identical non-batch dimensions are batched together, so variable-shape
+     inputs need no padding. Defaults to False.
 
   Returns:
     The decorated function will return the unbatched computation output Tensors.
@@ -100,6 +104,7 @@ def batch_function(num_batch_threads,
             batch_timeout_micros=batch_timeout_micros,
             allowed_batch_sizes=allowed_batch_sizes,
             max_enqueued_batches=max_enqueued_batches,
+            bucketize_by_shape=bucketize_by_shape,
             shared_name=name,
             f=computation,
             in_tensors=list(args),
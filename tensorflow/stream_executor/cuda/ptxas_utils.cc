@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/cuda_libdevice_path.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/regexp.h"
 #include "tensorflow/core/platform/subprocess.h"
@@ -106,6 +107,35 @@ static void WarnIfBadPtxasVersion(const string& ptxas_path) {
   }
 }
 
+// Persistent compiled-kernel cache.
+//
+// When TF_CUDA_KERNEL_CACHE_DIR is set, every cubin produced by CompilePtx
+// is written to one file per compilation under that directory and reused by
+// later processes, so jobs that JIT a lot of PTX (XLA in particular) do not
+// pay tens of seconds of ptxas time again on every restart. Files are named
+// by a fingerprint of the PTX text, the target compute capability and the
+// compile flags, so a shared directory is safe across heterogeneous hosts
+// and build configurations; a mismatch simply misses and recompiles.
+static const string& KernelCacheDir() {
+  static const string* dir = [] {
+    const char* value = getenv("TF_CUDA_KERNEL_CACHE_DIR");
+    return new string(value == nullptr ? "" : value);
+  }();
+  return *dir;
+}
+
+static string KernelCacheFileName(const char* ptx_contents, int cc_major,
+                                  int cc_minor,
+                                  const PtxCompilationOptions& options) {
+  uint64 fingerprint = tensorflow::Fingerprint64(ptx_contents);
+  if (options.disable_ptxas_optimizations) {
+    fingerprint = tensorflow::FingerprintCat64(fingerprint, 1);
+  }
+  return tensorflow::io::JoinPath(
+      KernelCacheDir(),
+      absl::StrFormat("%016x_sm%d%d.cubin", fingerprint, cc_major, cc_minor));
+}
+
 port::StatusOr<absl::Span<const uint8>> CompilePtxOrGetCached(
     int device_ordinal, const char* ptx,
     PtxCompilationOptions compilation_options) {
@@ -123,8 +153,7 @@ port::StatusOr<absl::Span<const uint8>> CompilePtxOrGetCached(
     auto compiled_or = CompilePtx(device_ordinal, ptx, compilation_options);
     TF_RETURN_IF_ERROR(compiled_or.status());
     std::vector<uint8> compiled = std::move(compiled_or.ValueOrDie());
-    it =
-        ptx_cache.emplace(cache_key, std::move(compiled_or.ValueOrDie())).first;
+    it = ptx_cache.emplace(cache_key, std::move(compiled)).first;
   }
 
   CHECK(it != ptx_cache.end());
@@ -142,8 +171,19 @@ port::StatusOr<std::vector<uint8>> CompilePtx(int device_ordinal,
   TF_RETURN_IF_ERROR(
       CUDADriver::GetComputeCapability(&cc_major, &cc_minor, handle));
 
-  string ptxas_path;
   auto env = tensorflow::Env::Default();
+  string cache_path;
+  if (!KernelCacheDir().empty()) {
+    cache_path = KernelCacheFileName(ptx_contents, cc_major, cc_minor, options);
+    string cached_cubin;
+    if (tensorflow::ReadFileToString(env, cache_path, &cached_cubin).ok() &&
+        !cached_cubin.empty()) {
+      VLOG(2) << "Using compiled kernel from " << cache_path;
+      return std::vector<uint8>(cached_cubin.begin(), cached_cubin.end());
+    }
+  }
+
+  string ptxas_path;
   for (const string& cuda_root :
        tensorflow::CandidateCudaRoots(options.preferred_cuda_dir)) {
     ptxas_path = tensorflow::io::JoinPath(cuda_root, "bin", "ptxas");
@@ -209,6 +249,32 @@ port::StatusOr<std::vector<uint8>> CompilePtx(int device_ordinal,
   string cubin;
   TF_RETURN_IF_ERROR(tensorflow::ReadFileToString(tensorflow::Env::Default(),
                                                   cubin_path, &cubin));
+
+  if (!cache_path.empty()) {
+    // Write through a unique temporary file and rename it into place, so
+    // concurrent processes sharing the cache directory never observe a
+    // partially written cubin. Failure to persist is not a compile error.
+    string tmp_path = cache_path;
+    port::Status persist_status;
+    if (env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+      persist_status = tensorflow::WriteStringToFile(env, tmp_path, cubin);
+      if (persist_status.ok()) {
+        persist_status = env->RenameFile(tmp_path, cache_path);
+      }
+      if (!persist_status.ok()) {
+        env->DeleteFile(tmp_path).IgnoreError();
+      }
+    } else {
+      persist_status = port::InternalError("couldn't get temp cache file name");
+    }
+    if (!persist_status.ok()) {
+      LOG(WARNING) << "Failed to persist compiled kernel to " << cache_path
+                   << ": " << persist_status;
+    } else {
+      VLOG(2) << "Persisted compiled kernel to " << cache_path;
+    }
+  }
+
   std::vector<uint8> cubin_vector(cubin.begin(), cubin.end());
   return cubin_vector;
 }
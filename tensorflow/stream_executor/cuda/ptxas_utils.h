@@ -49,6 +49,10 @@ struct PtxCompilationOptions {
 //
 // compile_ptx_options is used to query for the CUDA location in case it is
 // customized in a passed flag, and for controlling ptxas optimizations.
+//
+// When TF_CUDA_KERNEL_CACHE_DIR is set, compiled cubins are persisted under
+// that directory keyed by PTX fingerprint, compute capability and compile
+// flags, and reused by later processes instead of re-running ptxas.
 port::StatusOr<std::vector<uint8>> CompilePtx(int device_ordinal,
                                               const char* ptx_contents,
                                               PtxCompilationOptions options);
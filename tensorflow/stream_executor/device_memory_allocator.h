@@ -16,17 +16,22 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_SERVICE_DEVICE_MEMORY_ALLOCATOR_H_
 #define TENSORFLOW_COMPILER_XLA_SERVICE_DEVICE_MEMORY_ALLOCATOR_H_
 
+#include <map>
 #include <vector>
 
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/stream_executor/device_memory.h"
 #include "tensorflow/stream_executor/lib/statusor.h"
 #include "tensorflow/stream_executor/platform.h"
+#include "tensorflow/stream_executor/platform/thread_annotations.h"
 
 namespace stream_executor {
 
 class DeviceMemoryAllocator;
+class Event;
+class Stream;
 
 // Owning pointer for memory on a device.
 //
@@ -187,6 +192,34 @@ class DeviceMemoryAllocator {
   // Must be a nop for null pointers.
   virtual port::Status Deallocate(int device_ordinal, DeviceMemoryBase mem) = 0;
 
+  // Stream-ordered variant of Allocate().  The returned memory is valid for
+  // use by work subsequently enqueued on `stream` (or on any stream that
+  // synchronizes with it) without further synchronization.  The base
+  // implementation falls back to the synchronous Allocate(), which always
+  // satisfies that contract; allocators that override this may instead
+  // recycle memory freed earlier in `stream`'s order.
+  virtual port::StatusOr<OwningDeviceMemory> AllocateStreamOrdered(
+      int device_ordinal, uint64 size, bool retry_on_failure, Stream* stream) {
+    return Allocate(device_ordinal, size, retry_on_failure);
+  }
+
+  // Stream-ordered variant of Deallocate().  The memory is freed in
+  // `stream`'s order: work already enqueued on `stream` may still use it,
+  // and the allocator may hand it to a later AllocateStreamOrdered() call
+  // without waiting for the device to go idle.  The base implementation is
+  // the synchronous Deallocate(), so callers must only use this entry point
+  // when all work using `mem` has been enqueued on `stream`.  Must be a nop
+  // for null pointers.
+  virtual port::Status DeallocateStreamOrdered(int device_ordinal,
+                                               DeviceMemoryBase mem,
+                                               Stream* stream) {
+    return Deallocate(device_ordinal, mem);
+  }
+
+  // Returns true if this allocator implements the stream-ordered entry
+  // points above, rather than falling back to the synchronous ones.
+  virtual bool SupportsStreamOrderedAllocation() const { return false; }
+
   // Return the platform that the allocator allocates memory on.
   const Platform* platform() const { return platform_; }
 
@@ -235,6 +268,75 @@ class StreamExecutorMemoryAllocator : public DeviceMemoryAllocator {
   std::map<int, StreamExecutor *> stream_executors_;
 };
 
+// Stream-ordered allocator layered on StreamExecutorMemoryAllocator.
+//
+// Blocks freed through DeallocateStreamOrdered() are cached on a per-stream
+// free list instead of being returned to the device immediately.  A later
+// same-stream allocation of the same size reuses a cached block without any
+// synchronization, because stream ordering guarantees that the work which
+// used the old allocation completes before the work that uses the new one
+// begins.  Reuse across streams is gated on an event recorded at free time,
+// so no global synchronization is ever required.
+//
+// Memory freed through the synchronous Deallocate() entry point (e.g. by a
+// ScopedDeviceMemory destructor) bypasses the cache and is returned to the
+// device directly, as before.
+class StreamOrderedMemoryAllocator : public StreamExecutorMemoryAllocator {
+ public:
+  explicit StreamOrderedMemoryAllocator(StreamExecutor *executor);
+
+  StreamOrderedMemoryAllocator(
+      const Platform *platform,
+      absl::Span<StreamExecutor *const> stream_executors);
+
+  // Returns all cached blocks to the device.  The caller must ensure that
+  // every stream that freed memory into the cache has completed the work
+  // that preceded the free.
+  ~StreamOrderedMemoryAllocator() override;
+
+  port::StatusOr<OwningDeviceMemory> AllocateStreamOrdered(
+      int device_ordinal, uint64 size, bool retry_on_failure,
+      Stream *stream) override;
+
+  port::Status DeallocateStreamOrdered(int device_ordinal,
+                                       DeviceMemoryBase mem,
+                                       Stream *stream) override;
+
+  bool SupportsStreamOrderedAllocation() const override { return true; }
+
+  // Returns to the device all cached blocks whose free-time events have
+  // completed.  Blocks without an event stay cached, since only stream
+  // ordering proves their previous use has finished.
+  void TrimFreeLists();
+
+  // The number of blocks currently cached, for tests and debugging.
+  int64 free_list_size() const;
+
+ private:
+  struct FreeBlock {
+    DeviceMemoryBase mem;
+    int device_ordinal;
+    // Executor that owns the memory and the event.  Not owned.
+    StreamExecutor *executor;
+    // Recorded on the freeing stream when the block was deallocated, or
+    // null if the platform does not support events.  Reuse on another
+    // stream requires the event to have completed; reuse on the freeing
+    // stream does not.  Owned.
+    Event *event;
+  };
+
+  // Returns `block`'s event to its executor's pool if it has completed, or
+  // destroys it otherwise.  Null events are ignored.
+  static void RetireEvent(FreeBlock *block);
+
+  mutable absl::Mutex free_mu_;
+
+  // Cached blocks, keyed by the stream that freed them.  The key is only
+  // compared against the allocating stream, never dereferenced, so entries
+  // may safely outlive their stream.
+  std::map<Stream *, std::vector<FreeBlock>> free_lists_ GUARDED_BY(free_mu_);
+};
+
 template <typename ElemT>
 void ScopedDeviceMemory<ElemT>::Free() {
   if (!wrapped_.is_null()) {
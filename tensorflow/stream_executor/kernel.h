@@ -512,6 +512,10 @@ class TypedKernel : public KernelBase {
   // type signatures).
   friend class Stream;
 
+  // KernelLaunchSequence packs parameters the same way Stream does, but at
+  // the time a launch is recorded rather than at submission time.
+  friend class KernelLaunchSequence;
+
   // This is the main entry point into the magic. Packs the parameters (which
   // must type check against the class template) into the args and sizes
   // arrays.
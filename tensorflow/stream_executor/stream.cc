@@ -1830,6 +1830,26 @@ void Stream::ReturnSubStream(Stream *sub_stream) {
              << sub_stream->DebugStreamPointers();
 }
 
+Stream &Stream::ThenLaunchSequence(const KernelLaunchSequence &sequence) {
+  VLOG_CALL(PARAM(sequence.num_launches()));
+
+  if (ok()) {
+    for (const KernelLaunchSequence::Launch &launch : sequence.launches_) {
+      if (!parent_->Launch(this, launch.thread_dims, launch.block_dims,
+                           *launch.kernel, *launch.args)) {
+        SetError();
+        LOG(WARNING) << "parent failed to launch recorded kernel: "
+                     << launch.kernel;
+        break;
+      }
+    }
+  } else {
+    LOG(INFO) << DebugStreamPointers()
+              << " did not submit recorded kernel launch sequence";
+  }
+  return *this;
+}
+
 Stream &Stream::ThenStartTimer(Timer *t) {
   VLOG_CALL(PARAM(t));
 
@@ -5149,6 +5169,17 @@ Stream &Stream::ThenDoHostCallbackWithStatus(
   return *this;
 }
 
+Stream &Stream::ThenEnqueueHostCallback(std::function<void()> callback) {
+  VLOG_CALL(PARAM(callback));
+
+  if (!ok()) {
+    LOG(INFO) << DebugStreamPointers()
+              << " was in error state before enqueuing host callback";
+  }
+  CheckError(parent_->EnqueueHostCallback(this, std::move(callback)));
+  return *this;
+}
+
 Stream &Stream::ThenFft(fft::Plan *plan,
                         const DeviceMemory<std::complex<float>> &input,
                         DeviceMemory<std::complex<float>> *output) {
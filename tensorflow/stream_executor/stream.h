@@ -24,6 +24,9 @@ limitations under the License.
 #include <complex>
 #include <functional>
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/core/platform/macros.h"
@@ -78,6 +81,98 @@ class ScratchAllocator;
 template <typename ElementType>
 struct Quantization;
 
+// Records a fixed sequence of typed kernel launches so that the whole
+// sequence can be entrained onto a stream with a single
+// Stream::ThenLaunchSequence() call. The invocation type checking and
+// argument packing that ThenLaunch() performs for every call happen once
+// here, when a launch is recorded, which trims per-step submission overhead
+// for the repeated small-kernel sequences that fixed inference graphs
+// produce.
+//
+// The recorded kernels (and any device memory their arguments refer to)
+// must outlive the sequence; the argument values themselves are copied into
+// the sequence when a launch is added.
+//
+// Thread-compatible.
+class KernelLaunchSequence {
+ public:
+  KernelLaunchSequence() {}
+
+  // Records a launch of kernel over the given launch dimensions with the
+  // given (variadic) actual arguments. The arguments are checked against
+  // the kernel's formal parameters exactly as in Stream::ThenLaunch.
+  template <typename... Params, typename... Args>
+  void AddLaunch(ThreadDim thread_dims, BlockDim block_dims,
+                 const TypedKernel<Params...> &kernel, Args... args) {
+    KernelInvocationChecker<std::tuple<Params...>,
+                            std::tuple<Args...>>::CheckAllStaticAssert();
+    std::unique_ptr<RecordedArgs<Args...>> record(
+        new RecordedArgs<Args...>(std::move(args)...));
+    PackRecordedArgs(std::integral_constant<size_t, sizeof...(Args)>(),
+                     kernel, record.get());
+    launches_.push_back(
+        Launch{thread_dims, block_dims, &kernel, &record->args_array});
+    args_storage_.push_back(std::move(record));
+  }
+
+  // Returns the number of launches recorded so far.
+  size_t num_launches() const { return launches_.size(); }
+
+ private:
+  // Stream replays the recorded launches in ThenLaunchSequence().
+  friend class Stream;
+
+  // A single recorded launch. kernel is unowned; args points into the
+  // RecordedArgs entry owned by args_storage_.
+  struct Launch {
+    ThreadDim thread_dims;
+    BlockDim block_dims;
+    const KernelBase *kernel;
+    const KernelArgsArrayBase *args;
+  };
+
+  // Owns copies of the actual arguments together with the argument array
+  // packed from them. The packed array stores the addresses of the copies,
+  // so the two share one heap allocation that never moves.
+  struct RecordedArgsBase {
+    virtual ~RecordedArgsBase() {}
+  };
+  template <typename... Args>
+  struct RecordedArgs : public RecordedArgsBase {
+    explicit RecordedArgs(Args... args) : values(std::move(args)...) {}
+
+    std::tuple<Args...> values;
+    KernelArgsArray<sizeof...(Args)> args_array;
+  };
+
+  // Peels stored arguments off the tuple back-to-front, collecting lvalue
+  // references to them, until the base case below hands the complete
+  // reference pack to TypedKernel::PackParams(). The references must be to
+  // the stored copies because the packed array records their addresses.
+  template <size_t kRemaining, typename... Params, typename... Args,
+            typename... CollectedArgs>
+  static void PackRecordedArgs(std::integral_constant<size_t, kRemaining>,
+                               const TypedKernel<Params...> &kernel,
+                               RecordedArgs<Args...> *record,
+                               CollectedArgs &... collected) {
+    PackRecordedArgs(std::integral_constant<size_t, kRemaining - 1>(), kernel,
+                     record, std::get<kRemaining - 1>(record->values),
+                     collected...);
+  }
+  template <typename... Params, typename... Args, typename... CollectedArgs>
+  static void PackRecordedArgs(std::integral_constant<size_t, 0>,
+                               const TypedKernel<Params...> &kernel,
+                               RecordedArgs<Args...> *record,
+                               CollectedArgs &... collected) {
+    kernel.PackParams(&record->args_array, collected...);
+  }
+
+  std::vector<Launch> launches_;
+  std::vector<std::unique_ptr<RecordedArgsBase>> args_storage_;
+
+  SE_DISALLOW_COPY_AND_ASSIGN(KernelLaunchSequence);
+};
+
 // Represents a stream of dependent computations on a GPU device.
 //
 // The operations within a stream execute linearly and asynchronously until
@@ -171,6 +266,13 @@ class Stream {
   Stream &ThenLaunch(ThreadDim thread_dims, BlockDim block_dims,
                      const TypedKernel<Params...> &kernel, Args... args);
 
+  // Entrains every kernel launch recorded in sequence onto the stream, in
+  // recording order. Because the type checking and argument packing were
+  // performed when each launch was recorded, resubmitting a fixed sequence
+  // of small kernels this way is cheaper than issuing the equivalent
+  // ThenLaunch() calls individually.
+  Stream &ThenLaunchSequence(const KernelLaunchSequence &sequence);
+
   // Record a "start" event for the interval timer at this point in the
   // stream's execution (relative to the previously and subsequently enqueued
   // items in the stream's execution). Streams may be started/stopped multiple
@@ -1949,6 +2051,21 @@ class Stream {
   // negative effects on performance.
   Stream &ThenDoHostCallbackWithStatus(std::function<port::Status()> callback);
 
+  // Enqueues a callback to the host that runs once all work previously
+  // enqueued on this stream has completed.  Unlike ThenDoHostCallback, the
+  // callback does not block/occupy the stream: a lightweight completion
+  // marker is recorded instead, and the callback runs on a dedicated
+  // callback thread of the parent StreamExecutor once the marker completes.
+  // Callbacks enqueued on the same stream run in enqueue order.
+  //
+  // Prefer this form for frequent bookkeeping callbacks (e.g. deallocation
+  // tracking) on busy streams.  The callback may run noticeably later than
+  // the device work it follows, so it is unsuitable for latency-sensitive
+  // signaling, and it must not call device routines or insert work into any
+  // stream.  Falls back to ThenDoHostCallback behavior on platforms without
+  // event support.
+  Stream &ThenEnqueueHostCallback(std::function<void()> callback);
+
   // Returns the StreamExecutor (parent object) associated with this stream.
   StreamExecutor *parent() const {
     CHECK(parent_ != nullptr);
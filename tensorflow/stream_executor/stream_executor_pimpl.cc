@@ -143,6 +143,7 @@ StreamExecutor::StreamExecutor(
           port::Env::Default(), "stream_executor", kNumBackgroundThreads)),
       live_stream_count_(0),
       tracing_enabled_(false),
+      stop_host_callback_loop_(false),
       mem_alloc_bytes_(0),
       memory_limit_bytes_(GetMemoryLimitBytes()) {
   string name = absl::AsciiStrToLower(platform_->Name());
@@ -162,6 +163,25 @@ StreamExecutor::StreamExecutor(
 StreamExecutor::~StreamExecutor() {
   BlockOnThreadExecutor(background_threads_.get());
 
+  {
+    absl::MutexLock lock(&callback_mu_);
+    stop_host_callback_loop_ = true;
+    host_callbacks_cv_.SignalAll();
+  }
+  // Waits for HostCallbackLoop() to exit, if it was ever started.
+  callback_threads_.reset();
+  // Queued callbacks perform bookkeeping (e.g. deallocation) that must not
+  // be dropped.  By this point all streams should have been deallocated, so
+  // the device work the markers track has completed.
+  for (HostCallbackRecord &record : pending_host_callbacks_) {
+    // Records whose marker is null already ran in HostCallbackLoop().
+    if (record.marker != nullptr) {
+      delete record.marker;
+      record.callback();
+    }
+  }
+  pending_host_callbacks_.clear();
+
   if (live_stream_count_.load() != 0) {
     LOG(WARNING) << "Not all streams were deallocated at executor destruction "
                  << "time. This may lead to unexpected/bad behavior - "
@@ -443,6 +463,39 @@ bool StreamExecutor::Launch(Stream *stream, const ThreadDim &thread_dims,
   return implementation_->Launch(stream, thread_dims, block_dims, kernel, args);
 }
 
+std::unique_ptr<Event> StreamExecutor::GetOrCreateEvent() {
+  {
+    absl::MutexLock lock(&mu_);
+    if (!event_pool_.empty()) {
+      std::unique_ptr<Event> event = std::move(event_pool_.back());
+      event_pool_.pop_back();
+      return event;
+    }
+  }
+  // Create and initialize outside the lock; Init() calls into the driver.
+  std::unique_ptr<Event> event(new Event(this));
+  if (!event->Init()) {
+    return nullptr;
+  }
+  return event;
+}
+
+void StreamExecutor::ReturnEvent(std::unique_ptr<Event> event) {
+  if (event == nullptr) {
+    return;
+  }
+  absl::MutexLock lock(&mu_);
+  if (event_pool_.size() < static_cast<size_t>(kMaxPooledEvents)) {
+    event_pool_.push_back(std::move(event));
+  }
+  // Otherwise let the event be destroyed, releasing its driver resources.
+}
+
+size_t StreamExecutor::EventPoolSize() const {
+  absl::MutexLock lock(&mu_);
+  return event_pool_.size();
+}
+
 port::Status StreamExecutor::BlockHostUntilDone(Stream *stream) {
   port::Status result;
   SCOPED_TRACE(TraceListener::BlockHostUntilDone, &result, stream);
@@ -708,6 +761,78 @@ bool StreamExecutor::HostCallback(Stream *stream,
   return implementation_->HostCallback(stream, std::move(callback));
 }
 
+bool StreamExecutor::EnqueueHostCallback(Stream *stream,
+                                         std::function<void()> callback) {
+  std::unique_ptr<Event> marker = GetOrCreateEvent();
+  if (marker == nullptr) {
+    // The platform has no event support, so an entrained callback is the
+    // only way to observe the stream's progress.
+    return implementation_->HostCallback(stream, std::move(callback));
+  }
+  port::Status status = RecordEvent(stream, marker.get());
+  if (!status.ok()) {
+    LOG(WARNING) << "failed to record host callback completion marker: "
+                 << status;
+    ReturnEvent(std::move(marker));
+    return implementation_->HostCallback(stream, std::move(callback));
+  }
+  absl::MutexLock lock(&callback_mu_);
+  if (callback_threads_ == nullptr) {
+    callback_threads_.reset(new port::ThreadPool(
+        port::Env::Default(), "host_callback", /*num_threads=*/1));
+    callback_threads_->Schedule([this]() { HostCallbackLoop(); });
+  }
+  pending_host_callbacks_.push_back(
+      HostCallbackRecord{stream, marker.release(), std::move(callback)});
+  host_callbacks_cv_.Signal();
+  return true;
+}
+
+void StreamExecutor::HostCallbackLoop() {
+  std::vector<std::function<void()>> to_run;
+  while (true) {
+    bool markers_still_pending;
+    {
+      absl::MutexLock lock(&callback_mu_);
+      while (pending_host_callbacks_.empty() && !stop_host_callback_loop_) {
+        host_callbacks_cv_.Wait(&callback_mu_);
+      }
+      if (stop_host_callback_loop_) {
+        // Remaining records are drained by the destructor.
+        return;
+      }
+      // Collect every callback whose marker has completed, in queue order.
+      // Markers on a given stream complete in enqueue order, so this never
+      // reorders callbacks within a stream.
+      for (HostCallbackRecord &record : pending_host_callbacks_) {
+        if (record.marker == nullptr) {
+          continue;
+        }
+        if (record.marker->PollForStatus() == Event::Status::kComplete) {
+          ReturnEvent(std::unique_ptr<Event>(record.marker));
+          record.marker = nullptr;
+          to_run.push_back(std::move(record.callback));
+        }
+      }
+      while (!pending_host_callbacks_.empty() &&
+             pending_host_callbacks_.front().marker == nullptr) {
+        pending_host_callbacks_.pop_front();
+      }
+      markers_still_pending = !pending_host_callbacks_.empty();
+    }
+    // Run the batch outside the lock so that callbacks may enqueue more
+    // work without deadlocking.
+    for (std::function<void()> &callback : to_run) {
+      callback();
+    }
+    to_run.clear();
+    if (markers_still_pending) {
+      port::Env::Default()->SleepForMicroseconds(
+          kHostCallbackPollingDelayUsecs);
+    }
+  }
+}
+
 port::Status StreamExecutor::AllocateEvent(Event *event) {
   return implementation_->AllocateEvent(event);
 }
@@ -921,4 +1046,138 @@ bool StreamExecutorMemoryAllocator::AllowsAsynchronousDeallocation() const {
   return false;
 }
 
+StreamOrderedMemoryAllocator::StreamOrderedMemoryAllocator(
+    StreamExecutor *executor)
+    : StreamExecutorMemoryAllocator(executor) {}
+
+StreamOrderedMemoryAllocator::StreamOrderedMemoryAllocator(
+    const Platform *platform,
+    absl::Span<StreamExecutor *const> stream_executors)
+    : StreamExecutorMemoryAllocator(platform, stream_executors) {}
+
+StreamOrderedMemoryAllocator::~StreamOrderedMemoryAllocator() {
+  absl::MutexLock lock(&free_mu_);
+  for (auto &free_list : free_lists_) {
+    for (FreeBlock &block : free_list.second) {
+      RetireEvent(&block);
+      block.executor->Deallocate(&block.mem);
+    }
+  }
+  free_lists_.clear();
+}
+
+port::StatusOr<OwningDeviceMemory>
+StreamOrderedMemoryAllocator::AllocateStreamOrdered(int device_ordinal,
+                                                    uint64 size,
+                                                    bool retry_on_failure,
+                                                    Stream *stream) {
+  if (size > 0) {
+    absl::MutexLock lock(&free_mu_);
+    // Same-stream reuse: ordering on `stream` alone guarantees that the
+    // work which used the block completes before this allocation's user
+    // begins, so the free-time event (if any) is irrelevant.
+    auto it = free_lists_.find(stream);
+    if (it != free_lists_.end()) {
+      std::vector<FreeBlock> &blocks = it->second;
+      for (auto block_it = blocks.begin(); block_it != blocks.end();
+           ++block_it) {
+        if (block_it->device_ordinal == device_ordinal &&
+            block_it->mem.size() == size) {
+          DeviceMemoryBase result = block_it->mem;
+          RetireEvent(&*block_it);
+          blocks.erase(block_it);
+          VLOG(3) << absl::StreamFormat(
+              "Reusing %p (%uB) freed on the allocating stream %p",
+              result.opaque(), size, stream);
+          return OwningDeviceMemory(result, device_ordinal, this);
+        }
+      }
+    }
+    // Cross-stream reuse: only blocks whose free-time event has completed
+    // are provably no longer in use by the freeing stream.
+    for (auto &free_list : free_lists_) {
+      if (free_list.first == stream) {
+        continue;
+      }
+      std::vector<FreeBlock> &blocks = free_list.second;
+      for (auto block_it = blocks.begin(); block_it != blocks.end();
+           ++block_it) {
+        if (block_it->device_ordinal == device_ordinal &&
+            block_it->mem.size() == size && block_it->event != nullptr &&
+            block_it->event->PollForStatus() == Event::Status::kComplete) {
+          DeviceMemoryBase result = block_it->mem;
+          RetireEvent(&*block_it);
+          blocks.erase(block_it);
+          VLOG(3) << absl::StreamFormat(
+              "Reusing %p (%uB) freed on stream %p for stream %p",
+              result.opaque(), size, free_list.first, stream);
+          return OwningDeviceMemory(result, device_ordinal, this);
+        }
+      }
+    }
+  }
+  return Allocate(device_ordinal, size, retry_on_failure);
+}
+
+port::Status StreamOrderedMemoryAllocator::DeallocateStreamOrdered(
+    int device_ordinal, DeviceMemoryBase mem, Stream *stream) {
+  if (mem.is_null()) {
+    return port::Status::OK();
+  }
+  StreamExecutor *executor = stream->parent();
+  std::unique_ptr<Event> event = executor->GetOrCreateEvent();
+  if (event != nullptr) {
+    stream->ThenRecordEvent(event.get());
+  }
+  // Without an event (platforms that do not support them) the block can
+  // still be reused on the freeing stream; cross-stream reuse and trimming
+  // are simply disabled for it.
+  VLOG(3) << absl::StreamFormat("Caching %p (%uB) freed on stream %p",
+                                mem.opaque(), mem.size(), stream);
+  absl::MutexLock lock(&free_mu_);
+  free_lists_[stream].push_back(
+      FreeBlock{mem, device_ordinal, executor, event.release()});
+  return port::Status::OK();
+}
+
+void StreamOrderedMemoryAllocator::TrimFreeLists() {
+  absl::MutexLock lock(&free_mu_);
+  for (auto &free_list : free_lists_) {
+    std::vector<FreeBlock> &blocks = free_list.second;
+    for (auto block_it = blocks.begin(); block_it != blocks.end();) {
+      if (block_it->event != nullptr &&
+          block_it->event->PollForStatus() == Event::Status::kComplete) {
+        RetireEvent(&*block_it);
+        block_it->executor->Deallocate(&block_it->mem);
+        block_it = blocks.erase(block_it);
+      } else {
+        ++block_it;
+      }
+    }
+  }
+}
+
+int64 StreamOrderedMemoryAllocator::free_list_size() const {
+  absl::MutexLock lock(&free_mu_);
+  int64 size = 0;
+  for (const auto &free_list : free_lists_) {
+    size += free_list.second.size();
+  }
+  return size;
+}
+
+/* static */ void StreamOrderedMemoryAllocator::RetireEvent(FreeBlock *block) {
+  if (block->event == nullptr) {
+    return;
+  }
+  if (block->event->PollForStatus() == Event::Status::kComplete) {
+    block->executor->ReturnEvent(std::unique_ptr<Event>(block->event));
+  } else {
+    // A pending event cannot go back to the pool; let the platform defer
+    // its destruction until it completes.
+    delete block->event;
+  }
+  block->event = nullptr;
+}
+
 }  // namespace stream_executor
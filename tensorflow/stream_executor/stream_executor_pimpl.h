@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_STREAM_EXECUTOR_STREAM_EXECUTOR_PIMPL_H_
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <set>
 #include <tuple>
@@ -441,6 +442,25 @@ class StreamExecutor {
               const BlockDim &block_dims, const KernelBase &kernel,
               const KernelArgsArrayBase &args);
 
+  // Returns an initialized event, drawing from the per-executor pool of
+  // recycled events when one is available and creating (and initializing) a
+  // new one otherwise. Event creation maps to a driver call on most
+  // platforms, so clients that record events at a steady rate should return
+  // them through ReturnEvent() rather than destroying them.
+  //
+  // Returns nullptr if a new event could not be initialized.
+  std::unique_ptr<Event> GetOrCreateEvent();
+
+  // Returns an event previously obtained from GetOrCreateEvent() to the
+  // pool for reuse. The event must have completed (or never been recorded);
+  // a later GetOrCreateEvent() call may hand it out and re-record it. If
+  // the pool is full the event is simply destroyed.
+  void ReturnEvent(std::unique_ptr<Event> event);
+
+  // Returns the number of events currently held by the pool. Mainly for
+  // tests and diagnostics.
+  size_t EventPoolSize() const;
+
   // Gets-or-creates (creates with memoization) a FftSupport datatype that can
   // be used to execute FFT routines on the current platform.
   //
@@ -567,6 +587,23 @@ class StreamExecutor {
   // This is the preferred form for a callback that may return an error.
   bool HostCallback(Stream *stream, std::function<port::Status()> callback);
 
+  // Enqueues a user-specified function to run on the host once all work
+  // previously enqueued on stream has completed.
+  //
+  // Unlike HostCallback(), this does not entrain the callback through the
+  // platform's synchronization machinery, which serializes the stream on
+  // some platforms.  Instead a pooled event is recorded on the stream as a
+  // lightweight completion marker and the callback is queued for a
+  // dedicated callback thread that drains completed markers in batches.
+  // Falls back to HostCallback() on platforms without event support.
+  // See Stream::ThenEnqueueHostCallback for full details.
+  bool EnqueueHostCallback(Stream *stream, std::function<void()> callback);
+
+  // Body of the callback thread started by EnqueueHostCallback(): polls the
+  // completion markers of queued callbacks, runs the completed ones, and
+  // exits when the executor is destroyed.
+  void HostCallbackLoop();
+
   // Performs platform-specific allocation and initialization of an event.
   port::Status AllocateEvent(Event *event);
 
@@ -712,6 +749,47 @@ class StreamExecutor {
   // The set of TraceListeners registered for this StreamExecutor.
   std::set<TraceListener*> listeners_ GUARDED_BY(mu_);
 
+  // Initialized events available for reuse through GetOrCreateEvent();
+  // bounded so that a burst of in-flight events does not pin driver
+  // resources forever.
+  std::vector<std::unique_ptr<Event>> event_pool_ GUARDED_BY(mu_);
+
+  // Maximum number of events ReturnEvent() will keep pooled; any excess is
+  // destroyed on return.
+  static const int kMaxPooledEvents = 256;
+
+  // A host callback queued by EnqueueHostCallback(), waiting for its
+  // completion marker to record.
+  struct HostCallbackRecord {
+    Stream *stream;
+    Event *marker;  // Leased from the event pool. Owned.
+    std::function<void()> callback;
+  };
+
+  // Guards the host-callback queue separately from mu_ so that marker
+  // polling does not contend with the executor's other bookkeeping.
+  mutable absl::Mutex callback_mu_;
+
+  // Signalled when a record is queued or the executor shuts down.
+  absl::CondVar host_callbacks_cv_;
+
+  // Queued callbacks in enqueue order.  Markers on the same stream complete
+  // in that order, so a FIFO sweep runs each stream's callbacks in order.
+  std::deque<HostCallbackRecord> pending_host_callbacks_
+      GUARDED_BY(callback_mu_);
+
+  // Runs HostCallbackLoop(); created on the first EnqueueHostCallback()
+  // call.  A single thread both preserves enqueue order and keeps idle
+  // executors from paying for it.
+  std::unique_ptr<port::ThreadPool> callback_threads_ GUARDED_BY(callback_mu_);
+
+  // Set at destruction time to make HostCallbackLoop() exit.
+  bool stop_host_callback_loop_ GUARDED_BY(callback_mu_);
+
+  // How long HostCallbackLoop() sleeps between sweeps while markers are
+  // still pending.
+  static const int kHostCallbackPollingDelayUsecs = 10;
+
   // Allocated memory in bytes.
   int64 mem_alloc_bytes_;
 
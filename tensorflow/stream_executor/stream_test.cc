@@ -199,5 +199,101 @@ TEST_F(StreamTest, FailedSubStreamAfterReturnNotReused) {
   EXPECT_EQ(sub_stream2, sub_stream3);
 }
 
+TEST_F(StreamTest, LaunchSequenceRecordsLaunches) {
+  std::unique_ptr<StreamExecutor> executor = NewStreamExecutor();
+  TypedKernel<int, float> kernel(executor.get());
+
+  // Arguments are checked, packed and copied at recording time; nothing is
+  // submitted to a stream here.
+  KernelLaunchSequence sequence;
+  EXPECT_EQ(0, sequence.num_launches());
+  sequence.AddLaunch(ThreadDim(), BlockDim(), kernel, 42, 1.5f);
+  sequence.AddLaunch(ThreadDim(), BlockDim(), kernel, 7, 2.5f);
+  EXPECT_EQ(2, sequence.num_launches());
+}
+
+TEST_F(StreamTest, StreamOrderedAllocatorReusesSameStreamBlocks) {
+  std::unique_ptr<StreamExecutor> executor = NewStreamExecutor();
+  Stream stream(executor.get());
+  stream.Init();
+  EXPECT_TRUE(stream.ok());
+
+  StreamOrderedMemoryAllocator allocator(executor.get());
+  EXPECT_TRUE(allocator.SupportsStreamOrderedAllocation());
+  OwningDeviceMemory memory =
+      allocator.AllocateStreamOrdered(0, 64, /*retry_on_failure=*/false,
+                                      &stream)
+          .ConsumeValueOrDie();
+  void* opaque = memory->opaque();
+  EXPECT_NE(opaque, nullptr);
+
+  // Freeing in stream order caches the block instead of returning it to
+  // the device.
+  EXPECT_TRUE(
+      allocator.DeallocateStreamOrdered(0, memory.Release(), &stream).ok());
+  EXPECT_EQ(1, allocator.free_list_size());
+
+  // A same-stream allocation of the same size reuses the cached block.
+  OwningDeviceMemory reused =
+      allocator.AllocateStreamOrdered(0, 64, /*retry_on_failure=*/false,
+                                      &stream)
+          .ConsumeValueOrDie();
+  EXPECT_EQ(opaque, reused->opaque());
+  EXPECT_EQ(0, allocator.free_list_size());
+}
+
+TEST_F(StreamTest, StreamOrderedAllocatorNoCrossStreamReuseWithoutEvent) {
+  std::unique_ptr<StreamExecutor> executor = NewStreamExecutor();
+  Stream stream1(executor.get());
+  stream1.Init();
+  Stream stream2(executor.get());
+  stream2.Init();
+
+  StreamOrderedMemoryAllocator allocator(executor.get());
+  OwningDeviceMemory memory =
+      allocator.AllocateStreamOrdered(0, 64, /*retry_on_failure=*/false,
+                                      &stream1)
+          .ConsumeValueOrDie();
+  void* opaque = memory->opaque();
+  EXPECT_TRUE(
+      allocator.DeallocateStreamOrdered(0, memory.Release(), &stream1).ok());
+
+  // The host platform has no events, so the freed block carries no proof of
+  // completion for other streams and must not be handed to stream2.
+  OwningDeviceMemory other =
+      allocator.AllocateStreamOrdered(0, 64, /*retry_on_failure=*/false,
+                                      &stream2)
+          .ConsumeValueOrDie();
+  EXPECT_NE(opaque, other->opaque());
+  EXPECT_EQ(1, allocator.free_list_size());
+}
+
+TEST_F(StreamTest, EmptyLaunchSequenceSubmitOk) {
+  std::unique_ptr<StreamExecutor> executor = NewStreamExecutor();
+  Stream stream(executor.get());
+  stream.Init();
+  EXPECT_TRUE(stream.ok());
+
+  KernelLaunchSequence sequence;
+  stream.ThenLaunchSequence(sequence);
+  EXPECT_TRUE(stream.ok());
+}
+
+TEST_F(StreamTest, EnqueueHostCallbackRunsCallback) {
+  std::unique_ptr<StreamExecutor> executor = NewStreamExecutor();
+  Stream stream(executor.get());
+  stream.Init();
+  EXPECT_TRUE(stream.ok());
+
+  // The host platform has no events, so this exercises the entrained
+  // fallback path; either way the callback must run once the work
+  // preceding it on the stream completes.
+  bool ran = false;
+  stream.ThenEnqueueHostCallback([&ran]() { ran = true; });
+  EXPECT_TRUE(stream.ok());
+  EXPECT_TRUE(stream.BlockHostUntilDone().ok());
+  EXPECT_TRUE(ran);
+}
+
 }  // namespace
 }  // namespace stream_executor